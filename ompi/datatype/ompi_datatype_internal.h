@@ -115,8 +115,13 @@
 #define OMPI_DATATYPE_MPI_LONG                    0x32
 #define OMPI_DATATYPE_MPI_UNSIGNED_LONG           0x33
 
+/*
+ * Extension datatypes.
+ */
+#define OMPI_DATATYPE_MPI_BFLOAT16                0x34
+
 /* This should __ALWAYS__ stay last  */
-#define OMPI_DATATYPE_MPI_UNAVAILABLE             0x34
+#define OMPI_DATATYPE_MPI_UNAVAILABLE             0x35
 
 
 #define OMPI_DATATYPE_MPI_MAX_PREDEFINED          (OMPI_DATATYPE_MPI_UNAVAILABLE+1)
@@ -567,6 +572,12 @@ extern const ompi_datatype_t* ompi_datatype_basicDatatypes[OMPI_DATATYPE_MPI_MAX
 #define OMPI_DATATYPE_INITIALIZER_SHORT_FLOAT         OPAL_DATATYPE_INITIALIZER_UNAVAILABLE
 #endif /* HAVE_SHORT_FLOAT */
 
+/*
+ * bfloat16 has no C type: it is moved around as its 16 bits, and only
+ * the reduction operations know about its format.
+ */
+#define OMPI_DATATYPE_INITIALIZER_BFLOAT16            OPAL_DATATYPE_INITIALIZER_UINT2
+
 #if SIZEOF_FLOAT == 2
 #define OMPI_DATATYPE_INITIALIZER_FLOAT               OPAL_DATATYPE_INITIALIZER_FLOAT2
 #elif SIZEOF_FLOAT == 4
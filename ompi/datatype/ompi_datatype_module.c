@@ -309,6 +309,11 @@ ompi_predefined_datatype_t ompi_mpi_count = OMPI_DATATYPE_INIT_PREDEFINED_BASIC_
 ompi_predefined_datatype_t ompi_mpi_count = OMPI_DATATYPE_INIT_UNAVAILABLE_BASIC_TYPE(INT64_T, COUNT, OMPI_DATATYPE_FLAG_DATA_C | OMPI_DATATYPE_FLAG_DATA_INT);
 #endif
 
+/*
+ * Extension datatypes
+ */
+ompi_predefined_datatype_t ompi_mpi_bfloat16 = OMPI_DATATYPE_INIT_PREDEFINED (BFLOAT16, OMPI_DATATYPE_FLAG_DATA_C | OMPI_DATATYPE_FLAG_DATA_FLOAT);
+
 
 /*
  * NOTE: The order of this array *MUST* match what is listed in
@@ -384,6 +389,9 @@ const ompi_datatype_t* ompi_datatype_basicDatatypes[OMPI_DATATYPE_MPI_MAX_PREDEF
     [OMPI_DATATYPE_MPI_SHORT_FLOAT] = &ompi_mpi_short_float.dt,
     [OMPI_DATATYPE_MPI_C_SHORT_FLOAT_COMPLEX] = &ompi_mpi_c_short_float_complex.dt,
 
+    /* Extension types */
+    [OMPI_DATATYPE_MPI_BFLOAT16] = &ompi_mpi_bfloat16.dt,
+
     [OMPI_DATATYPE_MPI_UNAVAILABLE] = &ompi_mpi_unavailable.dt,
 };
 
@@ -665,6 +673,9 @@ int32_t ompi_datatype_init( void )
     MOOG(c_short_float_complex, 75);
     MOOG(cxx_sfltcplex, 76);
 
+    /* Extension types */
+    MOOG(bfloat16, 77);
+
     /**
      * Now make sure all non-contiguous types are marked as such.
      */
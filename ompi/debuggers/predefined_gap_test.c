@@ -109,6 +109,8 @@ int main(int argc, char **argv) {
     GAP_CHECK("o_f_to_c_index", test_op, o_f_to_c_index, o_flags, 1)
     GAP_CHECK("o_func", test_op, o_func, o_f_to_c_index, 1)
     GAP_CHECK("o_3buff_instrinsic", test_op, o_3buff_intrinsic, o_func, 1)
+    GAP_CHECK("o_copy_intrinsic", test_op, o_copy_intrinsic, o_3buff_intrinsic, 1)
+    GAP_CHECK("o_nary_intrinsic", test_op, o_nary_intrinsic, o_copy_intrinsic, 1)
 
     /* Test Predefined datatype sizes */
     printf("=============================================\n");
@@ -25,6 +25,7 @@
 #include "opal/runtime/opal_params.h"
 
 #include "ompi/mca/pml/pml.h"
+#include "ompi/runtime/mpiruntime.h"
 #include "ompi/runtime/params.h"
 
 #include "ompi/interlib/interlib.h"
@@ -378,6 +379,9 @@ static int ompi_mpi_instance_init_common (int argc, char **argv)
         return ret;
     }
 
+    /* must happen before any component is selected */
+    ompi_mpi_async_progress_enable_threads ();
+
     OBJ_CONSTRUCT(&ompi_instance_common_domain, opal_finalize_domain_t);
     opal_finalize_domain_init (&ompi_instance_common_domain, "ompi_mpi_instance_init_common");
     opal_finalize_set_domain (&ompi_instance_common_domain);
@@ -816,6 +820,10 @@ static int ompi_mpi_instance_init_common (int argc, char **argv)
     OBJ_CONSTRUCT( &ompi_mpi_f90_complex_hashtable, opal_hash_table_t);
     opal_hash_table_init(&ompi_mpi_f90_complex_hashtable, FLT_MAX_10_EXP);
 
+    if (OMPI_SUCCESS != (ret = ompi_mpi_async_progress_start ())) {
+        return ompi_instance_print_error ("ompi_mpi_async_progress_start() failed", ret);
+    }
+
     return OMPI_SUCCESS;
 }
 
@@ -891,6 +899,9 @@ static int ompi_mpi_instance_finalize_common (void)
     int ret;
     opal_pmix_lock_t mylock;
 
+    /* nothing may progress behind our back while the components are shut down */
+    ompi_mpi_async_progress_stop ();
+
     /* As finalize is the last legal MPI call, we are allowed to force the release
      * of the user buffer used for bsend, before going anywhere further.
      */
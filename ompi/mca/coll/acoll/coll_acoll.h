@@ -77,6 +77,31 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
 
 int mca_coll_acoll_barrier_intra(struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
 
+int mca_coll_acoll_alltoall(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                            void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                            struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+
+int mca_coll_acoll_alltoallv(const void *sbuf, ompi_count_array_t scounts,
+                             ompi_disp_array_t sdispls, struct ompi_datatype_t *sdtype,
+                             void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdispls,
+                             struct ompi_datatype_t *rdtype, struct ompi_communicator_t *comm,
+                             mca_coll_base_module_t *module);
+
+int mca_coll_acoll_scatter_intra(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                                 void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                                 int root, struct ompi_communicator_t *comm,
+                                 mca_coll_base_module_t *module);
+
+int mca_coll_acoll_reduce_scatter_intra(const void *sbuf, void *rbuf, ompi_count_array_t rcounts,
+                                        struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module);
+
+int mca_coll_acoll_reduce_scatter_block_intra(const void *sbuf, void *rbuf, size_t rcount,
+                                              struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module);
+
 END_C_DECLS
 
 #define MCA_COLL_ACOLL_ROOT_CHANGE_THRESH 10
@@ -138,6 +163,8 @@ typedef struct coll_acoll_data {
     int *l1_gp;
     int *l2_gp;
     int l2_gp_size;
+    /* l1 group leader of every rank, set up on first use by alltoall */
+    int *l1_ldr;
     int offset[4];
     int sync[2];
 } coll_acoll_data_t;
@@ -230,4 +257,7 @@ struct acoll_xpmem_rcache_reg_t {
 typedef struct mca_coll_acoll_module_t mca_coll_acoll_module_t;
 OMPI_DECLSPEC OBJ_CLASS_DECLARATION(mca_coll_acoll_module_t);
 
+/* Detach the leader segments attached by the shared memory alltoall */
+void coll_acoll_alltoall_shm_fini(coll_acoll_data_t *data, int rank);
+
 #endif /* MCA_COLL_ACOLL_EXPORT_H */
@@ -0,0 +1,445 @@
+/* -*- Mode: C; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/pml/pml.h"
+#include "opal/util/bit_ops.h"
+#include "coll_acoll.h"
+#include "coll_acoll_utils.h"
+
+/* msg_size is the size of a single block */
+static inline int coll_alltoall_decision_fixed(int comm_size, size_t msg_size)
+{
+    /* Set default to pairwise */
+    int alg = 0;
+    if (msg_size * comm_size <= PER_RANK_SHM_SIZE) {
+        /* Exchange through the per-rank shared memory slots */
+        alg = 1;
+    } else if (msg_size <= 256) {
+        /* Bruck */
+        alg = 3;
+    } else if (msg_size >= 16384) {
+        /* Single-copy reads through xpmem */
+        alg = 2;
+    }
+    return alg;
+}
+
+/*
+ * Leaders attach all leaders' segments in coll_acoll_init(), the others
+ * their own leader's and rank 0's. Is the segment of leader i one that
+ * the alltoall has to attach itself?
+ */
+static inline bool coll_acoll_alltoall_shm_extra(const int *l1_ldr, int rank, int my_ldr, int i)
+{
+    return (l1_ldr[i] == i) && (rank != my_ldr) && (i != my_ldr) && (0 != i);
+}
+
+/*
+ * The shared memory alltoall needs every rank's slot, ie. the segments of all
+ * the l1 group leaders, while coll_acoll_init() only attaches the ones that
+ * the reductions use. Find each rank's leader and attach the missing ones;
+ * coll_acoll_alltoall_shm_fini() detaches them.
+ */
+static int coll_acoll_alltoall_shm_init(struct ompi_communicator_t *comm,
+                                        coll_acoll_data_t *data)
+{
+    int err;
+    int size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    int my_ldr = data->l1_gp[0];
+    int *l1_ldr = (int *) malloc(sizeof(int) * size);
+    if (NULL == l1_ldr) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    err = comm->c_coll->coll_allgather(&my_ldr, 1, MPI_INT, l1_ldr, 1, MPI_INT, comm,
+                                       comm->c_coll->coll_allgather_module);
+    if (MPI_SUCCESS != err) {
+        free(l1_ldr);
+        return err;
+    }
+
+    for (int i = 0; i < size; i++) {
+        if (!coll_acoll_alltoall_shm_extra(l1_ldr, rank, my_ldr, i)) {
+            continue;
+        }
+        data->allshmmmap_sbuf[i] = opal_shmem_segment_attach(&data->allshmseg_id[i]);
+        if (NULL == data->allshmmmap_sbuf[i]) {
+            for (int j = 0; j < i; j++) {
+                if (coll_acoll_alltoall_shm_extra(l1_ldr, rank, my_ldr, j)) {
+                    opal_shmem_segment_detach(&data->allshmseg_id[j]);
+                    data->allshmmmap_sbuf[j] = NULL;
+                }
+            }
+            free(l1_ldr);
+            return OMPI_ERROR;
+        }
+    }
+    data->l1_ldr = l1_ldr;
+
+    return MPI_SUCCESS;
+}
+
+void coll_acoll_alltoall_shm_fini(coll_acoll_data_t *data, int rank)
+{
+    if (NULL == data->l1_ldr) {
+        return;
+    }
+    for (int i = 0; i < data->comm_size; i++) {
+        if (coll_acoll_alltoall_shm_extra(data->l1_ldr, rank, data->l1_gp[0], i)) {
+            opal_shmem_segment_detach(&data->allshmseg_id[i]);
+            data->allshmmmap_sbuf[i] = NULL;
+        }
+    }
+    free(data->l1_ldr);
+    data->l1_ldr = NULL;
+}
+
+/*
+ * Every rank copies its whole send buffer into its slot in its leader's
+ * segment, and after a barrier reads its block from each peer's slot.
+ * Peers are visited starting from the next rank, so that the slots are not
+ * all read by every rank at once.
+ */
+static inline int mca_coll_acoll_alltoall_shm(const void *sbuf, void *rbuf, size_t blk,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module,
+                                              coll_acoll_subcomms_t *subc)
+{
+    int err;
+    int size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+
+    coll_acoll_init(module, comm, subc->data, subc, 0);
+    coll_acoll_data_t *data = subc->data;
+    if (NULL == data) {
+        return -1;
+    }
+    if (NULL == data->l1_ldr) {
+        err = coll_acoll_alltoall_shm_init(comm, data);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    memcpy((char *) data->allshmmmap_sbuf[data->l1_gp[0]] + data->offset[3], sbuf, blk * size);
+    memcpy((char *) rbuf + rank * blk, (char *) sbuf + rank * blk, blk);
+
+    err = ompi_coll_base_barrier_intra_tree(comm, module);
+    if (MPI_SUCCESS != err) {
+        return err;
+    }
+
+    for (int i = 1; i < size; i++) {
+        int peer = (rank + i) % size;
+        char *slot = (char *) data->allshmmmap_sbuf[data->l1_ldr[peer]] + data->offset[2]
+                     + peer * PER_RANK_SHM_SIZE;
+        memcpy((char *) rbuf + peer * blk, slot + rank * blk, blk);
+    }
+
+    /* The slots may not be reused before all peers are done reading */
+    return ompi_coll_base_barrier_intra_tree(comm, module);
+}
+
+#ifdef HAVE_XPMEM_H
+/*
+ * Every rank maps its peers' send buffers and copies its block straight
+ * into its receive buffer, starting from the next rank.
+ */
+static inline int mca_coll_acoll_alltoall_xpmem(const void *sbuf, void *rbuf, size_t blk,
+                                                struct ompi_communicator_t *comm,
+                                                mca_coll_base_module_t *module,
+                                                coll_acoll_subcomms_t *subc)
+{
+    int err = MPI_SUCCESS;
+    int size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    size_t total_dsize = blk * size;
+
+    coll_acoll_init(module, comm, subc->data, subc, 0);
+    coll_acoll_data_t *data = subc->data;
+    if (NULL == data) {
+        return -1;
+    }
+
+    char *tmp_sbuf = (char *) sbuf;
+    if (0 == subc->xpmem_use_sr_buf) {
+        tmp_sbuf = (char *) data->scratch;
+        memcpy(tmp_sbuf, sbuf, total_dsize);
+    }
+    void *sbuf_vaddr[1] = {tmp_sbuf};
+
+    err = comm->c_coll->coll_allgather(sbuf_vaddr, sizeof(void *), MPI_BYTE, data->allshm_sbuf,
+                                       sizeof(void *), MPI_BYTE, comm,
+                                       comm->c_coll->coll_allgather_module);
+    if (MPI_SUCCESS != err) {
+        return err;
+    }
+
+    memcpy((char *) rbuf + rank * blk, (char *) sbuf + rank * blk, blk);
+    for (int i = 1; i < size; i++) {
+        int peer = (rank + i) % size;
+        char *src = (char *) coll_acoll_xpmem_map(data, peer, data->allshm_sbuf[peer],
+                                                  total_dsize);
+        if (NULL == src) {
+            err = OMPI_ERROR;
+            break;
+        }
+        memcpy((char *) rbuf + peer * blk, src + rank * blk, blk);
+    }
+
+    /* Send buffers must stay intact until all peers have read them */
+    ompi_coll_base_barrier_intra_tree(comm, module);
+
+    return err;
+}
+
+/*
+ * As above, with each rank first telling every peer, through a (small)
+ * alltoall, where its block lies in its send buffer.
+ */
+static inline int mca_coll_acoll_alltoallv_xpmem(const void *sbuf, ompi_count_array_t scounts,
+                                                 ompi_disp_array_t sdispls,
+                                                 struct ompi_datatype_t *sdtype, void *rbuf,
+                                                 ompi_count_array_t rcounts,
+                                                 ompi_disp_array_t rdispls,
+                                                 struct ompi_datatype_t *rdtype,
+                                                 struct ompi_communicator_t *comm,
+                                                 mca_coll_base_module_t *module,
+                                                 coll_acoll_subcomms_t *subc)
+{
+    int err;
+    int size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    ptrdiff_t sext, rext;
+    size_t rdsize;
+
+    coll_acoll_init(module, comm, subc->data, subc, 0);
+    coll_acoll_data_t *data = subc->data;
+    if (NULL == data) {
+        return -1;
+    }
+
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+    ompi_datatype_type_size(rdtype, &rdsize);
+
+    int64_t *soffs = (int64_t *) malloc(sizeof(int64_t) * 2 * size);
+    if (NULL == soffs) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    int64_t *roffs = soffs + size;
+    for (int i = 0; i < size; i++) {
+        soffs[i] = (int64_t) ompi_disp_array_get(sdispls, i) * sext;
+    }
+
+    err = comm->c_coll->coll_alltoall(soffs, 1, MPI_INT64_T, roffs, 1, MPI_INT64_T, comm,
+                                      comm->c_coll->coll_alltoall_module);
+    if (MPI_SUCCESS != err) {
+        free(soffs);
+        return err;
+    }
+
+    void *sbuf_vaddr[1] = {(void *) sbuf};
+    err = comm->c_coll->coll_allgather(sbuf_vaddr, sizeof(void *), MPI_BYTE, data->allshm_sbuf,
+                                       sizeof(void *), MPI_BYTE, comm,
+                                       comm->c_coll->coll_allgather_module);
+    if (MPI_SUCCESS != err) {
+        free(soffs);
+        return err;
+    }
+
+    for (int i = 0; i < size; i++) {
+        int peer = (rank + i) % size;
+        size_t len = ompi_count_array_get(rcounts, peer) * rdsize;
+        char *dst = (char *) rbuf + ompi_disp_array_get(rdispls, peer) * rext;
+        char *src;
+
+        if (0 == len) {
+            continue;
+        }
+        if (peer == rank) {
+            src = (char *) sbuf + soffs[rank];
+        } else {
+            src = (char *) coll_acoll_xpmem_map(data, peer,
+                                                (char *) data->allshm_sbuf[peer] + roffs[peer],
+                                                len);
+            if (NULL == src) {
+                err = OMPI_ERROR;
+                break;
+            }
+        }
+        memcpy(dst, src, len);
+    }
+    free(soffs);
+
+    ompi_coll_base_barrier_intra_tree(comm, module);
+
+    return err;
+}
+#endif
+
+/*
+ * mca_coll_acoll_alltoall
+ *
+ * Function:    Alltoall operation for single node
+ * Accepts:     Same arguments as MPI_Alltoall()
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Small messages are exchanged through the per-rank slots of
+ *              the shared memory segments, large ones are read directly from
+ *              the peers' send buffers with xpmem.
+ *
+ * Limitations: Contiguous datatypes only; other cases, and multinode
+ *              communicators, use the base algorithms.
+ *
+ * Memory:      No additional memory requirements beyond user-supplied buffers,
+ *              unless xpmem_use_sr_buf is disabled (scratch buffer is used).
+ *
+ */
+int mca_coll_acoll_alltoall(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                            void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                            struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    int size, alg, err;
+    size_t dsize, blk;
+    mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoall_intra_basic_inplace(rbuf, rcount, rdtype, comm, module);
+    }
+
+    size = ompi_comm_size(comm);
+    if (size < 4) {
+        return ompi_coll_base_alltoall_intra_pairwise(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                      comm, module);
+    }
+
+    /* The shared memory and xpmem variants move bytes */
+    if (!ompi_datatype_is_predefined(sdtype) || !ompi_datatype_is_predefined(rdtype)) {
+        return ompi_coll_base_alltoall_intra_pairwise(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                      comm, module);
+    }
+
+    ompi_datatype_type_size(rdtype, &dsize);
+    blk = dsize * rcount;
+
+    alg = coll_alltoall_decision_fixed(size, blk);
+
+    /* Obtain the subcomms structure */
+    coll_acoll_subcomms_t *subc = NULL;
+    err = check_and_create_subc(comm, acoll_module, &subc);
+
+    /* Fallback to pairwise if subc is not obtained */
+    if (NULL == subc) {
+        return ompi_coll_base_alltoall_intra_pairwise(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                      comm, module);
+    }
+
+    if (!subc->initialized) {
+        err = mca_coll_acoll_comm_split_init(comm, acoll_module, subc, 0);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    if (1 == subc->num_nodes) {
+        if (1 == alg) {
+            return mca_coll_acoll_alltoall_shm(sbuf, rbuf, blk, comm, module, subc);
+        }
+#ifdef HAVE_XPMEM_H
+        if ((2 == alg) && ((subc->xpmem_use_sr_buf != 0) || (subc->xpmem_buf_size >= blk * size))
+            && (subc->without_xpmem != 1)) {
+            return mca_coll_acoll_alltoall_xpmem(sbuf, rbuf, blk, comm, module, subc);
+        }
+#endif
+    }
+
+    if ((1 == alg) || (3 == alg)) {
+        return ompi_coll_base_alltoall_intra_bruck(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                   comm, module);
+    }
+    return ompi_coll_base_alltoall_intra_pairwise(sbuf, scount, sdtype, rbuf, rcount, rdtype, comm,
+                                                  module);
+}
+
+/*
+ * mca_coll_acoll_alltoallv
+ *
+ * Function:    Alltoallv operation for single node
+ * Accepts:     Same arguments as MPI_Alltoallv()
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Blocks are read directly from the peers' send buffers with
+ *              xpmem.
+ *
+ * Limitations: Requires xpmem_use_sr_buf, as the extent of the send buffers
+ *              isn't known in advance; otherwise pairwise is used.
+ *
+ * Memory:      No additional memory requirements beyond user-supplied buffers.
+ *
+ */
+int mca_coll_acoll_alltoallv(const void *sbuf, ompi_count_array_t scounts,
+                             ompi_disp_array_t sdispls, struct ompi_datatype_t *sdtype,
+                             void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdispls,
+                             struct ompi_datatype_t *rdtype, struct ompi_communicator_t *comm,
+                             mca_coll_base_module_t *module)
+{
+    int size, err;
+    mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoallv_intra_basic_inplace(rbuf, rcounts, rdispls, rdtype, comm,
+                                                           module);
+    }
+
+    size = ompi_comm_size(comm);
+    if ((size < 4) || !ompi_datatype_is_predefined(sdtype)
+        || !ompi_datatype_is_predefined(rdtype)) {
+        return ompi_coll_base_alltoallv_intra_pairwise(sbuf, scounts, sdispls, sdtype, rbuf,
+                                                       rcounts, rdispls, rdtype, comm, module);
+    }
+
+    /* Obtain the subcomms structure */
+    coll_acoll_subcomms_t *subc = NULL;
+    err = check_and_create_subc(comm, acoll_module, &subc);
+
+    /* Fallback to pairwise if subc is not obtained */
+    if (NULL == subc) {
+        return ompi_coll_base_alltoallv_intra_pairwise(sbuf, scounts, sdispls, sdtype, rbuf,
+                                                       rcounts, rdispls, rdtype, comm, module);
+    }
+
+    if (!subc->initialized) {
+        err = mca_coll_acoll_comm_split_init(comm, acoll_module, subc, 0);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+#ifdef HAVE_XPMEM_H
+    if ((1 == subc->num_nodes) && (subc->xpmem_use_sr_buf != 0) && (subc->without_xpmem != 1)) {
+        return mca_coll_acoll_alltoallv_xpmem(sbuf, scounts, sdispls, sdtype, rbuf, rcounts,
+                                              rdispls, rdtype, comm, module, subc);
+    }
+#endif
+
+    return ompi_coll_base_alltoallv_intra_pairwise(sbuf, scounts, sdispls, sdtype, rbuf, rcounts,
+                                                   rdispls, rdtype, comm, module);
+}
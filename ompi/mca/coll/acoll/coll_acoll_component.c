@@ -238,6 +238,9 @@ static void mca_coll_acoll_module_destruct(mca_coll_acoll_module_t *module)
             }
             coll_acoll_data_t *data = subc->data;
             if (NULL != data) {
+                if (subc->orig_comm != NULL) {
+                    coll_acoll_alltoall_shm_fini(data, ompi_comm_rank(subc->orig_comm));
+                }
 #ifdef HAVE_XPMEM_H
                 for (int j = 0; j < data->comm_size; j++) {
                     if (ompi_comm_rank(subc->orig_comm) == j) {
@@ -291,6 +294,8 @@ static void mca_coll_acoll_module_destruct(mca_coll_acoll_module_t *module)
                 data->l1_gp = NULL;
                 free(data->l2_gp);
                 data->l2_gp = NULL;
+                free(data->l1_ldr);
+                data->l1_ldr = NULL;
                 free(data);
                 data = NULL;
             }
@@ -158,10 +158,15 @@ mca_coll_base_module_t *mca_coll_acoll_comm_query(struct ompi_communicator_t *co
 
     acoll_module->super.coll_allgather = mca_coll_acoll_allgather;
     acoll_module->super.coll_allreduce = mca_coll_acoll_allreduce_intra;
+    acoll_module->super.coll_alltoall = mca_coll_acoll_alltoall;
+    acoll_module->super.coll_alltoallv = mca_coll_acoll_alltoallv;
     acoll_module->super.coll_barrier = mca_coll_acoll_barrier_intra;
     acoll_module->super.coll_bcast = mca_coll_acoll_bcast;
     acoll_module->super.coll_gather = mca_coll_acoll_gather_intra;
     acoll_module->super.coll_reduce = mca_coll_acoll_reduce_intra;
+    acoll_module->super.coll_reduce_scatter = mca_coll_acoll_reduce_scatter_intra;
+    acoll_module->super.coll_reduce_scatter_block = mca_coll_acoll_reduce_scatter_block_intra;
+    acoll_module->super.coll_scatter = mca_coll_acoll_scatter_intra;
 
     return &(acoll_module->super);
 }
@@ -181,10 +186,15 @@ static int acoll_module_enable(mca_coll_base_module_t *module, struct ompi_commu
 
    ACOLL_INSTALL_COLL_API(comm, acoll_module, allgather);
    ACOLL_INSTALL_COLL_API(comm, acoll_module, allreduce);
+   ACOLL_INSTALL_COLL_API(comm, acoll_module, alltoall);
+   ACOLL_INSTALL_COLL_API(comm, acoll_module, alltoallv);
    ACOLL_INSTALL_COLL_API(comm, acoll_module, barrier);
    ACOLL_INSTALL_COLL_API(comm, acoll_module, bcast);
    ACOLL_INSTALL_COLL_API(comm, acoll_module, gather);
    ACOLL_INSTALL_COLL_API(comm, acoll_module, reduce);
+   ACOLL_INSTALL_COLL_API(comm, acoll_module, reduce_scatter);
+   ACOLL_INSTALL_COLL_API(comm, acoll_module, reduce_scatter_block);
+   ACOLL_INSTALL_COLL_API(comm, acoll_module, scatter);
 
    /* Initialize k-nomial tree */
     module->base_data->cached_kmtree = NULL;
@@ -201,10 +211,15 @@ static int acoll_module_disable(mca_coll_base_module_t *module, struct ompi_comm
 
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, allgather);
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, allreduce);
+    ACOLL_UNINSTALL_COLL_API(comm, acoll_module, alltoall);
+    ACOLL_UNINSTALL_COLL_API(comm, acoll_module, alltoallv);
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, barrier);
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, bcast);
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, gather);
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, reduce);
+    ACOLL_UNINSTALL_COLL_API(comm, acoll_module, reduce_scatter);
+    ACOLL_UNINSTALL_COLL_API(comm, acoll_module, reduce_scatter_block);
+    ACOLL_UNINSTALL_COLL_API(comm, acoll_module, scatter);
 
     return OMPI_SUCCESS;
 }
@@ -0,0 +1,267 @@
+/* -*- Mode: C; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/op/op.h"
+#include "opal/util/bit_ops.h"
+#include "coll_acoll.h"
+#include "coll_acoll_utils.h"
+
+static inline int coll_reduce_scatter_decision_fixed(int comm_size, size_t msg_size)
+{
+    /* Set default to ring */
+    int alg = 0;
+    if (msg_size <= 65536) {
+        /* Recursive halving */
+        alg = 1;
+    } else if (msg_size >= 262144) {
+        /* Reduce (xpmem) followed by single-copy reads */
+        alg = 2;
+    }
+    return alg;
+}
+
+#ifdef HAVE_XPMEM_H
+/*
+ * Reduce to rank 0, which broadcasts the address of the result; every rank
+ * then reads its segment directly from it. rcounts may be 0, in which case
+ * all segments are rcount elements long.
+ */
+static inline int mca_coll_acoll_reduce_scatter_xpmem(const void *sbuf, void *rbuf,
+                                                      ompi_count_array_t rcounts, size_t rcount,
+                                                      struct ompi_datatype_t *dtype,
+                                                      struct ompi_op_t *op,
+                                                      struct ompi_communicator_t *comm,
+                                                      mca_coll_base_module_t *module,
+                                                      coll_acoll_subcomms_t *subc)
+{
+    int err;
+    int size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    size_t dsize, count = 0, disp = 0;
+    size_t my_count = (0 != rcounts) ? ompi_count_array_get(rcounts, rank) : rcount;
+    mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
+    coll_acoll_reserve_mem_t *reserve_mem_rs = &(acoll_module->reserve_mem_s);
+
+    coll_acoll_init(module, comm, subc->data, subc, 0);
+    coll_acoll_data_t *data = subc->data;
+    if (NULL == data) {
+        return -1;
+    }
+
+    ompi_datatype_type_size(dtype, &dsize);
+    for (int i = 0; i < size; i++) {
+        size_t c = (0 != rcounts) ? ompi_count_array_get(rcounts, i) : rcount;
+        if (i < rank) {
+            disp += c;
+        }
+        count += c;
+    }
+
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    char *tmp_rbuf = NULL;
+    if (0 == rank) {
+        tmp_rbuf = (char *) coll_acoll_buf_alloc(reserve_mem_rs, count * dsize);
+        if (NULL == tmp_rbuf) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    }
+
+    err = mca_coll_acoll_reduce_intra(sbuf, tmp_rbuf, count, dtype, op, 0, comm, module);
+    if (MPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    void *rbuf_vaddr[1] = {tmp_rbuf};
+    err = comm->c_coll->coll_bcast(rbuf_vaddr, sizeof(void *), MPI_BYTE, 0, comm,
+                                   comm->c_coll->coll_bcast_module);
+    if (MPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    if (0 == rank) {
+        memcpy(rbuf, tmp_rbuf, my_count * dsize);
+    } else if (my_count > 0) {
+        char *src = (char *) coll_acoll_xpmem_map(data, 0,
+                                                  (char *) rbuf_vaddr[0] + disp * dsize,
+                                                  my_count * dsize);
+        if (NULL == src) {
+            err = OMPI_ERROR;
+        } else {
+            memcpy(rbuf, src, my_count * dsize);
+        }
+    }
+
+    /* The result must stay intact until all ranks have read it */
+    ompi_coll_base_barrier_intra_tree(comm, module);
+
+cleanup:
+    if (NULL != tmp_rbuf) {
+        coll_acoll_buf_free(reserve_mem_rs, tmp_rbuf);
+    }
+    return err;
+}
+#endif
+
+/*
+ * Common decision for reduce_scatter and reduce_scatter_block; returns
+ * OMPI_ERR_NOT_AVAILABLE if the caller should use a base algorithm.
+ */
+static int mca_coll_acoll_reduce_scatter_common(const void *sbuf, void *rbuf,
+                                                ompi_count_array_t rcounts, size_t rcount,
+                                                size_t total_dsize, struct ompi_datatype_t *dtype,
+                                                struct ompi_op_t *op,
+                                                struct ompi_communicator_t *comm,
+                                                mca_coll_base_module_t *module, int *alg)
+{
+    int err;
+    mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
+
+    *alg = coll_reduce_scatter_decision_fixed(ompi_comm_size(comm), total_dsize);
+    if (2 != *alg) {
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    /* Obtain the subcomms structure */
+    coll_acoll_subcomms_t *subc = NULL;
+    err = check_and_create_subc(comm, acoll_module, &subc);
+    if (NULL == subc) {
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    if (!subc->initialized) {
+        err = mca_coll_acoll_comm_split_init(comm, acoll_module, subc, 0);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+#ifdef HAVE_XPMEM_H
+    if ((1 == subc->num_nodes) && (subc->without_xpmem != 1)) {
+        return mca_coll_acoll_reduce_scatter_xpmem(sbuf, rbuf, rcounts, rcount, dtype, op, comm,
+                                                   module, subc);
+    }
+#endif
+
+    return OMPI_ERR_NOT_AVAILABLE;
+}
+
+/*
+ * mca_coll_acoll_reduce_scatter_intra
+ *
+ * Function:    Reduce_scatter operation for single node
+ * Accepts:     Same arguments as MPI_Reduce_scatter()
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Large messages are reduced to rank 0 using acoll's reduce,
+ *              after which every rank reads its segment of the result
+ *              directly with xpmem.
+ *
+ * Limitations: Commutative operators and predefined datatypes only; other
+ *              cases use the base algorithms.
+ *
+ * Memory:      Rank 0 uses a temporary buffer of the size of the full vector.
+ *
+ */
+int mca_coll_acoll_reduce_scatter_intra(const void *sbuf, void *rbuf, ompi_count_array_t rcounts,
+                                        struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module)
+{
+    int size, alg = 0, err;
+    size_t dsize, count = 0;
+
+    size = ompi_comm_size(comm);
+
+    /* Falling back to nonoverlapping for non-commutative operators to be safe */
+    if (!ompi_op_is_commute(op)) {
+        return ompi_coll_base_reduce_scatter_intra_nonoverlapping(sbuf, rbuf, rcounts, dtype, op,
+                                                                  comm, module);
+    }
+
+    for (int i = 0; i < size; i++) {
+        count += ompi_count_array_get(rcounts, i);
+    }
+    ompi_datatype_type_size(dtype, &dsize);
+
+    if ((size >= 4) && ompi_datatype_is_predefined(dtype)) {
+        err = mca_coll_acoll_reduce_scatter_common(sbuf, rbuf, rcounts, 0, count * dsize, dtype,
+                                                   op, comm, module, &alg);
+        if (OMPI_ERR_NOT_AVAILABLE != err) {
+            return err;
+        }
+    }
+
+    if (1 == alg) {
+        return ompi_coll_base_reduce_scatter_intra_basic_recursivehalving(sbuf, rbuf, rcounts,
+                                                                          dtype, op, comm, module);
+    }
+    return ompi_coll_base_reduce_scatter_intra_ring(sbuf, rbuf, rcounts, dtype, op, comm, module);
+}
+
+/*
+ * mca_coll_acoll_reduce_scatter_block_intra
+ *
+ * Function:    Reduce_scatter_block operation for single node
+ * Accepts:     Same arguments as MPI_Reduce_scatter_block()
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Same as mca_coll_acoll_reduce_scatter_intra, with equal
+ *              segments.
+ *
+ * Limitations: Commutative operators and predefined datatypes only; other
+ *              cases use the base algorithms.
+ *
+ * Memory:      Rank 0 uses a temporary buffer of the size of the full vector.
+ *
+ */
+int mca_coll_acoll_reduce_scatter_block_intra(const void *sbuf, void *rbuf, size_t rcount,
+                                              struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module)
+{
+    int size, alg = 0, err;
+    size_t dsize;
+
+    size = ompi_comm_size(comm);
+
+    /* Falling back to basic linear for non-commutative operators to be safe */
+    if (!ompi_op_is_commute(op)) {
+        return ompi_coll_base_reduce_scatter_block_basic_linear(sbuf, rbuf, rcount, dtype, op,
+                                                                comm, module);
+    }
+
+    ompi_datatype_type_size(dtype, &dsize);
+
+    if ((size >= 4) && ompi_datatype_is_predefined(dtype)) {
+        err = mca_coll_acoll_reduce_scatter_common(sbuf, rbuf, 0, rcount, rcount * size * dsize,
+                                                   dtype, op, comm, module, &alg);
+        if (OMPI_ERR_NOT_AVAILABLE != err) {
+            return err;
+        }
+    }
+
+    if (1 == alg) {
+        return ompi_coll_base_reduce_scatter_block_intra_recursivehalving(sbuf, rbuf, rcount,
+                                                                          dtype, op, comm, module);
+    }
+    return ompi_coll_base_reduce_scatter_block_intra_butterfly(sbuf, rbuf, rcount, dtype, op, comm,
+                                                               module);
+}
@@ -0,0 +1,252 @@
+/* -*- Mode: C; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/pml/pml.h"
+#include "opal/util/bit_ops.h"
+#include "coll_acoll.h"
+#include "coll_acoll_utils.h"
+
+#ifdef HAVE_XPMEM_H
+/*
+ * The root broadcasts the address of its send buffer, and every rank reads
+ * its block directly from it. Returns OMPI_ERR_NOT_AVAILABLE (on all ranks)
+ * if the root's buffer can't be read as plain bytes.
+ */
+static inline int mca_coll_acoll_scatter_xpmem(const void *sbuf, size_t scount,
+                                               struct ompi_datatype_t *sdtype, void *rbuf,
+                                               size_t rcount, struct ompi_datatype_t *rdtype,
+                                               size_t blk, int root,
+                                               struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module,
+                                               coll_acoll_subcomms_t *subc)
+{
+    int err;
+    int size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+
+    coll_acoll_init(module, comm, subc->data, subc, 0);
+    coll_acoll_data_t *data = subc->data;
+    if (NULL == data) {
+        return -1;
+    }
+
+    char *tmp_sbuf = NULL;
+    if ((rank == root) && ompi_datatype_is_predefined(sdtype)) {
+        tmp_sbuf = (char *) sbuf;
+        if (0 == subc->xpmem_use_sr_buf) {
+            tmp_sbuf = (char *) data->scratch;
+            memcpy(tmp_sbuf, sbuf, blk * size);
+        }
+    }
+
+    err = comm->c_coll->coll_bcast(&tmp_sbuf, sizeof(void *), MPI_BYTE, root, comm,
+                                   comm->c_coll->coll_bcast_module);
+    if (MPI_SUCCESS != err) {
+        return err;
+    }
+    if (NULL == tmp_sbuf) {
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    if (rank == root) {
+        if (MPI_IN_PLACE != rbuf) {
+            err = ompi_datatype_sndrcv((char *) sbuf + blk * root, scount, sdtype, rbuf, rcount,
+                                       rdtype);
+        }
+    } else {
+        char *src = (char *) coll_acoll_xpmem_map(data, root, tmp_sbuf + blk * rank, blk);
+        if (NULL == src) {
+            err = OMPI_ERROR;
+        } else if (ompi_datatype_is_predefined(rdtype)) {
+            memcpy(rbuf, src, blk);
+        } else {
+            err = ompi_datatype_sndrcv(src, blk, MPI_PACKED, rbuf, rcount, rdtype);
+        }
+    }
+
+    /* The root's buffer must stay intact until all ranks have read it */
+    ompi_coll_base_barrier_intra_tree(comm, module);
+
+    return err;
+}
+#endif
+
+/*
+ * mca_coll_acoll_scatter_intra
+ *
+ * Function:    Scatter operation using subgroup based algorithm
+ * Accepts:     Same arguments as MPI_Scatter()
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: The root sends the blocks of each subgroup to its base rank
+ *              in a single message, and the base ranks distribute them
+ *              within their subgroups. On a single node, large messages are
+ *              read directly from the root's buffer with xpmem instead.
+ *
+ * Limitations: Current implementation is optimal only for map-by core.
+ *
+ * Memory:      The base rank of each subgroup may create temporary buffer.
+ *
+ */
+int mca_coll_acoll_scatter_intra(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                                 void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                                 int root, struct ompi_communicator_t *comm,
+                                 mca_coll_base_module_t *module)
+{
+    int i, err, rank, size;
+    char *wkg = NULL, *workbuf = NULL;
+    MPI_Aint sextent, rextent, rgap = 0, rsize;
+    int sg_cnt, cur_sg, root_sg;
+    int is_base, startr, endr;
+    mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
+    coll_acoll_reserve_mem_t *reserve_mem_scatter = &(acoll_module->reserve_mem_s);
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    if (size < 4) {
+        return ompi_coll_base_scatter_intra_basic_linear(sbuf, scount, sdtype, rbuf, rcount,
+                                                         rdtype, root, comm, module);
+    }
+
+    /* Obtain the subcomms structure */
+    coll_acoll_subcomms_t *subc = NULL;
+    err = check_and_create_subc(comm, acoll_module, &subc);
+
+    /* Fallback to binomial if subc is not obtained */
+    if (NULL == subc) {
+        return ompi_coll_base_scatter_intra_binomial(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                     root, comm, module);
+    }
+
+    if (!subc->initialized) {
+        err = mca_coll_acoll_comm_split_init(comm, acoll_module, subc, 0);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    if (1 != subc->num_nodes) {
+        return ompi_coll_base_scatter_intra_binomial(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                     root, comm, module);
+    }
+
+#ifdef HAVE_XPMEM_H
+    size_t dsize, blk;
+
+    /* Size of a single block; the same on all ranks */
+    if (rank == root) {
+        ompi_datatype_type_size(sdtype, &dsize);
+        blk = dsize * scount;
+    } else {
+        ompi_datatype_type_size(rdtype, &dsize);
+        blk = dsize * rcount;
+    }
+
+    if ((blk >= 65536) && ((subc->xpmem_use_sr_buf != 0) || (subc->xpmem_buf_size >= blk * size))
+        && (subc->without_xpmem != 1)) {
+        err = mca_coll_acoll_scatter_xpmem(sbuf, scount, sdtype, rbuf, rcount, rdtype, blk, root,
+                                           comm, module, subc);
+        if (OMPI_ERR_NOT_AVAILABLE != err) {
+            return err;
+        }
+    }
+#endif
+
+    sg_cnt = acoll_module->sg_cnt;
+    cur_sg = rank / sg_cnt;
+    root_sg = root / sg_cnt;
+    startr = cur_sg * sg_cnt;
+    endr = startr + sg_cnt;
+    if (endr > size) {
+        endr = size;
+    }
+    is_base = (rank == startr) && (cur_sg != root_sg);
+
+    if (rank == root) {
+        ompi_datatype_type_extent(sdtype, &sextent);
+
+        /* The other subgroups' blocks first, so that they can be forwarded
+         * while the root serves its own subgroup */
+        for (i = 0; i < size; i += sg_cnt) {
+            size_t send_amt = (i + sg_cnt > size) ? scount * (size - i) : scount * sg_cnt;
+            MPI_Aint snd_ofst = sextent * (ptrdiff_t) (scount * i);
+            if (i / sg_cnt == root_sg) {
+                continue;
+            }
+            err = MCA_PML_CALL(send((char *) sbuf + snd_ofst, send_amt, sdtype, i,
+                                    MCA_COLL_BASE_TAG_SCATTER, MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != err) {
+                return err;
+            }
+        }
+        for (i = startr; i < endr; i++) {
+            MPI_Aint snd_ofst = sextent * (ptrdiff_t) (scount * i);
+            if (i == root) {
+                continue;
+            }
+            err = MCA_PML_CALL(send((char *) sbuf + snd_ofst, scount, sdtype, i,
+                                    MCA_COLL_BASE_TAG_SCATTER, MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != err) {
+                return err;
+            }
+        }
+        if (MPI_IN_PLACE != rbuf) {
+            MPI_Aint root_ofst = sextent * (ptrdiff_t) (scount * root);
+            return ompi_datatype_sndrcv((char *) sbuf + root_ofst, scount, sdtype, rbuf, rcount,
+                                        rdtype);
+        }
+        return MPI_SUCCESS;
+    }
+
+    if (!is_base) {
+        int peer = (cur_sg == root_sg) ? root : startr;
+        return MCA_PML_CALL(recv(rbuf, rcount, rdtype, peer, MCA_COLL_BASE_TAG_SCATTER, comm,
+                                 MPI_STATUS_IGNORE));
+    }
+
+    /* Base ranks receive the blocks of their subgroup and distribute them */
+    ompi_datatype_type_extent(rdtype, &rextent);
+    rsize = opal_datatype_span(&rdtype->super, rcount * (endr - startr), &rgap);
+    workbuf = (char *) coll_acoll_buf_alloc(reserve_mem_scatter, rsize);
+    if (NULL == workbuf) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    wkg = workbuf - rgap;
+
+    err = MCA_PML_CALL(recv(wkg, rcount * (endr - startr), rdtype, root,
+                            MCA_COLL_BASE_TAG_SCATTER, comm, MPI_STATUS_IGNORE));
+    if (MPI_SUCCESS != err) {
+        coll_acoll_buf_free(reserve_mem_scatter, workbuf);
+        return err;
+    }
+    for (i = startr + 1; i < endr; i++) {
+        MPI_Aint snd_ofst = rextent * (ptrdiff_t) (rcount * (i - startr));
+        err = MCA_PML_CALL(send(wkg + snd_ofst, rcount, rdtype, i, MCA_COLL_BASE_TAG_SCATTER,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) {
+            coll_acoll_buf_free(reserve_mem_scatter, workbuf);
+            return err;
+        }
+    }
+    err = ompi_datatype_copy_content_same_ddt(rdtype, rcount, (char *) rbuf, wkg);
+
+    coll_acoll_buf_free(reserve_mem_scatter, workbuf);
+
+    return err;
+}
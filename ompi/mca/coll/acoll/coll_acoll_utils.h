@@ -762,6 +762,7 @@ static inline int coll_acoll_init(mca_coll_base_module_t *module, ompi_communica
     data->offset[3] = data->offset[2] + rank * PER_RANK_SHM_SIZE;
     data->allshmseg_id = (opal_shmem_ds_t *) malloc(sizeof(opal_shmem_ds_t) * size);
     data->allshmmmap_sbuf = (void **) malloc(sizeof(void *) * size);
+    data->l1_ldr = NULL;
     data->sync[0] = 0;
     data->sync[1] = 0;
     char *shfn;
@@ -928,4 +929,26 @@ static inline void register_and_cache(int size, size_t total_dsize, int rank,
         }
     }
 }
+
+/* Register (and cache) len bytes at addr in peer's address space, and
+ * return where they are mapped in ours, or NULL on failure. */
+static inline void *coll_acoll_xpmem_map(coll_acoll_data_t *data, int peer, void *addr,
+                                         size_t len)
+{
+    uintptr_t base, bound;
+    struct acoll_xpmem_rcache_reg_t *reg = NULL;
+    mca_rcache_base_module_t *rcache_i = data->rcache[peer];
+
+    base = OPAL_DOWN_ALIGN((uintptr_t) addr, 4096, uintptr_t);
+    bound = OPAL_ALIGN((uintptr_t) addr + len, 4096, uintptr_t);
+    int ret = rcache_i->rcache_register(rcache_i, (void *) base, bound - base, 0,
+                                        MCA_RCACHE_ACCESS_ANY,
+                                        (mca_rcache_base_registration_t **) &reg);
+    if (ret != 0) {
+        return NULL;
+    }
+    update_rcache_reg_hashtable_entry(reg, data->xpmem_reg_tracker_ht[peer]);
+
+    return (void *) ((uintptr_t) reg->xpmem_vaddr + ((uintptr_t) addr - (uintptr_t) reg->base.base));
+}
 #endif
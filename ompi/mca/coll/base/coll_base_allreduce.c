@@ -408,11 +408,9 @@ ompi_coll_base_allreduce_intra_ring(const void *sbuf, void *rbuf, size_t count,
         if (NULL == inbuf[1]) { ret = -1; line = __LINE__; goto error_hndl; }
     }
 
-    /* Handle MPI_IN_PLACE */
-    if (MPI_IN_PLACE != sbuf) {
-        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
-        if (ret < 0) { line = __LINE__; goto error_hndl; }
-    }
+    /* Without MPI_IN_PLACE sbuf is not copied into rbuf: my block is sent
+       from sbuf (and received back in the distribution loop), and the first
+       reduction of the other blocks reads sbuf and writes rbuf at once. */
 
     /* Computation loop */
 
@@ -444,7 +442,7 @@ ompi_coll_base_allreduce_intra_ring(const void *sbuf, void *rbuf, size_t count,
                     ((ptrdiff_t)rank * (ptrdiff_t)early_segcount) :
                     ((ptrdiff_t)rank * (ptrdiff_t)late_segcount + split_rank));
     block_count = ((rank < split_rank)? early_segcount : late_segcount);
-    tmpsend = ((char*)rbuf) + block_offset * extent;
+    tmpsend = ((MPI_IN_PLACE == sbuf) ? (char*)rbuf : (char*)sbuf) + block_offset * extent;
     ret = MCA_PML_CALL(send(tmpsend, block_count, dtype, send_to,
                             MCA_COLL_BASE_TAG_ALLREDUCE,
                             MCA_PML_BASE_SEND_STANDARD, comm));
@@ -472,7 +470,13 @@ ompi_coll_base_allreduce_intra_ring(const void *sbuf, void *rbuf, size_t count,
                         ((ptrdiff_t)prevblock * late_segcount + split_rank));
         block_count = ((prevblock < split_rank)? early_segcount : late_segcount);
         tmprecv = ((char*)rbuf) + (ptrdiff_t)block_offset * extent;
-        ompi_op_reduce(op, inbuf[inbi ^ 0x1], tmprecv, block_count, dtype);
+        if (MPI_IN_PLACE == sbuf) {
+            ompi_op_reduce(op, inbuf[inbi ^ 0x1], tmprecv, block_count, dtype);
+        } else {
+            ompi_3buff_op_reduce(op, inbuf[inbi ^ 0x1],
+                                 (char*)sbuf + (ptrdiff_t)block_offset * extent,
+                                 tmprecv, block_count, dtype);
+        }
 
         /* send previous block to send_to */
         ret = MCA_PML_CALL(send(tmprecv, block_count, dtype, send_to,
@@ -493,7 +497,12 @@ ompi_coll_base_allreduce_intra_ring(const void *sbuf, void *rbuf, size_t count,
                     ((ptrdiff_t)recv_from * late_segcount + split_rank));
     block_count = ((recv_from < split_rank)? early_segcount : late_segcount);
     tmprecv = ((char*)rbuf) + (ptrdiff_t)block_offset * extent;
-    ompi_op_reduce(op, inbuf[inbi], tmprecv, block_count, dtype);
+    if (MPI_IN_PLACE == sbuf) {
+        ompi_op_reduce(op, inbuf[inbi], tmprecv, block_count, dtype);
+    } else {
+        ompi_3buff_op_reduce(op, inbuf[inbi], (char*)sbuf + (ptrdiff_t)block_offset * extent,
+                             tmprecv, block_count, dtype);
+    }
 
     /* Distribution loop - variation of ring allgather */
     send_to = (rank + 1) % size;
@@ -696,11 +705,9 @@ ompi_coll_base_allreduce_intra_ring_segmented(const void *sbuf, void *rbuf, size
         if (NULL == inbuf[1]) { ret = -1; line = __LINE__; goto error_hndl; }
     }
 
-    /* Handle MPI_IN_PLACE */
-    if (MPI_IN_PLACE != sbuf) {
-        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
-        if (ret < 0) { line = __LINE__; goto error_hndl; }
-    }
+    /* Without MPI_IN_PLACE sbuf is not copied into rbuf: my block is sent
+       from sbuf (and received back in the distribution loop), and the first
+       reduction of the other blocks reads sbuf and writes rbuf at once. */
 
     /* Computation loop: for each phase, repeat ring allreduce computation loop */
     for (phase = 0; phase < num_phases; phase ++) {
@@ -746,7 +753,8 @@ ompi_coll_base_allreduce_intra_ring_segmented(const void *sbuf, void *rbuf, size
         phase_offset = ((phase < split_phase)?
                         ((ptrdiff_t)phase * (ptrdiff_t)early_phase_segcount) :
                         ((ptrdiff_t)phase * (ptrdiff_t)late_phase_segcount + split_phase));
-        tmpsend = ((char*)rbuf) + (ptrdiff_t)(block_offset + phase_offset) * extent;
+        tmpsend = ((MPI_IN_PLACE == sbuf) ? (char*)rbuf : (char*)sbuf) +
+            (ptrdiff_t)(block_offset + phase_offset) * extent;
         ret = MCA_PML_CALL(send(tmpsend, phase_count, dtype, send_to,
                                 MCA_COLL_BASE_TAG_ALLREDUCE,
                                 MCA_PML_BASE_SEND_STANDARD, comm));
@@ -783,7 +791,13 @@ ompi_coll_base_allreduce_intra_ring_segmented(const void *sbuf, void *rbuf, size
                             ((ptrdiff_t)phase * (ptrdiff_t)early_phase_segcount) :
                             ((ptrdiff_t)phase * (ptrdiff_t)late_phase_segcount + split_phase));
             tmprecv = ((char*)rbuf) + (ptrdiff_t)(block_offset + phase_offset) * extent;
-            ompi_op_reduce(op, inbuf[inbi ^ 0x1], tmprecv, phase_count, dtype);
+            if (MPI_IN_PLACE == sbuf) {
+                ompi_op_reduce(op, inbuf[inbi ^ 0x1], tmprecv, phase_count, dtype);
+            } else {
+                ompi_3buff_op_reduce(op, inbuf[inbi ^ 0x1],
+                                     (char*)sbuf + (ptrdiff_t)(block_offset + phase_offset) * extent,
+                                     tmprecv, phase_count, dtype);
+            }
 
             /* send previous block to send_to */
             ret = MCA_PML_CALL(send(tmprecv, phase_count, dtype, send_to,
@@ -812,7 +826,13 @@ ompi_coll_base_allreduce_intra_ring_segmented(const void *sbuf, void *rbuf, size
                         ((ptrdiff_t)phase * (ptrdiff_t)early_phase_segcount) :
                         ((ptrdiff_t)phase * (ptrdiff_t)late_phase_segcount + split_phase));
         tmprecv = ((char*)rbuf) + (ptrdiff_t)(block_offset + phase_offset) * extent;
-        ompi_op_reduce(op, inbuf[inbi], tmprecv, phase_count, dtype);
+        if (MPI_IN_PLACE == sbuf) {
+            ompi_op_reduce(op, inbuf[inbi], tmprecv, phase_count, dtype);
+        } else {
+            ompi_3buff_op_reduce(op, inbuf[inbi],
+                                 (char*)sbuf + (ptrdiff_t)(block_offset + phase_offset) * extent,
+                                 tmprecv, phase_count, dtype);
+        }
     }
 
     /* Distribution loop - variation of ring allgather */
@@ -1342,3 +1362,642 @@ err_hndl:
 
 }
 /* copied function (with appropriate renaming) ends here */
+
+/*
+ * Largest power of radix lower or equal to size, and its logarithm in nsteps.
+ */
+static int coll_base_allreduce_radix_pof(int size, int radix, int *nsteps)
+{
+    int pofk = 1;
+
+    for (*nsteps = 0; pofk <= size / radix; (*nsteps)++) {
+        pofk *= radix;
+    }
+    return pofk;
+}
+
+/*
+ * Fold the ranks above pofk into the first pofk ranks: rank r >= pofk sends
+ * its vector (in rbuf) to r % pofk, which reduces it into its own rbuf.
+ * tmp_buf must hold count elements.
+ */
+static int coll_base_allreduce_fold_in(void *rbuf, char *tmp_buf, size_t count,
+                                       struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                       struct ompi_communicator_t *comm, int pofk)
+{
+    int rank = ompi_comm_rank(comm), size = ompi_comm_size(comm), err = MPI_SUCCESS;
+
+    if (rank >= pofk) {
+        return MCA_PML_CALL(send(rbuf, count, dtype, rank % pofk, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                 MCA_PML_BASE_SEND_STANDARD, comm));
+    }
+    for (int extra = rank + pofk; extra < size; extra += pofk) {
+        err = MCA_PML_CALL(recv(tmp_buf, count, dtype, extra, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+        /* rbuf = tmp_buf <op> rbuf */
+        ompi_op_reduce(op, tmp_buf, rbuf, count, dtype);
+    }
+    return err;
+}
+
+/*
+ * Send back the result to the ranks folded by coll_base_allreduce_fold_in.
+ */
+static int coll_base_allreduce_fold_out(void *rbuf, size_t count, struct ompi_datatype_t *dtype,
+                                        struct ompi_communicator_t *comm, int pofk)
+{
+    int rank = ompi_comm_rank(comm), size = ompi_comm_size(comm), err = MPI_SUCCESS;
+
+    if (rank >= pofk) {
+        return MCA_PML_CALL(recv(rbuf, count, dtype, rank % pofk, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                 comm, MPI_STATUS_IGNORE));
+    }
+    for (int extra = rank + pofk; extra < size && MPI_SUCCESS == err; extra += pofk) {
+        err = MCA_PML_CALL(send(rbuf, count, dtype, extra, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+    }
+    return err;
+}
+
+/*
+ * Reduce the radix contributions of a group in the order of the group:
+ * bufs[0] <op> (bufs[1] <op> (... bufs[radix - 1])), so that all the
+ * members compute the same value. The result is stored in bufs[digit],
+ * the last reduction copying it there in the same pass when needed.
+ */
+static void coll_base_allreduce_fold_group(char **bufs, int radix, int digit, size_t count,
+                                           struct ompi_datatype_t *dtype, struct ompi_op_t *op)
+{
+    char *acc = bufs[radix - 1];
+
+    for (int j = radix - 2; j > 0; j--) {
+        ompi_op_reduce(op, bufs[j], acc, count, dtype);
+    }
+    if (digit == radix - 1) {
+        ompi_op_reduce(op, bufs[0], acc, count, dtype);
+    } else {
+        ompi_op_reduce_copy(op, bufs[0], acc, bufs[digit], count, dtype);
+    }
+}
+
+/*
+ *   ompi_coll_base_allreduce_intra_recursive_multiplying
+ *
+ *   Function:       Recursive multiplying algorithm for allreduce operation
+ *   Accepts:        Same as MPI_Allreduce(), plus radix
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    Generalization of recursive doubling to radix k: at each
+ *                   of the \log_k(p') steps, every rank exchanges its whole
+ *                   vector with the (k - 1) other members of its group of
+ *                   k ranks, and reduces the k vectors. The distance between
+ *                   the members of a group is multiplied by k at each step.
+ *                   With k > 2 there are fewer steps than with recursive
+ *                   doubling, and each step keeps (k - 1) messages in flight.
+ *
+ *                   If p is not a power of k, the ranks above the largest
+ *                   power of k p' first fold their vector into rank % p',
+ *                   and get the result back at the end.
+ *
+ *   Limitations:    Non-commutative operations are supported only if p is a
+ *                   power of k, otherwise recursive doubling is used.
+ *
+ *   Memory requirements (per process): (k - 1) * count * typesize
+ */
+int ompi_coll_base_allreduce_intra_recursive_multiplying(const void *sbuf, void *rbuf,
+                                                         size_t count,
+                                                         struct ompi_datatype_t *dtype,
+                                                         struct ompi_op_t *op,
+                                                         struct ompi_communicator_t *comm,
+                                                         mca_coll_base_module_t *module,
+                                                         int radix)
+{
+    int ret = MPI_SUCCESS, line, rank, size, pofk, nsteps, distance, nreqs, max_reqs = 0;
+    char *tmp_buf_raw = NULL, *tmp_buf, **bufs = NULL;
+    ompi_request_t **reqs = NULL;
+    ptrdiff_t span, gap = 0;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+    if (radix < 2) {
+        radix = 2;
+    }
+    if (radix > size) {
+        radix = size;
+    }
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allreduce_intra_recursive_multiplying radix %d rank %d", radix, rank));
+
+    if (MPI_IN_PLACE != sbuf) {
+        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (ret < 0) { line = __LINE__; goto error_hndl; }
+    }
+    if (1 == size || 0 == count) {
+        return MPI_SUCCESS;
+    }
+
+    pofk = coll_base_allreduce_radix_pof(size, radix, &nsteps);
+    if (pofk != size && !ompi_op_is_commute(op)) {
+        return ompi_coll_base_allreduce_intra_recursivedoubling(MPI_IN_PLACE, rbuf, count, dtype,
+                                                                op, comm, module);
+    }
+
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    tmp_buf_raw = (char*) malloc(span * (radix - 1));
+    bufs = (char**) malloc(sizeof(char*) * radix);
+    if (NULL == tmp_buf_raw || NULL == bufs) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+    tmp_buf = tmp_buf_raw - gap;
+
+    ret = coll_base_allreduce_fold_in(rbuf, tmp_buf, count, dtype, op, comm, pofk);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    if (rank < pofk) {
+        max_reqs = 2 * (radix - 1);
+        reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+        if (NULL == reqs) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+
+        for (distance = 1; distance < pofk; distance *= radix) {
+            int digit = (rank / distance) % radix;
+            int base = rank - digit * distance;
+
+            nreqs = 0;
+            for (int j = 0; j < radix; j++) {
+                int peer = base + j * distance;
+                if (j == digit) {
+                    bufs[j] = (char*) rbuf;
+                    continue;
+                }
+                bufs[j] = tmp_buf + span * (j < digit ? j : j - 1);
+                ret = MCA_PML_CALL(irecv(bufs[j], count, dtype, peer,
+                                         MCA_COLL_BASE_TAG_ALLREDUCE, comm, &reqs[nreqs++]));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+                ret = MCA_PML_CALL(isend(rbuf, count, dtype, peer,
+                                         MCA_COLL_BASE_TAG_ALLREDUCE,
+                                         MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            }
+            ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+            coll_base_allreduce_fold_group(bufs, radix, digit, count, dtype, op);
+        }
+    }
+
+    ret = coll_base_allreduce_fold_out(rbuf, count, dtype, comm, pofk);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    free(tmp_buf_raw);
+    free(bufs);
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, rank, ret));
+    (void)line;  // silence compiler warning
+    if (NULL != reqs) {
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    if (NULL != tmp_buf_raw) free(tmp_buf_raw);
+    if (NULL != bufs) free(bufs);
+    return ret;
+}
+
+/* Offset and length of the part j of a window of wcount elements split in radix parts */
+#define COLL_BASE_RADIX_PART(wcount, radix, j, offset, length)                   \
+    do {                                                                         \
+        size_t _q = (wcount) / (radix), _r = (wcount) % (radix);                 \
+        (offset) = (j) * _q + ((size_t)(j) < _r ? (size_t)(j) : _r);             \
+        (length) = _q + ((size_t)(j) < _r ? 1 : 0);                              \
+    } while (0)
+
+/*
+ *   ompi_coll_base_allreduce_intra_knomial_redscat_allgather
+ *
+ *   Function:       Radix k reduce-scatter followed by a radix k allgather
+ *   Accepts:        Same as MPI_Allreduce(), plus radix
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    Generalization of the Rabenseifner algorithm to radix k.
+ *                   The reduce-scatter runs in \log_k(p') steps: at each step
+ *                   the current window of the vector is split in k parts,
+ *                   each member of the group of k ranks sends the part of
+ *                   every other member to it and reduces the k copies of its
+ *                   own part, which becomes the window of the next step.
+ *                   The allgather then replays the steps in reverse order.
+ *                   Every rank sends and receives about 2 * count elements
+ *                   in total, like the Rabenseifner algorithm, in
+ *                   2 * \log_k(p') steps instead of 2 * \log_2(p').
+ *
+ *                   If p is not a power of k, the ranks above the largest
+ *                   power of k p' first fold their vector into rank % p',
+ *                   and get the result back at the end.
+ *
+ *   Limitations:    count >= p', otherwise recursive multiplying is used.
+ *                   Non-commutative operations are supported only if p is a
+ *                   power of k, otherwise recursive doubling is used.
+ *
+ *   Memory requirements (per process): about count * typesize
+ */
+int ompi_coll_base_allreduce_intra_knomial_redscat_allgather(const void *sbuf, void *rbuf,
+                                                             size_t count,
+                                                             struct ompi_datatype_t *dtype,
+                                                             struct ompi_op_t *op,
+                                                             struct ompi_communicator_t *comm,
+                                                             mca_coll_base_module_t *module,
+                                                             int radix)
+{
+    int ret = MPI_SUCCESS, line, rank, size, pofk, nsteps, step, distance, nreqs, max_reqs = 0;
+    char *tmp_buf_raw = NULL, *tmp_buf, **bufs = NULL;
+    size_t *wstart = NULL, *wcount = NULL, maxpart, offset, length, my_offset, my_length;
+    ompi_request_t **reqs = NULL;
+    ptrdiff_t extent, lb, span, part_span, gap = 0;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+    if (radix < 2) {
+        radix = 2;
+    }
+    if (radix > size) {
+        radix = size;
+    }
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allreduce_intra_knomial_redscat_allgather radix %d rank %d",
+                 radix, rank));
+
+    pofk = coll_base_allreduce_radix_pof(size, radix, &nsteps);
+    if (count < (size_t) pofk || 1 == size) {
+        return ompi_coll_base_allreduce_intra_recursive_multiplying(sbuf, rbuf, count, dtype, op,
+                                                                    comm, module, radix);
+    }
+    if (pofk != size && !ompi_op_is_commute(op)) {
+        return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype, op,
+                                                                comm, module);
+    }
+
+    if (MPI_IN_PLACE != sbuf) {
+        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (ret < 0) { line = __LINE__; goto error_hndl; }
+    }
+
+    /* The receive buffer holds either the whole vector of a folded rank,
+     * or (radix - 1) parts of the first window */
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    maxpart = (count + radix - 1) / radix;
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    part_span = opal_datatype_span(&dtype->super, maxpart, &gap);
+    if (span < part_span * (radix - 1)) {
+        span = part_span * (radix - 1);
+    }
+    tmp_buf_raw = (char*) malloc(span);
+    bufs = (char**) malloc(sizeof(char*) * radix);
+    wstart = (size_t*) malloc(sizeof(size_t) * 2 * (nsteps + 1));
+    if (NULL == tmp_buf_raw || NULL == bufs || NULL == wstart) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl;
+    }
+    tmp_buf = tmp_buf_raw - gap;
+    wcount = wstart + nsteps + 1;
+
+    ret = coll_base_allreduce_fold_in(rbuf, tmp_buf, count, dtype, op, comm, pofk);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    if (rank < pofk) {
+        max_reqs = 2 * (radix - 1);
+        reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+        if (NULL == reqs) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+
+        /*
+         * Reduce-scatter: the window of step s is [wstart[s], wstart[s] + wcount[s]),
+         * at the end each rank owns the reduced window wstart[nsteps].
+         */
+        wstart[0] = 0;
+        wcount[0] = count;
+        for (step = 0, distance = 1; distance < pofk; step++, distance *= radix) {
+            int digit = (rank / distance) % radix;
+            int base = rank - digit * distance;
+
+            COLL_BASE_RADIX_PART(wcount[step], radix, digit, my_offset, my_length);
+            my_offset += wstart[step];
+
+            nreqs = 0;
+            for (int j = 0; j < radix; j++) {
+                int peer = base + j * distance;
+                if (j == digit) {
+                    bufs[j] = (char*) rbuf + (ptrdiff_t) my_offset * extent;
+                    continue;
+                }
+                COLL_BASE_RADIX_PART(wcount[step], radix, j, offset, length);
+                bufs[j] = tmp_buf + part_span * (j < digit ? j : j - 1);
+                ret = MCA_PML_CALL(irecv(bufs[j], my_length, dtype, peer,
+                                         MCA_COLL_BASE_TAG_ALLREDUCE, comm, &reqs[nreqs++]));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+                ret = MCA_PML_CALL(isend((char*) rbuf + (ptrdiff_t)(wstart[step] + offset) * extent,
+                                         length, dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                         MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            }
+            ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+            coll_base_allreduce_fold_group(bufs, radix, digit, my_length, dtype, op);
+            wstart[step + 1] = my_offset;
+            wcount[step + 1] = my_length;
+        }
+
+        /* Allgather: replay the steps in reverse order, each rank sending its
+         * window of the next step to the other members of its group */
+        for (step = nsteps - 1, distance /= radix; step >= 0; step--, distance /= radix) {
+            int digit = (rank / distance) % radix;
+            int base = rank - digit * distance;
+
+            nreqs = 0;
+            for (int j = 0; j < radix; j++) {
+                int peer = base + j * distance;
+                if (j == digit) {
+                    continue;
+                }
+                COLL_BASE_RADIX_PART(wcount[step], radix, j, offset, length);
+                ret = MCA_PML_CALL(irecv((char*) rbuf + (ptrdiff_t)(wstart[step] + offset) * extent,
+                                         length, dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE, comm,
+                                         &reqs[nreqs++]));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+                ret = MCA_PML_CALL(isend((char*) rbuf + (ptrdiff_t) wstart[step + 1] * extent,
+                                         wcount[step + 1], dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                         MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            }
+            ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+    }
+
+    ret = coll_base_allreduce_fold_out(rbuf, count, dtype, comm, pofk);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    free(tmp_buf_raw);
+    free(bufs);
+    free(wstart);
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, rank, ret));
+    (void)line;  // silence compiler warning
+    if (NULL != reqs) {
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    if (NULL != tmp_buf_raw) free(tmp_buf_raw);
+    if (NULL != bufs) free(bufs);
+    if (NULL != wstart) free(wstart);
+    return ret;
+}
+
+/*
+ * Forward the final segment seg of rbuf to the children in the tree.
+ */
+static int coll_base_allreduce_tree_forward(void *rbuf, size_t seg, size_t segcount, size_t count,
+                                            ptrdiff_t extent, struct ompi_datatype_t *dtype,
+                                            ompi_coll_tree_t *tree,
+                                            struct ompi_communicator_t *comm)
+{
+    size_t length = (count - seg * segcount < segcount) ? count - seg * segcount : segcount;
+    char *buf = (char*) rbuf + (ptrdiff_t)(seg * segcount) * extent;
+    int err = MPI_SUCCESS;
+
+    for (int c = 0; c < tree->tree_nextsize && MPI_SUCCESS == err; c++) {
+        err = MCA_PML_CALL(send(buf, length, dtype, tree->tree_next[c],
+                                MCA_COLL_BASE_TAG_ALLREDUCE, MCA_PML_BASE_SEND_STANDARD, comm));
+    }
+    return err;
+}
+
+/*
+ * Message size (in bytes) for which the latency and the transfer time of a
+ * message are about the same, used to balance the pipeline of the tree
+ * algorithm when no segment size is given.
+ */
+#define COLL_BASE_ALLREDUCE_TREE_BALANCE_SIZE 8192
+
+/*
+ *   ompi_coll_base_allreduce_intra_tree_pipelined
+ *
+ *   Function:       Pipelined reduce and broadcast on a binary tree
+ *   Accepts:        Same as MPI_Allreduce(), plus segment size
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    The vector is split in segments, which are reduced up a
+ *                   binary tree rooted at rank 0 and broadcast back down the
+ *                   same tree. Unlike the nonoverlapping algorithm, the
+ *                   broadcast of a segment starts as soon as the root has
+ *                   reduced it, while the next segments are still being
+ *                   reduced, so that with n segments on a tree of depth d
+ *                   the cost is about (2d + n) (alpha + beta m / n). The
+ *                   tree does not depend on p being a power of two.
+ *
+ *                   If segsize is 0, the number of segments is chosen to
+ *                   balance the two terms: n = \sqrt{2d m / B}, where B is
+ *                   COLL_BASE_ALLREDUCE_TREE_BALANCE_SIZE.
+ *
+ *   Limitations:    Commutative operations only, otherwise the
+ *                   nonoverlapping algorithm is used.
+ *
+ *   Memory requirements (per process): 2 * (1 + number of children) segments
+ */
+int ompi_coll_base_allreduce_intra_tree_pipelined(const void *sbuf, void *rbuf, size_t count,
+                                                  struct ompi_datatype_t *dtype,
+                                                  struct ompi_op_t *op,
+                                                  struct ompi_communicator_t *comm,
+                                                  mca_coll_base_module_t *module,
+                                                  uint32_t segsize)
+{
+    int ret = MPI_SUCCESS, line, size, depth, nchild, window, max_reqs = 0, flag;
+    size_t typelng, segcount, nseg, seg, first_pending, length;
+    char *tmp_buf_raw = NULL, *tmp_buf, *acc[2], *child_buf[2];
+    ompi_request_t **reqs = NULL, **child_reqs, **send_reqs, **final_reqs;
+    mca_coll_base_comm_t *data = module->base_data;
+    ompi_coll_tree_t *tree;
+    ptrdiff_t extent, lb, seg_span, gap = 0;
+
+    size = ompi_comm_size(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allreduce_intra_tree_pipelined rank %d segsize %u",
+                 ompi_comm_rank(comm), segsize));
+
+    if (!ompi_op_is_commute(op)) {
+        return ompi_coll_base_allreduce_intra_nonoverlapping(sbuf, rbuf, count, dtype, op,
+                                                             comm, module);
+    }
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+    if (1 == size || 0 == count) {
+        if (sbuf != rbuf) {
+            ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        }
+        return ret;
+    }
+
+    COLL_BASE_UPDATE_BINTREE(comm, module, 0);
+    tree = data->cached_bintree;
+    nchild = tree->tree_nextsize;
+    depth = opal_hibit(size, comm->c_cube_dim + 1);    /* levels below the root */
+
+    ompi_datatype_type_size(dtype, &typelng);
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    if (0 == segsize) {
+        size_t total = typelng * count;
+        for (nseg = 1; nseg * nseg * COLL_BASE_ALLREDUCE_TREE_BALANCE_SIZE < 2 * depth * total;
+             nseg++);
+        segcount = (count + nseg - 1) / nseg;
+    } else {
+        segcount = count;
+        COLL_BASE_COMPUTED_SEGCOUNT(segsize, typelng, segcount);
+    }
+    nseg = (count + segcount - 1) / segcount;
+
+    /* Segments in flight between a rank and its parent: enough to cover
+     * the round trip to the root */
+    window = 2 * depth + 2;
+
+    /* Double buffering of the partial result and of the children's segments */
+    seg_span = opal_datatype_span(&dtype->super, segcount, &gap);
+    tmp_buf_raw = (char*) malloc(seg_span * 2 * (1 + nchild));
+    if (NULL == tmp_buf_raw) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+    tmp_buf = tmp_buf_raw - gap;
+    acc[0] = tmp_buf;
+    acc[1] = tmp_buf + seg_span;
+    child_buf[0] = tmp_buf + 2 * seg_span;
+    child_buf[1] = child_buf[0] + nchild * seg_span;
+
+    max_reqs = nchild + 2 + window;
+    reqs = ompi_coll_base_comm_get_reqs(data, max_reqs);
+    if (NULL == reqs) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+    child_reqs = reqs;
+    send_reqs = reqs + nchild;
+    final_reqs = reqs + nchild + 2;
+
+    for (int c = 0; c < nchild; c++) {
+        ret = MCA_PML_CALL(irecv(child_buf[0] + c * seg_span, segcount > count ? count : segcount,
+                                 dtype, tree->tree_next[c], MCA_COLL_BASE_TAG_ALLREDUCE, comm,
+                                 &child_reqs[c]));
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    }
+
+    first_pending = 0;
+    for (seg = 0; seg < nseg; seg++) {
+        ptrdiff_t offset = (ptrdiff_t)(seg * segcount) * extent;
+        char *target;
+
+        length = (seg + 1 < nseg) ? segcount : count - seg * segcount;
+
+        /* Reduce: wait for the children's partial results of this segment,
+         * and post the receives for the next one */
+        ret = ompi_request_wait_all(nchild, child_reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        if (seg + 1 < nseg) {
+            size_t next = (seg + 2 < nseg) ? segcount : count - (seg + 1) * segcount;
+            for (int c = 0; c < nchild; c++) {
+                ret = MCA_PML_CALL(irecv(child_buf[(seg + 1) % 2] + c * seg_span, next, dtype,
+                                         tree->tree_next[c], MCA_COLL_BASE_TAG_ALLREDUCE, comm,
+                                         &child_reqs[c]));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            }
+        }
+
+        if (-1 == tree->tree_prev) {
+            target = (char*) rbuf + offset;
+        } else {
+            target = acc[seg % 2];
+            ret = ompi_request_wait(&send_reqs[seg % 2], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        if (target == (char*) sbuf + offset) {
+            for (int c = 0; c < nchild; c++) {
+                ompi_op_reduce(op, child_buf[seg % 2] + c * seg_span, target, length, dtype);
+            }
+        } else if (nchild > 0) {
+            /* Reduce my contribution and the children's into target in a
+             * single call instead of copying sbuf first */
+            const void *sources[MAXTREEFANOUT + 1];
+            sources[0] = (char*) sbuf + offset;
+            for (int c = 0; c < nchild; c++) {
+                sources[c + 1] = child_buf[seg % 2] + c * seg_span;
+            }
+            ompi_op_reduce_nary(op, sources, nchild + 1, target, length, dtype);
+        } else {
+            ret = ompi_datatype_copy_content_same_ddt(dtype, length, target, (char*) sbuf + offset);
+            if (ret < 0) { line = __LINE__; goto error_hndl; }
+        }
+
+        if (-1 == tree->tree_prev) {
+            /* The root has the final segment: broadcast it */
+            for (int c = 0; c < nchild; c++) {
+                ret = MCA_PML_CALL(send(target, length, dtype, tree->tree_next[c],
+                                        MCA_COLL_BASE_TAG_ALLREDUCE,
+                                        MCA_PML_BASE_SEND_STANDARD, comm));
+                if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            }
+            continue;
+        }
+
+        /* Send the partial result up, and post the receive of the final
+         * segment; rbuf is not read anymore for this segment */
+        ret = MCA_PML_CALL(isend(target, length, dtype, tree->tree_prev,
+                                 MCA_COLL_BASE_TAG_ALLREDUCE, MCA_PML_BASE_SEND_STANDARD, comm,
+                                 &send_reqs[seg % 2]));
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        ret = MCA_PML_CALL(irecv((char*) rbuf + offset, length, dtype, tree->tree_prev,
+                                 MCA_COLL_BASE_TAG_ALLREDUCE, comm, &final_reqs[seg % window]));
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+        /* Broadcast: forward the final segments already received, waiting
+         * for the oldest one only if the window is full */
+        while (first_pending <= seg) {
+            ompi_request_t **req = &final_reqs[first_pending % window];
+            if (seg + 1 - first_pending >= (size_t) window) {
+                ret = ompi_request_wait(req, MPI_STATUS_IGNORE);
+            } else {
+                ret = ompi_request_test(req, &flag, MPI_STATUS_IGNORE);
+                if (MPI_SUCCESS == ret && !flag) {
+                    break;
+                }
+            }
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            ret = coll_base_allreduce_tree_forward(rbuf, first_pending, segcount, count, extent,
+                                                   dtype, tree, comm);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            first_pending++;
+        }
+    }
+
+    /* Drain the broadcast */
+    if (-1 != tree->tree_prev) {
+        for (; first_pending < nseg; first_pending++) {
+            ret = ompi_request_wait(&final_reqs[first_pending % window], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            ret = coll_base_allreduce_tree_forward(rbuf, first_pending, segcount, count, extent,
+                                                   dtype, tree, comm);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        ret = ompi_request_wait_all(2, send_reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    }
+
+    free(tmp_buf_raw);
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, ompi_comm_rank(comm), ret));
+    (void)line;  // silence compiler warning
+    if (NULL != reqs) {
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    if (NULL != tmp_buf_raw) free(tmp_buf_raw);
+    return ret;
+}
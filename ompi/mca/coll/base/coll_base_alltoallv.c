@@ -397,3 +397,781 @@ ompi_coll_base_alltoallv_intra_basic_linear(const void *sbuf, ompi_count_array_t
 
     return err;
 }
+
+/*
+ * Copy the block of the process to itself, from sbuf to rbuf.
+ */
+static inline int
+coll_base_alltoallv_self(const void *sbuf, ompi_count_array_t scounts, ompi_disp_array_t sdisps,
+                         struct ompi_datatype_t *sdtype, ptrdiff_t sext,
+                         void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdisps,
+                         struct ompi_datatype_t *rdtype, ptrdiff_t rext, int rank)
+{
+    size_t sdtype_size;
+
+    ompi_datatype_type_size(sdtype, &sdtype_size);
+    if (0 == ompi_count_array_get(scounts, rank) || 0 == sdtype_size) {
+        return MPI_SUCCESS;
+    }
+    return ompi_datatype_sndrcv((char *) sbuf + ompi_disp_array_get(sdisps, rank) * sext,
+                                ompi_count_array_get(scounts, rank), sdtype,
+                                (char *) rbuf + ompi_disp_array_get(rdisps, rank) * rext,
+                                ompi_count_array_get(rcounts, rank), rdtype);
+}
+
+/*
+ * Find a real error code in an array of completed requests.
+ */
+static inline int
+coll_base_alltoallv_reqs_error(ompi_request_t **reqs, int nreqs, int err)
+{
+    if (MPI_ERR_IN_STATUS == err) {
+        for (int i = 0; i < nreqs; i++) {
+            if (MPI_REQUEST_NULL == reqs[i]) continue;
+            if (MPI_ERR_PENDING == reqs[i]->req_status.MPI_ERROR) continue;
+            if (reqs[i]->req_status.MPI_ERROR != MPI_SUCCESS) {
+                return reqs[i]->req_status.MPI_ERROR;
+            }
+        }
+    }
+    return err;
+}
+
+/*
+ * ompi_coll_base_alltoallv_intra_sparse
+ *
+ * Function:    Nonblocking exchange with the peers that have data only
+ * Accepts:     Same arguments as MPI_Alltoallv()
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Unlike the basic linear algorithm, which creates persistent
+ *              requests, this algorithm posts plain nonblocking receives
+ *              and sends, and only to the peers with a non zero count: the
+ *              cost of a call depends on the number of actual messages and
+ *              not on the size of the communicator. Peers are visited in
+ *              rank + i order so that the first messages of all the ranks
+ *              do not target the same process.
+ *
+ *              This algorithm can be mixed with basic linear and scattered
+ *              between the ranks of a same call.
+ */
+int
+ompi_coll_base_alltoallv_intra_sparse(const void *sbuf, ompi_count_array_t scounts, ompi_disp_array_t sdisps,
+                                      struct ompi_datatype_t *sdtype,
+                                      void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdisps,
+                                      struct ompi_datatype_t *rdtype,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    int i, peer, size, rank, err, nreqs = 0, max_reqs = 0;
+    size_t sdtype_size, rdtype_size;
+    ptrdiff_t sext, rext;
+    ompi_request_t **reqs = NULL;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoallv_intra_basic_inplace(rbuf, rcounts, rdisps,
+                                                           rdtype, comm, module);
+    }
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:alltoallv_intra_sparse rank %d", rank));
+
+    ompi_datatype_type_size(sdtype, &sdtype_size);
+    ompi_datatype_type_size(rdtype, &rdtype_size);
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+
+    err = coll_base_alltoallv_self(sbuf, scounts, sdisps, sdtype, sext,
+                                   rbuf, rcounts, rdisps, rdtype, rext, rank);
+    if (MPI_SUCCESS != err || 1 == size) {
+        return err;
+    }
+
+    /* Size the request array to the actual number of messages */
+    for (i = 0; i < size; i++) {
+        if (i == rank) continue;
+        if (0 < ompi_count_array_get(rcounts, i) && 0 < rdtype_size) max_reqs++;
+        if (0 < ompi_count_array_get(scounts, i) && 0 < sdtype_size) max_reqs++;
+    }
+    if (0 == max_reqs) {
+        return MPI_SUCCESS;
+    }
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+    if (NULL == reqs) { return OMPI_ERR_OUT_OF_RESOURCE; }
+
+    for (i = 1; i < size; i++) {
+        peer = (rank + size - i) % size;
+        if (0 == ompi_count_array_get(rcounts, peer) || 0 == rdtype_size) {
+            continue;
+        }
+        err = MCA_PML_CALL(irecv((char *) rbuf + ompi_disp_array_get(rdisps, peer) * rext,
+                                 ompi_count_array_get(rcounts, peer), rdtype, peer,
+                                 MCA_COLL_BASE_TAG_ALLTOALLV, comm, &reqs[nreqs++]));
+        if (MPI_SUCCESS != err) { goto err_hndl; }
+    }
+    for (i = 1; i < size; i++) {
+        peer = (rank + i) % size;
+        if (0 == ompi_count_array_get(scounts, peer) || 0 == sdtype_size) {
+            continue;
+        }
+        err = MCA_PML_CALL(isend((char *) sbuf + ompi_disp_array_get(sdisps, peer) * sext,
+                                 ompi_count_array_get(scounts, peer), sdtype, peer,
+                                 MCA_COLL_BASE_TAG_ALLTOALLV, MCA_PML_BASE_SEND_STANDARD,
+                                 comm, &reqs[nreqs++]));
+        if (MPI_SUCCESS != err) { goto err_hndl; }
+    }
+
+    err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS == err) {
+        return MPI_SUCCESS;
+    }
+
+ err_hndl:
+    err = coll_base_alltoallv_reqs_error(reqs, nreqs, err);
+    ompi_coll_base_free_reqs(reqs, nreqs);
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "%s:%4d\tError occurred %d, rank %2d", __FILE__, __LINE__, err, rank));
+    return err;
+}
+
+/*
+ * Post in *req the receive from the next peer before rank - *dist, or the
+ * send to the next peer after rank + *dist, with a non zero count. Leaves
+ * *req to MPI_REQUEST_NULL once all the peers have been visited.
+ */
+static inline int
+coll_base_alltoallv_scattered_post(const void *sbuf, ompi_count_array_t scounts, ompi_disp_array_t sdisps,
+                                   struct ompi_datatype_t *sdtype, size_t sdtype_size, ptrdiff_t sext,
+                                   void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdisps,
+                                   struct ompi_datatype_t *rdtype, size_t rdtype_size, ptrdiff_t rext,
+                                   struct ompi_communicator_t *comm, int rank, int size,
+                                   bool recv, int *dist, ompi_request_t **req)
+{
+    for (; *dist < size; (*dist)++) {
+        int peer;
+        if (recv) {
+            peer = (rank + size - *dist) % size;
+            if (0 == ompi_count_array_get(rcounts, peer) || 0 == rdtype_size) continue;
+            (*dist)++;
+            return MCA_PML_CALL(irecv((char *) rbuf + ompi_disp_array_get(rdisps, peer) * rext,
+                                      ompi_count_array_get(rcounts, peer), rdtype, peer,
+                                      MCA_COLL_BASE_TAG_ALLTOALLV, comm, req));
+        }
+        peer = (rank + *dist) % size;
+        if (0 == ompi_count_array_get(scounts, peer) || 0 == sdtype_size) continue;
+        (*dist)++;
+        return MCA_PML_CALL(isend((char *) sbuf + ompi_disp_array_get(sdisps, peer) * sext,
+                                  ompi_count_array_get(scounts, peer), sdtype, peer,
+                                  MCA_COLL_BASE_TAG_ALLTOALLV, MCA_PML_BASE_SEND_STANDARD,
+                                  comm, req));
+    }
+    *req = MPI_REQUEST_NULL;
+    return MPI_SUCCESS;
+}
+
+/*
+ * ompi_coll_base_alltoallv_intra_scattered
+ *
+ * Function:    Nonblocking exchange with a bounded number of outstanding
+ *              requests
+ * Accepts:     Same arguments as MPI_Alltoallv(), plus the maximum number
+ *              of outstanding receives (and sends)
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Receives are posted from rank - 1, rank - 2, ... and sends
+ *              to rank + 1, rank + 2, ..., skipping the peers with a zero
+ *              count. At most max_requests receives and max_requests sends
+ *              are in flight, and a new one is posted as soon as one of the
+ *              same kind completes: a slow peer only holds one slot instead
+ *              of stalling the whole step as in the pairwise algorithm,
+ *              while the network is not flooded as with basic linear.
+ *
+ *              With max_requests <= 0 the window is not bounded.
+ *              This algorithm can be mixed with basic linear and sparse
+ *              between the ranks of a same call.
+ */
+int
+ompi_coll_base_alltoallv_intra_scattered(const void *sbuf, ompi_count_array_t scounts, ompi_disp_array_t sdisps,
+                                         struct ompi_datatype_t *sdtype,
+                                         void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdisps,
+                                         struct ompi_datatype_t *rdtype,
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_base_module_t *module,
+                                         int max_requests)
+{
+    int line = -1, size, rank, err, index, rdist = 1, sdist = 1;
+    size_t sdtype_size, rdtype_size;
+    ptrdiff_t sext, rext;
+    ompi_request_t **reqs = NULL;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoallv_intra_basic_inplace(rbuf, rcounts, rdisps,
+                                                           rdtype, comm, module);
+    }
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+    if (max_requests <= 0 || max_requests > size - 1) {
+        max_requests = size - 1;
+    }
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:alltoallv_intra_scattered rank %d max_requests %d", rank, max_requests));
+
+    ompi_datatype_type_size(sdtype, &sdtype_size);
+    ompi_datatype_type_size(rdtype, &rdtype_size);
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+
+    err = coll_base_alltoallv_self(sbuf, scounts, sdisps, sdtype, sext,
+                                   rbuf, rcounts, rdisps, rdtype, rext, rank);
+    if (MPI_SUCCESS != err || 1 == size) {
+        return err;
+    }
+
+    /* Receives use the first max_requests slots, sends the others */
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, 2 * max_requests);
+    if (NULL == reqs) { return OMPI_ERR_OUT_OF_RESOURCE; }
+
+    /* Fill all the slots, then refill each slot as it completes */
+    for (index = 0; index < 2 * max_requests; index++) {
+        err = coll_base_alltoallv_scattered_post(sbuf, scounts, sdisps, sdtype, sdtype_size, sext,
+                                                 rbuf, rcounts, rdisps, rdtype, rdtype_size, rext,
+                                                 comm, rank, size, index < max_requests,
+                                                 index < max_requests ? &rdist : &sdist,
+                                                 &reqs[index]);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    for (;;) {
+        /* MPI_UNDEFINED once all the slots are empty */
+        err = ompi_request_wait_any(2 * max_requests, reqs, &index, MPI_STATUS_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        if (MPI_UNDEFINED == index) {
+            break;
+        }
+        err = coll_base_alltoallv_scattered_post(sbuf, scounts, sdisps, sdtype, sdtype_size, sext,
+                                                 rbuf, rcounts, rdisps, rdtype, rdtype_size, rext,
+                                                 comm, rank, size, index < max_requests,
+                                                 index < max_requests ? &rdist : &sdist,
+                                                 &reqs[index]);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "%s:%4d\tError occurred %d, rank %2d", __FILE__, line, err, rank));
+    (void)line;  // silence compiler warning
+    ompi_coll_base_free_reqs(reqs, 2 * max_requests);
+    return err;
+}
+
+/*
+ * Node layout of the communicator for the node-aggregated algorithm. Nodes
+ * are numbered in the order of their lowest rank, which is their leader.
+ */
+typedef struct coll_base_alltoallv_nodes_t {
+    int nnodes;
+    int *node;      /* node of each rank */
+    int *index;     /* index of each rank in its node */
+    int *members;   /* ranks of each node, in increasing order */
+    int *first;     /* first member of each node in members, nnodes + 1 entries */
+} coll_base_alltoallv_nodes_t;
+
+static int
+coll_base_alltoallv_nodes_init(struct ompi_communicator_t *comm, mca_coll_base_comm_t *data,
+                               coll_base_alltoallv_nodes_t *nodes)
+{
+    int rank = ompi_comm_rank(comm), size = ompi_comm_size(comm), leader = rank, err;
+    int *leaders, *next;
+
+    /* The leaders are computed once per communicator */
+    if (NULL == data->cached_node_leaders) {
+        for (int i = 0; i < rank; i++) {
+            ompi_proc_t *proc = ompi_comm_peer_lookup(comm, i);
+            if (OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags)) {
+                leader = i;
+                break;
+            }
+        }
+        leaders = (int *) malloc(size * sizeof(int));
+        if (NULL == leaders) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        err = comm->c_coll->coll_allgather(&leader, 1, MPI_INT, leaders, 1, MPI_INT, comm,
+                                           comm->c_coll->coll_allgather_module);
+        if (MPI_SUCCESS != err) {
+            free(leaders);
+            return err;
+        }
+        data->cached_node_leaders = leaders;
+    }
+    leaders = data->cached_node_leaders;
+
+    /* node, index and members, then first and a cursor per node */
+    nodes->node = (int *) malloc((3 * size + 2 * (size + 1)) * sizeof(int));
+    if (NULL == nodes->node) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    nodes->index = nodes->node + size;
+    nodes->members = nodes->index + size;
+    nodes->first = nodes->members + size;
+    next = nodes->first + size + 1;
+
+    /* Number the nodes in the order of their leaders; the index array
+     * holds the node of each leader meanwhile */
+    nodes->nnodes = 0;
+    for (int i = 0; i < size; i++) {
+        if (leaders[i] == i) {
+            nodes->index[i] = nodes->nnodes++;
+        }
+        nodes->node[i] = nodes->index[leaders[i]];
+    }
+
+    /* Counting sort of the ranks by node, keeping the rank order */
+    memset(nodes->first, 0, (nodes->nnodes + 1) * sizeof(int));
+    for (int i = 0; i < size; i++) {
+        nodes->first[nodes->node[i] + 1]++;
+    }
+    for (int n = 0; n < nodes->nnodes; n++) {
+        nodes->first[n + 1] += nodes->first[n];
+    }
+    memcpy(next, nodes->first, nodes->nnodes * sizeof(int));
+    for (int i = 0; i < size; i++) {
+        int n = nodes->node[i];
+        nodes->index[i] = next[n] - nodes->first[n];
+        nodes->members[next[n]++] = i;
+    }
+    return MPI_SUCCESS;
+}
+
+/*
+ * Pack the blocks of sbuf for the ranks of the other nodes, node after node
+ * and in rank order inside a node.
+ */
+static int
+coll_base_alltoallv_pack_remote(const void *sbuf, ompi_count_array_t scounts, ompi_disp_array_t sdisps,
+                                struct ompi_datatype_t *sdtype, size_t sdtype_size, ptrdiff_t sext,
+                                const coll_base_alltoallv_nodes_t *nodes, int my_node, char *packed)
+{
+    opal_convertor_t convertor;
+
+    for (int n = 0; n < nodes->nnodes; n++) {
+        if (n == my_node) continue;
+        for (int k = nodes->first[n]; k < nodes->first[n + 1]; k++) {
+            int peer = nodes->members[k];
+            size_t count = ompi_count_array_get(scounts, peer), max_data = count * sdtype_size;
+            struct iovec iov = {.iov_base = packed, .iov_len = max_data};
+            uint32_t iov_count = 1;
+
+            if (0 == max_data) continue;
+            OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+            opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor, &sdtype->super, count,
+                                                     (char *) sbuf + ompi_disp_array_get(sdisps, peer) * sext,
+                                                     0, &convertor);
+            opal_convertor_pack(&convertor, &iov, &iov_count, &max_data);
+            OBJ_DESTRUCT(&convertor);
+            if (max_data != count * sdtype_size) {
+                return MPI_ERR_TRUNCATE;
+            }
+            packed += max_data;
+        }
+    }
+    return MPI_SUCCESS;
+}
+
+/*
+ * Unpack into rbuf the blocks of the ranks of the other nodes, in the order
+ * of coll_base_alltoallv_pack_remote.
+ */
+static int
+coll_base_alltoallv_unpack_remote(const char *packed, void *rbuf, ompi_count_array_t rcounts,
+                                  ompi_disp_array_t rdisps, struct ompi_datatype_t *rdtype,
+                                  size_t rdtype_size, ptrdiff_t rext,
+                                  const coll_base_alltoallv_nodes_t *nodes, int my_node)
+{
+    opal_convertor_t convertor;
+
+    for (int n = 0; n < nodes->nnodes; n++) {
+        if (n == my_node) continue;
+        for (int k = nodes->first[n]; k < nodes->first[n + 1]; k++) {
+            int peer = nodes->members[k];
+            size_t count = ompi_count_array_get(rcounts, peer), max_data = count * rdtype_size;
+            struct iovec iov = {.iov_base = (char *) packed, .iov_len = max_data};
+            uint32_t iov_count = 1;
+
+            if (0 == max_data) continue;
+            OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+            opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor, &rdtype->super, count,
+                                                     (char *) rbuf + ompi_disp_array_get(rdisps, peer) * rext,
+                                                     0, &convertor);
+            opal_convertor_unpack(&convertor, &iov, &iov_count, &max_data);
+            OBJ_DESTRUCT(&convertor);
+            if (max_data != count * rdtype_size) {
+                return MPI_ERR_TRUNCATE;
+            }
+            packed += max_data;
+        }
+    }
+    return MPI_SUCCESS;
+}
+
+/*
+ * ompi_coll_base_alltoallv_intra_node_aggregated
+ *
+ * Function:    Two-phase alltoallv aggregating the messages per node
+ * Accepts:     Same arguments as MPI_Alltoallv()
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Blocks between ranks of the same node are exchanged
+ *              directly. Blocks for other nodes are packed and sent to the
+ *              leader of the node (its lowest rank), along with the send
+ *              counts. The leaders exchange a single message per pair of
+ *              nodes, preceded by the matching counts, and each leader
+ *              forwards to every rank of its node a single message with
+ *              all its blocks from the other nodes.
+ *
+ *              The number of messages crossing the network drops from
+ *              p^2 to (number of nodes)^2, at the price of two extra
+ *              copies, which is worthwhile for small and irregular blocks.
+ *
+ * Limitations: Homogeneous environments only. The sparse algorithm is
+ *              used if there is a single node or a single rank per node.
+ *
+ * Memory:      The leaders hold about four times the data sent and
+ *              received by their node, plus the counts of all the local
+ *              ranks for the whole communicator.
+ */
+int
+ompi_coll_base_alltoallv_intra_node_aggregated(const void *sbuf, ompi_count_array_t scounts, ompi_disp_array_t sdisps,
+                                               struct ompi_datatype_t *sdtype,
+                                               void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdisps,
+                                               struct ompi_datatype_t *rdtype,
+                                               struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module)
+{
+    int line = -1, size, rank, err, my_node, nlocal, nnodes, leader, max_reqs = 0;
+    size_t sdtype_size, rdtype_size, stotal = 0, rtotal = 0, total;
+    size_t *meta = NULL, *cin = NULL, *cout = NULL, *goff = NULL, *toff = NULL, *noff = NULL;
+    char *sendbuf = NULL, *recvbuf = NULL, *gather = NULL, *agg, *fwd;
+    ompi_request_t **reqs = NULL, **dreq, **lreq, **creq, **xreq, **treq;
+    coll_base_alltoallv_nodes_t nodes = {.node = NULL};
+    ptrdiff_t sext, rext;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoallv_intra_basic_inplace(rbuf, rcounts, rdisps,
+                                                           rdtype, comm, module);
+    }
+#if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+    return ompi_coll_base_alltoallv_intra_sparse(sbuf, scounts, sdisps, sdtype, rbuf, rcounts,
+                                                 rdisps, rdtype, comm, module);
+#endif
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    err = coll_base_alltoallv_nodes_init(comm, module->base_data, &nodes);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    nnodes = nodes.nnodes;
+    if (1 == nnodes || size == nnodes) {
+        free(nodes.node);
+        return ompi_coll_base_alltoallv_intra_sparse(sbuf, scounts, sdisps, sdtype, rbuf, rcounts,
+                                                     rdisps, rdtype, comm, module);
+    }
+    my_node = nodes.node[rank];
+    nlocal = nodes.first[my_node + 1] - nodes.first[my_node];
+    leader = nodes.members[nodes.first[my_node]];
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:alltoallv_intra_node_aggregated rank %d nodes %d leader %d",
+                 rank, nnodes, leader));
+
+    ompi_datatype_type_size(sdtype, &sdtype_size);
+    ompi_datatype_type_size(rdtype, &rdtype_size);
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+
+    max_reqs = 5 * nlocal + 4 * nnodes;
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+    if (NULL == reqs) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    dreq = reqs;                  /* direct exchanges inside the node */
+    lreq = dreq + 2 * nlocal;     /* counts and blocks to the leader */
+    creq = lreq + 2 * nlocal;     /* counts between leaders */
+    xreq = creq + 2 * nnodes;     /* blocks between leaders */
+    treq = xreq + 2 * nnodes;     /* blocks from the leader */
+
+    /* Phase 0: direct exchanges inside the node */
+    err = coll_base_alltoallv_self(sbuf, scounts, sdisps, sdtype, sext,
+                                   rbuf, rcounts, rdisps, rdtype, rext, rank);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    for (int k = nodes.first[my_node]; k < nodes.first[my_node + 1]; k++) {
+        int peer = nodes.members[k], li = k - nodes.first[my_node];
+        if (peer == rank) continue;
+        if (0 < ompi_count_array_get(rcounts, peer) && 0 < rdtype_size) {
+            err = MCA_PML_CALL(irecv((char *) rbuf + ompi_disp_array_get(rdisps, peer) * rext,
+                                     ompi_count_array_get(rcounts, peer), rdtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLTOALLV, comm, &dreq[2 * li]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        if (0 < ompi_count_array_get(scounts, peer) && 0 < sdtype_size) {
+            err = MCA_PML_CALL(isend((char *) sbuf + ompi_disp_array_get(sdisps, peer) * sext,
+                                     ompi_count_array_get(scounts, peer), sdtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLTOALLV, MCA_PML_BASE_SEND_STANDARD,
+                                     comm, &dreq[2 * li + 1]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    }
+
+    /* The counts of all the local ranks, one row per rank; ours is the
+     * only one on the other ranks */
+    meta = (size_t *) malloc((rank == leader ? nlocal : 1) * size * sizeof(size_t));
+    if (NULL == meta) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    for (int i = 0; i < size; i++) {
+        meta[i] = ompi_count_array_get(scounts, i) * sdtype_size;
+        if (nodes.node[i] != my_node) stotal += meta[i];
+    }
+    for (int i = 0; i < size; i++) {
+        if (nodes.node[i] != my_node) rtotal += ompi_count_array_get(rcounts, i) * rdtype_size;
+    }
+
+    if (rank != leader) {
+        /* Phase 1: counts and blocks for the other nodes to the leader */
+        err = MCA_PML_CALL(isend(meta, size * sizeof(size_t), MPI_BYTE, leader,
+                                 MCA_COLL_BASE_TAG_ALLTOALLV, MCA_PML_BASE_SEND_STANDARD,
+                                 comm, &lreq[0]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        if (0 < stotal) {
+            sendbuf = (char *) malloc(stotal);
+            if (NULL == sendbuf) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+            err = coll_base_alltoallv_pack_remote(sbuf, scounts, sdisps, sdtype, sdtype_size, sext,
+                                                  &nodes, my_node, sendbuf);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = MCA_PML_CALL(isend(sendbuf, stotal, MPI_BYTE, leader,
+                                     MCA_COLL_BASE_TAG_ALLTOALLV, MCA_PML_BASE_SEND_STANDARD,
+                                     comm, &lreq[1]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+
+        /* Phase 3: all the blocks from the other nodes, from the leader */
+        if (0 < rtotal) {
+            recvbuf = (char *) malloc(rtotal);
+            if (NULL == recvbuf) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+            err = MCA_PML_CALL(irecv(recvbuf, rtotal, MPI_BYTE, leader,
+                                     MCA_COLL_BASE_TAG_ALLTOALLV, comm, &treq[0]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        err = ompi_request_wait_all(max_reqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        if (0 < rtotal) {
+            err = coll_base_alltoallv_unpack_remote(recvbuf, rbuf, rcounts, rdisps, rdtype,
+                                                    rdtype_size, rext, &nodes, my_node);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        goto cleanup;
+    }
+
+    /*
+     * Leader. The counts exchanged between the leaders of nodes A and B are
+     * a matrix with one row per rank of A and one column per rank of B.
+     */
+    total = (size_t) (size - nlocal) * nlocal;
+    cin = (size_t *) malloc(2 * total * sizeof(size_t));
+    noff = (size_t *) malloc(3 * (nnodes + 1) * sizeof(size_t));
+    goff = (size_t *) malloc(2 * (nlocal + 1) * sizeof(size_t));
+    toff = (size_t *) malloc(2 * (nlocal + 1) * sizeof(size_t));
+    if (NULL == cin || NULL == noff || NULL == goff || NULL == toff) {
+        err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+    }
+    cout = cin + total;
+
+    /* noff: offset of the counts matrix of each node in cin and cout */
+    noff[0] = 0;
+    for (int n = 0; n < nnodes; n++) {
+        int nsize = (n == my_node) ? 0 : nodes.first[n + 1] - nodes.first[n];
+        noff[n + 1] = noff[n] + (size_t) nsize * nlocal;
+    }
+    for (int n = 0; n < nnodes; n++) {
+        if (n == my_node) continue;
+        err = MCA_PML_CALL(irecv(cin + noff[n], (noff[n + 1] - noff[n]) * sizeof(size_t), MPI_BYTE,
+                                 nodes.members[nodes.first[n]], MCA_COLL_BASE_TAG_ALLTOALLV,
+                                 comm, &creq[n]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    /* Phase 1: counts of the local ranks, then their blocks */
+    for (int li = 1; li < nlocal; li++) {
+        err = MCA_PML_CALL(irecv(meta + (size_t) li * size, size * sizeof(size_t), MPI_BYTE,
+                                 nodes.members[nodes.first[my_node] + li],
+                                 MCA_COLL_BASE_TAG_ALLTOALLV, comm, &lreq[li]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    err = ompi_request_wait_all(nlocal, lreq, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    /* goff: offset of the blocks of each local rank in gather */
+    goff[0] = 0;
+    for (int li = 0; li < nlocal; li++) {
+        size_t bytes = 0;
+        for (int i = 0; i < size; i++) {
+            if (nodes.node[i] != my_node) bytes += meta[(size_t) li * size + i];
+        }
+        goff[li + 1] = goff[li] + bytes;
+    }
+    gather = (char *) malloc(2 * goff[nlocal] + 1);
+    if (NULL == gather) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    agg = gather + goff[nlocal];
+    for (int li = 1; li < nlocal; li++) {
+        if (goff[li + 1] == goff[li]) continue;
+        err = MCA_PML_CALL(irecv(gather + goff[li], goff[li + 1] - goff[li], MPI_BYTE,
+                                 nodes.members[nodes.first[my_node] + li],
+                                 MCA_COLL_BASE_TAG_ALLTOALLV, comm, &lreq[nlocal + li]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    err = coll_base_alltoallv_pack_remote(sbuf, scounts, sdisps, sdtype, sdtype_size, sext,
+                                          &nodes, my_node, gather);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    /* Phase 2: counts to the other leaders */
+    for (int n = 0; n < nnodes; n++) {
+        size_t *c = cout + noff[n];
+        if (n == my_node) continue;
+        for (int li = 0; li < nlocal; li++) {
+            for (int k = nodes.first[n]; k < nodes.first[n + 1]; k++) {
+                *c++ = meta[(size_t) li * size + nodes.members[k]];
+            }
+        }
+        err = MCA_PML_CALL(isend(cout + noff[n], (noff[n + 1] - noff[n]) * sizeof(size_t), MPI_BYTE,
+                                 nodes.members[nodes.first[n]], MCA_COLL_BASE_TAG_ALLTOALLV,
+                                 MCA_PML_BASE_SEND_STANDARD, comm, &creq[nnodes + n]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    /* Phase 2: blocks to the other leaders. Each local rank packed its
+     * blocks node after node, goff + nlocal is its cursor in gather */
+    err = ompi_request_wait_all(nlocal, lreq + nlocal, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    memcpy(goff + nlocal + 1, goff, nlocal * sizeof(size_t));
+    total = 0;
+    for (int n = 0; n < nnodes; n++) {
+        size_t start = total;
+        if (n == my_node) continue;
+        for (int li = 0; li < nlocal; li++) {
+            size_t bytes = 0, *cursor = goff + nlocal + 1 + li;
+            for (int k = nodes.first[n]; k < nodes.first[n + 1]; k++) {
+                bytes += meta[(size_t) li * size + nodes.members[k]];
+            }
+            memcpy(agg + total, gather + *cursor, bytes);
+            *cursor += bytes;
+            total += bytes;
+        }
+        if (total == start) continue;
+        err = MCA_PML_CALL(isend(agg + start, total - start, MPI_BYTE,
+                                 nodes.members[nodes.first[n]], MCA_COLL_BASE_TAG_ALLTOALLV,
+                                 MCA_PML_BASE_SEND_STANDARD, comm, &xreq[nnodes + n]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    /* Phase 2: blocks from the other leaders, rows of the counts matrix
+     * being the ranks of the remote node; roff (in noff) is the offset of
+     * the blocks of each node in recvbuf */
+    err = ompi_request_wait_all(nnodes, creq, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    {
+        size_t *roff = noff + nnodes + 1;
+        roff[0] = 0;
+        for (int n = 0; n < nnodes; n++) {
+            size_t bytes = 0;
+            for (size_t c = noff[n]; c < noff[n + 1]; c++) {
+                bytes += cin[c];
+            }
+            roff[n + 1] = roff[n] + bytes;
+        }
+        total = roff[nnodes];
+        recvbuf = (char *) malloc(2 * total + 1);
+        if (NULL == recvbuf) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+        fwd = recvbuf + total;
+        for (int n = 0; n < nnodes; n++) {
+            if (roff[n + 1] == roff[n]) continue;
+            err = MCA_PML_CALL(irecv(recvbuf + roff[n], roff[n + 1] - roff[n], MPI_BYTE,
+                                     nodes.members[nodes.first[n]], MCA_COLL_BASE_TAG_ALLTOALLV,
+                                     comm, &xreq[n]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    }
+    err = ompi_request_wait_all(nnodes, xreq, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    /* Phase 3: regroup the blocks per local rank, node after node, and
+     * forward them; toff + nlocal + 1 is the cursor of each local rank */
+    toff[0] = 0;
+    for (int li = 0; li < nlocal; li++) {
+        size_t bytes = 0;
+        for (int n = 0; n < nnodes; n++) {
+            for (size_t c = noff[n] + li; c < noff[n + 1]; c += nlocal) {
+                bytes += cin[c];
+            }
+        }
+        toff[li + 1] = toff[li] + bytes;
+    }
+    memcpy(toff + nlocal + 1, toff, nlocal * sizeof(size_t));
+    total = 0;
+    for (int n = 0; n < nnodes; n++) {
+        for (size_t c = noff[n]; c < noff[n + 1]; c++) {
+            size_t *cursor = toff + nlocal + 1 + (c - noff[n]) % nlocal;
+            memcpy(fwd + *cursor, recvbuf + total, cin[c]);
+            *cursor += cin[c];
+            total += cin[c];
+        }
+    }
+    for (int li = 1; li < nlocal; li++) {
+        if (toff[li + 1] == toff[li]) continue;
+        err = MCA_PML_CALL(isend(fwd + toff[li], toff[li + 1] - toff[li], MPI_BYTE,
+                                 nodes.members[nodes.first[my_node] + li],
+                                 MCA_COLL_BASE_TAG_ALLTOALLV, MCA_PML_BASE_SEND_STANDARD,
+                                 comm, &treq[li]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    if (0 < rtotal) {
+        err = coll_base_alltoallv_unpack_remote(fwd, rbuf, rcounts, rdisps, rdtype,
+                                                rdtype_size, rext, &nodes, my_node);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    err = ompi_request_wait_all(max_reqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+ cleanup:
+    free(nodes.node);
+    free(meta);
+    free(cin);
+    free(noff);
+    free(goff);
+    free(toff);
+    free(gather);
+    free(recvbuf);
+    free(sendbuf);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "%s:%4d\tError occurred %d, rank %2d", __FILE__, line, err, ompi_comm_rank(comm)));
+    (void)line;  // silence compiler warning
+    if (NULL != reqs) {
+        err = coll_base_alltoallv_reqs_error(reqs, max_reqs, err);
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    free(nodes.node);
+    free(meta);
+    free(cin);
+    free(noff);
+    free(goff);
+    free(toff);
+    free(gather);
+    free(recvbuf);
+    free(sendbuf);
+    return err;
+}
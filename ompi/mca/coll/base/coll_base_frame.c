@@ -108,6 +108,10 @@ coll_base_comm_destruct(mca_coll_base_comm_t *data)
     if (data->cached_in_order_bintree) { /* destroy in order bintree if defined */
         ompi_coll_base_topo_destroy_tree (&data->cached_in_order_bintree);
     }
+    if (NULL != data->cached_node_leaders) {
+        free(data->cached_node_leaders);
+        data->cached_node_leaders = NULL;
+    }
 }
 
 OBJ_CLASS_INSTANCE(mca_coll_base_comm_t, opal_object_t,
@@ -212,6 +212,9 @@ int ompi_coll_base_allreduce_intra_ring_segmented(ALLREDUCE_ARGS, uint32_t segsi
 int ompi_coll_base_allreduce_intra_basic_linear(ALLREDUCE_ARGS);
 int ompi_coll_base_allreduce_intra_redscat_allgather(ALLREDUCE_ARGS);
 int ompi_coll_base_allreduce_intra_allgather_reduce(ALLREDUCE_ARGS);
+int ompi_coll_base_allreduce_intra_recursive_multiplying(ALLREDUCE_ARGS, int radix);
+int ompi_coll_base_allreduce_intra_knomial_redscat_allgather(ALLREDUCE_ARGS, int radix);
+int ompi_coll_base_allreduce_intra_tree_pipelined(ALLREDUCE_ARGS, uint32_t segsize);
 
 /* AlltoAll */
 int ompi_coll_base_alltoall_intra_pairwise(ALLTOALL_ARGS);
@@ -227,6 +230,9 @@ int mca_coll_base_alltoall_intra_basic_inplace(const void *rbuf, size_t rcount,
 /* AlltoAllV */
 int ompi_coll_base_alltoallv_intra_pairwise(ALLTOALLV_ARGS);
 int ompi_coll_base_alltoallv_intra_basic_linear(ALLTOALLV_ARGS);
+int ompi_coll_base_alltoallv_intra_sparse(ALLTOALLV_ARGS);
+int ompi_coll_base_alltoallv_intra_scattered(ALLTOALLV_ARGS, int max_requests);
+int ompi_coll_base_alltoallv_intra_node_aggregated(ALLTOALLV_ARGS);
 int mca_coll_base_alltoallv_intra_basic_inplace(const void *rbuf, ompi_count_array_t rcounts, ompi_disp_array_t rdisps,
                                                 struct ompi_datatype_t *rdtype,
                                                 struct ompi_communicator_t *comm,
@@ -516,6 +522,9 @@ struct mca_coll_base_comm_t {
 
     /* in-order binary tree (root of the in-order binary tree is rank 0) */
     ompi_coll_tree_t *cached_in_order_bintree;
+
+    /* lowest rank of the node of each rank (node-aggregated algorithms) */
+    int *cached_node_leaders;
 };
 typedef struct mca_coll_base_comm_t mca_coll_base_comm_t;
 OMPI_DECLSPEC OBJ_CLASS_DECLARATION(mca_coll_base_comm_t);
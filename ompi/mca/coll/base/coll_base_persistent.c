@@ -0,0 +1,969 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/bit_ops.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "coll_base_topo.h"
+#include "coll_base_util.h"
+#include "coll_base_persistent.h"
+
+/*
+ * Plans which did not complete from MPI_Start are progressed from
+ * opal_progress. The callback is only registered while plans exist.
+ */
+static bool active_initialized = false;
+static opal_list_t active_plans;
+/* number of existing plans, protected by active_lock. the list is
+ * constructed with the first plan and destructed with the last one */
+static int live_plans = 0;
+static bool in_progress = false;
+static opal_mutex_t active_lock = OPAL_MUTEX_STATIC_INIT;
+
+/*
+ * Run the plan as far as possible without blocking. Returns
+ * OMPI_SUCCESS once all the steps completed, OMPI_ERR_WOULD_BLOCK if
+ * some requests are still pending, or an error.
+ */
+static int persistent_advance(ompi_coll_base_persistent_request_t *plan)
+{
+    while (plan->current < plan->nsteps) {
+        ompi_coll_base_persistent_step_t *step = plan->steps + plan->current;
+        ompi_request_t **reqs = plan->reqs + step->first_req;
+        int rc;
+
+        if (!plan->current_started) {
+            plan->current_started = true;
+            for (int i = 0; i < step->nreqs; ++i) {
+                rc = reqs[i]->req_start(1, reqs + i);
+                if (OMPI_SUCCESS != rc) {
+                    return rc;
+                }
+            }
+        }
+
+        for (int i = 0; i < step->nreqs; ++i) {
+            if (!REQUEST_COMPLETE(reqs[i])) {
+                return OMPI_ERR_WOULD_BLOCK;
+            }
+            if (OMPI_SUCCESS != reqs[i]->req_status.MPI_ERROR) {
+                return reqs[i]->req_status.MPI_ERROR;
+            }
+        }
+
+        switch (step->action) {
+        case OMPI_COLL_BASE_PERSISTENT_REDUCE:
+            ompi_op_reduce(step->op, step->src, step->dst, step->count, step->dtype);
+            break;
+        case OMPI_COLL_BASE_PERSISTENT_COPY:
+            rc = ompi_datatype_copy_content_same_ddt(step->dtype, step->count, (char *) step->dst,
+                                                     (char *) step->src);
+            if (OMPI_SUCCESS != rc) {
+                return rc;
+            }
+            break;
+        default:
+            break;
+        }
+
+        plan->current++;
+        plan->current_started = false;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static void persistent_complete(ompi_coll_base_persistent_request_t *plan, int rc)
+{
+    plan->super.super.req_status.MPI_ERROR = rc;
+    ompi_request_complete(&plan->super.super, true);
+}
+
+static int persistent_progress(void)
+{
+    ompi_coll_base_persistent_request_t *plan, *next;
+    int completed = 0;
+
+    if (0 == opal_list_get_size(&active_plans)) {
+        return 0;
+    }
+
+    OPAL_THREAD_LOCK(&active_lock);
+    /* return if invoked recursively, e.g. from a sub-request start */
+    if (!in_progress) {
+        in_progress = true;
+
+        OPAL_LIST_FOREACH_SAFE (plan, next, &active_plans, ompi_coll_base_persistent_request_t) {
+            int rc;
+
+            OPAL_THREAD_UNLOCK(&active_lock);
+            rc = persistent_advance(plan);
+            OPAL_THREAD_LOCK(&active_lock);
+            if (OMPI_ERR_WOULD_BLOCK != rc) {
+                opal_list_remove_item(&active_plans, &plan->super.super.super.super);
+                OPAL_THREAD_UNLOCK(&active_lock);
+                persistent_complete(plan, rc);
+                OPAL_THREAD_LOCK(&active_lock);
+                completed++;
+            }
+        }
+        in_progress = false;
+    }
+    OPAL_THREAD_UNLOCK(&active_lock);
+
+    return completed;
+}
+
+static int persistent_start(size_t count, ompi_request_t **requests)
+{
+    for (size_t i = 0; i < count; ++i) {
+        ompi_coll_base_persistent_request_t *plan
+            = (ompi_coll_base_persistent_request_t *) requests[i];
+        int rc;
+
+        if (OMPI_REQUEST_INACTIVE != plan->super.super.req_state
+            && !REQUEST_COMPLETE(&plan->super.super)) {
+            return MPI_ERR_REQUEST;
+        }
+
+        plan->super.super.req_complete = REQUEST_PENDING;
+        plan->super.super.req_state = OMPI_REQUEST_ACTIVE;
+        plan->super.super.req_status.MPI_ERROR = OMPI_SUCCESS;
+        plan->current = 0;
+        plan->current_started = false;
+
+        rc = persistent_advance(plan);
+        if (OMPI_ERR_WOULD_BLOCK != rc) {
+            persistent_complete(plan, rc);
+            continue;
+        }
+
+        OPAL_THREAD_LOCK(&active_lock);
+        opal_list_append(&active_plans, &plan->super.super.super.super);
+        OPAL_THREAD_UNLOCK(&active_lock);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int persistent_cancel(struct ompi_request_t *request, int complete)
+{
+    return MPI_ERR_REQUEST;
+}
+
+static int persistent_free(struct ompi_request_t **request)
+{
+    ompi_coll_base_persistent_request_t *plan = (ompi_coll_base_persistent_request_t *) *request;
+
+    if (!REQUEST_COMPLETE(&plan->super.super)) {
+        return MPI_ERR_REQUEST;
+    }
+
+    ompi_coll_base_persistent_destroy(plan);
+    *request = MPI_REQUEST_NULL;
+
+    return OMPI_SUCCESS;
+}
+
+static void persistent_construct(ompi_coll_base_persistent_request_t *plan)
+{
+    plan->comm = NULL;
+    plan->tag = 0;
+    plan->steps = NULL;
+    plan->nsteps = plan->steps_size = 0;
+    plan->reqs = NULL;
+    plan->nreqs = plan->reqs_size = 0;
+    plan->current = 0;
+    plan->current_started = false;
+    plan->tmpbuf = NULL;
+}
+
+static void persistent_destruct(ompi_coll_base_persistent_request_t *plan)
+{
+    for (int i = 0; i < plan->nreqs; ++i) {
+        if (MPI_REQUEST_NULL != plan->reqs[i]) {
+            ompi_request_free(plan->reqs + i);
+        }
+    }
+    free(plan->reqs);
+    free(plan->steps);
+    free(plan->tmpbuf);
+
+    if (NULL != plan->super.data.refcounted.op.op) {
+        OBJ_RELEASE(plan->super.data.refcounted.op.op);
+    }
+    if (NULL != plan->super.data.refcounted.op.datatype) {
+        OBJ_RELEASE(plan->super.data.refcounted.op.datatype);
+    }
+}
+
+OBJ_CLASS_INSTANCE(ompi_coll_base_persistent_request_t, ompi_coll_base_nbc_request_t,
+                   persistent_construct, persistent_destruct);
+
+int ompi_coll_base_persistent_create(ompi_communicator_t *comm, ompi_datatype_t *dtype,
+                                     ompi_op_t *op,
+                                     ompi_coll_base_persistent_request_t **request)
+{
+    ompi_coll_base_persistent_request_t *plan;
+
+    plan = OBJ_NEW(ompi_coll_base_persistent_request_t);
+    if (NULL == plan) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    OMPI_REQUEST_INIT(&plan->super.super, true);
+    plan->super.super.req_type = OMPI_REQUEST_COLL;
+    plan->super.super.req_mpi_object.comm = comm;
+    plan->super.super.req_start = persistent_start;
+    plan->super.super.req_free = persistent_free;
+    plan->super.super.req_cancel = persistent_cancel;
+
+    plan->comm = comm;
+    plan->tag = ompi_coll_base_nbc_reserve_tags(comm, 1);
+
+    /* the MPI layer does not retain the arguments of persistent
+     * requests, they have to outlive the user handles */
+    if (NULL != op && !ompi_op_is_intrinsic(op)) {
+        OBJ_RETAIN(op);
+        plan->super.data.refcounted.op.op = op;
+    }
+    if (NULL != dtype && !ompi_datatype_is_predefined(dtype)) {
+        OBJ_RETAIN(dtype);
+        plan->super.data.refcounted.op.datatype = dtype;
+    }
+
+    OPAL_THREAD_LOCK(&active_lock);
+    if (!active_initialized) {
+        OBJ_CONSTRUCT(&active_plans, opal_list_t);
+        active_initialized = true;
+    }
+    if (1 == ++live_plans) {
+        opal_progress_register(persistent_progress);
+    }
+    OPAL_THREAD_UNLOCK(&active_lock);
+
+    *request = plan;
+    return OMPI_SUCCESS;
+}
+
+void ompi_coll_base_persistent_destroy(ompi_coll_base_persistent_request_t *plan)
+{
+    OMPI_REQUEST_FINI(&plan->super.super);
+    OBJ_RELEASE(plan);
+
+    OPAL_THREAD_LOCK(&active_lock);
+    if (0 == --live_plans) {
+        /* inactive plans are not in the list, it is empty */
+        opal_progress_unregister(persistent_progress);
+        OBJ_DESTRUCT(&active_plans);
+        active_initialized = false;
+    }
+    OPAL_THREAD_UNLOCK(&active_lock);
+}
+
+void *ompi_coll_base_persistent_tmpbuf(ompi_coll_base_persistent_request_t *plan, size_t size)
+{
+    assert(NULL == plan->tmpbuf);
+    plan->tmpbuf = malloc(size > 0 ? size : 1);
+    return plan->tmpbuf;
+}
+
+int ompi_coll_base_persistent_step(ompi_coll_base_persistent_request_t *plan)
+{
+    ompi_coll_base_persistent_step_t *step;
+
+    if (plan->nsteps == plan->steps_size) {
+        int size = plan->steps_size ? 2 * plan->steps_size : 8;
+        step = realloc(plan->steps, size * sizeof(*step));
+        if (NULL == step) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        plan->steps = step;
+        plan->steps_size = size;
+    }
+
+    step = plan->steps + plan->nsteps++;
+    step->first_req = plan->nreqs;
+    step->nreqs = 0;
+    step->action = OMPI_COLL_BASE_PERSISTENT_NONE;
+
+    return OMPI_SUCCESS;
+}
+
+/* the step the next request or action belongs to */
+static int persistent_current_step(ompi_coll_base_persistent_request_t *plan)
+{
+    if (0 == plan->nsteps
+        || OMPI_COLL_BASE_PERSISTENT_NONE != plan->steps[plan->nsteps - 1].action) {
+        return ompi_coll_base_persistent_step(plan);
+    }
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_base_persistent_add_request(ompi_coll_base_persistent_request_t *plan,
+                                          ompi_request_t *subreq)
+{
+    int rc;
+
+    rc = persistent_current_step(plan);
+    if (OMPI_SUCCESS != rc) {
+        ompi_request_free(&subreq);
+        return rc;
+    }
+
+    if (plan->nreqs == plan->reqs_size) {
+        int size = plan->reqs_size ? 2 * plan->reqs_size : 8;
+        ompi_request_t **reqs = realloc(plan->reqs, size * sizeof(*reqs));
+        if (NULL == reqs) {
+            ompi_request_free(&subreq);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        plan->reqs = reqs;
+        plan->reqs_size = size;
+    }
+
+    plan->reqs[plan->nreqs++] = subreq;
+    plan->steps[plan->nsteps - 1].nreqs++;
+
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_base_persistent_add_send(ompi_coll_base_persistent_request_t *plan,
+                                       const void *buf, size_t count, ompi_datatype_t *dtype,
+                                       int peer)
+{
+    ompi_request_t *req;
+    int rc;
+
+    rc = MCA_PML_CALL(isend_init(buf, count, dtype, peer, plan->tag, MCA_PML_BASE_SEND_STANDARD,
+                                 plan->comm, &req));
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    return ompi_coll_base_persistent_add_request(plan, req);
+}
+
+int ompi_coll_base_persistent_add_recv(ompi_coll_base_persistent_request_t *plan, void *buf,
+                                       size_t count, ompi_datatype_t *dtype, int peer)
+{
+    ompi_request_t *req;
+    int rc;
+
+    rc = MCA_PML_CALL(irecv_init(buf, count, dtype, peer, plan->tag, plan->comm, &req));
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    return ompi_coll_base_persistent_add_request(plan, req);
+}
+
+static int persistent_add_action(ompi_coll_base_persistent_request_t *plan,
+                                 ompi_coll_base_persistent_action_t action, const void *src,
+                                 void *dst, size_t count, ompi_datatype_t *dtype, ompi_op_t *op)
+{
+    ompi_coll_base_persistent_step_t *step;
+    int rc;
+
+    rc = persistent_current_step(plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    step = plan->steps + plan->nsteps - 1;
+    step->action = action;
+    step->src = src;
+    step->dst = dst;
+    step->count = count;
+    step->dtype = dtype;
+    step->op = op;
+
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_base_persistent_add_reduce(ompi_coll_base_persistent_request_t *plan,
+                                         const void *src, void *dst, size_t count,
+                                         ompi_datatype_t *dtype, ompi_op_t *op)
+{
+    return persistent_add_action(plan, OMPI_COLL_BASE_PERSISTENT_REDUCE, src, dst, count, dtype,
+                                 op);
+}
+
+int ompi_coll_base_persistent_add_copy(ompi_coll_base_persistent_request_t *plan,
+                                       const void *src, void *dst, size_t count,
+                                       ompi_datatype_t *dtype)
+{
+    return persistent_add_action(plan, OMPI_COLL_BASE_PERSISTENT_COPY, src, dst, count, dtype,
+                                 NULL);
+}
+
+/*
+ * Plans. They follow the blocking algorithms of coll/base step by step,
+ * including the order of the operands of the reductions.
+ */
+
+int ompi_coll_base_allreduce_init_intra_recursivedoubling(const void *sbuf, void *rbuf,
+                                                          size_t count, ompi_datatype_t *dtype,
+                                                          ompi_op_t *op, ompi_communicator_t *comm,
+                                                          ompi_request_t **request,
+                                                          mca_coll_base_module_t *module)
+{
+    ompi_coll_base_persistent_request_t *plan;
+    int rc, rank, size, adjsize, extra_ranks, newrank, distance;
+    char *tmpsend, *tmprecv, *tmpswap, *inplacebuf;
+    ptrdiff_t span, gap = 0;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    rc = ompi_coll_base_persistent_create(comm, dtype, op, &plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    if (1 == size) {
+        if (MPI_IN_PLACE != sbuf) {
+            rc = ompi_coll_base_persistent_add_copy(plan, sbuf, rbuf, count, dtype);
+        }
+        goto done;
+    }
+
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    inplacebuf = ompi_coll_base_persistent_tmpbuf(plan, span);
+    if (NULL == inplacebuf) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto done;
+    }
+    inplacebuf -= gap;
+
+    rc = ompi_coll_base_persistent_add_copy(plan, MPI_IN_PLACE == sbuf ? rbuf : sbuf, inplacebuf,
+                                            count, dtype);
+    if (OMPI_SUCCESS != rc) {
+        goto done;
+    }
+
+    tmpsend = inplacebuf;
+    tmprecv = (char *) rbuf;
+
+    adjsize = opal_next_poweroftwo(size);
+    adjsize >>= 1;
+    extra_ranks = size - adjsize;
+
+    /* fold the extra ranks into the nearest power of two */
+    if (rank < 2 * extra_ranks) {
+        rc = ompi_coll_base_persistent_step(plan);
+        if (0 == (rank % 2)) {
+            if (OMPI_SUCCESS == rc) {
+                rc = ompi_coll_base_persistent_add_send(plan, tmpsend, count, dtype, rank + 1);
+            }
+            newrank = -1;
+        } else {
+            if (OMPI_SUCCESS == rc) {
+                rc = ompi_coll_base_persistent_add_recv(plan, tmprecv, count, dtype, rank - 1);
+            }
+            if (OMPI_SUCCESS == rc) {
+                rc = ompi_coll_base_persistent_add_reduce(plan, tmprecv, tmpsend, count, dtype, op);
+            }
+            newrank = rank >> 1;
+        }
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+    } else {
+        newrank = rank - extra_ranks;
+    }
+
+    for (distance = 0x1; distance < adjsize && newrank >= 0; distance <<= 1) {
+        int newremote = newrank ^ distance;
+        int remote = (newremote < extra_ranks) ? (newremote * 2 + 1) : (newremote + extra_ranks);
+
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_recv(plan, tmprecv, count, dtype, remote);
+        }
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_send(plan, tmpsend, count, dtype, remote);
+        }
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+
+        if (rank < remote) {
+            /* tmprecv = tmpsend (op) tmprecv */
+            rc = ompi_coll_base_persistent_add_reduce(plan, tmpsend, tmprecv, count, dtype, op);
+            tmpswap = tmprecv;
+            tmprecv = tmpsend;
+            tmpsend = tmpswap;
+        } else {
+            /* tmpsend = tmprecv (op) tmpsend */
+            rc = ompi_coll_base_persistent_add_reduce(plan, tmprecv, tmpsend, count, dtype, op);
+        }
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+    }
+
+    /* hand the result back to the extra ranks */
+    if (rank < 2 * extra_ranks) {
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+        if (0 == (rank % 2)) {
+            rc = ompi_coll_base_persistent_add_recv(plan, rbuf, count, dtype, rank + 1);
+            tmpsend = (char *) rbuf;
+        } else {
+            rc = ompi_coll_base_persistent_add_send(plan, tmpsend, count, dtype, rank - 1);
+        }
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+    }
+
+    if (tmpsend != rbuf) {
+        rc = ompi_coll_base_persistent_add_copy(plan, tmpsend, rbuf, count, dtype);
+    }
+
+done:
+    if (OMPI_SUCCESS != rc) {
+        ompi_coll_base_persistent_destroy(plan);
+        return rc;
+    }
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_base_allreduce_init_intra_ring(const void *sbuf, void *rbuf, size_t count,
+                                             ompi_datatype_t *dtype, ompi_op_t *op,
+                                             ompi_communicator_t *comm, ompi_request_t **request,
+                                             mca_coll_base_module_t *module)
+{
+    ompi_coll_base_persistent_request_t *plan;
+    int rc, rank, size, k, send_to, recv_from, split_rank;
+    size_t early_segcount, late_segcount, max_segcount;
+    ptrdiff_t lb, extent, span, gap = 0;
+    char *inbuf;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    /* the ring needs at least one element per block */
+    if (1 == size || count < (size_t) size) {
+        return ompi_coll_base_allreduce_init_intra_recursivedoubling(sbuf, rbuf, count, dtype, op,
+                                                                     comm, request, module);
+    }
+
+    rc = ompi_coll_base_persistent_create(comm, dtype, op, &plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    COLL_BASE_COMPUTE_BLOCKCOUNT(count, size, split_rank, early_segcount, late_segcount);
+    max_segcount = early_segcount;
+
+    span = opal_datatype_span(&dtype->super, max_segcount, &gap);
+    inbuf = ompi_coll_base_persistent_tmpbuf(plan, span);
+    if (NULL == inbuf) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto done;
+    }
+    inbuf -= gap;
+
+    if (MPI_IN_PLACE != sbuf) {
+        rc = ompi_coll_base_persistent_add_copy(plan, sbuf, rbuf, count, dtype);
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+    }
+
+    send_to = (rank + 1) % size;
+    recv_from = (rank + size - 1) % size;
+
+#define RING_BLOCK(B) \
+    ((char *) rbuf + extent * (((B) < split_rank) \
+                               ? (ptrdiff_t) (B) * (ptrdiff_t) early_segcount \
+                               : (ptrdiff_t) (B) * (ptrdiff_t) late_segcount + split_rank))
+#define RING_COUNT(B) (((B) < split_rank) ? early_segcount : late_segcount)
+
+    /* computation: at step k, forward block (rank - k) and reduce the
+     * incoming block (rank - k - 1) into the local copy */
+    for (k = 0; k < size - 1; ++k) {
+        int send_block = (rank - k + size) % size;
+        int recv_block = (rank - k - 1 + size) % size;
+
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_recv(plan, inbuf, RING_COUNT(recv_block), dtype,
+                                                    recv_from);
+        }
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_send(plan, RING_BLOCK(send_block),
+                                                    RING_COUNT(send_block), dtype, send_to);
+        }
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_reduce(plan, inbuf, RING_BLOCK(recv_block),
+                                                      RING_COUNT(recv_block), dtype, op);
+        }
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+    }
+
+    /* distribution: circulate the fully reduced blocks */
+    for (k = 0; k < size - 1; ++k) {
+        int send_block = (rank + 1 - k + size) % size;
+        int recv_block = (rank - k + size) % size;
+
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_recv(plan, RING_BLOCK(recv_block),
+                                                    RING_COUNT(recv_block), dtype, recv_from);
+        }
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_send(plan, RING_BLOCK(send_block),
+                                                    RING_COUNT(send_block), dtype, send_to);
+        }
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+    }
+
+#undef RING_BLOCK
+#undef RING_COUNT
+
+done:
+    if (OMPI_SUCCESS != rc) {
+        ompi_coll_base_persistent_destroy(plan);
+        return rc;
+    }
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_base_bcast_init_intra_basic_linear(void *buffer, size_t count,
+                                                 ompi_datatype_t *datatype, int root,
+                                                 ompi_communicator_t *comm,
+                                                 ompi_request_t **request,
+                                                 mca_coll_base_module_t *module)
+{
+    ompi_coll_base_persistent_request_t *plan;
+    int rc, rank, size;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    rc = ompi_coll_base_persistent_create(comm, datatype, NULL, &plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    if (rank != root) {
+        rc = ompi_coll_base_persistent_add_recv(plan, buffer, count, datatype, root);
+    } else {
+        for (int i = 0; i < size && OMPI_SUCCESS == rc; ++i) {
+            if (i != rank) {
+                rc = ompi_coll_base_persistent_add_send(plan, buffer, count, datatype, i);
+            }
+        }
+    }
+
+    if (OMPI_SUCCESS != rc) {
+        ompi_coll_base_persistent_destroy(plan);
+        return rc;
+    }
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Segmented binomial broadcast. The inner ranks pipeline the segments:
+ * at step s they receive segment s from their parent while forwarding
+ * segment s - 1 to their children.
+ */
+int ompi_coll_base_bcast_init_intra_binomial(void *buffer, size_t count, ompi_datatype_t *datatype,
+                                             int root, ompi_communicator_t *comm,
+                                             ompi_request_t **request,
+                                             mca_coll_base_module_t *module, uint32_t segsize)
+{
+    ompi_coll_base_persistent_request_t *plan;
+    ompi_coll_tree_t *tree;
+    size_t typelng, segcount = count;
+    ptrdiff_t lb, extent;
+    int rc, rank, nseg;
+
+    rank = ompi_comm_rank(comm);
+
+    rc = ompi_coll_base_persistent_create(comm, datatype, NULL, &plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    if (0 == count || 1 == ompi_comm_size(comm)) {
+        goto done;
+    }
+
+    tree = ompi_coll_base_topo_build_bmtree(comm, root);
+    if (NULL == tree) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto done;
+    }
+
+    ompi_datatype_type_size(datatype, &typelng);
+    ompi_datatype_get_extent(datatype, &lb, &extent);
+    COLL_BASE_COMPUTED_SEGCOUNT((size_t) segsize, typelng, segcount);
+    nseg = (int) ((count + segcount - 1) / segcount);
+
+#define BCAST_SEG(S) ((char *) buffer + (ptrdiff_t) (S) * (ptrdiff_t) segcount * extent)
+#define BCAST_COUNT(S) (((size_t) (S) == (size_t) (nseg - 1)) ? count - (size_t) (S) * segcount : segcount)
+
+    if (0 == tree->tree_nextsize) {
+        /* leaves only receive, all the segments can be posted at once */
+        for (int s = 0; s < nseg && OMPI_SUCCESS == rc; ++s) {
+            rc = ompi_coll_base_persistent_add_recv(plan, BCAST_SEG(s), BCAST_COUNT(s), datatype,
+                                                    tree->tree_prev);
+        }
+    } else {
+        int first = (rank == root) ? 0 : -1;
+
+        for (int s = first; s < nseg && OMPI_SUCCESS == rc; ++s) {
+            rc = ompi_coll_base_persistent_step(plan);
+            if (rank != root && s + 1 < nseg && OMPI_SUCCESS == rc) {
+                rc = ompi_coll_base_persistent_add_recv(plan, BCAST_SEG(s + 1), BCAST_COUNT(s + 1),
+                                                        datatype, tree->tree_prev);
+            }
+            for (int c = 0; s >= 0 && c < tree->tree_nextsize && OMPI_SUCCESS == rc; ++c) {
+                rc = ompi_coll_base_persistent_add_send(plan, BCAST_SEG(s), BCAST_COUNT(s),
+                                                        datatype, tree->tree_next[c]);
+            }
+        }
+    }
+
+#undef BCAST_SEG
+#undef BCAST_COUNT
+
+    ompi_coll_base_topo_destroy_tree(&tree);
+
+done:
+    if (OMPI_SUCCESS != rc) {
+        ompi_coll_base_persistent_destroy(plan);
+        return rc;
+    }
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Linear reduction in rank order, valid for non-commutative operations:
+ * the root accumulates the contributions from rank size - 1 down to 0.
+ */
+int ompi_coll_base_reduce_init_intra_basic_linear(const void *sbuf, void *rbuf, size_t count,
+                                                  ompi_datatype_t *dtype, ompi_op_t *op, int root,
+                                                  ompi_communicator_t *comm,
+                                                  ompi_request_t **request,
+                                                  mca_coll_base_module_t *module)
+{
+    ompi_coll_base_persistent_request_t *plan;
+    int rc, rank, size;
+    ptrdiff_t span, gap = 0;
+    char *inbuf = NULL, *sbuf_copy;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    rc = ompi_coll_base_persistent_create(comm, dtype, op, &plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    if (rank != root) {
+        rc = ompi_coll_base_persistent_add_send(plan, sbuf, count, dtype, root);
+        goto done;
+    }
+    if (1 == size) {
+        if (MPI_IN_PLACE != sbuf) {
+            rc = ompi_coll_base_persistent_add_copy(plan, sbuf, rbuf, count, dtype);
+        }
+        goto done;
+    }
+
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    inbuf = ompi_coll_base_persistent_tmpbuf(plan, 2 * span);
+    if (NULL == inbuf) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto done;
+    }
+    inbuf -= gap;
+
+    /* rbuf is overwritten by the first contribution, keep the local one */
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf_copy = inbuf + span;
+        rc = ompi_coll_base_persistent_add_copy(plan, rbuf, sbuf_copy, count, dtype);
+        if (OMPI_SUCCESS != rc) {
+            goto done;
+        }
+        sbuf = sbuf_copy;
+    }
+
+    if (rank == size - 1) {
+        rc = ompi_coll_base_persistent_add_copy(plan, sbuf, rbuf, count, dtype);
+    } else {
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_recv(plan, rbuf, count, dtype, size - 1);
+        }
+    }
+
+    for (int i = size - 2; i >= 0 && OMPI_SUCCESS == rc; --i) {
+        if (rank == i) {
+            rc = ompi_coll_base_persistent_add_reduce(plan, sbuf, rbuf, count, dtype, op);
+            continue;
+        }
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_recv(plan, inbuf, count, dtype, i);
+        }
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_reduce(plan, inbuf, rbuf, count, dtype, op);
+        }
+    }
+
+done:
+    if (OMPI_SUCCESS != rc) {
+        ompi_coll_base_persistent_destroy(plan);
+        return rc;
+    }
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Binomial reduction for commutative operations. The contributions of
+ * all the children are received at once, each in its own buffer.
+ */
+int ompi_coll_base_reduce_init_intra_binomial(const void *sbuf, void *rbuf, size_t count,
+                                              ompi_datatype_t *dtype, ompi_op_t *op, int root,
+                                              ompi_communicator_t *comm, ompi_request_t **request,
+                                              mca_coll_base_module_t *module)
+{
+    ompi_coll_base_persistent_request_t *plan;
+    ompi_coll_tree_t *tree;
+    int rc, rank, nchildren;
+    ptrdiff_t span, gap = 0;
+    char *tmpbuf, *accbuf;
+
+    rank = ompi_comm_rank(comm);
+
+    rc = ompi_coll_base_persistent_create(comm, dtype, op, &plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    tree = ompi_coll_base_topo_build_bmtree(comm, root);
+    if (NULL == tree) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto done;
+    }
+    nchildren = tree->tree_nextsize;
+
+    if (0 == nchildren) {
+        if (rank != root) {
+            rc = ompi_coll_base_persistent_add_send(plan, sbuf, count, dtype, tree->tree_prev);
+        } else if (MPI_IN_PLACE != sbuf) {
+            rc = ompi_coll_base_persistent_add_copy(plan, sbuf, rbuf, count, dtype);
+        }
+        goto done_tree;
+    }
+
+    /* one receive buffer per child, plus the accumulator on inner ranks */
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    tmpbuf = ompi_coll_base_persistent_tmpbuf(plan, (nchildren + 1) * span);
+    if (NULL == tmpbuf) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto done_tree;
+    }
+    tmpbuf -= gap;
+
+    accbuf = (rank == root) ? (char *) rbuf : tmpbuf + nchildren * span;
+    if (MPI_IN_PLACE != sbuf) {
+        rc = ompi_coll_base_persistent_add_copy(plan, sbuf, accbuf, count, dtype);
+    }
+
+    if (OMPI_SUCCESS == rc) {
+        rc = ompi_coll_base_persistent_step(plan);
+    }
+    for (int c = 0; c < nchildren && OMPI_SUCCESS == rc; ++c) {
+        rc = ompi_coll_base_persistent_add_recv(plan, tmpbuf + c * span, count, dtype,
+                                                tree->tree_next[c]);
+    }
+    for (int c = 0; c < nchildren && OMPI_SUCCESS == rc; ++c) {
+        rc = ompi_coll_base_persistent_add_reduce(plan, tmpbuf + c * span, accbuf, count, dtype,
+                                                  op);
+    }
+
+    if (rank != root && OMPI_SUCCESS == rc) {
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_send(plan, accbuf, count, dtype, tree->tree_prev);
+        }
+    }
+
+done_tree:
+    ompi_coll_base_topo_destroy_tree(&tree);
+done:
+    if (OMPI_SUCCESS != rc) {
+        ompi_coll_base_persistent_destroy(plan);
+        return rc;
+    }
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Dissemination barrier with zero-byte messages.
+ */
+int ompi_coll_base_barrier_init_intra_bruck(ompi_communicator_t *comm, ompi_request_t **request,
+                                            mca_coll_base_module_t *module)
+{
+    ompi_coll_base_persistent_request_t *plan;
+    int rc, rank, size;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    rc = ompi_coll_base_persistent_create(comm, NULL, NULL, &plan);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    for (int distance = 1; distance < size && OMPI_SUCCESS == rc; distance <<= 1) {
+        rc = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_recv(plan, NULL, 0, MPI_BYTE,
+                                                    (rank + size - distance) % size);
+        }
+        if (OMPI_SUCCESS == rc) {
+            rc = ompi_coll_base_persistent_add_send(plan, NULL, 0, MPI_BYTE,
+                                                    (rank + distance) % size);
+        }
+    }
+
+    if (OMPI_SUCCESS != rc) {
+        ompi_coll_base_persistent_destroy(plan);
+        return rc;
+    }
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+}
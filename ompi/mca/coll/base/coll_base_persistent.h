@@ -0,0 +1,163 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Pre-computed plans for persistent collectives.
+ *
+ * A plan is built once, when the *_init function is called: the
+ * algorithm is chosen, the temporary buffers are allocated and every
+ * point-to-point exchange is bound to a persistent PML request (or to a
+ * persistent collective request on a sub-communicator). The plan is an
+ * ordered list of steps; each step starts its requests, waits for them
+ * and then optionally applies one local reduction or copy. MPI_Start
+ * only rewinds the plan and starts the first step, and the remaining
+ * steps are driven from the progress engine.
+ */
+
+#ifndef MCA_COLL_BASE_PERSISTENT_H
+#define MCA_COLL_BASE_PERSISTENT_H
+
+#include "ompi_config.h"
+
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+
+BEGIN_C_DECLS
+
+typedef enum {
+    OMPI_COLL_BASE_PERSISTENT_NONE = 0,
+    OMPI_COLL_BASE_PERSISTENT_REDUCE,
+    OMPI_COLL_BASE_PERSISTENT_COPY
+} ompi_coll_base_persistent_action_t;
+
+typedef struct ompi_coll_base_persistent_step_t {
+    /** index of the first request of this step in the plan */
+    int first_req;
+    int nreqs;
+    /** local operation applied once all the requests completed */
+    ompi_coll_base_persistent_action_t action;
+    const void *src;
+    void *dst;
+    size_t count;
+    ompi_datatype_t *dtype;
+    ompi_op_t *op;
+} ompi_coll_base_persistent_step_t;
+
+struct ompi_coll_base_persistent_request_t {
+    ompi_coll_base_nbc_request_t super;
+    ompi_communicator_t *comm;
+    int tag;
+
+    ompi_coll_base_persistent_step_t *steps;
+    int nsteps;
+    int steps_size;
+    ompi_request_t **reqs;
+    int nreqs;
+    int reqs_size;
+
+    /** progress through the plan, reset by each MPI_Start */
+    int current;
+    bool current_started;
+
+    /** temporary memory owned by the plan */
+    void *tmpbuf;
+};
+typedef struct ompi_coll_base_persistent_request_t ompi_coll_base_persistent_request_t;
+
+OMPI_DECLSPEC OBJ_CLASS_DECLARATION(ompi_coll_base_persistent_request_t);
+
+/**
+ * Create an empty plan on comm. The datatype and the operation are
+ * retained until the request is freed.
+ */
+int ompi_coll_base_persistent_create(ompi_communicator_t *comm, ompi_datatype_t *dtype,
+                                     ompi_op_t *op,
+                                     ompi_coll_base_persistent_request_t **request);
+
+/**
+ * Release a plan that was never returned to the user (error path of
+ * the builders).
+ */
+void ompi_coll_base_persistent_destroy(ompi_coll_base_persistent_request_t *request);
+
+/**
+ * Allocate the temporary memory of the plan. Can only be called once
+ * per plan; the memory is released with the request.
+ */
+void *ompi_coll_base_persistent_tmpbuf(ompi_coll_base_persistent_request_t *request, size_t size);
+
+/**
+ * Open a new step: the requests added afterwards are started only when
+ * all the previous steps completed.
+ */
+int ompi_coll_base_persistent_step(ompi_coll_base_persistent_request_t *request);
+
+int ompi_coll_base_persistent_add_send(ompi_coll_base_persistent_request_t *request,
+                                       const void *buf, size_t count, ompi_datatype_t *dtype,
+                                       int peer);
+int ompi_coll_base_persistent_add_recv(ompi_coll_base_persistent_request_t *request, void *buf,
+                                       size_t count, ompi_datatype_t *dtype, int peer);
+
+/**
+ * Add an already initialized persistent request to the current step.
+ * The plan takes ownership of the request.
+ */
+int ompi_coll_base_persistent_add_request(ompi_coll_base_persistent_request_t *request,
+                                          ompi_request_t *subreq);
+
+/**
+ * Apply dst = src op dst (resp. copy src into dst) once the requests of
+ * the current step completed.
+ */
+int ompi_coll_base_persistent_add_reduce(ompi_coll_base_persistent_request_t *request,
+                                         const void *src, void *dst, size_t count,
+                                         ompi_datatype_t *dtype, ompi_op_t *op);
+int ompi_coll_base_persistent_add_copy(ompi_coll_base_persistent_request_t *request,
+                                       const void *src, void *dst, size_t count,
+                                       ompi_datatype_t *dtype);
+
+/*
+ * Plans for the algorithms of coll/base. They all return a persistent
+ * request, ready to be started.
+ */
+int ompi_coll_base_allreduce_init_intra_recursivedoubling(const void *sbuf, void *rbuf,
+                                                          size_t count, ompi_datatype_t *dtype,
+                                                          ompi_op_t *op, ompi_communicator_t *comm,
+                                                          ompi_request_t **request,
+                                                          mca_coll_base_module_t *module);
+int ompi_coll_base_allreduce_init_intra_ring(const void *sbuf, void *rbuf, size_t count,
+                                             ompi_datatype_t *dtype, ompi_op_t *op,
+                                             ompi_communicator_t *comm, ompi_request_t **request,
+                                             mca_coll_base_module_t *module);
+int ompi_coll_base_bcast_init_intra_basic_linear(void *buffer, size_t count,
+                                                 ompi_datatype_t *datatype, int root,
+                                                 ompi_communicator_t *comm,
+                                                 ompi_request_t **request,
+                                                 mca_coll_base_module_t *module);
+int ompi_coll_base_bcast_init_intra_binomial(void *buffer, size_t count, ompi_datatype_t *datatype,
+                                             int root, ompi_communicator_t *comm,
+                                             ompi_request_t **request,
+                                             mca_coll_base_module_t *module, uint32_t segsize);
+int ompi_coll_base_reduce_init_intra_basic_linear(const void *sbuf, void *rbuf, size_t count,
+                                                  ompi_datatype_t *dtype, ompi_op_t *op, int root,
+                                                  ompi_communicator_t *comm,
+                                                  ompi_request_t **request,
+                                                  mca_coll_base_module_t *module);
+int ompi_coll_base_reduce_init_intra_binomial(const void *sbuf, void *rbuf, size_t count,
+                                              ompi_datatype_t *dtype, ompi_op_t *op, int root,
+                                              ompi_communicator_t *comm, ompi_request_t **request,
+                                              mca_coll_base_module_t *module);
+int ompi_coll_base_barrier_init_intra_bruck(ompi_communicator_t *comm, ompi_request_t **request,
+                                            mca_coll_base_module_t *module);
+
+END_C_DECLS
+
+#endif /* MCA_COLL_BASE_PERSISTENT_H */
@@ -604,15 +604,12 @@ ompi_coll_base_reduce_scatter_intra_ring( const void *sbuf, void *rbuf, ompi_cou
     ret = ompi_request_wait(&reqs[inbi], MPI_STATUS_IGNORE);
     if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
 
-    /* Apply operation on the last block (my block)
+    /* Apply operation on the last block (my block) and copy the result
+       to rbuf in the same pass
        rbuf[rank] = inbuf[inbi] (op) rbuf[rank] */
     tmprecv = accumbuf + displs[rank] * extent;
-    ompi_op_reduce(op, inbuf[inbi], tmprecv, ompi_count_array_get(rcounts, rank), dtype);
-
-    /* Copy result from tmprecv to rbuf */
-    ret = ompi_datatype_copy_content_same_ddt(dtype, ompi_count_array_get(rcounts, rank),
-                                              (char *)rbuf, tmprecv);
-    if (ret < 0) { line = __LINE__; goto error_hndl; }
+    ompi_op_reduce_copy(op, inbuf[inbi], tmprecv, rbuf,
+                        ompi_count_array_get(rcounts, rank), dtype);
 
     if (NULL != displs) free(displs);
     if (NULL != accumbuf_free) free(accumbuf_free);
@@ -255,6 +255,8 @@ typedef struct mca_coll_han_component_t {
     uint32_t han_scatterv_up_module;
     /* low level module for scatterv */
     uint32_t han_scatterv_low_module;
+    /* segment size for reduce_scatter */
+    uint32_t han_reduce_scatter_segsize;
 
     /* low level module for alltoall */
     uint32_t han_alltoall_low_module;
@@ -296,6 +298,9 @@ typedef struct mca_coll_han_component_t {
     opal_free_list_t pack_buffers;
     int64_t han_packbuf_max_count;
     int64_t han_packbuf_bytes;
+
+    /* largest block aggregated between nodes by the neighborhood collectives */
+    int64_t han_neighbor_aggregate_max;
 } mca_coll_han_component_t;
 
 /*
@@ -318,6 +323,17 @@ typedef struct mca_coll_han_single_collective_fallback_s
         mca_coll_base_module_reduce_fn_t reduce;
         mca_coll_base_module_scatter_fn_t scatter;
         mca_coll_base_module_scatterv_fn_t scatterv;
+        mca_coll_base_module_allreduce_init_fn_t allreduce_init;
+        mca_coll_base_module_bcast_init_fn_t bcast_init;
+        mca_coll_base_module_reduce_scatter_fn_t reduce_scatter;
+        mca_coll_base_module_reduce_scatter_block_fn_t reduce_scatter_block;
+        mca_coll_base_module_scan_fn_t scan;
+        mca_coll_base_module_exscan_fn_t exscan;
+        mca_coll_base_module_allgather_fn_t neighbor_allgather;
+        mca_coll_base_module_allgatherv_fn_t neighbor_allgatherv;
+        mca_coll_base_module_alltoall_fn_t neighbor_alltoall;
+        mca_coll_base_module_alltoallv_fn_t neighbor_alltoallv;
+        mca_coll_base_module_neighbor_alltoallw_fn_t neighbor_alltoallw;
     };
     mca_coll_base_module_t* module;
 } mca_coll_han_single_collective_fallback_t;
@@ -341,8 +357,22 @@ typedef struct mca_coll_han_collectives_fallback_s
     mca_coll_han_single_collective_fallback_t gatherv;
     mca_coll_han_single_collective_fallback_t scatter;
     mca_coll_han_single_collective_fallback_t scatterv;
+    mca_coll_han_single_collective_fallback_t allreduce_init;
+    mca_coll_han_single_collective_fallback_t bcast_init;
+    mca_coll_han_single_collective_fallback_t reduce_scatter;
+    mca_coll_han_single_collective_fallback_t reduce_scatter_block;
+    mca_coll_han_single_collective_fallback_t scan;
+    mca_coll_han_single_collective_fallback_t exscan;
+    mca_coll_han_single_collective_fallback_t neighbor_allgather;
+    mca_coll_han_single_collective_fallback_t neighbor_allgatherv;
+    mca_coll_han_single_collective_fallback_t neighbor_alltoall;
+    mca_coll_han_single_collective_fallback_t neighbor_alltoallv;
+    mca_coll_han_single_collective_fallback_t neighbor_alltoallw;
 } mca_coll_han_collectives_fallback_t;
 
+/* Plan of the neighborhood collectives, see coll_han_neighbor.c */
+typedef struct mca_coll_han_neighbor_plan_s mca_coll_han_neighbor_plan_t;
+
 /** Coll han module */
 typedef struct mca_coll_han_module_t {
     /** Base module */
@@ -386,6 +416,11 @@ typedef struct mca_coll_han_module_t {
 
     /* Sub-communicator */
     struct ompi_communicator_t *sub_comm[NB_TOPO_LVL];
+
+    /* Neighborhood collectives plan, built on first use */
+    mca_coll_han_neighbor_plan_t *neighbor_plan;
+    /* the plan could not be built, use the previous component */
+    bool neighbor_plan_failed;
 } mca_coll_han_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_han_module_t);
 
@@ -429,6 +464,39 @@ OBJ_CLASS_DECLARATION(mca_coll_han_module_t);
 #define previous_scatterv           fallback.scatterv.scatterv
 #define previous_scatterv_module    fallback.scatterv.module
 
+#define previous_allreduce_init         fallback.allreduce_init.allreduce_init
+#define previous_allreduce_init_module  fallback.allreduce_init.module
+
+#define previous_bcast_init         fallback.bcast_init.bcast_init
+#define previous_bcast_init_module  fallback.bcast_init.module
+
+#define previous_reduce_scatter             fallback.reduce_scatter.reduce_scatter
+#define previous_reduce_scatter_module      fallback.reduce_scatter.module
+
+#define previous_reduce_scatter_block         fallback.reduce_scatter_block.reduce_scatter_block
+#define previous_reduce_scatter_block_module  fallback.reduce_scatter_block.module
+
+#define previous_scan               fallback.scan.scan
+#define previous_scan_module        fallback.scan.module
+
+#define previous_exscan             fallback.exscan.exscan
+#define previous_exscan_module      fallback.exscan.module
+
+#define previous_neighbor_allgather          fallback.neighbor_allgather.neighbor_allgather
+#define previous_neighbor_allgather_module   fallback.neighbor_allgather.module
+
+#define previous_neighbor_allgatherv         fallback.neighbor_allgatherv.neighbor_allgatherv
+#define previous_neighbor_allgatherv_module  fallback.neighbor_allgatherv.module
+
+#define previous_neighbor_alltoall           fallback.neighbor_alltoall.neighbor_alltoall
+#define previous_neighbor_alltoall_module    fallback.neighbor_alltoall.module
+
+#define previous_neighbor_alltoallv          fallback.neighbor_alltoallv.neighbor_alltoallv
+#define previous_neighbor_alltoallv_module   fallback.neighbor_alltoallv.module
+
+#define previous_neighbor_alltoallw          fallback.neighbor_alltoallw.neighbor_alltoallw
+#define previous_neighbor_alltoallw_module   fallback.neighbor_alltoallw.module
+
 /* macro to correctly load a fallback collective module */
 #define HAN_UNINSTALL_COLL_API(__comm, __module, __api)                                  \
     do                                                                                   \
@@ -456,6 +524,17 @@ OBJ_CLASS_DECLARATION(mca_coll_han_module_t);
         HAN_UNINSTALL_COLL_API(COMM, HANM, allgatherv);                \
         HAN_UNINSTALL_COLL_API(COMM, HANM, alltoall);                  \
         HAN_UNINSTALL_COLL_API(COMM, HANM, alltoallv);                 \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, allreduce_init);            \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, bcast_init);                \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, reduce_scatter);            \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, reduce_scatter_block);      \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, scan);                      \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, exscan);                    \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, neighbor_allgather);        \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, neighbor_allgatherv);       \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, neighbor_alltoall);         \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, neighbor_alltoallv);        \
+        HAN_UNINSTALL_COLL_API(COMM, HANM, neighbor_alltoallw);        \
         han_module->enabled = false;  /* entire module set to pass-through from now on */ \
     } while(0)
 
@@ -551,10 +630,42 @@ mca_coll_han_scatter_intra_dynamic(SCATTER_BASE_ARGS,
 int
 mca_coll_han_scatterv_intra_dynamic(SCATTERV_BASE_ARGS,
                                     mca_coll_base_module_t *module);
+int
+mca_coll_han_reduce_scatter_intra_dynamic(REDUCESCATTER_BASE_ARGS,
+                                          mca_coll_base_module_t *module);
+int
+mca_coll_han_reduce_scatter_block_intra_dynamic(REDUCESCATTERBLOCK_BASE_ARGS,
+                                                mca_coll_base_module_t *module);
+int
+mca_coll_han_scan_intra_dynamic(SCAN_BASE_ARGS,
+                                mca_coll_base_module_t *module);
+int
+mca_coll_han_exscan_intra_dynamic(EXSCAN_BASE_ARGS,
+                                  mca_coll_base_module_t *module);
 
 int mca_coll_han_barrier_intra_simple(struct ompi_communicator_t *comm,
                                       mca_coll_base_module_t *module);
 
+/* persistent collectives */
+int
+mca_coll_han_allreduce_init_intra(ALLREDUCE_INIT_ARGS);
+int
+mca_coll_han_bcast_init_intra(BCAST_INIT_ARGS);
+
+/* neighborhood collectives on distributed graph communicators */
+int
+mca_coll_han_neighbor_allgather_intra(NEIGHBOR_ALLGATHER_ARGS);
+int
+mca_coll_han_neighbor_allgatherv_intra(NEIGHBOR_ALLGATHERV_ARGS);
+int
+mca_coll_han_neighbor_alltoall_intra(NEIGHBOR_ALLTOALL_ARGS);
+int
+mca_coll_han_neighbor_alltoallv_intra(NEIGHBOR_ALLTOALLV_ARGS);
+int
+mca_coll_han_neighbor_alltoallw_intra(NEIGHBOR_ALLTOALLW_ARGS);
+void
+mca_coll_han_neighbor_plan_free(mca_coll_han_neighbor_plan_t *plan);
+
 /* reordering after gather, for unordered ranks */
 void
 ompi_coll_han_reorder_gather(const void *sbuf,
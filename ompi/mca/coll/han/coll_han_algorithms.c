@@ -86,6 +86,22 @@ mca_coll_han_algorithm_value_t*  mca_coll_han_available_algorithms[COLLCOUNT] =
         {"smsc", (fnptr_t)&mca_coll_han_alltoallv_using_smsc}, // 2-level
         { 0 }
     },
+    [REDUCESCATTER] = (mca_coll_han_algorithm_value_t[]){
+        {"intra", (fnptr_t)&mca_coll_han_reduce_scatter_intra}, // 2-level
+        { 0 }
+    },
+    [REDUCESCATTERBLOCK] = (mca_coll_han_algorithm_value_t[]){
+        {"intra", (fnptr_t)&mca_coll_han_reduce_scatter_block_intra}, // 2-level
+        { 0 }
+    },
+    [SCAN] = (mca_coll_han_algorithm_value_t[]){
+        {"intra", (fnptr_t)&mca_coll_han_scan_intra}, // 2-level
+        { 0 }
+    },
+    [EXSCAN] = (mca_coll_han_algorithm_value_t[]){
+        {"intra", (fnptr_t)&mca_coll_han_exscan_intra}, // 2-level
+        { 0 }
+    },
 };
 
 int
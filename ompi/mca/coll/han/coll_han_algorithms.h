@@ -219,5 +219,25 @@ int
 mca_coll_han_alltoallv_using_smsc(ALLTOALLV_BASE_ARGS,
                                     mca_coll_base_module_t *module);
 
+/* Reduce_scatter */
+int
+mca_coll_han_reduce_scatter_intra(REDUCESCATTER_BASE_ARGS,
+                                  mca_coll_base_module_t *module);
+
+/* Reduce_scatter_block */
+int
+mca_coll_han_reduce_scatter_block_intra(REDUCESCATTERBLOCK_BASE_ARGS,
+                                        mca_coll_base_module_t *module);
+
+/* Scan */
+int
+mca_coll_han_scan_intra(SCAN_BASE_ARGS,
+                        mca_coll_base_module_t *module);
+
+/* Exscan */
+int
+mca_coll_han_exscan_intra(EXSCAN_BASE_ARGS,
+                          mca_coll_base_module_t *module);
+
 
 #endif
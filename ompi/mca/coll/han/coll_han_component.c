@@ -416,6 +416,14 @@ static int han_register(void)
                                               "low level module for scatterv, 0 basic",
                                               OPAL_INFO_LVL_9, &cs->han_scatterv_low_module,
                                               &cs->han_op_module_name.scatterv.han_op_low_module_name);
+
+    cs->han_reduce_scatter_segsize = 65536;
+    (void) mca_base_component_var_register(c, "reduce_scatter_segsize",
+                                           "segment size for reduce_scatter and reduce_scatter_block",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_ALL, &cs->han_reduce_scatter_segsize);
+
     cs->han_alltoall_low_module = 0;
     (void) mca_coll_han_query_module_from_mca(c, "alltoall_lower_module",
                                               "low level module for alltoall, 0 tuned, 1 sm ",
@@ -471,6 +479,16 @@ static int han_register(void)
                                            OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL,
                                            &cs->han_packbuf_max_count);
 
+    cs->han_neighbor_aggregate_max = 4096;
+    (void) mca_base_component_var_register(c, "neighbor_aggregate_max",
+                                           "Largest block (in bytes) that the neighborhood collectives on "
+                                           "distributed graphs aggregate into one message per pair of nodes. "
+                                           "Larger blocks are sent directly; 0 disables aggregation. "
+                                           "Must be the same on all the processes.",
+                                           MCA_BASE_VAR_TYPE_INT64_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &cs->han_neighbor_aggregate_max);
+
     /*
      * Han algorithms MCA parameters for each collective.
      * Shows algorithms thanks to enumerator
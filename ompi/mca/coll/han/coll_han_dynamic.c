@@ -45,9 +45,13 @@ bool mca_coll_han_is_coll_dynamic_implemented(COLLTYPE_T coll_id)
     case ALLTOALLV:
     case BARRIER:
     case BCAST:
+    case EXSCAN:
     case GATHER:
     case GATHERV:
     case REDUCE:
+    case REDUCESCATTER:
+    case REDUCESCATTERBLOCK:
+    case SCAN:
     case SCATTER:
     case SCATTERV:
         return true;
@@ -1747,3 +1751,430 @@ mca_coll_han_alltoallv_intra_dynamic(
      */
     return alltoallv(ALLTOALLV_BASE_ARG_NAMES, sub_module);
 }
+
+
+/*
+ * Reduce_scatter selector:
+ * On a sub-communicator, checks the stored rules to find the module to use
+ * On the global communicator, calls the han collective implementation, or
+ * calls the correct module if fallback mechanism is activated
+ */
+int
+mca_coll_han_reduce_scatter_intra_dynamic(REDUCESCATTER_BASE_ARGS,
+                                          mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t*) module;
+    TOPO_LVL_T topo_lvl = han_module->topologic_level;
+    mca_coll_base_module_reduce_scatter_fn_t reduce_scatter;
+    mca_coll_base_module_t *sub_module;
+    size_t dtype_size, count = 0;
+    int rank, verbosity = 0;
+
+    if (!han_module->enabled) {
+        return han_module->previous_reduce_scatter(REDUCESCATTER_BASE_ARG_NAMES,
+                                                   han_module->previous_reduce_scatter_module);
+    }
+
+    /* Compute configuration information for dynamic rules */
+    ompi_datatype_type_size(datatype, &dtype_size);
+    for (int i = 0; i < ompi_comm_size(comm); i++) {
+        count += ompi_count_array_get(recvcounts, i);
+    }
+    dtype_size = dtype_size * count;
+
+    sub_module = get_module(REDUCESCATTER,
+                            dtype_size,
+                            comm,
+                            han_module);
+
+    /* First errors are always printed by rank 0 */
+    rank = ompi_comm_rank(comm);
+    if( (0 == rank) && (han_module->dynamic_errors < mca_coll_han_component.max_dynamic_errors) ) {
+        verbosity = 30;
+    }
+
+    if(NULL == sub_module) {
+        /*
+         * No valid collective module from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_reduce_scatter_intra_dynamic "
+                            "HAN did not find any valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s). "
+                            "Please check dynamic file/mca parameters\n",
+                            REDUCESCATTER, mca_coll_base_colltype_to_str(REDUCESCATTER),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/REDUCESCATTER: No module found for the sub-communicator. "
+                             "Falling back to another component\n"));
+        reduce_scatter = han_module->previous_reduce_scatter;
+        sub_module = han_module->previous_reduce_scatter_module;
+    } else if (NULL == sub_module->coll_reduce_scatter) {
+        /*
+         * No valid collective from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_reduce_scatter_intra_dynamic "
+                            "HAN found valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s) "
+                            "but this module cannot handle this collective. "
+                            "Please check dynamic file/mca parameters\n",
+                            REDUCESCATTER, mca_coll_base_colltype_to_str(REDUCESCATTER),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/REDUCESCATTER: the module found for the sub-"
+                             "communicator cannot handle the REDUCESCATTER operation. "
+                             "Falling back to another component\n"));
+        reduce_scatter = han_module->previous_reduce_scatter;
+        sub_module = han_module->previous_reduce_scatter_module;
+    } else if (GLOBAL_COMMUNICATOR == topo_lvl && sub_module == module) {
+        /*
+         * No fallback mechanism activated for this configuration
+         * sub_module is valid
+         * sub_module->coll_reduce_scatter is valid and point to this function
+         * Call han topological collective algorithm
+         */
+        int algorithm_id = get_algorithm(REDUCESCATTER,
+                                         dtype_size,
+                                         comm,
+                                         han_module);
+        reduce_scatter = (mca_coll_base_module_reduce_scatter_fn_t)mca_coll_han_algorithm_id_to_fn(REDUCESCATTER, algorithm_id);
+        if (NULL == reduce_scatter) { /* default behaviour */
+            reduce_scatter = mca_coll_han_reduce_scatter_intra;
+        }
+    } else {
+        /*
+         * If we get here:
+         * sub_module is valid
+         * sub_module->coll_reduce_scatter is valid
+         * They points to the collective to use, according to the dynamic rules
+         * Selector's job is done, call the collective
+         */
+        reduce_scatter = sub_module->coll_reduce_scatter;
+    }
+    return reduce_scatter(REDUCESCATTER_BASE_ARG_NAMES, sub_module);
+}
+
+
+/*
+ * Reduce_scatter_block selector:
+ * On a sub-communicator, checks the stored rules to find the module to use
+ * On the global communicator, calls the han collective implementation, or
+ * calls the correct module if fallback mechanism is activated
+ */
+int
+mca_coll_han_reduce_scatter_block_intra_dynamic(REDUCESCATTERBLOCK_BASE_ARGS,
+                                                mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t*) module;
+    TOPO_LVL_T topo_lvl = han_module->topologic_level;
+    mca_coll_base_module_reduce_scatter_block_fn_t reduce_scatter_block;
+    mca_coll_base_module_t *sub_module;
+    size_t dtype_size;
+    int rank, verbosity = 0;
+
+    if (!han_module->enabled) {
+        return han_module->previous_reduce_scatter_block(REDUCESCATTERBLOCK_BASE_ARG_NAMES,
+                                                         han_module->previous_reduce_scatter_block_module);
+    }
+
+    /* Compute configuration information for dynamic rules */
+    ompi_datatype_type_size(datatype, &dtype_size);
+    dtype_size = dtype_size * recvcount * ompi_comm_size(comm);
+
+    sub_module = get_module(REDUCESCATTERBLOCK,
+                            dtype_size,
+                            comm,
+                            han_module);
+
+    /* First errors are always printed by rank 0 */
+    rank = ompi_comm_rank(comm);
+    if( (0 == rank) && (han_module->dynamic_errors < mca_coll_han_component.max_dynamic_errors) ) {
+        verbosity = 30;
+    }
+
+    if(NULL == sub_module) {
+        /*
+         * No valid collective module from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_reduce_scatter_block_intra_dynamic "
+                            "HAN did not find any valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s). "
+                            "Please check dynamic file/mca parameters\n",
+                            REDUCESCATTERBLOCK, mca_coll_base_colltype_to_str(REDUCESCATTERBLOCK),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/REDUCESCATTERBLOCK: No module found for the sub-communicator. "
+                             "Falling back to another component\n"));
+        reduce_scatter_block = han_module->previous_reduce_scatter_block;
+        sub_module = han_module->previous_reduce_scatter_block_module;
+    } else if (NULL == sub_module->coll_reduce_scatter_block) {
+        /*
+         * No valid collective from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_reduce_scatter_block_intra_dynamic "
+                            "HAN found valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s) "
+                            "but this module cannot handle this collective. "
+                            "Please check dynamic file/mca parameters\n",
+                            REDUCESCATTERBLOCK, mca_coll_base_colltype_to_str(REDUCESCATTERBLOCK),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/REDUCESCATTERBLOCK: the module found for the sub-"
+                             "communicator cannot handle the REDUCESCATTERBLOCK operation. "
+                             "Falling back to another component\n"));
+        reduce_scatter_block = han_module->previous_reduce_scatter_block;
+        sub_module = han_module->previous_reduce_scatter_block_module;
+    } else if (GLOBAL_COMMUNICATOR == topo_lvl && sub_module == module) {
+        /*
+         * No fallback mechanism activated for this configuration
+         * sub_module is valid
+         * sub_module->coll_reduce_scatter_block is valid and point to this function
+         * Call han topological collective algorithm
+         */
+        int algorithm_id = get_algorithm(REDUCESCATTERBLOCK,
+                                         dtype_size,
+                                         comm,
+                                         han_module);
+        reduce_scatter_block = (mca_coll_base_module_reduce_scatter_block_fn_t)mca_coll_han_algorithm_id_to_fn(REDUCESCATTERBLOCK, algorithm_id);
+        if (NULL == reduce_scatter_block) { /* default behaviour */
+            reduce_scatter_block = mca_coll_han_reduce_scatter_block_intra;
+        }
+    } else {
+        /*
+         * If we get here:
+         * sub_module is valid
+         * sub_module->coll_reduce_scatter_block is valid
+         * They points to the collective to use, according to the dynamic rules
+         * Selector's job is done, call the collective
+         */
+        reduce_scatter_block = sub_module->coll_reduce_scatter_block;
+    }
+    return reduce_scatter_block(REDUCESCATTERBLOCK_BASE_ARG_NAMES, sub_module);
+}
+
+
+/*
+ * Scan selector:
+ * On a sub-communicator, checks the stored rules to find the module to use
+ * On the global communicator, calls the han collective implementation, or
+ * calls the correct module if fallback mechanism is activated
+ */
+int
+mca_coll_han_scan_intra_dynamic(SCAN_BASE_ARGS,
+                                mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t*) module;
+    TOPO_LVL_T topo_lvl = han_module->topologic_level;
+    mca_coll_base_module_scan_fn_t scan;
+    mca_coll_base_module_t *sub_module;
+    size_t dtype_size;
+    int rank, verbosity = 0;
+
+    if (!han_module->enabled) {
+        return han_module->previous_scan(SCAN_BASE_ARG_NAMES,
+                                         han_module->previous_scan_module);
+    }
+
+    /* Compute configuration information for dynamic rules */
+    ompi_datatype_type_size(datatype, &dtype_size);
+    dtype_size = dtype_size * count;
+
+    sub_module = get_module(SCAN,
+                            dtype_size,
+                            comm,
+                            han_module);
+
+    /* First errors are always printed by rank 0 */
+    rank = ompi_comm_rank(comm);
+    if( (0 == rank) && (han_module->dynamic_errors < mca_coll_han_component.max_dynamic_errors) ) {
+        verbosity = 30;
+    }
+
+    if(NULL == sub_module) {
+        /*
+         * No valid collective module from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_scan_intra_dynamic "
+                            "HAN did not find any valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s). "
+                            "Please check dynamic file/mca parameters\n",
+                            SCAN, mca_coll_base_colltype_to_str(SCAN),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/SCAN: No module found for the sub-communicator. "
+                             "Falling back to another component\n"));
+        scan = han_module->previous_scan;
+        sub_module = han_module->previous_scan_module;
+    } else if (NULL == sub_module->coll_scan) {
+        /*
+         * No valid collective from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_scan_intra_dynamic "
+                            "HAN found valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s) "
+                            "but this module cannot handle this collective. "
+                            "Please check dynamic file/mca parameters\n",
+                            SCAN, mca_coll_base_colltype_to_str(SCAN),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/SCAN: the module found for the sub-"
+                             "communicator cannot handle the SCAN operation. "
+                             "Falling back to another component\n"));
+        scan = han_module->previous_scan;
+        sub_module = han_module->previous_scan_module;
+    } else if (GLOBAL_COMMUNICATOR == topo_lvl && sub_module == module) {
+        /*
+         * No fallback mechanism activated for this configuration
+         * sub_module is valid
+         * sub_module->coll_scan is valid and point to this function
+         * Call han topological collective algorithm
+         */
+        int algorithm_id = get_algorithm(SCAN,
+                                         dtype_size,
+                                         comm,
+                                         han_module);
+        scan = (mca_coll_base_module_scan_fn_t)mca_coll_han_algorithm_id_to_fn(SCAN, algorithm_id);
+        if (NULL == scan) { /* default behaviour */
+            scan = mca_coll_han_scan_intra;
+        }
+    } else {
+        /*
+         * If we get here:
+         * sub_module is valid
+         * sub_module->coll_scan is valid
+         * They points to the collective to use, according to the dynamic rules
+         * Selector's job is done, call the collective
+         */
+        scan = sub_module->coll_scan;
+    }
+    return scan(SCAN_BASE_ARG_NAMES, sub_module);
+}
+
+
+/*
+ * Exscan selector:
+ * On a sub-communicator, checks the stored rules to find the module to use
+ * On the global communicator, calls the han collective implementation, or
+ * calls the correct module if fallback mechanism is activated
+ */
+int
+mca_coll_han_exscan_intra_dynamic(EXSCAN_BASE_ARGS,
+                                  mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t*) module;
+    TOPO_LVL_T topo_lvl = han_module->topologic_level;
+    mca_coll_base_module_exscan_fn_t exscan;
+    mca_coll_base_module_t *sub_module;
+    size_t dtype_size;
+    int rank, verbosity = 0;
+
+    if (!han_module->enabled) {
+        return han_module->previous_exscan(EXSCAN_BASE_ARG_NAMES,
+                                           han_module->previous_exscan_module);
+    }
+
+    /* Compute configuration information for dynamic rules */
+    ompi_datatype_type_size(datatype, &dtype_size);
+    dtype_size = dtype_size * count;
+
+    sub_module = get_module(EXSCAN,
+                            dtype_size,
+                            comm,
+                            han_module);
+
+    /* First errors are always printed by rank 0 */
+    rank = ompi_comm_rank(comm);
+    if( (0 == rank) && (han_module->dynamic_errors < mca_coll_han_component.max_dynamic_errors) ) {
+        verbosity = 30;
+    }
+
+    if(NULL == sub_module) {
+        /*
+         * No valid collective module from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_exscan_intra_dynamic "
+                            "HAN did not find any valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s). "
+                            "Please check dynamic file/mca parameters\n",
+                            EXSCAN, mca_coll_base_colltype_to_str(EXSCAN),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/EXSCAN: No module found for the sub-communicator. "
+                             "Falling back to another component\n"));
+        exscan = han_module->previous_exscan;
+        sub_module = han_module->previous_exscan_module;
+    } else if (NULL == sub_module->coll_exscan) {
+        /*
+         * No valid collective from dynamic rules
+         * nor from mca parameter
+         */
+        han_module->dynamic_errors++;
+        opal_output_verbose(verbosity, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_exscan_intra_dynamic "
+                            "HAN found valid module for collective %d (%s) "
+                            "with topological level %d (%s) on communicator (%s/%s) "
+                            "but this module cannot handle this collective. "
+                            "Please check dynamic file/mca parameters\n",
+                            EXSCAN, mca_coll_base_colltype_to_str(EXSCAN),
+                            topo_lvl, mca_coll_han_topo_lvl_to_str(topo_lvl),
+                            ompi_comm_print_cid(comm), comm->c_name);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/EXSCAN: the module found for the sub-"
+                             "communicator cannot handle the EXSCAN operation. "
+                             "Falling back to another component\n"));
+        exscan = han_module->previous_exscan;
+        sub_module = han_module->previous_exscan_module;
+    } else if (GLOBAL_COMMUNICATOR == topo_lvl && sub_module == module) {
+        /*
+         * No fallback mechanism activated for this configuration
+         * sub_module is valid
+         * sub_module->coll_exscan is valid and point to this function
+         * Call han topological collective algorithm
+         */
+        int algorithm_id = get_algorithm(EXSCAN,
+                                         dtype_size,
+                                         comm,
+                                         han_module);
+        exscan = (mca_coll_base_module_exscan_fn_t)mca_coll_han_algorithm_id_to_fn(EXSCAN, algorithm_id);
+        if (NULL == exscan) { /* default behaviour */
+            exscan = mca_coll_han_exscan_intra;
+        }
+    } else {
+        /*
+         * If we get here:
+         * sub_module is valid
+         * sub_module->coll_exscan is valid
+         * They points to the collective to use, according to the dynamic rules
+         * Selector's job is done, call the collective
+         */
+        exscan = sub_module->coll_exscan;
+    }
+    return exscan(EXSCAN_BASE_ARG_NAMES, sub_module);
+}
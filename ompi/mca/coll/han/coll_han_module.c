@@ -60,6 +60,17 @@ static void han_module_clear(mca_coll_han_module_t *han_module)
     CLEAN_PREV_COLL(han_module, gatherv);
     CLEAN_PREV_COLL(han_module, scatter);
     CLEAN_PREV_COLL(han_module, scatterv);
+    CLEAN_PREV_COLL(han_module, allreduce_init);
+    CLEAN_PREV_COLL(han_module, bcast_init);
+    CLEAN_PREV_COLL(han_module, reduce_scatter);
+    CLEAN_PREV_COLL(han_module, reduce_scatter_block);
+    CLEAN_PREV_COLL(han_module, scan);
+    CLEAN_PREV_COLL(han_module, exscan);
+    CLEAN_PREV_COLL(han_module, neighbor_allgather);
+    CLEAN_PREV_COLL(han_module, neighbor_allgatherv);
+    CLEAN_PREV_COLL(han_module, neighbor_alltoall);
+    CLEAN_PREV_COLL(han_module, neighbor_alltoallv);
+    CLEAN_PREV_COLL(han_module, neighbor_alltoallw);
 
     han_module->reproducible_reduce = NULL;
     han_module->reproducible_reduce_module = NULL;
@@ -80,6 +91,8 @@ static void mca_coll_han_module_construct(mca_coll_han_module_t * module)
     module->cached_up_comms = NULL;
     module->cached_vranks = NULL;
     module->cached_topo = NULL;
+    module->neighbor_plan = NULL;
+    module->neighbor_plan_failed = false;
     module->is_mapbycore = false;
     module->storage_initialized = false;
     for( i = 0; i < NB_TOPO_LVL; i++ ) {
@@ -136,6 +149,10 @@ mca_coll_han_module_destruct(mca_coll_han_module_t * module)
         free(module->cached_topo);
         module->cached_topo = NULL;
     }
+    if (module->neighbor_plan != NULL) {
+        mca_coll_han_neighbor_plan_free(module->neighbor_plan);
+        module->neighbor_plan = NULL;
+    }
     for(i=0 ; i<NB_TOPO_LVL ; i++) {
         if(NULL != module->sub_comm[i]) {
             ompi_comm_free(&(module->sub_comm[i]));
@@ -238,9 +255,10 @@ mca_coll_han_comm_query(struct ompi_communicator_t * comm, int *priority)
     han_module->super.coll_alltoall   = mca_coll_han_alltoall_intra_dynamic;
     han_module->super.coll_alltoallv  = mca_coll_han_alltoallv_intra_dynamic;
     han_module->super.coll_alltoallw  = NULL;
-    han_module->super.coll_exscan     = NULL;
-    han_module->super.coll_reduce_scatter = NULL;
-    han_module->super.coll_scan       = NULL;
+    han_module->super.coll_exscan     = mca_coll_han_exscan_intra_dynamic;
+    han_module->super.coll_reduce_scatter = mca_coll_han_reduce_scatter_intra_dynamic;
+    han_module->super.coll_reduce_scatter_block = mca_coll_han_reduce_scatter_block_intra_dynamic;
+    han_module->super.coll_scan       = mca_coll_han_scan_intra_dynamic;
     han_module->super.coll_scatterv   = mca_coll_han_scatterv_intra_dynamic;
     han_module->super.coll_barrier    = mca_coll_han_barrier_intra_dynamic;
     han_module->super.coll_scatter    = mca_coll_han_scatter_intra_dynamic;
@@ -253,6 +271,16 @@ mca_coll_han_comm_query(struct ompi_communicator_t * comm, int *priority)
     if (GLOBAL_COMMUNICATOR == han_module->topologic_level) {
         /* We are on the global communicator, return topological algorithms */
         han_module->super.coll_allgatherv = NULL;
+        /* persistent collectives build their plan on the sub-communicators */
+        han_module->super.coll_allreduce_init = mca_coll_han_allreduce_init_intra;
+        han_module->super.coll_bcast_init     = mca_coll_han_bcast_init_intra;
+        /* neighborhood collectives only act on distributed graphs, and
+         * defer to the previous component otherwise */
+        han_module->super.coll_neighbor_allgather  = mca_coll_han_neighbor_allgather_intra;
+        han_module->super.coll_neighbor_allgatherv = mca_coll_han_neighbor_allgatherv_intra;
+        han_module->super.coll_neighbor_alltoall   = mca_coll_han_neighbor_alltoall_intra;
+        han_module->super.coll_neighbor_alltoallv  = mca_coll_han_neighbor_alltoallv_intra;
+        han_module->super.coll_neighbor_alltoallw  = mca_coll_han_neighbor_alltoallw_intra;
     } else {
         /* We are on a topologic sub-communicator, return only the selector */
         han_module->super.coll_allgatherv = mca_coll_han_allgatherv_intra_dynamic;
@@ -309,6 +337,17 @@ mca_coll_han_module_enable(mca_coll_base_module_t * module,
     HAN_INSTALL_COLL_API(comm, han_module, reduce);
     HAN_INSTALL_COLL_API(comm, han_module, scatter);
     HAN_INSTALL_COLL_API(comm, han_module, scatterv);
+    HAN_INSTALL_COLL_API(comm, han_module, allreduce_init);
+    HAN_INSTALL_COLL_API(comm, han_module, bcast_init);
+    HAN_INSTALL_COLL_API(comm, han_module, reduce_scatter);
+    HAN_INSTALL_COLL_API(comm, han_module, reduce_scatter_block);
+    HAN_INSTALL_COLL_API(comm, han_module, scan);
+    HAN_INSTALL_COLL_API(comm, han_module, exscan);
+    HAN_INSTALL_COLL_API(comm, han_module, neighbor_allgather);
+    HAN_INSTALL_COLL_API(comm, han_module, neighbor_allgatherv);
+    HAN_INSTALL_COLL_API(comm, han_module, neighbor_alltoall);
+    HAN_INSTALL_COLL_API(comm, han_module, neighbor_alltoallv);
+    HAN_INSTALL_COLL_API(comm, han_module, neighbor_alltoallw);
 
     /* set reproducible algos */
     mca_coll_han_reduce_reproducible_decision(comm, module);
@@ -338,6 +377,17 @@ mca_coll_han_module_disable(mca_coll_base_module_t * module,
     HAN_UNINSTALL_COLL_API(comm, han_module, reduce);
     HAN_UNINSTALL_COLL_API(comm, han_module, scatter);
     HAN_UNINSTALL_COLL_API(comm, han_module, scatterv);
+    HAN_UNINSTALL_COLL_API(comm, han_module, allreduce_init);
+    HAN_UNINSTALL_COLL_API(comm, han_module, bcast_init);
+    HAN_UNINSTALL_COLL_API(comm, han_module, reduce_scatter);
+    HAN_UNINSTALL_COLL_API(comm, han_module, reduce_scatter_block);
+    HAN_UNINSTALL_COLL_API(comm, han_module, scan);
+    HAN_UNINSTALL_COLL_API(comm, han_module, exscan);
+    HAN_UNINSTALL_COLL_API(comm, han_module, neighbor_allgather);
+    HAN_UNINSTALL_COLL_API(comm, han_module, neighbor_allgatherv);
+    HAN_UNINSTALL_COLL_API(comm, han_module, neighbor_alltoall);
+    HAN_UNINSTALL_COLL_API(comm, han_module, neighbor_alltoallv);
+    HAN_UNINSTALL_COLL_API(comm, han_module, neighbor_alltoallw);
 
     han_module_clear(han_module);
 
@@ -0,0 +1,1252 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Topology-aware neighborhood collectives on distributed graph
+ * communicators.
+ *
+ * The graph is only attached to the communicator after the collective
+ * components have been selected, so the plan is built on the first
+ * neighborhood call and cached in the module. It records:
+ *  - the order in which the out-edges are served: off-node neighbors
+ *    first, as they have the highest latency, then on-node neighbors
+ *    (which the pml delivers through shared memory), each group rotated
+ *    by rank so that the ranks do not all target the same peer at once;
+ *  - for neighbor_alltoall and neighbor_allgather, how small blocks
+ *    travelling between two nodes are aggregated: every rank hands its
+ *    off-node blocks to its node leader, the leaders exchange one message
+ *    per pair of nodes, and forward the received blocks to their
+ *    destination on the node.
+ *
+ * Blocks larger than the neighbor_aggregate_max MCA parameter, and all
+ * blocks of the vector variants, are sent directly in plan order. The
+ * parameter sizes the aggregation buffers of the plan and must agree on
+ * all the processes, hence it is read-only.
+ */
+
+#include "coll_han.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/mca/topo/base/base.h"
+
+#define HAN_NEIGHBOR_TAG_DIRECT  MCA_COLL_BASE_TAG_NEIGHBOR_BASE
+#define HAN_NEIGHBOR_TAG_PACK    (MCA_COLL_BASE_TAG_NEIGHBOR_BASE - 1)
+#define HAN_NEIGHBOR_TAG_NODE    (MCA_COLL_BASE_TAG_NEIGHBOR_BASE - 2)
+#define HAN_NEIGHBOR_TAG_FWD     (MCA_COLL_BASE_TAG_NEIGHBOR_BASE - 3)
+#define HAN_NEIGHBOR_TAG_PLAN    (MCA_COLL_BASE_TAG_NEIGHBOR_BASE - 4)
+
+/* Header of a node message or of a pack: the size of the blocks of a source */
+#define HAN_NEIGHBOR_HDR sizeof(uint64_t)
+
+/*
+ * Message between two node leaders. It is made of one run of blocks per
+ * source rank, preceded by the block size of each run. The blocks of
+ * a source that does not aggregate are left out.
+ */
+typedef struct mca_coll_han_neighbor_msg_s {
+    int node;          /* peer node, i.e. rank in up_comm */
+    int nsegs;         /* number of runs */
+    int nblocks;
+    int *seg_cnt;      /* number of blocks in each run */
+    int *seg_mate;     /* outgoing: low rank of the source of each run */
+    int *seg_first;    /* outgoing: index of the run in the source's pack */
+    int *blk_dest;     /* incoming: low rank of the destination of each block */
+    size_t len;        /* upper bound of the message size */
+    char *buf;
+} mca_coll_han_neighbor_msg_t;
+
+struct mca_coll_han_neighbor_plan_s {
+    int indegree;
+    int outdegree;
+    int *send_order;   /* out-edge indices, in the order they are served */
+    int nremote_out;   /* the first nremote_out entries of send_order are off-node */
+    char *in_remote;   /* for each in-edge, whether the source is off-node */
+
+    int nreqs;
+    ompi_request_t **reqs;
+
+    /* Aggregation, on all ranks */
+    bool aggregate;
+    size_t max_blk;
+    int npack;         /* off-node out-edges, in the order they are packed */
+    int *pack_edges;
+    char *pack_buf;
+    int nfwd;          /* in-edges whose block is forwarded by the leader */
+    int *fwd_slots;
+    char *fwd_buf;
+
+    /* Aggregation, on the node leader only */
+    bool is_leader;
+    int low_size;
+    int *mate_npack;
+    char **mate_pack;
+    int *mate_nfwd;
+    char **mate_fwd;
+    size_t *fwd_fill;
+    int nout;
+    int first_out;     /* the messages are sent starting from the next node */
+    mca_coll_han_neighbor_msg_t *out;
+    int nin;
+    mca_coll_han_neighbor_msg_t *in;
+};
+
+typedef struct {
+    int key1, key2, key3, edge;
+} han_neighbor_sort_t;
+
+static int han_neighbor_sort_cmp(const void *a, const void *b)
+{
+    const han_neighbor_sort_t *x = (const han_neighbor_sort_t *) a;
+    const han_neighbor_sort_t *y = (const han_neighbor_sort_t *) b;
+
+    if (x->key1 != y->key1) {
+        return (x->key1 < y->key1) ? -1 : 1;
+    }
+    if (x->key2 != y->key2) {
+        return (x->key2 < y->key2) ? -1 : 1;
+    }
+    if (x->key3 != y->key3) {
+        return (x->key3 < y->key3) ? -1 : 1;
+    }
+    /* Keep the edge order, duplicate edges are matched in order */
+    return (x->edge < y->edge) ? -1 : (x->edge > y->edge);
+}
+
+static void han_neighbor_msgs_free(mca_coll_han_neighbor_msg_t *msgs, int n)
+{
+    if (NULL == msgs) {
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        free(msgs[i].seg_cnt);
+        free(msgs[i].seg_mate);
+        free(msgs[i].seg_first);
+        free(msgs[i].blk_dest);
+        free(msgs[i].buf);
+    }
+    free(msgs);
+}
+
+void mca_coll_han_neighbor_plan_free(mca_coll_han_neighbor_plan_t *plan)
+{
+    if (NULL == plan) {
+        return;
+    }
+    free(plan->send_order);
+    free(plan->in_remote);
+    free(plan->reqs);
+    free(plan->pack_edges);
+    free(plan->pack_buf);
+    free(plan->fwd_slots);
+    free(plan->fwd_buf);
+    if (NULL != plan->mate_pack) {
+        /* mate_pack[0] is pack_buf */
+        for (int r = 1; r < plan->low_size; r++) {
+            free(plan->mate_pack[r]);
+        }
+        free(plan->mate_pack);
+    }
+    if (NULL != plan->mate_fwd) {
+        /* mate_fwd[0] is fwd_buf */
+        for (int r = 1; r < plan->low_size; r++) {
+            free(plan->mate_fwd[r]);
+        }
+        free(plan->mate_fwd);
+    }
+    free(plan->mate_npack);
+    free(plan->mate_nfwd);
+    free(plan->fwd_fill);
+    han_neighbor_msgs_free(plan->out, plan->nout);
+    han_neighbor_msgs_free(plan->in, plan->nin);
+    free(plan);
+}
+
+/*
+ * Agree on the outcome of a step of the plan build. Returns OMPI_SUCCESS
+ * only if the step succeeded on every rank of comm, so that the ranks
+ * stop before the same collective when one of them fails.
+ */
+static int han_neighbor_plan_agree(ompi_communicator_t *comm, int err)
+{
+    int ok = (OMPI_SUCCESS == err), rc;
+
+    rc = comm->c_coll->coll_allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN, comm,
+                                      comm->c_coll->coll_allreduce_module);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    if (!ok) {
+        return (OMPI_SUCCESS != err) ? err : OMPI_ERROR;
+    }
+    return OMPI_SUCCESS;
+}
+
+/* State of the leader carried between the steps of the aggregation plan */
+typedef struct {
+    int *cnt_node;     /* blocks the node sends to each node */
+    int *recv_cnt;     /* blocks each node sends to the node */
+    int **hdr_out;     /* (source, destination) of the blocks of each outgoing message */
+    int **hdr_in;
+    ompi_request_t **reqs;
+} han_neighbor_leader_tmp_t;
+
+static void han_neighbor_leader_tmp_free(han_neighbor_leader_tmp_t *tmp,
+                                         const mca_coll_han_neighbor_plan_t *plan)
+{
+    if (NULL != tmp->hdr_out) {
+        for (int m = 0; m < plan->nout; m++) {
+            free(tmp->hdr_out[m]);
+        }
+        free(tmp->hdr_out);
+    }
+    if (NULL != tmp->hdr_in) {
+        for (int m = 0; m < plan->nin; m++) {
+            free(tmp->hdr_in[m]);
+        }
+        free(tmp->hdr_in);
+    }
+    free(tmp->reqs);
+    free(tmp->recv_cnt);
+    free(tmp->cnt_node);
+}
+
+/*
+ * First step of the leader part of the plan, local: group the off-node
+ * blocks of the node by destination node into the outgoing messages.
+ */
+static int
+han_neighbor_plan_leader_out(mca_coll_han_neighbor_plan_t *plan, int nnodes,
+                             const int *low_to_comm, const int *all_pairs,
+                             const int *pair_displs, ompi_communicator_t *up_comm,
+                             han_neighbor_leader_tmp_t *tmp)
+{
+    int low_size = plan->low_size;
+    int *cursor = NULL;
+    int err = OMPI_ERR_OUT_OF_RESOURCE, m, n, r, b;
+
+    tmp->cnt_node = (int *) calloc(nnodes, sizeof(int));
+    tmp->recv_cnt = (int *) calloc(nnodes, sizeof(int));
+    cursor = (int *) calloc(low_size, sizeof(int));
+    if (NULL == tmp->cnt_node || NULL == tmp->recv_cnt || NULL == cursor) {
+        goto cleanup;
+    }
+
+    for (r = 0; r < low_size; r++) {
+        for (b = 0; b < plan->mate_npack[r]; b++) {
+            tmp->cnt_node[all_pairs[pair_displs[r] + 2 * b]]++;
+        }
+    }
+    for (n = 0; n < nnodes; n++) {
+        if (tmp->cnt_node[n] > 0) {
+            plan->nout++;
+        }
+    }
+
+    /* Outgoing messages, by increasing node; the pack of every rank is
+     * sorted by destination node, so each run is contiguous */
+    plan->out = (mca_coll_han_neighbor_msg_t *) calloc(plan->nout + 1, sizeof(*plan->out));
+    tmp->hdr_out = (int **) calloc(plan->nout + 1, sizeof(int *));
+    if (NULL == plan->out || NULL == tmp->hdr_out) {
+        goto cleanup;
+    }
+    m = 0;
+    plan->first_out = 0;
+    for (n = 0; n < nnodes; n++) {
+        mca_coll_han_neighbor_msg_t *msg;
+        int *hdr;
+
+        if (0 == tmp->cnt_node[n]) {
+            continue;
+        }
+        if (n <= ompi_comm_rank(up_comm)) {
+            plan->first_out = m + 1;
+        }
+        msg = &plan->out[m];
+        msg->node = n;
+        msg->nblocks = tmp->cnt_node[n];
+        msg->seg_cnt = (int *) malloc(low_size * sizeof(int));
+        msg->seg_mate = (int *) malloc(low_size * sizeof(int));
+        msg->seg_first = (int *) malloc(low_size * sizeof(int));
+        hdr = tmp->hdr_out[m] = (int *) malloc(2 * msg->nblocks * sizeof(int));
+        if (NULL == msg->seg_cnt || NULL == msg->seg_mate || NULL == msg->seg_first
+            || NULL == hdr) {
+            goto cleanup;
+        }
+        for (r = 0; r < low_size; r++) {
+            const int *pairs = all_pairs + pair_displs[r];
+            int first = cursor[r];
+
+            while (cursor[r] < plan->mate_npack[r] && pairs[2 * cursor[r]] == n) {
+                /* (source, destination) of each block */
+                *hdr++ = low_to_comm[r];
+                *hdr++ = pairs[2 * cursor[r] + 1];
+                cursor[r]++;
+            }
+            if (cursor[r] > first) {
+                msg->seg_mate[msg->nsegs] = r;
+                msg->seg_first[msg->nsegs] = first;
+                msg->seg_cnt[msg->nsegs] = cursor[r] - first;
+                msg->nsegs++;
+            }
+        }
+        msg->len = HAN_NEIGHBOR_HDR * msg->nsegs + plan->max_blk * msg->nblocks;
+        msg->buf = (char *) malloc(msg->len);
+        if (NULL == msg->buf) {
+            goto cleanup;
+        }
+        m++;
+    }
+    if (plan->nout > 0) {
+        plan->first_out %= plan->nout;
+    }
+    err = OMPI_SUCCESS;
+
+cleanup:
+    free(cursor);
+    return err;
+}
+
+/*
+ * Second step, collective over up_comm: learn how many blocks each node
+ * sends to this one and allocate the incoming messages.
+ */
+static int
+han_neighbor_plan_leader_in(mca_coll_han_neighbor_plan_t *plan, int nnodes,
+                            ompi_communicator_t *up_comm, han_neighbor_leader_tmp_t *tmp)
+{
+    int err, m, n;
+
+    err = up_comm->c_coll->coll_alltoall(tmp->cnt_node, 1, MPI_INT, tmp->recv_cnt, 1, MPI_INT,
+                                         up_comm, up_comm->c_coll->coll_alltoall_module);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+    for (n = 0; n < nnodes; n++) {
+        if (tmp->recv_cnt[n] > 0) {
+            plan->nin++;
+        }
+    }
+    plan->in = (mca_coll_han_neighbor_msg_t *) calloc(plan->nin + 1, sizeof(*plan->in));
+    tmp->hdr_in = (int **) calloc(plan->nin + 1, sizeof(int *));
+    tmp->reqs = (ompi_request_t **) malloc((plan->nin + plan->nout + 1)
+                                           * sizeof(ompi_request_t *));
+    if (NULL == plan->in || NULL == tmp->hdr_in || NULL == tmp->reqs) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    m = 0;
+    for (n = 0; n < nnodes; n++) {
+        if (0 == tmp->recv_cnt[n]) {
+            continue;
+        }
+        plan->in[m].node = n;
+        plan->in[m].nblocks = tmp->recv_cnt[n];
+        tmp->hdr_in[m] = (int *) malloc(2 * tmp->recv_cnt[n] * sizeof(int));
+        if (NULL == tmp->hdr_in[m]) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        m++;
+    }
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Last step, over up_comm: exchange the description of the node
+ * messages with the other leaders, and tell each rank of the node which
+ * sources its forwarded blocks come from. fwd_srcs receives these
+ * sources for all ranks of the node, at offsets fwd_displs.
+ */
+static int
+han_neighbor_plan_leader_fwd(mca_coll_han_neighbor_plan_t *plan, const int *low_to_comm,
+                             ompi_communicator_t *up_comm, han_neighbor_leader_tmp_t *tmp,
+                             int **fwd_srcs, int *fwd_displs)
+{
+    int low_size = plan->low_size;
+    int *cursor = NULL;
+    int err, nreq = 0, m, r, b;
+
+    /* Exchange the (source, destination) pairs of the node messages */
+    for (m = 0; m < plan->nin; m++) {
+        err = MCA_PML_CALL(irecv(tmp->hdr_in[m], 2 * plan->in[m].nblocks, MPI_INT,
+                                 plan->in[m].node, HAN_NEIGHBOR_TAG_PLAN, up_comm,
+                                 &tmp->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+    for (m = 0; m < plan->nout; m++) {
+        err = MCA_PML_CALL(isend(tmp->hdr_out[m], 2 * plan->out[m].nblocks, MPI_INT,
+                                 plan->out[m].node, HAN_NEIGHBOR_TAG_PLAN,
+                                 MCA_PML_BASE_SEND_STANDARD, up_comm, &tmp->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+    err = ompi_request_wait_all(nreq, tmp->reqs, MPI_STATUSES_IGNORE);
+    nreq = 0;
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    err = OMPI_ERR_OUT_OF_RESOURCE;
+
+    /* Incoming messages: runs of blocks from the same source, and the
+     * rank of the node each block is forwarded to */
+    for (m = 0; m < plan->nin; m++) {
+        mca_coll_han_neighbor_msg_t *msg = &plan->in[m];
+        const int *hdr = tmp->hdr_in[m];
+
+        msg->seg_cnt = (int *) malloc(msg->nblocks * sizeof(int));
+        msg->blk_dest = (int *) malloc(msg->nblocks * sizeof(int));
+        if (NULL == msg->seg_cnt || NULL == msg->blk_dest) {
+            goto cleanup;
+        }
+        for (b = 0; b < msg->nblocks; b++) {
+            if (0 == b || hdr[2 * b] != hdr[2 * (b - 1)]) {
+                msg->seg_cnt[msg->nsegs++] = 0;
+            }
+            msg->seg_cnt[msg->nsegs - 1]++;
+            for (r = 0; r < low_size && low_to_comm[r] != hdr[2 * b + 1]; r++) {
+            }
+            if (r == low_size) {
+                err = OMPI_ERROR;
+                goto cleanup;
+            }
+            msg->blk_dest[b] = r;
+            plan->mate_nfwd[r]++;
+        }
+        msg->len = HAN_NEIGHBOR_HDR * msg->nsegs + plan->max_blk * msg->nblocks;
+        msg->buf = (char *) malloc(msg->len);
+        if (NULL == msg->buf) {
+            goto cleanup;
+        }
+    }
+
+    /* Sources of the forwarded blocks, in forwarding order */
+    fwd_displs[0] = 0;
+    for (r = 1; r <= low_size; r++) {
+        fwd_displs[r] = fwd_displs[r - 1] + plan->mate_nfwd[r - 1];
+    }
+    *fwd_srcs = (int *) malloc((fwd_displs[low_size] + 1) * sizeof(int));
+    cursor = (int *) calloc(low_size, sizeof(int));
+    if (NULL == *fwd_srcs || NULL == cursor) {
+        goto cleanup;
+    }
+    for (m = 0; m < plan->nin; m++) {
+        const int *hdr = tmp->hdr_in[m];
+        for (b = 0; b < plan->in[m].nblocks; b++) {
+            r = plan->in[m].blk_dest[b];
+            (*fwd_srcs)[fwd_displs[r] + cursor[r]++] = hdr[2 * b];
+        }
+    }
+
+    /* Receive buffers for the packs, send buffers for the forwards */
+    plan->mate_pack = (char **) calloc(low_size, sizeof(char *));
+    plan->mate_fwd = (char **) calloc(low_size, sizeof(char *));
+    plan->fwd_fill = (size_t *) calloc(low_size, sizeof(size_t));
+    if (NULL == plan->mate_pack || NULL == plan->mate_fwd || NULL == plan->fwd_fill) {
+        goto cleanup;
+    }
+    for (r = 1; r < low_size; r++) {
+        if (plan->mate_npack[r] > 0) {
+            plan->mate_pack[r] = (char *) malloc(HAN_NEIGHBOR_HDR
+                                                 + plan->max_blk * plan->mate_npack[r]);
+            if (NULL == plan->mate_pack[r]) {
+                goto cleanup;
+            }
+        }
+        if (plan->mate_nfwd[r] > 0) {
+            plan->mate_fwd[r] = (char *) malloc(plan->max_blk * plan->mate_nfwd[r]);
+            if (NULL == plan->mate_fwd[r]) {
+                goto cleanup;
+            }
+        }
+    }
+    err = OMPI_SUCCESS;
+
+cleanup:
+    if (nreq > 0) {
+        ompi_coll_base_free_reqs(tmp->reqs, nreq);
+    }
+    free(cursor);
+    return err;
+}
+
+/*
+ * Aggregation part of the plan, on all ranks. Collective over the
+ * communicator: every rank goes through the same agreements, so a
+ * failure on any rank (including a leader) stops all of them before the
+ * next exchange.
+ */
+static int
+han_neighbor_plan_aggregate(mca_coll_han_neighbor_plan_t *plan, int nnodes, const int *node_of,
+                            const mca_topo_base_comm_dist_graph_2_2_0_t *dg,
+                            ompi_communicator_t *comm, ompi_communicator_t *low_comm,
+                            ompi_communicator_t *up_comm)
+{
+    int rank = ompi_comm_rank(comm);
+    int low_size = ompi_comm_size(low_comm);
+    int *pairs = NULL, *low_to_comm = NULL, *pair_cnt = NULL, *pair_displs = NULL;
+    int *all_pairs = NULL, *fwd_srcs = NULL, *fwd_displs = NULL;
+    char *used = NULL;
+    han_neighbor_sort_t *keys = NULL;
+    han_neighbor_leader_tmp_t tmp = {0};
+    ompi_count_array_t cnt_desc;
+    ompi_disp_array_t displs_desc;
+    int err = OMPI_ERR_OUT_OF_RESOURCE, rc, i, j, k, r;
+
+    plan->low_size = low_size;
+    plan->is_leader = (0 == ompi_comm_rank(low_comm));
+
+    /* Off-node out-edges, sorted by destination node and rank */
+    keys = (han_neighbor_sort_t *) malloc((plan->nremote_out + 1) * sizeof(*keys));
+    plan->pack_edges = (int *) malloc((plan->nremote_out + 1) * sizeof(int));
+    pairs = (int *) malloc((2 * plan->nremote_out + 1) * sizeof(int));
+    plan->pack_buf = (char *) malloc(HAN_NEIGHBOR_HDR + plan->max_blk * plan->nremote_out);
+    if (plan->is_leader) {
+        low_to_comm = (int *) malloc(low_size * sizeof(int));
+        plan->mate_npack = (int *) malloc(low_size * sizeof(int));
+        plan->mate_nfwd = (int *) calloc(low_size, sizeof(int));
+        pair_cnt = (int *) malloc(low_size * sizeof(int));
+        pair_displs = (int *) malloc((low_size + 1) * sizeof(int));
+        fwd_displs = (int *) malloc((low_size + 1) * sizeof(int));
+    }
+    if (NULL != keys && NULL != plan->pack_edges && NULL != pairs && NULL != plan->pack_buf
+        && (!plan->is_leader
+            || (NULL != low_to_comm && NULL != plan->mate_npack && NULL != plan->mate_nfwd
+                && NULL != pair_cnt && NULL != pair_displs && NULL != fwd_displs))) {
+        err = OMPI_SUCCESS;
+    }
+    err = han_neighbor_plan_agree(comm, err);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    for (j = 0; j < dg->outdegree; j++) {
+        if (node_of[dg->out[j]] == node_of[rank]) {
+            continue;
+        }
+        keys[plan->npack].key1 = node_of[dg->out[j]];
+        keys[plan->npack].key2 = dg->out[j];
+        keys[plan->npack].key3 = 0;
+        keys[plan->npack].edge = j;
+        plan->npack++;
+    }
+    qsort(keys, plan->npack, sizeof(*keys), han_neighbor_sort_cmp);
+    for (k = 0; k < plan->npack; k++) {
+        plan->pack_edges[k] = keys[k].edge;
+        pairs[2 * k] = keys[k].key1;
+        pairs[2 * k + 1] = keys[k].key2;
+    }
+
+    /* Let the leader know the ranks of the node and their off-node blocks */
+    err = low_comm->c_coll->coll_gather(&rank, 1, MPI_INT, low_to_comm, 1, MPI_INT, 0, low_comm,
+                                        low_comm->c_coll->coll_gather_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    err = low_comm->c_coll->coll_gather(&plan->npack, 1, MPI_INT, plan->mate_npack, 1, MPI_INT,
+                                        0, low_comm, low_comm->c_coll->coll_gather_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    if (plan->is_leader) {
+        pair_displs[0] = 0;
+        for (r = 0; r < low_size; r++) {
+            pair_cnt[r] = 2 * plan->mate_npack[r];
+            pair_displs[r + 1] = pair_displs[r] + pair_cnt[r];
+        }
+        all_pairs = (int *) malloc((pair_displs[low_size] + 1) * sizeof(int));
+        if (NULL == all_pairs) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    err = han_neighbor_plan_agree(comm, err);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    OMPI_COUNT_ARRAY_INIT(&cnt_desc, pair_cnt);
+    OMPI_DISP_ARRAY_INIT(&displs_desc, pair_displs);
+    err = low_comm->c_coll->coll_gatherv(pairs, 2 * plan->npack, MPI_INT, all_pairs, cnt_desc,
+                                         displs_desc, MPI_INT, 0, low_comm,
+                                         low_comm->c_coll->coll_gatherv_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    /* Leader part. The other ranks only join the agreements */
+    if (plan->is_leader) {
+        err = han_neighbor_plan_leader_out(plan, nnodes, low_to_comm, all_pairs, pair_displs,
+                                           up_comm, &tmp);
+    }
+    err = han_neighbor_plan_agree(comm, err);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    if (plan->is_leader) {
+        err = han_neighbor_plan_leader_in(plan, nnodes, up_comm, &tmp);
+    }
+    err = han_neighbor_plan_agree(comm, err);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    if (plan->is_leader) {
+        err = han_neighbor_plan_leader_fwd(plan, low_to_comm, up_comm, &tmp, &fwd_srcs,
+                                           fwd_displs);
+    }
+
+    /* Which sources the leader forwards blocks from. mate_nfwd is valid
+     * even if the leader failed, the agreement below catches it */
+    rc = low_comm->c_coll->coll_scatter(plan->mate_nfwd, 1, MPI_INT, &plan->nfwd, 1, MPI_INT, 0,
+                                        low_comm, low_comm->c_coll->coll_scatter_module);
+    if (OMPI_SUCCESS != rc) {
+        err = rc;
+    } else if (OMPI_SUCCESS == err) {
+        plan->fwd_slots = (int *) malloc((plan->nfwd + 1) * sizeof(int));
+        plan->fwd_buf = (char *) malloc(plan->max_blk * plan->nfwd + 1);
+        used = (char *) calloc(dg->indegree + 1, sizeof(char));
+        if (NULL == plan->fwd_slots || NULL == plan->fwd_buf || NULL == used) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    err = han_neighbor_plan_agree(comm, err);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    if (plan->is_leader) {
+        OMPI_COUNT_ARRAY_INIT(&cnt_desc, plan->mate_nfwd);
+        OMPI_DISP_ARRAY_INIT(&displs_desc, fwd_displs);
+    }
+    err = low_comm->c_coll->coll_scatterv(fwd_srcs, cnt_desc, displs_desc, MPI_INT,
+                                          plan->fwd_slots, plan->nfwd, MPI_INT, 0, low_comm,
+                                          low_comm->c_coll->coll_scatterv_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    /* The k-th block forwarded from a source fills its k-th off-node in-edge */
+    for (k = 0; k < plan->nfwd; k++) {
+        int src = plan->fwd_slots[k];
+        for (i = 0; i < dg->indegree; i++) {
+            if (!used[i] && plan->in_remote[i] && dg->in[i] == src) {
+                break;
+            }
+        }
+        if (i == dg->indegree) {
+            err = OMPI_ERROR;
+            goto cleanup;
+        }
+        used[i] = 1;
+        plan->fwd_slots[k] = i;
+    }
+    if (plan->is_leader) {
+        plan->mate_pack[0] = plan->pack_buf;
+        plan->mate_fwd[0] = plan->fwd_buf;
+    }
+    err = OMPI_SUCCESS;
+
+cleanup:
+    han_neighbor_leader_tmp_free(&tmp, plan);
+    free(used);
+    free(fwd_srcs);
+    free(fwd_displs);
+    free(all_pairs);
+    free(pair_displs);
+    free(pair_cnt);
+    free(low_to_comm);
+    free(pairs);
+    free(keys);
+    return err;
+}
+
+/*
+ * Build the plan of a distributed graph communicator. Collective over
+ * the communicator; the caller agrees on the result.
+ */
+static int
+han_neighbor_plan_create(struct ompi_communicator_t *comm, mca_coll_han_module_t *han_module,
+                         mca_coll_han_neighbor_plan_t **plan_out)
+{
+    const mca_topo_base_comm_dist_graph_2_2_0_t *dg = comm->c_topo->mtc.dist_graph;
+    ompi_communicator_t *low_comm = han_module->sub_comm[INTRA_NODE];
+    ompi_communicator_t *up_comm = han_module->sub_comm[INTER_NODE];
+    int rank = ompi_comm_rank(comm);
+    int size = ompi_comm_size(comm);
+    mca_coll_han_neighbor_plan_t *plan;
+    han_neighbor_sort_t *keys = NULL;
+    int *node_of = NULL;
+    int my_node, nnodes = 0, err = OMPI_SUCCESS, i, j;
+
+    plan = (mca_coll_han_neighbor_plan_t *) calloc(1, sizeof(*plan));
+    node_of = (int *) malloc(size * sizeof(int));
+    keys = (han_neighbor_sort_t *) malloc((dg->outdegree + 1) * sizeof(*keys));
+    if (NULL != plan) {
+        plan->in_remote = (char *) malloc(dg->indegree + 1);
+        plan->send_order = (int *) malloc((dg->outdegree + 1) * sizeof(int));
+    }
+    if (NULL == plan || NULL == node_of || NULL == keys || NULL == plan->in_remote
+        || NULL == plan->send_order) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    err = han_neighbor_plan_agree(comm, err);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    plan->indegree = dg->indegree;
+    plan->outdegree = dg->outdegree;
+
+    /* The node index is the rank of the node leader in up_comm */
+    my_node = ompi_comm_rank(up_comm);
+    err = low_comm->c_coll->coll_bcast(&my_node, 1, MPI_INT, 0, low_comm,
+                                       low_comm->c_coll->coll_bcast_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    err = comm->c_coll->coll_allgather(&my_node, 1, MPI_INT, node_of, 1, MPI_INT, comm,
+                                       comm->c_coll->coll_allgather_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    for (i = 0; i < size; i++) {
+        if (node_of[i] >= nnodes) {
+            nnodes = node_of[i] + 1;
+        }
+    }
+
+    for (i = 0; i < dg->indegree; i++) {
+        plan->in_remote[i] = (node_of[dg->in[i]] != my_node);
+    }
+
+    /* Off-node neighbors first, each group starting after this rank */
+    for (j = 0; j < dg->outdegree; j++) {
+        int remote = (node_of[dg->out[j]] != my_node);
+        keys[j].key1 = remote ? 0 : 1;
+        keys[j].key2 = (dg->out[j] - rank + size) % size;
+        keys[j].key3 = 0;
+        keys[j].edge = j;
+        plan->nremote_out += remote;
+    }
+    qsort(keys, dg->outdegree, sizeof(*keys), han_neighbor_sort_cmp);
+    for (j = 0; j < dg->outdegree; j++) {
+        plan->send_order[j] = keys[j].edge;
+    }
+
+    /* nnodes and max_blk are the same on all the ranks */
+    plan->max_blk = (size_t) mca_coll_han_component.han_neighbor_aggregate_max;
+    plan->aggregate = (nnodes > 1) && (plan->max_blk > 0);
+    if (plan->aggregate) {
+        err = han_neighbor_plan_aggregate(plan, nnodes, node_of, dg, comm, low_comm, up_comm);
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+
+    /* No collective from here on, a local failure is caught by the caller */
+    plan->nreqs = dg->indegree + dg->outdegree + 2;
+    if (plan->is_leader) {
+        plan->nreqs += 2 * plan->low_size + plan->nout + plan->nin;
+    }
+    plan->reqs = (ompi_request_t **) malloc(plan->nreqs * sizeof(ompi_request_t *));
+    if (NULL == plan->reqs) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+
+cleanup:
+    free(keys);
+    free(node_of);
+    if (OMPI_SUCCESS != err) {
+        mca_coll_han_neighbor_plan_free(plan);
+        plan = NULL;
+    }
+    *plan_out = plan;
+    return err;
+}
+
+/*
+ * Return the plan of the communicator, building it on the first call.
+ * Returns NULL if HAN cannot handle the communicator; a failed build is
+ * not attempted again. The ranks agree on the outcome of the build, so
+ * they either all use the plan or all fall back.
+ */
+static mca_coll_han_neighbor_plan_t *
+han_neighbor_get_plan(struct ompi_communicator_t *comm, mca_coll_han_module_t *han_module)
+{
+    mca_coll_han_neighbor_plan_t *plan;
+    int err;
+
+    if (!OMPI_COMM_IS_DIST_GRAPH(comm) || han_module->neighbor_plan_failed) {
+        return NULL;
+    }
+    if (NULL != han_module->neighbor_plan) {
+        return han_module->neighbor_plan;
+    }
+
+    if (OMPI_SUCCESS != mca_coll_han_comm_create_new(comm, han_module)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle neighborhood collectives with this communicator. "
+                             "Drop HAN support in this communicator and fall back on another component\n"));
+        HAN_LOAD_FALLBACK_COLLECTIVES(comm, han_module);
+        return NULL;
+    }
+    err = han_neighbor_plan_create(comm, han_module, &plan);
+    err = han_neighbor_plan_agree(comm, err);
+    if (OMPI_SUCCESS != err) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han failed to build the neighborhood plan, fall back on another component\n"));
+        mca_coll_han_neighbor_plan_free(plan);
+        han_module->neighbor_plan_failed = true;
+        return NULL;
+    }
+    han_module->neighbor_plan = plan;
+    return plan;
+}
+
+static inline int han_neighbor_pack(char *dst, const char *src, size_t count,
+                                    struct ompi_datatype_t *dtype, size_t blk)
+{
+    if (ompi_datatype_is_predefined(dtype)) {
+        memcpy(dst, src, blk);
+        return OMPI_SUCCESS;
+    }
+    return ompi_datatype_sndrcv((void *) src, count, dtype, dst, blk, MPI_PACKED);
+}
+
+static inline int han_neighbor_unpack(char *dst, const char *src, size_t count,
+                                      struct ompi_datatype_t *dtype, size_t blk)
+{
+    if (ompi_datatype_is_predefined(dtype)) {
+        memcpy(dst, src, blk);
+        return OMPI_SUCCESS;
+    }
+    return ompi_datatype_sndrcv((void *) src, blk, MPI_PACKED, dst, count, dtype);
+}
+
+/*
+ * Node leader: build and exchange the node messages from the packs of
+ * the node, then forward the received blocks to their destination.
+ */
+static int han_neighbor_leader(mca_coll_han_neighbor_plan_t *plan,
+                               ompi_communicator_t *low_comm, ompi_communicator_t *up_comm)
+{
+    ompi_request_t **reqs = plan->reqs + plan->indegree + plan->outdegree + 2;
+    int nreq = 0, npin, err, m, k, s, b, r;
+
+    for (m = 0; m < plan->nin; m++) {
+        err = MCA_PML_CALL(irecv(plan->in[m].buf, plan->in[m].len, MPI_BYTE, plan->in[m].node,
+                                 HAN_NEIGHBOR_TAG_NODE, up_comm, &reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    npin = nreq;
+    for (r = 1; r < plan->low_size; r++) {
+        if (0 == plan->mate_npack[r]) {
+            continue;
+        }
+        err = MCA_PML_CALL(irecv(plan->mate_pack[r],
+                                 HAN_NEIGHBOR_HDR + plan->max_blk * plan->mate_npack[r],
+                                 MPI_BYTE, r, HAN_NEIGHBOR_TAG_PACK, low_comm, &reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    err = ompi_request_wait_all(nreq - npin, reqs + npin, MPI_STATUSES_IGNORE);
+    nreq = npin;
+    if (OMPI_SUCCESS != err) {
+        goto err_hndl;
+    }
+
+    /* One message per destination node, starting from the next node */
+    for (k = 0; k < plan->nout; k++) {
+        mca_coll_han_neighbor_msg_t *msg = &plan->out[(plan->first_out + k) % plan->nout];
+        uint64_t *hdr = (uint64_t *) msg->buf;
+        char *data = msg->buf + HAN_NEIGHBOR_HDR * msg->nsegs;
+
+        for (s = 0; s < msg->nsegs; s++) {
+            const char *pack = plan->mate_pack[msg->seg_mate[s]];
+            uint64_t blk;
+
+            memcpy(&blk, pack, sizeof(blk));
+            hdr[s] = blk;
+            if (blk <= plan->max_blk) {
+                memcpy(data, pack + HAN_NEIGHBOR_HDR + msg->seg_first[s] * blk,
+                       msg->seg_cnt[s] * blk);
+                data += msg->seg_cnt[s] * blk;
+            }
+        }
+        err = MCA_PML_CALL(isend(msg->buf, data - msg->buf, MPI_BYTE, msg->node,
+                                 HAN_NEIGHBOR_TAG_NODE, MCA_PML_BASE_SEND_STANDARD, up_comm,
+                                 &reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+
+    /* Sort the received blocks by destination */
+    err = ompi_request_wait_all(npin, reqs, MPI_STATUSES_IGNORE);
+    if (OMPI_SUCCESS != err) {
+        goto err_hndl;
+    }
+    memset(plan->fwd_fill, 0, plan->low_size * sizeof(size_t));
+    for (m = 0; m < plan->nin; m++) {
+        mca_coll_han_neighbor_msg_t *msg = &plan->in[m];
+        const uint64_t *hdr = (const uint64_t *) msg->buf;
+        const char *data = msg->buf + HAN_NEIGHBOR_HDR * msg->nsegs;
+
+        b = 0;
+        for (s = 0; s < msg->nsegs; s++) {
+            uint64_t blk = hdr[s];
+            for (k = 0; k < msg->seg_cnt[s]; k++, b++) {
+                if (blk > plan->max_blk) {
+                    continue;
+                }
+                r = msg->blk_dest[b];
+                memcpy(plan->mate_fwd[r] + plan->fwd_fill[r], data, blk);
+                plan->fwd_fill[r] += blk;
+                data += blk;
+            }
+        }
+    }
+    for (r = 1; r < plan->low_size; r++) {
+        if (0 == plan->mate_nfwd[r]) {
+            continue;
+        }
+        err = MCA_PML_CALL(isend(plan->mate_fwd[r], plan->fwd_fill[r], MPI_BYTE, r,
+                                 HAN_NEIGHBOR_TAG_FWD, MCA_PML_BASE_SEND_STANDARD, low_comm,
+                                 &reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    err = ompi_request_wait_all(nreq - npin, reqs + npin, MPI_STATUSES_IGNORE);
+    if (OMPI_SUCCESS == err) {
+        return OMPI_SUCCESS;
+    }
+    nreq = 0;
+
+err_hndl:
+    ompi_coll_base_free_reqs(reqs, nreq);
+    return err;
+}
+
+/*
+ * Common part of neighbor_alltoall and neighbor_allgather: the block of
+ * out-edge j starts at sbuf + j * sstride.
+ */
+static int
+han_neighbor_exchange(const char *sbuf, ptrdiff_t sstride, size_t scount,
+                      struct ompi_datatype_t *sdtype, char *rbuf, size_t rcount,
+                      struct ompi_datatype_t *rdtype, struct ompi_communicator_t *comm,
+                      mca_coll_han_module_t *han_module, mca_coll_han_neighbor_plan_t *plan)
+{
+    const mca_topo_base_comm_dist_graph_2_2_0_t *dg = comm->c_topo->mtc.dist_graph;
+    ompi_communicator_t *low_comm = han_module->sub_comm[INTRA_NODE];
+    ompi_communicator_t *up_comm = han_module->sub_comm[INTER_NODE];
+    ompi_request_t **reqs = plan->reqs;
+    bool agg_send = false, agg_recv = false;
+    size_t sblk, rblk, dsize;
+    ptrdiff_t rext, lb;
+    int nreq = 0, err = OMPI_SUCCESS, i, j, k;
+
+    ompi_datatype_get_extent(rdtype, &lb, &rext);
+    rext *= rcount;
+    ompi_datatype_type_size(sdtype, &dsize);
+    sblk = dsize * scount;
+    ompi_datatype_type_size(rdtype, &dsize);
+    rblk = dsize * rcount;
+    if (plan->aggregate) {
+        /* The type signatures match along each edge, so both ends agree */
+        agg_send = (sblk <= plan->max_blk);
+        agg_recv = (rblk <= plan->max_blk);
+    }
+
+    for (i = 0; i < plan->indegree; i++) {
+        if (agg_recv && plan->in_remote[i]) {
+            continue;
+        }
+        err = MCA_PML_CALL(irecv(rbuf + i * rext, rcount, rdtype, dg->in[i],
+                                 HAN_NEIGHBOR_TAG_DIRECT, comm, &reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+
+    if (plan->aggregate) {
+        if (plan->nfwd > 0 && !plan->is_leader) {
+            err = MCA_PML_CALL(irecv(plan->fwd_buf, plan->max_blk * plan->nfwd, MPI_BYTE, 0,
+                                     HAN_NEIGHBOR_TAG_FWD, low_comm, &reqs[nreq++]));
+            if (OMPI_SUCCESS != err) {
+                goto err_hndl;
+            }
+        }
+        if (plan->npack > 0) {
+            uint64_t hdr = sblk;
+            size_t len = HAN_NEIGHBOR_HDR;
+
+            memcpy(plan->pack_buf, &hdr, sizeof(hdr));
+            if (agg_send) {
+                for (k = 0; k < plan->npack; k++) {
+                    err = han_neighbor_pack(plan->pack_buf + len,
+                                            sbuf + plan->pack_edges[k] * sstride, scount,
+                                            sdtype, sblk);
+                    if (OMPI_SUCCESS != err) {
+                        goto err_hndl;
+                    }
+                    len += sblk;
+                }
+            }
+            if (!plan->is_leader) {
+                err = MCA_PML_CALL(isend(plan->pack_buf, len, MPI_BYTE, 0, HAN_NEIGHBOR_TAG_PACK,
+                                         MCA_PML_BASE_SEND_STANDARD, low_comm, &reqs[nreq++]));
+                if (OMPI_SUCCESS != err) {
+                    goto err_hndl;
+                }
+            }
+        }
+    }
+
+    for (k = 0; k < plan->outdegree; k++) {
+        if (agg_send && k < plan->nremote_out) {
+            continue;
+        }
+        j = plan->send_order[k];
+        err = MCA_PML_CALL(isend(sbuf + j * sstride, scount, sdtype, dg->out[j],
+                                 HAN_NEIGHBOR_TAG_DIRECT, MCA_PML_BASE_SEND_STANDARD, comm,
+                                 &reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+
+    if (plan->aggregate && plan->is_leader) {
+        err = han_neighbor_leader(plan, low_comm, up_comm);
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+
+    err = ompi_request_wait_all(nreq, reqs, MPI_STATUSES_IGNORE);
+    if (OMPI_SUCCESS != err) {
+        goto err_hndl;
+    }
+
+    if (agg_recv) {
+        for (k = 0; k < plan->nfwd; k++) {
+            err = han_neighbor_unpack(rbuf + plan->fwd_slots[k] * rext,
+                                      plan->fwd_buf + k * rblk, rcount, rdtype, rblk);
+            if (OMPI_SUCCESS != err) {
+                return err;
+            }
+        }
+    }
+    return OMPI_SUCCESS;
+
+err_hndl:
+    ompi_coll_base_free_reqs(reqs, nreq);
+    return err;
+}
+
+int
+mca_coll_han_neighbor_alltoall_intra(const void *sbuf, size_t scount,
+                                     struct ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+                                     struct ompi_datatype_t *rdtype,
+                                     struct ompi_communicator_t *comm,
+                                     mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    mca_coll_han_neighbor_plan_t *plan = han_neighbor_get_plan(comm, han_module);
+    ptrdiff_t sext, lb;
+
+    if (NULL == plan) {
+        return han_module->previous_neighbor_alltoall(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                      comm,
+                                                      han_module->previous_neighbor_alltoall_module);
+    }
+
+    ompi_datatype_get_extent(sdtype, &lb, &sext);
+    return han_neighbor_exchange((const char *) sbuf, sext * scount, scount, sdtype,
+                                 (char *) rbuf, rcount, rdtype, comm, han_module, plan);
+}
+
+int
+mca_coll_han_neighbor_allgather_intra(const void *sbuf, size_t scount,
+                                      struct ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+                                      struct ompi_datatype_t *rdtype,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    mca_coll_han_neighbor_plan_t *plan = han_neighbor_get_plan(comm, han_module);
+
+    if (NULL == plan) {
+        return han_module->previous_neighbor_allgather(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                       comm,
+                                                       han_module->previous_neighbor_allgather_module);
+    }
+
+    /* The same block goes to every neighbor */
+    return han_neighbor_exchange((const char *) sbuf, 0, scount, sdtype, (char *) rbuf, rcount,
+                                 rdtype, comm, han_module, plan);
+}
+
+int
+mca_coll_han_neighbor_allgatherv_intra(const void *sbuf, size_t scount,
+                                       struct ompi_datatype_t *sdtype, void *rbuf,
+                                       ompi_count_array_t rcounts, ompi_disp_array_t displs,
+                                       struct ompi_datatype_t *rdtype,
+                                       struct ompi_communicator_t *comm,
+                                       mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    mca_coll_han_neighbor_plan_t *plan = han_neighbor_get_plan(comm, han_module);
+    const mca_topo_base_comm_dist_graph_2_2_0_t *dg;
+    ptrdiff_t rext, lb;
+    int nreq = 0, err, i, k;
+
+    if (NULL == plan) {
+        return han_module->previous_neighbor_allgatherv(sbuf, scount, sdtype, rbuf, rcounts,
+                                                        displs, rdtype, comm,
+                                                        han_module->previous_neighbor_allgatherv_module);
+    }
+
+    dg = comm->c_topo->mtc.dist_graph;
+    ompi_datatype_get_extent(rdtype, &lb, &rext);
+
+    for (i = 0; i < plan->indegree; i++) {
+        err = MCA_PML_CALL(irecv((char *) rbuf + ompi_disp_array_get(displs, i) * rext,
+                                 ompi_count_array_get(rcounts, i), rdtype, dg->in[i],
+                                 HAN_NEIGHBOR_TAG_DIRECT, comm, &plan->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    for (k = 0; k < plan->outdegree; k++) {
+        err = MCA_PML_CALL(isend(sbuf, scount, sdtype, dg->out[plan->send_order[k]],
+                                 HAN_NEIGHBOR_TAG_DIRECT, MCA_PML_BASE_SEND_STANDARD, comm,
+                                 &plan->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    err = ompi_request_wait_all(nreq, plan->reqs, MPI_STATUSES_IGNORE);
+    if (OMPI_SUCCESS == err) {
+        return OMPI_SUCCESS;
+    }
+    nreq = 0;
+
+err_hndl:
+    ompi_coll_base_free_reqs(plan->reqs, nreq);
+    return err;
+}
+
+int
+mca_coll_han_neighbor_alltoallv_intra(const void *sbuf, ompi_count_array_t scounts,
+                                      ompi_disp_array_t sdispls, struct ompi_datatype_t *sdtype,
+                                      void *rbuf, ompi_count_array_t rcounts,
+                                      ompi_disp_array_t rdispls, struct ompi_datatype_t *rdtype,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    mca_coll_han_neighbor_plan_t *plan = han_neighbor_get_plan(comm, han_module);
+    const mca_topo_base_comm_dist_graph_2_2_0_t *dg;
+    ptrdiff_t sext, rext, lb;
+    int nreq = 0, err, i, j, k;
+
+    if (NULL == plan) {
+        return han_module->previous_neighbor_alltoallv(sbuf, scounts, sdispls, sdtype, rbuf,
+                                                       rcounts, rdispls, rdtype, comm,
+                                                       han_module->previous_neighbor_alltoallv_module);
+    }
+
+    dg = comm->c_topo->mtc.dist_graph;
+    ompi_datatype_get_extent(sdtype, &lb, &sext);
+    ompi_datatype_get_extent(rdtype, &lb, &rext);
+
+    for (i = 0; i < plan->indegree; i++) {
+        err = MCA_PML_CALL(irecv((char *) rbuf + ompi_disp_array_get(rdispls, i) * rext,
+                                 ompi_count_array_get(rcounts, i), rdtype, dg->in[i],
+                                 HAN_NEIGHBOR_TAG_DIRECT, comm, &plan->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    for (k = 0; k < plan->outdegree; k++) {
+        j = plan->send_order[k];
+        err = MCA_PML_CALL(isend((char *) sbuf + ompi_disp_array_get(sdispls, j) * sext,
+                                 ompi_count_array_get(scounts, j), sdtype, dg->out[j],
+                                 HAN_NEIGHBOR_TAG_DIRECT, MCA_PML_BASE_SEND_STANDARD, comm,
+                                 &plan->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    err = ompi_request_wait_all(nreq, plan->reqs, MPI_STATUSES_IGNORE);
+    if (OMPI_SUCCESS == err) {
+        return OMPI_SUCCESS;
+    }
+    nreq = 0;
+
+err_hndl:
+    ompi_coll_base_free_reqs(plan->reqs, nreq);
+    return err;
+}
+
+int
+mca_coll_han_neighbor_alltoallw_intra(const void *sbuf, ompi_count_array_t scounts,
+                                      ompi_disp_array_t sdispls,
+                                      struct ompi_datatype_t * const *sdtypes, void *rbuf,
+                                      ompi_count_array_t rcounts, ompi_disp_array_t rdispls,
+                                      struct ompi_datatype_t * const *rdtypes,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    mca_coll_han_neighbor_plan_t *plan = han_neighbor_get_plan(comm, han_module);
+    const mca_topo_base_comm_dist_graph_2_2_0_t *dg;
+    int nreq = 0, err, i, j, k;
+
+    if (NULL == plan) {
+        return han_module->previous_neighbor_alltoallw(sbuf, scounts, sdispls, sdtypes, rbuf,
+                                                       rcounts, rdispls, rdtypes, comm,
+                                                       han_module->previous_neighbor_alltoallw_module);
+    }
+
+    dg = comm->c_topo->mtc.dist_graph;
+
+    for (i = 0; i < plan->indegree; i++) {
+        err = MCA_PML_CALL(irecv((char *) rbuf + ompi_disp_array_get(rdispls, i),
+                                 ompi_count_array_get(rcounts, i),
+                                 rdtypes[i], dg->in[i], HAN_NEIGHBOR_TAG_DIRECT, comm,
+                                 &plan->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    for (k = 0; k < plan->outdegree; k++) {
+        j = plan->send_order[k];
+        err = MCA_PML_CALL(isend((char *) sbuf + ompi_disp_array_get(sdispls, j),
+                                 ompi_count_array_get(scounts, j),
+                                 sdtypes[j], dg->out[j], HAN_NEIGHBOR_TAG_DIRECT,
+                                 MCA_PML_BASE_SEND_STANDARD, comm, &plan->reqs[nreq++]));
+        if (OMPI_SUCCESS != err) {
+            goto err_hndl;
+        }
+    }
+    err = ompi_request_wait_all(nreq, plan->reqs, MPI_STATUSES_IGNORE);
+    if (OMPI_SUCCESS == err) {
+        return OMPI_SUCCESS;
+    }
+    nreq = 0;
+
+err_hndl:
+    ompi_coll_base_free_reqs(plan->reqs, nreq);
+    return err;
+}
@@ -0,0 +1,212 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Persistent hierarchical collectives. The sub-communicators are
+ * created and the per-level persistent requests initialized once, in
+ * *_init; every MPI_Start then replays the levels in order without any
+ * further decision or allocation.
+ */
+
+#include "coll_han.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_base_persistent.h"
+
+/*
+ * Persistent allreduce: reduce on the node, allreduce between the node
+ * leaders, bcast on the node. Same decomposition as
+ * mca_coll_han_allreduce_intra_simple.
+ */
+int
+mca_coll_han_allreduce_init_intra(const void *sbuf,
+                                  void *rbuf,
+                                  size_t count,
+                                  struct ompi_datatype_t *dtype,
+                                  struct ompi_op_t *op,
+                                  struct ompi_communicator_t *comm,
+                                  struct ompi_info_t *info,
+                                  ompi_request_t **request,
+                                  mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *)module;
+    ompi_coll_base_persistent_request_t *plan;
+    ompi_communicator_t *low_comm, *up_comm;
+    ompi_request_t *subreq;
+    int root_low_rank = 0;
+    int low_rank, ret;
+
+    /* Fallback to another component if the op cannot commute */
+    if (! ompi_op_is_commute(op)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle allreduce_init with this operation. Fall back on another component\n"));
+        goto prev_allreduce_init;
+    }
+
+    /* Create the subcommunicators */
+    if( OMPI_SUCCESS != mca_coll_han_comm_create_new(comm, han_module) ) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle allreduce_init with this communicator. Drop HAN support in this communicator and fall back on another component\n"));
+        HAN_LOAD_FALLBACK_COLLECTIVES(comm, han_module);
+        goto prev_allreduce_init;
+    }
+
+    low_comm = han_module->sub_comm[INTRA_NODE];
+    up_comm = han_module->sub_comm[INTER_NODE];
+    low_rank = ompi_comm_rank(low_comm);
+
+    ret = ompi_coll_base_persistent_create(comm, dtype, op, &plan);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    /* Low_comm reduce */
+    if (MPI_IN_PLACE == sbuf) {
+        if (low_rank == root_low_rank) {
+            ret = low_comm->c_coll->coll_reduce_init(MPI_IN_PLACE, rbuf, count, dtype, op,
+                                                     root_low_rank, low_comm, info, &subreq,
+                                                     low_comm->c_coll->coll_reduce_init_module);
+        } else {
+            ret = low_comm->c_coll->coll_reduce_init(rbuf, NULL, count, dtype, op,
+                                                     root_low_rank, low_comm, info, &subreq,
+                                                     low_comm->c_coll->coll_reduce_init_module);
+        }
+    } else {
+        ret = low_comm->c_coll->coll_reduce_init(sbuf, rbuf, count, dtype, op,
+                                                 root_low_rank, low_comm, info, &subreq,
+                                                 low_comm->c_coll->coll_reduce_init_module);
+    }
+    if (OMPI_SUCCESS == ret) {
+        ret = ompi_coll_base_persistent_add_request(plan, subreq);
+    }
+
+    /* Local roots perform an allreduce on the upper comm */
+    if (OMPI_SUCCESS == ret && low_rank == root_low_rank) {
+        ret = ompi_coll_base_persistent_step(plan);
+        if (OMPI_SUCCESS == ret) {
+            ret = up_comm->c_coll->coll_allreduce_init(MPI_IN_PLACE, rbuf, count, dtype, op,
+                                                       up_comm, info, &subreq,
+                                                       up_comm->c_coll->coll_allreduce_init_module);
+        }
+        if (OMPI_SUCCESS == ret) {
+            ret = ompi_coll_base_persistent_add_request(plan, subreq);
+        }
+    }
+
+    /* Low_comm bcast */
+    if (OMPI_SUCCESS == ret) {
+        ret = ompi_coll_base_persistent_step(plan);
+    }
+    if (OMPI_SUCCESS == ret) {
+        ret = low_comm->c_coll->coll_bcast_init(rbuf, count, dtype, root_low_rank, low_comm,
+                                                info, &subreq,
+                                                low_comm->c_coll->coll_bcast_init_module);
+    }
+    if (OMPI_SUCCESS == ret) {
+        ret = ompi_coll_base_persistent_add_request(plan, subreq);
+    }
+
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/ALLREDUCE_INIT: cannot build the plan (%d)\n", ret));
+        ompi_coll_base_persistent_destroy(plan);
+        return ret;
+    }
+
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+
+ prev_allreduce_init:
+    return han_module->previous_allreduce_init(sbuf, rbuf, count, dtype, op, comm, info, request,
+                                               han_module->previous_allreduce_init_module);
+}
+
+/*
+ * Persistent bcast: bcast between the node leaders then on the node.
+ * Same decomposition as mca_coll_han_bcast_intra_simple.
+ */
+int
+mca_coll_han_bcast_init_intra(void *buf,
+                              size_t count,
+                              struct ompi_datatype_t *dtype,
+                              int root,
+                              struct ompi_communicator_t *comm,
+                              struct ompi_info_t *info,
+                              ompi_request_t **request,
+                              mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *)module;
+    ompi_coll_base_persistent_request_t *plan;
+    ompi_communicator_t *low_comm, *up_comm;
+    ompi_request_t *subreq;
+    int low_rank, low_size, root_low_rank, root_up_rank, ret;
+
+    /* Create the subcommunicators */
+    if( OMPI_SUCCESS != mca_coll_han_comm_create_new(comm, han_module) ) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle bcast_init with this communicator. Fall back on another component\n"));
+        HAN_LOAD_FALLBACK_COLLECTIVES(comm, han_module);
+        goto prev_bcast_init;
+    }
+    /* Topo must be initialized to know rank distribution which then is used to
+     * determine if han can be used */
+    mca_coll_han_topo_init(comm, han_module, 2);
+    if (han_module->are_ppn_imbalanced) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle bcast_init with this communicator (imbalance). Fall back on another component\n"));
+        HAN_UNINSTALL_COLL_API(comm, han_module, bcast_init);
+        goto prev_bcast_init;
+    }
+
+    low_comm = han_module->sub_comm[INTRA_NODE];
+    up_comm = han_module->sub_comm[INTER_NODE];
+    low_rank = ompi_comm_rank(low_comm);
+    low_size = ompi_comm_size(low_comm);
+
+    mca_coll_han_get_ranks(han_module->cached_vranks, root, low_size,
+                           &root_low_rank, &root_up_rank);
+
+    ret = ompi_coll_base_persistent_create(comm, dtype, NULL, &plan);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    if (low_rank == root_low_rank) {
+        ret = up_comm->c_coll->coll_bcast_init(buf, count, dtype, root_up_rank, up_comm, info,
+                                               &subreq, up_comm->c_coll->coll_bcast_init_module);
+        if (OMPI_SUCCESS == ret) {
+            ret = ompi_coll_base_persistent_add_request(plan, subreq);
+        }
+    }
+
+    if (OMPI_SUCCESS == ret) {
+        ret = ompi_coll_base_persistent_step(plan);
+    }
+    if (OMPI_SUCCESS == ret) {
+        ret = low_comm->c_coll->coll_bcast_init(buf, count, dtype, root_low_rank, low_comm, info,
+                                                &subreq, low_comm->c_coll->coll_bcast_init_module);
+    }
+    if (OMPI_SUCCESS == ret) {
+        ret = ompi_coll_base_persistent_add_request(plan, subreq);
+    }
+
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "HAN/BCAST_INIT: cannot build the plan (%d)\n", ret));
+        ompi_coll_base_persistent_destroy(plan);
+        return ret;
+    }
+
+    *request = &plan->super.super;
+    return OMPI_SUCCESS;
+
+ prev_bcast_init:
+    return han_module->previous_bcast_init(buf, count, dtype, root, comm, info, request,
+                                           han_module->previous_bcast_init_module);
+}
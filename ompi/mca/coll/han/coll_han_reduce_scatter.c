@@ -0,0 +1,304 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * @file
+ * This files contains the hierarchical implementations of reduce_scatter
+ * and reduce_scatter_block.
+ *
+ * The vector is reduced on the node leaders, segment by segment. Each
+ * segment is then reduce-scattered between the leaders, each leader
+ * getting the part of the segment that belongs to the ranks of its node;
+ * the up-level reduce_scatter of a segment overlaps with the low-level
+ * reduce of the next one. Finally each leader scatters the result of its
+ * node.
+ */
+
+#include "coll_han.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+
+/* rcounts is 0 for reduce_scatter_block, where every rank gets rcount */
+#define HAN_RS_COUNT(rcounts, rcount, r) \
+    ((0 != (rcounts)) ? ompi_count_array_get((rcounts), (r)) : (rcount))
+
+/*
+ * Walk the ranks of node `node` (in node order, as given by topo) and copy
+ * their overlap with the segment [lo, lo + cnt) of the vector.
+ * When packing, the overlaps are read from seg and appended to buf; when
+ * unpacking, they are read from buf and written to the result of each
+ * rank in res (layout given by res_displs). Returns the number of
+ * elements copied.
+ */
+static size_t
+han_reduce_scatter_copy(bool pack, int node, int low_size, const int *topo,
+                        const size_t *displs, ompi_count_array_t rcounts, size_t rcount,
+                        size_t lo, size_t cnt, char *seg, char *buf, char *res,
+                        const ptrdiff_t *res_displs, ptrdiff_t extent,
+                        struct ompi_datatype_t *dtype)
+{
+    size_t pos = 0;
+
+    for (int k = 0; k < low_size; k++) {
+        int r = topo[2 * (node * low_size + k) + 1];
+        size_t d = displs[r], c = HAN_RS_COUNT(rcounts, rcount, r);
+        size_t a = (lo > d) ? lo : d;
+        size_t b = (lo + cnt < d + c) ? lo + cnt : d + c;
+
+        if (a >= b) {
+            continue;
+        }
+        if (pack) {
+            ompi_datatype_copy_content_same_ddt(dtype, b - a, buf + pos * extent,
+                                                seg + (a - lo) * extent);
+        } else {
+            ompi_datatype_copy_content_same_ddt(dtype, b - a,
+                                                res + (res_displs[k] + a - d) * extent,
+                                                buf + pos * extent);
+        }
+        pos += b - a;
+    }
+    return pos;
+}
+
+static int
+han_reduce_scatter_common(const void *sbuf, void *rbuf, ompi_count_array_t rcounts,
+                          size_t rcount, struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                          struct ompi_communicator_t *comm, mca_coll_han_module_t *han_module)
+{
+    ompi_communicator_t *low_comm = han_module->sub_comm[INTRA_NODE];
+    ompi_communicator_t *up_comm = han_module->sub_comm[INTER_NODE];
+    int w_size = ompi_comm_size(comm);
+    int w_rank = ompi_comm_rank(comm);
+    int low_rank = ompi_comm_rank(low_comm);
+    int low_size = ompi_comm_size(low_comm);
+    int *topo = han_module->cached_topo;
+    size_t total = 0, dtype_size, seg_count, node_total = 0, lo, k;
+    size_t *displs = NULL, *local_cnt = NULL, *upc = NULL;
+    ptrdiff_t *local_displ = NULL, extent, lb, seg_span, res_span, gap = 0, res_gap = 0;
+    char *buffer = NULL, *red = NULL, *pk[2], *piece[2], *res = NULL, *dst;
+    ompi_request_t *req = MPI_REQUEST_NULL;
+    ompi_count_array_t upc_desc, cnt_desc = 0;
+    ompi_disp_array_t displ_desc = 0;
+    int err = OMPI_SUCCESS, up_rank = 0, up_size = 0, seg, r;
+
+    for (r = 0; r < w_size; r++) {
+        total += HAN_RS_COUNT(rcounts, rcount, r);
+    }
+    if (0 == total) {
+        return OMPI_SUCCESS;
+    }
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    ompi_datatype_type_size(dtype, &dtype_size);
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    seg_count = total;
+    COLL_BASE_COMPUTED_SEGCOUNT(mca_coll_han_component.han_reduce_scatter_segsize, dtype_size,
+                                seg_count);
+
+    if (0 == low_rank) {
+        up_rank = ompi_comm_rank(up_comm);
+        up_size = ompi_comm_size(up_comm);
+
+        displs = (size_t *) malloc((w_size + 2 * up_size + low_size) * sizeof(size_t));
+        local_displ = (ptrdiff_t *) malloc(low_size * sizeof(ptrdiff_t));
+        if (NULL == displs || NULL == local_displ) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
+        upc = displs + w_size;
+        local_cnt = upc + 2 * up_size;
+
+        /* Offset of each rank in the vector, and of each rank of this node
+         * in the result of the node */
+        for (r = 0, lo = 0; r < w_size; r++) {
+            displs[r] = lo;
+            lo += HAN_RS_COUNT(rcounts, rcount, r);
+        }
+        for (k = 0; k < (size_t) low_size; k++) {
+            int wr = topo[2 * (up_rank * low_size + k) + 1];
+            local_cnt[k] = HAN_RS_COUNT(rcounts, rcount, wr);
+            local_displ[k] = node_total;
+            node_total += local_cnt[k];
+        }
+
+        /* reduced segment, two packed segments, two received pieces, result */
+        seg_span = opal_datatype_span(&dtype->super, seg_count, &gap);
+        res_span = opal_datatype_span(&dtype->super, node_total, &res_gap);
+        buffer = (char *) malloc(5 * seg_span + res_span);
+        if (NULL == buffer) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
+        red = buffer - gap;
+        pk[0] = red + seg_span;
+        pk[1] = pk[0] + seg_span;
+        piece[0] = pk[1] + seg_span;
+        piece[1] = piece[0] + seg_span;
+        res = buffer + 5 * seg_span - res_gap;
+    }
+
+    for (seg = 0, lo = 0; lo < total; seg++, lo += seg_count) {
+        size_t cnt = (total - lo < seg_count) ? total - lo : seg_count;
+        int cur = seg % 2;
+
+        err = low_comm->c_coll->coll_reduce((char *) sbuf + lo * extent, red, cnt, dtype, op, 0,
+                                            low_comm, low_comm->c_coll->coll_reduce_module);
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+        if (0 != low_rank) {
+            continue;
+        }
+
+        /* The previous segment was reduced between the leaders meanwhile */
+        if (seg > 0) {
+            err = ompi_request_wait(&req, MPI_STATUS_IGNORE);
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+            han_reduce_scatter_copy(false, up_rank, low_size, topo, displs, rcounts, rcount,
+                                    lo - seg_count, seg_count, NULL, piece[1 - cur], res,
+                                    local_displ, extent, dtype);
+        }
+
+        /* Group the segment by node, then reduce_scatter it among the leaders */
+        dst = pk[cur];
+        for (r = 0; r < up_size; r++) {
+            upc[cur * up_size + r] = han_reduce_scatter_copy(true, r, low_size, topo, displs,
+                                                             rcounts, rcount, lo, cnt, red, dst,
+                                                             NULL, NULL, extent, dtype);
+            dst += upc[cur * up_size + r] * extent;
+        }
+        OMPI_COUNT_ARRAY_INIT(&upc_desc, upc + cur * up_size);
+        err = up_comm->c_coll->coll_ireduce_scatter(pk[cur], piece[cur], upc_desc, dtype, op,
+                                                    up_comm, &req,
+                                                    up_comm->c_coll->coll_ireduce_scatter_module);
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+
+    if (0 == low_rank) {
+        err = ompi_request_wait(&req, MPI_STATUS_IGNORE);
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+        lo -= seg_count;
+        han_reduce_scatter_copy(false, up_rank, low_size, topo, displs, rcounts, rcount, lo,
+                                total - lo, NULL, piece[(seg - 1) % 2], res,
+                                local_displ, extent, dtype);
+        OMPI_COUNT_ARRAY_INIT(&cnt_desc, local_cnt);
+        OMPI_DISP_ARRAY_INIT(&displ_desc, local_displ);
+    }
+
+    /* Distribute the result of the node */
+    err = low_comm->c_coll->coll_scatterv(res, cnt_desc, displ_desc, dtype, rbuf,
+                                          HAN_RS_COUNT(rcounts, rcount, w_rank), dtype, 0,
+                                          low_comm, low_comm->c_coll->coll_scatterv_module);
+
+cleanup:
+    if (MPI_REQUEST_NULL != req) {
+        ompi_request_wait(&req, MPI_STATUS_IGNORE);
+    }
+    free(buffer);
+    free(local_displ);
+    free(displs);
+    return err;
+}
+
+/*
+ * Checks shared by reduce_scatter and reduce_scatter_block. Returns
+ * OMPI_ERR_NOT_SUPPORTED if the previous component must be used for this
+ * call, and OMPI_ERR_NOT_AVAILABLE if it must be used from now on.
+ */
+static int
+han_reduce_scatter_usable(struct ompi_communicator_t *comm, mca_coll_han_module_t *han_module,
+                          struct ompi_op_t *op, const char *name)
+{
+    /* No support for non-commutative operations */
+    if (!ompi_op_is_commute(op)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle %s with this operation. Fall back on another component\n",
+                             name));
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    /* Create the subcommunicators */
+    if (OMPI_SUCCESS != mca_coll_han_comm_create_new(comm, han_module)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle %s with this communicator. Drop HAN support in this communicator and fall back on another component\n",
+                             name));
+        HAN_LOAD_FALLBACK_COLLECTIVES(comm, han_module);
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    /* The leaders need the position of every rank in the node order */
+    mca_coll_han_topo_init(comm, han_module, 2);
+    if (han_module->are_ppn_imbalanced) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle %s with this communicator (imbalanced). Drop HAN support in this communicator and fall back on another component\n",
+                             name));
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Reduce_scatter: intra-node reduce to the leaders, reduce_scatter
+ * between the leaders, intra-node scatterv, pipelined by segments of
+ * reduce_scatter_segsize bytes.
+ */
+int
+mca_coll_han_reduce_scatter_intra(const void *sbuf, void *rbuf, ompi_count_array_t rcounts,
+                                  struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    int ret = han_reduce_scatter_usable(comm, han_module, op, "reduce_scatter");
+
+    if (OMPI_SUCCESS != ret) {
+        if (OMPI_ERR_NOT_AVAILABLE == ret) {
+            /* Put back the fallback collective support and call it once. All
+             * future calls will then be automatically redirected. */
+            HAN_UNINSTALL_COLL_API(comm, han_module, reduce_scatter);
+        }
+        return han_module->previous_reduce_scatter(sbuf, rbuf, rcounts, dtype, op, comm,
+                                                   han_module->previous_reduce_scatter_module);
+    }
+
+    return han_reduce_scatter_common(sbuf, rbuf, rcounts, 0, dtype, op, comm, han_module);
+}
+
+/*
+ * Reduce_scatter_block: same as mca_coll_han_reduce_scatter_intra with
+ * equal counts.
+ */
+int
+mca_coll_han_reduce_scatter_block_intra(const void *sbuf, void *rbuf, size_t rcount,
+                                        struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    int ret = han_reduce_scatter_usable(comm, han_module, op, "reduce_scatter_block");
+
+    if (OMPI_SUCCESS != ret) {
+        if (OMPI_ERR_NOT_AVAILABLE == ret) {
+            HAN_UNINSTALL_COLL_API(comm, han_module, reduce_scatter_block);
+        }
+        return han_module->previous_reduce_scatter_block(sbuf, rbuf, rcount, dtype, op, comm,
+                                                         han_module->previous_reduce_scatter_block_module);
+    }
+
+    return han_reduce_scatter_common(sbuf, rbuf, 0, rcount, dtype, op, comm, han_module);
+}
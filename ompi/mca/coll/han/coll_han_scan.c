@@ -0,0 +1,234 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * @file
+ * This files contains the hierarchical implementations of scan and exscan.
+ *
+ * The ranks of a node must be consecutive in the communicator, with the
+ * nodes in the order of the leaders' ranks: the prefix of a rank is then
+ * the prefix of the previous nodes, given by an exscan between the
+ * leaders of the node totals, combined with its prefix inside the node.
+ */
+
+#include "coll_han.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+
+/*
+ * Checks shared by scan and exscan. Returns OMPI_ERR_NOT_SUPPORTED if
+ * the previous component must be used for this call, and
+ * OMPI_ERR_NOT_AVAILABLE if it must be used from now on.
+ */
+static int
+han_scan_usable(struct ompi_communicator_t *comm, mca_coll_han_module_t *han_module,
+                const char *name)
+{
+    /* Create the subcommunicators */
+    if (OMPI_SUCCESS != mca_coll_han_comm_create_new(comm, han_module)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle %s with this communicator. Drop HAN support in this communicator and fall back on another component\n",
+                             name));
+        HAN_LOAD_FALLBACK_COLLECTIVES(comm, han_module);
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    /* The prefixes follow the rank order, which must match the node order */
+    mca_coll_han_topo_init(comm, han_module, 2);
+    if (han_module->are_ppn_imbalanced || !han_module->is_mapbycore) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                             "han cannot handle %s with this communicator (imbalanced or not mapped by core). Drop HAN support in this communicator and fall back on another component\n",
+                             name));
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Compute on every rank of a node but the first one the total of the
+ * previous nodes (into prefix), from the inclusive scan of the node
+ * (incl, on every rank). Returns the index of the node.
+ */
+static int
+han_scan_node_prefix(void *incl, void *prefix, size_t count, struct ompi_datatype_t *dtype,
+                     struct ompi_op_t *op, struct ompi_communicator_t *comm,
+                     mca_coll_han_module_t *han_module, int *node)
+{
+    ompi_communicator_t *low_comm = han_module->sub_comm[INTRA_NODE];
+    ompi_communicator_t *up_comm = han_module->sub_comm[INTER_NODE];
+    int low_rank = ompi_comm_rank(low_comm);
+    int low_size = ompi_comm_size(low_comm);
+    int err = OMPI_SUCCESS;
+
+    /* Ranks are consecutive and balanced */
+    *node = ompi_comm_rank(comm) / low_size;
+
+    /* The last rank of the node holds the total of the node */
+    if (low_size > 1 && low_rank == low_size - 1) {
+        err = MCA_PML_CALL(send(incl, count, dtype, 0, MCA_COLL_BASE_TAG_SCAN,
+                                MCA_PML_BASE_SEND_STANDARD, low_comm));
+    } else if (0 == low_rank) {
+        if (low_size > 1) {
+            err = MCA_PML_CALL(recv(prefix, count, dtype, low_size - 1, MCA_COLL_BASE_TAG_SCAN,
+                                    low_comm, MPI_STATUS_IGNORE));
+        } else {
+            err = ompi_datatype_copy_content_same_ddt(dtype, count, prefix, incl);
+        }
+        if (OMPI_SUCCESS != err) {
+            return err;
+        }
+        err = up_comm->c_coll->coll_exscan(MPI_IN_PLACE, prefix, count, dtype, op, up_comm,
+                                           up_comm->c_coll->coll_exscan_module);
+    }
+    if (OMPI_SUCCESS != err || 0 == *node) {
+        return err;
+    }
+
+    return low_comm->c_coll->coll_bcast(prefix, count, dtype, 0, low_comm,
+                                        low_comm->c_coll->coll_bcast_module);
+}
+
+/*
+ * Scan: intra-node scan, exscan of the node totals between the leaders,
+ * intra-node bcast of the prefix of the node.
+ */
+int
+mca_coll_han_scan_intra(const void *sbuf, void *rbuf, size_t count,
+                        struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                        struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    ompi_communicator_t *low_comm;
+    ptrdiff_t span, gap = 0;
+    char *prefix = NULL;
+    int node, err;
+
+    err = han_scan_usable(comm, han_module, "scan");
+    if (OMPI_SUCCESS != err) {
+        if (OMPI_ERR_NOT_AVAILABLE == err) {
+            /* Put back the fallback collective support and call it once. All
+             * future calls will then be automatically redirected. */
+            HAN_UNINSTALL_COLL_API(comm, han_module, scan);
+        }
+        return han_module->previous_scan(sbuf, rbuf, count, dtype, op, comm,
+                                         han_module->previous_scan_module);
+    }
+
+    low_comm = han_module->sub_comm[INTRA_NODE];
+    err = low_comm->c_coll->coll_scan(sbuf, rbuf, count, dtype, op, low_comm,
+                                      low_comm->c_coll->coll_scan_module);
+    if (OMPI_SUCCESS != err || 0 == count) {
+        return err;
+    }
+
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    prefix = (char *) malloc(span);
+    if (NULL == prefix) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    err = han_scan_node_prefix(rbuf, prefix - gap, count, dtype, op, comm, han_module, &node);
+    if (OMPI_SUCCESS == err && node > 0) {
+        /* The previous nodes come first for non-commutative operations */
+        ompi_op_reduce(op, prefix - gap, rbuf, count, dtype);
+    }
+
+    free(prefix);
+    return err;
+}
+
+/*
+ * Exscan: same as mca_coll_han_scan_intra, the inclusive prefix inside
+ * the node being shifted by one rank.
+ */
+int
+mca_coll_han_exscan_intra(const void *sbuf, void *rbuf, size_t count,
+                          struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                          struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    mca_coll_han_module_t *han_module = (mca_coll_han_module_t *) module;
+    ompi_communicator_t *low_comm;
+    ompi_request_t *req = MPI_REQUEST_NULL;
+    ptrdiff_t span, gap = 0;
+    char *buffer = NULL, *incl, *prefix;
+    int low_rank, low_size, node, err;
+
+    err = han_scan_usable(comm, han_module, "exscan");
+    if (OMPI_SUCCESS != err) {
+        if (OMPI_ERR_NOT_AVAILABLE == err) {
+            HAN_UNINSTALL_COLL_API(comm, han_module, exscan);
+        }
+        return han_module->previous_exscan(sbuf, rbuf, count, dtype, op, comm,
+                                           han_module->previous_exscan_module);
+    }
+    if (0 == count) {
+        return OMPI_SUCCESS;
+    }
+
+    low_comm = han_module->sub_comm[INTRA_NODE];
+    low_rank = ompi_comm_rank(low_comm);
+    low_size = ompi_comm_size(low_comm);
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    buffer = (char *) malloc(2 * span);
+    if (NULL == buffer) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    incl = buffer - gap;
+    prefix = incl + span;
+
+    err = low_comm->c_coll->coll_scan(sbuf, incl, count, dtype, op, low_comm,
+                                      low_comm->c_coll->coll_scan_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+    err = han_scan_node_prefix(incl, prefix, count, dtype, op, comm, han_module, &node);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    /* Shift the inclusive prefixes of the node by one rank */
+    if (low_rank < low_size - 1) {
+        err = MCA_PML_CALL(isend(incl, count, dtype, low_rank + 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                 MCA_PML_BASE_SEND_STANDARD, low_comm, &req));
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+    if (low_rank > 0) {
+        err = MCA_PML_CALL(recv(rbuf, count, dtype, low_rank - 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                low_comm, MPI_STATUS_IGNORE));
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+    err = ompi_request_wait(&req, MPI_STATUS_IGNORE);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    if (node > 0) {
+        if (0 == low_rank) {
+            err = ompi_datatype_copy_content_same_ddt(dtype, count, rbuf, prefix);
+        } else {
+            ompi_op_reduce(op, prefix, rbuf, count, dtype);
+        }
+    }
+
+cleanup:
+    if (MPI_REQUEST_NULL != req) {
+        ompi_request_wait(&req, MPI_STATUS_IGNORE);
+    }
+    free(buffer);
+    return err;
+}
@@ -38,19 +38,9 @@ BEGIN_C_DECLS
 /* the debug level */
 #define NBC_DLEVEL 0
 
-/* enable schedule caching - undef NBC_CACHE_SCHEDULE to deactivate it */
-/* TODO: this whole schedule cache stuff does not work with the tmbuf
- * :-( - first, the tmpbuf must not be freed if a schedule using it is
- * still in the cache and second, the tmpbuf used by the schedule must
- * be attached to the handle that uses this schedule !!!!
- * I.E., THIS IS EXPERIMENTAL AND MIGHT NOT WORK */
-/* It also leaks memory because the schedule is never cleaned up when
-   the communicator is destroyed, so don't use it for now */
-#ifdef NBC_CACHE_SCHEDULE
-#undef NBC_CACHE_SCHEDULE
-#endif
-#define NBC_SCHED_DICT_UPPER 1024 /* max. number of dict entries */
-#define NBC_SCHED_DICT_LOWER 512  /* number of dict entries after wipe, if SCHED_DICT_UPPER is reached */
+/* default number of schedules cached per communicator (see
+ * coll_libnbc_schedule_cache_size) */
+#define NBC_SCHED_CACHE_SIZE 16
 
 /********************* end of LibNBC tuning parameters ************************/
 
@@ -84,6 +74,9 @@ struct ompi_coll_libnbc_component_t {
     opal_list_t active_requests;
     opal_atomic_int32_t active_comms;
     opal_mutex_t lock;                /* protect access to the active_requests list */
+    int schedule_cache_size;          /* max. number of schedules cached per communicator */
+    opal_atomic_size_t schedule_cache_hits;   /* schedules found in the cache */
+    opal_atomic_size_t schedule_cache_misses; /* cacheable schedules that had to be built */
 };
 typedef struct ompi_coll_libnbc_component_t ompi_coll_libnbc_component_t;
 
@@ -94,25 +87,38 @@ struct ompi_coll_libnbc_module_t {
     mca_coll_base_module_t super;
     opal_mutex_t mutex;
     bool comm_registered;
-#ifdef NBC_CACHE_SCHEDULE
-  void *NBC_Dict[NBC_NUM_COLL]; /* this should point to a struct
-                                      hb_tree, but since this is a
-                                      public header-file, this would be
-                                      an include mess :-(. So let's void
-                                      it ...*/
-  int NBC_Dict_size[NBC_NUM_COLL];
-#endif
+    /* schedule templates, most recently used first */
+    opal_list_t schedule_cache;
 };
 typedef struct ompi_coll_libnbc_module_t ompi_coll_libnbc_module_t;
 OBJ_CLASS_DECLARATION(ompi_coll_libnbc_module_t);
 
 typedef ompi_coll_libnbc_module_t NBC_Comminfo;
 
+/* everything that determines the shape of a schedule except the
+ * buffers. the datatypes and the operation are retained by the
+ * schedule so they can not be reused while it is cached */
+struct NBC_Schedule_key {
+    int coll;
+    int alg;
+    int root;
+    bool inplace;
+    bool persistent;
+    size_t count[2];
+    struct ompi_datatype_t *dtype[2];
+    struct ompi_op_t *op;
+};
+
+typedef struct NBC_Schedule_key NBC_Schedule_key;
+
 struct NBC_Schedule {
-    opal_object_t super;
+    opal_list_item_t super;
     volatile int size;
     volatile int current_round_offset;
     char *data;
+    /* set if this schedule is a template (see NBC_Schedule_cache_insert) */
+    bool cached;
+    NBC_Schedule_key key;
 };
 
 typedef struct NBC_Schedule NBC_Schedule;
@@ -129,7 +135,9 @@ struct ompi_coll_libnbc_request_t {
     ompi_request_t **req_array;
     NBC_Comminfo *comminfo;
     NBC_Schedule *schedule;
-    void *tmpbuf; /* temporary buffer e.g. used for Reduce */
+    void *tmpbuf; /* temporary buffer e.g. used for Reduce, owned by the handle */
+    const void *sendbuf; /* user buffers a cached schedule is started on */
+    void *recvbuf;
     /* TODO: we should make a handle pointer to a state later (that the user
      * can move request handles) */
 };
@@ -157,7 +165,6 @@ typedef ompi_coll_libnbc_request_t NBC_Handle;
 
 int ompi_coll_libnbc_progress(void);
 
-int NBC_Init_comm(MPI_Comm comm, ompi_coll_libnbc_module_t *module);
 int NBC_Progress(NBC_Handle *handle);
 
 
@@ -36,6 +36,7 @@
 #include "mpi.h"
 #include "ompi/mca/coll/coll.h"
 #include "ompi/communicator/communicator.h"
+#include "opal/mca/base/mca_base_pvar.h"
 
 /*
  * Public string showing the coll ompi_libnbc component version number
@@ -273,6 +274,42 @@ libnbc_register(void)
                                     &libnbc_ireduce_algorithm);
     OBJ_RELEASE(new_enum);
 
+    mca_coll_libnbc_component.schedule_cache_size = NBC_SCHED_CACHE_SIZE;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "schedule_cache_size",
+                                           "Maximum number of schedules cached per communicator and reused by "
+                                           "later calls with the same arguments (except the buffers). 0 disables "
+                                           "the cache",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_coll_libnbc_component.schedule_cache_size);
+
+    mca_coll_libnbc_component.schedule_cache_hits = 0;
+    (void) mca_base_component_pvar_register(&mca_coll_libnbc_component.super.collm_version,
+                                            "schedule_cache_hits",
+                                            "Number of nonblocking collectives that reused a cached schedule",
+                                            OPAL_INFO_LVL_5, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_SIZE_T, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &mca_coll_libnbc_component.schedule_cache_hits);
+
+    mca_coll_libnbc_component.schedule_cache_misses = 0;
+    (void) mca_base_component_pvar_register(&mca_coll_libnbc_component.super.collm_version,
+                                            "schedule_cache_misses",
+                                            "Number of nonblocking collectives that had to build a cacheable "
+                                            "schedule",
+                                            OPAL_INFO_LVL_5, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_SIZE_T, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &mca_coll_libnbc_component.schedule_cache_misses);
+
     libnbc_iscan_algorithm = 0;
     (void) mca_base_var_enum_create("coll_libnbc_iscan_algorithms", iscan_algorithms, &new_enum);
     mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
@@ -403,11 +440,6 @@ libnbc_comm_query(struct ompi_communicator_t *comm,
         module->super.coll_neighbor_alltoallw_init = ompi_coll_libnbc_neighbor_alltoallw_init;
     }
 
-    if (OMPI_SUCCESS != NBC_Init_comm(comm, module)) {
-        OBJ_RELEASE(module);
-        return NULL;
-    }
-
     return &(module->super);
 }
 
@@ -609,6 +641,7 @@ static void
 libnbc_module_construct(ompi_coll_libnbc_module_t *module)
 {
     OBJ_CONSTRUCT(&module->mutex, opal_mutex_t);
+    OBJ_CONSTRUCT(&module->schedule_cache, opal_list_t);
     module->comm_registered = false;
 }
 
@@ -617,6 +650,9 @@ static void
 libnbc_module_destruct(ompi_coll_libnbc_module_t *module)
 {
     OBJ_DESTRUCT(&module->mutex);
+    /* drop the cached schedules. requests that are still using one of
+     * them hold their own reference */
+    OPAL_LIST_DESTRUCT(&module->schedule_cache);
 
     /* if we ever were used for a collective op, do the progress cleanup. */
     if (true == module->comm_registered) {
@@ -691,7 +727,9 @@ request_free(struct ompi_request_t **ompi_req)
         return MPI_ERR_REQUEST;
     }
 
-    OMPI_COLL_LIBNBC_REQUEST_RETURN(request);
+    /* persistent requests keep their schedule and temporary buffer
+     * until they are freed */
+    NBC_Return_handle(request);
     *ompi_req = MPI_REQUEST_NULL;
 
     return OMPI_SUCCESS;
@@ -51,14 +51,27 @@ static void nbc_schedule_constructor (NBC_Schedule *schedule) {
   schedule->size = sizeof (int);
   schedule->current_round_offset = 0;
   schedule->data = calloc (1, schedule->size);
+  schedule->cached = false;
 }
 
 static void nbc_schedule_destructor (NBC_Schedule *schedule) {
   free (schedule->data);
   schedule->data = NULL;
+
+  if (schedule->cached) {
+    /* release the objects retained by NBC_Schedule_cache_insert */
+    for (int i = 0 ; i < 2 ; ++i) {
+      if (NULL != schedule->key.dtype[i]) {
+        OMPI_DATATYPE_RELEASE_NO_NULLIFY(schedule->key.dtype[i]);
+      }
+    }
+    if (NULL != schedule->key.op && !ompi_op_is_intrinsic (schedule->key.op)) {
+      OBJ_RELEASE_NO_NULLIFY(schedule->key.op);
+    }
+  }
 }
 
-OBJ_CLASS_INSTANCE(NBC_Schedule, opal_object_t, nbc_schedule_constructor,
+OBJ_CLASS_INSTANCE(NBC_Schedule, opal_list_item_t, nbc_schedule_constructor,
                    nbc_schedule_destructor);
 
 static int nbc_schedule_grow (NBC_Schedule *schedule, int additional) {
@@ -305,9 +318,8 @@ static inline void NBC_Free (NBC_Handle* handle) {
     handle->schedule = NULL;
   }
 
-  /* if the nbc_I<collective> attached some data */
-  /* problems with schedule cache here, see comment (TODO) in
-   * nbc_internal.h */
+  /* if the nbc_I<collective> attached some data. the temporary buffer
+   * belongs to the handle, cached schedules only hold offsets into it */
   if (NULL != handle->tmpbuf) {
     free((void*)handle->tmpbuf);
     handle->tmpbuf = NULL;
@@ -426,6 +438,20 @@ int NBC_Progress(NBC_Handle *handle) {
   return ret;
 }
 
+/* returns the address of a buffer in the schedule of {handle} */
+static inline void *nbc_handle_buf(NBC_Handle *handle, char where, const void *buf) {
+  switch (where) {
+  case NBC_BUF_TMP:
+    return (char *) handle->tmpbuf + (intptr_t) buf;
+  case NBC_BUF_SEND:
+    return (char *) handle->sendbuf + (intptr_t) buf;
+  case NBC_BUF_RECV:
+    return (char *) handle->recvbuf + (intptr_t) buf;
+  default:
+    return (void *) buf;
+  }
+}
+
 static inline int NBC_Start_round(NBC_Handle *handle) {
   int num; /* number of operations */
   int res;
@@ -458,11 +484,7 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
         /* get an additional request */
         handle->req_count++;
         /* get buffer */
-        if(sendargs.tmpbuf) {
-          buf1=(char*)handle->tmpbuf+(long)sendargs.buf;
-        } else {
-          buf1=(void *)sendargs.buf;
-        }
+        buf1 = nbc_handle_buf(handle, sendargs.tmpbuf, sendargs.buf);
 #ifdef NBC_TIMING
         Isend_time -= MPI_Wtime();
 #endif
@@ -493,11 +515,7 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
         /* get an additional request - TODO: req_count NOT thread safe */
         handle->req_count++;
         /* get buffer */
-        if(recvargs.tmpbuf) {
-          buf1=(char*)handle->tmpbuf+(long)recvargs.buf;
-        } else {
-          buf1=recvargs.buf;
-        }
+        buf1 = nbc_handle_buf(handle, recvargs.tmpbuf, recvargs.buf);
 #ifdef NBC_TIMING
         Irecv_time -= MPI_Wtime();
 #endif
@@ -525,16 +543,8 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
         NBC_DEBUG(5, "*buf1: %p, buf2: %p, count: %i, type: %p)\n", opargs.buf1, opargs.buf2,
                   opargs.count, opargs.datatype);
         /* get buffers */
-        if(opargs.tmpbuf1) {
-          buf1=(char*)handle->tmpbuf+(long)opargs.buf1;
-        } else {
-          buf1=(void *)opargs.buf1;
-        }
-        if(opargs.tmpbuf2) {
-          buf2=(char*)handle->tmpbuf+(long)opargs.buf2;
-        } else {
-          buf2=opargs.buf2;
-        }
+        buf1 = nbc_handle_buf(handle, opargs.tmpbuf1, opargs.buf1);
+        buf2 = nbc_handle_buf(handle, opargs.tmpbuf2, opargs.buf2);
 
         ompi_op_reduce(opargs.op, buf1, buf2, opargs.count, opargs.datatype);
         break;
@@ -545,16 +555,8 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
                   (unsigned long) copyargs.src, copyargs.srccount, copyargs.srctype,
                   (unsigned long) copyargs.tgt, copyargs.tgtcount, copyargs.tgttype);
         /* get buffers */
-        if(copyargs.tmpsrc) {
-          buf1=(char*)handle->tmpbuf+(long)copyargs.src;
-        } else {
-          buf1=copyargs.src;
-        }
-        if(copyargs.tmptgt) {
-          buf2=(char*)handle->tmpbuf+(long)copyargs.tgt;
-        } else {
-          buf2=copyargs.tgt;
-        }
+        buf1 = nbc_handle_buf(handle, copyargs.tmpsrc, copyargs.src);
+        buf2 = nbc_handle_buf(handle, copyargs.tmptgt, copyargs.tgt);
         res = NBC_Copy (buf1, copyargs.srccount, copyargs.srctype, buf2, copyargs.tgtcount, copyargs.tgttype,
                         handle->comm);
         if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -567,16 +569,8 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
         NBC_DEBUG(5, "*src: %lu, srccount: %i, srctype: %p, *tgt: %lu\n", (unsigned long) unpackargs.inbuf,
                   unpackargs.count, unpackargs.datatype, (unsigned long) unpackargs.outbuf);
         /* get buffers */
-        if(unpackargs.tmpinbuf) {
-          buf1=(char*)handle->tmpbuf+(long)unpackargs.inbuf;
-        } else {
-          buf1=unpackargs.inbuf;
-        }
-        if(unpackargs.tmpoutbuf) {
-          buf2=(char*)handle->tmpbuf+(long)unpackargs.outbuf;
-        } else {
-          buf2=unpackargs.outbuf;
-        }
+        buf1 = nbc_handle_buf(handle, unpackargs.tmpinbuf, unpackargs.inbuf);
+        buf2 = nbc_handle_buf(handle, unpackargs.tmpoutbuf, unpackargs.outbuf);
         res = NBC_Unpack (buf1, unpackargs.count, unpackargs.datatype, buf2, handle->comm);
         if (OMPI_SUCCESS != res) {
           NBC_Error ("NBC_Unpack() failed (code: %i)", res);
@@ -610,57 +604,6 @@ void NBC_Return_handle(ompi_coll_libnbc_request_t *request) {
   OMPI_COLL_LIBNBC_REQUEST_RETURN(request);
 }
 
-int  NBC_Init_comm(MPI_Comm comm, NBC_Comminfo *comminfo) {
-
-#ifdef NBC_CACHE_SCHEDULE
-  /* initialize the NBC_ALLTOALL SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLTOALL] = hb_tree_new((dict_cmp_func)NBC_Alltoall_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLTOALL] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLTOALL]);
-  comminfo->NBC_Dict_size[NBC_ALLTOALL] = 0;
-  /* initialize the NBC_ALLGATHER SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLGATHER] = hb_tree_new((dict_cmp_func)NBC_Allgather_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLGATHER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLGATHER]);
-  comminfo->NBC_Dict_size[NBC_ALLGATHER] = 0;
-  /* initialize the NBC_ALLREDUCE SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLREDUCE] = hb_tree_new((dict_cmp_func)NBC_Allreduce_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLREDUCE] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLREDUCE]);
-  comminfo->NBC_Dict_size[NBC_ALLREDUCE] = 0;
-  /* initialize the NBC_BARRIER SchedCache tree - is not needed -
-   * schedule is hung off directly */
-  comminfo->NBC_Dict_size[NBC_BARRIER] = 0;
-  /* initialize the NBC_BCAST SchedCache tree */
-  comminfo->NBC_Dict[NBC_BCAST] = hb_tree_new((dict_cmp_func)NBC_Bcast_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_BCAST] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_BCAST]);
-  comminfo->NBC_Dict_size[NBC_BCAST] = 0;
-  /* initialize the NBC_GATHER SchedCache tree */
-  comminfo->NBC_Dict[NBC_GATHER] = hb_tree_new((dict_cmp_func)NBC_Gather_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_GATHER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_GATHER]);
-  comminfo->NBC_Dict_size[NBC_GATHER] = 0;
-  /* initialize the NBC_REDUCE SchedCache tree */
-  comminfo->NBC_Dict[NBC_REDUCE] = hb_tree_new((dict_cmp_func)NBC_Reduce_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_REDUCE] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_REDUCE]);
-  comminfo->NBC_Dict_size[NBC_REDUCE] = 0;
-  /* initialize the NBC_SCAN SchedCache tree */
-  comminfo->NBC_Dict[NBC_SCAN] = hb_tree_new((dict_cmp_func)NBC_Scan_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_SCAN] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_SCAN]);
-  comminfo->NBC_Dict_size[NBC_SCAN] = 0;
-  /* initialize the NBC_SCATTER SchedCache tree */
-  comminfo->NBC_Dict[NBC_SCATTER] = hb_tree_new((dict_cmp_func)NBC_Scatter_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_SCATTER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_SCATTER]);
-  comminfo->NBC_Dict_size[NBC_SCATTER] = 0;
-#endif
-
-  return OMPI_SUCCESS;
-}
-
 int NBC_Start(NBC_Handle *handle) {
   int res;
 
@@ -687,6 +630,15 @@ int NBC_Start(NBC_Handle *handle) {
 int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
                          ompi_coll_libnbc_module_t *module, bool persistent,
                          ompi_request_t **request, void *tmpbuf) {
+  return NBC_Schedule_request_bufs(schedule, comm, module, persistent, request, tmpbuf, NULL, NULL);
+}
+
+/* same as NBC_Schedule_request() for a schedule that may be a template.
+ * {sendbuf} and {recvbuf} are the user buffers the template is started on */
+int NBC_Schedule_request_bufs(NBC_Schedule *schedule, ompi_communicator_t *comm,
+                              ompi_coll_libnbc_module_t *module, bool persistent,
+                              ompi_request_t **request, void *tmpbuf,
+                              const void *sendbuf, void *recvbuf) {
   int ret;
   bool need_register = false;
   ompi_coll_libnbc_request_t *handle;
@@ -748,21 +700,171 @@ int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
   NBC_DEBUG(3, "got tag %i\n", handle->tag);
 
   handle->tmpbuf = tmpbuf;
+  handle->sendbuf = sendbuf;
+  handle->recvbuf = recvbuf;
   handle->schedule = schedule;
   *request = (ompi_request_t *) handle;
 
   return OMPI_SUCCESS;
 }
 
-#ifdef NBC_CACHE_SCHEDULE
-void NBC_SchedCache_args_delete_key_dummy(void *k) {
-    /* do nothing because the key and the data element are identical :-)
-     * both (the single one :) is freed in NBC_<COLLOP>_args_delete() */
+static bool nbc_schedule_key_equal(const NBC_Schedule_key *a, const NBC_Schedule_key *b) {
+  return a->coll == b->coll && a->alg == b->alg && a->root == b->root &&
+    a->inplace == b->inplace && a->persistent == b->persistent &&
+    a->count[0] == b->count[0] && a->count[1] == b->count[1] &&
+    a->dtype[0] == b->dtype[0] && a->dtype[1] == b->dtype[1] && a->op == b->op;
 }
 
-void NBC_SchedCache_args_delete(void *entry) {
-  struct NBC_dummyarg *tmp = (struct NBC_dummyarg*)entry;
-  OBJ_RELEASE(tmp->schedule);
-  free(entry);
+/* look up the template for {key} in the cache of {module}. returns a new
+ * reference to the schedule or NULL if it has to be built */
+NBC_Schedule *NBC_Schedule_cache_find(ompi_coll_libnbc_module_t *module, const NBC_Schedule_key *key) {
+  NBC_Schedule *schedule;
+
+  if (!NBC_Schedule_cache_enabled()) {
+    return NULL;
+  }
+
+  OPAL_THREAD_LOCK(&module->mutex);
+  OPAL_LIST_FOREACH(schedule, &module->schedule_cache, NBC_Schedule) {
+    if (nbc_schedule_key_equal (&schedule->key, key)) {
+      /* keep the list in most recently used order */
+      if ((opal_list_item_t *) schedule != opal_list_get_first (&module->schedule_cache)) {
+        opal_list_remove_item (&module->schedule_cache, &schedule->super);
+        opal_list_prepend (&module->schedule_cache, &schedule->super);
+      }
+      OBJ_RETAIN(schedule);
+      OPAL_THREAD_UNLOCK(&module->mutex);
+      /* the counters are shared by all the communicators */
+      (void) OPAL_THREAD_ADD_FETCH_SIZE_T(&mca_coll_libnbc_component.schedule_cache_hits, 1);
+      return schedule;
+    }
+  }
+  OPAL_THREAD_UNLOCK(&module->mutex);
+  (void) OPAL_THREAD_ADD_FETCH_SIZE_T(&mca_coll_libnbc_component.schedule_cache_misses, 1);
+
+  return NULL;
+}
+
+/* turns an address of a schedule built against the template buffers
+ * into an offset from the corresponding buffer of the handle */
+static inline void nbc_template_rebase(char *where, const void **buf) {
+  static void * const bases[] = {NBC_TEMPLATE_TMPBUF, NBC_TEMPLATE_SENDBUF, NBC_TEMPLATE_RECVBUF};
+  static const char kinds[] = {NBC_BUF_TMP, NBC_BUF_SEND, NBC_BUF_RECV};
+
+  if (NBC_BUF_ABS != *where) {
+    return;
+  }
+
+  for (int i = 0 ; i < 3 ; ++i) {
+    intptr_t offset = (intptr_t) ((uintptr_t) *buf - (uintptr_t) bases[i]);
+    if (offset > -(intptr_t) NBC_TEMPLATE_WINDOW && offset < (intptr_t) NBC_TEMPLATE_WINDOW) {
+      *where = kinds[i];
+      *buf = (const void *) offset;
+      return;
+    }
+  }
+}
+
+#define NBC_TEMPLATE_REBASE(where, buf)                         \
+  do {                                                          \
+    const void *_buf = (buf);                                   \
+    nbc_template_rebase (&(where), &_buf);                      \
+    (buf) = (void *) _buf;                                      \
+  } while (0)
+
+static void nbc_schedule_make_template(NBC_Schedule *schedule) {
+  char *ptr = schedule->data;
+
+  for (;;) {
+    int num;
+
+    NBC_GET_BYTES(ptr, num);
+    for (int i = 0 ; i < num ; ++i) {
+      NBC_Fn_type type;
+
+      memcpy (&type, ptr, sizeof (type));
+      switch (type) {
+      case SEND: {
+        NBC_Args_send args;
+        memcpy (&args, ptr, sizeof (args));
+        NBC_TEMPLATE_REBASE(args.tmpbuf, args.buf);
+        NBC_PUT_BYTES(ptr, args);
+        break;
+      }
+      case RECV: {
+        NBC_Args_recv args;
+        memcpy (&args, ptr, sizeof (args));
+        NBC_TEMPLATE_REBASE(args.tmpbuf, args.buf);
+        NBC_PUT_BYTES(ptr, args);
+        break;
+      }
+      case OP: {
+        NBC_Args_op args;
+        memcpy (&args, ptr, sizeof (args));
+        NBC_TEMPLATE_REBASE(args.tmpbuf1, args.buf1);
+        NBC_TEMPLATE_REBASE(args.tmpbuf2, args.buf2);
+        NBC_PUT_BYTES(ptr, args);
+        break;
+      }
+      case COPY: {
+        NBC_Args_copy args;
+        memcpy (&args, ptr, sizeof (args));
+        NBC_TEMPLATE_REBASE(args.tmpsrc, args.src);
+        NBC_TEMPLATE_REBASE(args.tmptgt, args.tgt);
+        NBC_PUT_BYTES(ptr, args);
+        break;
+      }
+      case UNPACK: {
+        NBC_Args_unpack args;
+        memcpy (&args, ptr, sizeof (args));
+        NBC_TEMPLATE_REBASE(args.tmpinbuf, args.inbuf);
+        NBC_TEMPLATE_REBASE(args.tmpoutbuf, args.outbuf);
+        NBC_PUT_BYTES(ptr, args);
+        break;
+      }
+      default:
+        NBC_Error ("nbc_schedule_make_template: bad type %i", (int) type);
+        return;
+      }
+    }
+
+    /* round delimiter: 0 ends the schedule */
+    if (0 == *ptr++) {
+      break;
+    }
+  }
+}
+
+/* turn the committed {schedule}, which was built against the template
+ * buffers, into a template and add it to the cache of {module}. the
+ * least recently used template is evicted once the cache is full */
+void NBC_Schedule_cache_insert(ompi_coll_libnbc_module_t *module, const NBC_Schedule_key *key,
+                               NBC_Schedule *schedule) {
+  NBC_Schedule *evicted = NULL;
+
+  nbc_schedule_make_template (schedule);
+
+  schedule->key = *key;
+  for (int i = 0 ; i < 2 ; ++i) {
+    if (NULL != key->dtype[i]) {
+      OMPI_DATATYPE_RETAIN(key->dtype[i]);
+    }
+  }
+  if (NULL != key->op && !ompi_op_is_intrinsic (key->op)) {
+    OBJ_RETAIN(key->op);
+  }
+  schedule->cached = true;
+
+  OBJ_RETAIN(schedule);
+  OPAL_THREAD_LOCK(&module->mutex);
+  opal_list_prepend (&module->schedule_cache, &schedule->super);
+  if (opal_list_get_size (&module->schedule_cache) > (size_t) mca_coll_libnbc_component.schedule_cache_size) {
+    evicted = (NBC_Schedule *) opal_list_remove_last (&module->schedule_cache);
+  }
+  OPAL_THREAD_UNLOCK(&module->mutex);
+
+  if (NULL != evicted) {
+    /* handles that still use the template hold their own reference */
+    OBJ_RELEASE(evicted);
+  }
 }
-#endif
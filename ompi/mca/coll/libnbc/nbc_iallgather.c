@@ -29,26 +29,6 @@ static inline int allgather_sched_recursivedoubling(
     size_t scount, struct ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
     struct ompi_datatype_t *rdtype);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Allgather_args_compare(NBC_Allgather_args *a, NBC_Allgather_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype) ) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatype sendtype, void* recvbuf, size_t recvcount,
                               MPI_Datatype recvtype, struct ompi_communicator_t *comm, ompi_request_t ** request,
                               mca_coll_base_module_t *module, bool persistent)
@@ -56,10 +36,8 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
   int rank, p, res;
   MPI_Aint rcvext;
   NBC_Schedule *schedule;
-  char *rbuf, inplace;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Allgather_args *args, *found, search;
-#endif
+  char inplace;
+  NBC_Schedule_key key;
   enum { NBC_ALLGATHER_LINEAR, NBC_ALLGATHER_RDBL} alg;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -92,7 +70,7 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
     sendcount = recvcount;
   } else if (!persistent) { /* for persistent, the copy must be scheduled */
     /* copy my data to receive buffer */
-    rbuf = (char *) recvbuf + (MPI_Aint)rcvext * rank * recvcount;
+    char *rbuf = (char *) recvbuf + (MPI_Aint)rcvext * rank * recvcount;
     res = NBC_Copy (sendbuf, sendcount, sendtype, rbuf, recvcount, recvtype, comm);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       return res;
@@ -102,17 +80,17 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
     return nbc_get_noop_request(persistent, request);
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  found = (NBC_Allgather_args *) hb_tree_search ((hb_tree*)libnbc_module->NBC_Dict[NBC_ALLGATHER], &search);
-  if (NULL == found) {
-#endif
+  NBC_Schedule_key_init (&key, NBC_ALLGATHER, alg, 0, inplace, persistent);
+  key.count[0] = sendcount;
+  key.dtype[0] = sendtype;
+  key.count[1] = recvcount;
+  key.dtype[1] = recvtype;
+  schedule = NBC_Schedule_cache_find (libnbc_module, &key);
+  if (NULL == schedule) {
+    const void *sched_sbuf = sendbuf;
+    void *sched_rbuf = recvbuf;
+    bool cache = NBC_Schedule_template_bufs (&sched_sbuf, &sched_rbuf, NULL, inplace);
+
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -121,9 +99,9 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
     if (persistent && !inplace) {
       /* for nonblocking, data has been copied already */
       /* copy my data to receive buffer (= send buffer of NBC_Sched_send) */
-      rbuf = (char *)recvbuf + (MPI_Aint) rcvext * rank * recvcount;
-      res = NBC_Sched_copy((void *)sendbuf, false, sendcount, sendtype,
-                            rbuf, false, recvcount, recvtype, schedule, true);
+      res = NBC_Sched_copy((void *)sched_sbuf, false, sendcount, sendtype,
+                            (char *) sched_rbuf + (MPI_Aint) rcvext * rank * recvcount, false,
+                            recvcount, recvtype, schedule, true);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         return res;
@@ -132,12 +110,12 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
 
     switch (alg) {
       case NBC_ALLGATHER_LINEAR:
-        res = allgather_sched_linear(rank, p, schedule, sendbuf, sendcount, sendtype,
-                                     recvbuf, recvcount, recvtype);
+        res = allgather_sched_linear(rank, p, schedule, sched_sbuf, sendcount, sendtype,
+                                     sched_rbuf, recvcount, recvtype);
         break;
       case NBC_ALLGATHER_RDBL:
-        res = allgather_sched_recursivedoubling(rank, p, schedule, sendbuf, sendcount,
-                                                sendtype, recvbuf, recvcount, recvtype);
+        res = allgather_sched_recursivedoubling(rank, p, schedule, sched_sbuf, sendcount,
+                                                sendtype, sched_rbuf, recvcount, recvtype);
         break;
     }
 
@@ -152,36 +130,13 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Allgather_args *) malloc (sizeof (args));
-    args->sendbuf = sendbuf;
-    args->sendcount = sendcount;
-    args->sendtype = sendtype;
-    args->recvbuf = recvbuf;
-    args->recvcount = recvcount;
-    args->recvtype = recvtype;
-    args->schedule = schedule;
-
-    res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLGATHER], args, args, 0);
-    if (res != 0) {
-      free (args);
-    } else {
-      OBJ_RETAIN(schedule);
-    }
-
-    /* increase number of elements for A2A */
-    if (++libnbc_module->NBC_Dict_size[NBC_ALLGATHER] > NBC_SCHED_DICT_UPPER) {
-      NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLGATHER], &libnbc_module->NBC_Dict_size[NBC_ALLGATHER]);
+    if (cache) {
+      NBC_Schedule_cache_insert (libnbc_module, &key, schedule);
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_bufs(schedule, comm, libnbc_module, persistent, request, NULL,
+                                  sendbuf, recvbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -42,25 +42,6 @@ static inline int allred_sched_redscat_allgather(
     const void *sbuf, void *rbuf, MPI_Op op, char inplace,
     NBC_Schedule *schedule, void *tmpbuf, struct ompi_communicator_t *comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Allreduce_args_compare(NBC_Allreduce_args *a, NBC_Allreduce_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->op == b->op)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count, MPI_Datatype datatype, MPI_Op op,
                               struct ompi_communicator_t *comm, ompi_request_t ** request,
                               mca_coll_base_module_t *module, bool persistent)
@@ -69,9 +50,7 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
   ptrdiff_t ext, lb;
   NBC_Schedule *schedule;
   size_t size;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Allreduce_args *args, *found, search;
-#endif
+  NBC_Schedule_key key;
   enum { NBC_ARED_BINOMIAL, NBC_ARED_RING, NBC_ARED_REDSCAT_ALLGATHER, NBC_ARED_RDBL } alg;
   char inplace;
   void *tmpbuf = NULL;
@@ -131,16 +110,16 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
     else if (libnbc_iallreduce_algorithm == 4)
       alg = NBC_ARED_RDBL;
   }
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.recvbuf = recvbuf;
-  search.count = count;
-  search.datatype = datatype;
-  search.op = op;
-  found = (NBC_Allreduce_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE], &search);
-  if (NULL == found) {
-#endif
+  NBC_Schedule_key_init (&key, NBC_ALLREDUCE, alg, 0, inplace, persistent);
+  key.count[0] = count;
+  key.dtype[0] = datatype;
+  key.op = op;
+  schedule = NBC_Schedule_cache_find (libnbc_module, &key);
+  if (NULL == schedule) {
+    const void *sched_sbuf = sendbuf;
+    void *sched_rbuf = recvbuf, *sched_tmpbuf = tmpbuf;
+    bool cache = NBC_Schedule_template_bufs (&sched_sbuf, &sched_rbuf, &sched_tmpbuf, inplace);
+
     schedule = OBJ_NEW(NBC_Schedule);
     if (NULL == schedule) {
       free(tmpbuf);
@@ -148,21 +127,21 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
     }
 
     if (p == 1) {
-      res = NBC_Sched_copy((void *)sendbuf, false, count, datatype,
-                           recvbuf, false, count, datatype, schedule, false);
+      res = NBC_Sched_copy((void *)sched_sbuf, false, count, datatype,
+                           sched_rbuf, false, count, datatype, schedule, false);
     } else {
       switch(alg) {
         case NBC_ARED_BINOMIAL:
-          res = allred_sched_diss(rank, p, count, datatype, gap, sendbuf, recvbuf, op, inplace, schedule, tmpbuf);
+          res = allred_sched_diss(rank, p, count, datatype, gap, sched_sbuf, sched_rbuf, op, inplace, schedule, sched_tmpbuf);
           break;
         case NBC_ARED_REDSCAT_ALLGATHER:
-          res = allred_sched_redscat_allgather(rank, p, count, datatype, gap, sendbuf, recvbuf, op, inplace, schedule, tmpbuf, comm);
+          res = allred_sched_redscat_allgather(rank, p, count, datatype, gap, sched_sbuf, sched_rbuf, op, inplace, schedule, sched_tmpbuf, comm);
           break;
         case NBC_ARED_RING:
-          res = allred_sched_ring(rank, p, count, datatype, sendbuf, recvbuf, op, size, ext, schedule, tmpbuf);
+          res = allred_sched_ring(rank, p, count, datatype, sched_sbuf, sched_rbuf, op, size, ext, schedule, sched_tmpbuf);
           break;
         case NBC_ARED_RDBL:
-          res = allred_sched_recursivedoubling(rank, p, sendbuf, recvbuf, count, datatype, gap, op, inplace, schedule, tmpbuf);
+          res = allred_sched_recursivedoubling(rank, p, sched_sbuf, sched_rbuf, count, datatype, gap, op, inplace, schedule, sched_tmpbuf);
           break;
       }
     }
@@ -180,38 +159,13 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Allreduce_args *) malloc (sizeof(args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->recvbuf = recvbuf;
-      args->count = count;
-      args->datatype = datatype;
-      args->op = op;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_ALLREDUCE] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE],
-                                   &libnbc_module->NBC_Dict_size[NBC_ALLREDUCE]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
+    if (cache) {
+      NBC_Schedule_cache_insert (libnbc_module, &key, schedule);
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
   }
-#endif
 
-  res = NBC_Schedule_request (schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_bufs (schedule, comm, libnbc_module, persistent, request, tmpbuf,
+                                   sendbuf, recvbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -33,26 +33,6 @@ static inline int a2a_sched_diss(int rank, int p, MPI_Aint sndext, MPI_Aint rcve
 static inline int a2a_sched_inplace(int rank, int p, NBC_Schedule* schedule, void* buf, size_t count,
                                    MPI_Datatype type, MPI_Aint ext, ptrdiff_t gap, MPI_Comm comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Alltoall_args_compare(NBC_Alltoall_args *a, NBC_Alltoall_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 /* simple linear MPI_Ialltoall the (simple) algorithm just sends to all nodes */
 static int nbc_alltoall_init(const void* sendbuf, size_t sendcount, MPI_Datatype sendtype, void* recvbuf, size_t recvcount,
                              MPI_Datatype recvtype, struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -63,9 +43,7 @@ static int nbc_alltoall_init(const void* sendbuf, size_t sendcount, MPI_Datatype
   size_t a2asize, sndsize;
   NBC_Schedule *schedule;
   MPI_Aint rcvext, sndext;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Alltoall_args *args, *found, search;
-#endif
+  NBC_Schedule_key key;
   char *rbuf, *sbuf, inplace;
   enum {NBC_A2A_LINEAR, NBC_A2A_PAIRWISE, NBC_A2A_DISS, NBC_A2A_INPLACE} alg;
   void *tmpbuf = NULL;
@@ -188,17 +166,17 @@ static int nbc_alltoall_init(const void* sendbuf, size_t sendcount, MPI_Datatype
     }
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  found = (NBC_Alltoall_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLTOALL], &search);
-  if (NULL == found) {
-#endif
+  NBC_Schedule_key_init (&key, NBC_ALLTOALL, alg, 0, inplace, persistent);
+  key.count[0] = sendcount;
+  key.dtype[0] = sendtype;
+  key.count[1] = recvcount;
+  key.dtype[1] = recvtype;
+  schedule = NBC_Schedule_cache_find (libnbc_module, &key);
+  if (NULL == schedule) {
+    const void *sched_sbuf = sendbuf;
+    void *sched_rbuf = recvbuf, *sched_tmpbuf = tmpbuf;
+    bool cache = NBC_Schedule_template_bufs (&sched_sbuf, &sched_rbuf, &sched_tmpbuf, inplace);
+
     /* not found - generate new schedule */
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
@@ -208,8 +186,8 @@ static int nbc_alltoall_init(const void* sendbuf, size_t sendcount, MPI_Datatype
 
     if (!inplace) {
       /* copy my data to receive buffer */
-      rbuf = (char *) recvbuf + (MPI_Aint)rank * (MPI_Aint)recvcount * rcvext;
-      sbuf = (char *) sendbuf + (MPI_Aint)rank * (MPI_Aint)sendcount * sndext;
+      rbuf = (char *) sched_rbuf + (MPI_Aint)rank * (MPI_Aint)recvcount * rcvext;
+      sbuf = (char *) sched_sbuf + (MPI_Aint)rank * (MPI_Aint)sendcount * sndext;
       res = NBC_Sched_copy (sbuf, false, sendcount, sendtype,
                             rbuf, false, recvcount, recvtype, schedule, false);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -221,16 +199,16 @@ static int nbc_alltoall_init(const void* sendbuf, size_t sendcount, MPI_Datatype
 
     switch(alg) {
       case NBC_A2A_INPLACE:
-        res = a2a_sched_inplace(rank, p, schedule, recvbuf, recvcount, recvtype, rcvext, gap, comm);
+        res = a2a_sched_inplace(rank, p, schedule, sched_rbuf, recvcount, recvtype, rcvext, gap, comm);
         break;
       case NBC_A2A_LINEAR:
-        res = a2a_sched_linear(rank, p, sndext, rcvext, schedule, sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+        res = a2a_sched_linear(rank, p, sndext, rcvext, schedule, sched_sbuf, sendcount, sendtype, sched_rbuf, recvcount, recvtype, comm);
         break;
       case NBC_A2A_DISS:
-        res = a2a_sched_diss(rank, p, sndext, rcvext, schedule, sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm, tmpbuf);
+        res = a2a_sched_diss(rank, p, sndext, rcvext, schedule, sched_sbuf, sendcount, sendtype, sched_rbuf, recvcount, recvtype, comm, sched_tmpbuf);
         break;
       case NBC_A2A_PAIRWISE:
-        res = a2a_sched_pairwise(rank, p, sndext, rcvext, schedule, sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+        res = a2a_sched_pairwise(rank, p, sndext, rcvext, schedule, sched_sbuf, sendcount, sendtype, sched_rbuf, recvcount, recvtype, comm);
         break;
     }
 
@@ -247,39 +225,13 @@ static int nbc_alltoall_init(const void* sendbuf, size_t sendcount, MPI_Datatype
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Alltoall_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->sendcount = sendcount;
-      args->sendtype = sendtype;
-      args->recvbuf = recvbuf;
-      args->recvcount = recvcount;
-      args->recvtype = recvtype;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLTOALL], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_ALLTOALL] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLTOALL],
-                                   &libnbc_module->NBC_Dict_size[NBC_ALLTOALL]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
+    if (cache) {
+      NBC_Schedule_cache_insert (libnbc_module, &key, schedule);
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_bufs(schedule, comm, libnbc_module, persistent, request, tmpbuf,
+                                  sendbuf, recvbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
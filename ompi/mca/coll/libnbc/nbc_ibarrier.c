@@ -27,19 +27,18 @@ static int nbc_barrier_init(struct ompi_communicator_t *comm, ompi_request_t **
 {
   int rank, p, maxround, res, recvpeer, sendpeer;
   NBC_Schedule *schedule;
+  NBC_Schedule_key key;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
   rank = ompi_comm_rank (comm);
   p = ompi_comm_size (comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* there only one argument set per communicator -> hang it directly at
-   * the tree-position, NBC_Dict_size[...] is 0 for not initialized and
-   * 1 for initialized. NBC_Dict[...] is a pointer to the schedule in
-   * this case */
-  if (libnbc_module->NBC_Dict_size[NBC_BARRIER] == 0) {
-    /* we did not init it yet */
-#endif
+  /* there is only one barrier schedule per communicator */
+  NBC_Schedule_key_init (&key, NBC_BARRIER, 0, 0, false, persistent);
+  schedule = NBC_Schedule_cache_find (libnbc_module, &key);
+  if (NULL == schedule) {
+    bool cache = NBC_Schedule_cache_enabled ();
+
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -82,13 +81,10 @@ static int nbc_barrier_init(struct ompi_communicator_t *comm, ompi_request_t **
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* add it */
-    libnbc_module->NBC_Dict[NBC_BARRIER] = (hb_tree *) schedule;
-    libnbc_module->NBC_Dict_size[NBC_BARRIER] = 1;
+    if (cache) {
+      NBC_Schedule_cache_insert (libnbc_module, &key, schedule);
+    }
   }
-  OBJ_RETAIN(schedule);
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -23,27 +23,6 @@
  */
 #include "nbc_internal.h"
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Gather_args_compare(NBC_Gather_args *a, NBC_Gather_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype) &&
-      (a->root == b->root)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_gather_init(const void* sendbuf, size_t sendcount, MPI_Datatype sendtype, void* recvbuf,
                            size_t recvcount, MPI_Datatype recvtype, int root,
                            struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -51,6 +30,7 @@ static int nbc_gather_init(const void* sendbuf, size_t sendcount, MPI_Datatype s
   int rank, p, res;
   MPI_Aint rcvext = 0;
   NBC_Schedule *schedule;
+  NBC_Schedule_key key;
   char *rbuf, inplace = 0;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -73,21 +53,17 @@ static int nbc_gather_init(const void* sendbuf, size_t sendcount, MPI_Datatype s
     sendtype = recvtype;
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Gather_args *args, *found, search;
+  NBC_Schedule_key_init (&key, NBC_GATHER, 0, root, inplace, persistent);
+  key.count[0] = sendcount;
+  key.dtype[0] = sendtype;
+  key.count[1] = recvcount;
+  key.dtype[1] = recvtype;
+  schedule = NBC_Schedule_cache_find (libnbc_module, &key);
+  if (NULL == schedule) {
+    const void *sched_sbuf = sendbuf;
+    void *sched_rbuf = recvbuf;
+    bool cache = NBC_Schedule_template_bufs (&sched_sbuf, &sched_rbuf, NULL, inplace);
 
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  search.root = root;
-  found = (NBC_Gather_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER],
-                                              &search);
-  if (NULL == found) {
-#endif
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -96,18 +72,18 @@ static int nbc_gather_init(const void* sendbuf, size_t sendcount, MPI_Datatype s
     /* send to root */
     if (rank != root) {
       /* send msg to root */
-      res = NBC_Sched_send(sendbuf, false, sendcount, sendtype, root, schedule, false);
+      res = NBC_Sched_send(sched_sbuf, false, sendcount, sendtype, root, schedule, false);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         return res;
       }
     } else {
       for (int i = 0 ; i < p ; ++i) {
-        rbuf = (char *)recvbuf + (MPI_Aint) rcvext * i * recvcount;
+        rbuf = (char *)sched_rbuf + (MPI_Aint) rcvext * i * recvcount;
         if (i == root) {
           if (!inplace) {
             /* if I am the root - just copy the message */
-            res = NBC_Sched_copy ((void *)sendbuf, false, sendcount, sendtype,
+            res = NBC_Sched_copy ((void *)sched_sbuf, false, sendcount, sendtype,
                                   rbuf, false, recvcount, recvtype, schedule, false);
             if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
               OBJ_RELEASE(schedule);
@@ -131,40 +107,13 @@ static int nbc_gather_init(const void* sendbuf, size_t sendcount, MPI_Datatype s
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Gather_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->sendcount = sendcount;
-      args->sendtype = sendtype;
-      args->recvbuf = recvbuf;
-      args->recvcount = recvcount;
-      args->recvtype = recvtype;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_GATHER] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER],
-                                   &libnbc_module->NBC_Dict_size[NBC_GATHER]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
+    if (cache) {
+      NBC_Schedule_cache_insert (libnbc_module, &key, schedule);
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_bufs (schedule, comm, libnbc_module, persistent, request, NULL,
+                                   sendbuf, recvbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -44,7 +44,6 @@
 #include <assert.h>
 #include <math.h>
 #include <string.h>
-#include "libdict/dict.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -167,112 +166,83 @@ int NBC_Sched_unpack (void *inbuf, char tmpinbuf, size_t count, MPI_Datatype dat
 int NBC_Sched_barrier (NBC_Schedule *schedule);
 int NBC_Sched_commit (NBC_Schedule *schedule);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* this is a dummy structure which is used to get the schedule out of
- * the collop specific structure. The schedule pointer HAS to be at the
- * first position and should NOT BE REORDERED by the compiler (C
- * guarantees that */
-struct NBC_dummyarg {
-  NBC_Schedule *schedule;
-};
+/* where the address of a buffer in a schedule points to */
+#define NBC_BUF_ABS  0 /* absolute address */
+#define NBC_BUF_TMP  1 /* offset into the temporary buffer of the handle */
+#define NBC_BUF_SEND 2 /* offset from the send buffer of the handle */
+#define NBC_BUF_RECV 3 /* offset from the receive buffer of the handle */
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  size_t sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  size_t recvcount;
-  MPI_Datatype recvtype;
-} NBC_Alltoall_args;
-int NBC_Alltoall_args_compare(NBC_Alltoall_args *a, NBC_Alltoall_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  size_t sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  size_t recvcount;
-  MPI_Datatype recvtype;
-} NBC_Allgather_args;
-int NBC_Allgather_args_compare(NBC_Allgather_args *a, NBC_Allgather_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  size_t count;
-  MPI_Datatype datatype;
-  MPI_Op op;
-} NBC_Allreduce_args;
-int NBC_Allreduce_args_compare(NBC_Allreduce_args *a, NBC_Allreduce_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *buffer;
-  size_t count;
-  MPI_Datatype datatype;
-  int root;
-} NBC_Bcast_args;
-int NBC_Bcast_args_compare(NBC_Bcast_args *a, NBC_Bcast_args *b, void *param);
+/* Schedule templates
+ *
+ * A cacheable schedule is built against placeholder buffers instead of
+ * the user buffers. NBC_Schedule_cache_insert() turns every address
+ * inside one of the placeholder windows into an offset from the send,
+ * receive or temporary buffer of the handle, so the cached schedule can
+ * be started on any set of buffers. The windows are far away from user
+ * space addresses and larger than any buffer, so templates are only
+ * used where pointers are 64 bits wide. */
+#if SIZEOF_VOID_P >= 8
+#define NBC_SCHED_TEMPLATES 1
+#define NBC_TEMPLATE_WINDOW ((uintptr_t) 1 << 60)
+#else
+#define NBC_SCHED_TEMPLATES 0
+#define NBC_TEMPLATE_WINDOW ((uintptr_t) 1 << 28)
+#endif
+#define NBC_TEMPLATE_SENDBUF ((void *) (4 * NBC_TEMPLATE_WINDOW))
+#define NBC_TEMPLATE_RECVBUF ((void *) (8 * NBC_TEMPLATE_WINDOW))
+#define NBC_TEMPLATE_TMPBUF  ((void *) (12 * NBC_TEMPLATE_WINDOW))
+
+static inline void NBC_Schedule_key_init(NBC_Schedule_key *key, int coll, int alg, int root,
+                                         bool inplace, bool persistent) {
+  memset (key, 0, sizeof (*key));
+  key->coll = coll;
+  key->alg = alg;
+  key->root = root;
+  key->inplace = inplace;
+  key->persistent = persistent;
+}
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  size_t sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  size_t recvcount;
-  MPI_Datatype recvtype;
-  int root;
-} NBC_Gather_args;
-int NBC_Gather_args_compare(NBC_Gather_args *a, NBC_Gather_args *b, void *param);
+/* returns true if schedules are cached. the caller then builds the
+ * schedule against the template buffers and inserts it in the cache */
+static inline bool NBC_Schedule_cache_enabled(void) {
+  return NBC_SCHED_TEMPLATES && mca_coll_libnbc_component.schedule_cache_size > 0;
+}
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  size_t count;
-  MPI_Datatype datatype;
-  MPI_Op op;
-  int root;
-} NBC_Reduce_args;
-int NBC_Reduce_args_compare(NBC_Reduce_args *a, NBC_Reduce_args *b, void *param);
+/* if schedules are cached, replace the buffers a schedule is about to be
+ * built against by the template placeholders and return true. in place
+ * operations use the receive buffer for both. any argument may be NULL */
+static inline bool NBC_Schedule_template_bufs(const void **sendbuf, void **recvbuf, void **tmpbuf,
+                                              bool inplace) {
+  if (!NBC_Schedule_cache_enabled()) {
+    return false;
+  }
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  size_t count;
-  MPI_Datatype datatype;
-  MPI_Op op;
-} NBC_Scan_args;
-int NBC_Scan_args_compare(NBC_Scan_args *a, NBC_Scan_args *b, void *param);
+  if (NULL != sendbuf) {
+    *sendbuf = inplace ? NBC_TEMPLATE_RECVBUF : NBC_TEMPLATE_SENDBUF;
+  }
+  if (NULL != recvbuf) {
+    *recvbuf = NBC_TEMPLATE_RECVBUF;
+  }
+  if (NULL != tmpbuf) {
+    *tmpbuf = NBC_TEMPLATE_TMPBUF;
+  }
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  size_t sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  size_t recvcount;
-  MPI_Datatype recvtype;
-  int root;
-} NBC_Scatter_args;
-int NBC_Scatter_args_compare(NBC_Scatter_args *a, NBC_Scatter_args *b, void *param);
-
-/* Schedule cache structures/functions */
-void NBC_SchedCache_args_delete(void *entry);
-void NBC_SchedCache_args_delete_key_dummy(void *k);
+  return true;
+}
 
-#endif
+NBC_Schedule *NBC_Schedule_cache_find(ompi_coll_libnbc_module_t *module, const NBC_Schedule_key *key);
+void NBC_Schedule_cache_insert(ompi_coll_libnbc_module_t *module, const NBC_Schedule_key *key,
+                               NBC_Schedule *schedule);
 
 
 int NBC_Start(NBC_Handle *handle);
 int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
                          ompi_coll_libnbc_module_t *module, bool persistent,
                          ompi_request_t **request, void *tmpbuf);
+int NBC_Schedule_request_bufs(NBC_Schedule *schedule, ompi_communicator_t *comm,
+                              ompi_coll_libnbc_module_t *module, bool persistent,
+                              ompi_request_t **request, void *tmpbuf,
+                              const void *sendbuf, void *recvbuf);
 void NBC_Return_handle(ompi_coll_libnbc_request_t *request);
 static inline int NBC_Type_intrinsic(MPI_Datatype type);
 int NBC_Create_fortran_handle(int *fhandle, NBC_Handle **handle);
@@ -565,18 +535,6 @@ static inline int NBC_Unpack(void *src, size_t srccount, MPI_Datatype srctype, v
   return OMPI_SUCCESS;
 }
 
-/* deletes elements from dict_in until low watermark is reached */
-static inline void NBC_SchedCache_dictwipe(hb_tree *dict_in, int *size) {
-  hb_itor *itor;
-
-  itor = ompi_coll_libnbc_hb_itor_new(dict_in);
-  for (; ompi_coll_libnbc_hb_itor_valid(itor) && (*size>NBC_SCHED_DICT_LOWER); ompi_coll_libnbc_hb_itor_next(itor)) {
-    ompi_coll_libnbc_hb_tree_remove(dict_in, ompi_coll_libnbc_hb_itor_key(itor), 0);
-    *size = *size-1;
-  }
-  ompi_coll_libnbc_hb_itor_destroy(itor);
-}
-
 #define NBC_IN_PLACE(sendbuf, recvbuf, inplace) \
 { \
   inplace = 0; \
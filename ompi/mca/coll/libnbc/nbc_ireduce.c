@@ -38,26 +38,6 @@ static inline int red_sched_redscat_gather(
     char tmpredbuf, size_t count, MPI_Datatype datatype, MPI_Op op, char inplace,
     NBC_Schedule *schedule, void *tmp_buf, struct ompi_communicator_t *comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Reduce_args_compare(NBC_Reduce_args *a, NBC_Reduce_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->op == b->op) &&
-      (a->root == b->root)) {
-    return 0;
-  }
-
-  if (a->sendbuf < b->sendbuf) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 /* the non-blocking reduce */
 static int nbc_reduce_init(const void* sendbuf, void* recvbuf, size_t count, MPI_Datatype datatype,
                            MPI_Op op, int root, struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -66,6 +46,7 @@ static int nbc_reduce_init(const void* sendbuf, void* recvbuf, size_t count, MPI
   size_t size;
   MPI_Aint ext;
   NBC_Schedule *schedule;
+  NBC_Schedule_key key;
   char *redbuf=NULL, inplace;
   void *tmpbuf;
   char tmpredbuf = 0;
@@ -147,19 +128,18 @@ static int nbc_reduce_init(const void* sendbuf, void* recvbuf, size_t count, MPI
     return OMPI_ERR_OUT_OF_RESOURCE;
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Reduce_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.recvbuf = recvbuf;
-  search.count = count;
-  search.datatype = datatype;
-  search.op = op;
-  search.root = root;
-  found = (NBC_Reduce_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_REDUCE], &search);
-  if (NULL == found) {
-#endif
+  NBC_Schedule_key_init (&key, NBC_REDUCE, alg, root, inplace, persistent);
+  key.count[0] = count;
+  key.dtype[0] = datatype;
+  key.op = op;
+  schedule = NBC_Schedule_cache_find (libnbc_module, &key);
+  if (NULL == schedule) {
+    const void *sched_sbuf = sendbuf;
+    void *sched_rbuf = recvbuf, *sched_tmpbuf = tmpbuf;
+    bool cache = NBC_Schedule_template_bufs (&sched_sbuf, &sched_rbuf, &sched_tmpbuf, inplace);
+    /* the root reduces in the receive buffer, everybody else in tmpbuf */
+    void *sched_redbuf = tmpredbuf ? redbuf : sched_rbuf;
+
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       free(tmpbuf);
@@ -167,18 +147,18 @@ static int nbc_reduce_init(const void* sendbuf, void* recvbuf, size_t count, MPI
     }
 
     if (p == 1) {
-      res = NBC_Sched_copy ((void *)sendbuf, false, count, datatype,
-                            recvbuf, false, count, datatype, schedule, false);
+      res = NBC_Sched_copy ((void *)sched_sbuf, false, count, datatype,
+                            sched_rbuf, false, count, datatype, schedule, false);
     } else {
       switch(alg) {
         case NBC_RED_BINOMIAL:
-          res = red_sched_binomial(rank, p, root, sendbuf, redbuf, tmpredbuf, count, datatype, op, inplace, schedule, tmpbuf);
+          res = red_sched_binomial(rank, p, root, sched_sbuf, sched_redbuf, tmpredbuf, count, datatype, op, inplace, schedule, sched_tmpbuf);
           break;
         case NBC_RED_CHAIN:
-          res = red_sched_chain(rank, p, root, sendbuf, recvbuf, count, datatype, op, ext, size, schedule, tmpbuf, segsize);
+          res = red_sched_chain(rank, p, root, sched_sbuf, sched_rbuf, count, datatype, op, ext, size, schedule, sched_tmpbuf, segsize);
           break;
         case NBC_RED_REDSCAT_GATHER:
-          res = red_sched_redscat_gather(rank, p, root, sendbuf, redbuf, tmpredbuf, count, datatype, op, inplace, schedule, tmpbuf, comm);
+          res = red_sched_redscat_gather(rank, p, root, sched_sbuf, sched_redbuf, tmpredbuf, count, datatype, op, inplace, schedule, sched_tmpbuf, comm);
           break;
       }
     }
@@ -195,39 +175,14 @@ static int nbc_reduce_init(const void* sendbuf, void* recvbuf, size_t count, MPI
       free(tmpbuf);
       return res;
     }
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Reduce_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->recvbuf = recvbuf;
-      args->count = count;
-      args->datatype = datatype;
-      args->op = op;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_REDUCE], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for Reduce */
-        if (++libnbc_module->NBC_Dict_size[NBC_REDUCE] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_REDUCE],
-                                   &libnbc_module->NBC_Dict_size[NBC_REDUCE]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
+
+    if (cache) {
+      NBC_Schedule_cache_insert (libnbc_module, &key, schedule);
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_bufs (schedule, comm, libnbc_module, persistent, request, tmpbuf,
+                                   sendbuf, recvbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
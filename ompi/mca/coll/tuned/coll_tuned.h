@@ -23,10 +23,12 @@
 #include "ompi/mca/mca.h"
 #include "ompi/request/request.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
+#include "opal/mca/base/mca_base_event.h"
 #include "opal/util/output.h"
 
 /* also need the dynamic rule structures */
 #include "coll_tuned_dynamic_rules.h"
+#include "coll_tuned_online.h"
 
 BEGIN_C_DECLS
 
@@ -39,10 +41,15 @@ extern int   ompi_coll_tuned_init_tree_fanout;
 extern int   ompi_coll_tuned_init_chain_fanout;
 extern int   ompi_coll_tuned_init_max_requests;
 extern int   ompi_coll_tuned_alltoall_max_requests;
+extern int   ompi_coll_tuned_alltoallv_max_requests;
 extern int   ompi_coll_tuned_scatter_intermediate_msg;
 extern int   ompi_coll_tuned_scatter_large_msg;
 extern int   ompi_coll_tuned_scatter_min_procs;
 extern int   ompi_coll_tuned_scatter_blocking_send_ratio;
+extern bool  ompi_coll_tuned_online_selection;
+extern int   ompi_coll_tuned_online_trials;
+extern int   ompi_coll_tuned_online_reexplore;
+extern int   ompi_coll_tuned_online_segsize;
 
 /* forced algorithm choices */
 /* this structure is for storing the indexes to the forced algorithm mca params... */
@@ -74,6 +81,30 @@ extern coll_tuned_force_algorithm_mca_param_indices_t ompi_coll_tuned_forced_par
 /* the actual max algorithm values (readonly), loaded at component open */
 extern int ompi_coll_tuned_forced_max_algorithms[COLLCOUNT];
 
+/* data of the algorithm_selected MPI_T event */
+struct ompi_coll_tuned_algorithm_event_t {
+    int32_t collective;  /* COLLTYPE_T */
+    int32_t algorithm;
+    int32_t segsize;
+};
+typedef struct ompi_coll_tuned_algorithm_event_t ompi_coll_tuned_algorithm_event_t;
+
+extern mca_base_event_t *ompi_coll_tuned_algorithm_event;
+
+/* raise the algorithm_selected event. algorithm 0 defers to the fixed
+ * decision which selects again */
+static inline void ompi_coll_tuned_algorithm_selected(struct ompi_communicator_t *comm,
+                                                      COLLTYPE_T collective, int algorithm,
+                                                      int segsize)
+{
+    if (OPAL_UNLIKELY(ompi_coll_tuned_algorithm_event->active) && 0 != algorithm) {
+        ompi_coll_tuned_algorithm_event_t data = {.collective = collective,
+                                                  .algorithm = algorithm,
+                                                  .segsize = segsize};
+        mca_base_event_record(ompi_coll_tuned_algorithm_event, comm, &data);
+    }
+}
+
 /*
  * coll API functions
  */
@@ -98,6 +129,7 @@ ompi_coll_tuned_comm_query(struct ompi_communicator_t *comm, int *priority);
 /* All Gather */
 int ompi_coll_tuned_allgather_intra_dec_fixed(ALLGATHER_ARGS);
 int ompi_coll_tuned_allgather_intra_dec_dynamic(ALLGATHER_ARGS);
+int ompi_coll_tuned_allgather_intra_dec_online(ALLGATHER_ARGS);
 int ompi_coll_tuned_allgather_intra_do_this(ALLGATHER_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_allgather_intra_check_forced_init(coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
@@ -110,30 +142,40 @@ int ompi_coll_tuned_allgatherv_intra_check_forced_init(coll_tuned_force_algorith
 /* All Reduce */
 int ompi_coll_tuned_allreduce_intra_dec_fixed(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_intra_dec_dynamic(ALLREDUCE_ARGS);
+int ompi_coll_tuned_allreduce_intra_dec_online(ALLREDUCE_ARGS);
+int ompi_coll_tuned_allreduce_intra_fixed_alg(size_t count, struct ompi_datatype_t *dtype, struct ompi_op_t *op, struct ompi_communicator_t *comm);
+int ompi_coll_tuned_allreduce_init_intra_dec(ALLREDUCE_INIT_ARGS);
 int ompi_coll_tuned_allreduce_intra_do_this(ALLREDUCE_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
 /* AlltoAll */
 int ompi_coll_tuned_alltoall_intra_dec_fixed(ALLTOALL_ARGS);
 int ompi_coll_tuned_alltoall_intra_dec_dynamic(ALLTOALL_ARGS);
+int ompi_coll_tuned_alltoall_intra_dec_online(ALLTOALL_ARGS);
 int ompi_coll_tuned_alltoall_intra_do_this(ALLTOALL_ARGS, int algorithm, int faninout, int segsize, int max_requests);
 int ompi_coll_tuned_alltoall_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
 /* AlltoAllV */
 int ompi_coll_tuned_alltoallv_intra_dec_fixed(ALLTOALLV_ARGS);
 int ompi_coll_tuned_alltoallv_intra_dec_dynamic(ALLTOALLV_ARGS);
-int ompi_coll_tuned_alltoallv_intra_do_this(ALLTOALLV_ARGS, int algorithm);
+int ompi_coll_tuned_alltoallv_intra_do_this(ALLTOALLV_ARGS, int algorithm, int max_requests);
 int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
 /* Barrier */
 int ompi_coll_tuned_barrier_intra_dec_fixed(BARRIER_ARGS);
 int ompi_coll_tuned_barrier_intra_dec_dynamic(BARRIER_ARGS);
+int ompi_coll_tuned_barrier_intra_dec_online(BARRIER_ARGS);
+int ompi_coll_tuned_barrier_intra_fixed_alg(struct ompi_communicator_t *comm);
+int ompi_coll_tuned_barrier_init_intra_dec(BARRIER_INIT_ARGS);
 int ompi_coll_tuned_barrier_intra_do_this(BARRIER_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_barrier_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
 /* Bcast */
 int ompi_coll_tuned_bcast_intra_dec_fixed(BCAST_ARGS);
 int ompi_coll_tuned_bcast_intra_dec_dynamic(BCAST_ARGS);
+int ompi_coll_tuned_bcast_intra_dec_online(BCAST_ARGS);
+int ompi_coll_tuned_bcast_intra_fixed_alg(size_t count, struct ompi_datatype_t *datatype, struct ompi_communicator_t *comm);
+int ompi_coll_tuned_bcast_init_intra_dec(BCAST_INIT_ARGS);
 int ompi_coll_tuned_bcast_intra_do_this(BCAST_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_bcast_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
@@ -146,6 +188,9 @@ int ompi_coll_tuned_gather_intra_check_forced_init (coll_tuned_force_algorithm_m
 /* Reduce */
 int ompi_coll_tuned_reduce_intra_dec_fixed(REDUCE_ARGS);
 int ompi_coll_tuned_reduce_intra_dec_dynamic(REDUCE_ARGS);
+int ompi_coll_tuned_reduce_intra_dec_online(REDUCE_ARGS);
+int ompi_coll_tuned_reduce_intra_fixed_alg(size_t count, struct ompi_datatype_t *datatype, struct ompi_op_t *op, struct ompi_communicator_t *comm);
+int ompi_coll_tuned_reduce_init_intra_dec(REDUCE_INIT_ARGS);
 int ompi_coll_tuned_reduce_intra_do_this(REDUCE_ARGS, int algorithm, int faninout, int segsize, int max_oustanding_reqs);
 int ompi_coll_tuned_reduce_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
@@ -158,6 +203,7 @@ int ompi_coll_tuned_reduce_scatter_intra_check_forced_init (coll_tuned_force_alg
 /* Reduce_scatter_block */
 int ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_tuned_reduce_scatter_block_intra_dec_dynamic(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_tuned_reduce_scatter_block_intra_dec_online(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_tuned_reduce_scatter_block_intra_do_this(REDUCESCATTERBLOCK_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_reduce_scatter_block_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
@@ -212,6 +258,9 @@ struct mca_coll_tuned_module_t {
 
     /* the communicator rules for each MPI collective for ONLY my comsize */
     ompi_coll_com_rule_t *com_rules[COLLCOUNT];
+
+    /* online selection state, for the collectives that use it */
+    ompi_coll_tuned_online_t *online[COLLCOUNT];
 };
 typedef struct mca_coll_tuned_module_t mca_coll_tuned_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_tuned_module_t);
@@ -135,6 +135,8 @@ int ompi_coll_tuned_allgather_intra_do_this(const void *sbuf, size_t scount,
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:allgather_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
+    ompi_coll_tuned_algorithm_selected(comm, ALLGATHER, algorithm, segsize);
+
     switch (algorithm) {
     case (0):
         return ompi_coll_tuned_allgather_intra_dec_fixed(sbuf, scount, sdtype,
@@ -136,6 +136,8 @@ int ompi_coll_tuned_allgatherv_intra_do_this(const void *sbuf, size_t scount,
                  "coll:tuned:allgatherv_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    ompi_coll_tuned_algorithm_selected(comm, ALLGATHERV, algorithm, segsize);
+
     switch (algorithm) {
     case (0):
         return ompi_coll_tuned_allgatherv_intra_dec_fixed(sbuf, scount, sdtype,
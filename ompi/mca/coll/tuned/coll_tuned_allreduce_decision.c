@@ -18,6 +18,7 @@
 #include "opal/util/bit_ops.h"
 #include "ompi/constants.h"
 #include "ompi/datatype/ompi_datatype.h"
+#include "ompi/datatype/ompi_datatype_internal.h"
 #include "ompi/communicator/communicator.h"
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/coll_tags.h"
@@ -32,6 +33,7 @@ static int coll_tuned_allreduce_forced_algorithm = 0;
 static int coll_tuned_allreduce_segment_size = 0;
 static int coll_tuned_allreduce_tree_fanout;
 static int coll_tuned_allreduce_chain_fanout;
+static bool coll_tuned_allreduce_fp32_accumulate = false;
 
 /* valid values for coll_tuned_allreduce_forced_algorithm */
 static const mca_base_var_enum_value_t allreduce_algorithms[] = {
@@ -43,6 +45,9 @@ static const mca_base_var_enum_value_t allreduce_algorithms[] = {
     {5, "segmented_ring"},
     {6, "rabenseifner"},
     {7, "allgather_reduce"},
+    {8, "recursive_multiplying"},
+    {9, "knomial_rabenseifner"},
+    {10, "tree_pipelined"},
     {0, NULL}
 };
 
@@ -78,7 +83,7 @@ int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorith
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allreduce_algorithm",
-                                        "Which allreduce algorithm is used. Can be locked down to any of: 0 ignore, 1 basic linear, 2 nonoverlapping (tuned reduce + tuned bcast), 3 recursive doubling, 4 ring, 5 segmented ring, 6 rabenseifner, 7 allgather_reduce. "
+                                        "Which allreduce algorithm is used. Can be locked down to any of: 0 ignore, 1 basic linear, 2 nonoverlapping (tuned reduce + tuned bcast), 3 recursive doubling, 4 ring, 5 segmented ring, 6 rabenseifner, 7 allgather_reduce, 8 recursive multiplying (radix is the tree fanout), 9 knomial rabenseifner (radix is the tree fanout), 10 pipelined binary tree. "
                                         "Only relevant if coll_tuned_use_dynamic_rules is true.",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
@@ -119,9 +124,83 @@ int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorith
                                       MCA_BASE_VAR_SCOPE_ALL,
                                       &coll_tuned_allreduce_chain_fanout);
 
+    coll_tuned_allreduce_fp32_accumulate = false;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "allreduce_fp32_accumulate",
+                                           "Sum and product of 16-bit floating point types (half precision short float and bfloat16) are accumulated in single precision: the data is converted to float before the allreduce and rounded once at the end, which doubles the volume of data exchanged.",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &coll_tuned_allreduce_fp32_accumulate);
+
     return (MPI_SUCCESS);
 }
 
+#if (defined(HAVE_SHORT_FLOAT) && (2 == SIZEOF_SHORT_FLOAT)) || \
+    (!defined(HAVE_SHORT_FLOAT) && defined(HAVE_OPAL_SHORT_FLOAT_T) && (2 == SIZEOF_OPAL_SHORT_FLOAT_T))
+#define COLL_TUNED_HAVE_HALF 1
+#if defined(HAVE_SHORT_FLOAT)
+typedef short float coll_tuned_half_t;
+#else
+typedef opal_short_float_t coll_tuned_half_t;
+#endif
+#endif
+
+/*
+ * Returns true if the elements of dtype can be accumulated in float for op:
+ * rounding once at the end differs from the native 16-bit operation only
+ * for sum and product.
+ */
+static bool allreduce_fp32_accumulate(struct ompi_datatype_t *dtype, struct ompi_op_t *op)
+{
+    if (!coll_tuned_allreduce_fp32_accumulate ||
+        (&ompi_mpi_op_sum.op != op && &ompi_mpi_op_prod.op != op)) {
+        return false;
+    }
+#if defined(COLL_TUNED_HAVE_HALF)
+    if (OMPI_DATATYPE_MPI_SHORT_FLOAT == dtype->id) {
+        return true;
+    }
+#endif
+    return OMPI_DATATYPE_MPI_BFLOAT16 == dtype->id;
+}
+
+static void allreduce_to_fp32(float *dst, const void *src, size_t count,
+                              struct ompi_datatype_t *dtype)
+{
+#if defined(COLL_TUNED_HAVE_HALF)
+    if (OMPI_DATATYPE_MPI_SHORT_FLOAT == dtype->id) {
+        const coll_tuned_half_t *h = (const coll_tuned_half_t *) src;
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = (float) h[i];
+        }
+        return;
+    }
+#endif
+    const uint16_t *b = (const uint16_t *) src;
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = ompi_op_bfloat16_to_float(b[i]);
+    }
+}
+
+static void allreduce_from_fp32(void *dst, const float *src, size_t count,
+                                struct ompi_datatype_t *dtype)
+{
+#if defined(COLL_TUNED_HAVE_HALF)
+    if (OMPI_DATATYPE_MPI_SHORT_FLOAT == dtype->id) {
+        coll_tuned_half_t *h = (coll_tuned_half_t *) dst;
+        for (size_t i = 0; i < count; i++) {
+            h[i] = (coll_tuned_half_t) src[i];
+        }
+        return;
+    }
+#endif
+    uint16_t *b = (uint16_t *) dst;
+    for (size_t i = 0; i < count; i++) {
+        b[i] = ompi_op_float_to_bfloat16(src[i]);
+    }
+}
+
 int ompi_coll_tuned_allreduce_intra_do_this(const void *sbuf, void *rbuf, size_t count,
                                             struct ompi_datatype_t *dtype,
                                             struct ompi_op_t *op,
@@ -132,6 +211,26 @@ int ompi_coll_tuned_allreduce_intra_do_this(const void *sbuf, void *rbuf, size_t
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:allreduce_intra_do_this algorithm %d topo fan in/out %d segsize %d",
                  algorithm, faninout, segsize));
 
+    /* Run the same algorithm on the single precision copy of the data */
+    if (count > 0 && allreduce_fp32_accumulate(dtype, op)) {
+        float *acc = (float *) malloc(count * sizeof(float));
+        int err;
+
+        if (NULL == acc) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        allreduce_to_fp32(acc, (MPI_IN_PLACE == sbuf) ? rbuf : sbuf, count, dtype);
+        err = ompi_coll_tuned_allreduce_intra_do_this(MPI_IN_PLACE, acc, count, MPI_FLOAT, op,
+                                                      comm, module, algorithm, faninout, segsize);
+        if (MPI_SUCCESS == err) {
+            allreduce_from_fp32(rbuf, acc, count, dtype);
+        }
+        free(acc);
+        return err;
+    }
+
+    ompi_coll_tuned_algorithm_selected(comm, ALLREDUCE, algorithm, segsize);
+
     switch (algorithm) {
     case (0):
         return ompi_coll_tuned_allreduce_intra_dec_fixed(sbuf, rbuf, count, dtype, op, comm, module);
@@ -149,6 +248,12 @@ int ompi_coll_tuned_allreduce_intra_do_this(const void *sbuf, void *rbuf, size_t
         return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype, op, comm, module);
     case (7):
         return ompi_coll_base_allreduce_intra_allgather_reduce(sbuf, rbuf, count, dtype, op, comm, module);
+    case (8):
+        return ompi_coll_base_allreduce_intra_recursive_multiplying(sbuf, rbuf, count, dtype, op, comm, module, faninout);
+    case (9):
+        return ompi_coll_base_allreduce_intra_knomial_redscat_allgather(sbuf, rbuf, count, dtype, op, comm, module, faninout);
+    case (10):
+        return ompi_coll_base_allreduce_intra_tree_pipelined(sbuf, rbuf, count, dtype, op, comm, module, segsize);
     } /* switch */
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:allreduce_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                  algorithm, ompi_coll_tuned_forced_max_algorithms[ALLREDUCE]));
@@ -33,6 +33,9 @@ static const mca_base_var_enum_value_t alltoallv_algorithms[] = {
     {0, "ignore"},
     {1, "basic_linear"},
     {2, "pairwise"},
+    {3, "sparse"},
+    {4, "scattered"},
+    {5, "node_aggregated"},
     {0, NULL}
 };
 
@@ -71,7 +74,8 @@ int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm
                                         "alltoallv_algorithm",
                                         "Which alltoallv algorithm is used. "
                                         "Can be locked down to choice of: 0 ignore, "
-                                        "1 basic linear, 2 pairwise. "
+                                        "1 basic linear, 2 pairwise, 3 sparse, 4 scattered, "
+                                        "5 node aggregated. "
                                         "Only relevant if coll_tuned_use_dynamic_rules is true.",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
@@ -83,6 +87,25 @@ int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm
         return mca_param_indices->algorithm_param_index;
     }
 
+    mca_param_indices->max_requests_param_index =
+      mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                      "alltoallv_algorithm_max_requests",
+                                      "Maximum number of outstanding send and of outstanding recv requests.  Only has meaning for the scattered algorithm, 0 using coll_tuned_init_max_requests.",
+                                      MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                      OPAL_INFO_LVL_5,
+                                      MCA_BASE_VAR_SCOPE_ALL,
+                                      &ompi_coll_tuned_alltoallv_max_requests);
+    if (mca_param_indices->max_requests_param_index < 0) {
+        return mca_param_indices->max_requests_param_index;
+    }
+
+    if (ompi_coll_tuned_alltoallv_max_requests < 0) {
+        if( 0 == ompi_comm_rank( MPI_COMM_WORLD ) ) {
+            opal_output( 0, "Maximum outstanding requests must be positive number greater than 1.  Switching to 0 \n");
+        }
+        ompi_coll_tuned_alltoallv_max_requests = 0;
+    }
+
     return (MPI_SUCCESS);
 }
 
@@ -94,11 +117,13 @@ int ompi_coll_tuned_alltoallv_intra_do_this(const void *sbuf, ompi_count_array_t
                                             struct ompi_datatype_t *rdtype,
                                             struct ompi_communicator_t *comm,
                                             mca_coll_base_module_t *module,
-                                            int algorithm)
+                                            int algorithm, int max_requests)
 {
     OPAL_OUTPUT((ompi_coll_tuned_stream,
-                 "coll:tuned:alltoallv_intra_do_this selected algorithm %d ",
-                 algorithm));
+                 "coll:tuned:alltoallv_intra_do_this selected algorithm %d max_requests %d",
+                 algorithm, max_requests));
+
+    ompi_coll_tuned_algorithm_selected(comm, ALLTOALLV, algorithm, 0);
 
     switch (algorithm) {
     case (0):
@@ -113,6 +138,21 @@ int ompi_coll_tuned_alltoallv_intra_do_this(const void *sbuf, ompi_count_array_t
         return ompi_coll_base_alltoallv_intra_pairwise(sbuf, scounts, sdisps, sdtype,
                                                        rbuf, rcounts, rdisps, rdtype,
                                                        comm, module);
+    case (3):
+        return ompi_coll_base_alltoallv_intra_sparse(sbuf, scounts, sdisps, sdtype,
+                                                     rbuf, rcounts, rdisps, rdtype,
+                                                     comm, module);
+    case (4):
+        if (0 >= max_requests) {
+            max_requests = ompi_coll_tuned_init_max_requests;
+        }
+        return ompi_coll_base_alltoallv_intra_scattered(sbuf, scounts, sdisps, sdtype,
+                                                        rbuf, rcounts, rdisps, rdtype,
+                                                        comm, module, max_requests);
+    case (5):
+        return ompi_coll_base_alltoallv_intra_node_aggregated(sbuf, scounts, sdisps, sdtype,
+                                                              rbuf, rcounts, rdisps, rdtype,
+                                                              comm, module);
     }  /* switch */
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:alltoall_intra_do_this attempt to select "
@@ -94,6 +94,8 @@ int ompi_coll_tuned_barrier_intra_do_this (struct ompi_communicator_t *comm,
                  "coll:tuned:barrier_intra_do_this selected algorithm %d topo fanin/out%d",
                  algorithm, faninout));
 
+    ompi_coll_tuned_algorithm_selected(comm, BARRIER, algorithm, segsize);
+
     switch (algorithm) {
     case (0):   return ompi_coll_tuned_barrier_intra_dec_fixed(comm, module);
     case (1):   return ompi_coll_base_barrier_intra_basic_linear(comm, module);
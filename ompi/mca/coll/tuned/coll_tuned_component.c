@@ -61,6 +61,7 @@ int   ompi_coll_tuned_init_max_requests = 128;
  * default algorithm selection. Changing this value will force using linear with
  * sync algorithm on certain message sizes. */
 int   ompi_coll_tuned_alltoall_max_requests  = 0; /* no limit for alltoall by default */
+int   ompi_coll_tuned_alltoallv_max_requests = 0; /* init_max_requests for alltoallv by default */
 
 /* Disable by default */
 int   ompi_coll_tuned_scatter_intermediate_msg = 0;
@@ -68,11 +69,18 @@ int   ompi_coll_tuned_scatter_large_msg = 0;
 int   ompi_coll_tuned_scatter_min_procs = 0;
 int   ompi_coll_tuned_scatter_blocking_send_ratio = 0;
 
+/* online selection, disabled by default */
+bool  ompi_coll_tuned_online_selection = false;
+int   ompi_coll_tuned_online_trials = 4;
+int   ompi_coll_tuned_online_reexplore = 0;
+int   ompi_coll_tuned_online_segsize = 65536;
+
 /* forced algorithm variables */
 /* indices for the MCA parameters */
 coll_tuned_force_algorithm_mca_param_indices_t ompi_coll_tuned_forced_params[COLLCOUNT] = {{0}};
 /* max algorithm values */
 int ompi_coll_tuned_forced_max_algorithms[COLLCOUNT] = {0};
+mca_base_event_t *ompi_coll_tuned_algorithm_event = &mca_base_event_null;
 
 /*
  * Local function
@@ -124,6 +132,13 @@ mca_coll_tuned_component_t mca_coll_tuned_component = {
 
 static int tuned_register(void)
 {
+    static const mca_base_var_type_t algorithm_event_types[] = {
+        MCA_BASE_VAR_TYPE_INT32_T, MCA_BASE_VAR_TYPE_INT32_T, MCA_BASE_VAR_TYPE_INT32_T};
+    static const ptrdiff_t algorithm_event_offsets[] = {
+        offsetof(ompi_coll_tuned_algorithm_event_t, collective),
+        offsetof(ompi_coll_tuned_algorithm_event_t, algorithm),
+        offsetof(ompi_coll_tuned_algorithm_event_t, segsize)};
+
 
     /* Use a low priority, but allow other components to be lower */
     ompi_coll_tuned_priority = 30;
@@ -187,6 +202,38 @@ static int tuned_register(void)
                                            MCA_BASE_VAR_SCOPE_ALL,
                                            &ompi_coll_tuned_dynamic_rules_filename);
 
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "online_selection",
+                                           "Select the algorithm of the collectives at runtime: the first calls of each power of two message size try every algorithm, and the fastest one is then used for that message size. Only applies to the collectives without forced algorithm or dynamic rule",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_online_selection);
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "online_trials",
+                                           "Number of calls given to each algorithm during the online exploration (the first one is not timed)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_online_trials);
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "online_reexplore",
+                                           "Number of calls after which the online selection explores the algorithms again. The interval doubles each time the exploration keeps the same algorithm. 0 never explores again",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_online_reexplore);
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "online_segsize",
+                                           "Segment size also tried by the online selection for the algorithms that support segmentation, on messages larger than it. 0 only tries unsegmented algorithms",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_online_segsize);
+
     /* register forced params */
     ompi_coll_tuned_allreduce_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLREDUCE]);
     ompi_coll_tuned_alltoall_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLTOALL]);
@@ -203,6 +250,17 @@ static int tuned_register(void)
     ompi_coll_tuned_exscan_intra_check_forced_init(&ompi_coll_tuned_forced_params[EXSCAN]);
     ompi_coll_tuned_scan_intra_check_forced_init(&ompi_coll_tuned_forced_params[SCAN]);
 
+    (void) mca_base_component_event_register(&mca_coll_tuned_component.super.collm_version,
+                                             "algorithm_selected",
+                                             "A collective algorithm was selected for an "
+                                             "operation on the communicator. Elements: "
+                                             "collective (index of the coll_tuned_*_algorithm "
+                                             "parameters), algorithm, segment size",
+                                             OPAL_INFO_LVL_5, MPI_T_BIND_MPI_COMM, 3,
+                                             algorithm_event_types, algorithm_event_offsets,
+                                             sizeof(ompi_coll_tuned_algorithm_event_t),
+                                             &ompi_coll_tuned_algorithm_event);
+
     return OMPI_SUCCESS;
 }
 
@@ -272,8 +330,20 @@ mca_coll_tuned_module_construct(mca_coll_tuned_module_t *module)
     for( int i = 0; i < COLLCOUNT; i++ ) {
         tuned_module->user_forced[i].algorithm = 0;
         tuned_module->com_rules[i] = NULL;
+        tuned_module->online[i] = NULL;
+    }
+}
+
+static void
+mca_coll_tuned_module_destruct(mca_coll_tuned_module_t *module)
+{
+    for( int i = 0; i < COLLCOUNT; i++ ) {
+        if( NULL != module->online[i] ) {
+            ompi_coll_tuned_online_free(module->online[i]);
+            module->online[i] = NULL;
+        }
     }
 }
 
 OBJ_CLASS_INSTANCE(mca_coll_tuned_module_t, mca_coll_base_module_t,
-                   mca_coll_tuned_module_construct, NULL);
+                   mca_coll_tuned_module_construct, mca_coll_tuned_module_destruct);
@@ -52,16 +52,13 @@
  *  Returns:    - MPI_SUCCESS or error code
  */
 int
-ompi_coll_tuned_allreduce_intra_dec_fixed(const void *sbuf, void *rbuf, size_t count,
-                                          struct ompi_datatype_t *dtype,
+ompi_coll_tuned_allreduce_intra_fixed_alg(size_t count, struct ompi_datatype_t *dtype,
                                           struct ompi_op_t *op,
-                                          struct ompi_communicator_t *comm,
-                                          mca_coll_base_module_t *module)
+                                          struct ompi_communicator_t *comm)
 {
     size_t dsize, total_dsize;
     int communicator_size, alg;
     communicator_size = ompi_comm_size(comm);
-    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_allreduce_intra_dec_fixed"));
 
     ompi_datatype_type_size(dtype, &dsize);
     total_dsize = dsize * (ptrdiff_t)count;
@@ -213,6 +210,21 @@ ompi_coll_tuned_allreduce_intra_dec_fixed(const void *sbuf, void *rbuf, size_t c
         }
     }
 
+    return alg;
+}
+
+int
+ompi_coll_tuned_allreduce_intra_dec_fixed(const void *sbuf, void *rbuf, size_t count,
+                                          struct ompi_datatype_t *dtype,
+                                          struct ompi_op_t *op,
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module)
+{
+    int alg;
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_allreduce_intra_dec_fixed"));
+
+    alg = ompi_coll_tuned_allreduce_intra_fixed_alg(count, dtype, op, comm);
+
     return ompi_coll_tuned_allreduce_intra_do_this (sbuf, rbuf, count, dtype, op,
                                                     comm, module, alg, 0, 0);
 }
@@ -422,7 +434,8 @@ int ompi_coll_tuned_alltoallv_intra_dec_fixed(const void *sbuf, ompi_count_array
                                               struct ompi_communicator_t *comm,
                                               mca_coll_base_module_t *module)
 {
-    int communicator_size, alg;
+    int communicator_size, alg, peers = 0;
+    size_t dsize, total_dsize = 0;
     communicator_size = ompi_comm_size(comm);
 
     OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_alltoallv_intra_dec_fixed com_size %d",
@@ -430,8 +443,15 @@ int ompi_coll_tuned_alltoallv_intra_dec_fixed(const void *sbuf, ompi_count_array
     /** Algorithms:
      *  {1, "basic_linear"},
      *  {2, "pairwise"},
+     *  {3, "sparse"},
+     *  {4, "scattered"},
+     *  {5, "node_aggregated"},
      *
-     * We can only optimize based on com size
+     * The choice of pairwise must be the same on all ranks, so it is only
+     * based on com size. Linear, sparse and scattered exchange the same
+     * messages and can be mixed: each rank refines the linear choice with
+     * its own send counts. Node aggregated is never selected here, as it
+     * would need all ranks to agree on it.
      */
     if (communicator_size < 4) {
 		alg = 2;
@@ -447,10 +467,26 @@ int ompi_coll_tuned_alltoallv_intra_dec_fixed(const void *sbuf, ompi_count_array
 		alg = 1;
     }
 
+    if (1 == alg && MPI_IN_PLACE != sbuf) {
+        ompi_datatype_type_size(sdtype, &dsize);
+        for (int i = 0; i < communicator_size; i++) {
+            size_t count = ompi_count_array_get(scounts, i);
+            if (0 < count) {
+                peers++;
+                total_dsize += count * dsize;
+            }
+        }
+        if (peers < communicator_size / 4) {
+            alg = 3;
+        } else if (communicator_size >= 256 && total_dsize / peers >= 8192) {
+            alg = 4;
+        }
+    }
+
     return ompi_coll_tuned_alltoallv_intra_do_this (sbuf, scounts, sdisps, sdtype,
                                                     rbuf, rcounts, rdisps, rdtype,
                                                     comm, module,
-                                                    alg);
+                                                    alg, ompi_coll_tuned_alltoallv_max_requests);
 }
 
 
@@ -461,14 +497,11 @@ int ompi_coll_tuned_alltoallv_intra_dec_fixed(const void *sbuf, ompi_count_array
  *	Accepts:	- same arguments as MPI_Barrier()
  *	Returns:	- MPI_SUCCESS or error code (passed from the barrier implementation)
  */
-int ompi_coll_tuned_barrier_intra_dec_fixed(struct ompi_communicator_t *comm,
-                                            mca_coll_base_module_t *module)
+int ompi_coll_tuned_barrier_intra_fixed_alg(struct ompi_communicator_t *comm)
 {
     int communicator_size, alg;
     communicator_size = ompi_comm_size(comm);
 
-    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_barrier_intra_dec_fixed com_size %d",
-                 communicator_size));
     /** Algorithms:
      *  {1, "linear"},
      *  {2, "double_ring"},
@@ -497,6 +530,18 @@ int ompi_coll_tuned_barrier_intra_dec_fixed(struct ompi_communicator_t *comm,
         alg = 4;
     }
 
+    return alg;
+}
+
+int ompi_coll_tuned_barrier_intra_dec_fixed(struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    int alg;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_barrier_intra_dec_fixed com_size %d",
+                 ompi_comm_size(comm)));
+    alg = ompi_coll_tuned_barrier_intra_fixed_alg(comm);
+
     return ompi_coll_tuned_barrier_intra_do_this (comm, module,
                                                   alg, 0, 0);
 }
@@ -509,22 +554,16 @@ int ompi_coll_tuned_barrier_intra_dec_fixed(struct ompi_communicator_t *comm,
  *	Accepts:	- same arguments as MPI_Bcast()
  *	Returns:	- MPI_SUCCESS or error code (passed from the bcast implementation)
  */
-int ompi_coll_tuned_bcast_intra_dec_fixed(void *buff, size_t count,
-                                          struct ompi_datatype_t *datatype, int root,
-                                          struct ompi_communicator_t *comm,
-                                          mca_coll_base_module_t *module)
+int ompi_coll_tuned_bcast_intra_fixed_alg(size_t count, struct ompi_datatype_t *datatype,
+                                          struct ompi_communicator_t *comm)
 {
     size_t total_dsize, dsize;
     int communicator_size, alg;
-	communicator_size = ompi_comm_size(comm);
+    communicator_size = ompi_comm_size(comm);
 
     ompi_datatype_type_size(datatype, &dsize);
     total_dsize = dsize * (unsigned long)count;
 
-    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_bcast_intra_dec_fixed"
-                 " root %d rank %d com_size %d",
-                 root, ompi_comm_rank(comm), communicator_size));
-
     /** Algorithms:
      *  {1, "basic_linear"},
      *  {2, "chain"},
@@ -646,6 +685,21 @@ int ompi_coll_tuned_bcast_intra_dec_fixed(void *buff, size_t count,
         }
     }
 
+    return alg;
+}
+
+int ompi_coll_tuned_bcast_intra_dec_fixed(void *buff, size_t count,
+                                          struct ompi_datatype_t *datatype, int root,
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module)
+{
+    int alg;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_bcast_intra_dec_fixed"
+                 " root %d rank %d com_size %d",
+                 root, ompi_comm_rank(comm), ompi_comm_size(comm)));
+    alg = ompi_coll_tuned_bcast_intra_fixed_alg(count, datatype, comm);
+
     return ompi_coll_tuned_bcast_intra_do_this (buff, count, datatype, root,
                                                 comm, module,
                                                 alg, 0, 0);
@@ -659,20 +713,15 @@ int ompi_coll_tuned_bcast_intra_dec_fixed(void *buff, size_t count,
  *	Returns:	- MPI_SUCCESS or error code (passed from the reduce implementation)
  *
  */
-int ompi_coll_tuned_reduce_intra_dec_fixed( const void *sendbuf, void *recvbuf,
-                                            size_t count, struct ompi_datatype_t* datatype,
-                                            struct ompi_op_t* op, int root,
-                                            struct ompi_communicator_t* comm,
-                                            mca_coll_base_module_t *module)
+int ompi_coll_tuned_reduce_intra_fixed_alg(size_t count, struct ompi_datatype_t* datatype,
+                                           struct ompi_op_t* op,
+                                           struct ompi_communicator_t* comm)
 {
     int communicator_size, alg;
     size_t total_dsize, dsize;
 
     communicator_size = ompi_comm_size(comm);
 
-    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_reduce_intra_dec_fixed "
-                 "root %d rank %d com_size %d", root, ompi_comm_rank(comm), communicator_size));
-
     ompi_datatype_type_size(datatype, &dsize);
     total_dsize = dsize * (ptrdiff_t)count;   /* needed for decision */
 
@@ -807,6 +856,20 @@ int ompi_coll_tuned_reduce_intra_dec_fixed( const void *sendbuf, void *recvbuf,
             }
         }
     }
+    return alg;
+}
+
+int ompi_coll_tuned_reduce_intra_dec_fixed( const void *sendbuf, void *recvbuf,
+                                            size_t count, struct ompi_datatype_t* datatype,
+                                            struct ompi_op_t* op, int root,
+                                            struct ompi_communicator_t* comm,
+                                            mca_coll_base_module_t *module)
+{
+    int alg;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_reduce_intra_dec_fixed "
+                 "root %d rank %d com_size %d", root, ompi_comm_rank(comm), ompi_comm_size(comm)));
+    alg = ompi_coll_tuned_reduce_intra_fixed_alg(count, datatype, op, comm);
 
     int faninout = 2;
     return  ompi_coll_tuned_reduce_intra_do_this (sendbuf, recvbuf, count, datatype,
@@ -0,0 +1,154 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/coll/base/base.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_base_persistent.h"
+#include "coll_tuned.h"
+#include "coll_tuned_dynamic_rules.h"
+
+/*
+ * Persistent collectives
+ *
+ * The decision follows the same order as the blocking collectives
+ * (forced algorithm, file based rules, fixed decision) but is taken
+ * once, when the request is initialized. The selected algorithm is
+ * then mapped onto the closest algorithm that has a pre-computed plan
+ * in coll/base, and every MPI_Start replays that plan.
+ */
+
+/* forced algorithm or file based rule for this collective, 0 if none */
+static int
+tuned_persistent_forced(mca_coll_base_module_t *module, COLLTYPE_T coll, size_t msgsize,
+                        int *segsize)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    int faninout, ignoreme;
+
+    *segsize = 0;
+    if (tuned_module->user_forced[coll].algorithm) {
+        *segsize = tuned_module->user_forced[coll].segsize;
+        return tuned_module->user_forced[coll].algorithm;
+    }
+    if (tuned_module->com_rules[coll]) {
+        return ompi_coll_tuned_get_target_method_params(tuned_module->com_rules[coll], msgsize,
+                                                        &faninout, segsize, &ignoreme);
+    }
+    return 0;
+}
+
+int ompi_coll_tuned_allreduce_init_intra_dec(const void *sbuf, void *rbuf, size_t count,
+                                             struct ompi_datatype_t *dtype,
+                                             struct ompi_op_t *op,
+                                             struct ompi_communicator_t *comm,
+                                             struct ompi_info_t *info,
+                                             ompi_request_t **request,
+                                             mca_coll_base_module_t *module)
+{
+    int alg, segsize;
+    size_t dsize;
+
+    ompi_datatype_type_size(dtype, &dsize);
+    alg = tuned_persistent_forced(module, ALLREDUCE, dsize * count, &segsize);
+    if (0 == alg) {
+        alg = ompi_coll_tuned_allreduce_intra_fixed_alg(count, dtype, op, comm);
+    }
+
+    /* the bandwidth oriented algorithms (ring, segmented ring and
+     * rabenseifner) run as a ring, everything else as recursive doubling */
+    if (alg >= 4 && ompi_op_is_commute(op) && count >= (size_t) ompi_comm_size(comm)) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:allreduce_init: ring (selected %d)", alg));
+        ompi_coll_tuned_algorithm_selected(comm, ALLREDUCE, 4, 0);
+        return ompi_coll_base_allreduce_init_intra_ring(sbuf, rbuf, count, dtype, op, comm,
+                                                        request, module);
+    }
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:allreduce_init: recursive doubling (selected %d)", alg));
+    ompi_coll_tuned_algorithm_selected(comm, ALLREDUCE, 3, 0);
+    return ompi_coll_base_allreduce_init_intra_recursivedoubling(sbuf, rbuf, count, dtype, op,
+                                                                 comm, request, module);
+}
+
+int ompi_coll_tuned_barrier_init_intra_dec(struct ompi_communicator_t *comm,
+                                           struct ompi_info_t *info,
+                                           ompi_request_t **request,
+                                           mca_coll_base_module_t *module)
+{
+    /* all the barrier algorithms synchronize the same way once the
+     * exchanges are bound, the dissemination has the fewest rounds */
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:barrier_init: bruck"));
+    ompi_coll_tuned_algorithm_selected(comm, BARRIER, 4, 0);
+    return ompi_coll_base_barrier_init_intra_bruck(comm, request, module);
+}
+
+int ompi_coll_tuned_bcast_init_intra_dec(void *buff, size_t count,
+                                         struct ompi_datatype_t *datatype, int root,
+                                         struct ompi_communicator_t *comm,
+                                         struct ompi_info_t *info,
+                                         ompi_request_t **request,
+                                         mca_coll_base_module_t *module)
+{
+    int alg, segsize;
+    size_t dsize;
+
+    ompi_datatype_type_size(datatype, &dsize);
+    alg = tuned_persistent_forced(module, BCAST, dsize * count, &segsize);
+    if (0 == alg) {
+        /* the fixed decision does not segment, segsize stays 0 */
+        alg = ompi_coll_tuned_bcast_intra_fixed_alg(count, datatype, comm);
+    }
+
+    if (1 == alg) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:bcast_init: linear"));
+        ompi_coll_tuned_algorithm_selected(comm, BCAST, 1, 0);
+        return ompi_coll_base_bcast_init_intra_basic_linear(buff, count, datatype, root, comm,
+                                                            request, module);
+    }
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:bcast_init: binomial segsize %d (selected %d)",
+                 segsize, alg));
+    ompi_coll_tuned_algorithm_selected(comm, BCAST, 6, segsize);
+    return ompi_coll_base_bcast_init_intra_binomial(buff, count, datatype, root, comm, request,
+                                                    module, segsize);
+}
+
+int ompi_coll_tuned_reduce_init_intra_dec(const void *sbuf, void *rbuf, size_t count,
+                                          struct ompi_datatype_t *dtype,
+                                          struct ompi_op_t *op, int root,
+                                          struct ompi_communicator_t *comm,
+                                          struct ompi_info_t *info,
+                                          ompi_request_t **request,
+                                          mca_coll_base_module_t *module)
+{
+    int alg, segsize;
+    size_t dsize;
+
+    ompi_datatype_type_size(dtype, &dsize);
+    alg = tuned_persistent_forced(module, REDUCE, dsize * count, &segsize);
+    if (0 == alg) {
+        alg = ompi_coll_tuned_reduce_intra_fixed_alg(count, dtype, op, comm);
+    }
+
+    /* the linear plan keeps the rank order of non-commutative operations */
+    if (1 == alg || !ompi_op_is_commute(op)) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:reduce_init: linear (selected %d)", alg));
+        ompi_coll_tuned_algorithm_selected(comm, REDUCE, 1, 0);
+        return ompi_coll_base_reduce_init_intra_basic_linear(sbuf, rbuf, count, dtype, op, root,
+                                                             comm, request, module);
+    }
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:reduce_init: binomial (selected %d)", alg));
+    ompi_coll_tuned_algorithm_selected(comm, REDUCE, 5, 0);
+    return ompi_coll_base_reduce_init_intra_binomial(sbuf, rbuf, count, dtype, op, root, comm,
+                                                     request, module);
+}
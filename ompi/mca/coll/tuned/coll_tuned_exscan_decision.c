@@ -95,6 +95,8 @@ int ompi_coll_tuned_exscan_intra_do_this(const void *sbuf, void* rbuf, size_t co
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_do_this selected algorithm %d",
                  algorithm));
 
+    ompi_coll_tuned_algorithm_selected(comm, EXSCAN, algorithm, 0);
+
     switch (algorithm) {
     case (0):
     case (1):  return ompi_coll_base_exscan_intra_linear(sbuf, rbuf, count, dtype,
@@ -111,6 +111,12 @@ ompi_coll_tuned_comm_query(struct ompi_communicator_t *comm, int *priority)
     tuned_module->super.coll_reduce_scatter_block = ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed;
     tuned_module->super.coll_scatter    = ompi_coll_tuned_scatter_intra_dec_fixed;
 
+    /* persistent collectives select their algorithm once, at init */
+    tuned_module->super.coll_allreduce_init = ompi_coll_tuned_allreduce_init_intra_dec;
+    tuned_module->super.coll_barrier_init   = ompi_coll_tuned_barrier_init_intra_dec;
+    tuned_module->super.coll_bcast_init     = ompi_coll_tuned_bcast_init_intra_dec;
+    tuned_module->super.coll_reduce_init    = ompi_coll_tuned_reduce_init_intra_dec;
+
     return &(tuned_module->super);
 }
 
@@ -187,6 +193,20 @@ ompi_coll_tuned_forced_getvalues( enum COLLTYPE type,
         }                                                               \
     } while(0)
 
+/* the online selection only replaces the fixed decision, forced algorithms
+ * and dynamic rules take precedence */
+#define COLL_TUNED_EXECUTE_IF_ONLINE(TMOD, TYPE, API, SIZE)                     \
+    do {                                                                        \
+        if( ompi_coll_tuned_##API##_intra_dec_fixed == (TMOD)->super.coll_##API \
+            && NULL == (TMOD)->online[(TYPE)] ) {                               \
+            (TMOD)->online[(TYPE)] = ompi_coll_tuned_online_create((TYPE), (SIZE)); \
+            if( NULL != (TMOD)->online[(TYPE)] ) {                              \
+                OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned: enable online selection for "#TYPE)); \
+                (TMOD)->super.coll_##API = ompi_coll_tuned_##API##_intra_dec_online; \
+            }                                                                   \
+        }                                                                       \
+    } while(0)
+
 /*
  * Init module on the communicator
  */
@@ -266,6 +286,15 @@ tuned_module_enable( mca_coll_base_module_t *module,
         COLL_TUNED_EXECUTE_IF_DYNAMIC(tuned_module, SCATTERV,
                                       tuned_module->super.coll_scatterv   = NULL);
     }
+    if (ompi_coll_tuned_online_selection && OMPI_COMM_IS_INTRA(comm)) {
+        COLL_TUNED_EXECUTE_IF_ONLINE(tuned_module, ALLGATHER, allgather, size);
+        COLL_TUNED_EXECUTE_IF_ONLINE(tuned_module, ALLREDUCE, allreduce, size);
+        COLL_TUNED_EXECUTE_IF_ONLINE(tuned_module, ALLTOALL, alltoall, size);
+        COLL_TUNED_EXECUTE_IF_ONLINE(tuned_module, BARRIER, barrier, size);
+        COLL_TUNED_EXECUTE_IF_ONLINE(tuned_module, BCAST, bcast, size);
+        COLL_TUNED_EXECUTE_IF_ONLINE(tuned_module, REDUCE, reduce, size);
+        COLL_TUNED_EXECUTE_IF_ONLINE(tuned_module, REDUCESCATTERBLOCK, reduce_scatter_block, size);
+    }
     TUNED_INSTALL_COLL_API(comm, tuned_module, allgather);
     TUNED_INSTALL_COLL_API(comm, tuned_module, allgatherv);
     TUNED_INSTALL_COLL_API(comm, tuned_module, allreduce);
@@ -283,6 +312,10 @@ tuned_module_enable( mca_coll_base_module_t *module,
     TUNED_INSTALL_COLL_API(comm, tuned_module, scan);
     TUNED_INSTALL_COLL_API(comm, tuned_module, scatter);
     TUNED_INSTALL_COLL_API(comm, tuned_module, scatterv);
+    TUNED_INSTALL_COLL_API(comm, tuned_module, allreduce_init);
+    TUNED_INSTALL_COLL_API(comm, tuned_module, barrier_init);
+    TUNED_INSTALL_COLL_API(comm, tuned_module, bcast_init);
+    TUNED_INSTALL_COLL_API(comm, tuned_module, reduce_init);
 
     /* general n fan out tree */
     data->cached_ntree = NULL;
@@ -331,6 +364,10 @@ tuned_module_disable(mca_coll_base_module_t *module,
     TUNED_UNINSTALL_COLL_API(comm, tuned_module, scan);
     TUNED_UNINSTALL_COLL_API(comm, tuned_module, scatter);
     TUNED_UNINSTALL_COLL_API(comm, tuned_module, scatterv);
+    TUNED_UNINSTALL_COLL_API(comm, tuned_module, allreduce_init);
+    TUNED_UNINSTALL_COLL_API(comm, tuned_module, barrier_init);
+    TUNED_UNINSTALL_COLL_API(comm, tuned_module, bcast_init);
+    TUNED_UNINSTALL_COLL_API(comm, tuned_module, reduce_init);
 
     return OMPI_SUCCESS;
 }
@@ -0,0 +1,523 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <float.h>
+#include <limits.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/coll/base/base.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "opal/mca/timer/base/base.h"
+#include "coll_tuned.h"
+#include "coll_tuned_online.h"
+
+/*
+ * Algorithms taking a segment size, per collective. They are tried both
+ * unsegmented and with the coll_tuned_online_segsize segments.
+ */
+static const int bcast_segmented[]     = {2, 3, 4, 5, 6, 7, 0};
+static const int reduce_segmented[]    = {2, 3, 4, 5, 6, 8, 0};
+static const int allreduce_segmented[] = {5, 10, 0};
+
+/* algorithms that only run on two processes */
+static int online_two_procs_only(COLLTYPE_T collective, int algorithm)
+{
+    switch (collective) {
+    case ALLGATHER: return 6 == algorithm;
+    case ALLTOALL:  return 5 == algorithm;
+    case BARRIER:   return 5 == algorithm;
+    default:        return 0;
+    }
+}
+
+static int online_is_segmented(COLLTYPE_T collective, int algorithm)
+{
+    const int *list;
+
+    switch (collective) {
+    case BCAST:     list = bcast_segmented; break;
+    case REDUCE:    list = reduce_segmented; break;
+    case ALLREDUCE: list = allreduce_segmented; break;
+    default:        return 0;
+    }
+    for (; 0 != *list; list++) {
+        if (*list == algorithm) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+ompi_coll_tuned_online_t *ompi_coll_tuned_online_create(COLLTYPE_T collective, int comm_size)
+{
+    ompi_coll_tuned_online_t *online;
+    int nalgs = ompi_coll_tuned_forced_max_algorithms[collective];
+    double *cycles;
+
+    switch (collective) {
+    case ALLGATHER: case ALLREDUCE: case ALLTOALL: case BARRIER: case BCAST: case REDUCE:
+    case REDUCESCATTERBLOCK:
+        break;
+    default:
+        return NULL;
+    }
+    if (nalgs < 2) {
+        return NULL;
+    }
+
+    online = calloc(1, sizeof(*online));
+    if (NULL == online) {
+        return NULL;
+    }
+    online->collective = collective;
+    /* algorithm 0 is the fixed decision, every other one may come twice */
+    online->candidates = malloc(2 * (nalgs - 1) * sizeof(ompi_coll_tuned_online_candidate_t));
+    if (NULL == online->candidates) {
+        free(online);
+        return NULL;
+    }
+    for (int alg = 1; alg < nalgs; alg++) {
+        if (2 != comm_size && online_two_procs_only(collective, alg)) {
+            continue;
+        }
+        online->candidates[online->ncandidates++] =
+            (ompi_coll_tuned_online_candidate_t) {.algorithm = alg, .segsize = 0};
+        if (ompi_coll_tuned_online_segsize > 0 && online_is_segmented(collective, alg)) {
+            online->candidates[online->ncandidates++] = (ompi_coll_tuned_online_candidate_t) {
+                .algorithm = alg, .segsize = ompi_coll_tuned_online_segsize};
+        }
+    }
+
+    /* allocated up front: all the processes must be able to explore */
+    switch (collective) {
+    case ALLREDUCE: case REDUCE: case REDUCESCATTERBLOCK:
+        online->maxtables = OMPI_COLL_TUNED_ONLINE_KEYS;
+        break;
+    default:
+        online->maxtables = 1;
+        break;
+    }
+    online->tables = calloc((size_t) online->maxtables, sizeof(ompi_coll_tuned_online_table_t));
+    cycles = calloc((size_t) online->maxtables * OMPI_COLL_TUNED_ONLINE_BUCKETS
+                    * online->ncandidates, sizeof(double));
+    if (NULL == online->tables || NULL == cycles) {
+        free(cycles);
+        free(online->tables);
+        free(online->candidates);
+        free(online);
+        return NULL;
+    }
+    for (int t = 0; t < online->maxtables; t++) {
+        for (int i = 0; i < OMPI_COLL_TUNED_ONLINE_BUCKETS; i++) {
+            ompi_coll_tuned_online_bucket_t *bucket = &online->tables[t].buckets[i];
+
+            bucket->explore = 0;
+            bucket->calls = 0;
+            bucket->winner = -1;
+            bucket->interval = ompi_coll_tuned_online_reexplore;
+            bucket->cycles = cycles;
+            cycles += online->ncandidates;
+        }
+    }
+    return online;
+}
+
+void ompi_coll_tuned_online_free(ompi_coll_tuned_online_t *online)
+{
+    free(online->tables[0].buckets[0].cycles);
+    free(online->tables);
+    free(online->candidates);
+    free(online);
+}
+
+/*
+ * Table of an operation and set of basic datatypes, NULL once all the
+ * tables are taken. The tables are handed out in call order, hence in
+ * the same order on all the processes.
+ */
+static ompi_coll_tuned_online_table_t *online_table(ompi_coll_tuned_online_t *online, int op,
+                                                    uint32_t types)
+{
+    for (int t = 0; t < online->ntables; t++) {
+        if (op == online->tables[t].op && types == online->tables[t].types) {
+            return &online->tables[t];
+        }
+    }
+    if (online->ntables == online->maxtables) {
+        return NULL;
+    }
+    online->tables[online->ntables].op = op;
+    online->tables[online->ntables].types = types;
+    return &online->tables[online->ntables++];
+}
+
+static inline int online_bucket_index(size_t msgsize)
+{
+    int index = 0;
+
+    while (msgsize > 0 && index < OMPI_COLL_TUNED_ONLINE_BUCKETS - 1) {
+        msgsize >>= 1;
+        index++;
+    }
+    return index;
+}
+
+/* skip the candidates that would not differ on msgsize bytes */
+static int online_next_candidate(ompi_coll_tuned_online_t *online,
+                                 ompi_coll_tuned_online_bucket_t *bucket, int from, size_t msgsize)
+{
+    while (from < online->ncandidates && 0 != online->candidates[from].segsize
+           && msgsize <= (size_t) online->candidates[from].segsize) {
+        bucket->cycles[from++] = DBL_MAX;
+    }
+    return from;
+}
+
+/*
+ * Candidate to run for this call, NULL to use the fixed decision.
+ */
+static const ompi_coll_tuned_online_candidate_t *
+online_start(ompi_coll_tuned_online_t *online, int op, uint32_t types, size_t msgsize,
+             ompi_coll_tuned_online_bucket_t **pbucket)
+{
+    ompi_coll_tuned_online_table_t *table = online_table(online, op, types);
+    ompi_coll_tuned_online_bucket_t *bucket;
+
+    if (NULL == table) {
+        return NULL;
+    }
+    bucket = &table->buckets[online_bucket_index(msgsize)];
+    *pbucket = bucket;
+    if (bucket->explore < 0) {
+        if (0 == bucket->interval || ++bucket->calls < bucket->interval) {
+            return bucket->winner < 0 ? NULL : &online->candidates[bucket->winner];
+        }
+        bucket->calls = 0;
+        bucket->explore = 0;
+    }
+    if (0 == bucket->explore && 0 == bucket->calls) {
+        for (int i = 0; i < online->ncandidates; i++) {
+            bucket->cycles[i] = 0.0;
+        }
+        bucket->explore = online_next_candidate(online, bucket, 0, msgsize);
+    }
+    if (bucket->explore >= online->ncandidates) {
+        /* nothing applies to this message size */
+        bucket->explore = -1;
+        return bucket->winner < 0 ? NULL : &online->candidates[bucket->winner];
+    }
+    return &online->candidates[bucket->explore];
+}
+
+/*
+ * All the candidates ran: agree on the slowest process time of each of
+ * them, and lock in the fastest.
+ */
+static void online_agree(ompi_coll_tuned_online_t *online, ompi_coll_tuned_online_bucket_t *bucket,
+                         size_t msgsize, struct ompi_communicator_t *comm,
+                         mca_coll_base_module_t *module)
+{
+    int winner = -1, err;
+
+    err = ompi_coll_base_allreduce_intra_recursivedoubling(MPI_IN_PLACE, bucket->cycles,
+                                                           online->ncandidates, MPI_DOUBLE, MPI_MAX,
+                                                           comm, module);
+    if (OMPI_SUCCESS == err) {
+        for (int i = 0; i < online->ncandidates; i++) {
+            if (DBL_MAX != bucket->cycles[i]
+                && (winner < 0 || bucket->cycles[i] < bucket->cycles[winner])) {
+                winner = i;
+            }
+        }
+    }
+
+    if (winner == bucket->winner && bucket->interval > 0 && bucket->interval < INT_MAX / 2) {
+        bucket->interval *= 2;
+    } else {
+        bucket->interval = ompi_coll_tuned_online_reexplore;
+    }
+    bucket->winner = winner;
+    bucket->explore = -1;
+    bucket->calls = 0;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:online %s bucket %d: algorithm %d segsize %d, next exploration in %d calls",
+                 mca_coll_base_colltype_to_str(online->collective), online_bucket_index(msgsize),
+                 winner < 0 ? 0 : online->candidates[winner].algorithm,
+                 winner < 0 ? 0 : online->candidates[winner].segsize, bucket->interval));
+}
+
+/*
+ * Account the call. A failure is only seen by the local process: the
+ * candidate keeps all its calls so the processes stay in step, and its
+ * time is set to DBL_MAX, which the agreement turns into a loss on all
+ * of them.
+ */
+static void online_end(ompi_coll_tuned_online_t *online, ompi_coll_tuned_online_bucket_t *bucket,
+                       size_t msgsize, opal_timer_t cycles, bool failed,
+                       struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    int trials = ompi_coll_tuned_online_trials < 2 ? 2 : ompi_coll_tuned_online_trials;
+
+    if (bucket->explore < 0) {
+        return;
+    }
+    if (failed) {
+        bucket->cycles[bucket->explore] = DBL_MAX;
+    } else if (bucket->calls > 0 && DBL_MAX != bucket->cycles[bucket->explore]) {
+        /* the first call of each candidate warms it up */
+        bucket->cycles[bucket->explore] += (double) cycles;
+    }
+    if (++bucket->calls < trials) {
+        return;
+    }
+    bucket->calls = 0;
+    bucket->explore = online_next_candidate(online, bucket, bucket->explore + 1, msgsize);
+    if (bucket->explore >= online->ncandidates) {
+        online_agree(online, bucket, msgsize, comm, module);
+    }
+}
+
+/*
+ * The message sizes are computed from arguments that are significant
+ * on all the processes (the receive side for the gathers), so that all
+ * of them land in the same bucket. The reductions also select their
+ * table from the operation and the basic datatypes, which are the same
+ * on all the processes; the datatype of the other collectives may
+ * differ between them and is not part of the key.
+ *
+ * Failed candidates return their error, as a forced algorithm would:
+ * falling back to the fixed decision on the processes that saw the
+ * failure alone would mismatch the collectives of the others.
+ */
+
+int ompi_coll_tuned_allgather_intra_dec_online(const void *sbuf, size_t scount,
+                                               struct ompi_datatype_t *sdtype,
+                                               void *rbuf, size_t rcount,
+                                               struct ompi_datatype_t *rdtype,
+                                               struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_online_t *online = ((mca_coll_tuned_module_t *) module)->online[ALLGATHER];
+    const ompi_coll_tuned_online_candidate_t *candidate;
+    ompi_coll_tuned_online_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int ret;
+
+    ompi_datatype_type_size(rdtype, &dsize);
+    dsize *= rcount * ompi_comm_size(comm);
+    candidate = online_start(online, 0, 0, dsize, &bucket);
+    if (NULL == candidate) {
+        return ompi_coll_tuned_allgather_intra_dec_fixed(sbuf, scount, sdtype, rbuf, rcount,
+                                                         rdtype, comm, module);
+    }
+    start = opal_timer_base_get_cycles();
+    ret = ompi_coll_tuned_allgather_intra_do_this(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                  comm, module, candidate->algorithm,
+                                                  ompi_coll_tuned_init_tree_fanout,
+                                                  candidate->segsize);
+    online_end(online, bucket, dsize, opal_timer_base_get_cycles() - start, OMPI_SUCCESS != ret,
+               comm, module);
+    return ret;
+}
+
+int ompi_coll_tuned_allreduce_intra_dec_online(const void *sbuf, void *rbuf, size_t count,
+                                               struct ompi_datatype_t *dtype,
+                                               struct ompi_op_t *op,
+                                               struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_online_t *online = ((mca_coll_tuned_module_t *) module)->online[ALLREDUCE];
+    const ompi_coll_tuned_online_candidate_t *candidate;
+    ompi_coll_tuned_online_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int ret;
+
+    /* most candidates reorder the operands */
+    if (!ompi_op_is_commute(op)) {
+        return ompi_coll_tuned_allreduce_intra_dec_fixed(sbuf, rbuf, count, dtype, op, comm,
+                                                         module);
+    }
+    ompi_datatype_type_size(dtype, &dsize);
+    dsize *= count;
+    candidate = online_start(online, op->op_type, dtype->super.bdt_used, dsize, &bucket);
+    if (NULL == candidate) {
+        return ompi_coll_tuned_allreduce_intra_dec_fixed(sbuf, rbuf, count, dtype, op, comm,
+                                                         module);
+    }
+    start = opal_timer_base_get_cycles();
+    ret = ompi_coll_tuned_allreduce_intra_do_this(sbuf, rbuf, count, dtype, op, comm, module,
+                                                  candidate->algorithm,
+                                                  ompi_coll_tuned_init_tree_fanout,
+                                                  candidate->segsize);
+    online_end(online, bucket, dsize, opal_timer_base_get_cycles() - start, OMPI_SUCCESS != ret,
+               comm, module);
+    return ret;
+}
+
+int ompi_coll_tuned_alltoall_intra_dec_online(const void *sbuf, size_t scount,
+                                              struct ompi_datatype_t *sdtype,
+                                              void *rbuf, size_t rcount,
+                                              struct ompi_datatype_t *rdtype,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_online_t *online = ((mca_coll_tuned_module_t *) module)->online[ALLTOALL];
+    const ompi_coll_tuned_online_candidate_t *candidate;
+    ompi_coll_tuned_online_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int ret;
+
+    ompi_datatype_type_size(rdtype, &dsize);
+    dsize *= rcount * ompi_comm_size(comm);
+    candidate = online_start(online, 0, 0, dsize, &bucket);
+    if (NULL == candidate) {
+        return ompi_coll_tuned_alltoall_intra_dec_fixed(sbuf, scount, sdtype, rbuf, rcount,
+                                                        rdtype, comm, module);
+    }
+    start = opal_timer_base_get_cycles();
+    ret = ompi_coll_tuned_alltoall_intra_do_this(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                 comm, module, candidate->algorithm,
+                                                 ompi_coll_tuned_init_tree_fanout,
+                                                 candidate->segsize,
+                                                 ompi_coll_tuned_alltoall_max_requests);
+    online_end(online, bucket, dsize, opal_timer_base_get_cycles() - start, OMPI_SUCCESS != ret,
+               comm, module);
+    return ret;
+}
+
+int ompi_coll_tuned_barrier_intra_dec_online(struct ompi_communicator_t *comm,
+                                             mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_online_t *online = ((mca_coll_tuned_module_t *) module)->online[BARRIER];
+    const ompi_coll_tuned_online_candidate_t *candidate;
+    ompi_coll_tuned_online_bucket_t *bucket;
+    opal_timer_t start;
+    int ret;
+
+    candidate = online_start(online, 0, 0, 0, &bucket);
+    if (NULL == candidate) {
+        return ompi_coll_tuned_barrier_intra_dec_fixed(comm, module);
+    }
+    start = opal_timer_base_get_cycles();
+    ret = ompi_coll_tuned_barrier_intra_do_this(comm, module, candidate->algorithm,
+                                                ompi_coll_tuned_init_tree_fanout, 0);
+    online_end(online, bucket, 0, opal_timer_base_get_cycles() - start, OMPI_SUCCESS != ret,
+               comm, module);
+    return ret;
+}
+
+int ompi_coll_tuned_bcast_intra_dec_online(void *buf, size_t count,
+                                           struct ompi_datatype_t *dtype, int root,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_online_t *online = ((mca_coll_tuned_module_t *) module)->online[BCAST];
+    const ompi_coll_tuned_online_candidate_t *candidate;
+    ompi_coll_tuned_online_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int ret;
+
+    ompi_datatype_type_size(dtype, &dsize);
+    dsize *= count;
+    candidate = online_start(online, 0, 0, dsize, &bucket);
+    if (NULL == candidate) {
+        return ompi_coll_tuned_bcast_intra_dec_fixed(buf, count, dtype, root, comm, module);
+    }
+    start = opal_timer_base_get_cycles();
+    ret = ompi_coll_tuned_bcast_intra_do_this(buf, count, dtype, root, comm, module,
+                                              candidate->algorithm,
+                                              ompi_coll_tuned_init_chain_fanout,
+                                              candidate->segsize);
+    online_end(online, bucket, dsize, opal_timer_base_get_cycles() - start, OMPI_SUCCESS != ret,
+               comm, module);
+    return ret;
+}
+
+int ompi_coll_tuned_reduce_intra_dec_online(const void *sbuf, void *rbuf, size_t count,
+                                            struct ompi_datatype_t *dtype,
+                                            struct ompi_op_t *op, int root,
+                                            struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_online_t *online = ((mca_coll_tuned_module_t *) module)->online[REDUCE];
+    const ompi_coll_tuned_online_candidate_t *candidate;
+    ompi_coll_tuned_online_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int ret;
+
+    /* most candidates reorder the operands */
+    if (!ompi_op_is_commute(op)) {
+        return ompi_coll_tuned_reduce_intra_dec_fixed(sbuf, rbuf, count, dtype, op, root, comm,
+                                                      module);
+    }
+    ompi_datatype_type_size(dtype, &dsize);
+    dsize *= count;
+    candidate = online_start(online, op->op_type, dtype->super.bdt_used, dsize, &bucket);
+    if (NULL == candidate) {
+        return ompi_coll_tuned_reduce_intra_dec_fixed(sbuf, rbuf, count, dtype, op, root, comm,
+                                                      module);
+    }
+    start = opal_timer_base_get_cycles();
+    ret = ompi_coll_tuned_reduce_intra_do_this(sbuf, rbuf, count, dtype, op, root, comm, module,
+                                               candidate->algorithm,
+                                               ompi_coll_tuned_init_chain_fanout,
+                                               candidate->segsize, 0);
+    online_end(online, bucket, dsize, opal_timer_base_get_cycles() - start, OMPI_SUCCESS != ret,
+               comm, module);
+    return ret;
+}
+
+int ompi_coll_tuned_reduce_scatter_block_intra_dec_online(const void *sbuf, void *rbuf,
+                                                          size_t rcount,
+                                                          struct ompi_datatype_t *dtype,
+                                                          struct ompi_op_t *op,
+                                                          struct ompi_communicator_t *comm,
+                                                          mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_online_t *online =
+        ((mca_coll_tuned_module_t *) module)->online[REDUCESCATTERBLOCK];
+    const ompi_coll_tuned_online_candidate_t *candidate;
+    ompi_coll_tuned_online_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int ret;
+
+    /* most candidates reorder the operands */
+    if (!ompi_op_is_commute(op)) {
+        return ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(sbuf, rbuf, rcount, dtype, op,
+                                                                    comm, module);
+    }
+    ompi_datatype_type_size(dtype, &dsize);
+    dsize *= rcount * ompi_comm_size(comm);
+    candidate = online_start(online, op->op_type, dtype->super.bdt_used, dsize, &bucket);
+    if (NULL == candidate) {
+        return ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(sbuf, rbuf, rcount, dtype, op,
+                                                                    comm, module);
+    }
+    start = opal_timer_base_get_cycles();
+    ret = ompi_coll_tuned_reduce_scatter_block_intra_do_this(sbuf, rbuf, rcount, dtype, op, comm,
+                                                             module, candidate->algorithm,
+                                                             ompi_coll_tuned_init_tree_fanout,
+                                                             candidate->segsize);
+    online_end(online, bucket, dsize, opal_timer_base_get_cycles() - start, OMPI_SUCCESS != ret,
+               comm, module);
+    return ret;
+}
@@ -0,0 +1,90 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COLL_TUNED_ONLINE_H_HAS_BEEN_INCLUDED
+#define MCA_COLL_TUNED_ONLINE_H_HAS_BEEN_INCLUDED
+
+#include "ompi_config.h"
+
+#include "ompi/mca/coll/base/coll_base_functions.h"
+
+BEGIN_C_DECLS
+
+/*
+ * Online algorithm selection.
+ *
+ * Each (collective, communicator) has one table of candidates and one
+ * state per power of two message size. The first invocations of a
+ * message size cycle through the candidates, a few calls each, timing
+ * them locally; once all the candidates ran the processes agree on the
+ * slowest process time of each candidate and the fastest candidate is
+ * locked in for that message size. Exploration starts again after a
+ * configurable number of calls, and that interval doubles every time
+ * the exploration confirms the previous winner.
+ *
+ * The reductions keep separate message size states per operation and
+ * basic datatypes, up to OMPI_COLL_TUNED_ONLINE_KEYS of them; further
+ * combinations and the non-commutative operations use the fixed
+ * decision.
+ *
+ * All the decisions only depend on the sequence of calls, which is the
+ * same on all the processes, so the processes always run the same
+ * algorithm without any extra synchronization until the agreement.
+ */
+
+#define OMPI_COLL_TUNED_ONLINE_BUCKETS 64
+#define OMPI_COLL_TUNED_ONLINE_KEYS    4
+
+typedef struct ompi_coll_tuned_online_candidate_t {
+    int algorithm;
+    int segsize;
+} ompi_coll_tuned_online_candidate_t;
+
+typedef struct ompi_coll_tuned_online_bucket_t {
+    /* candidate being explored, -1 once a winner is locked in */
+    int explore;
+    /* calls to the explored candidate, or since the winner was locked in */
+    int calls;
+    /* locked in candidate, -1 to defer to the fixed decision */
+    int winner;
+    /* calls before exploring again, 0 to keep the winner forever */
+    int interval;
+    /* cycles spent in each candidate during the current exploration */
+    double *cycles;
+} ompi_coll_tuned_online_bucket_t;
+
+/* message size states of one operation and set of basic datatypes */
+typedef struct ompi_coll_tuned_online_table_t {
+    /* ompi_op_type of the operation, 0 outside of the reductions */
+    int op;
+    /* basic datatypes of the data, 0 outside of the reductions */
+    uint32_t types;
+    ompi_coll_tuned_online_bucket_t buckets[OMPI_COLL_TUNED_ONLINE_BUCKETS];
+} ompi_coll_tuned_online_table_t;
+
+typedef struct ompi_coll_tuned_online_t {
+    COLLTYPE_T collective;
+    int ncandidates;
+    ompi_coll_tuned_online_candidate_t *candidates;
+    /* tables in use, and allocated */
+    int ntables, maxtables;
+    ompi_coll_tuned_online_table_t *tables;
+} ompi_coll_tuned_online_t;
+
+/**
+ * Build the candidates of a collective for a communicator of
+ * comm_size processes. Returns NULL if the collective has no online
+ * selection or on allocation failure.
+ */
+ompi_coll_tuned_online_t *ompi_coll_tuned_online_create(COLLTYPE_T collective, int comm_size);
+void ompi_coll_tuned_online_free(ompi_coll_tuned_online_t *online);
+
+END_C_DECLS
+
+#endif /* MCA_COLL_TUNED_ONLINE_H_HAS_BEEN_INCLUDED */
@@ -95,6 +95,8 @@ int ompi_coll_tuned_scan_intra_do_this(const void *sbuf, void* rbuf, size_t coun
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this selected algorithm %d",
                  algorithm));
 
+    ompi_coll_tuned_algorithm_selected(comm, SCAN, algorithm, 0);
+
     switch (algorithm) {
     case (0):
     case (1):  return ompi_coll_base_scan_intra_linear(sbuf, rbuf, count, dtype,
@@ -166,6 +166,8 @@ ompi_coll_tuned_scatter_intra_do_this(const void *sbuf, size_t scount,
                  "coll:tuned:scatter_intra_do_this selected algorithm %d topo faninout %d segsize %d",
                  algorithm, faninout, segsize));
 
+    ompi_coll_tuned_algorithm_selected(comm, SCATTER, algorithm, segsize);
+
     switch (algorithm) {
     case (0):
         return ompi_coll_tuned_scatter_intra_dec_fixed(sbuf, scount, sdtype,
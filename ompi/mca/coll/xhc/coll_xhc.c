@@ -15,6 +15,7 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/mca/coll/coll.h"
 
+#include "opal/align.h"
 #include "opal/class/opal_hash_table.h"
 #include "opal/mca/rcache/rcache.h"
 #include "opal/mca/shmem/base/base.h"
@@ -27,7 +28,9 @@
 
 // ------------------------------------------------
 
-static int xhc_alloc_bcast_cico(xhc_module_t *module,
+static int xhc_alloc_cico(xhc_module_t *module,
+    ompi_communicator_t *comm);
+static int xhc_alloc_peer_ctrl(xhc_module_t *module,
     ompi_communicator_t *comm);
 
 static int xhc_print_config_info(xhc_module_t *module,
@@ -132,8 +135,20 @@ int mca_coll_xhc_init_op(xhc_module_t *module,
     data->colltype = colltype;
     data->seq = 0;
 
-    if(XHC_BCAST == colltype) {
-        err = xhc_alloc_bcast_cico(module, comm);
+    /* The direct collectives don't use the hierarchy; they
+     * only need the peer table, shared amongst all of them. */
+    if(XHC_COLLTYPE_IS_DIRECT(colltype)) {
+        if(NULL == module->peer_ctrl) {
+            err = xhc_alloc_peer_ctrl(module, comm);
+            if(OMPI_SUCCESS != err) {RETURN_WITH_ERROR(return_code, err, end);}
+        }
+
+        data->init = true;
+        goto end;
+    }
+
+    if(XHC_COLLTYPE_USES_CICO(colltype)) {
+        err = xhc_alloc_cico(module, comm);
         if(OMPI_SUCCESS != err) {RETURN_WITH_ERROR(return_code, err, end);}
     }
 
@@ -216,7 +231,10 @@ int mca_coll_xhc_init_op(xhc_module_t *module,
     return return_code;
 }
 
-static int xhc_alloc_bcast_cico(xhc_module_t *module, ompi_communicator_t *comm) {
+/* The per-rank CICO buffer is shared by all the ops that use one (see
+ * XHC_COLLTYPE_USES_CICO). It is allocated the first time any of them is
+ * initialized, sized for the largest of their CICO thresholds. */
+static int xhc_alloc_cico(xhc_module_t *module, ompi_communicator_t *comm) {
     opal_shmem_ds_t *ds_list = NULL;
     opal_shmem_ds_t cico_ds;
     void *cico_buffer = NULL;
@@ -227,9 +245,9 @@ static int xhc_alloc_bcast_cico(xhc_module_t *module, ompi_communicator_t *comm)
     int comm_size = ompi_comm_size(comm);
     int rank = ompi_comm_rank(comm);
 
-    size_t cico_size = module->op_config[XHC_BCAST].cico_max;
+    size_t cico_size = xhc_cico_buffer_size(module);
 
-    if(0 == cico_size) {
+    if(0 == cico_size || module->peer_info[rank].cico_buffer) {
         return OMPI_SUCCESS;
     }
 
@@ -316,7 +334,80 @@ void mca_coll_xhc_fini(mca_coll_xhc_module_t *module) {
         }
     }
 
+    if(module->peer_ctrl) {
+        opal_shmem_segment_detach(&module->peer_ctrl_ds);
+    }
+
     free(module->rbuf);
+    free(module->stage);
+}
+
+/* The peer table holds one control struct per rank, through which each rank
+ * exposes its buffer for the op at hand. It is allocated by rank 0 and shared
+ * by all the direct collectives; they all use the same sequence number. */
+static int xhc_alloc_peer_ctrl(xhc_module_t *module, ompi_communicator_t *comm) {
+    xhc_coll_fns_t xhc_fns;
+    void *peer_ctrl = NULL;
+
+    int err, return_code = OMPI_SUCCESS;
+
+    int comm_size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+
+    size_t smsc_reg_size = 0;
+
+    if(mca_smsc_base_has_feature(MCA_SMSC_FEATURE_REQUIRE_REGISTRATION)) {
+        smsc_reg_size = mca_smsc_base_registration_data_size();
+    }
+
+    module->peer_ctrl_stride = OPAL_ALIGN(offsetof(xhc_peer_ctrl_t,
+        access_token) + smsc_reg_size, XHC_ALIGN, size_t);
+
+    xhc_module_set_coll_fns(comm, &module->prev_colls, &xhc_fns);
+
+    if(0 == rank) {
+        size_t ds_len = comm_size * module->peer_ctrl_stride;
+
+        peer_ctrl = xhc_shmem_create(&module->peer_ctrl_ds,
+            ds_len, comm, "peer", 0, 0);
+
+        /* Even on failure, the bcast below must take place; the
+         * other ranks will find out through the invalid segment. */
+        if(peer_ctrl) {
+            memset(peer_ctrl, 0, ds_len);
+        } else {
+            memset(&module->peer_ctrl_ds, 0, sizeof(opal_shmem_ds_t));
+        }
+    }
+
+    err = comm->c_coll->coll_bcast(&module->peer_ctrl_ds,
+        sizeof(opal_shmem_ds_t), MPI_BYTE, 0, comm,
+        comm->c_coll->coll_bcast_module);
+    if(OMPI_SUCCESS != err) {RETURN_WITH_ERROR(return_code, err, end);}
+
+    if(0 != rank && OPAL_SHMEM_DS_IS_VALID(&module->peer_ctrl_ds)) {
+        peer_ctrl = xhc_shmem_attach(&module->peer_ctrl_ds);
+    }
+
+    if(NULL == peer_ctrl) {
+        RETURN_WITH_ERROR(return_code, OMPI_ERROR, end);
+    }
+
+    module->peer_ctrl = peer_ctrl;
+    module->peer_seq = 0;
+
+    // --
+
+    end:
+
+    xhc_module_set_coll_fns(comm, &xhc_fns, NULL);
+
+    if(OMPI_SUCCESS != return_code && 0 == rank && peer_ctrl) {
+        opal_shmem_unlink(&module->peer_ctrl_ds);
+        opal_shmem_segment_detach(&module->peer_ctrl_ds);
+    }
+
+    return return_code;
 }
 
 // ------------------------------------------------
@@ -334,6 +425,10 @@ int mca_coll_xhc_read_op_config(xhc_module_t *module,
 
     xhc_op_config_t *config = &module->op_config[colltype];
 
+    if(XHC_COLLTYPE_IS_DIRECT(colltype)) {
+        return OMPI_SUCCESS;
+    }
+
     const char *param[] = {"hierarchy", "chunk_size", "cico_max"};
     for(size_t p = 0; p < sizeof(param)/sizeof(param[0]); p++) {
         xhc_op_mca_t op_mca = mca_coll_xhc_component.op_mca[colltype];
@@ -530,12 +625,25 @@ static int xhc_print_config_info(xhc_module_t *module, ompi_communicator_t *comm
     for(int t = 0; t < XHC_COLLCOUNT; t++) {
         xhc_op_config_t *config = &module->op_config[t];
 
-        if(XHC_BARRIER == t) {
+        if(XHC_COLLTYPE_IS_DIRECT(t)) {
+            printf("\n"
+                "  [%s]\n"
+                "    Direct single-copy\n",
+                xhc_colltype_to_str(t));
+        } else if(XHC_BARRIER == t) {
             printf("\n"
                 "  [%s]\n"
                 "    Hierarchy: %s (source: %s)\n",
                 xhc_colltype_to_str(t),
                 config->hierarchy_string, xhc_config_source_to_str(config->hierarchy_source));
+        } else if(!XHC_COLLTYPE_IS_PIPELINED(t)) {
+            printf("\n"
+                "  [%s]\n"
+                "    Hierarchy: %s (source: %s)\n"
+                "    CICO: Up to %zu bytes (source: %s)\n",
+                xhc_colltype_to_str(t),
+                config->hierarchy_string, xhc_config_source_to_str(config->hierarchy_source),
+                config->cico_max, xhc_config_source_to_str(config->cico_max_source));
         } else {
             printf("\n"
                 "  [%s]\n"
@@ -647,9 +755,10 @@ static int xhc_print_op_hierarchy_dot(xhc_module_t *module,
         char *dir;
 
         switch(colltype) {
-            case XHC_BCAST:
+            case XHC_BCAST: case XHC_SCATTER: case XHC_REDUCE_SCATTER_BLOCK:
                 dir = "forward"; break;
             case XHC_REDUCE: case XHC_ALLREDUCE:
+            case XHC_GATHER: case XHC_ALLGATHER:
                 dir = "back"; break;
             case XHC_BARRIER:
                 dir = "both"; break;
@@ -792,6 +901,39 @@ int mca_coll_xhc_copy_from(xhc_peer_info_t *peer_info,
     return (OPAL_SUCCESS == status ? 0 : -1);
 }
 
+int mca_coll_xhc_copy_to(xhc_peer_info_t *peer_info,
+        void *src, void *dst, size_t size, void *access_token) {
+
+    mca_smsc_endpoint_t *smsc_ep = xhc_smsc_ep(peer_info);
+
+    if(NULL == smsc_ep) {
+        return -1;
+    }
+
+    int status = MCA_SMSC_CALL(copy_to, smsc_ep,
+        src, dst, size, access_token);
+
+    return (OPAL_SUCCESS == status ? 0 : -1);
+}
+
+/* Copy a list of regions at once; with smsc/cma this is
+ * a single process_vm_readv() rather than one per region. */
+int mca_coll_xhc_copy_from_iov(xhc_peer_info_t *peer_info,
+        const struct iovec *dst_iov, const struct iovec *src_iov,
+        size_t iov_count, void *access_token) {
+
+    mca_smsc_endpoint_t *smsc_ep = xhc_smsc_ep(peer_info);
+
+    if(NULL == smsc_ep) {
+        return -1;
+    }
+
+    int status = MCA_SMSC_CALL(copy_from_iov, smsc_ep, dst_iov,
+        iov_count, src_iov, iov_count, access_token);
+
+    return (OPAL_SUCCESS == status ? 0 : -1);
+}
+
 void mca_coll_xhc_copy_close_region(xhc_copy_data_t *region_data) {
     if(mca_smsc_base_has_feature(MCA_SMSC_FEATURE_REQUIRE_REGISTRATION)) {
         MCA_SMSC_CALL(deregister_region, region_data);
@@ -824,3 +966,109 @@ void mca_coll_xhc_return_registration(xhc_reg_t *reg) {
      * MCA_RCACHE_FLAGS_PERSIST flag to map_peer_region */
     MCA_SMSC_CALL(unmap_peer_region, reg);
 }
+
+// ------------------------------------------------
+
+/* Temporary (private) buffer for ops that need one
+ * for intermediate data, such as reduce's non-root ranks */
+void *mca_coll_xhc_get_rbuf(xhc_module_t *module, size_t size) {
+    if(module->rbuf_size < size) {
+        void *new_rbuf = realloc(module->rbuf, size);
+        if(!new_rbuf) {return NULL;}
+
+        module->rbuf = new_rbuf;
+        module->rbuf_size = size;
+    }
+
+    return module->rbuf;
+}
+
+void *mca_coll_xhc_get_stage(xhc_module_t *module, size_t size) {
+    if(module->stage_size < size) {
+        void *new_stage = realloc(module->stage, size);
+        if(!new_stage) {return NULL;}
+
+        module->stage = new_stage;
+        module->stage_size = size;
+    }
+
+    return module->stage;
+}
+
+// ------------------------------------------------
+
+/* Expose a buffer for the direct op with the given seq. The peers will find
+ * it in the rank's entry in the peer table, once they observe its seq. */
+int mca_coll_xhc_peer_publish(xhc_module_t *module, void *buf,
+        size_t size, xf_sig_t seq, xhc_copy_data_t **region_data) {
+
+    xhc_peer_ctrl_t *my_ctrl = XHC_PEER_CTRL(module, module->rank);
+
+    *region_data = NULL;
+
+    if(NULL != buf && size > 0) {
+        int err = xhc_copy_expose_region(buf, size, region_data);
+        if(0 != err) {return OMPI_ERROR;}
+
+        if(NULL != *region_data) {
+            xhc_copy_region_post((void *) my_ctrl->access_token, *region_data);
+        }
+    }
+
+    my_ctrl->vaddr = buf;
+
+    /* Make sure the above stores complete
+     * before the one to the control flag */
+    xhc_atomic_wmb();
+
+    my_ctrl->seq = seq;
+
+    return OMPI_SUCCESS;
+}
+
+/* Get a peer's entry in the peer table, once it has published its
+ * buffer for the op with the given seq. Returns NULL if the peer hasn't
+ * done so yet and the check is non-blocking. */
+xhc_peer_ctrl_t *mca_coll_xhc_peer_wait(xhc_module_t *module,
+        int rank, xf_sig_t seq, bool blocking) {
+
+    xhc_peer_ctrl_t *ctrl = XHC_PEER_CTRL(module, rank);
+
+    if(blocking) {
+        WAIT_FLAG(&ctrl->seq, seq, 0);
+    } else if(!CHECK_FLAG(&ctrl->seq, seq, 0)) {
+        return NULL;
+    }
+
+    xhc_atomic_rmb();
+
+    return ctrl;
+}
+
+/* Signal that this rank is done with the peers' buffers for the op with the
+ * given seq, and wait until the ones that access this rank's buffer are also
+ * done: either a specific rank, or all of them (wait_rank = -1). */
+void mca_coll_xhc_peer_ack(xhc_module_t *module, xf_sig_t seq,
+        int wait_rank, xhc_copy_data_t *region_data) {
+
+    /* Make sure any copies have completed
+     * before the store to the ack flag */
+    xhc_atomic_fmb();
+
+    XHC_PEER_CTRL(module, module->rank)->ack = seq;
+
+    for(int r = 0; r < module->comm_size; r++) {
+        if(r == module->rank || (wait_rank >= 0 && r != wait_rank)) {
+            continue;
+        }
+
+        /* A peer that had nothing to wait for in this op might already
+         * have acked the next one (but no further, as that would need
+         * this rank to have joined it); hence the window of 1. */
+        WAIT_FLAG(&XHC_PEER_CTRL(module, r)->ack, seq, 1);
+    }
+
+    if(region_data) {
+        xhc_copy_close_region(region_data);
+    }
+}
@@ -15,6 +15,7 @@
 
 #include <stdint.h>
 #include <limits.h>
+#include <sys/uio.h>
 
 #include "mpi.h"
 
@@ -113,6 +114,7 @@ typedef struct mca_coll_xhc_module_t xhc_module_t;
 
 typedef struct xhc_coll_fns_t xhc_coll_fns_t;
 typedef struct xhc_peer_info_t xhc_peer_info_t;
+typedef struct xhc_peer_ctrl_t xhc_peer_ctrl_t;
 
 typedef struct xhc_op_mca_t xhc_op_mca_t;
 typedef struct xhc_op_config_t xhc_op_config_t;
@@ -174,10 +176,36 @@ typedef enum XHC_COLLTYPE_T {
     XHC_BARRIER,
     XHC_REDUCE,
     XHC_ALLREDUCE,
+    XHC_GATHER,
+    XHC_SCATTER,
+    XHC_ALLGATHER,
+    XHC_REDUCE_SCATTER_BLOCK,
+    XHC_GATHERV,
+    XHC_SCATTERV,
+    XHC_ALLGATHERV,
+    XHC_ALLTOALL,
 
     XHC_COLLCOUNT
 } XHC_COLLTYPE_T;
 
+/* Collectives that move the data directly between the ranks' buffers,
+ * through the peer table, rather than along the hierarchy. The hierarchy,
+ * chunk size and CICO settings don't apply to them. */
+#define XHC_COLLTYPE_IS_DIRECT(colltype) \
+    (XHC_GATHERV == (colltype) || XHC_SCATTERV == (colltype) \
+    || XHC_ALLGATHERV == (colltype) || XHC_ALLTOALL == (colltype))
+
+/* Collectives that pipeline their data, and thus have a chunk size */
+#define XHC_COLLTYPE_IS_PIPELINED(colltype) \
+    (XHC_BCAST == (colltype) || XHC_REDUCE == (colltype) \
+    || XHC_ALLREDUCE == (colltype))
+
+/* Collectives that stage data in the per-rank CICO buffers */
+#define XHC_COLLTYPE_USES_CICO(colltype) \
+    (XHC_BCAST == (colltype) || XHC_GATHER == (colltype) \
+    || XHC_SCATTER == (colltype) || XHC_ALLGATHER == (colltype) \
+    || XHC_REDUCE_SCATTER_BLOCK == (colltype))
+
 typedef enum xhc_config_source_t {
     XHC_CONFIG_SOURCE_INFO_GLOBAL = 0,
     XHC_CONFIG_SOURCE_INFO_OP,
@@ -250,6 +278,11 @@ struct mca_coll_xhc_module_t {
     void *rbuf;
     size_t rbuf_size;
 
+    /* Leaders' staging buffer in gather and scatter; separate from rbuf, as
+     * a (multi-sliced) reduce's leaders may exit while it's still read. */
+    void *stage;
+    size_t stage_size;
+
     // book-keeping for info on other ranks
     struct xhc_peer_info_t {
         xhc_loc_t locality;
@@ -261,6 +294,13 @@ struct mca_coll_xhc_module_t {
         void *cico_buffer;
     } *peer_info;
 
+    /* Per-rank control table, for the collectives that move data
+     * directly between the ranks (see XHC_COLLTYPE_IS_DIRECT) */
+    void *peer_ctrl;
+    size_t peer_ctrl_stride;
+    opal_shmem_ds_t peer_ctrl_ds;
+    xf_sig_t peer_seq;
+
     // ---
 
     opal_hash_table_t hierarchy_cache;
@@ -367,6 +407,11 @@ struct xhc_comm_t {
         xhc_reg_t *sbuf_reg, *rbuf_reg;
         void *sbuf, *rbuf;
         bool attach, join;
+
+        /* The ranks in the member's subtree, for the collectives
+         * that move per-rank blocks (see xhc_comms_map_subtrees) */
+        xhc_rank_range_t *ranges;
+        int n_ranges;
     } *member_info;
 
     xhc_member_info_t *my_info; // = &member_info[my_id]
@@ -450,6 +495,19 @@ struct xhc_member_ctrl_t {
     };
 } __attribute__((aligned(XHC_ALIGN)));
 
+struct xhc_peer_ctrl_t {
+    volatile xf_sig_t ack;
+    volatile xf_sig_t seq __attribute__((aligned(XHC_ALIGN)));
+
+    // below fields in same cache line as seq
+
+    void* volatile vaddr;
+
+    /* Actually sized according to the smsc registration
+     * data size (see peer_ctrl_stride). Keep it last. */
+    volatile char access_token[];
+} __attribute__((aligned(XHC_ALIGN)));
+
 // -----
 
 struct xhc_reduce_queue_item_t {
@@ -576,9 +634,19 @@ void mca_coll_xhc_module_set_coll_fns(ompi_communicator_t *comm,
 #define xhc_copy_from(...) mca_coll_xhc_copy_from(__VA_ARGS__)
 #define xhc_copy_close_region(...) mca_coll_xhc_copy_close_region(__VA_ARGS__)
 
+#define xhc_copy_to(...) mca_coll_xhc_copy_to(__VA_ARGS__)
+#define xhc_copy_from_iov(...) mca_coll_xhc_copy_from_iov(__VA_ARGS__)
+
 #define xhc_get_registration(...) mca_coll_xhc_get_registration(__VA_ARGS__)
 #define xhc_return_registration(...) mca_coll_xhc_return_registration(__VA_ARGS__)
 
+#define xhc_get_rbuf(...) mca_coll_xhc_get_rbuf(__VA_ARGS__)
+#define xhc_get_stage(...) mca_coll_xhc_get_stage(__VA_ARGS__)
+
+#define xhc_peer_publish(...) mca_coll_xhc_peer_publish(__VA_ARGS__)
+#define xhc_peer_wait(...) mca_coll_xhc_peer_wait(__VA_ARGS__)
+#define xhc_peer_ack(...) mca_coll_xhc_peer_ack(__VA_ARGS__)
+
 int mca_coll_xhc_lazy_init(mca_coll_xhc_module_t *module, ompi_communicator_t *comm);
 int mca_coll_xhc_init_op(xhc_module_t *module, ompi_communicator_t *comm,
     XHC_COLLTYPE_T colltype);
@@ -600,10 +668,26 @@ int mca_coll_xhc_copy_from(xhc_peer_info_t *peer_info, void *dst,
     void *src, size_t size, void *access_token);
 void mca_coll_xhc_copy_close_region(xhc_copy_data_t *region_data);
 
+int mca_coll_xhc_copy_to(xhc_peer_info_t *peer_info, void *src,
+    void *dst, size_t size, void *access_token);
+int mca_coll_xhc_copy_from_iov(xhc_peer_info_t *peer_info,
+    const struct iovec *dst_iov, const struct iovec *src_iov,
+    size_t iov_count, void *access_token);
+
 void *mca_coll_xhc_get_registration(xhc_peer_info_t *peer_info,
     void *peer_vaddr, size_t size, xhc_reg_t **reg);
 void mca_coll_xhc_return_registration(xhc_reg_t *reg);
 
+void *mca_coll_xhc_get_rbuf(xhc_module_t *module, size_t size);
+void *mca_coll_xhc_get_stage(xhc_module_t *module, size_t size);
+
+int mca_coll_xhc_peer_publish(xhc_module_t *module, void *buf,
+    size_t size, xf_sig_t seq, xhc_copy_data_t **region_data);
+xhc_peer_ctrl_t *mca_coll_xhc_peer_wait(xhc_module_t *module,
+    int rank, xf_sig_t seq, bool blocking);
+void mca_coll_xhc_peer_ack(xhc_module_t *module, xf_sig_t seq,
+    int wait_rank, xhc_copy_data_t *region_data);
+
 // coll_xhc_comm.c
 // --------------------
 
@@ -641,6 +725,45 @@ int mca_coll_xhc_allreduce(const void *sbuf, void *rbuf,
     size_t count, ompi_datatype_t *datatype, ompi_op_t *op,
     ompi_communicator_t *comm, mca_coll_base_module_t *module);
 
+int mca_coll_xhc_gather(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, int root, ompi_communicator_t *comm,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_gatherv(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, ompi_count_array_t rcounts,
+    ompi_disp_array_t displs, ompi_datatype_t *rdtype, int root,
+    ompi_communicator_t *comm, mca_coll_base_module_t *module);
+
+int mca_coll_xhc_scatter(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, int root, ompi_communicator_t *comm,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_scatterv(const void *sbuf, ompi_count_array_t scounts,
+    ompi_disp_array_t displs, ompi_datatype_t *sdtype, void *rbuf,
+    size_t rcount, ompi_datatype_t *rdtype, int root,
+    ompi_communicator_t *comm, mca_coll_base_module_t *module);
+
+int mca_coll_xhc_allgather(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, ompi_communicator_t *comm,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_allgatherv(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, ompi_count_array_t rcounts,
+    ompi_disp_array_t displs, ompi_datatype_t *rdtype,
+    ompi_communicator_t *comm, mca_coll_base_module_t *module);
+
+int mca_coll_xhc_alltoall(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, ompi_communicator_t *comm,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_reduce_scatter_block(const void *sbuf, void *rbuf,
+    size_t rcount, ompi_datatype_t *datatype, ompi_op_t *op,
+    ompi_communicator_t *comm, mca_coll_base_module_t *module);
+
 // coll_xhc_bcast.c
 // ----------------
 
@@ -672,8 +795,76 @@ int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
     ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
     mca_coll_base_module_t *module, bool require_bcast);
 
+// coll_xhc_gather.c
+// -----------------
+
+#define xhc_gather_internal(...) mca_coll_xhc_gather_internal(__VA_ARGS__)
+#define xhc_gather_direct(...) mca_coll_xhc_gather_direct(__VA_ARGS__)
+
+int mca_coll_xhc_gather_internal(const void *sbuf, void *rbuf, void *stage,
+    size_t bytes, ompi_communicator_t *ompi_comm, xhc_module_t *module,
+    XHC_COLLTYPE_T colltype);
+int mca_coll_xhc_gather_direct(const void *sbuf, size_t sbytes, void *rbuf,
+    size_t bytes, ompi_count_array_t rcounts, ompi_disp_array_t displs,
+    int root, ompi_communicator_t *ompi_comm, xhc_module_t *module);
+
+// coll_xhc_scatter.c
+// ------------------
+
+#define xhc_scatter_internal(...) mca_coll_xhc_scatter_internal(__VA_ARGS__)
+#define xhc_scatter_direct(...) mca_coll_xhc_scatter_direct(__VA_ARGS__)
+
+int mca_coll_xhc_scatter_internal(const void *sbuf, void *rbuf,
+    size_t bytes, ompi_communicator_t *ompi_comm, xhc_module_t *module,
+    XHC_COLLTYPE_T colltype);
+int mca_coll_xhc_scatter_direct(const void *sbuf, size_t bytes,
+    ompi_count_array_t scounts, ompi_disp_array_t displs, void *rbuf,
+    size_t rbytes, int root, ompi_communicator_t *ompi_comm,
+    xhc_module_t *module);
+
+// coll_xhc_allgather.c
+// --------------------
+
+#define xhc_allgather_direct(...) mca_coll_xhc_allgather_direct(__VA_ARGS__)
+
+int mca_coll_xhc_allgather_direct(const void *sbuf, size_t sbytes, void *rbuf,
+    size_t bytes, ompi_count_array_t rcounts, ompi_disp_array_t displs,
+    ompi_communicator_t *ompi_comm, xhc_module_t *module);
+
 // ----------------------------------------
 
+/* Size and offset (in bytes) of a rank's block in the (v-)variants of the
+ * block-moving collectives. Without counts/displacements, all blocks are of
+ * 'unit' bytes and packed; otherwise 'unit' is the datatype's size. */
+static inline size_t XHC_BLOCK_SIZE(ompi_count_array_t counts,
+        size_t unit, int rank) {
+    return (counts ? ompi_count_array_get(counts, rank) * unit : unit);
+}
+
+static inline ptrdiff_t XHC_BLOCK_OFFSET(ompi_disp_array_t displs,
+        size_t unit, int rank) {
+    return (displs ? ompi_disp_array_get(displs, rank) * (ptrdiff_t) unit
+        : (ptrdiff_t) (rank * unit));
+}
+
+// Size of the per-rank CICO buffer, shared by all ops that use CICO
+static inline size_t xhc_cico_buffer_size(xhc_module_t *module) {
+    size_t size = 0;
+
+    for(int t = 0; t < XHC_COLLCOUNT; t++) {
+        if(XHC_COLLTYPE_USES_CICO(t)) {
+            size = opal_max(size, module->op_config[t].cico_max);
+        }
+    }
+
+    return size;
+}
+
+static inline xhc_peer_ctrl_t *XHC_PEER_CTRL(xhc_module_t *module, int rank) {
+    return (xhc_peer_ctrl_t *) ((char *) module->peer_ctrl
+        + rank * module->peer_ctrl_stride);
+}
+
 /* Rollover-safe check that _flag_ has reached _thresh_,
  * without having exceeded it by more than _win_. */
 static inline bool CHECK_FLAG(volatile xf_sig_t *flag,
@@ -0,0 +1,225 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "opal/util/show_help.h"
+#include "opal/util/minmax.h"
+
+#include "coll_xhc.h"
+
+// ------------------------------------------------
+
+/* Direct Allgather(v)
+ * -------------------
+ * Used for allgatherv, and for allgather with smsc components that require
+ * registration. Every rank publishes its send buffer in the peer table and
+ * copies from all others, starting from its next rank to spread the load. */
+int mca_coll_xhc_allgather_direct(const void *sbuf, size_t sbytes, void *rbuf,
+        size_t bytes, ompi_count_array_t rcounts, ompi_disp_array_t displs,
+        ompi_communicator_t *ompi_comm, xhc_module_t *module) {
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_copy_data_t *region_data = NULL;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    char *my_block = (char *) rbuf + XHC_BLOCK_OFFSET(displs, bytes, rank);
+    int err;
+
+    if(MPI_IN_PLACE == sbuf) {
+        sbuf = my_block;
+        sbytes = XHC_BLOCK_SIZE(rcounts, bytes, rank);
+    }
+
+    xf_sig_t seq = ++module->peer_seq;
+
+    err = xhc_peer_publish(module, (void *) sbuf, sbytes, seq, &region_data);
+    if(OMPI_SUCCESS != err) {return err;}
+
+    if(my_block != sbuf) {
+        xhc_memcpy(my_block, sbuf, XHC_BLOCK_SIZE(rcounts, bytes, rank));
+    }
+
+    // ---
+
+    bool done[comm_size];
+    int pending = comm_size - 1;
+
+    memset(done, 0, sizeof(done));
+
+    while(pending > 0) {
+        for(int i = 1; i < comm_size; i++) {
+            int r = (rank + i) % comm_size;
+
+            if(done[r]) {
+                continue;
+            }
+
+            xhc_peer_ctrl_t *ctrl = xhc_peer_wait(module, r, seq, false);
+            if(NULL == ctrl) {continue;}
+
+            size_t size = XHC_BLOCK_SIZE(rcounts, bytes, r);
+
+            if(size > 0) {
+                err = xhc_copy_from(&peer_info[r], (char *) rbuf
+                    + XHC_BLOCK_OFFSET(displs, bytes, r), ctrl->vaddr,
+                    size, (void *) ctrl->access_token);
+                if(0 != err) {return OMPI_ERROR;}
+            }
+
+            done[r] = true;
+            pending--;
+        }
+    }
+
+    xhc_peer_ack(module, seq, -1, region_data);
+
+    return OMPI_SUCCESS;
+}
+
+// ------------------------------------------------
+
+/* Allgather is a hierarchical gather to rank 0, directly in the leaders'
+ * rbufs, followed by a broadcast of the whole rbuf (through the comm's
+ * bcast, ie. normally XHC's own pipelined one). */
+int mca_coll_xhc_allgather(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+        ompi_datatype_t *rdtype, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    size_t dtype_size;
+    int err;
+
+    // ---
+
+    if(!ompi_datatype_is_predefined(rdtype)
+            || (MPI_IN_PLACE != sbuf && !ompi_datatype_is_predefined(sdtype))) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    ompi_datatype_type_size(rdtype, &dtype_size);
+    size_t bytes = rcount * dtype_size;
+
+    size_t cico_size = module->op_config[XHC_ALLGATHER].cico_max;
+    bool cico = (comm_size * bytes <= cico_size);
+
+    if(!module->zcopy_support && !cico) {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; utilizing fallback "
+            "component for allgather greater than %zu bytes", cico_size);
+        goto _fallback;
+    }
+
+    // ---
+
+    // See mca_coll_xhc_gather() regarding registration
+    if(cico || !mca_smsc_base_has_feature(MCA_SMSC_FEATURE_REQUIRE_REGISTRATION)) {
+        if(!module->op_data[XHC_ALLGATHER].init) {
+            err = xhc_init_op(module, ompi_comm, XHC_ALLGATHER);
+            if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+        }
+
+        if(MPI_IN_PLACE == sbuf) {
+            sbuf = (char *) rbuf + rank * bytes;
+        }
+
+        err = xhc_gather_internal(sbuf, rbuf, rbuf,
+            bytes, ompi_comm, module, XHC_ALLGATHER);
+        if(OMPI_SUCCESS != err) {return err;}
+
+        return ompi_comm->c_coll->coll_bcast(rbuf, rcount * comm_size,
+            rdtype, 0, ompi_comm, ompi_comm->c_coll->coll_bcast_module);
+    }
+
+    // The direct path's state is kept in allgatherv's op data
+    if(!module->op_data[XHC_ALLGATHERV].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_ALLGATHERV);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    return xhc_allgather_direct(sbuf, bytes, rbuf,
+        bytes, 0, 0, ompi_comm, module);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module,
+        ompi_comm, XHC_ALLGATHER, allgather);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_ALLGATHER, allgather,
+        sbuf, scount, sdtype, rbuf, rcount, rdtype, ompi_comm);
+}
+
+int mca_coll_xhc_allgatherv(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, ompi_count_array_t rcounts,
+        ompi_disp_array_t displs, ompi_datatype_t *rdtype,
+        ompi_communicator_t *ompi_comm, mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    size_t sdtype_size = 0, rdtype_size;
+    int err;
+
+    // ---
+
+    if(!ompi_datatype_is_predefined(rdtype)
+            || (MPI_IN_PLACE != sbuf && !ompi_datatype_is_predefined(sdtype))) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(!module->zcopy_support) {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; "
+            "utilizing fallback component for allgatherv");
+        goto _fallback;
+    }
+
+    // ---
+
+    if(!module->op_data[XHC_ALLGATHERV].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_ALLGATHERV);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    if(MPI_IN_PLACE != sbuf) {
+        ompi_datatype_type_size(sdtype, &sdtype_size);
+    }
+
+    ompi_datatype_type_size(rdtype, &rdtype_size);
+
+    return xhc_allgather_direct(sbuf, scount * sdtype_size, rbuf,
+        rdtype_size, rcounts, displs, ompi_comm, module);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module,
+        ompi_comm, XHC_ALLGATHERV, allgatherv);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_ALLGATHERV, allgatherv,
+        sbuf, scount, sdtype, rbuf, rcounts, displs, rdtype, ompi_comm);
+}
@@ -1005,15 +1005,8 @@ int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
      * TODO: Strictly speaking, the members that won't do reductions, shouldn't
      * require an rbuf; consult this and don't allocate one for them?? */
     if(NULL == rbuf) {
-        if(module->rbuf_size < bytes_total) {
-            void *new_rbuf = realloc(module->rbuf, bytes_total);
-            if(!new_rbuf) {return OPAL_ERR_OUT_OF_RESOURCE;}
-
-            module->rbuf = new_rbuf;
-            module->rbuf_size = bytes_total;
-        }
-
-        rbuf = module->rbuf;
+        rbuf = xhc_get_rbuf(module, bytes_total);
+        if(!rbuf) {return OPAL_ERR_OUT_OF_RESOURCE;}
     }
 
     if(MPI_IN_PLACE == sbuf) {
@@ -0,0 +1,133 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "opal/util/show_help.h"
+#include "opal/util/minmax.h"
+
+#include "coll_xhc.h"
+
+// ------------------------------------------------
+
+/* Direct Alltoall
+ * ---------------
+ * Every rank publishes its send buffer in the peer table, and copies its
+ * block from each peer's, starting from its next rank to spread the load.
+ * There's no hierarchical variant, as no data is shared between ranks. */
+static int xhc_alltoall_direct(const void *sbuf, void *rbuf, size_t bytes,
+        ompi_communicator_t *ompi_comm, xhc_module_t *module) {
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_copy_data_t *region_data = NULL;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    int err;
+
+    xf_sig_t seq = ++module->peer_seq;
+
+    err = xhc_peer_publish(module, (void *) sbuf,
+        comm_size * bytes, seq, &region_data);
+    if(OMPI_SUCCESS != err) {return err;}
+
+    xhc_memcpy_offset(rbuf, sbuf, rank * bytes, bytes);
+
+    bool done[comm_size];
+    int pending = comm_size - 1;
+
+    memset(done, 0, sizeof(done));
+
+    while(pending > 0) {
+        for(int i = 1; i < comm_size; i++) {
+            int r = (rank + i) % comm_size;
+
+            if(done[r]) {
+                continue;
+            }
+
+            xhc_peer_ctrl_t *ctrl = xhc_peer_wait(module, r, seq, false);
+            if(NULL == ctrl) {continue;}
+
+            if(bytes > 0) {
+                err = xhc_copy_from(&peer_info[r], (char *) rbuf + r * bytes,
+                    (char *) ctrl->vaddr + rank * bytes, bytes,
+                    (void *) ctrl->access_token);
+                if(0 != err) {return OMPI_ERROR;}
+            }
+
+            done[r] = true;
+            pending--;
+        }
+    }
+
+    xhc_peer_ack(module, seq, -1, region_data);
+
+    return OMPI_SUCCESS;
+}
+
+int mca_coll_xhc_alltoall(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+        ompi_datatype_t *rdtype, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    size_t dtype_size;
+    int err;
+
+    // ---
+
+    if(MPI_IN_PLACE == sbuf) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "in-place alltoall; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(!ompi_datatype_is_predefined(sdtype)
+            || !ompi_datatype_is_predefined(rdtype)) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(!module->zcopy_support) {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; "
+            "utilizing fallback component for alltoall");
+        goto _fallback;
+    }
+
+    // ---
+
+    if(!module->op_data[XHC_ALLTOALL].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_ALLTOALL);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    ompi_datatype_type_size(rdtype, &dtype_size);
+
+    return xhc_alltoall_direct(sbuf, rbuf,
+        rcount * dtype_size, ompi_comm, module);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module,
+        ompi_comm, XHC_ALLTOALL, alltoall);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_ALLTOALL, alltoall,
+        sbuf, scount, sdtype, rbuf, rcount, rdtype, ompi_comm);
+}
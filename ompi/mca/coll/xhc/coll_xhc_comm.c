@@ -22,6 +22,11 @@
 
 // ------------------------------------------------
 
+static int xhc_comms_map_subtrees(ompi_communicator_t *ompi_comm,
+    xhc_comm_t *comms, int comm_count);
+
+// ------------------------------------------------
+
 /* This is the method that constructs XHC's hierarchies. It receives a
  * config object that contains the specs (a list of localities) for the
  * new hierarchiy. The algorithm groups ranks together according to it,
@@ -348,6 +353,18 @@ int mca_coll_xhc_comms_make(ompi_communicator_t *ompi_comm,
 
     REALLOC(comms, comm_count, xhc_comm_t);
 
+    // The ops that move per-rank blocks need to know who's under whom
+    if(XHC_GATHER == data->colltype || XHC_SCATTER == data->colltype
+            || XHC_ALLGATHER == data->colltype
+            || XHC_REDUCE_SCATTER_BLOCK == data->colltype) {
+
+        err = xhc_comms_map_subtrees(ompi_comm, comms, comm_count);
+        if(OMPI_SUCCESS != err) {
+            xhc_comms_destroy(comms, comm_count);
+            RETURN_WITH_ERROR(return_code, err, end);
+        }
+    }
+
     data->comms = comms;
     data->comm_count = comm_count;
 
@@ -367,6 +384,117 @@ int mca_coll_xhc_comms_make(ompi_communicator_t *ompi_comm,
     return return_code;
 }
 
+/* The ops that move per-rank blocks (e.g. gather) have each leader handle,
+ * for each member, the blocks of all the ranks in that member's subtree. To
+ * find these, every rank shares its direct leader (the owner of the lowest
+ * comm in which it's not the owner itself), and that comm's locality. A
+ * comm's members are its owner, plus the ranks that have the owner as their
+ * leader on the comm's locality, with member IDs following rank order. The
+ * subtree of a member comprises the ranks whose chain of leaders goes
+ * through it. The owner of a comm always has the lowest rank in it, so
+ * any chain of leaders is strictly decreasing, and eventually ends at the
+ * top-most owner (who has no leader). */
+static int xhc_comms_map_subtrees(ompi_communicator_t *ompi_comm,
+        xhc_comm_t *comms, int comm_count) {
+
+    int n_ranks = ompi_comm_size(ompi_comm);
+
+    int my_leader[2] = {-1, 0};
+    int *leader_list = NULL;
+    int *members = NULL;
+
+    int return_code = OMPI_SUCCESS;
+    int err;
+
+    for(int i = 0; i < comm_count; i++) {
+        if(0 != comms[i].my_id) {
+            my_leader[0] = comms[i].owner_rank;
+            my_leader[1] = (int) comms[i].locality;
+            break;
+        }
+    }
+
+    leader_list = malloc(2 * n_ranks * sizeof(int));
+    members = malloc(n_ranks * sizeof(int));
+
+    if(!leader_list || !members) {
+        RETURN_WITH_ERROR(return_code, OMPI_ERR_OUT_OF_RESOURCE, end);
+    }
+
+    err = ompi_comm->c_coll->coll_allgather(my_leader, 2, MPI_INT,
+        leader_list, 2, MPI_INT, ompi_comm,
+        ompi_comm->c_coll->coll_allgather_module);
+    if(OMPI_SUCCESS != err) {RETURN_WITH_ERROR(return_code, err, end);}
+
+    for(int i = 0; i < comm_count; i++) {
+        xhc_comm_t *xc = &comms[i];
+        int n_members = 0;
+
+        members[n_members++] = xc->owner_rank;
+
+        for(int r = 0; r < n_ranks; r++) {
+            if(leader_list[2*r] == xc->owner_rank
+                    && (xhc_loc_t) leader_list[2*r + 1] == xc->locality) {
+                members[n_members++] = r;
+            }
+        }
+
+        if(n_members != xc->size) {
+            opal_output_verbose(MCA_BASE_VERBOSE_ERROR,
+                ompi_coll_base_framework.framework_output,
+                "coll:xhc: Error: Member mapping mismatch for locality "
+                "0x%04x (%d vs %d members)", xc->locality, n_members, xc->size);
+
+            RETURN_WITH_ERROR(return_code, OMPI_ERROR, end);
+        }
+
+        // The owner's subtree is never of interest to anyone
+        for(int m = 1; m < xc->size; m++) {
+            xhc_member_info_t *info = &xc->member_info[m];
+            int ranges_size = 0;
+
+            for(int r = 0; r < n_ranks; r++) {
+                int l = r;
+
+                while(-1 != l && members[m] != l) {
+                    l = leader_list[2*l];
+                }
+
+                if(-1 == l) {
+                    continue;
+                }
+
+                if(info->n_ranges > 0 && r - 1
+                        == info->ranges[info->n_ranges - 1].end_rank) {
+                    info->ranges[info->n_ranges - 1].end_rank = r;
+                    continue;
+                }
+
+                if(info->n_ranges == ranges_size) {
+                    ranges_size = (ranges_size > 0 ? 2 * ranges_size : 4);
+
+                    void *tmp = realloc(info->ranges,
+                        ranges_size * sizeof(xhc_rank_range_t));
+                    if(!tmp) {RETURN_WITH_ERROR(return_code,
+                        OMPI_ERR_OUT_OF_RESOURCE, end);}
+
+                    info->ranges = tmp;
+                }
+
+                info->ranges[info->n_ranges++] = (xhc_rank_range_t) {
+                    .start_rank = r, .end_rank = r};
+            }
+        }
+    }
+
+    end:
+
+    free(leader_list);
+    free(members);
+
+    return return_code;
+}
+
 void mca_coll_xhc_comms_destroy(xhc_comm_t *comms, int comm_count) {
     bool is_owner = true;
 
@@ -378,6 +506,13 @@ void mca_coll_xhc_comms_destroy(xhc_comm_t *comms, int comm_count) {
         }
 
         free(xc->slices);
+
+        if(xc->member_info) {
+            for(int m = 0; m < xc->size; m++) {
+                free(xc->member_info[m].ranges);
+            }
+        }
+
         free(xc->member_info);
 
         if(xc->reduce_queue) {
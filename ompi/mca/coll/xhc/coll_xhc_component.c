@@ -58,7 +58,15 @@ static const COLLTYPE_T xhc_colltype_to_universal_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = BCAST,
     [XHC_BARRIER] = BARRIER,
     [XHC_REDUCE] = REDUCE,
-    [XHC_ALLREDUCE] = ALLREDUCE
+    [XHC_ALLREDUCE] = ALLREDUCE,
+    [XHC_GATHER] = GATHER,
+    [XHC_SCATTER] = SCATTER,
+    [XHC_ALLGATHER] = ALLGATHER,
+    [XHC_REDUCE_SCATTER_BLOCK] = REDUCESCATTERBLOCK,
+    [XHC_GATHERV] = GATHERV,
+    [XHC_SCATTERV] = SCATTERV,
+    [XHC_ALLGATHERV] = ALLGATHERV,
+    [XHC_ALLTOALL] = ALLTOALL
 };
 
 static const char *xhc_config_source_to_str_map[XHC_CONFIG_SOURCE_COUNT] = {
@@ -144,7 +152,37 @@ static xhc_op_mca_t op_mca_default[XHC_COLLCOUNT] = {
         .hierarchy = "l3,numa,socket",
         .chunk_size = "16K",
         .cico_max = 4096
+    },
+
+    /* No pipelining in these; chunk_size is not registered as a
+     * parameter, and it's only here to keep xhc_read_op_config happy.
+     * The CICO threshold refers to the total (all ranks') data size. */
+
+    [XHC_GATHER] = {
+        .hierarchy = "numa,socket",
+        .chunk_size = "16K",
+        .cico_max = 4096
+    },
+
+    [XHC_SCATTER] = {
+        .hierarchy = "numa,socket",
+        .chunk_size = "16K",
+        .cico_max = 4096
+    },
+
+    [XHC_ALLGATHER] = {
+        .hierarchy = "numa,socket",
+        .chunk_size = "16K",
+        .cico_max = 4096
+    },
+
+    [XHC_REDUCE_SCATTER_BLOCK] = {
+        .hierarchy = "numa,socket",
+        .chunk_size = "16K",
+        .cico_max = 4096
     }
+
+    /* The direct ops (XHC_COLLTYPE_IS_DIRECT) don't have any */
 };
 static xhc_op_mca_t op_mca_global_default = {0};
 
@@ -385,6 +423,10 @@ static int xhc_register(void) {
     mca_base_var_get(vari, &var);
 
     for(int t = 0; t < XHC_COLLCOUNT; t++) {
+        if(XHC_COLLTYPE_IS_DIRECT(t)) {
+            continue;
+        }
+
         err = opal_asprintf(&name, "%s_hierarchy", xhc_colltype_to_str(t));
         if(err < 0) {free(topo_list); return OPAL_ERR_OUT_OF_RESOURCE;}
 
@@ -431,7 +473,7 @@ static int xhc_register(void) {
     mca_base_var_get(vari, &var);
 
     for(int t = 0; t < XHC_COLLCOUNT; t++) {
-        if(XHC_BARRIER == t) {
+        if(!XHC_COLLTYPE_IS_PIPELINED(t)) {
             continue;
         }
 
@@ -477,7 +519,7 @@ static int xhc_register(void) {
     mca_base_var_get(vari, &var);
 
     for(int t = 0; t < XHC_COLLCOUNT; t++) {
-        if(XHC_BARRIER == t) {
+        if(XHC_BARRIER == t || XHC_COLLTYPE_IS_DIRECT(t)) {
             continue;
         }
 
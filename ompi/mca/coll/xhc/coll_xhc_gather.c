@@ -0,0 +1,449 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "opal/util/show_help.h"
+#include "opal/util/minmax.h"
+
+#include "coll_xhc.h"
+
+// ------------------------------------------------
+
+/* Hierarchical Gather (root is the top-level owner, ie. rank 0)
+ * -------------------------------------------------------------
+ * Leadership is static: the owner of each xhc comm is its leader. Each
+ * leader has a rank-indexed staging area (the root's is its rbuf), where
+ * it places its own block and then the blocks of its members' subtrees.
+ *
+ * 1. Each rank exposes its data to its leader: a non-leader its own block,
+ *    a leader its staging area, once its subtree has been gathered in it.
+ *
+ * 2. A leader copies the blocks of each member's subtree (a few rank
+ *    ranges, see xhc_comms_map_subtrees) as soon as the member becomes
+ *    ready, across all the levels it leads. A member is released via the
+ *    comm's ack once the leader has copied from all the comm's members.
+ *
+ * Copies are made with the smsc copy_from primitives (no mapping), so this
+ * works with CMA too. For small messages, the CICO buffers are used instead.
+ * ------------------------------------------------------------- */
+
+static int xhc_gather_copy_member(xhc_comm_t *xc, int member,
+        xhc_peer_info_t *peer_info, void *area, size_t bytes,
+        xhc_copy_method_t method) {
+
+    xhc_member_ctrl_t *m_ctrl = &xc->member_ctrl[member];
+    xhc_member_info_t *m_info = &xc->member_info[member];
+
+    int m_rank = m_ctrl->rank;
+    int err;
+
+    if(0 == bytes) {
+        return OMPI_SUCCESS;
+    }
+
+    char *src = (XHC_COPY_CICO == method ?
+        xhc_get_cico(peer_info, m_rank) : m_ctrl->sbuf_vaddr);
+
+    // A non-leader member exposes only its own block
+    if(!m_ctrl->is_leader) {
+        char *dst = (char *) area + m_rank * bytes;
+
+        if(XHC_COPY_CICO == method) {
+            xhc_memcpy(dst, src, bytes);
+            return OMPI_SUCCESS;
+        }
+
+        err = xhc_copy_from(&peer_info[m_rank], dst, src, bytes, NULL);
+        return (0 == err ? OMPI_SUCCESS : OMPI_ERROR);
+    }
+
+    if(XHC_COPY_CICO == method) {
+        for(int i = 0; i < m_info->n_ranges; i++) {
+            xhc_rank_range_t *range = &m_info->ranges[i];
+
+            xhc_memcpy_offset(area, src, range->start_rank * bytes,
+                (range->end_rank - range->start_rank + 1) * bytes);
+        }
+
+        return OMPI_SUCCESS;
+    }
+
+    struct iovec dst_iov[m_info->n_ranges];
+    struct iovec src_iov[m_info->n_ranges];
+
+    for(int i = 0; i < m_info->n_ranges; i++) {
+        xhc_rank_range_t *range = &m_info->ranges[i];
+
+        size_t offset = range->start_rank * bytes;
+        size_t len = (range->end_rank - range->start_rank + 1) * bytes;
+
+        dst_iov[i] = (struct iovec) {.iov_base = (char *) area + offset, .iov_len = len};
+        src_iov[i] = (struct iovec) {.iov_base = src + offset, .iov_len = len};
+    }
+
+    err = xhc_copy_from_iov(&peer_info[m_rank], dst_iov,
+        src_iov, m_info->n_ranges, NULL);
+
+    return (0 == err ? OMPI_SUCCESS : OMPI_ERROR);
+}
+
+/* Gather all ranks' blocks of 'bytes' in rank 0's rbuf. Non-root leaders
+ * stage their subtree's blocks in 'stage' (at the respective rank-indexed
+ * offsets), or in the module's stage buffer if NULL. The caller resolves
+ * MPI_IN_PLACE; the hierarchical path is not used when the smsc component
+ * requires registration (see mca_coll_xhc_gather). */
+int mca_coll_xhc_gather_internal(const void *sbuf, void *rbuf, void *stage,
+        size_t bytes, ompi_communicator_t *ompi_comm, xhc_module_t *module,
+        XHC_COLLTYPE_T colltype) {
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_op_data_t *data = &module->op_data[colltype];
+    xhc_comm_t *comms = data->comms;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    xhc_comm_t *src_comm = NULL;
+    xhc_copy_method_t method;
+
+    void *area;
+    int err;
+
+    // ---
+
+    xf_sig_t seq = ++data->seq;
+
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        xc->is_leader = false;
+        xc->op_state = 0;
+    }
+
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        if(0 != xc->my_id) {
+            src_comm = xc;
+            break;
+        }
+
+        xc->is_leader = true;
+    }
+
+    bool is_leader = comms[0].is_leader;
+
+    method = (comm_size * bytes <= comms[0].cico_size ?
+        XHC_COPY_CICO : XHC_COPY_SMSC);
+
+    /* Safe to alter the CICO buffer without checking any flags, as
+     * in any past ops where others copied from it, this rank has
+     * waited for the respective acks before completing. */
+    if(0 == rank) {
+        area = rbuf;
+    } else if(XHC_COPY_CICO == method) {
+        area = xhc_get_cico(peer_info, rank);
+    } else if(is_leader) {
+        area = (stage ? stage : xhc_get_stage(module, comm_size * bytes));
+        if(NULL == area) {return OMPI_ERR_OUT_OF_RESOURCE;}
+    } else {
+        area = (void *) sbuf;
+    }
+
+    if(is_leader) {
+        char *dst = (char *) area + rank * bytes;
+
+        if(dst != sbuf) {
+            xhc_memcpy(dst, sbuf, bytes);
+        }
+    } else if(XHC_COPY_CICO == method) {
+        xhc_memcpy(area, sbuf, bytes);
+    }
+
+    // ---
+
+    if(is_leader) {
+        int pending = 0;
+
+        for(xhc_comm_t *xc = comms; xc && xc->is_leader; xc = xc->up) {
+            for(int m = 0; m < xc->size; m++) {
+                xc->member_info[m].join = false;
+            }
+
+            pending += xc->size - 1;
+        }
+
+        while(pending > 0) {
+            for(xhc_comm_t *xc = comms; xc && xc->is_leader; xc = xc->up) {
+                if(xc->op_state == xc->size - 1) {
+                    continue;
+                }
+
+                for(int m = 1; m < xc->size; m++) {
+                    if(xc->member_info[m].join
+                            || !CHECK_FLAG(&xc->member_ctrl[m].seq, seq, 0)) {
+                        continue;
+                    }
+
+                    xhc_atomic_rmb();
+
+                    err = xhc_gather_copy_member(xc, m,
+                        peer_info, area, bytes, method);
+                    if(OMPI_SUCCESS != err) {return err;}
+
+                    xc->member_info[m].join = true;
+                    xc->op_state++;
+                    pending--;
+                }
+
+                if(xc->op_state == xc->size - 1) {
+                    /* Make sure the copies have completed
+                     * before the store to the ack flag */
+                    xhc_atomic_fmb();
+
+                    xc->comm_ctrl->ack = seq;
+                }
+            }
+        }
+    }
+
+    // ---
+
+    if(src_comm) {
+        xhc_member_ctrl_t *my_ctrl = src_comm->my_ctrl;
+
+        my_ctrl->sbuf_vaddr = area;
+        my_ctrl->rank = rank;
+        my_ctrl->is_leader = is_leader;
+
+        xhc_atomic_wmb();
+
+        my_ctrl->seq = seq;
+
+        WAIT_FLAG(&src_comm->comm_ctrl->ack, seq, 0);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+// ------------------------------------------------
+
+/* Direct Gather(v)
+ * ----------------
+ * Used for gatherv, and for gather with a root other than rank 0. The
+ * non-root ranks publish their send buffers in the peer table, and the
+ * root copies from each one as soon as it becomes available. */
+int mca_coll_xhc_gather_direct(const void *sbuf, size_t sbytes, void *rbuf,
+        size_t bytes, ompi_count_array_t rcounts, ompi_disp_array_t displs,
+        int root, ompi_communicator_t *ompi_comm, xhc_module_t *module) {
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_copy_data_t *region_data = NULL;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    int err;
+
+    xf_sig_t seq = ++module->peer_seq;
+
+    if(rank != root) {
+        err = xhc_peer_publish(module, (void *) sbuf,
+            sbytes, seq, &region_data);
+        if(OMPI_SUCCESS != err) {return err;}
+
+        xhc_peer_ack(module, seq, root, region_data);
+
+        return OMPI_SUCCESS;
+    }
+
+    // ---
+
+    if(MPI_IN_PLACE != sbuf) {
+        xhc_memcpy((char *) rbuf + XHC_BLOCK_OFFSET(displs, bytes, rank),
+            sbuf, XHC_BLOCK_SIZE(rcounts, bytes, rank));
+    }
+
+    bool done[comm_size];
+    int pending = comm_size - 1;
+
+    memset(done, 0, sizeof(done));
+
+    while(pending > 0) {
+        for(int r = 0; r < comm_size; r++) {
+            if(r == rank || done[r]) {
+                continue;
+            }
+
+            xhc_peer_ctrl_t *ctrl = xhc_peer_wait(module, r, seq, false);
+            if(NULL == ctrl) {continue;}
+
+            size_t size = XHC_BLOCK_SIZE(rcounts, bytes, r);
+
+            if(size > 0) {
+                err = xhc_copy_from(&peer_info[r], (char *) rbuf
+                    + XHC_BLOCK_OFFSET(displs, bytes, r), ctrl->vaddr,
+                    size, (void *) ctrl->access_token);
+                if(0 != err) {return OMPI_ERROR;}
+            }
+
+            done[r] = true;
+            pending--;
+        }
+    }
+
+    xhc_peer_ack(module, seq, root, NULL);
+
+    return OMPI_SUCCESS;
+}
+
+// ------------------------------------------------
+
+int mca_coll_xhc_gather(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+        ompi_datatype_t *rdtype, int root, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    size_t dtype_size, bytes;
+    int err;
+
+    // ---
+
+    // Only the root's receive arguments are significant
+    if((rank == root && !ompi_datatype_is_predefined(rdtype))
+            || (MPI_IN_PLACE != sbuf && !ompi_datatype_is_predefined(sdtype))) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(rank == root) {
+        ompi_datatype_type_size(rdtype, &dtype_size);
+        bytes = rcount * dtype_size;
+    } else {
+        ompi_datatype_type_size(sdtype, &dtype_size);
+        bytes = scount * dtype_size;
+    }
+
+    size_t cico_size = module->op_config[XHC_GATHER].cico_max;
+    bool cico = (comm_size * bytes <= cico_size);
+
+    /* The hierarchical path is rooted at rank 0. The member control
+     * structs don't have room for registration data, so the direct
+     * path is also used with smsc components that require it. */
+    bool hierarchical = (0 == root && (cico || !mca_smsc_base_has_feature(
+        MCA_SMSC_FEATURE_REQUIRE_REGISTRATION)));
+
+    if(!module->zcopy_support && !(hierarchical && cico)) {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; utilizing fallback "
+            "component for non-zero-root gather or gather greater than "
+            "%zu bytes", cico_size);
+        goto _fallback;
+    }
+
+    // ---
+
+    if(hierarchical) {
+        if(!module->op_data[XHC_GATHER].init) {
+            err = xhc_init_op(module, ompi_comm, XHC_GATHER);
+            if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+        }
+
+        if(MPI_IN_PLACE == sbuf) {
+            sbuf = (char *) rbuf + rank * bytes;
+        }
+
+        return xhc_gather_internal(sbuf, rbuf, NULL,
+            bytes, ompi_comm, module, XHC_GATHER);
+    }
+
+    // The direct path's state is kept in gatherv's op data
+    if(!module->op_data[XHC_GATHERV].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_GATHERV);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    return xhc_gather_direct(sbuf, bytes, rbuf, bytes,
+        0, 0, root, ompi_comm, module);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module,
+        ompi_comm, XHC_GATHER, gather);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_GATHER, gather,
+        sbuf, scount, sdtype, rbuf, rcount, rdtype, root, ompi_comm);
+}
+
+int mca_coll_xhc_gatherv(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, ompi_count_array_t rcounts,
+        ompi_disp_array_t displs, ompi_datatype_t *rdtype, int root,
+        ompi_communicator_t *ompi_comm, mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int rank = ompi_comm_rank(ompi_comm);
+
+    size_t sdtype_size = 0, rdtype_size = 0;
+    int err;
+
+    // ---
+
+    if((rank == root && !ompi_datatype_is_predefined(rdtype))
+            || (MPI_IN_PLACE != sbuf && !ompi_datatype_is_predefined(sdtype))) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(!module->zcopy_support) {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; "
+            "utilizing fallback component for gatherv");
+        goto _fallback;
+    }
+
+    // ---
+
+    if(!module->op_data[XHC_GATHERV].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_GATHERV);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    if(MPI_IN_PLACE != sbuf) {
+        ompi_datatype_type_size(sdtype, &sdtype_size);
+    }
+
+    if(rank == root) {
+        ompi_datatype_type_size(rdtype, &rdtype_size);
+    }
+
+    return xhc_gather_direct(sbuf, scount * sdtype_size, rbuf,
+        rdtype_size, rcounts, displs, root, ompi_comm, module);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module,
+        ompi_comm, XHC_GATHERV, gatherv);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_GATHERV, gatherv,
+        sbuf, scount, sdtype, rbuf, rcounts, displs, rdtype, root, ompi_comm);
+}
@@ -40,21 +40,45 @@ static size_t xhc_colltype_to_c_coll_fn_offset_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = offsetof(mca_coll_base_comm_coll_t, coll_bcast),
     [XHC_BARRIER] = offsetof(mca_coll_base_comm_coll_t, coll_barrier),
     [XHC_REDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_reduce),
-    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce)
+    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce),
+    [XHC_GATHER] = offsetof(mca_coll_base_comm_coll_t, coll_gather),
+    [XHC_SCATTER] = offsetof(mca_coll_base_comm_coll_t, coll_scatter),
+    [XHC_ALLGATHER] = offsetof(mca_coll_base_comm_coll_t, coll_allgather),
+    [XHC_REDUCE_SCATTER_BLOCK] = offsetof(mca_coll_base_comm_coll_t, coll_reduce_scatter_block),
+    [XHC_GATHERV] = offsetof(mca_coll_base_comm_coll_t, coll_gatherv),
+    [XHC_SCATTERV] = offsetof(mca_coll_base_comm_coll_t, coll_scatterv),
+    [XHC_ALLGATHERV] = offsetof(mca_coll_base_comm_coll_t, coll_allgatherv),
+    [XHC_ALLTOALL] = offsetof(mca_coll_base_comm_coll_t, coll_alltoall)
 };
 
 static size_t xhc_colltype_to_c_coll_module_offset_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = offsetof(mca_coll_base_comm_coll_t, coll_bcast_module),
     [XHC_BARRIER] = offsetof(mca_coll_base_comm_coll_t, coll_barrier_module),
     [XHC_REDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_reduce_module),
-    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce_module)
+    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce_module),
+    [XHC_GATHER] = offsetof(mca_coll_base_comm_coll_t, coll_gather_module),
+    [XHC_SCATTER] = offsetof(mca_coll_base_comm_coll_t, coll_scatter_module),
+    [XHC_ALLGATHER] = offsetof(mca_coll_base_comm_coll_t, coll_allgather_module),
+    [XHC_REDUCE_SCATTER_BLOCK] = offsetof(mca_coll_base_comm_coll_t, coll_reduce_scatter_block_module),
+    [XHC_GATHERV] = offsetof(mca_coll_base_comm_coll_t, coll_gatherv_module),
+    [XHC_SCATTERV] = offsetof(mca_coll_base_comm_coll_t, coll_scatterv_module),
+    [XHC_ALLGATHERV] = offsetof(mca_coll_base_comm_coll_t, coll_allgatherv_module),
+    [XHC_ALLTOALL] = offsetof(mca_coll_base_comm_coll_t, coll_alltoall_module)
 };
 
 static size_t xhc_colltype_to_base_module_fn_offset_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = offsetof(mca_coll_base_module_t, coll_bcast),
     [XHC_BARRIER] = offsetof(mca_coll_base_module_t, coll_barrier),
     [XHC_REDUCE] = offsetof(mca_coll_base_module_t, coll_reduce),
-    [XHC_ALLREDUCE] = offsetof(mca_coll_base_module_t, coll_allreduce)
+    [XHC_ALLREDUCE] = offsetof(mca_coll_base_module_t, coll_allreduce),
+    [XHC_GATHER] = offsetof(mca_coll_base_module_t, coll_gather),
+    [XHC_SCATTER] = offsetof(mca_coll_base_module_t, coll_scatter),
+    [XHC_ALLGATHER] = offsetof(mca_coll_base_module_t, coll_allgather),
+    [XHC_REDUCE_SCATTER_BLOCK] = offsetof(mca_coll_base_module_t, coll_reduce_scatter_block),
+    [XHC_GATHERV] = offsetof(mca_coll_base_module_t, coll_gatherv),
+    [XHC_SCATTERV] = offsetof(mca_coll_base_module_t, coll_scatterv),
+    [XHC_ALLGATHERV] = offsetof(mca_coll_base_module_t, coll_allgatherv),
+    [XHC_ALLTOALL] = offsetof(mca_coll_base_module_t, coll_alltoall)
 };
 
 static inline void (*MODULE_COLL_FN(xhc_module_t *module,
@@ -95,8 +119,15 @@ static void xhc_module_clear(xhc_module_t *module) {
     module->rbuf = NULL;
     module->rbuf_size = 0;
 
+    module->stage = NULL;
+    module->stage_size = 0;
+
     module->peer_info = NULL;
 
+    module->peer_ctrl = NULL;
+    module->peer_ctrl_stride = 0;
+    module->peer_seq = 0;
+
     memset(&module->prev_colls, 0, sizeof(module->prev_colls));
     memset(&module->op_config, 0, sizeof(module->op_config));
     memset(&module->op_data, 0, sizeof(module->op_data));
@@ -191,6 +222,14 @@ mca_coll_base_module_t *mca_coll_xhc_module_comm_query(ompi_communicator_t *comm
     module->super.coll_barrier = mca_coll_xhc_barrier;
     module->super.coll_allreduce = mca_coll_xhc_allreduce;
     module->super.coll_reduce = mca_coll_xhc_reduce;
+    module->super.coll_gather = mca_coll_xhc_gather;
+    module->super.coll_gatherv = mca_coll_xhc_gatherv;
+    module->super.coll_scatter = mca_coll_xhc_scatter;
+    module->super.coll_scatterv = mca_coll_xhc_scatterv;
+    module->super.coll_allgather = mca_coll_xhc_allgather;
+    module->super.coll_allgatherv = mca_coll_xhc_allgatherv;
+    module->super.coll_alltoall = mca_coll_xhc_alltoall;
+    module->super.coll_reduce_scatter_block = mca_coll_xhc_reduce_scatter_block;
 
     return &module->super;
 }
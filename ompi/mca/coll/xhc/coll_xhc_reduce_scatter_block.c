@@ -0,0 +1,108 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/op/op.h"
+
+#include "opal/util/show_help.h"
+#include "opal/util/minmax.h"
+
+#include "coll_xhc.h"
+
+/* Reduce_scatter_block is a reduction to rank 0 (through the comm's reduce,
+ * ie. normally XHC's own pipelined one), followed by a hierarchical scatter.
+ * The scatter only starts once the reduction has completed everywhere. */
+int mca_coll_xhc_reduce_scatter_block(const void *sbuf, void *rbuf,
+        size_t rcount, ompi_datatype_t *datatype, ompi_op_t *op,
+        ompi_communicator_t *ompi_comm, mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    void *tmp = NULL;
+    int err;
+
+    // ---
+
+    if(!ompi_datatype_is_predefined(datatype)) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    size_t dtype_size; ompi_datatype_type_size(datatype, &dtype_size);
+    size_t bytes = rcount * dtype_size;
+
+    if(!module->zcopy_support) {
+        size_t cico_size = module->op_config[XHC_REDUCE_SCATTER_BLOCK].cico_max;
+        if(comm_size * bytes > cico_size) {
+            WARN_ONCE("coll:xhc: Warning: No smsc support; utilizing fallback "
+                "component for reduce_scatter_block greater than %zu bytes",
+                cico_size);
+            goto _fallback;
+        }
+    }
+
+    // ---
+
+    if(!module->op_data[XHC_REDUCE_SCATTER_BLOCK].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_REDUCE_SCATTER_BLOCK);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    if(0 == rank) {
+        if(MPI_IN_PLACE != sbuf) {
+            tmp = malloc(comm_size * bytes);
+            if(NULL == tmp) {return OMPI_ERR_OUT_OF_RESOURCE;}
+        }
+
+        err = ompi_comm->c_coll->coll_reduce(sbuf, (tmp ? tmp : rbuf),
+            rcount * comm_size, datatype, op, 0, ompi_comm,
+            ompi_comm->c_coll->coll_reduce_module);
+
+        /* In-place, the root's block is
+         * already where it should be */
+        if(OMPI_SUCCESS == err) {
+            err = xhc_scatter_internal((tmp ? tmp : rbuf),
+                (tmp ? rbuf : MPI_IN_PLACE), bytes, ompi_comm,
+                module, XHC_REDUCE_SCATTER_BLOCK);
+        }
+
+        free(tmp);
+    } else {
+        err = ompi_comm->c_coll->coll_reduce((MPI_IN_PLACE == sbuf ? rbuf : sbuf),
+            NULL, rcount * comm_size, datatype, op, 0, ompi_comm,
+            ompi_comm->c_coll->coll_reduce_module);
+
+        if(OMPI_SUCCESS == err) {
+            err = xhc_scatter_internal(NULL, rbuf, bytes,
+                ompi_comm, module, XHC_REDUCE_SCATTER_BLOCK);
+        }
+    }
+
+    return err;
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module, ompi_comm,
+        XHC_REDUCE_SCATTER_BLOCK, reduce_scatter_block);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_REDUCE_SCATTER_BLOCK,
+        reduce_scatter_block, sbuf, rbuf, rcount, datatype, op, ompi_comm);
+}
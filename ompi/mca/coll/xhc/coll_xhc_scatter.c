@@ -0,0 +1,421 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "opal/util/show_help.h"
+#include "opal/util/minmax.h"
+
+#include "coll_xhc.h"
+
+// ------------------------------------------------
+
+/* Hierarchical Scatter (root is the top-level owner, ie. rank 0)
+ * --------------------------------------------------------------
+ * The reverse of the hierarchical gather. Leadership is static, and each
+ * leader has a rank-indexed staging area (the root's is its sbuf).
+ *
+ * 1. Each non-root leader copies its subtree's blocks (a few rank ranges,
+ *    see xhc_comms_map_subtrees) from its own leader's staging area into
+ *    its own; a non-leader copies just its block, into its rbuf.
+ *
+ * 2. The leader then exposes its staging area on all the levels it leads,
+ *    and waits for the members' acks before completing.
+ *
+ * Copies are made with the smsc copy_from primitives (no mapping), so this
+ * works with CMA too. For small messages, the CICO buffers are used instead.
+ * -------------------------------------------------------------- */
+
+static int xhc_scatter_copy_subtree(xhc_comm_t *src_comm,
+        xhc_peer_info_t *peer_info, void *src, void *area, size_t bytes,
+        xhc_copy_method_t method) {
+
+    xhc_member_info_t *my_info = src_comm->my_info;
+    int leader_rank = src_comm->comm_ctrl->leader_rank;
+
+    if(XHC_COPY_CICO == method) {
+        for(int i = 0; i < my_info->n_ranges; i++) {
+            xhc_rank_range_t *range = &my_info->ranges[i];
+
+            xhc_memcpy_offset(area, src, range->start_rank * bytes,
+                (range->end_rank - range->start_rank + 1) * bytes);
+        }
+
+        return OMPI_SUCCESS;
+    }
+
+    struct iovec dst_iov[my_info->n_ranges];
+    struct iovec src_iov[my_info->n_ranges];
+
+    for(int i = 0; i < my_info->n_ranges; i++) {
+        xhc_rank_range_t *range = &my_info->ranges[i];
+
+        size_t offset = range->start_rank * bytes;
+        size_t len = (range->end_rank - range->start_rank + 1) * bytes;
+
+        dst_iov[i] = (struct iovec) {.iov_base = (char *) area + offset, .iov_len = len};
+        src_iov[i] = (struct iovec) {.iov_base = (char *) src + offset, .iov_len = len};
+    }
+
+    int err = xhc_copy_from_iov(&peer_info[leader_rank], dst_iov, src_iov,
+        my_info->n_ranges, (void *) src_comm->comm_ctrl->access_token);
+
+    return (0 == err ? OMPI_SUCCESS : OMPI_ERROR);
+}
+
+/* Scatter rank 0's sbuf in blocks of 'bytes' to all ranks' rbufs. At
+ * the root, rbuf may be MPI_IN_PLACE, in which case its own block is
+ * left in place. Non-root leaders stage in the module's stage buffer. */
+int mca_coll_xhc_scatter_internal(const void *sbuf, void *rbuf,
+        size_t bytes, ompi_communicator_t *ompi_comm, xhc_module_t *module,
+        XHC_COLLTYPE_T colltype) {
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_op_data_t *data = &module->op_data[colltype];
+    xhc_comm_t *comms = data->comms;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    xhc_comm_t *src_comm = NULL;
+    xhc_copy_method_t method;
+
+    xhc_copy_data_t *region_data = NULL;
+    void *area = NULL;
+
+    int err;
+
+    // ---
+
+    xf_sig_t seq = ++data->seq;
+
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        xc->is_leader = false;
+    }
+
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        if(0 != xc->my_id) {
+            src_comm = xc;
+            break;
+        }
+
+        xc->is_leader = true;
+    }
+
+    bool is_leader = comms[0].is_leader;
+
+    method = (comm_size * bytes <= comms[0].cico_size ?
+        XHC_COPY_CICO : XHC_COPY_SMSC);
+
+    if(is_leader) {
+        if(XHC_COPY_CICO == method) {
+            area = xhc_get_cico(peer_info, rank);
+        } else if(0 == rank) {
+            area = (void *) sbuf;
+        } else {
+            area = xhc_get_stage(module, comm_size * bytes);
+            if(NULL == area) {return OMPI_ERR_OUT_OF_RESOURCE;}
+        }
+    }
+
+    /* Safe to alter the CICO buffer without checking any flags, as
+     * in any past ops where others copied from it, this rank has
+     * waited for the respective acks before completing. */
+    if(0 == rank && XHC_COPY_CICO == method) {
+        xhc_memcpy(area, sbuf, comm_size * bytes);
+    }
+
+    // ---
+
+    if(src_comm) {
+        xhc_comm_ctrl_t *src_ctrl = src_comm->comm_ctrl;
+
+        WAIT_FLAG(&src_ctrl->seq, seq, 0);
+        xhc_atomic_rmb();
+
+        void *src = (XHC_COPY_CICO == method ?
+            xhc_get_cico(peer_info, src_ctrl->leader_rank)
+            : src_ctrl->data_vaddr);
+
+        if(0 == bytes) {
+            err = OMPI_SUCCESS;
+        } else if(is_leader) {
+            err = xhc_scatter_copy_subtree(src_comm,
+                peer_info, src, area, bytes, method);
+        } else if(XHC_COPY_CICO == method) {
+            xhc_memcpy(rbuf, (char *) src + rank * bytes, bytes);
+            err = OMPI_SUCCESS;
+        } else {
+            err = xhc_copy_from(&peer_info[src_ctrl->leader_rank], rbuf,
+                (char *) src + rank * bytes, bytes,
+                (void *) src_ctrl->access_token);
+            err = (0 == err ? OMPI_SUCCESS : OMPI_ERROR);
+        }
+
+        if(OMPI_SUCCESS != err) {return err;}
+
+        /* Make sure the copies have completed
+         * before the store to the ack flag */
+        xhc_atomic_fmb();
+
+        src_comm->my_ctrl->ack = seq;
+    }
+
+    if(!is_leader) {
+        return OMPI_SUCCESS;
+    }
+
+    // ---
+
+    if(XHC_COPY_SMSC == method && bytes > 0) {
+        err = xhc_copy_expose_region(area, comm_size * bytes, &region_data);
+        if(0 != err) {return OMPI_ERROR;}
+    }
+
+    for(xhc_comm_t *xc = comms; xc && xc->is_leader; xc = xc->up) {
+        xhc_comm_ctrl_t *ctrl = xc->comm_ctrl;
+
+        ctrl->leader_rank = rank;
+        ctrl->data_vaddr = area;
+
+        if(region_data) {
+            xhc_copy_region_post((void *) ctrl->access_token, region_data);
+        }
+
+        xhc_atomic_wmb();
+
+        ctrl->seq = seq;
+    }
+
+    if(MPI_IN_PLACE != rbuf) {
+        xhc_memcpy(rbuf, (char *) area + rank * bytes, bytes);
+    }
+
+    for(xhc_comm_t *xc = comms; xc && xc->is_leader; xc = xc->up) {
+        for(int m = 1; m < xc->size; m++) {
+            WAIT_FLAG(&xc->member_ctrl[m].ack, seq, 0);
+        }
+    }
+
+    if(region_data) {
+        xhc_copy_close_region(region_data);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+// ------------------------------------------------
+
+/* Direct Scatter(v)
+ * -----------------
+ * Used for scatterv, and for scatter with a root other than rank 0. The
+ * non-root ranks publish their receive buffers in the peer table, and the
+ * root copies into each one as soon as it becomes available. */
+int mca_coll_xhc_scatter_direct(const void *sbuf, size_t bytes,
+        ompi_count_array_t scounts, ompi_disp_array_t displs, void *rbuf,
+        size_t rbytes, int root, ompi_communicator_t *ompi_comm,
+        xhc_module_t *module) {
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_copy_data_t *region_data = NULL;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    int err;
+
+    xf_sig_t seq = ++module->peer_seq;
+
+    if(rank != root) {
+        err = xhc_peer_publish(module, rbuf, rbytes, seq, &region_data);
+        if(OMPI_SUCCESS != err) {return err;}
+
+        xhc_peer_ack(module, seq, root, region_data);
+
+        return OMPI_SUCCESS;
+    }
+
+    // ---
+
+    if(MPI_IN_PLACE != rbuf) {
+        xhc_memcpy(rbuf, (char *) sbuf + XHC_BLOCK_OFFSET(displs, bytes, rank),
+            XHC_BLOCK_SIZE(scounts, bytes, rank));
+    }
+
+    bool done[comm_size];
+    int pending = comm_size - 1;
+
+    memset(done, 0, sizeof(done));
+
+    while(pending > 0) {
+        for(int r = 0; r < comm_size; r++) {
+            if(r == rank || done[r]) {
+                continue;
+            }
+
+            xhc_peer_ctrl_t *ctrl = xhc_peer_wait(module, r, seq, false);
+            if(NULL == ctrl) {continue;}
+
+            size_t size = XHC_BLOCK_SIZE(scounts, bytes, r);
+
+            if(size > 0) {
+                err = xhc_copy_to(&peer_info[r], (char *) sbuf
+                    + XHC_BLOCK_OFFSET(displs, bytes, r), ctrl->vaddr,
+                    size, (void *) ctrl->access_token);
+                if(0 != err) {return OMPI_ERROR;}
+            }
+
+            done[r] = true;
+            pending--;
+        }
+    }
+
+    xhc_peer_ack(module, seq, root, NULL);
+
+    return OMPI_SUCCESS;
+}
+
+// ------------------------------------------------
+
+int mca_coll_xhc_scatter(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+        ompi_datatype_t *rdtype, int root, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    size_t dtype_size, bytes;
+    int err;
+
+    // ---
+
+    // Only the root's send arguments are significant
+    if((rank == root && !ompi_datatype_is_predefined(sdtype))
+            || (MPI_IN_PLACE != rbuf && !ompi_datatype_is_predefined(rdtype))) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(rank == root) {
+        ompi_datatype_type_size(sdtype, &dtype_size);
+        bytes = scount * dtype_size;
+    } else {
+        ompi_datatype_type_size(rdtype, &dtype_size);
+        bytes = rcount * dtype_size;
+    }
+
+    size_t cico_size = module->op_config[XHC_SCATTER].cico_max;
+    bool hierarchical = (0 == root);
+
+    if(!module->zcopy_support && !(hierarchical
+            && comm_size * bytes <= cico_size)) {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; utilizing fallback "
+            "component for non-zero-root scatter or scatter greater than "
+            "%zu bytes", cico_size);
+        goto _fallback;
+    }
+
+    // ---
+
+    if(hierarchical) {
+        if(!module->op_data[XHC_SCATTER].init) {
+            err = xhc_init_op(module, ompi_comm, XHC_SCATTER);
+            if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+        }
+
+        return xhc_scatter_internal(sbuf, rbuf, bytes,
+            ompi_comm, module, XHC_SCATTER);
+    }
+
+    // The direct path's state is kept in scatterv's op data
+    if(!module->op_data[XHC_SCATTERV].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_SCATTERV);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    return xhc_scatter_direct(sbuf, bytes, 0, 0,
+        rbuf, bytes, root, ompi_comm, module);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module,
+        ompi_comm, XHC_SCATTER, scatter);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_SCATTER, scatter,
+        sbuf, scount, sdtype, rbuf, rcount, rdtype, root, ompi_comm);
+}
+
+int mca_coll_xhc_scatterv(const void *sbuf, ompi_count_array_t scounts,
+        ompi_disp_array_t displs, ompi_datatype_t *sdtype, void *rbuf,
+        size_t rcount, ompi_datatype_t *rdtype, int root,
+        ompi_communicator_t *ompi_comm, mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int rank = ompi_comm_rank(ompi_comm);
+
+    size_t sdtype_size = 0, rdtype_size = 0;
+    int err;
+
+    // ---
+
+    if((rank == root && !ompi_datatype_is_predefined(sdtype))
+            || (MPI_IN_PLACE != rbuf && !ompi_datatype_is_predefined(rdtype))) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(!module->zcopy_support) {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; "
+            "utilizing fallback component for scatterv");
+        goto _fallback;
+    }
+
+    // ---
+
+    if(!module->op_data[XHC_SCATTERV].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_SCATTERV);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    if(rank == root) {
+        ompi_datatype_type_size(sdtype, &sdtype_size);
+    }
+
+    if(MPI_IN_PLACE != rbuf) {
+        ompi_datatype_type_size(rdtype, &rdtype_size);
+    }
+
+    return xhc_scatter_direct(sbuf, sdtype_size, scounts, displs,
+        rbuf, rcount * rdtype_size, root, ompi_comm, module);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_FALLBACK(module,
+        ompi_comm, XHC_SCATTERV, scatterv);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_colls, XHC_SCATTERV, scatterv,
+        sbuf, scounts, displs, sdtype, rbuf, rcount, rdtype, root, ompi_comm);
+}
@@ -44,6 +44,10 @@ typedef struct {
     /** A simple boolean indicating whether double precision is
         supported. */
     bool double_supported;
+
+    /** Smallest segment copied with non-temporal stores by the fused
+        reduce-and-copy functions. */
+    size_t stream_threshold;
 } ompi_op_aarch64_component_t;
 
 /**
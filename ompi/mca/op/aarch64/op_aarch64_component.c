@@ -22,11 +22,14 @@
 
 #include "ompi_config.h"
 
+#include <string.h>
+
 #include "opal/util/printf.h"
 
 #include "ompi/constants.h"
 #include "ompi/mca/op/aarch64/op_aarch64.h"
 #include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/base/fused.h"
 #include "ompi/mca/op/op.h"
 #include "ompi/op/op.h"
 
@@ -133,6 +136,15 @@ static int mca_op_aarch64_component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_op_aarch64_component.double_supported);
 
+    mca_op_aarch64_component.stream_threshold = 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_op_aarch64_component.super.opc_version,
+                                           "stream_threshold",
+                                           "Size in bytes from which the fused reduce-and-copy functions write the copy with non-temporal stores, bypassing the caches",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_op_aarch64_component.stream_threshold);
+
     return OMPI_SUCCESS;
 }
 
@@ -161,6 +173,41 @@ extern ompi_op_base_3buff_handler_fn_t
 ompi_op_aarch64_3buff_functions_sve[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
 #endif  /* defined(OMPI_MCA_OP_HAVE_SVE) */
 
+/*
+ * Copy with non-temporal store pairs, the copy being only read again by
+ * the network or by another process.
+ */
+static void aarch64_stream_copy(void *dst, const void *src, size_t len)
+{
+    char *d = (char *) dst;
+    const char *s = (const char *) src;
+
+    for (; len >= 32; len -= 32, d += 32, s += 32) {
+        __asm__ __volatile__("ldp q0, q1, [%1]\n\t"
+                             "stnp q0, q1, [%0]"
+                             : : "r"(d), "r"(s) : "v0", "v1", "memory");
+    }
+    memcpy(d, s, len);
+    /* Order the non-temporal stores with the following ones */
+    __asm__ __volatile__("dmb ishst" : : : "memory");
+}
+
+static void aarch64_reduce_copy(const void *in, void *inout, void *copy, int *count,
+                                struct ompi_datatype_t **dtype,
+                                struct ompi_op_base_module_1_0_0_t *module)
+{
+    ompi_op_base_fused_reduce_copy(in, inout, copy, count, dtype, module,
+                                   mca_op_aarch64_component.stream_threshold,
+                                   aarch64_stream_copy);
+}
+
+static void aarch64_reduce_nary(const void *const *in, int nin, void *out, int *count,
+                                struct ompi_datatype_t **dtype,
+                                struct ompi_op_base_module_1_0_0_t *module)
+{
+    ompi_op_base_fused_reduce_nary(in, nin, out, count, dtype, module);
+}
+
 /*
  * Query whether this component can be used for a specific op
  */
@@ -205,6 +252,11 @@ static struct ompi_op_base_module_1_0_0_t *
                 }
             }
 #endif  /* defined(OMPI_MCA_OP_HAVE_NEON) */
+            /* The fused functions rely on both functions of the module */
+            if( NULL != module->opm_fns[i] && NULL != module->opm_3buff_fns[i] ) {
+                module->opm_copy_fns[i] = aarch64_reduce_copy;
+                module->opm_nary_fns[i] = aarch64_reduce_nary;
+            }
         }
         break;
     case OMPI_OP_BASE_FORTRAN_LAND:
@@ -29,12 +29,18 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
     op_avx_support=0
     op_avx2_support=0
     op_avx512_support=0
+    op_f16c_support=0
+    op_avx512_fp16_support=0
+    op_avx512_bf16_support=0
 
     AS_VAR_PUSHDEF([op_avx_check_sse3], [ompi_cv_op_avx_check_sse3])
     AS_VAR_PUSHDEF([op_avx_check_sse41], [ompi_cv_op_avx_check_sse41])
     AS_VAR_PUSHDEF([op_avx_check_avx], [ompi_cv_op_avx_check_avx])
     AS_VAR_PUSHDEF([op_avx_check_avx2], [ompi_cv_op_avx_check_avx2])
     AS_VAR_PUSHDEF([op_avx_check_avx512], [ompi_cv_op_avx_check_avx512])
+    AS_VAR_PUSHDEF([op_avx_check_f16c], [ompi_cv_op_avx_check_f16c])
+    AS_VAR_PUSHDEF([op_avx_check_avx512_fp16], [ompi_cv_op_avx_check_avx512_fp16])
+    AS_VAR_PUSHDEF([op_avx_check_avx512_bf16], [ompi_cv_op_avx_check_avx512_bf16])
 
     OPAL_VAR_SCOPE_PUSH([op_avx_cflags_save])
 
@@ -213,6 +219,91 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
                          CFLAGS="$op_avx_cflags_save"
                         ])])
            #
+           # Check for the 16-bit floating point conversions (F16C), used with
+           # AVX2 and AVX512 for the half precision short float.
+           #
+           AC_CACHE_CHECK([for F16C support], op_avx_check_f16c, AS_VAR_SET(op_avx_check_f16c, yes))
+           AS_IF([test $op_avx2_support -eq 1 && test "$op_avx_check_f16c" = "yes"],
+                 [AC_MSG_CHECKING([for F16C support (no additional flags)])
+                  op_avx_cflags_save="$CFLAGS"
+                  CFLAGS="$CFLAGS_WITHOUT_OPTFLAGS -O0 $MCA_BUILD_OP_AVX2_FLAGS"
+                  AC_LINK_IFELSE(
+                      [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                              [[
+#if !defined(__F16C__)
+#error "the -m flags are needed to provide the F16C detection macro"
+#endif
+    __m128i vA = _mm_setzero_si128();
+    vA = _mm256_cvtps_ph(_mm256_cvtph_ps(vA), _MM_FROUND_TO_NEAREST_INT)
+                              ]])],
+                      [op_f16c_support=1
+                       AC_MSG_RESULT([yes])],
+                      [AC_MSG_RESULT([no])])
+                  AS_IF([test $op_f16c_support -eq 0],
+                        [AC_MSG_CHECKING([for F16C support (with -mf16c)])
+                         CFLAGS="$CFLAGS_WITHOUT_OPTFLAGS -O0 $MCA_BUILD_OP_AVX2_FLAGS -mf16c"
+                         AC_LINK_IFELSE(
+                             [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                     [[
+#if !defined(__F16C__)
+#error "the -m flags are needed to provide the F16C detection macro"
+#endif
+    __m128i vA = _mm_setzero_si128();
+    vA = _mm256_cvtps_ph(_mm256_cvtph_ps(vA), _MM_FROUND_TO_NEAREST_INT)
+                                     ]])],
+                             [op_f16c_support=1
+                              MCA_BUILD_OP_AVX2_FLAGS="$MCA_BUILD_OP_AVX2_FLAGS -mf16c"
+                              AS_IF([test $op_avx512_support -eq 1],
+                                    [MCA_BUILD_OP_AVX512_FLAGS="$MCA_BUILD_OP_AVX512_FLAGS -mf16c"])
+                              AC_MSG_RESULT([yes])],
+                             [AC_MSG_RESULT([no])])])
+                  CFLAGS="$op_avx_cflags_save"
+                 ])
+           #
+           # The native 16-bit floating point instructions are only enabled
+           # for the functions using them (with the target attribute), so
+           # that the rest of the AVX512 code does not require them.
+           #
+           AC_CACHE_CHECK([for AVX512-FP16 support], op_avx_check_avx512_fp16, AS_VAR_SET(op_avx_check_avx512_fp16, yes))
+           AS_IF([test $op_avx512_support -eq 1 && test "$op_avx_check_avx512_fp16" = "yes"],
+                 [AC_MSG_CHECKING([if _mm512_add_ph generates code that can be compiled])
+                  op_avx_cflags_save="$CFLAGS"
+                  CFLAGS="$CFLAGS_WITHOUT_OPTFLAGS -O0 $MCA_BUILD_OP_AVX512_FLAGS"
+                  AC_LINK_IFELSE(
+                      [AC_LANG_PROGRAM([[#include <immintrin.h>
+static __m512i __attribute__((target("avx512fp16"))) add_ph(__m512i a, __m512i b)
+{
+    return _mm512_castph_si512(_mm512_add_ph(_mm512_castsi512_ph(a), _mm512_castsi512_ph(b)));
+}]],
+                              [[
+    __m512i vA = _mm512_setzero_si512();
+    vA = add_ph(vA, vA)
+                              ]])],
+                      [op_avx512_fp16_support=1
+                       AC_MSG_RESULT([yes])],
+                      [AC_MSG_RESULT([no])])
+                  CFLAGS="$op_avx_cflags_save"
+                 ])
+           AC_CACHE_CHECK([for AVX512-BF16 support], op_avx_check_avx512_bf16, AS_VAR_SET(op_avx_check_avx512_bf16, yes))
+           AS_IF([test $op_avx512_support -eq 1 && test "$op_avx_check_avx512_bf16" = "yes"],
+                 [AC_MSG_CHECKING([if _mm512_cvtneps_pbh generates code that can be compiled])
+                  op_avx_cflags_save="$CFLAGS"
+                  CFLAGS="$CFLAGS_WITHOUT_OPTFLAGS -O0 $MCA_BUILD_OP_AVX512_FLAGS"
+                  AC_LINK_IFELSE(
+                      [AC_LANG_PROGRAM([[#include <immintrin.h>
+static __m256i __attribute__((target("avx512bf16"))) cvt_bf16(__m512 a)
+{
+    return (__m256i)_mm512_cvtneps_pbh(a);
+}]],
+                              [[
+    __m256i vA = cvt_bf16(_mm512_setzero_ps())
+                              ]])],
+                      [op_avx512_bf16_support=1
+                       AC_MSG_RESULT([yes])],
+                      [AC_MSG_RESULT([no])])
+                  CFLAGS="$op_avx_cflags_save"
+                 ])
+           #
            # What about early AVX support? The rest of the logic is slightly different as
            # we need to include some of the SSE4.1 and SSE3 instructions. So, we first check
            # if we can compile AVX code without a flag, then we validate that we have support
@@ -330,6 +421,15 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
     AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX512],
                        [$op_avx512_support],
                        [AVX512 supported in the current build])
+    AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX512_FP16],
+                       [$op_avx512_fp16_support],
+                       [AVX512-FP16 supported in the current build])
+    AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX512_BF16],
+                       [$op_avx512_bf16_support],
+                       [AVX512-BF16 supported in the current build])
+    AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_F16C],
+                       [$op_f16c_support],
+                       [F16C supported in the current build])
     AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX2],
                        [$op_avx2_support],
                        [AVX2 supported in the current build])
@@ -356,6 +456,9 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
     AC_SUBST(MCA_BUILD_OP_AVX2_FLAGS)
     AC_SUBST(MCA_BUILD_OP_AVX_FLAGS)
 
+    AS_VAR_POPDEF([op_avx_check_avx512_bf16])
+    AS_VAR_POPDEF([op_avx_check_avx512_fp16])
+    AS_VAR_POPDEF([op_avx_check_f16c])
     AS_VAR_POPDEF([op_avx_check_avx512])
     AS_VAR_POPDEF([op_avx_check_avx2])
     AS_VAR_POPDEF([op_avx_check_avx])
@@ -21,8 +21,11 @@
 
 BEGIN_C_DECLS
 
+#define OMPI_OP_AVX_HAS_AVX512_BF16_FLAG 0x00000800
+#define OMPI_OP_AVX_HAS_AVX512_FP16_FLAG 0x00000400
 #define OMPI_OP_AVX_HAS_AVX512BW_FLAG  0x00000200
 #define OMPI_OP_AVX_HAS_AVX512F_FLAG   0x00000100
+#define OMPI_OP_AVX_HAS_F16C_FLAG      0x00000040
 #define OMPI_OP_AVX_HAS_AVX2_FLAG      0x00000020
 #define OMPI_OP_AVX_HAS_AVX_FLAG       0x00000010
 #define OMPI_OP_AVX_HAS_SSE4_1_FLAG    0x00000008
@@ -48,6 +51,8 @@ typedef struct {
 
     uint32_t supported; /* AVX capabilities supported by the environment */
     uint32_t flags; /* AVX capabilities requested by this process */
+    size_t stream_threshold; /* Smallest segment copied with non-temporal stores */
+    bool bf16_native; /* Round bfloat16 results with AVX512-BF16, which flushes denormals */
 } ompi_op_avx_component_t;
 
 /**
@@ -20,12 +20,18 @@
 
 #include "ompi_config.h"
 
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "opal/util/printf.h"
 
 #include "ompi/constants.h"
 #include "ompi/op/op.h"
 #include "ompi/mca/op/op.h"
 #include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/base/fused.h"
 #include "ompi/mca/op/avx/op_avx.h"
 
 static int avx_component_open(void);
@@ -43,8 +49,11 @@ static mca_base_var_enum_value_flag_t avx_support_flags[] = {
     { .flag = 0x008, .string = "SSE4.1" },
     { .flag = 0x010, .string = "AVX" },
     { .flag = 0x020, .string = "AVX2" },
+    { .flag = 0x040, .string = "F16C" },
     { .flag = 0x100, .string = "AVX512F" },
     { .flag = 0x200, .string = "AVX512BW" },
+    { .flag = 0x400, .string = "AVX512_FP16" },
+    { .flag = 0x800, .string = "AVX512_BF16" },
     { .flag = 0,     .string = NULL },
 };
 
@@ -62,6 +71,13 @@ static uint32_t has_intel_AVX_features(void)
 
     flags |= _may_i_use_cpu_feature(_FEATURE_AVX512F)  ? OMPI_OP_AVX_HAS_AVX512F_FLAG   : 0;
     flags |= _may_i_use_cpu_feature(_FEATURE_AVX512BW) ? OMPI_OP_AVX_HAS_AVX512BW_FLAG : 0;
+#if defined(_FEATURE_AVX512_FP16)
+    flags |= _may_i_use_cpu_feature(_FEATURE_AVX512_FP16) ? OMPI_OP_AVX_HAS_AVX512_FP16_FLAG : 0;
+#endif
+#if defined(_FEATURE_AVX512_BF16)
+    flags |= _may_i_use_cpu_feature(_FEATURE_AVX512_BF16) ? OMPI_OP_AVX_HAS_AVX512_BF16_FLAG : 0;
+#endif
+    flags |= _may_i_use_cpu_feature(_FEATURE_F16C)     ? OMPI_OP_AVX_HAS_F16C_FLAG      : 0;
     flags |= _may_i_use_cpu_feature(_FEATURE_AVX2)     ? OMPI_OP_AVX_HAS_AVX2_FLAG      : 0;
     flags |= _may_i_use_cpu_feature(_FEATURE_AVX)      ? OMPI_OP_AVX_HAS_AVX_FLAG       : 0;
     flags |= _may_i_use_cpu_feature(_FEATURE_SSE4_1)   ? OMPI_OP_AVX_HAS_SSE4_1_FLAG    : 0;
@@ -100,6 +116,9 @@ static uint32_t has_intel_AVX_features(void)
     const uint32_t avx512f_mask   = (1U << 16);  // AVX512F   (EAX = 7, ECX = 0) : EBX
     const uint32_t avx512_bw_mask = (1U << 30);  // AVX512BW  (EAX = 7, ECX = 0) : EBX
     const uint32_t avx2_mask      = (1U << 5);   // AVX2      (EAX = 7, ECX = 0) : EBX
+    const uint32_t avx512_fp16_mask = (1U << 23);  // AVX512_FP16 (EAX = 7, ECX = 0) : EDX
+    const uint32_t avx512_bf16_mask = (1U << 5);   // AVX512_BF16 (EAX = 7, ECX = 1) : EAX
+    const uint32_t f16c_mask      = (1U << 29);  // F16C      (EAX = 1, ECX = 0) : ECX
     const uint32_t avx_mask       = (1U << 28);  // AVX       (EAX = 1, ECX = 0) : ECX
     const uint32_t sse4_1_mask    = (1U << 19);  // SSE4.1    (EAX = 1, ECX = 0) : ECX
     const uint32_t sse3_mask      = (1U << 0);   // SSE3      (EAX = 1, ECX = 0) : ECX
@@ -108,6 +127,7 @@ static uint32_t has_intel_AVX_features(void)
     uint32_t flags = 0, abcd[4];
 
     run_cpuid( 1, 0, abcd );
+    flags |= (abcd[2] & f16c_mask)      ? OMPI_OP_AVX_HAS_F16C_FLAG     : 0;
     flags |= (abcd[2] & avx_mask)       ? OMPI_OP_AVX_HAS_AVX_FLAG      : 0;
     flags |= (abcd[2] & sse4_1_mask)    ? OMPI_OP_AVX_HAS_SSE4_1_FLAG   : 0;
     flags |= (abcd[2] & sse3_mask)      ? OMPI_OP_AVX_HAS_SSE3_FLAG     : 0;
@@ -124,6 +144,11 @@ static uint32_t has_intel_AVX_features(void)
     flags |= (abcd[1] & avx512f_mask)   ? OMPI_OP_AVX_HAS_AVX512F_FLAG  : 0;
     flags |= (abcd[1] & avx512_bw_mask) ? OMPI_OP_AVX_HAS_AVX512BW_FLAG : 0;
     flags |= (abcd[1] & avx2_mask)      ? OMPI_OP_AVX_HAS_AVX2_FLAG     : 0;
+    flags |= (abcd[3] & avx512_fp16_mask) ? OMPI_OP_AVX_HAS_AVX512_FP16_FLAG : 0;
+    if( abcd[0] >= 1 ) {  /* highest subleaf of the leaf 7 */
+        run_cpuid( 7, 1, abcd );
+        flags |= (abcd[0] & avx512_bf16_mask) ? OMPI_OP_AVX_HAS_AVX512_BF16_FLAG : 0;
+    }
     return flags;
 }
 #endif /* non-Intel compiler */
@@ -220,6 +245,24 @@ avx_component_register(void)
 
     mca_op_avx_component.flags &= mca_op_avx_component.supported;
 
+    mca_op_avx_component.stream_threshold = 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_op_avx_component.super.opc_version,
+                                           "stream_threshold",
+                                           "Size in bytes from which the fused reduce-and-copy functions write the copy with non-temporal stores, bypassing the caches. Smaller copies are likely to be read again soon",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_op_avx_component.stream_threshold);
+
+    mca_op_avx_component.bf16_native = false;
+    (void) mca_base_component_var_register(&mca_op_avx_component.super.opc_version,
+                                           "bf16_native",
+                                           "Round the bfloat16 reductions with the AVX512-BF16 conversion instruction when available. It flushes denormal results to zero, unlike the default rounding done with AVX512F",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_op_avx_component.bf16_native);
+
     return OMPI_SUCCESS;
 }
 
@@ -247,6 +290,58 @@ avx_component_init_query(bool enable_progress_threads,
  extern ompi_op_base_handler_fn_t ompi_op_avx_functions_avx[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
  extern ompi_op_base_3buff_handler_fn_t ompi_op_avx_3buff_functions_avx[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
 #endif
+
+/*
+ * Copy with non-temporal stores: the copy is only read again by the
+ * network or by another process. SSE2 is always available on x86_64,
+ * and the copy is bound by the memory bandwidth anyway.
+ */
+static void avx_stream_copy(void *dst, const void *src, size_t len)
+{
+    char *d = (char *) dst;
+    const char *s = (const char *) src;
+#if defined(__SSE2__)
+    size_t head = (16 - ((uintptr_t) d & 15)) & 15;
+
+    if (head > len) {
+        head = len;
+    }
+    memcpy(d, s, head);
+    d += head; s += head; len -= head;
+    for( ; len >= 64; len -= 64, d += 64, s += 64 ) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *) s);
+        __m128i v1 = _mm_loadu_si128((const __m128i *) (s + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *) (s + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *) (s + 48));
+        _mm_stream_si128((__m128i *) d, v0);
+        _mm_stream_si128((__m128i *) (d + 16), v1);
+        _mm_stream_si128((__m128i *) (d + 32), v2);
+        _mm_stream_si128((__m128i *) (d + 48), v3);
+    }
+    for( ; len >= 16; len -= 16, d += 16, s += 16 ) {
+        _mm_stream_si128((__m128i *) d, _mm_loadu_si128((const __m128i *) s));
+    }
+    /* The streamed stores are weakly ordered */
+    _mm_sfence();
+#endif  /* defined(__SSE2__) */
+    memcpy(d, s, len);
+}
+
+static void avx_reduce_copy(const void *in, void *inout, void *copy, int *count,
+                            struct ompi_datatype_t **dtype,
+                            struct ompi_op_base_module_1_0_0_t *module)
+{
+    ompi_op_base_fused_reduce_copy(in, inout, copy, count, dtype, module,
+                                   mca_op_avx_component.stream_threshold, avx_stream_copy);
+}
+
+static void avx_reduce_nary(const void *const *in, int nin, void *out, int *count,
+                            struct ompi_datatype_t **dtype,
+                            struct ompi_op_base_module_1_0_0_t *module)
+{
+    ompi_op_base_fused_reduce_nary(in, nin, out, count, dtype, module);
+}
+
 /*
  * Query whether this component can be used for a specific op
  */
@@ -269,6 +364,11 @@ avx_component_op_query(struct ompi_op_t *op, int *priority)
     case OMPI_OP_BASE_FORTRAN_BOR:
     case OMPI_OP_BASE_FORTRAN_BAND:
     case OMPI_OP_BASE_FORTRAN_BXOR:
+    case OMPI_OP_BASE_FORTRAN_LAND:
+    case OMPI_OP_BASE_FORTRAN_LOR:
+    case OMPI_OP_BASE_FORTRAN_LXOR:
+    case OMPI_OP_BASE_FORTRAN_MAXLOC:
+    case OMPI_OP_BASE_FORTRAN_MINLOC:
         module = OBJ_NEW(ompi_op_base_module_t);
         for (int i = 0; i < OMPI_OP_BASE_TYPE_MAX; ++i) {
 #if OMPI_MCA_OP_HAVE_AVX512
@@ -297,6 +397,11 @@ avx_component_op_query(struct ompi_op_t *op, int *priority)
                 }
             }
 #endif
+            /* The fused functions rely on both AVX functions */
+            if( NULL != module->opm_fns[i] && NULL != module->opm_3buff_fns[i] ) {
+                module->opm_copy_fns[i] = avx_reduce_copy;
+                module->opm_nary_fns[i] = avx_reduce_nary;
+            }
             if( NULL != module->opm_fns[i] ) {
                 OBJ_RETAIN(module);
             }
@@ -305,11 +410,6 @@ avx_component_op_query(struct ompi_op_t *op, int *priority)
             }
         }
         break;
-    case OMPI_OP_BASE_FORTRAN_LAND:
-    case OMPI_OP_BASE_FORTRAN_LOR:
-    case OMPI_OP_BASE_FORTRAN_LXOR:
-    case OMPI_OP_BASE_FORTRAN_MAXLOC:
-    case OMPI_OP_BASE_FORTRAN_MINLOC:
     case OMPI_OP_BASE_FORTRAN_REPLACE:
     default:
         break;
@@ -168,6 +168,25 @@
  * _mm512_storeu_p[s,d]            AVX512F
  * _mm512_storeu_si512             AVX512F
  * _mm512_xor_si512                AVX512F
+ *
+ * Logical and location functions (AVX2 and AVX512 only):
+ *
+ * _mm256_andnot_si256             AVX2
+ * _mm256_blendv_epi8              AVX2
+ * _mm256_blendv_pd                AVX
+ * _mm256_cmp_p[s,d]               AVX
+ * _mm256_cmpeq_epi[8,16,32,64]    AVX2
+ * _mm256_cmpgt_epi32              AVX2
+ * _mm256_permute_pd               AVX
+ * _mm256_shuffle_epi32            AVX2
+ * _mm512_cmp_p[s,d]_mask          AVX512F
+ * _mm512_cmp[eq,gt]_epi32_mask    AVX512F
+ * _mm512_mask_blend_epi[32,64]    AVX512F
+ * _mm512_mask_min_epi32           AVX512F
+ * _mm512_maskz_mov_epi[8,16]      AVX512BW
+ * _mm512_maskz_mov_epi[32,64]     AVX512F
+ * _mm512_test_epi[8,16]_mask      AVX512BW
+ * _mm512_test_epi[32,64]_mask     AVX512F
  */
 
 /*
@@ -751,6 +770,277 @@ static void OP_CONCAT(ompi_op_avx_2buff_##op##_double,PREPEND)(const void *_in,
     // not defined - OP_AVX_FLOAT_FUNC(xor)
     // not defined - OP_AVX_DOUBLE_FUNC(xor)
 
+/*
+ *  These macros are for the logical operations and for maxloc and minloc,
+ *  for both the two and three buffer versions: they process the elements
+ *  of a and b from index i, storing into o, and leave the remaining
+ *  elements (from index i to n) to the scalar loop.
+ *
+ *  Support ops: land, lor, lxor, for signed/unsigned 8,16,32,64
+ *               maxloc, minloc, for 2int, float_int and double_int
+ */
+typedef struct {
+    int v;
+    int k;
+} ompi_op_avx_2int_t;
+
+typedef struct {
+    float v;
+    int k;
+} ompi_op_avx_float_int_t;
+
+typedef struct {
+    double v;
+    int k;
+} ompi_op_avx_double_int_t;
+
+/* a > b for maxloc, a < b for minloc */
+#define OP_AVX_LOC_OP_maxloc >
+#define OP_AVX_LOC_OP_minloc <
+#define OP_AVX_LOC_BETTER_maxloc(cmpgt, a, b) cmpgt(a, b)
+#define OP_AVX_LOC_BETTER_minloc(cmpgt, a, b) cmpgt(b, a)
+
+/* Same as the base functions: on equal values the smallest index wins,
+ * and NaN values never win */
+#define OP_AVX_LOC_SCALAR(name, a, b, o)                                \
+    if( (a).v OP_AVX_LOC_OP_##name (b).v ) {                            \
+        (o) = (a);                                                      \
+    } else if( (a).v == (b).v ) {                                       \
+        (o).v = (b).v;                                                  \
+        (o).k = ((a).k < (b).k) ? (a).k : (b).k;                        \
+    } else {                                                            \
+        (o) = (b);                                                      \
+    }
+
+#if defined(GENERATE_AVX512_CODE) && defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512)
+#if __AVX512F__ && __AVX512BW__
+#define OP_AVX_AVX512_LOGICAL_land(ma, mb) ((ma) & (mb))
+#define OP_AVX_AVX512_LOGICAL_lor(ma, mb)  ((ma) | (mb))
+#define OP_AVX_AVX512_LOGICAL_lxor(ma, mb) ((ma) ^ (mb))
+/* The masks of the nonzero elements are combined, and set the elements
+ * of the result to 1 */
+#define OP_AVX_AVX512_LOGICAL_FUNC(name, type_size, type, a, b, o)      \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG|OMPI_OP_AVX_HAS_AVX512BW_FLAG) ) { \
+        int types_per_step = (512 / 8) / sizeof(type);                  \
+        const __m512i one = _mm512_set1_epi##type_size(1);              \
+        for( ; i + types_per_step <= n; i += types_per_step ) {         \
+            __m512i vecA = _mm512_loadu_si512((__m512i*)((a) + i));     \
+            __m512i vecB = _mm512_loadu_si512((__m512i*)((b) + i));     \
+            __m512i res = _mm512_maskz_mov_epi##type_size(              \
+                OP_AVX_AVX512_LOGICAL_##name(_mm512_test_epi##type_size##_mask(vecA, vecA), \
+                                             _mm512_test_epi##type_size##_mask(vecB, vecB)), one); \
+            _mm512_storeu_si512((__m512i*)((o) + i), res);              \
+        }                                                               \
+        if( i == n ) return;                                            \
+    }
+
+#define OP_AVX_AVX512_CMPGT_2int(a, b)       _mm512_cmpgt_epi32_mask(a, b)
+#define OP_AVX_AVX512_CMPEQ_2int(a, b)       _mm512_cmpeq_epi32_mask(a, b)
+#define OP_AVX_AVX512_CMPGT_float_int(a, b)  _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_GT_OQ)
+#define OP_AVX_AVX512_CMPEQ_float_int(a, b)  _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_EQ_OQ)
+#define OP_AVX_AVX512_CMPGT_double_int(a, b) _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ)
+/* 8 pairs of 32-bit value and index: the comparisons are valid in the even
+ * lanes, and are extended to the odd lanes holding the indexes */
+#define OP_AVX_AVX512_LOC32_FUNC(name, type_name, a, b, o)              \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG) ) {         \
+        for( ; i + 8 <= n; i += 8 ) {                                   \
+            __m512i vecA = _mm512_loadu_si512((__m512i*)((a) + i));     \
+            __m512i vecB = _mm512_loadu_si512((__m512i*)((b) + i));     \
+            __mmask16 gt = OP_AVX_LOC_BETTER_##name(OP_AVX_AVX512_CMPGT_##type_name, vecA, vecB) & 0x5555; \
+            __mmask16 eq = OP_AVX_AVX512_CMPEQ_##type_name(vecA, vecB) & 0x5555; \
+            __m512i res = _mm512_mask_blend_epi32(gt | (gt << 1), vecB, vecA); \
+            res = _mm512_mask_min_epi32(res, eq << 1, vecA, vecB);      \
+            _mm512_storeu_si512((__m512i*)((o) + i), res);              \
+        }                                                               \
+        if( i == n ) return;                                            \
+    }
+/* 4 double_int pairs of 16 bytes: the values are in the even 64-bit lanes,
+ * the indexes in the 32-bit lanes 2, 6, 10 and 14 */
+#define OP_AVX_AVX512_LOC64_FUNC(name, type_name, a, b, o)              \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG) && (16 == sizeof(*(a))) ) { \
+        for( ; i + 4 <= n; i += 4 ) {                                   \
+            __m512d vecA = _mm512_loadu_pd((double*)((a) + i));         \
+            __m512d vecB = _mm512_loadu_pd((double*)((b) + i));         \
+            __mmask8 gt = OP_AVX_LOC_BETTER_##name(OP_AVX_AVX512_CMPGT_##type_name, vecA, vecB) & 0x55; \
+            __mmask8 eq = _mm512_cmp_pd_mask(vecA, vecB, _CMP_EQ_OQ);   \
+            __m512i res = _mm512_mask_blend_epi64(gt | (gt << 1), _mm512_castpd_si512(vecB), \
+                                                  _mm512_castpd_si512(vecA)); \
+            res = _mm512_mask_min_epi32(res, ((eq & 0x01) << 2) | ((eq & 0x04) << 4) | \
+                                        ((eq & 0x10) << 6) | ((eq & 0x40) << 8), \
+                                        _mm512_castpd_si512(vecA), _mm512_castpd_si512(vecB)); \
+            _mm512_storeu_si512((__m512i*)((o) + i), res);              \
+        }                                                               \
+        if( i == n ) return;                                            \
+    }
+#else
+#error Target architecture lacks AVX512F and AVX512BW support needed for the logical and location functions
+#endif  /* __AVX512F__ && __AVX512BW__ */
+#else
+#define OP_AVX_AVX512_LOGICAL_FUNC(name, type_size, type, a, b, o) {}
+#define OP_AVX_AVX512_LOC32_FUNC(name, type_name, a, b, o) {}
+#define OP_AVX_AVX512_LOC64_FUNC(name, type_name, a, b, o) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512) */
+
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+#if __AVX2__
+#define OP_AVX_AVX2_SET1_8(v)  _mm256_set1_epi8(v)
+#define OP_AVX_AVX2_SET1_16(v) _mm256_set1_epi16(v)
+#define OP_AVX_AVX2_SET1_32(v) _mm256_set1_epi32(v)
+#define OP_AVX_AVX2_SET1_64(v) _mm256_set1_epi64x(v)
+/* za and zb are all ones for the zero elements of a and b */
+#define OP_AVX_AVX2_LOGICAL_land(za, zb, one) _mm256_andnot_si256(_mm256_or_si256(za, zb), one)
+#define OP_AVX_AVX2_LOGICAL_lor(za, zb, one)  _mm256_andnot_si256(_mm256_and_si256(za, zb), one)
+#define OP_AVX_AVX2_LOGICAL_lxor(za, zb, one) _mm256_and_si256(_mm256_xor_si256(za, zb), one)
+#define OP_AVX_AVX2_LOGICAL_FUNC(name, type_size, type, a, b, o)        \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX2_FLAG | OMPI_OP_AVX_HAS_AVX_FLAG) ) { \
+        int types_per_step = (256 / 8) / sizeof(type);                  \
+        const __m256i zero = _mm256_setzero_si256();                    \
+        const __m256i one = OP_AVX_AVX2_SET1_##type_size(1);            \
+        for( ; i + types_per_step <= n; i += types_per_step ) {         \
+            __m256i vecA = _mm256_cmpeq_epi##type_size(_mm256_loadu_si256((__m256i*)((a) + i)), zero); \
+            __m256i vecB = _mm256_cmpeq_epi##type_size(_mm256_loadu_si256((__m256i*)((b) + i)), zero); \
+            __m256i res = OP_AVX_AVX2_LOGICAL_##name(vecA, vecB, one);  \
+            _mm256_storeu_si256((__m256i*)((o) + i), res);              \
+        }                                                               \
+        if( i == n ) return;                                            \
+    }
+
+#define OP_AVX_AVX2_CMPGT_2int(a, b)       _mm256_cmpgt_epi32(a, b)
+#define OP_AVX_AVX2_CMPEQ_2int(a, b)       _mm256_cmpeq_epi32(a, b)
+#define OP_AVX_AVX2_CMPGT_float_int(a, b)  _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_GT_OQ))
+#define OP_AVX_AVX2_CMPEQ_float_int(a, b)  _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ))
+#define OP_AVX_AVX2_CMPGT_double_int(a, b) _mm256_cmp_pd(a, b, _CMP_GT_OQ)
+/* 4 pairs of 32-bit value and index: the comparisons of the even lanes are
+ * copied to the odd lanes holding the indexes */
+#define OP_AVX_AVX2_LOC32_FUNC(name, type_name, a, b, o)                \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX2_FLAG | OMPI_OP_AVX_HAS_AVX_FLAG) ) { \
+        const __m256i odd = _mm256_setr_epi32(0, -1, 0, -1, 0, -1, 0, -1); \
+        for( ; i + 4 <= n; i += 4 ) {                                   \
+            __m256i vecA = _mm256_loadu_si256((__m256i*)((a) + i));     \
+            __m256i vecB = _mm256_loadu_si256((__m256i*)((b) + i));     \
+            __m256i gt = _mm256_shuffle_epi32(OP_AVX_LOC_BETTER_##name(OP_AVX_AVX2_CMPGT_##type_name, vecA, vecB), \
+                                              _MM_SHUFFLE(2, 2, 0, 0)); \
+            __m256i eq = _mm256_shuffle_epi32(OP_AVX_AVX2_CMPEQ_##type_name(vecA, vecB), \
+                                              _MM_SHUFFLE(2, 2, 0, 0)); \
+            __m256i res = _mm256_blendv_epi8(vecB, vecA, gt);           \
+            res = _mm256_blendv_epi8(res, _mm256_min_epi32(vecA, vecB), _mm256_and_si256(eq, odd)); \
+            _mm256_storeu_si256((__m256i*)((o) + i), res);              \
+        }                                                               \
+        if( i == n ) return;                                            \
+    }
+/* 2 double_int pairs of 16 bytes: the values are in the 64-bit lanes 0 and
+ * 2, the indexes in the 32-bit lanes 2 and 6 */
+#define OP_AVX_AVX2_LOC64_FUNC(name, type_name, a, b, o)                \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX2_FLAG | OMPI_OP_AVX_HAS_AVX_FLAG) && (16 == sizeof(*(a))) ) { \
+        const __m256i idx = _mm256_setr_epi32(0, 0, -1, 0, 0, 0, -1, 0); \
+        for( ; i + 2 <= n; i += 2 ) {                                   \
+            __m256d vecA = _mm256_loadu_pd((double*)((a) + i));         \
+            __m256d vecB = _mm256_loadu_pd((double*)((b) + i));         \
+            __m256d gt = _mm256_permute_pd(OP_AVX_LOC_BETTER_##name(OP_AVX_AVX2_CMPGT_##type_name, vecA, vecB), 0x0); \
+            __m256d eq = _mm256_permute_pd(_mm256_cmp_pd(vecA, vecB, _CMP_EQ_OQ), 0x0); \
+            __m256i res = _mm256_castpd_si256(_mm256_blendv_pd(vecB, vecA, gt)); \
+            res = _mm256_blendv_epi8(res, _mm256_min_epi32(_mm256_castpd_si256(vecA), _mm256_castpd_si256(vecB)), \
+                                     _mm256_and_si256(_mm256_castpd_si256(eq), idx)); \
+            _mm256_storeu_si256((__m256i*)((o) + i), res);              \
+        }                                                               \
+        if( i == n ) return;                                            \
+    }
+#else
+#error Target architecture lacks AVX2 support needed for the logical and location functions
+#endif  /* __AVX2__ */
+#else
+#define OP_AVX_AVX2_LOGICAL_FUNC(name, type_size, type, a, b, o) {}
+#define OP_AVX_AVX2_LOC32_FUNC(name, type_name, a, b, o) {}
+#define OP_AVX_AVX2_LOC64_FUNC(name, type_name, a, b, o) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
+#define OP_AVX_LOGICAL_FUNC(name, type_size, type)                      \
+static void OP_CONCAT(ompi_op_avx_2buff_##name##_##type,PREPEND)(const void *_in, void *_out, int *count, \
+                                                                 struct ompi_datatype_t **dtype, \
+                                                                 struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int i = 0, n = *count;                                              \
+    type *in = (type*)_in, *out = (type*)_out;                          \
+    OP_AVX_AVX512_LOGICAL_FUNC(name, type_size, type, in, out, out);    \
+    OP_AVX_AVX2_LOGICAL_FUNC(name, type_size, type, in, out, out);      \
+    for( ; i < n; i++ ) {                                               \
+        out[i] = current_func(out[i], in[i]);                           \
+    }                                                                   \
+}
+
+#define OP_AVX_LOC_FUNC(name, type_name, width)                         \
+static void OP_CONCAT(ompi_op_avx_2buff_##name##_##type_name,PREPEND)(const void *_in, void *_out, int *count, \
+                                                                      struct ompi_datatype_t **dtype, \
+                                                                      struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int i = 0, n = *count;                                              \
+    ompi_op_avx_##type_name##_t *in = (ompi_op_avx_##type_name##_t*)_in; \
+    ompi_op_avx_##type_name##_t *out = (ompi_op_avx_##type_name##_t*)_out; \
+    OP_AVX_AVX512_LOC##width##_FUNC(name, type_name, in, out, out);     \
+    OP_AVX_AVX2_LOC##width##_FUNC(name, type_name, in, out, out);       \
+    for( ; i < n; i++ ) {                                               \
+        OP_AVX_LOC_SCALAR(name, in[i], out[i], out[i]);                 \
+    }                                                                   \
+}
+
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+/*************************************************************************
+ * Logical AND
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) && (b))
+    OP_AVX_LOGICAL_FUNC(land, 8,    int8_t)
+    OP_AVX_LOGICAL_FUNC(land, 8,   uint8_t)
+    OP_AVX_LOGICAL_FUNC(land, 16,  int16_t)
+    OP_AVX_LOGICAL_FUNC(land, 16, uint16_t)
+    OP_AVX_LOGICAL_FUNC(land, 32,  int32_t)
+    OP_AVX_LOGICAL_FUNC(land, 32, uint32_t)
+    OP_AVX_LOGICAL_FUNC(land, 64,  int64_t)
+    OP_AVX_LOGICAL_FUNC(land, 64, uint64_t)
+
+/*************************************************************************
+ * Logical OR
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) || (b))
+    OP_AVX_LOGICAL_FUNC(lor, 8,    int8_t)
+    OP_AVX_LOGICAL_FUNC(lor, 8,   uint8_t)
+    OP_AVX_LOGICAL_FUNC(lor, 16,  int16_t)
+    OP_AVX_LOGICAL_FUNC(lor, 16, uint16_t)
+    OP_AVX_LOGICAL_FUNC(lor, 32,  int32_t)
+    OP_AVX_LOGICAL_FUNC(lor, 32, uint32_t)
+    OP_AVX_LOGICAL_FUNC(lor, 64,  int64_t)
+    OP_AVX_LOGICAL_FUNC(lor, 64, uint64_t)
+
+/*************************************************************************
+ * Logical XOR
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a ? 1 : 0) ^ (b ? 1: 0))
+    OP_AVX_LOGICAL_FUNC(lxor, 8,    int8_t)
+    OP_AVX_LOGICAL_FUNC(lxor, 8,   uint8_t)
+    OP_AVX_LOGICAL_FUNC(lxor, 16,  int16_t)
+    OP_AVX_LOGICAL_FUNC(lxor, 16, uint16_t)
+    OP_AVX_LOGICAL_FUNC(lxor, 32,  int32_t)
+    OP_AVX_LOGICAL_FUNC(lxor, 32, uint32_t)
+    OP_AVX_LOGICAL_FUNC(lxor, 64,  int64_t)
+    OP_AVX_LOGICAL_FUNC(lxor, 64, uint64_t)
+
+/*************************************************************************
+ * Max location
+ *************************************************************************/
+    OP_AVX_LOC_FUNC(maxloc, 2int, 32)
+    OP_AVX_LOC_FUNC(maxloc, float_int, 32)
+    OP_AVX_LOC_FUNC(maxloc, double_int, 64)
+
+/*************************************************************************
+ * Min location
+ *************************************************************************/
+    OP_AVX_LOC_FUNC(minloc, 2int, 32)
+    OP_AVX_LOC_FUNC(minloc, float_int, 32)
+    OP_AVX_LOC_FUNC(minloc, double_int, 64)
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
 /*
  *  This is a three buffer (2 input and 1 output) version of the reduction
  *  routines, needed for some optimizations.
@@ -1339,6 +1629,340 @@ static void OP_CONCAT(ompi_op_avx_3buff_##op##_double,PREPEND)(const void *_in1,
     // not defined - OP_AVX_FLOAT_FUNC_3(xor)
     // not defined - OP_AVX_DOUBLE_FUNC_3(xor)
 
+#define OP_AVX_LOGICAL_FUNC_3(name, type_size, type)                    \
+static void OP_CONCAT(ompi_op_avx_3buff_##name##_##type,PREPEND)(const void * restrict _in1, \
+                                                                 const void * restrict _in2, \
+                                                                 void * restrict _out, int *count, \
+                                                                 struct ompi_datatype_t **dtype, \
+                                                                 struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int i = 0, n = *count;                                              \
+    type *in1 = (type*)_in1, *in2 = (type*)_in2, *out = (type*)_out;    \
+    OP_AVX_AVX512_LOGICAL_FUNC(name, type_size, type, in1, in2, out);   \
+    OP_AVX_AVX2_LOGICAL_FUNC(name, type_size, type, in1, in2, out);     \
+    for( ; i < n; i++ ) {                                               \
+        out[i] = current_func(in1[i], in2[i]);                          \
+    }                                                                   \
+}
+
+#define OP_AVX_LOC_FUNC_3(name, type_name, width)                       \
+static void OP_CONCAT(ompi_op_avx_3buff_##name##_##type_name,PREPEND)(const void * restrict _in1, \
+                                                                      const void * restrict _in2, \
+                                                                      void * restrict _out, int *count, \
+                                                                      struct ompi_datatype_t **dtype, \
+                                                                      struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int i = 0, n = *count;                                              \
+    ompi_op_avx_##type_name##_t *in1 = (ompi_op_avx_##type_name##_t*)_in1; \
+    ompi_op_avx_##type_name##_t *in2 = (ompi_op_avx_##type_name##_t*)_in2; \
+    ompi_op_avx_##type_name##_t *out = (ompi_op_avx_##type_name##_t*)_out; \
+    OP_AVX_AVX512_LOC##width##_FUNC(name, type_name, in1, in2, out);    \
+    OP_AVX_AVX2_LOC##width##_FUNC(name, type_name, in1, in2, out);      \
+    for( ; i < n; i++ ) {                                               \
+        OP_AVX_LOC_SCALAR(name, in1[i], in2[i], out[i]);                \
+    }                                                                   \
+}
+
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+/*************************************************************************
+ * Logical AND
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) && (b))
+    OP_AVX_LOGICAL_FUNC_3(land, 8,    int8_t)
+    OP_AVX_LOGICAL_FUNC_3(land, 8,   uint8_t)
+    OP_AVX_LOGICAL_FUNC_3(land, 16,  int16_t)
+    OP_AVX_LOGICAL_FUNC_3(land, 16, uint16_t)
+    OP_AVX_LOGICAL_FUNC_3(land, 32,  int32_t)
+    OP_AVX_LOGICAL_FUNC_3(land, 32, uint32_t)
+    OP_AVX_LOGICAL_FUNC_3(land, 64,  int64_t)
+    OP_AVX_LOGICAL_FUNC_3(land, 64, uint64_t)
+
+/*************************************************************************
+ * Logical OR
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) || (b))
+    OP_AVX_LOGICAL_FUNC_3(lor, 8,    int8_t)
+    OP_AVX_LOGICAL_FUNC_3(lor, 8,   uint8_t)
+    OP_AVX_LOGICAL_FUNC_3(lor, 16,  int16_t)
+    OP_AVX_LOGICAL_FUNC_3(lor, 16, uint16_t)
+    OP_AVX_LOGICAL_FUNC_3(lor, 32,  int32_t)
+    OP_AVX_LOGICAL_FUNC_3(lor, 32, uint32_t)
+    OP_AVX_LOGICAL_FUNC_3(lor, 64,  int64_t)
+    OP_AVX_LOGICAL_FUNC_3(lor, 64, uint64_t)
+
+/*************************************************************************
+ * Logical XOR
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a ? 1 : 0) ^ (b ? 1: 0))
+    OP_AVX_LOGICAL_FUNC_3(lxor, 8,    int8_t)
+    OP_AVX_LOGICAL_FUNC_3(lxor, 8,   uint8_t)
+    OP_AVX_LOGICAL_FUNC_3(lxor, 16,  int16_t)
+    OP_AVX_LOGICAL_FUNC_3(lxor, 16, uint16_t)
+    OP_AVX_LOGICAL_FUNC_3(lxor, 32,  int32_t)
+    OP_AVX_LOGICAL_FUNC_3(lxor, 32, uint32_t)
+    OP_AVX_LOGICAL_FUNC_3(lxor, 64,  int64_t)
+    OP_AVX_LOGICAL_FUNC_3(lxor, 64, uint64_t)
+
+/*************************************************************************
+ * Max location
+ *************************************************************************/
+    OP_AVX_LOC_FUNC_3(maxloc, 2int, 32)
+    OP_AVX_LOC_FUNC_3(maxloc, float_int, 32)
+    OP_AVX_LOC_FUNC_3(maxloc, double_int, 64)
+
+/*************************************************************************
+ * Min location
+ *************************************************************************/
+    OP_AVX_LOC_FUNC_3(minloc, 2int, 32)
+    OP_AVX_LOC_FUNC_3(minloc, float_int, 32)
+    OP_AVX_LOC_FUNC_3(minloc, double_int, 64)
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
+/*
+ *  These macros are for the 16-bit floating point types: short float, when
+ *  it is an IEEE half, and bfloat16. The elements are converted to float,
+ *  the operation is done in float and the result is rounded to nearest
+ *  even: as float has more than twice their precision, this is exactly the
+ *  native 16-bit operation. Like the logical ones, they process the
+ *  elements of a and b from index i, storing into o, and leave the
+ *  remaining elements (from index i to n) to the scalar loop.
+ *
+ *  Support ops: max, min, sum, prod
+ */
+#if (defined(HAVE_SHORT_FLOAT) && (2 == SIZEOF_SHORT_FLOAT)) || \
+    (!defined(HAVE_SHORT_FLOAT) && defined(HAVE_OPAL_SHORT_FLOAT_T) && (2 == SIZEOF_OPAL_SHORT_FLOAT_T))
+#define OP_AVX_HAVE_HALF 1
+#if defined(HAVE_SHORT_FLOAT)
+typedef short float ompi_op_avx_half_t;
+#else
+typedef opal_short_float_t ompi_op_avx_half_t;
+#endif  /* defined(HAVE_SHORT_FLOAT) */
+#endif  /* 2 bytes short float */
+typedef uint16_t ompi_op_avx_bfloat16_t;
+
+#define OP_AVX_TO_FLOAT_half(v)       ((float)(v))
+#define OP_AVX_FROM_FLOAT_half(f)     ((ompi_op_avx_half_t)(f))
+#define OP_AVX_TO_FLOAT_bfloat16(v)   ompi_op_bfloat16_to_float(v)
+#define OP_AVX_FROM_FLOAT_bfloat16(f) ompi_op_float_to_bfloat16(f)
+
+#if defined(GENERATE_AVX512_CODE) && defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512)
+#if __AVX512F__
+/* Same rounding as ompi_op_float_to_bfloat16 */
+static inline __m256i ompi_op_avx512_ps_to_bfloat16(__m512 v)
+{
+    __m512i u = _mm512_castps_si512(v);
+    __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+    __m512i r = _mm512_add_epi32(u, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff)));
+    __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+    r = _mm512_mask_mov_epi32(r, nan, _mm512_or_si512(u, _mm512_set1_epi32(0x00400000)));
+    return _mm512_cvtepi32_epi16(_mm512_srli_epi32(r, 16));
+}
+#define OP_AVX_AVX512_LOAD_half(p)         _mm512_cvtph_ps(_mm256_loadu_si256((__m256i*)(p)))
+#define OP_AVX_AVX512_STORE_half(p, v)     _mm256_storeu_si256((__m256i*)(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC))
+#define OP_AVX_AVX512_LOAD_bfloat16(p)     _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((__m256i*)(p))), 16))
+#define OP_AVX_AVX512_STORE_bfloat16(p, v) _mm256_storeu_si256((__m256i*)(p), ompi_op_avx512_ps_to_bfloat16(v))
+#define OP_AVX_AVX512_16BIT_FUNC(op, type_name, a, b, o)                \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG) ) {         \
+        for( ; (i + 16) <= n; i += 16 ) {                               \
+            __m512 vecA = OP_AVX_AVX512_LOAD_##type_name((a) + i);      \
+            __m512 vecB = OP_AVX_AVX512_LOAD_##type_name((b) + i);      \
+            OP_AVX_AVX512_STORE_##type_name((o) + i, _mm512_##op##_ps(vecA, vecB)); \
+        }                                                               \
+    }
+
+/*
+ * The native 16-bit instructions are not enabled for the whole file, as
+ * the compiler could then use them outside of the runtime checks: they
+ * are only used by these functions, processing 32 halves or 16 bfloat16
+ * per iteration. They return the number of elements processed.
+ */
+#if defined(OMPI_MCA_OP_HAVE_AVX512_FP16) && (1 == OMPI_MCA_OP_HAVE_AVX512_FP16) && defined(OP_AVX_HAVE_HALF)
+#define OP_AVX_AVX512_FP16_HELPER(op)                                   \
+static int __attribute__((target("avx512fp16")))                        \
+ompi_op_avx512_fp16_##op(const ompi_op_avx_half_t *a, const ompi_op_avx_half_t *b, \
+                         ompi_op_avx_half_t *o, int n)                  \
+{                                                                       \
+    int i = 0;                                                          \
+    for( ; (i + 32) <= n; i += 32 ) {                                   \
+        __m512h vecA = _mm512_castsi512_ph(_mm512_loadu_si512(a + i));  \
+        __m512h vecB = _mm512_castsi512_ph(_mm512_loadu_si512(b + i));  \
+        _mm512_storeu_si512(o + i, _mm512_castph_si512(_mm512_##op##_ph(vecA, vecB))); \
+    }                                                                   \
+    return i;                                                           \
+}
+#define OP_AVX_AVX512_NATIVE_half(op, a, b, o)                          \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512_FP16_FLAG) ) {     \
+        i = ompi_op_avx512_fp16_##op(a, b, o, n);                       \
+    }
+#endif  /* OMPI_MCA_OP_HAVE_AVX512_FP16 */
+/*
+ * The conversion instruction treats the denormals as zero, so it is only
+ * used when the bf16_native MCA parameter asks for it.
+ */
+#if defined(OMPI_MCA_OP_HAVE_AVX512_BF16) && (1 == OMPI_MCA_OP_HAVE_AVX512_BF16)
+#define OP_AVX_AVX512_BF16_HELPER(op)                                   \
+static int __attribute__((target("avx512bf16")))                        \
+ompi_op_avx512_bf16_##op(const ompi_op_avx_bfloat16_t *a, const ompi_op_avx_bfloat16_t *b, \
+                         ompi_op_avx_bfloat16_t *o, int n)              \
+{                                                                       \
+    int i = 0;                                                          \
+    for( ; (i + 16) <= n; i += 16 ) {                                   \
+        __m512 vecA = OP_AVX_AVX512_LOAD_bfloat16(a + i);               \
+        __m512 vecB = OP_AVX_AVX512_LOAD_bfloat16(b + i);               \
+        __m256bh res = _mm512_cvtneps_pbh(_mm512_##op##_ps(vecA, vecB)); \
+        _mm256_storeu_si256((__m256i*)(o + i), (__m256i)res);           \
+    }                                                                   \
+    return i;                                                           \
+}
+#define OP_AVX_AVX512_NATIVE_bfloat16(op, a, b, o)                      \
+    if( mca_op_avx_component.bf16_native                                \
+        && OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512_BF16_FLAG) ) {  \
+        i = ompi_op_avx512_bf16_##op(a, b, o, n);                       \
+    }
+#endif  /* OMPI_MCA_OP_HAVE_AVX512_BF16 */
+#else
+#error Target architecture lacks AVX512F support needed for _mm512_cvtph_ps and _mm512_cvtepi32_epi16
+#endif  /* __AVX512F__ */
+#else
+#define OP_AVX_AVX512_16BIT_FUNC(op, type_name, a, b, o) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512) */
+#if !defined(OP_AVX_AVX512_FP16_HELPER)
+#define OP_AVX_AVX512_FP16_HELPER(op)
+#define OP_AVX_AVX512_NATIVE_half(op, a, b, o) {}
+#endif
+#if !defined(OP_AVX_AVX512_BF16_HELPER)
+#define OP_AVX_AVX512_BF16_HELPER(op)
+#define OP_AVX_AVX512_NATIVE_bfloat16(op, a, b, o) {}
+#endif
+
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+#if __AVX2__
+/* Same rounding as ompi_op_float_to_bfloat16 */
+static inline __m128i ompi_op_avx2_ps_to_bfloat16(__m256 v)
+{
+    __m256i u = _mm256_castps_si256(v);
+    __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+    __m256i r = _mm256_add_epi32(u, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff)));
+    __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+    r = _mm256_blendv_epi8(r, _mm256_or_si256(u, _mm256_set1_epi32(0x00400000)), nan);
+    /* packus works inside the 128-bit lanes: gather the two useful quadwords */
+    r = _mm256_packus_epi32(_mm256_srli_epi32(r, 16), _mm256_setzero_si256());
+    return _mm256_castsi256_si128(_mm256_permute4x64_epi64(r, 0xD8));
+}
+#define OP_AVX_AVX2_LOAD_half(p)         _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)(p)))
+#define OP_AVX_AVX2_STORE_half(p, v)     _mm_storeu_si128((__m128i*)(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC))
+#define OP_AVX_AVX2_FLAGS_half           (OMPI_OP_AVX_HAS_AVX2_FLAG | OMPI_OP_AVX_HAS_F16C_FLAG)
+#define OP_AVX_AVX2_LOAD_bfloat16(p)     _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i*)(p))), 16))
+#define OP_AVX_AVX2_STORE_bfloat16(p, v) _mm_storeu_si128((__m128i*)(p), ompi_op_avx2_ps_to_bfloat16(v))
+#define OP_AVX_AVX2_FLAGS_bfloat16       OMPI_OP_AVX_HAS_AVX2_FLAG
+#define OP_AVX_AVX2_16BIT_LOOP(op, type_name, a, b, o)                  \
+    if( OMPI_OP_AVX_HAS_FLAGS(OP_AVX_AVX2_FLAGS_##type_name) ) {        \
+        for( ; (i + 8) <= n; i += 8 ) {                                 \
+            __m256 vecA = OP_AVX_AVX2_LOAD_##type_name((a) + i);        \
+            __m256 vecB = OP_AVX_AVX2_LOAD_##type_name((b) + i);        \
+            OP_AVX_AVX2_STORE_##type_name((o) + i, _mm256_##op##_ps(vecA, vecB)); \
+        }                                                               \
+    }
+#define OP_AVX_AVX2_16BIT_FUNC_bfloat16(op, a, b, o) OP_AVX_AVX2_16BIT_LOOP(op, bfloat16, a, b, o)
+#if defined(OMPI_MCA_OP_HAVE_F16C) && (1 == OMPI_MCA_OP_HAVE_F16C) && defined(__F16C__)
+#define OP_AVX_AVX2_16BIT_FUNC_half(op, a, b, o) OP_AVX_AVX2_16BIT_LOOP(op, half, a, b, o)
+#else
+/* Without F16C the halves are left to the scalar loop */
+#define OP_AVX_AVX2_16BIT_FUNC_half(op, a, b, o) {}
+#endif  /* __F16C__ */
+#else
+#error Target architecture lacks AVX2 support needed for _mm256_cvtepu16_epi32 and _mm256_packus_epi32
+#endif  /* __AVX2__ */
+#else
+#define OP_AVX_AVX2_16BIT_FUNC_half(op, a, b, o) {}
+#define OP_AVX_AVX2_16BIT_FUNC_bfloat16(op, a, b, o) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
+#define OP_AVX_16BIT_FUNC(op, type_name)                                \
+static void OP_CONCAT(ompi_op_avx_2buff_##op##_##type_name,PREPEND)(const void *_in, void *_out, int *count, \
+                                                                    struct ompi_datatype_t **dtype, \
+                                                                    struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int i = 0, n = *count;                                              \
+    ompi_op_avx_##type_name##_t *in = (ompi_op_avx_##type_name##_t*)_in; \
+    ompi_op_avx_##type_name##_t *out = (ompi_op_avx_##type_name##_t*)_out; \
+    OP_AVX_AVX512_NATIVE_##type_name(op, out, in, out);                 \
+    OP_AVX_AVX512_16BIT_FUNC(op, type_name, out, in, out);              \
+    OP_AVX_AVX2_16BIT_FUNC_##type_name(op, out, in, out);                \
+    for( ; i < n; i++ ) {                                               \
+        out[i] = OP_AVX_FROM_FLOAT_##type_name(current_func(OP_AVX_TO_FLOAT_##type_name(out[i]), \
+                                                            OP_AVX_TO_FLOAT_##type_name(in[i]))); \
+    }                                                                   \
+}
+
+#define OP_AVX_16BIT_FUNC_3(op, type_name)                              \
+static void OP_CONCAT(ompi_op_avx_3buff_##op##_##type_name,PREPEND)(const void * restrict _in1, \
+                                                                    const void * restrict _in2, \
+                                                                    void * restrict _out, int *count, \
+                                                                    struct ompi_datatype_t **dtype, \
+                                                                    struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int i = 0, n = *count;                                              \
+    ompi_op_avx_##type_name##_t *in1 = (ompi_op_avx_##type_name##_t*)_in1; \
+    ompi_op_avx_##type_name##_t *in2 = (ompi_op_avx_##type_name##_t*)_in2; \
+    ompi_op_avx_##type_name##_t *out = (ompi_op_avx_##type_name##_t*)_out; \
+    OP_AVX_AVX512_NATIVE_##type_name(op, in1, in2, out);                \
+    OP_AVX_AVX512_16BIT_FUNC(op, type_name, in1, in2, out);             \
+    OP_AVX_AVX2_16BIT_FUNC_##type_name(op, in1, in2, out);               \
+    for( ; i < n; i++ ) {                                               \
+        out[i] = OP_AVX_FROM_FLOAT_##type_name(current_func(OP_AVX_TO_FLOAT_##type_name(in1[i]), \
+                                                            OP_AVX_TO_FLOAT_##type_name(in2[i]))); \
+    }                                                                   \
+}
+
+#if defined(OP_AVX_HAVE_HALF)
+#define OP_AVX_HALF_FUNCS(op)                                           \
+    OP_AVX_AVX512_FP16_HELPER(op)                                       \
+    OP_AVX_16BIT_FUNC(op, half)                                         \
+    OP_AVX_16BIT_FUNC_3(op, half)
+#else
+#define OP_AVX_HALF_FUNCS(op)
+#endif  /* defined(OP_AVX_HAVE_HALF) */
+
+#define OP_AVX_16BIT_FUNCS(op)                                          \
+    OP_AVX_HALF_FUNCS(op)                                               \
+    OP_AVX_AVX512_BF16_HELPER(op)                                       \
+    OP_AVX_16BIT_FUNC(op, bfloat16)                                     \
+    OP_AVX_16BIT_FUNC_3(op, bfloat16)
+
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+/*************************************************************************
+ * Max
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) > (b) ? (a) : (b))
+    OP_AVX_16BIT_FUNCS(max)
+
+/*************************************************************************
+ * Min
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) < (b) ? (a) : (b))
+    OP_AVX_16BIT_FUNCS(min)
+
+/*************************************************************************
+ * Sum
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) + (b))
+    OP_AVX_16BIT_FUNCS(add)
+
+/*************************************************************************
+ * Product
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) * (b))
+    OP_AVX_16BIT_FUNCS(mul)
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
 /** C integer ***********************************************************/
 #define C_INTEGER_8_16_32(name, ftype)                                                         \
     [OMPI_OP_BASE_TYPE_INT8_T]   = OP_CONCAT(ompi_op_avx_##ftype##_##name##_int8_t,PREPEND),   \
@@ -1363,12 +1987,38 @@ static void OP_CONCAT(ompi_op_avx_3buff_##op##_double,PREPEND)(const void *_in1,
     C_INTEGER_8_16_32(name, ftype)
 #endif
 
+/** Logical and location, only with AVX2 or AVX512 *********************/
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+#define C_INTEGER_LOGICAL(name, ftype)                                                         \
+    C_INTEGER(name, ftype)
+#define LOC_PAIRS(name, ftype)                                                                 \
+    [OMPI_OP_BASE_TYPE_FLOAT_INT]  = OP_CONCAT(ompi_op_avx_##ftype##_##name##_float_int,PREPEND),  \
+    [OMPI_OP_BASE_TYPE_DOUBLE_INT] = OP_CONCAT(ompi_op_avx_##ftype##_##name##_double_int,PREPEND), \
+    [OMPI_OP_BASE_TYPE_2INT]       = OP_CONCAT(ompi_op_avx_##ftype##_##name##_2int,PREPEND)
+#else
+#define C_INTEGER_LOGICAL(name, ftype) NULL
+#define LOC_PAIRS(name, ftype) NULL
+#endif
+
 /** Floating point, including all the Fortran reals *********************/
 #define FLOAT(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_float,PREPEND)
 #define DOUBLE(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_double,PREPEND)
 
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+#if defined(OP_AVX_HAVE_HALF)
+#define SHORT_FLOAT(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_half,PREPEND)
+#else
+#define SHORT_FLOAT(name, ftype) NULL
+#endif  /* defined(OP_AVX_HAVE_HALF) */
+#define BFLOAT16(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_bfloat16,PREPEND)
+#else
+#define SHORT_FLOAT(name, ftype) NULL
+#define BFLOAT16(name, ftype) NULL
+#endif
+
 #define FLOATING_POINT(name, ftype)                                         \
-    [OMPI_OP_BASE_TYPE_SHORT_FLOAT] = NULL,                                 \
+    [OMPI_OP_BASE_TYPE_SHORT_FLOAT] = SHORT_FLOAT(name, ftype),             \
+    [OMPI_OP_BASE_TYPE_BFLOAT16] = BFLOAT16(name, ftype),                   \
     [OMPI_OP_BASE_TYPE_FLOAT] = FLOAT(name, ftype),                         \
     [OMPI_OP_BASE_TYPE_DOUBLE] = DOUBLE(name, ftype)
 
@@ -1411,7 +2061,7 @@ ompi_op_base_handler_fn_t OP_CONCAT(ompi_op_avx_functions, PREPEND)[OMPI_OP_BASE
     },
     /* Corresponds to MPI_LAND */
     [OMPI_OP_BASE_FORTRAN_LAND] = {
-        NULL,
+        C_INTEGER_LOGICAL(land, 2buff),
     },
     /* Corresponds to MPI_BAND */
     [OMPI_OP_BASE_FORTRAN_BAND] = {
@@ -1419,7 +2069,7 @@ ompi_op_base_handler_fn_t OP_CONCAT(ompi_op_avx_functions, PREPEND)[OMPI_OP_BASE
     },
     /* Corresponds to MPI_LOR */
     [OMPI_OP_BASE_FORTRAN_LOR] = {
-        NULL,
+        C_INTEGER_LOGICAL(lor, 2buff),
     },
     /* Corresponds to MPI_BOR */
     [OMPI_OP_BASE_FORTRAN_BOR] = {
@@ -1427,12 +2077,20 @@ ompi_op_base_handler_fn_t OP_CONCAT(ompi_op_avx_functions, PREPEND)[OMPI_OP_BASE
     },
     /* Corresponds to MPI_LXOR */
     [OMPI_OP_BASE_FORTRAN_LXOR] = {
-        NULL,
+        C_INTEGER_LOGICAL(lxor, 2buff),
     },
     /* Corresponds to MPI_BXOR */
     [OMPI_OP_BASE_FORTRAN_BXOR] = {
         C_INTEGER(bxor, 2buff),
     },
+    /* Corresponds to MPI_MAXLOC */
+    [OMPI_OP_BASE_FORTRAN_MAXLOC] = {
+        LOC_PAIRS(maxloc, 2buff),
+    },
+    /* Corresponds to MPI_MINLOC */
+    [OMPI_OP_BASE_FORTRAN_MINLOC] = {
+        LOC_PAIRS(minloc, 2buff),
+    },
     /* Corresponds to MPI_REPLACE */
     [OMPI_OP_BASE_FORTRAN_REPLACE] = {
         /* (MPI_ACCUMULATE is handled differently than the other
@@ -1474,7 +2132,7 @@ ompi_op_base_3buff_handler_fn_t OP_CONCAT(ompi_op_avx_3buff_functions, PREPEND)[
     },
     /* Corresponds to MPI_LAND */
     [OMPI_OP_BASE_FORTRAN_LAND] ={
-        NULL,
+        C_INTEGER_LOGICAL(land, 3buff),
     },
     /* Corresponds to MPI_BAND */
     [OMPI_OP_BASE_FORTRAN_BAND] = {
@@ -1482,7 +2140,7 @@ ompi_op_base_3buff_handler_fn_t OP_CONCAT(ompi_op_avx_3buff_functions, PREPEND)[
     },
     /* Corresponds to MPI_LOR */
     [OMPI_OP_BASE_FORTRAN_LOR] = {
-        NULL,
+        C_INTEGER_LOGICAL(lor, 3buff),
     },
     /* Corresponds to MPI_BOR */
     [OMPI_OP_BASE_FORTRAN_BOR] = {
@@ -1490,12 +2148,20 @@ ompi_op_base_3buff_handler_fn_t OP_CONCAT(ompi_op_avx_3buff_functions, PREPEND)[
     },
     /* Corresponds to MPI_LXOR */
     [OMPI_OP_BASE_FORTRAN_LXOR] = {
-        NULL,
+        C_INTEGER_LOGICAL(lxor, 3buff),
     },
     /* Corresponds to MPI_BXOR */
     [OMPI_OP_BASE_FORTRAN_BXOR] = {
         C_INTEGER(xor, 3buff),
     },
+    /* Corresponds to MPI_MAXLOC */
+    [OMPI_OP_BASE_FORTRAN_MAXLOC] = {
+        LOC_PAIRS(maxloc, 3buff),
+    },
+    /* Corresponds to MPI_MINLOC */
+    [OMPI_OP_BASE_FORTRAN_MINLOC] = {
+        LOC_PAIRS(minloc, 3buff),
+    },
     /* Corresponds to MPI_REPLACE */
     [OMPI_OP_BASE_FORTRAN_REPLACE] = {
         /* MPI_ACCUMULATE is handled differently than the other
@@ -95,5 +95,10 @@ OMPI_DECLSPEC int ompi_op_base_op_unselect(struct ompi_op_t *op);
 
 OMPI_DECLSPEC extern mca_base_framework_t ompi_op_base_framework;
 
+/**
+ * Stop the helper threads of the reduction pool, if they were started.
+ */
+void ompi_op_base_reduce_pool_fini(void);
+
 END_C_DECLS
 #endif /* MCA_OP_BASE_H */
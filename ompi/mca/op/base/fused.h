@@ -0,0 +1,108 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Helpers for the op components implementing the fused reduce-and-copy
+ * and N-ary functions with their own 2-buffer and 3-buffer functions.
+ *
+ * The elements are processed by chunks small enough to stay in the L1
+ * cache between the steps: the copy (or the following reductions into
+ * the output) then reads the result from the cache instead of memory.
+ */
+
+#ifndef OMPI_OP_BASE_FUSED_H
+#define OMPI_OP_BASE_FUSED_H
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/op/op.h"
+
+BEGIN_C_DECLS
+
+/** Size in bytes of the chunks processed at once */
+#define OMPI_OP_BASE_FUSED_CHUNK_SIZE 8192
+
+/**
+ * Copy function of the components, usually with non-temporal stores,
+ * which must be ordered with the following stores before returning.
+ */
+typedef void (*ompi_op_base_stream_copy_fn_t)(void *dst, const void *src, size_t len);
+
+static inline int ompi_op_base_fused_chunk(struct ompi_datatype_t *dtype, size_t *dsize)
+{
+    *dsize = dtype->super.size;
+    return (*dsize >= OMPI_OP_BASE_FUSED_CHUNK_SIZE) ? 1 : (int)(OMPI_OP_BASE_FUSED_CHUNK_SIZE / *dsize);
+}
+
+/**
+ * Reduce in into inout and copy the result, with the 2-buffer function
+ * of the module. Segments of at least stream_threshold bytes are copied
+ * with stream_copy, the smaller ones (which are likely to be used again
+ * from the cache) with memcpy.
+ */
+static inline void
+ompi_op_base_fused_reduce_copy(const void *in, void *inout, void *copy, int *count,
+                               struct ompi_datatype_t **dtype,
+                               struct ompi_op_base_module_1_0_0_t *module,
+                               size_t stream_threshold, ompi_op_base_stream_copy_fn_t stream_copy)
+{
+    ompi_op_base_handler_fn_t fn = module->opm_fns[ompi_op_ddt_map[(*dtype)->id]];
+    size_t dsize;
+    int chunk = ompi_op_base_fused_chunk(*dtype, &dsize);
+
+    if ((size_t)*count * dsize < stream_threshold) {
+        fn(in, inout, count, dtype, module);
+        memcpy(copy, inout, (size_t)*count * dsize);
+        return;
+    }
+    for (int done = 0, n; done < *count; done += n) {
+        size_t offset = (size_t)done * dsize;
+        n = (*count - done < chunk) ? (*count - done) : chunk;
+        fn((const char *)in + offset, (char *)inout + offset, &n, dtype, module);
+        stream_copy((char *)copy + offset, (char *)inout + offset, (size_t)n * dsize);
+    }
+}
+
+/**
+ * Reduce the nin inputs into out, with the 3-buffer function of the
+ * module for the last two inputs and its 2-buffer function for the
+ * others. As the intrinsic ops are commutative, the order only matters
+ * for the rounding of the floating point types.
+ */
+static inline void
+ompi_op_base_fused_reduce_nary(const void *const *in, int nin, void *out, int *count,
+                               struct ompi_datatype_t **dtype,
+                               struct ompi_op_base_module_1_0_0_t *module)
+{
+    int dtype_id = ompi_op_ddt_map[(*dtype)->id];
+    ompi_op_base_handler_fn_t fn = module->opm_fns[dtype_id];
+    ompi_op_base_3buff_handler_fn_t fn3 = module->opm_3buff_fns[dtype_id];
+    size_t dsize;
+    int chunk = ompi_op_base_fused_chunk(*dtype, &dsize);
+
+    for (int done = 0, n; done < *count; done += n) {
+        size_t offset = (size_t)done * dsize;
+        n = (*count - done < chunk) ? (*count - done) : chunk;
+        fn3((const char *)in[nin - 2] + offset, (const char *)in[nin - 1] + offset,
+            (char *)out + offset, &n, dtype, module);
+        for (int i = nin - 3; i >= 0; i--) {
+            fn((const char *)in[i] + offset, (char *)out + offset, &n, dtype, module);
+        }
+    }
+}
+
+END_C_DECLS
+
+#endif /* OMPI_OP_BASE_FUSED_H */
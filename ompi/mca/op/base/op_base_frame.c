@@ -29,6 +29,7 @@
 #include "ompi/constants.h"
 #include "ompi/mca/op/op.h"
 #include "ompi/mca/op/base/base.h"
+#include "ompi/op/op.h"
 
 
 /*
@@ -44,6 +45,8 @@ static void module_constructor(ompi_op_base_module_t *m)
     m->opm_op = NULL;
     memset(&(m->opm_fns), 0, sizeof(m->opm_fns));
     memset(&(m->opm_3buff_fns), 0, sizeof(m->opm_3buff_fns));
+    memset(&(m->opm_copy_fns), 0, sizeof(m->opm_copy_fns));
+    memset(&(m->opm_nary_fns), 0, sizeof(m->opm_nary_fns));
 }
 
 static void module_constructor_1_0_0(ompi_op_base_module_1_0_0_t *m)
@@ -52,6 +55,8 @@ static void module_constructor_1_0_0(ompi_op_base_module_1_0_0_t *m)
     m->opm_op = NULL;
     memset(&(m->opm_fns), 0, sizeof(m->opm_fns));
     memset(&(m->opm_3buff_fns), 0, sizeof(m->opm_3buff_fns));
+    memset(&(m->opm_copy_fns), 0, sizeof(m->opm_copy_fns));
+    memset(&(m->opm_nary_fns), 0, sizeof(m->opm_nary_fns));
 }
 
 OBJ_CLASS_INSTANCE(ompi_op_base_module_t, opal_object_t,
@@ -59,5 +64,32 @@ OBJ_CLASS_INSTANCE(ompi_op_base_module_t, opal_object_t,
 OBJ_CLASS_INSTANCE(ompi_op_base_module_1_0_0_t, opal_object_t,
                    module_constructor_1_0_0, NULL);
 
-MCA_BASE_FRAMEWORK_DECLARE(ompi, op, NULL, NULL, NULL, NULL,
+static int ompi_op_base_register(mca_base_register_flag_t flags)
+{
+    ompi_op_base_reduce_threads = 0;
+    (void) mca_base_framework_var_register(&ompi_op_base_framework, "reduce_threads",
+                                           "Number of helper threads used to split large "
+                                           "reductions of intrinsic operations (0 disables "
+                                           "helper threads, default: 0)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &ompi_op_base_reduce_threads);
+
+    ompi_op_base_reduce_threshold = 64 * 1024 * 1024;
+    (void) mca_base_framework_var_register(&ompi_op_base_framework, "reduce_threshold",
+                                           "Minimum size of a reduction that is split across "
+                                           "the helper threads (default: 64M)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &ompi_op_base_reduce_threshold);
+
+    return OMPI_SUCCESS;
+}
+
+static int ompi_op_base_close(void)
+{
+    ompi_op_base_reduce_pool_fini();
+
+    return mca_base_framework_components_close(&ompi_op_base_framework, NULL);
+}
+
+MCA_BASE_FRAMEWORK_DECLARE(ompi, op, NULL, ompi_op_base_register, NULL, ompi_op_base_close,
                            mca_op_base_static_components, 0);
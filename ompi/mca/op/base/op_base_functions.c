@@ -146,6 +146,27 @@
       }                                                                  \
   }
 
+/*
+ * bfloat16 has no C type: the operation is computed in float and
+ * rounded back to bfloat16. op is a function-like macro taking the two
+ * float operands, in the same order as for FUNC_FUNC.
+ */
+#define BFLOAT16_ADD(a, b) ((a) + (b))
+#define BFLOAT16_MUL(a, b) ((a) * (b))
+#define BFLOAT16_FUNC(name, op) \
+  static void ompi_op_base_2buff_##name##_bfloat16(const void *in, void *out, int *count, \
+                                                   struct ompi_datatype_t **dtype, \
+                                                   struct ompi_op_base_module_1_0_0_t *module) \
+  {                                                                      \
+      int i;                                                             \
+      const uint16_t *a = (const uint16_t *) in;                         \
+      uint16_t *b = (uint16_t *) out;                                    \
+      for (i = *count; i > 0; i--, ++a, ++b) {                           \
+          *b = ompi_op_float_to_bfloat16(op(ompi_op_bfloat16_to_float(*b), \
+                                            ompi_op_bfloat16_to_float(*a))); \
+      }                                                                  \
+  }
+
 /*************************************************************************
  * Max
  *************************************************************************/
@@ -189,6 +210,7 @@ FUNC_FUNC(max, short_float, short float)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 FUNC_FUNC(max, short_float, opal_short_float_t)
 #endif
+BFLOAT16_FUNC(max, current_func)
 FUNC_FUNC(max, float, float)
 FUNC_FUNC(max, double, double)
 FUNC_FUNC(max, long_double, long double)
@@ -255,6 +277,7 @@ FUNC_FUNC(min, short_float, short float)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 FUNC_FUNC(min, short_float, opal_short_float_t)
 #endif
+BFLOAT16_FUNC(min, current_func)
 FUNC_FUNC(min, float, float)
 FUNC_FUNC(min, double, double)
 FUNC_FUNC(min, long_double, long double)
@@ -318,6 +341,7 @@ OP_FUNC(sum, short_float, short float, +=)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 OP_FUNC(sum, short_float, opal_short_float_t, +=)
 #endif
+BFLOAT16_FUNC(sum, BFLOAT16_ADD)
 OP_FUNC(sum, float, float, +=)
 OP_FUNC(sum, double, double, +=)
 OP_FUNC(sum, long_double, long double, +=)
@@ -390,6 +414,7 @@ OP_FUNC(prod, short_float, short float, *=)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 OP_FUNC(prod, short_float, opal_short_float_t, *=)
 #endif
+BFLOAT16_FUNC(prod, BFLOAT16_MUL)
 OP_FUNC(prod, float, float, *=)
 OP_FUNC(prod, double, double, *=)
 OP_FUNC(prod, long_double, long double, *=)
@@ -723,6 +748,25 @@ LOC_FUNC(minloc, long_double_int, <)
         }                                                               \
     }
 
+/*
+ * bfloat16, computed in float (see BFLOAT16_FUNC)
+ */
+#define BFLOAT16_FUNC_3BUF(name, op)                                    \
+    static void ompi_op_base_3buff_##name##_bfloat16(const void * restrict in1, \
+                                                     const void * restrict in2, void * restrict out, int *count, \
+                                                     struct ompi_datatype_t **dtype, \
+                                                     struct ompi_op_base_module_1_0_0_t *module) \
+    {                                                                   \
+        int i;                                                          \
+        const uint16_t *a1 = (const uint16_t *) in1;                    \
+        const uint16_t *a2 = (const uint16_t *) in2;                    \
+        uint16_t *b = (uint16_t *) out;                                 \
+        for (i = *count; i > 0; i--, ++a1, ++a2, ++b) {                 \
+            *b = ompi_op_float_to_bfloat16(op(ompi_op_bfloat16_to_float(*a1), \
+                                              ompi_op_bfloat16_to_float(*a2))); \
+        }                                                               \
+    }
+
 /*
  * Since all the functions in this file are essentially identical, we
  * use a macro to substitute in names and types.  The core operation
@@ -849,6 +893,7 @@ FUNC_FUNC_3BUF(max, short_float, short float)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 FUNC_FUNC_3BUF(max, short_float, opal_short_float_t)
 #endif
+BFLOAT16_FUNC_3BUF(max, current_func)
 FUNC_FUNC_3BUF(max, float, float)
 FUNC_FUNC_3BUF(max, double, double)
 FUNC_FUNC_3BUF(max, long_double, long double)
@@ -915,6 +960,7 @@ FUNC_FUNC_3BUF(min, short_float, short float)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 FUNC_FUNC_3BUF(min, short_float, opal_short_float_t)
 #endif
+BFLOAT16_FUNC_3BUF(min, current_func)
 FUNC_FUNC_3BUF(min, float, float)
 FUNC_FUNC_3BUF(min, double, double)
 FUNC_FUNC_3BUF(min, long_double, long double)
@@ -978,6 +1024,7 @@ OP_FUNC_3BUF(sum, short_float, short float, +)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 OP_FUNC_3BUF(sum, short_float, opal_short_float_t, +)
 #endif
+BFLOAT16_FUNC_3BUF(sum, BFLOAT16_ADD)
 OP_FUNC_3BUF(sum, float, float, +)
 OP_FUNC_3BUF(sum, double, double, +)
 OP_FUNC_3BUF(sum, long_double, long double, +)
@@ -1050,6 +1097,7 @@ OP_FUNC_3BUF(prod, short_float, short float, *)
 #elif defined(HAVE_OPAL_SHORT_FLOAT_T)
 OP_FUNC_3BUF(prod, short_float, opal_short_float_t, *)
 #endif
+BFLOAT16_FUNC_3BUF(prod, BFLOAT16_MUL)
 OP_FUNC_3BUF(prod, float, float, *)
 OP_FUNC_3BUF(prod, double, double, *)
 OP_FUNC_3BUF(prod, long_double, long double, *)
@@ -1457,12 +1505,14 @@ LOC_FUNC_3BUF(minloc, long_double_int, <)
 #else
 #define SHORT_FLOAT(name, ftype) NULL
 #endif
+#define BFLOAT16(name, ftype) ompi_op_base_##ftype##_##name##_bfloat16
 #define FLOAT(name, ftype) ompi_op_base_##ftype##_##name##_float
 #define DOUBLE(name, ftype) ompi_op_base_##ftype##_##name##_double
 #define LONG_DOUBLE(name, ftype) ompi_op_base_##ftype##_##name##_long_double
 
 #define FLOATING_POINT(name, ftype)                                                            \
   [OMPI_OP_BASE_TYPE_SHORT_FLOAT] = SHORT_FLOAT(name, ftype),                                  \
+  [OMPI_OP_BASE_TYPE_BFLOAT16] = BFLOAT16(name, ftype),                                        \
   [OMPI_OP_BASE_TYPE_FLOAT] = FLOAT(name, ftype),                                              \
   [OMPI_OP_BASE_TYPE_DOUBLE] = DOUBLE(name, ftype),                                            \
   FLOATING_POINT_FORTRAN_REAL(name, ftype),                                                    \
@@ -125,6 +125,20 @@ int ompi_op_base_op_select(ompi_op_t *op)
     /* Offset the initial OBJ_NEW */
     OBJ_RELEASE(module);
 
+    /* There are no base fused functions: the NULL ones are emulated by
+       ompi_op_reduce_copy and ompi_op_reduce_nary */
+    if (NULL == op->o_copy_intrinsic) {
+        op->o_copy_intrinsic = (ompi_op_base_op_copy_fns_t*)
+            calloc(1, sizeof(ompi_op_base_op_copy_fns_t));
+    }
+    if (NULL == op->o_nary_intrinsic) {
+        op->o_nary_intrinsic = (ompi_op_base_op_nary_fns_t*)
+            calloc(1, sizeof(ompi_op_base_op_nary_fns_t));
+    }
+    if (NULL == op->o_copy_intrinsic || NULL == op->o_nary_intrinsic) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
     /* Check for any components that want to run.  It's not an error
        if there are none; we'll just use all the base functions in
        this case. */
@@ -169,6 +183,29 @@ int ompi_op_base_op_select(ompi_op_t *op)
                 op->o_3buff_intrinsic.modules[i] = avail->ao_module;
                 OBJ_RETAIN(avail->ao_module);
             }
+
+            /* fused variants, which must come from the module
+               providing the 2-buffer function */
+            if (NULL != avail->ao_module->opm_fns[i]) {
+                if (NULL != op->o_copy_intrinsic->modules[i]) {
+                    OBJ_RELEASE(op->o_copy_intrinsic->modules[i]);
+                    op->o_copy_intrinsic->modules[i] = NULL;
+                }
+                op->o_copy_intrinsic->fns[i] = avail->ao_module->opm_copy_fns[i];
+                if (NULL != op->o_copy_intrinsic->fns[i]) {
+                    op->o_copy_intrinsic->modules[i] = avail->ao_module;
+                    OBJ_RETAIN(avail->ao_module);
+                }
+                if (NULL != op->o_nary_intrinsic->modules[i]) {
+                    OBJ_RELEASE(op->o_nary_intrinsic->modules[i]);
+                    op->o_nary_intrinsic->modules[i] = NULL;
+                }
+                op->o_nary_intrinsic->fns[i] = avail->ao_module->opm_nary_fns[i];
+                if (NULL != op->o_nary_intrinsic->fns[i]) {
+                    op->o_nary_intrinsic->modules[i] = avail->ao_module;
+                    OBJ_RETAIN(avail->ao_module);
+                }
+            }
         }
 
         /* release the original module reference and the list item */
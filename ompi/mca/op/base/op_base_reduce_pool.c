@@ -0,0 +1,128 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Helper-thread reduction pool
+ *
+ * Large reductions of intrinsic ops on predefined datatypes are split into
+ * chunks that are reduced by the calling thread together with
+ * op_base_reduce_threads helper threads of an opal chunk pool, each chunk
+ * with the op's own 2-buffer or 3-buffer function. When the datatype
+ * extent divides the page size and the distance from the target to its
+ * next page boundary, the chunk boundaries fall on page boundaries of the
+ * target, so no two threads write the same page.
+ */
+
+#include "ompi_config.h"
+
+#include <limits.h>
+
+#include "opal/util/chunk_pool.h"
+#include "opal/util/minmax.h"
+#include "opal/util/sys_limits.h"
+
+#include "ompi/constants.h"
+#include "ompi/mca/op/base/base.h"
+#include "ompi/op/op.h"
+
+int ompi_op_base_reduce_threads = 0;
+size_t ompi_op_base_reduce_threshold = 64 * 1024 * 1024;
+
+static opal_chunk_pool_t ompi_op_base_reduce_pool = OPAL_CHUNK_POOL_STATIC_INIT;
+
+struct ompi_op_base_reduce_job_t {
+    ompi_op_t *op;
+    ompi_datatype_t *dtype;
+    int dtype_id;
+    const char *source1;
+    const char *source2;
+    char *target;
+    ptrdiff_t extent;
+    size_t count;
+    /** elements before the first page boundary, reduced with the first chunk */
+    size_t head;
+    size_t chunk_count;
+};
+typedef struct ompi_op_base_reduce_job_t ompi_op_base_reduce_job_t;
+
+static int ompi_op_base_reduce_pool_chunk(void *ctx, size_t index)
+{
+    ompi_op_base_reduce_job_t *job = (ompi_op_base_reduce_job_t *) ctx;
+    ompi_datatype_t *dtype = job->dtype;
+    int dtype_id = job->dtype_id;
+    size_t start = (0 == index) ? 0 : job->head + index * job->chunk_count;
+    size_t end = opal_min(job->count, job->head + (index + 1) * job->chunk_count);
+    ptrdiff_t shift = (ptrdiff_t) start * job->extent;
+    int count = (int) (end - start);
+
+    if (NULL == job->source2) {
+        job->op->o_func.intrinsic.fns[dtype_id](job->source1 + shift, job->target + shift, &count,
+                                                &dtype, job->op->o_func.intrinsic.modules[dtype_id]);
+    } else {
+        job->op->o_3buff_intrinsic.fns[dtype_id](job->source1 + shift, job->source2 + shift,
+                                                 job->target + shift, &count, &dtype,
+                                                 job->op->o_3buff_intrinsic.modules[dtype_id]);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+int ompi_op_base_reduce_pool_run(struct ompi_op_t *op, const void *source1,
+                                 const void *source2, void *target, size_t count,
+                                 struct ompi_datatype_t *dtype)
+{
+    const size_t page_size = (size_t) opal_getpagesize();
+    ompi_op_base_reduce_job_t job;
+    ptrdiff_t lb, extent;
+    size_t num_chunks;
+    int num_threads;
+
+    num_threads = opal_chunk_pool_acquire(&ompi_op_base_reduce_pool, ompi_op_base_reduce_threads,
+                                          ompi_op_base_framework.framework_output);
+    if (0 == num_threads) {
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+
+    /* two chunks per thread gives some room for load balancing; a chunk is
+     * passed to the op functions as an int */
+    job.head = 0;
+    job.chunk_count = count / (2 * (num_threads + 1));
+    if (0 == page_size % (size_t) extent) {
+        size_t page_count = page_size / (size_t) extent;
+        size_t to_page = (page_size - (uintptr_t) target % page_size) % page_size;
+
+        job.chunk_count = opal_max(page_count,
+                                   (job.chunk_count + page_count - 1) / page_count * page_count);
+        if (0 == to_page % (size_t) extent) {
+            job.head = opal_min(to_page / (size_t) extent, count);
+        }
+    }
+    job.chunk_count = opal_max(1, opal_min(job.chunk_count, (size_t) INT_MAX - job.head));
+    num_chunks = (count > job.head) ? (count - job.head + job.chunk_count - 1) / job.chunk_count
+                                    : 1;
+
+    job.op = op;
+    job.dtype = dtype;
+    job.dtype_id = ompi_op_ddt_map[dtype->id];
+    job.source1 = (const char *) source1;
+    job.source2 = (const char *) source2;
+    job.target = (char *) target;
+    job.extent = extent;
+    job.count = count;
+
+    return opal_chunk_pool_run(&ompi_op_base_reduce_pool, ompi_op_base_reduce_pool_chunk, &job,
+                               num_chunks);
+}
+
+void ompi_op_base_reduce_pool_fini(void)
+{
+    opal_chunk_pool_fini(&ompi_op_base_reduce_pool);
+}
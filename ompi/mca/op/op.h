@@ -134,6 +134,8 @@ enum {
 
     /** Floating point: short float */
     OMPI_OP_BASE_TYPE_SHORT_FLOAT,
+    /** Floating point: bfloat16 (MPIX_BFLOAT16) */
+    OMPI_OP_BASE_TYPE_BFLOAT16,
     /** Floating point: float */
     OMPI_OP_BASE_TYPE_FLOAT,
     /** Floating point: double */
@@ -203,6 +205,31 @@ enum {
     OMPI_OP_BASE_TYPE_MAX
 };
 
+/**
+ * bfloat16 is the upper half of an IEEE float, and has no C type: the
+ * operations on MPIX_BFLOAT16 are computed in float, using these
+ * conversions.
+ */
+static inline float ompi_op_bfloat16_to_float(uint16_t v)
+{
+    union { uint32_t u; float f; } c = { .u = ((uint32_t) v) << 16 };
+    return c.f;
+}
+
+/**
+ * Round to nearest even, keeping NaN quiet (a NaN with only the low
+ * bits of its mantissa set would otherwise turn into an infinity).
+ */
+static inline uint16_t ompi_op_float_to_bfloat16(float f)
+{
+    union { uint32_t u; float f; } c = { .f = f };
+    if ((c.u & 0x7fffffffU) > 0x7f800000U) {
+        return (uint16_t) ((c.u >> 16) | 0x0040U);
+    }
+    c.u += 0x7fffU + ((c.u >> 16) & 1U);
+    return (uint16_t) (c.u >> 16);
+}
+
 
 /**
  * Fortran handles; must be [manually set to be] equivalent to the
@@ -277,6 +304,30 @@ typedef void (*ompi_op_base_3buff_handler_fn_1_0_0_t)(const void *,
 
 typedef ompi_op_base_3buff_handler_fn_1_0_0_t ompi_op_base_3buff_handler_fn_t;
 
+/*
+ * Typedef for fused reduce-and-copy op functions: the first buffer is
+ * reduced into the second one, as with the 2-buffer functions, and the
+ * result is also written to the third buffer.
+ */
+typedef void (*ompi_op_base_copy_handler_fn_1_0_0_t)(const void *,
+                                                     void *, void *, int *,
+                                                     struct ompi_datatype_t **,
+                                                     struct ompi_op_base_module_1_0_0_t *);
+
+typedef ompi_op_base_copy_handler_fn_1_0_0_t ompi_op_base_copy_handler_fn_t;
+
+/*
+ * Typedef for N-ary op functions: the given number (at least 2) of
+ * input buffers are reduced into the output buffer, which must not be
+ * one of them.
+ */
+typedef void (*ompi_op_base_nary_handler_fn_1_0_0_t)(const void *const *, int,
+                                                     void *, int *,
+                                                     struct ompi_datatype_t **,
+                                                     struct ompi_op_base_module_1_0_0_t *);
+
+typedef ompi_op_base_nary_handler_fn_1_0_0_t ompi_op_base_nary_handler_fn_t;
+
 /**
  * Op component initialization
  *
@@ -380,6 +431,10 @@ typedef struct ompi_op_base_module_1_0_0_t {
         with the MPI_Op that this module is used with */
     ompi_op_base_handler_fn_1_0_0_t opm_fns[OMPI_OP_BASE_TYPE_MAX];
     ompi_op_base_3buff_handler_fn_1_0_0_t opm_3buff_fns[OMPI_OP_BASE_TYPE_MAX];
+    /** Optional fused variants; the NULL ones are emulated with the
+        functions above */
+    ompi_op_base_copy_handler_fn_1_0_0_t opm_copy_fns[OMPI_OP_BASE_TYPE_MAX];
+    ompi_op_base_nary_handler_fn_1_0_0_t opm_nary_fns[OMPI_OP_BASE_TYPE_MAX];
 } ompi_op_base_module_1_0_0_t;
 
 /**
@@ -416,6 +471,23 @@ typedef struct ompi_op_base_op_3buff_fns_1_0_0_t {
 
 typedef ompi_op_base_op_3buff_fns_1_0_0_t ompi_op_base_op_3buff_fns_t;
 
+/**
+ * Same as above, for the fused reduce-and-copy and N-ary functions
+ */
+typedef struct ompi_op_base_op_copy_fns_1_0_0_t {
+    ompi_op_base_copy_handler_fn_1_0_0_t fns[OMPI_OP_BASE_TYPE_MAX];
+    ompi_op_base_module_t *modules[OMPI_OP_BASE_TYPE_MAX];
+} ompi_op_base_op_copy_fns_1_0_0_t;
+
+typedef ompi_op_base_op_copy_fns_1_0_0_t ompi_op_base_op_copy_fns_t;
+
+typedef struct ompi_op_base_op_nary_fns_1_0_0_t {
+    ompi_op_base_nary_handler_fn_1_0_0_t fns[OMPI_OP_BASE_TYPE_MAX];
+    ompi_op_base_module_t *modules[OMPI_OP_BASE_TYPE_MAX];
+} ompi_op_base_op_nary_fns_1_0_0_t;
+
+typedef ompi_op_base_op_nary_fns_1_0_0_t ompi_op_base_op_nary_fns_t;
+
 /*
  * Macro for use in modules that are of type op v2.0.0
  */
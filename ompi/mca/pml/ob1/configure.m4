@@ -22,9 +22,11 @@ AC_DEFUN([MCA_ompi_pml_ob1_POST_CONFIG], [
 # ------------------------------------------------
 # We can always build, unless we were explicitly disabled.
 AC_DEFUN([MCA_ompi_pml_ob1_CONFIG],[
-    OPAL_VAR_SCOPE_PUSH([pml_ob1_matching_engine])
+    OPAL_VAR_SCOPE_PUSH([pml_ob1_matching_engine pml_ob1_avx512_support pml_ob1_cflags_save])
     AC_ARG_WITH([pml-ob1-matching], [AS_HELP_STRING([--with-pml-ob1-matching=type],
-                                                    [Configure pml/ob1 to use an alternate matching engine. Only valid on x86_64 systems.
+                                                    [Configure the default matching engine of pml/ob1. The engine can also be selected
+                                                     at runtime using the pml_ob1_matching_engine MCA parameter. The fuzzy and vector
+                                                     engines are only available on x86_64 systems.
                                                      Valid values are: none, default, arrays, fuzzy-byte, fuzzy-short, fuzzy-word, vector (default: none)])])
 
     pml_ob1_matching_engine=MCA_PML_OB1_CUSTOM_MATCHING_NONE
@@ -58,7 +60,45 @@ AC_DEFUN([MCA_ompi_pml_ob1_CONFIG],[
         esac
     fi
 
-    AC_DEFINE_UNQUOTED([MCA_PML_OB1_CUSTOM_MATCHING], [$pml_ob1_matching_engine], [Custom matching engine to use in pml/ob1])
+    AC_DEFINE_UNQUOTED([MCA_PML_OB1_CUSTOM_MATCHING], [$pml_ob1_matching_engine], [Default custom matching engine to use in pml/ob1])
+
+    # The fuzzy and vector matching engines are built with AVX-512 and are
+    # only selected at runtime if the processor supports it.
+    MCA_BUILD_PML_OB1_AVX512_FLAGS=""
+    pml_ob1_avx512_support=0
+    case "${host}" in
+        x86_64*|amd64*)
+            AC_LANG_PUSH([C])
+            AC_MSG_CHECKING([for AVX512 support for pml/ob1 matching engines])
+            pml_ob1_cflags_save="$CFLAGS"
+            CFLAGS="-mavx512f -mavx512bw $CFLAGS"
+            AC_LINK_IFELSE(
+                [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                 [[
+    __m512i vA = _mm512_set1_epi8(1), vB = _mm512_set1_epi16(2);
+    __mmask64 m = _mm512_cmpeq_epi8_mask(_mm512_and_epi32(vA, vB), vB);
+    if (!__builtin_cpu_supports("avx512bw")) return (int) m;
+                                 ]])],
+                [pml_ob1_avx512_support=1
+                 MCA_BUILD_PML_OB1_AVX512_FLAGS="-mavx512f -mavx512bw"
+                 AC_MSG_RESULT([yes])],
+                [AC_MSG_RESULT([no])])
+            CFLAGS="$pml_ob1_cflags_save"
+            AC_LANG_POP([C])
+            ;;
+    esac
+
+    AS_IF([test $pml_ob1_avx512_support -eq 0],
+          [AS_CASE([$pml_ob1_matching_engine],
+                   [MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_BYTE|MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT|MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD|MCA_PML_OB1_CUSTOM_MATCHING_VECTOR],
+                   [AC_MSG_ERROR([pml/ob1 matching engine $with_pml_ob1_matching requires AVX512 support])])])
+
+    AC_DEFINE_UNQUOTED([OMPI_PML_OB1_HAVE_AVX512_MATCHING], [$pml_ob1_avx512_support],
+                       [Whether the AVX512 matching engines of pml/ob1 are built])
+    AM_CONDITIONAL([MCA_BUILD_ompi_pml_ob1_has_avx512_support],
+                   [test "$pml_ob1_avx512_support" = "1"])
+    AC_SUBST(MCA_BUILD_PML_OB1_AVX512_FLAGS)
+    OPAL_VAR_SCOPE_POP
 
     AC_CONFIG_FILES([ompi/mca/pml/ob1/Makefile])
     [$1]
@@ -0,0 +1,78 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2018      Los Alamos National Security, LLC. All rights
+ *                         reserved.
+ * Copyright (c) 2018      Sandia National Laboratories.  All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "pml_ob1_custom_match.h"
+
+mca_base_var_enum_value_t mca_pml_ob1_match_engine_enum[] = {
+    {MCA_PML_OB1_CUSTOM_MATCHING_NONE, "none"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_LINKEDLIST, "linkedlist"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_ARRAYS, "arrays"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_BYTE, "fuzzy-byte"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT, "fuzzy-short"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD, "fuzzy-word"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_VECTOR, "vector"},
+    {0, NULL},
+};
+
+#if OMPI_PML_OB1_HAVE_AVX512_MATCHING
+/* the fuzzy and vector engines are compiled with AVX-512F/BW, make sure
+ * the processor we are running on can execute them. */
+static bool mca_pml_ob1_match_engine_have_avx512 (void)
+{
+    static int have_avx512 = -1;
+
+    if (-1 == have_avx512) {
+        __builtin_cpu_init ();
+        have_avx512 = __builtin_cpu_supports ("avx512f") && __builtin_cpu_supports ("avx512bw");
+    }
+
+    return (bool) have_avx512;
+}
+#endif
+
+const mca_pml_ob1_match_engine_t *mca_pml_ob1_match_engine_get (int type)
+{
+    switch (type) {
+    case MCA_PML_OB1_CUSTOM_MATCHING_LINKEDLIST:
+        return &mca_pml_ob1_match_engine_linkedlist;
+    case MCA_PML_OB1_CUSTOM_MATCHING_ARRAYS:
+        return &mca_pml_ob1_match_engine_arrays;
+#if OMPI_PML_OB1_HAVE_AVX512_MATCHING
+    case MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_BYTE:
+        return mca_pml_ob1_match_engine_have_avx512 () ? &mca_pml_ob1_match_engine_fuzzy_byte : NULL;
+    case MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT:
+        return mca_pml_ob1_match_engine_have_avx512 () ? &mca_pml_ob1_match_engine_fuzzy_short : NULL;
+    case MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD:
+        return mca_pml_ob1_match_engine_have_avx512 () ? &mca_pml_ob1_match_engine_fuzzy_word : NULL;
+    case MCA_PML_OB1_CUSTOM_MATCHING_VECTOR:
+        return mca_pml_ob1_match_engine_have_avx512 () ? &mca_pml_ob1_match_engine_vectors : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+int mca_pml_ob1_match_engine_from_name (const char *name)
+{
+    for (int i = 0 ; NULL != mca_pml_ob1_match_engine_enum[i].string ; ++i) {
+        if (0 == strcasecmp (name, mca_pml_ob1_match_engine_enum[i].string)) {
+            return mca_pml_ob1_match_engine_enum[i].value;
+        }
+    }
+
+    return -1;
+}
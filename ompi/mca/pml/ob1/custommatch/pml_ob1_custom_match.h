@@ -15,10 +15,13 @@
 #define PML_OB1_CUSTOM_MATCH_H
 
 #include "ompi_config.h"
+#include "opal/mca/base/mca_base_var_enum.h"
 #include "ompi/mca/pml/ob1/pml_ob1.h"
 
-#define CUSTOM_MATCH_DEBUG         1
-#define CUSTOM_MATCH_DEBUG_VERBOSE 1
+#define CUSTOM_MATCH_DEBUG         0
+#define CUSTOM_MATCH_DEBUG_VERBOSE 0
+
+BEGIN_C_DECLS
 
 /**
  * Custom match types
@@ -30,29 +33,63 @@
 #define MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT 4
 #define MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD  5
 #define MCA_PML_OB1_CUSTOM_MATCHING_VECTOR      6
+#define MCA_PML_OB1_CUSTOM_MATCHING_MAX         7
 
-#if MCA_PML_OB1_CUSTOM_MATCHING != MCA_PML_OB1_CUSTOM_MATCHING_NONE
-
-#define MCA_PML_OB1_CUSTOM_MATCH 1
-
-#if MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_LINKEDLIST
-#include "pml_ob1_custom_match_linkedlist.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_ARRAYS
-#include "pml_ob1_custom_match_arrays.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_BYTE
-#include "pml_ob1_custom_match_fuzzy512-byte.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT
-#include "pml_ob1_custom_match_fuzzy512-short.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD
-#include "pml_ob1_custom_match_fuzzy512-word.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_VECTOR
-#include "pml_ob1_custom_match_vectors.h"
-#endif
+/**
+ * Function table of an alternate matching engine.
+ *
+ * Every engine keeps a single posted receive queue (prq) and a single
+ * unexpected message queue (umq) per communicator. The queue and node
+ * types are private to the engine, so they are only seen as opaque
+ * pointers here. All functions are called with the communicator
+ * matching lock held.
+ */
+typedef struct mca_pml_ob1_match_engine_t {
+    /** engine name, as used by the MCA parameter and the info key */
+    const char *name;
 
-#else
+    void *(*prq_init) (void);
+    void (*prq_destroy) (void *prq);
+    void (*prq_append) (void *prq, void *payload, int tag, int source);
+    int (*prq_cancel) (void *prq, void *req);
+    void *(*prq_find_dequeue_verify) (void *prq, int tag, int peer);
+    int (*prq_size) (void *prq);
+    void (*prq_dump) (void *prq);
 
-#define MCA_PML_OB1_CUSTOM_MATCH 0
+    void *(*umq_init) (void);
+    void (*umq_destroy) (void *umq);
+    void (*umq_append) (void *umq, int tag, int source, void *payload);
+    void *(*umq_find_verify_hold) (void *umq, int tag, int peer, void **hold_prev,
+                                   void **hold_elem, int *hold_index);
+    void (*umq_remove_hold) (void *umq, void *hold_prev, void *hold_elem, int hold_index);
+    int (*umq_size) (void *umq);
+    void (*umq_dump) (void *umq);
+} mca_pml_ob1_match_engine_t;
 
+extern const mca_pml_ob1_match_engine_t mca_pml_ob1_match_engine_linkedlist;
+extern const mca_pml_ob1_match_engine_t mca_pml_ob1_match_engine_arrays;
+#if OMPI_PML_OB1_HAVE_AVX512_MATCHING
+extern const mca_pml_ob1_match_engine_t mca_pml_ob1_match_engine_fuzzy_byte;
+extern const mca_pml_ob1_match_engine_t mca_pml_ob1_match_engine_fuzzy_short;
+extern const mca_pml_ob1_match_engine_t mca_pml_ob1_match_engine_fuzzy_word;
+extern const mca_pml_ob1_match_engine_t mca_pml_ob1_match_engine_vectors;
 #endif
 
+/** MCA enumerator for the pml_ob1_matching_engine parameter */
+extern mca_base_var_enum_value_t mca_pml_ob1_match_engine_enum[];
+
+/**
+ * Return the engine for a custom match type, or NULL if the type is
+ * MCA_PML_OB1_CUSTOM_MATCHING_NONE (use the ob1 per-peer queues) or if
+ * the engine was not built or cannot run on this processor.
+ */
+const mca_pml_ob1_match_engine_t *mca_pml_ob1_match_engine_get (int type);
+
+/**
+ * Find the engine type by name. Returns -1 if the name is unknown.
+ */
+int mca_pml_ob1_match_engine_from_name (const char *name);
+
+END_C_DECLS
+
 #endif
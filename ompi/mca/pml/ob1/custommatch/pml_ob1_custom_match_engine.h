@@ -0,0 +1,118 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2018      Los Alamos National Security, LLC. All rights
+ *                         reserved.
+ * Copyright (c) 2018      Sandia National Laboratories.  All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Instantiate the function table for the matching engine whose header was
+ * included right before this file. The engine headers all use the same
+ * custom_match_* names, so each of them lives in its own compilation unit.
+ *
+ * Before including this file define:
+ *   MCA_PML_OB1_MATCH_ENGINE_NAME  - name of the engine (string)
+ *   MCA_PML_OB1_MATCH_ENGINE       - symbol of the resulting function table
+ */
+
+#if !defined(MCA_PML_OB1_MATCH_ENGINE_NAME) || !defined(MCA_PML_OB1_MATCH_ENGINE)
+#    error "MCA_PML_OB1_MATCH_ENGINE_NAME and MCA_PML_OB1_MATCH_ENGINE must be defined"
+#endif
+
+static void *engine_prq_init (void)
+{
+    return (void *) custom_match_prq_init ();
+}
+
+static void engine_prq_destroy (void *prq)
+{
+    custom_match_prq_destroy ((custom_match_prq *) prq);
+}
+
+static void engine_prq_append (void *prq, void *payload, int tag, int source)
+{
+    custom_match_prq_append ((custom_match_prq *) prq, payload, tag, source);
+}
+
+static int engine_prq_cancel (void *prq, void *req)
+{
+    return custom_match_prq_cancel ((custom_match_prq *) prq, req);
+}
+
+static void *engine_prq_find_dequeue_verify (void *prq, int tag, int peer)
+{
+    return custom_match_prq_find_dequeue_verify ((custom_match_prq *) prq, tag, peer);
+}
+
+static int engine_prq_size (void *prq)
+{
+    return custom_match_prq_size ((custom_match_prq *) prq);
+}
+
+static void engine_prq_dump (void *prq)
+{
+    custom_match_prq_dump ((custom_match_prq *) prq);
+}
+
+static void *engine_umq_init (void)
+{
+    return (void *) custom_match_umq_init ();
+}
+
+static void engine_umq_destroy (void *umq)
+{
+    custom_match_umq_destroy ((custom_match_umq *) umq);
+}
+
+static void engine_umq_append (void *umq, int tag, int source, void *payload)
+{
+    custom_match_umq_append ((custom_match_umq *) umq, tag, source, payload);
+}
+
+static void *engine_umq_find_verify_hold (void *umq, int tag, int peer, void **hold_prev,
+                                          void **hold_elem, int *hold_index)
+{
+    return custom_match_umq_find_verify_hold ((custom_match_umq *) umq, tag, peer,
+                                              (custom_match_umq_node **) hold_prev,
+                                              (custom_match_umq_node **) hold_elem, hold_index);
+}
+
+static void engine_umq_remove_hold (void *umq, void *hold_prev, void *hold_elem, int hold_index)
+{
+    custom_match_umq_remove_hold ((custom_match_umq *) umq, (custom_match_umq_node *) hold_prev,
+                                  (custom_match_umq_node *) hold_elem, hold_index);
+}
+
+static int engine_umq_size (void *umq)
+{
+    return custom_match_umq_size ((custom_match_umq *) umq);
+}
+
+static void engine_umq_dump (void *umq)
+{
+    custom_match_umq_dump ((custom_match_umq *) umq);
+}
+
+const mca_pml_ob1_match_engine_t MCA_PML_OB1_MATCH_ENGINE = {
+    .name = MCA_PML_OB1_MATCH_ENGINE_NAME,
+    .prq_init = engine_prq_init,
+    .prq_destroy = engine_prq_destroy,
+    .prq_append = engine_prq_append,
+    .prq_cancel = engine_prq_cancel,
+    .prq_find_dequeue_verify = engine_prq_find_dequeue_verify,
+    .prq_size = engine_prq_size,
+    .prq_dump = engine_prq_dump,
+    .umq_init = engine_umq_init,
+    .umq_destroy = engine_umq_destroy,
+    .umq_append = engine_umq_append,
+    .umq_find_verify_hold = engine_umq_find_verify_hold,
+    .umq_remove_hold = engine_umq_remove_hold,
+    .umq_size = engine_umq_size,
+    .umq_dump = engine_umq_dump,
+};
@@ -302,7 +302,7 @@ static inline void custom_match_print(custom_match_prq* list)
         printf("This is the %d linked list element\n", ++i);
         for(j = 0; j < 32; j++)
         {
-            printf("%d:%d The key is %d, the mask is %d, the value is %ld\n", i, j, ((short*)(&(elem->keys)))[j], ((short*)(&(elem->mask)))[j], elem->value[j]);
+            printf("%d:%d The key is %d, the mask is %d, the value is %p\n", i, j, ((short*)(&(elem->keys)))[j], ((short*)(&(elem->mask)))[j], elem->value[j]);
         }
         i++;
     }
@@ -310,7 +310,6 @@ static inline void custom_match_print(custom_match_prq* list)
 
 static inline void custom_match_prq_dump(custom_match_prq* list)
 {
-    opal_list_item_t* item;
     char cpeer[64], ctag[64];
 
     custom_match_prq_node* elem;
@@ -566,7 +565,7 @@ static inline void custom_match_umq_dump(custom_match_umq* list)
             if(elem->value[j])
             {
                 mca_pml_ob1_recv_frag_t *req = (mca_pml_ob1_recv_frag_t *)elem->value[j];
-                printf("%x %x %x\n", elem->value[j], req->hdr.hdr_match.hdr_tag, req->hdr.hdr_match.hdr_src);
+                printf("%p %x %x\n", elem->value[j], req->hdr.hdr_match.hdr_tag, req->hdr.hdr_match.hdr_src);
                 if( OMPI_ANY_SOURCE == req->hdr.hdr_match.hdr_src ) snprintf(cpeer, 64, "%s", "ANY_SOURCE");
                 else snprintf(cpeer, 64, "%d", req->hdr.hdr_match.hdr_src);
                 if( OMPI_ANY_TAG == req->hdr.hdr_match.hdr_tag ) snprintf(ctag, 64, "%s", "ANY_TAG");
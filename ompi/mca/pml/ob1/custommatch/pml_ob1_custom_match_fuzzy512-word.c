@@ -0,0 +1,21 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2018      Los Alamos National Security, LLC. All rights
+ *                         reserved.
+ * Copyright (c) 2018      Sandia National Laboratories.  All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "ompi/mca/pml/ob1/pml_ob1_comm.h"
+#include "pml_ob1_custom_match_fuzzy512-word.h"
+
+#define MCA_PML_OB1_MATCH_ENGINE_NAME "fuzzy-word"
+#define MCA_PML_OB1_MATCH_ENGINE      mca_pml_ob1_match_engine_fuzzy_word
+#include "pml_ob1_custom_match_engine.h"
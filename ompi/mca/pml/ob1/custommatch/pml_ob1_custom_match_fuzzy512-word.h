@@ -11,8 +11,8 @@
  * $HEADER$
  */
 
-#ifndef PML_OB1_CUSTOM_MATCH_FUZZY512_SHORT_H
-#define PML_OB1_CUSTOM_MATCH_FUZZY512_SHORT_H
+#ifndef PML_OB1_CUSTOM_MATCH_FUZZY512_WORD_H
+#define PML_OB1_CUSTOM_MATCH_FUZZY512_WORD_H
 
 #include <immintrin.h>
 
@@ -265,14 +265,13 @@ static inline void custom_match_print(custom_match_prq* list)
     for(elem = list->head; elem; elem = elem->next)
     {
         printf("This is the %d linked list element\n", ++i);
-        printf("%d The key is %d, the mask is %d, the value is %ld\n", i, elem->tag, elem->tmask, elem->value);
+        printf("%d The key is %d, the mask is %d, the value is %p\n", i, elem->tag, elem->tmask, elem->value);
         i++;
     }
 }
 
 static inline void custom_match_prq_dump(custom_match_prq* list)
 {
-    opal_list_item_t* item;
     char cpeer[64], ctag[64];
 
     custom_match_prq_node* elem;
@@ -504,7 +503,7 @@ static inline void custom_match_umq_dump(custom_match_umq* list)
         if(elem->value)
         {
             mca_pml_ob1_recv_frag_t *req = (mca_pml_ob1_recv_frag_t *)elem->value;
-            printf("%x %x %x\n", elem->value, req->hdr.hdr_match.hdr_tag, req->hdr.hdr_match.hdr_src);
+            printf("%p %x %x\n", elem->value, req->hdr.hdr_match.hdr_tag, req->hdr.hdr_match.hdr_src);
             if( OMPI_ANY_SOURCE == req->hdr.hdr_match.hdr_src ) snprintf(cpeer, 64, "%s", "ANY_SOURCE");
             else snprintf(cpeer, 64, "%d", req->hdr.hdr_match.hdr_src);
             if( OMPI_ANY_TAG == req->hdr.hdr_match.hdr_tag ) snprintf(ctag, 64, "%s", "ANY_TAG");
@@ -263,6 +263,10 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
     ompi_comm_assert_subscribe (comm, OMPI_COMM_ASSERT_NO_ANY_SOURCE);
 
     mca_pml_ob1_comm_init_size(pml_comm, comm->c_remote_group->grp_proc_count);
+    if (OMPI_SUCCESS != mca_pml_ob1_comm_select_match_engine(pml_comm, comm)) {
+        OBJ_RELEASE(pml_comm);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
     comm->c_pml_comm = pml_comm;
 
     /* Register the subscriber alert for the mpi_assert_allow_overtaking info. */
@@ -317,11 +321,11 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
         pml_proc = mca_pml_ob1_peer_lookup(comm, hdr->hdr_src);
 
         if (OMPI_COMM_CHECK_ASSERT_ALLOW_OVERTAKE(comm)) {
-#if !MCA_PML_OB1_CUSTOM_MATCH
-            opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
-#else
-            custom_match_umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
-#endif
+            if (MCA_PML_OB1_COMM_CUSTOM_MATCH(pml_comm)) {
+                pml_comm->match_engine->umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
+            } else {
+                opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
+            }
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
                                    hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
             continue;
@@ -332,11 +336,11 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
         add_fragment_to_unexpected:
             /* We're now expecting the next sequence number. */
             pml_proc->expected_sequence++;
-#if !MCA_PML_OB1_CUSTOM_MATCH
-            opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
-#else
-            custom_match_umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
-#endif
+            if (MCA_PML_OB1_COMM_CUSTOM_MATCH(pml_comm)) {
+                pml_comm->match_engine->umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
+            } else {
+                opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
+            }
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
                                    hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
             /* And now the ugly part. As some fragments can be inserted in the cant_match list,
@@ -609,7 +613,6 @@ static void mca_pml_ob1_dump_hdr(mca_pml_ob1_hdr_t* hdr)
                 header);
 }
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
 static void mca_pml_ob1_dump_frag_list(opal_list_t* queue, bool is_req)
 {
     opal_list_item_t* item;
@@ -642,7 +645,6 @@ static void mca_pml_ob1_dump_frag_list(opal_list_t* queue, bool is_req)
         }
     }
 }
-#endif
 
 void mca_pml_ob1_dump_cant_match(mca_pml_ob1_recv_frag_t* queue)
 {
@@ -672,19 +674,15 @@ int mca_pml_ob1_dump(struct ompi_communicator_t* comm, int verbose)
                 comm->c_name, (void*) comm, ompi_comm_print_cid (comm), comm->c_my_rank,
                 pml_comm->recv_sequence, pml_comm->num_procs, pml_comm->last_probed);
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
-    if( opal_list_get_size(&pml_comm->wild_receives) ) {
+    if (MCA_PML_OB1_COMM_CUSTOM_MATCH(pml_comm)) {
+        opal_output(0, "expected receives (%s matching)\n", pml_comm->match_engine->name);
+        pml_comm->match_engine->prq_dump(pml_comm->prq);
+        opal_output(0, "unexpected frag\n");
+        pml_comm->match_engine->umq_dump(pml_comm->umq);
+    } else if( opal_list_get_size(&pml_comm->wild_receives) ) {
         opal_output(0, "expected MPI_ANY_SOURCE fragments\n");
         mca_pml_ob1_dump_frag_list(&pml_comm->wild_receives, true);
     }
-#endif
-
-#if MCA_PML_OB1_CUSTOM_MATCH
-     opal_output(0, "expected receives\n");
-     custom_match_prq_dump(pml_comm->prq);
-     opal_output(0, "unexpected frag\n");
-     custom_match_umq_dump(pml_comm->umq);
-#endif
 
     /* iterate through all procs on communicator */
     for( i = 0; i < (int)pml_comm->num_procs; i++ ) {
@@ -702,22 +700,18 @@ int mca_pml_ob1_dump(struct ompi_communicator_t* comm, int verbose)
                     proc->send_sequence);
 
         /* dump all receive queues */
-#if !MCA_PML_OB1_CUSTOM_MATCH
        if( opal_list_get_size(&proc->specific_receives) ) {
             opal_output(0, "expected specific receives\n");
             mca_pml_ob1_dump_frag_list(&proc->specific_receives, true);
         }
-#endif
         if( NULL != proc->frags_cant_match ) {
             opal_output(0, "out of sequence\n");
             mca_pml_ob1_dump_cant_match(proc->frags_cant_match);
         }
-#if !MCA_PML_OB1_CUSTOM_MATCH
         if( opal_list_get_size(&proc->unexpected_frags) ) {
             opal_output(0, "unexpected frag\n");
             mca_pml_ob1_dump_frag_list(&proc->unexpected_frags, false);
         }
-#endif
         /* dump all btls used for eager messages */
         for( n = 0; n < ep->btl_eager.arr_size; n++ ) {
             mca_bml_base_btl_t* bml_btl = &ep->btl_eager.bml_btls[n];
@@ -43,6 +43,7 @@
 #include "ompi/mca/bml/base/base.h"
 #include "ompi/proc/proc.h"
 #include "opal/mca/allocator/base/base.h"
+#include "opal/mca/base/mca_base_event.h"
 #include "ompi/runtime/mpiruntime.h"
 
 BEGIN_C_DECLS
@@ -86,6 +87,7 @@ struct mca_pml_ob1_t {
     char* allocator_name;
     mca_allocator_base_module_t* allocator;
     unsigned int unexpected_limit;
+    int matching_engine;    /* default matching engine (see custommatch/pml_ob1_custom_match.h) */
     /* Accelerator support initialized */
     bool accelerator_enabled;
 };
@@ -96,6 +98,44 @@ extern int mca_pml_ob1_output;
 extern bool mca_pml_ob1_matching_protection;
 extern int mca_pml_ob1_accelerator_events_max;
 
+/*
+ * MPI_T events. All of them are bound to the communicator and carry a
+ * mca_pml_ob1_event_t.
+ */
+enum {
+    /** a message arrived before a matching receive was posted */
+    MCA_PML_OB1_EVENT_UNEXPECTED,
+    /** a message was matched to a receive */
+    MCA_PML_OB1_EVENT_MATCHED,
+    /** a rendezvous (RNDV or RGET) message was matched */
+    MCA_PML_OB1_EVENT_RNDV_START,
+    /** all data of a rendezvous message was received */
+    MCA_PML_OB1_EVENT_RNDV_FINISH,
+    MCA_PML_OB1_EVENT_MAX
+};
+
+struct mca_pml_ob1_event_t {
+    /** rank of the sender in the communicator */
+    int32_t peer;
+    int32_t tag;
+    /** message size */
+    uint64_t bytes;
+};
+typedef struct mca_pml_ob1_event_t mca_pml_ob1_event_t;
+
+extern mca_base_event_t *mca_pml_ob1_events[MCA_PML_OB1_EVENT_MAX];
+
+static inline void mca_pml_ob1_event_raise(int index, ompi_communicator_t *comm, int peer, int tag,
+                                           size_t bytes)
+{
+    mca_base_event_t *event = mca_pml_ob1_events[index];
+
+    if (OPAL_UNLIKELY(event->active)) {
+        mca_pml_ob1_event_t data = {.peer = peer, .tag = tag, .bytes = bytes};
+        mca_base_event_record(event, comm, &data);
+    }
+}
+
 /*
  * PML interface functions.
  */
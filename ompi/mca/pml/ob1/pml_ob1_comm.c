@@ -39,20 +39,16 @@ static void mca_pml_ob1_comm_proc_construct(mca_pml_ob1_comm_proc_t* proc)
     proc->frags_cant_match = NULL;
     /* don't know the index of this communicator yet */
     proc->comm_index = -1;
-#if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_CONSTRUCT(&proc->specific_receives, opal_list_t);
     OBJ_CONSTRUCT(&proc->unexpected_frags, opal_list_t);
-#endif
 }
 
 
 static void mca_pml_ob1_comm_proc_destruct(mca_pml_ob1_comm_proc_t* proc)
 {
     assert(NULL == proc->frags_cant_match);
-#if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_DESTRUCT(&proc->specific_receives);
     OBJ_DESTRUCT(&proc->unexpected_frags);
-#endif
     if (proc->ompi_proc) {
         OBJ_RELEASE(proc->ompi_proc);
     }
@@ -66,12 +62,10 @@ OBJ_CLASS_INSTANCE(mca_pml_ob1_comm_proc_t, opal_object_t,
 
 static void mca_pml_ob1_comm_construct(mca_pml_ob1_comm_t* comm)
 {
-#if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_CONSTRUCT(&comm->wild_receives, opal_list_t);
-#else
-    comm->prq = custom_match_prq_init();
-    comm->umq = custom_match_umq_init();
-#endif
+    comm->match_engine = NULL;
+    comm->prq = NULL;
+    comm->umq = NULL;
     OBJ_CONSTRUCT(&comm->matching_lock, opal_mutex_t);
     OBJ_CONSTRUCT(&comm->proc_lock, opal_mutex_t);
     comm->recv_sequence = 0;
@@ -93,12 +87,11 @@ static void mca_pml_ob1_comm_destruct(mca_pml_ob1_comm_t* comm)
         free ((void *) comm->procs);
     }
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_DESTRUCT(&comm->wild_receives);
-#else
-    custom_match_prq_destroy(comm->prq);
-    custom_match_umq_destroy(comm->umq);
-#endif
+    if (NULL != comm->match_engine) {
+        comm->match_engine->prq_destroy(comm->prq);
+        comm->match_engine->umq_destroy(comm->umq);
+    }
     OBJ_DESTRUCT(&comm->matching_lock);
     OBJ_DESTRUCT(&comm->proc_lock);
 }
@@ -122,6 +115,57 @@ int mca_pml_ob1_comm_init_size (mca_pml_ob1_comm_t* comm, size_t size)
     return OMPI_SUCCESS;
 }
 
+int mca_pml_ob1_comm_select_match_engine (mca_pml_ob1_comm_t *pml_comm, ompi_communicator_t *comm)
+{
+    const mca_pml_ob1_match_engine_t *engine;
+    int type = mca_pml_ob1.matching_engine;
+    int flag;
+
+    if (NULL != comm->super.s_info) {
+        opal_cstring_t *info_str;
+        opal_info_get(comm->super.s_info, "ompi_comm_pml_ob1_matching_engine",
+                      &info_str, &flag);
+        if (flag) {
+            type = mca_pml_ob1_match_engine_from_name(info_str->string);
+            if (type < 0) {
+                opal_output_verbose(1, mca_pml_ob1_output,
+                                    "pml:ob1: unknown matching engine %s requested on communicator %s, "
+                                    "using the default", info_str->string, ompi_comm_print_cid(comm));
+                type = mca_pml_ob1.matching_engine;
+            }
+            OBJ_RELEASE(info_str);
+        }
+    }
+
+    engine = mca_pml_ob1_match_engine_get(type);
+    if (NULL == engine && MCA_PML_OB1_CUSTOM_MATCHING_NONE != type) {
+        opal_output_verbose(1, mca_pml_ob1_output,
+                            "pml:ob1: matching engine %s is not available on this system, "
+                            "using the default ob1 matching", mca_pml_ob1_match_engine_enum[type].string);
+    }
+
+    if (NULL != engine) {
+        pml_comm->prq = engine->prq_init();
+        pml_comm->umq = engine->umq_init();
+        if (NULL == pml_comm->prq || NULL == pml_comm->umq) {
+            if (NULL != pml_comm->prq) {
+                engine->prq_destroy(pml_comm->prq);
+            }
+            if (NULL != pml_comm->umq) {
+                engine->umq_destroy(pml_comm->umq);
+            }
+            pml_comm->prq = pml_comm->umq = NULL;
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+
+        opal_output_verbose(10, mca_pml_ob1_output, "pml:ob1: communicator %s uses the %s matching engine",
+                            ompi_comm_print_cid(comm), engine->name);
+    }
+
+    pml_comm->match_engine = engine;
+    return OMPI_SUCCESS;
+}
+
 mca_pml_ob1_comm_proc_t *mca_pml_ob1_peer_create (ompi_communicator_t *comm, mca_pml_ob1_comm_t *pml_comm, int rank)
 {
     mca_pml_ob1_comm_proc_t *proc = OBJ_NEW(mca_pml_ob1_comm_proc_t);
@@ -47,10 +47,8 @@ struct mca_pml_ob1_comm_proc_t {
     int16_t comm_index;           /**< index of this communicator on the receiver size (-1 - not set) */
     opal_atomic_int32_t send_sequence; /**< send side sequence number */
     struct mca_pml_ob1_recv_frag_t* frags_cant_match;  /**< out-of-order fragment queues */
-#if !MCA_PML_OB1_CUSTOM_MATCH
     opal_list_t specific_receives; /**< queues of unmatched specific receives */
     opal_list_t unexpected_frags;  /**< unexpected fragment queues */
-#endif
 };
 
 OBJ_CLASS_DECLARATION(mca_pml_ob1_comm_proc_t);
@@ -65,22 +63,25 @@ struct mca_pml_comm_t {
     opal_object_t super;
     volatile uint32_t recv_sequence;  /**< recv request sequence number - receiver side */
     opal_mutex_t matching_lock;   /**< matching lock */
-#if !MCA_PML_OB1_CUSTOM_MATCH
     opal_list_t wild_receives;    /**< queue of unmatched wild (source process not specified) receives */
-#endif
     opal_mutex_t proc_lock;
     mca_pml_ob1_comm_proc_t * volatile * procs;
     size_t num_procs;
     size_t last_probed;
-#if MCA_PML_OB1_CUSTOM_MATCH
-    custom_match_prq* prq;
-    custom_match_umq* umq;
-#endif
+    const mca_pml_ob1_match_engine_t *match_engine; /**< alternate matching engine (NULL if the
+                                                      *   per-peer queues above are used) */
+    void *prq;                    /**< posted receive queue of the matching engine */
+    void *umq;                    /**< unexpected message queue of the matching engine */
 };
 typedef struct mca_pml_comm_t mca_pml_ob1_comm_t;
 
 OBJ_CLASS_DECLARATION(mca_pml_ob1_comm_t);
 
+/**
+ * Check if a communicator uses an alternate matching engine
+ */
+#define MCA_PML_OB1_COMM_CUSTOM_MATCH(pml_comm) (NULL != (pml_comm)->match_engine)
+
 /**
  * @brief Helper function to allocate/fill in ob1 proc for a comm/rank
  */
@@ -117,6 +118,20 @@ static inline mca_pml_ob1_comm_proc_t *mca_pml_ob1_peer_lookup (struct ompi_comm
 
 extern int mca_pml_ob1_comm_init_size(mca_pml_ob1_comm_t* comm, size_t size);
 
+/**
+ * Select the matching engine of a communicator.
+ *
+ * The engine is selected using the ompi_comm_pml_ob1_matching_engine info key
+ * on the communicator if present, otherwise the pml_ob1_matching_engine MCA
+ * parameter. This must be called before any message is queued on the
+ * communicator.
+ *
+ * @param  pml_comm  Instance of mca_pml_ob1_comm_t
+ * @param  comm      Communicator the instance belongs to
+ * @return           OMPI_SUCCESS or error status on failure.
+ */
+extern int mca_pml_ob1_comm_select_match_engine(mca_pml_ob1_comm_t *pml_comm, ompi_communicator_t *comm);
+
 END_C_DECLS
 #endif
 
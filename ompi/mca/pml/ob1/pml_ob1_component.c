@@ -63,6 +63,9 @@ int mca_pml_ob1_output = 0;
 static int mca_pml_ob1_verbose = 0;
 bool mca_pml_ob1_matching_protection = false;
 int mca_pml_ob1_accelerator_events_max = 400;
+mca_base_event_t *mca_pml_ob1_events[MCA_PML_OB1_EVENT_MAX] = {
+    &mca_base_event_null, &mca_base_event_null, &mca_base_event_null, &mca_base_event_null,
+};
 
 mca_pml_base_component_2_1_0_t mca_pml_ob1_component = {
     /* First, the mca_base_component_t struct containing meta
@@ -143,6 +146,11 @@ static int mca_pml_ob1_comm_size_notify (mca_base_pvar_t *pvar, mca_base_pvar_ev
     return OMPI_SUCCESS;
 }
 
+/*
+ * The custom match engines keep a single set of queues per communicator,
+ * so the queue length cannot be split by peer: every connected peer then
+ * reports the length of the whole communicator queue.
+ */
 static int mca_pml_ob1_get_unex_msgq_size (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
 {
     ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
@@ -151,16 +159,13 @@ static int mca_pml_ob1_get_unex_msgq_size (const struct mca_base_pvar_t *pvar, v
     unsigned *values = (unsigned *) value;
     mca_pml_ob1_comm_proc_t *pml_proc;
     int i;
+    bool custom_match = MCA_PML_OB1_COMM_CUSTOM_MATCH(pml_comm);
+    unsigned total = custom_match ? pml_comm->match_engine->umq_size(pml_comm->umq) : 0;
 
     for (i = 0 ; i < comm_size ; ++i) {
         pml_proc = pml_comm->procs[i];
         if (pml_proc) {
-#if MCA_PML_OB1_CUSTOM_MATCH
-            values[i] = custom_match_umq_size(pml_comm->umq); // TODO: given the structure of custom match this does not make sense,
-                                                     //       as we only have one set of queues.
-#else
-            values[i] = opal_list_get_size (&pml_proc->unexpected_frags);
-#endif
+            values[i] = custom_match ? total : opal_list_get_size (&pml_proc->unexpected_frags);
         } else {
             values[i] = 0;
         }
@@ -169,6 +174,7 @@ static int mca_pml_ob1_get_unex_msgq_size (const struct mca_base_pvar_t *pvar, v
     return OMPI_SUCCESS;
 }
 
+/* same limitation as mca_pml_ob1_get_unex_msgq_size with custom match */
 static int mca_pml_ob1_get_posted_recvq_size (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
 {
     ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
@@ -177,17 +183,14 @@ static int mca_pml_ob1_get_posted_recvq_size (const struct mca_base_pvar_t *pvar
     unsigned *values = (unsigned *) value;
     mca_pml_ob1_comm_proc_t *pml_proc;
     int i;
+    bool custom_match = MCA_PML_OB1_COMM_CUSTOM_MATCH(pml_comm);
+    unsigned total = custom_match ? pml_comm->match_engine->prq_size(pml_comm->prq) : 0;
 
     for (i = 0 ; i < comm_size ; ++i) {
         pml_proc = pml_comm->procs[i];
 
         if (pml_proc) {
-#if MCA_PML_OB1_CUSTOM_MATCH
-            values[i] = custom_match_prq_size(pml_comm->prq); // TODO: given the structure of custom match this does not make sense,
-                                                     //       as we only have one set of queues.
-#else
-            values[i] = opal_list_get_size (&pml_proc->specific_receives);
-#endif
+            values[i] = custom_match ? total : opal_list_get_size (&pml_proc->specific_receives);
         } else {
             values[i] = 0;
         }
@@ -196,8 +199,74 @@ static int mca_pml_ob1_get_posted_recvq_size (const struct mca_base_pvar_t *pvar
     return OMPI_SUCCESS;
 }
 
+static int mca_pml_ob1_match_queue_depth_notify (mca_base_pvar_t *pvar, mca_base_pvar_event_t event, void *obj_handle, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        /* posted receive queue depth, unexpected message queue depth */
+        *count = 2;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_pml_ob1_get_match_queue_depth (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
+    mca_pml_ob1_comm_t *pml_comm = comm->c_pml_comm;
+    unsigned *values = (unsigned *) value;
+    mca_pml_ob1_comm_proc_t *pml_proc;
+
+    if (MCA_PML_OB1_COMM_CUSTOM_MATCH(pml_comm)) {
+        values[0] = pml_comm->match_engine->prq_size(pml_comm->prq);
+        values[1] = pml_comm->match_engine->umq_size(pml_comm->umq);
+        return OMPI_SUCCESS;
+    }
+
+    /* a message has to be matched against the wildcard and the per-peer queues */
+    values[0] = opal_list_get_size (&pml_comm->wild_receives);
+    values[1] = 0;
+    for (size_t i = 0 ; i < pml_comm->num_procs ; ++i) {
+        pml_proc = pml_comm->procs[i];
+        if (pml_proc) {
+            values[0] += opal_list_get_size (&pml_proc->specific_receives);
+            values[1] += opal_list_get_size (&pml_proc->unexpected_frags);
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static void mca_pml_ob1_register_events(void)
+{
+    static const mca_base_var_type_t types[] = {MCA_BASE_VAR_TYPE_INT32_T, MCA_BASE_VAR_TYPE_INT32_T,
+                                                MCA_BASE_VAR_TYPE_UINT64_T};
+    static const ptrdiff_t offsets[] = {offsetof(mca_pml_ob1_event_t, peer),
+                                        offsetof(mca_pml_ob1_event_t, tag),
+                                        offsetof(mca_pml_ob1_event_t, bytes)};
+    static const char *names[MCA_PML_OB1_EVENT_MAX][2] = {
+        [MCA_PML_OB1_EVENT_UNEXPECTED] = {"message_unexpected", "A message arrived before a matching "
+                                          "receive was posted. Elements: source, tag, size"},
+        [MCA_PML_OB1_EVENT_MATCHED] = {"message_matched", "A message was matched to a receive. "
+                                       "Elements: source, tag, size"},
+        [MCA_PML_OB1_EVENT_RNDV_START] = {"rndv_start", "A message using the rendezvous protocol "
+                                          "was matched. Elements: source, tag, size"},
+        [MCA_PML_OB1_EVENT_RNDV_FINISH] = {"rndv_finish", "All data of a message using the "
+                                           "rendezvous protocol was received. Elements: source, "
+                                           "tag, size"},
+    };
+
+    for (int i = 0 ; i < MCA_PML_OB1_EVENT_MAX ; ++i) {
+        (void) mca_base_component_event_register(&mca_pml_ob1_component.pmlm_version, names[i][0],
+                                                 names[i][1], OPAL_INFO_LVL_4, MPI_T_BIND_MPI_COMM,
+                                                 3, types, offsets, sizeof(mca_pml_ob1_event_t),
+                                                 mca_pml_ob1_events + i);
+    }
+}
+
 static int mca_pml_ob1_component_register(void)
 {
+    mca_base_var_enum_t *new_enum;
+
     mca_pml_ob1_param_register_int("verbose", 0, &mca_pml_ob1_verbose);
 
     mca_pml_ob1_param_register_int("free_list_num", 4, &mca_pml_ob1.free_list_num);
@@ -218,6 +287,17 @@ static int mca_pml_ob1_component_register(void)
 
     mca_pml_ob1_param_register_uint("unexpected_limit", 128, &mca_pml_ob1.unexpected_limit);
 
+    mca_pml_ob1.matching_engine = MCA_PML_OB1_CUSTOM_MATCHING;
+    (void) mca_base_var_enum_create("pml_ob1_matching_engines", mca_pml_ob1_match_engine_enum, &new_enum);
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "matching_engine",
+                                           "Default engine used to match incoming messages with posted receives. "
+                                           "\"none\" uses the ob1 per-peer queues. The engine can be overridden per "
+                                           "communicator with the \"ompi_comm_pml_ob1_matching_engine\" info key. The "
+                                           "fuzzy and vector engines require AVX-512 support",
+                                           MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &mca_pml_ob1.matching_engine);
+    OBJ_RELEASE(new_enum);
+
     mca_pml_ob1.use_all_rdma = false;
     (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "use_all_rdma",
                                            "Use all available RDMA btls for the RDMA and RDMA pipeline protocols "
@@ -231,24 +311,36 @@ static int mca_pml_ob1_component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.allocator_name);
     (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
                                            "unexpected_msgq_length", "Number of unexpected messages "
-                                           "received by each peer in a communicator", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                           "received by each peer in a communicator (the total of the "
+                                           "communicator for every peer with a custom match engine)", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
                                            MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, MPI_T_BIND_MPI_COMM,
                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
                                            mca_pml_ob1_get_unex_msgq_size, NULL, mca_pml_ob1_comm_size_notify, NULL);
 
     (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
                                            "posted_recvq_length", "Number of unmatched receives "
-                                           "posted for each peer in a communicator", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                           "posted for each peer in a communicator (the total of the "
+                                           "communicator for every peer with a custom match engine)", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
                                            MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, MPI_T_BIND_MPI_COMM,
                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
                                            mca_pml_ob1_get_posted_recvq_size, NULL, mca_pml_ob1_comm_size_notify, NULL);
 
+    (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
+                                           "match_queue_depth", "Total number of unmatched posted receives "
+                                           "and of unexpected messages queued in a communicator",
+                                           OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, MPI_T_BIND_MPI_COMM,
+                                           MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                           mca_pml_ob1_get_match_queue_depth, NULL, mca_pml_ob1_match_queue_depth_notify, NULL);
+
     mca_pml_ob1_accelerator_events_max = 400;
     (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "accelerator_events_max",
                                            "Number of events created by the ob1 component internally",
                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
                                            MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1_accelerator_events_max);
 
+    mca_pml_ob1_register_events();
+
     return OMPI_SUCCESS;
 }
 
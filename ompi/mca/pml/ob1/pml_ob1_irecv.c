@@ -233,6 +233,7 @@ mca_pml_ob1_imrecv( void *buf,
     recvreq->req_rdma_idx = 0;
     recvreq->req_pending = false;
     recvreq->req_ack_sent = false;
+    recvreq->req_rndv = false;
 
     MCA_PML_BASE_RECV_START(&recvreq->req_recv);
 
@@ -88,10 +88,8 @@ append_frag_to_list(opal_list_t *queue, mca_btl_base_module_t *btl,
     opal_list_append(queue, (opal_list_item_t*)frag);
 }
 
-#if MCA_PML_OB1_CUSTOM_MATCH
-
 static void
-append_frag_to_umq(custom_match_umq *queue, mca_btl_base_module_t *btl,
+append_frag_to_umq(mca_pml_ob1_comm_t *comm, mca_btl_base_module_t *btl,
                    const mca_pml_ob1_match_hdr_t *hdr, const mca_btl_base_segment_t *segments,
                    size_t num_segments, mca_pml_ob1_recv_frag_t* frag)
 {
@@ -99,11 +97,9 @@ append_frag_to_umq(custom_match_umq *queue, mca_btl_base_module_t *btl,
     MCA_PML_OB1_RECV_FRAG_ALLOC(frag);
     MCA_PML_OB1_RECV_FRAG_INIT(frag, hdr, segments, num_segments, btl);
   }
-  custom_match_umq_append(queue, hdr->hdr_tag, hdr->hdr_src, frag);
+  comm->match_engine->umq_append(comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
 }
 
-#endif
-
 
 /**
  * Append an unexpected descriptor to an ordered queue.
@@ -283,6 +279,20 @@ remove_head_from_ordered_list(mca_pml_ob1_recv_frag_t** queue)
     return frag;
 }
 
+/* size of the message described by a matching header */
+static size_t match_hdr_msg_length (const mca_pml_ob1_match_hdr_t *hdr,
+                                    const mca_btl_base_segment_t *segments, size_t num_segments)
+{
+    switch (hdr->hdr_common.hdr_type) {
+    case MCA_PML_OB1_HDR_TYPE_RNDV:
+    case MCA_PML_OB1_HDR_TYPE_RGET:
+        return ((const mca_pml_ob1_rendezvous_hdr_t *) hdr)->hdr_msg_length;
+    default:
+        return mca_pml_ob1_compute_segment_length_base (segments, num_segments,
+                                                        OMPI_PML_OB1_MATCH_HDR_LEN);
+    }
+}
+
 /**
  * Match incoming recv_frags against posted receives.
  * Supports out of order delivery.
@@ -565,7 +575,11 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
          */
         match->req_recv.req_bytes_packed = bytes_received + (num_segments-1);
 
-        MCA_PML_OB1_RECV_REQUEST_MATCHED(match, hdr);
+        /* only walk the segments when somebody listens to the matched event */
+        MCA_PML_OB1_RECV_REQUEST_MATCHED(match, hdr,
+                                         OPAL_UNLIKELY(mca_pml_ob1_events[MCA_PML_OB1_EVENT_MATCHED]->active)
+                                             ? match_hdr_msg_length(hdr, segments, num_segments)
+                                             : 0);
         if(match->req_bytes_expected > 0) {
             struct iovec iov[MCA_BTL_DES_MAX_SEGMENTS];
             uint32_t iov_count = 1;
@@ -864,7 +878,6 @@ static mca_pml_ob1_recv_request_t *match_incomming(const mca_pml_ob1_match_hdr_t
                                                    mca_pml_ob1_comm_t *comm,
                                                    mca_pml_ob1_comm_proc_t *proc)
 {
-#if !MCA_PML_OB1_CUSTOM_MATCH
     mca_pml_ob1_recv_request_t *specific_recv, *wild_recv;
     mca_pml_sequence_t wild_recv_seq, specific_recv_seq;
     int tag = hdr->hdr_tag;
@@ -907,12 +920,8 @@ static mca_pml_ob1_recv_request_t *match_incomming(const mca_pml_ob1_match_hdr_t
     }
 
     return NULL;
-#else
-    return custom_match_prq_find_dequeue_verify(comm->prq, hdr->hdr_tag, hdr->hdr_src);
-#endif
 }
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
 static mca_pml_ob1_recv_request_t *match_incomming_no_any_source (const mca_pml_ob1_match_hdr_t *hdr,
                                                                   mca_pml_ob1_comm_t *comm,
                                                                   mca_pml_ob1_comm_proc_t *proc)
@@ -933,7 +942,6 @@ static mca_pml_ob1_recv_request_t *match_incomming_no_any_source (const mca_pml_
 
     return NULL;
 }
-#endif
 
 static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
                                               const mca_pml_ob1_match_hdr_t *hdr,
@@ -951,15 +959,13 @@ static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
     mca_pml_ob1_comm_t *comm = (mca_pml_ob1_comm_t *)comm_ptr->c_pml_comm;
 
     do {
-#if MCA_PML_OB1_CUSTOM_MATCH
-        match = match_incomming(hdr, comm, proc);
-#else
-        if (!OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE (comm_ptr)) {
+        if (MCA_PML_OB1_COMM_CUSTOM_MATCH(comm)) {
+            match = comm->match_engine->prq_find_dequeue_verify(comm->prq, hdr->hdr_tag, hdr->hdr_src);
+        } else if (!OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE (comm_ptr)) {
             match = match_incomming(hdr, comm, proc);
         } else {
             match = match_incomming_no_any_source (hdr, comm, proc);
         }
-#endif
 
         /* if match found, process data */
         if(OPAL_LIKELY(NULL != match)) {
@@ -999,16 +1005,20 @@ static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
         }
 
         /* if no match found, place on unexpected queue */
-#if MCA_PML_OB1_CUSTOM_MATCH
-        append_frag_to_umq(comm->umq, btl, hdr, segments,
-                            num_segments, frag);
-#else
-        append_frag_to_list(&proc->unexpected_frags, btl, hdr, segments,
-                            num_segments, frag);
-#endif
+        if (MCA_PML_OB1_COMM_CUSTOM_MATCH(comm)) {
+            append_frag_to_umq(comm, btl, hdr, segments,
+                               num_segments, frag);
+        } else {
+            append_frag_to_list(&proc->unexpected_frags, btl, hdr, segments,
+                                num_segments, frag);
+        }
         SPC_RECORD(OMPI_SPC_UNEXPECTED, 1);
         SPC_RECORD(OMPI_SPC_UNEXPECTED_IN_QUEUE, 1);
         SPC_UPDATE_WATERMARK(OMPI_SPC_MAX_UNEXPECTED_IN_QUEUE, OMPI_SPC_UNEXPECTED_IN_QUEUE);
+        if (OPAL_UNLIKELY(mca_pml_ob1_events[MCA_PML_OB1_EVENT_UNEXPECTED]->active)) {
+            mca_pml_ob1_event_raise(MCA_PML_OB1_EVENT_UNEXPECTED, comm_ptr, hdr->hdr_src,
+                                    hdr->hdr_tag, match_hdr_msg_length(hdr, segments, num_segments));
+        }
         PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm_ptr,
                                hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
         SPC_TIMER_STOP(OMPI_SPC_MATCH_TIME, &timer);
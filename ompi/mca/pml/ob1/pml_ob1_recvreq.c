@@ -108,16 +108,14 @@ static int mca_pml_ob1_recv_request_cancel(struct ompi_request_t* ompi_request,
     }
     if( !request->req_match_received ) { /* the match has not been already done */
         assert( OMPI_ANY_TAG == ompi_request->req_status.MPI_TAG ); /* not matched isn't it */
-#if MCA_PML_OB1_CUSTOM_MATCH
-        custom_match_prq_cancel(ob1_comm->prq, request);
-#else
-        if( request->req_recv.req_base.req_peer == OMPI_ANY_SOURCE ) {
+        if (MCA_PML_OB1_COMM_CUSTOM_MATCH(ob1_comm)) {
+            ob1_comm->match_engine->prq_cancel(ob1_comm->prq, request);
+        } else if( request->req_recv.req_base.req_peer == OMPI_ANY_SOURCE ) {
             opal_list_remove_item( &ob1_comm->wild_receives, (opal_list_item_t*)request );
         } else {
             mca_pml_ob1_comm_proc_t* proc = mca_pml_ob1_peer_lookup (comm, request->req_recv.req_base.req_peer);
             opal_list_remove_item(&proc->specific_receives, (opal_list_item_t*)request);
         }
-#endif
         PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_REMOVE_FROM_POSTED_Q,
                                 &(request->req_recv.req_base), PERUSE_RECV );
         OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
@@ -704,7 +702,12 @@ void mca_pml_ob1_recv_request_progress_rget( mca_pml_ob1_recv_request_t* recvreq
     recvreq->req_send_offset = 0;
     recvreq->req_rdma_offset = 0;
 
-    MCA_PML_OB1_RECV_REQUEST_MATCHED(recvreq, &hdr->hdr_rndv.hdr_match);
+    MCA_PML_OB1_RECV_REQUEST_MATCHED(recvreq, &hdr->hdr_rndv.hdr_match,
+                                     hdr->hdr_rndv.hdr_msg_length);
+    recvreq->req_rndv = true;
+    mca_pml_ob1_event_raise(MCA_PML_OB1_EVENT_RNDV_START, recvreq->req_recv.req_base.req_comm,
+                            hdr->hdr_rndv.hdr_match.hdr_src, hdr->hdr_rndv.hdr_match.hdr_tag,
+                            hdr->hdr_rndv.hdr_msg_length);
 
     /* if receive buffer is not contiguous we can't just RDMA read into it, so
      * fall back to copy in/out protocol. It is a pity because buffer on the
@@ -853,7 +856,11 @@ void mca_pml_ob1_recv_request_progress_rndv( mca_pml_ob1_recv_request_t* recvreq
     recvreq->req_recv.req_bytes_packed = hdr->hdr_rndv.hdr_msg_length;
     recvreq->remote_req_send = hdr->hdr_rndv.hdr_src_req;
     recvreq->req_rdma_offset = bytes_received;
-    MCA_PML_OB1_RECV_REQUEST_MATCHED(recvreq, &hdr->hdr_match);
+    MCA_PML_OB1_RECV_REQUEST_MATCHED(recvreq, &hdr->hdr_match, hdr->hdr_rndv.hdr_msg_length);
+    recvreq->req_rndv = true;
+    mca_pml_ob1_event_raise(MCA_PML_OB1_EVENT_RNDV_START, recvreq->req_recv.req_base.req_comm,
+                            hdr->hdr_match.hdr_src, hdr->hdr_match.hdr_tag,
+                            hdr->hdr_rndv.hdr_msg_length);
     mca_pml_ob1_recv_request_ack(recvreq, btl, &hdr->hdr_rndv, bytes_received);
     /**
      * The PUT protocol do not attach any data to the original request.
@@ -919,7 +926,7 @@ void mca_pml_ob1_recv_request_progress_match( mca_pml_ob1_recv_request_t* recvre
 
     recvreq->req_recv.req_bytes_packed = bytes_received;
 
-    MCA_PML_OB1_RECV_REQUEST_MATCHED(recvreq, &hdr->hdr_match);
+    MCA_PML_OB1_RECV_REQUEST_MATCHED(recvreq, &hdr->hdr_match, bytes_received);
     /*
      *  Make user buffer accessible(defined) before unpacking.
      */
@@ -1134,24 +1141,14 @@ static inline void append_recv_req_to_queue(opal_list_t *queue,
  *  function has to be called with the communicator matching lock held.
 */
 
-#if MCA_PML_OB1_CUSTOM_MATCH
-static mca_pml_ob1_recv_frag_t*
-recv_req_match_specific_proc( const mca_pml_ob1_recv_request_t *req,
-                              mca_pml_ob1_comm_proc_t *proc,
-                              custom_match_umq_node** hold_prev,
-                              custom_match_umq_node** hold_elem,
-                              int* hold_index)
-#else
 static mca_pml_ob1_recv_frag_t*
 recv_req_match_specific_proc( const mca_pml_ob1_recv_request_t *req,
                               mca_pml_ob1_comm_proc_t *proc )
-#endif
 {
     if (NULL == proc) {
         return NULL;
     }
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
     int tag = req->req_recv.req_base.req_tag;
     opal_list_t* unexpected_frags = &proc->unexpected_frags;
     mca_pml_ob1_recv_frag_t* frag;
@@ -1172,51 +1169,52 @@ recv_req_match_specific_proc( const mca_pml_ob1_recv_request_t *req,
         }
     }
     return NULL;
-#else
-    return custom_match_umq_find_verify_hold(req->req_recv.req_base.req_comm->c_pml_comm->umq,
-                                             req->req_recv.req_base.req_tag,
-                                             req->req_recv.req_base.req_peer,
-                                             hold_prev, hold_elem, hold_index);
-#endif
+}
+
+/*
+ * this routine searches the unexpected queue of an alternate matching
+ * engine. The engine specific location of the fragment is returned in
+ * hold_prev, hold_elem and hold_index so that it can later be removed.
+ */
+static mca_pml_ob1_recv_frag_t*
+recv_req_match_custom( mca_pml_ob1_recv_request_t* req,
+                       mca_pml_ob1_comm_proc_t **p,
+                       void **hold_prev,
+                       void **hold_elem,
+                       int *hold_index)
+{
+    mca_pml_ob1_comm_t *comm = (mca_pml_ob1_comm_t *) req->req_recv.req_base.req_comm->c_pml_comm;
+    mca_pml_ob1_recv_frag_t* frag;
+
+    frag = comm->match_engine->umq_find_verify_hold (comm->umq, req->req_recv.req_base.req_tag,
+                                                     req->req_recv.req_base.req_peer,
+                                                     hold_prev, hold_elem, hold_index);
+
+    /* the peer is already known for specific receives */
+    if (OMPI_ANY_SOURCE == req->req_recv.req_base.req_peer) {
+        if (frag) {
+            *p = comm->procs[frag->hdr.hdr_match.hdr_src];
+            req->req_recv.req_base.req_proc = (*p)->ompi_proc;
+            prepare_recv_req_converter(req);
+        } else {
+            *p = NULL;
+        }
+    }
+
+    return frag;
 }
 
 /*
  * this routine is used to try and match a wild posted receive - where
  * wild is determined by the value assigned to the source process
 */
-#if MCA_PML_OB1_CUSTOM_MATCH
-static mca_pml_ob1_recv_frag_t*
-recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
-                     mca_pml_ob1_comm_proc_t **p,
-                     custom_match_umq_node** hold_prev,
-                     custom_match_umq_node** hold_elem,
-                     int* hold_index)
-#else
 static mca_pml_ob1_recv_frag_t*
 recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
                      mca_pml_ob1_comm_proc_t **p)
-#endif
 {
     mca_pml_ob1_comm_t *comm = (mca_pml_ob1_comm_t *) req->req_recv.req_base.req_comm->c_pml_comm;
     mca_pml_ob1_comm_proc_t **procp = (mca_pml_ob1_comm_proc_t **) comm->procs;
 
-#if MCA_PML_OB1_CUSTOM_MATCH
-    mca_pml_ob1_recv_frag_t* frag;
-    frag = custom_match_umq_find_verify_hold (comm->umq, req->req_recv.req_base.req_tag,
-                                              req->req_recv.req_base.req_peer,
-                                              hold_prev, hold_elem, hold_index);
-
-    if (frag) {
-        *p = procp[frag->hdr.hdr_match.hdr_src];
-        req->req_recv.req_base.req_proc = procp[frag->hdr.hdr_match.hdr_src]->ompi_proc;
-        prepare_recv_req_converter(req);
-    } else {
-        *p = NULL;
-    }
-
-    return frag;
-#else
-
     /*
      * Loop over all the outstanding messages to find one that matches.
      * There is an outer loop over lists of messages from each
@@ -1252,7 +1250,6 @@ recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
 
     *p = NULL;
     return NULL;
-#endif
 }
 
 
@@ -1263,13 +1260,9 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
     mca_pml_ob1_comm_proc_t* proc;
     mca_pml_ob1_recv_frag_t* frag;
     mca_pml_ob1_hdr_t* hdr;
-#if MCA_PML_OB1_CUSTOM_MATCH
-    custom_match_umq_node* hold_prev;
-    custom_match_umq_node* hold_elem;
-    int hold_index;
-#else
-    opal_list_t *queue;
-#endif
+    void *hold_prev = NULL, *hold_elem = NULL;
+    int hold_index = 0;
+    opal_list_t *queue = NULL;
 
     /* init/re-init the request */
     req->req_lock = 0;
@@ -1280,6 +1273,7 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
     req->req_rdma_idx = 0;
     req->req_pending = false;
     req->req_ack_sent = false;
+    req->req_rndv = false;
 
     MCA_PML_BASE_RECV_START(&req->req_recv);
 
@@ -1317,12 +1311,12 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
 
     /* attempt to match posted recv */
     if(req->req_recv.req_base.req_peer == OMPI_ANY_SOURCE) {
-#if MCA_PML_OB1_CUSTOM_MATCH
-        frag = recv_req_match_wild(req, &proc, &hold_prev, &hold_elem, &hold_index);
-#else
-        frag = recv_req_match_wild(req, &proc);
-        queue = &ob1_comm->wild_receives;
-#endif
+        if (MCA_PML_OB1_COMM_CUSTOM_MATCH(ob1_comm)) {
+            frag = recv_req_match_custom(req, &proc, &hold_prev, &hold_elem, &hold_index);
+        } else {
+            frag = recv_req_match_wild(req, &proc);
+            queue = &ob1_comm->wild_receives;
+        }
 #if !OPAL_ENABLE_HETEROGENEOUS_SUPPORT
         /* As we are in a homogeneous environment we know that all remote
          * architectures are exactly the same as the local one. Therefore,
@@ -1337,12 +1331,12 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
     } else {
         proc = mca_pml_ob1_peer_lookup (comm, req->req_recv.req_base.req_peer);
         req->req_recv.req_base.req_proc = proc->ompi_proc;
-#if MCA_PML_OB1_CUSTOM_MATCH
-        frag = recv_req_match_specific_proc(req, proc, &hold_prev, &hold_elem, &hold_index);
-#else
-        frag = recv_req_match_specific_proc(req, proc);
-        queue = &proc->specific_receives;
-#endif
+        if (MCA_PML_OB1_COMM_CUSTOM_MATCH(ob1_comm)) {
+            frag = recv_req_match_custom(req, &proc, &hold_prev, &hold_elem, &hold_index);
+        } else {
+            frag = recv_req_match_specific_proc(req, proc);
+            queue = &proc->specific_receives;
+        }
         /* wildcard recv will be prepared on match */
         prepare_recv_req_converter(req);
     }
@@ -1353,14 +1347,15 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
         /* We didn't find any matches.  Record this irecv so we can match
            it when the message comes in. */
         if(OPAL_LIKELY(req->req_recv.req_base.req_type != MCA_PML_REQUEST_IPROBE &&
-                       req->req_recv.req_base.req_type != MCA_PML_REQUEST_IMPROBE))
-#if MCA_PML_OB1_CUSTOM_MATCH
-            custom_match_prq_append(ob1_comm->prq, req,
-                                    req->req_recv.req_base.req_tag,
-                                    req->req_recv.req_base.req_peer);
-#else
-            append_recv_req_to_queue(queue, req);
-#endif
+                       req->req_recv.req_base.req_type != MCA_PML_REQUEST_IMPROBE)) {
+            if (MCA_PML_OB1_COMM_CUSTOM_MATCH(ob1_comm)) {
+                ob1_comm->match_engine->prq_append(ob1_comm->prq, req,
+                                                   req->req_recv.req_base.req_tag,
+                                                   req->req_recv.req_base.req_peer);
+            } else {
+                append_recv_req_to_queue(queue, req);
+            }
+        }
         req->req_match_received = false;
         OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
     } else {
@@ -1378,12 +1373,12 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
             PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_SEARCH_UNEX_Q_END,
                                     &(req->req_recv.req_base), PERUSE_RECV);
 
-#if MCA_PML_OB1_CUSTOM_MATCH
-            custom_match_umq_remove_hold(req->req_recv.req_base.req_comm->c_pml_comm->umq, hold_prev, hold_elem, hold_index);
-#else
-            opal_list_remove_item(&proc->unexpected_frags,
-                                  (opal_list_item_t*)frag);
-#endif
+            if (MCA_PML_OB1_COMM_CUSTOM_MATCH(ob1_comm)) {
+                ob1_comm->match_engine->umq_remove_hold(ob1_comm->umq, hold_prev, hold_elem, hold_index);
+            } else {
+                opal_list_remove_item(&proc->unexpected_frags,
+                                      (opal_list_item_t*)frag);
+            }
             SPC_RECORD(OMPI_SPC_UNEXPECTED_IN_QUEUE, -1);
             OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
 
@@ -1414,12 +1409,12 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
                "recreated" as a receive request, and the frag will be
                restarted with this request during mrecv */
 
-#if MCA_PML_OB1_CUSTOM_MATCH
-            custom_match_umq_remove_hold(req->req_recv.req_base.req_comm->c_pml_comm->umq, hold_prev, hold_elem, hold_index);
-#else
-            opal_list_remove_item(&proc->unexpected_frags,
-                                  (opal_list_item_t*)frag);
-#endif
+            if (MCA_PML_OB1_COMM_CUSTOM_MATCH(ob1_comm)) {
+                ob1_comm->match_engine->umq_remove_hold(ob1_comm->umq, hold_prev, hold_elem, hold_index);
+            } else {
+                opal_list_remove_item(&proc->unexpected_frags,
+                                      (opal_list_item_t*)frag);
+            }
             SPC_RECORD(OMPI_SPC_UNEXPECTED_IN_QUEUE, -1);
             OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
 
@@ -53,6 +53,7 @@ struct mca_pml_ob1_recv_request_t {
     bool req_pending;
     bool req_ack_sent; /**< whether ack was sent to the sender */
     bool req_match_received; /**< Prevent request to be completed prematurely */
+    bool req_rndv; /**< the message uses a rendezvous protocol */
     opal_mutex_t lock;
     mca_bml_base_btl_t *rdma_bml;
     mca_btl_base_registration_handle_t *local_handle;
@@ -166,6 +167,14 @@ recv_request_pml_complete(mca_pml_ob1_recv_request_t *recvreq)
                     &recvreq->req_recv.req_base, PERUSE_RECV );
         }
 
+        if (recvreq->req_rndv) {
+            mca_pml_ob1_event_raise(MCA_PML_OB1_EVENT_RNDV_FINISH,
+                                    recvreq->req_recv.req_base.req_comm,
+                                    recvreq->req_recv.req_base.req_ompi.req_status.MPI_SOURCE,
+                                    recvreq->req_recv.req_base.req_ompi.req_status.MPI_TAG,
+                                    recvreq->req_bytes_received);
+        }
+
         for(i = 0; i < recvreq->req_rdma_cnt; i++) {
             struct mca_btl_base_registration_handle_t *handle = recvreq->req_rdma[i].btl_reg;
             mca_bml_base_btl_t *bml_btl = recvreq->req_rdma[i].bml_btl;
@@ -239,11 +248,13 @@ static inline void prepare_recv_req_converter(mca_pml_ob1_recv_request_t *req)
     }
 }
 
-#define MCA_PML_OB1_RECV_REQUEST_MATCHED(request, hdr) \
-    recv_req_matched(request, hdr)
+#define MCA_PML_OB1_RECV_REQUEST_MATCHED(request, hdr, msg_length) \
+    recv_req_matched(request, hdr, msg_length)
 
+/* msg_length is the size of the incoming message. only reported to the
+ * matched event */
 static inline void recv_req_matched(mca_pml_ob1_recv_request_t *req,
-                                    const mca_pml_ob1_match_hdr_t *hdr)
+                                    const mca_pml_ob1_match_hdr_t *hdr, size_t msg_length)
 {
     req->req_recv.req_base.req_ompi.req_status.MPI_SOURCE = hdr->hdr_src;
     req->req_recv.req_base.req_ompi.req_status.MPI_TAG = hdr->hdr_tag;
@@ -251,6 +262,9 @@ static inline void recv_req_matched(mca_pml_ob1_recv_request_t *req,
 
     opal_atomic_wmb();
 
+    mca_pml_ob1_event_raise(MCA_PML_OB1_EVENT_MATCHED, req->req_recv.req_base.req_comm,
+                            hdr->hdr_src, hdr->hdr_tag, msg_length);
+
     if(req->req_recv.req_bytes_packed > 0) {
 #if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
         if(MPI_ANY_SOURCE == req->req_recv.req_base.req_peer) {
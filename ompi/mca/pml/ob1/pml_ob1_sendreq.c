@@ -47,6 +47,45 @@
 OBJ_CLASS_INSTANCE(mca_pml_ob1_send_range_t, opal_free_list_item_t,
         NULL, NULL);
 
+opal_thread_local mca_pml_ob1_start_batch_t mca_pml_ob1_start_batch = {.active = false};
+
+/* returns MCA_BTL_DES_FLAGS_DEFER if an inline send on this btl can be held
+ * back until the end of mca_pml_ob1_start */
+static inline uint32_t mca_pml_ob1_start_batch_defer(mca_bml_base_btl_t *bml_btl)
+{
+    mca_pml_ob1_start_batch_t *batch = &mca_pml_ob1_start_batch;
+
+    if (OPAL_LIKELY(!batch->active) || NULL == bml_btl->btl->btl_flush) {
+        return 0;
+    }
+
+    for (int i = 0 ; i < batch->count ; ++i) {
+        if (batch->bml_btls[i] == bml_btl) {
+            return MCA_BTL_DES_FLAGS_DEFER;
+        }
+    }
+
+    if (MCA_PML_OB1_START_BATCH_MAX == batch->count) {
+        return 0;
+    }
+
+    batch->bml_btls[batch->count++] = bml_btl;
+    return MCA_BTL_DES_FLAGS_DEFER;
+}
+
+void mca_pml_ob1_start_batch_flush(void)
+{
+    mca_pml_ob1_start_batch_t *batch = &mca_pml_ob1_start_batch;
+
+    for (int i = 0 ; i < batch->count ; ++i) {
+        mca_bml_base_btl_t *bml_btl = batch->bml_btls[i];
+        (void) bml_btl->btl->btl_flush (bml_btl->btl, bml_btl->btl_endpoint);
+    }
+
+    batch->count = 0;
+    batch->active = false;
+}
+
 void mca_pml_ob1_send_request_process_pending(mca_bml_base_btl_t *bml_btl)
 {
     int rc, i, s = opal_list_get_size(&mca_pml_ob1.send_pending);
@@ -636,7 +675,8 @@ int mca_pml_ob1_send_request_start_copy( mca_pml_ob1_send_request_t* sendreq,
         rc = mca_bml_base_sendi( bml_btl, &sendreq->req_send.req_base.req_convertor,
                                  &match, OMPI_PML_OB1_MATCH_HDR_LEN,
                                  size, MCA_BTL_NO_ORDER,
-                                 MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP,
+                                 MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP |
+                                 mca_pml_ob1_start_batch_defer (bml_btl),
                                  MCA_PML_OB1_HDR_TYPE_MATCH,
                                  &des);
         if( OPAL_LIKELY(OMPI_SUCCESS == rc) ) {
@@ -370,6 +370,25 @@ int mca_pml_ob1_send_request_start_copy(
     mca_bml_base_btl_t* bml_btl,
     size_t size);
 
+/**
+ * Eager sends started by one call to mca_pml_ob1_start may be held back by
+ * the btl (MCA_BTL_DES_FLAGS_DEFER) so it can pack them together. The btls
+ * used for such sends are recorded here and flushed before mca_pml_ob1_start
+ * returns.
+ */
+#define MCA_PML_OB1_START_BATCH_MAX 8
+
+typedef struct mca_pml_ob1_start_batch_t {
+    bool active;
+    int count;
+    mca_bml_base_btl_t *bml_btls[MCA_PML_OB1_START_BATCH_MAX];
+} mca_pml_ob1_start_batch_t;
+
+extern opal_thread_local mca_pml_ob1_start_batch_t mca_pml_ob1_start_batch;
+
+/* flush the btls recorded in the batch of the calling thread and close it */
+void mca_pml_ob1_start_batch_flush(void);
+
 int mca_pml_ob1_send_request_start_prepare(
     mca_pml_ob1_send_request_t* sendreq,
     mca_bml_base_btl_t* bml_btl,
@@ -413,7 +432,10 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
             rc = mca_pml_ob1_send_request_start_prepare(sendreq, bml_btl, size);
             break;
         default:
-            if (size != 0 && bml_btl->btl_flags & MCA_BTL_FLAGS_SEND_INPLACE) {
+            /* sends started together go through sendi so the btl can pack them */
+            if (size != 0 && bml_btl->btl_flags & MCA_BTL_FLAGS_SEND_INPLACE
+                && !(mca_pml_ob1_start_batch.active && NULL != btl->btl_flush
+                     && NULL != btl->btl_sendi)) {
                 rc = mca_pml_ob1_send_request_start_prepare(sendreq, bml_btl, size);
             } else {
                 rc = mca_pml_ob1_send_request_start_copy(sendreq, bml_btl, size);
@@ -30,7 +30,11 @@
 
 int mca_pml_ob1_start(size_t count, ompi_request_t** requests)
 {
-    int rc;
+    int rc = OMPI_SUCCESS;
+
+    /* let the btls pack the small sends started together. they are flushed
+     * before returning */
+    mca_pml_ob1_start_batch.active = count > 1;
 
     for (size_t i = 0 ; i < count ; ++i) {
         mca_pml_base_request_t *pml_request = (mca_pml_base_request_t*)requests[i];
@@ -71,7 +75,7 @@ int mca_pml_ob1_start(size_t count, ompi_request_t** requests)
                                                  pml_request->req_comm,
                                                  &request);
                     if (OPAL_UNLIKELY(OMPI_SUCCESS != rc)) {
-                        return rc;
+                        goto done;
                     }
 
                     /* copy the callback and callback data to the new requests */
@@ -101,7 +105,7 @@ int mca_pml_ob1_start(size_t count, ompi_request_t** requests)
 
                 MCA_PML_OB1_SEND_REQUEST_START(sendreq, rc);
                 if(rc != OMPI_SUCCESS)
-                    return rc;
+                    goto done;
                 break;
             }
             case MCA_PML_REQUEST_RECV:
@@ -111,9 +115,13 @@ int mca_pml_ob1_start(size_t count, ompi_request_t** requests)
                 break;
             }
             default:
-                return OMPI_ERR_REQUEST;
+                rc = OMPI_ERR_REQUEST;
+                goto done;
         }
     }
-    return OMPI_SUCCESS;
+
+done:
+    mca_pml_ob1_start_batch_flush();
+    return rc;
 }
 
@@ -33,6 +33,16 @@ int MPI_T_event_callback_get_info (MPI_T_event_registration event_registration,
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
-}
+    if (MPI_T_EVENT_REGISTRATION_NULL == event_registration) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    if (MPI_PARAM_CHECK && (NULL == info_used || cb_safety < MPI_T_CB_REQUIRE_NONE ||
+                            cb_safety > MPI_T_CB_REQUIRE_ASYNC_SIGNAL_SAFE)) {
+        return MPI_ERR_ARG;
+    }
+
+    *info_used = ompi_info_allocate ();
 
+    return (NULL == *info_used) ? MPI_T_ERR_MEMORY : MPI_SUCCESS;
+}
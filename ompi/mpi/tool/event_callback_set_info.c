@@ -32,5 +32,17 @@ int MPI_T_event_callback_set_info (MPI_T_event_registration event_registration,
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (MPI_T_EVENT_REGISTRATION_NULL == event_registration) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    if (MPI_PARAM_CHECK && (cb_safety < MPI_T_CB_REQUIRE_NONE ||
+                            cb_safety > MPI_T_CB_REQUIRE_ASYNC_SIGNAL_SAFE)) {
+        return MPI_ERR_ARG;
+    }
+
+    /* no info keys are supported at this time */
+    (void) info;
+
+    return MPI_SUCCESS;
 }
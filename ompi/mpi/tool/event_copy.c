@@ -27,9 +27,21 @@
 
 int MPI_T_event_copy (MPI_T_event_instance event, void *buffer)
 {
+    const mca_base_event_instance_t *instance = mpit_event_instance (event);
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (NULL == instance) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    if (MPI_PARAM_CHECK && NULL == buffer) {
+        return MPI_ERR_ARG;
+    }
+
+    memcpy (buffer, instance->data, instance->event->extent);
+
+    return MPI_SUCCESS;
 }
@@ -25,6 +25,8 @@
 
 int MPI_T_event_get_index (const char *name, int *event_index)
 {
+    int ret;
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
@@ -33,5 +35,9 @@ int MPI_T_event_get_index (const char *name, int *event_index)
         return MPI_ERR_ARG;
     }
 
-    return MPI_T_ERR_INVALID_NAME;
+    ompi_mpit_lock ();
+    ret = mca_base_event_find_by_name (name, event_index);
+    ompi_mpit_unlock ();
+
+    return (OPAL_SUCCESS == ret) ? MPI_SUCCESS : MPI_T_ERR_INVALID_NAME;
 }
@@ -30,9 +30,60 @@ int MPI_T_event_get_info (int event_index, char *name, int *name_len,
                           MPI_T_enum *enumtype, MPI_Info *info,
                           char *desc, int *desc_len, int *bind)
 {
+    mca_base_event_t *event;
+    int ret;
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_INDEX;
+    ompi_mpit_lock ();
+
+    do {
+        ret = mca_base_event_get (event_index, &event);
+        if (OPAL_SUCCESS != ret) {
+            ret = MPI_T_ERR_INVALID_INDEX;
+            break;
+        }
+
+        mpit_copy_string (name, name_len, event->name);
+        mpit_copy_string (desc, desc_len, event->description);
+
+        if (verbosity) {
+            *verbosity = event->verbosity;
+        }
+
+        if (num_elements) {
+            /* on input num_elements is the length of the arrays */
+            for (int i = 0 ; i < event->num_elements && i < *num_elements ; ++i) {
+                if (array_of_datatypes) {
+                    (void) ompit_var_type_to_datatype (event->types[i], array_of_datatypes + i);
+                }
+
+                if (array_of_displacements) {
+                    array_of_displacements[i] = (MPI_Aint) event->offsets[i];
+                }
+            }
+
+            *num_elements = event->num_elements;
+        }
+
+        if (enumtype) {
+            *enumtype = MPI_T_ENUM_NULL;
+        }
+
+        if (info) {
+            *info = ompi_info_allocate ();
+        }
+
+        if (bind) {
+            *bind = event->bind;
+        }
+
+        ret = MPI_SUCCESS;
+    } while (0);
+
+    ompi_mpit_unlock ();
+
+    return ret;
 }
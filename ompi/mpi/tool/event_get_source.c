@@ -30,5 +30,16 @@ int MPI_T_event_get_source (MPI_T_event_instance event, int *source_index)
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (NULL == event) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    if (MPI_PARAM_CHECK && NULL == source_index) {
+        return MPI_ERR_ARG;
+    }
+
+    /* all events are timestamped with the same clock */
+    *source_index = MCA_BASE_EVENT_SOURCE_TIMER;
+
+    return MPI_SUCCESS;
 }
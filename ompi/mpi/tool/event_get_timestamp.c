@@ -30,5 +30,15 @@ int MPI_T_event_get_timestamp (MPI_T_event_instance event, MPI_Count *event_time
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (NULL == event) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    if (MPI_PARAM_CHECK && NULL == event_time) {
+        return MPI_ERR_ARG;
+    }
+
+    *event_time = (MPI_Count) mpit_event_instance (event)->timestamp;
+
+    return MPI_SUCCESS;
 }
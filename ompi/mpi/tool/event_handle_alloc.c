@@ -27,9 +27,29 @@
 int MPI_T_event_handle_alloc (int event_index, void *obj_handle, MPI_Info info,
                               MPI_T_event_registration *event_registration)
 {
+    mca_base_event_handle_t *handle;
+    int ret;
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_INDEX;
+    if (MPI_PARAM_CHECK && NULL == event_registration) {
+        return MPI_ERR_ARG;
+    }
+
+    /* no info keys are supported at this time */
+    (void) info;
+
+    ompi_mpit_lock ();
+    ret = mca_base_event_handle_alloc (event_index, obj_handle, &handle);
+    ompi_mpit_unlock ();
+
+    if (OPAL_SUCCESS != ret) {
+        return (OPAL_ERR_NOT_FOUND == ret) ? MPI_T_ERR_INVALID_INDEX : ompit_opal_to_mpit_error (ret);
+    }
+
+    *event_registration = (MPI_T_event_registration) handle;
+
+    return MPI_SUCCESS;
 }
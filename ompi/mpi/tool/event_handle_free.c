@@ -28,9 +28,20 @@ int MPI_T_event_handle_free (MPI_T_event_registration event_registration,
                              void *user_data,
                              MPI_T_event_free_cb_function free_cb_function)
 {
+    int ret;
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (MPI_T_EVENT_REGISTRATION_NULL == event_registration) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    ompi_mpit_lock ();
+    ret = mca_base_event_handle_free (mpit_event_handle (event_registration),
+                                      (mca_base_event_free_cb_fn_t) free_cb_function, user_data);
+    ompi_mpit_unlock ();
+
+    return ompit_opal_to_mpit_error (ret);
 }
@@ -32,5 +32,15 @@ int MPI_T_event_handle_get_info (MPI_T_event_registration event_registration,
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (MPI_T_EVENT_REGISTRATION_NULL == event_registration) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    if (MPI_PARAM_CHECK && NULL == info_used) {
+        return MPI_ERR_ARG;
+    }
+
+    *info_used = ompi_info_allocate ();
+
+    return (NULL == *info_used) ? MPI_T_ERR_MEMORY : MPI_SUCCESS;
 }
@@ -26,9 +26,21 @@
 
 int MPI_T_event_read (MPI_T_event_instance event, int element_index, void *buffer)
 {
+    int ret;
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (NULL == event) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    if (MPI_PARAM_CHECK && NULL == buffer) {
+        return MPI_ERR_ARG;
+    }
+
+    ret = mca_base_event_read (mpit_event_instance (event), element_index, buffer);
+
+    return (OPAL_SUCCESS == ret) ? MPI_SUCCESS : MPI_T_ERR_INVALID_ITEM;
 }
@@ -28,9 +28,22 @@ int MPI_T_event_register_callback (MPI_T_event_registration event_registration,
                                    MPI_T_cb_safety cb_safety, MPI_Info info, void *user_data,
                                    MPI_T_event_cb_function event_cb_function)
 {
+    int ret;
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (MPI_T_EVENT_REGISTRATION_NULL == event_registration) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    /* no info keys are supported at this time */
+    (void) info;
+
+    ret = mca_base_event_register_callback (mpit_event_handle (event_registration), cb_safety,
+                                            (mca_base_event_cb_fn_t) event_cb_function,
+                                            user_data);
+
+    return (OPAL_ERR_BAD_PARAM == ret) ? MPI_ERR_ARG : ompit_opal_to_mpit_error (ret);
 }
@@ -27,9 +27,18 @@
 int MPI_T_event_set_dropped_handler (MPI_T_event_registration handle, MPI_T_event_dropped_cb_function dropped_cb_function)
 
 {
+    int ret;
+
     if (!mpit_is_initialized ()) {
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_HANDLE;
+    if (MPI_T_EVENT_REGISTRATION_NULL == handle) {
+        return MPI_T_ERR_INVALID_HANDLE;
+    }
+
+    ret = mca_base_event_set_dropped_handler (mpit_event_handle (handle),
+                                              (mca_base_event_dropped_cb_fn_t) dropped_cb_function);
+
+    return ompit_opal_to_mpit_error (ret);
 }
@@ -17,6 +17,7 @@
 
 #include "opal/util/string_copy.h"
 #include "opal/mca/base/mca_base_var.h"
+#include "opal/mca/base/mca_base_event.h"
 #include "opal/mca/base/mca_base_pvar.h"
 
 #include "ompi/include/ompi_config.h"
@@ -24,6 +25,7 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/constants.h"
 #include "ompi/datatype/ompi_datatype.h"
+#include "ompi/info/info.h"
 
 #include "mpi.h"
 
@@ -43,6 +45,18 @@ extern volatile uint32_t ompi_mpit_init_count;
 int ompit_var_type_to_datatype (mca_base_var_type_t type, MPI_Datatype *datatype);
 int ompit_opal_to_mpit_error (int rc);
 
+/* MPI_T_event_registration and MPI_T_event_instance are opaque pointers to
+ * the OPAL handle and instance */
+static inline mca_base_event_handle_t *mpit_event_handle (MPI_T_event_registration registration)
+{
+    return (mca_base_event_handle_t *) registration;
+}
+
+static inline mca_base_event_instance_t *mpit_event_instance (MPI_T_event_instance event)
+{
+    return (mca_base_event_instance_t *) event;
+}
+
 static inline int mpit_is_initialized (void)
 {
     return !!ompi_mpit_init_count;
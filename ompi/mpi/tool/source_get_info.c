@@ -30,5 +30,31 @@ int MPI_T_source_get_info (int source_index, char *name, int *name_len, char *de
         return MPI_T_ERR_NOT_INITIALIZED;
     }
 
-    return MPI_T_ERR_INVALID_INDEX;
+    if (MCA_BASE_EVENT_SOURCE_TIMER != source_index) {
+        return MPI_T_ERR_INVALID_INDEX;
+    }
+
+    mpit_copy_string (name, name_len, "opal_timer");
+    mpit_copy_string (desc, desc_len, "High resolution timer used to timestamp all Open MPI "
+                      "events. Events are delivered in the order they were raised");
+
+    if (ordering) {
+        /* threads may raise events concurrently. their timestamps can
+         * interleave with the delivery order */
+        *ordering = opal_using_threads () ? MPI_T_UNORDERED : MPI_T_ORDERED;
+    }
+
+    if (ticks_per_second) {
+        *ticks_per_second = (MPI_Count) mca_base_event_source_ticks_per_second ();
+    }
+
+    if (max_timestamp) {
+        *max_timestamp = (MPI_Count) INT64_MAX;
+    }
+
+    if (info) {
+        *info = ompi_info_allocate ();
+    }
+
+    return MPI_SUCCESS;
 }
@@ -33,6 +33,7 @@ int MPI_T_source_get_num (int *num_source)
         return MPI_ERR_ARG;
     }
 
-    *num_source = 0;
+    /* all events share one source */
+    *num_source = 1;
     return MPI_SUCCESS;
 }
@@ -33,5 +33,11 @@ int MPI_T_source_get_timestamp (int source_index, MPI_Count *timestamp)
         return MPI_ERR_ARG;
     }
 
-    return MPI_T_ERR_INVALID_INDEX;
+    if (MCA_BASE_EVENT_SOURCE_TIMER != source_index) {
+        return MPI_T_ERR_INVALID_INDEX;
+    }
+
+    *timestamp = (MPI_Count) mca_base_event_source_timestamp ();
+
+    return MPI_SUCCESS;
 }
@@ -231,6 +231,7 @@ int ompi_op_init(void)
      * See https://github.com/mpi-forum/mpi-issues/issues/65 */
     ompi_op_ddt_map[OMPI_DATATYPE_MPI_SHORT_FLOAT] = OMPI_OP_BASE_TYPE_SHORT_FLOAT;
     ompi_op_ddt_map[OMPI_DATATYPE_MPI_C_SHORT_FLOAT_COMPLEX] = OMPI_OP_BASE_TYPE_C_SHORT_FLOAT_COMPLEX;
+    ompi_op_ddt_map[OMPI_DATATYPE_MPI_BFLOAT16] = OMPI_OP_BASE_TYPE_BFLOAT16;
 
     ompi_op_ddt_map[OMPI_DATATYPE_MPI_LONG] = OMPI_OP_BASE_TYPE_LONG;
     ompi_op_ddt_map[OMPI_DATATYPE_MPI_UNSIGNED_LONG] = OMPI_OP_BASE_TYPE_UNSIGNED_LONG;
@@ -479,6 +480,8 @@ static void ompi_op_construct(ompi_op_t *new_op)
         new_op->o_3buff_intrinsic.fns[i] = NULL;
         new_op->o_3buff_intrinsic.modules[i] = NULL;
     }
+    new_op->o_copy_intrinsic = NULL;
+    new_op->o_nary_intrinsic = NULL;
 }
 
 
@@ -509,5 +512,15 @@ static void ompi_op_destruct(ompi_op_t *op)
             OBJ_RELEASE(op->o_3buff_intrinsic.modules[i]);
             op->o_3buff_intrinsic.modules[i] = NULL;
         }
+        if( NULL != op->o_copy_intrinsic && NULL != op->o_copy_intrinsic->modules[i] ) {
+            OBJ_RELEASE(op->o_copy_intrinsic->modules[i]);
+        }
+        if( NULL != op->o_nary_intrinsic && NULL != op->o_nary_intrinsic->modules[i] ) {
+            OBJ_RELEASE(op->o_nary_intrinsic->modules[i]);
+        }
     }
+    free(op->o_copy_intrinsic);
+    op->o_copy_intrinsic = NULL;
+    free(op->o_nary_intrinsic);
+    op->o_nary_intrinsic = NULL;
 }
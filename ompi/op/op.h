@@ -175,6 +175,12 @@ struct ompi_op_t {
     /** 3-buffer functions, which is only for intrinsic ops.  No need
         for the C/C++/Fortran user-defined functions. */
     ompi_op_base_op_3buff_fns_t o_3buff_intrinsic;
+
+    /** Fused reduce-and-copy and N-ary functions, which are only for
+        intrinsic ops. They are allocated separately (and are NULL for
+        the user-defined ops) to fit in the predefined op padding. */
+    ompi_op_base_op_copy_fns_t *o_copy_intrinsic;
+    ompi_op_base_op_nary_fns_t *o_nary_intrinsic;
 };
 
 /**
@@ -481,6 +487,30 @@ static inline bool ompi_op_is_valid(ompi_op_t * op, ompi_datatype_t * ddt,
 }
 
 
+/** number of helper threads used for large reductions (0 disables the pool) */
+OMPI_DECLSPEC extern int ompi_op_base_reduce_threads;
+/** reductions of at least this many bytes are split across the pool */
+OMPI_DECLSPEC extern size_t ompi_op_base_reduce_threshold;
+
+/**
+ * Reduce count elements with the calling thread and the helper threads of
+ * the op base reduction pool: target = source1 op target if source2 is
+ * NULL, target = source1 op source2 otherwise. The op must be intrinsic
+ * and the datatype predefined. Returns OMPI_ERR_TEMP_OUT_OF_RESOURCE,
+ * without reducing anything, if the pool is busy or has no threads.
+ */
+OMPI_DECLSPEC int ompi_op_base_reduce_pool_run(struct ompi_op_t *op, const void *source1,
+                                               const void *source2, void *target, size_t count,
+                                               struct ompi_datatype_t *dtype);
+
+/** check if a reduction should go through the reduction pool */
+static inline bool ompi_op_reduce_pool_use(ompi_op_t *op, size_t count, ompi_datatype_t *dtype)
+{
+    return ompi_op_base_reduce_threads > 0 && ompi_op_is_intrinsic(op) &&
+        ompi_datatype_is_predefined(dtype) &&
+        count * dtype->super.size >= ompi_op_base_reduce_threshold;
+}
+
 /**
  * Perform a reduction operation.
  *
@@ -518,6 +548,11 @@ static inline void ompi_op_reduce(ompi_op_t * op, const void *source,
     MPI_Fint f_dtype, f_count;
     int count = full_count;
 
+    if (OPAL_UNLIKELY(ompi_op_reduce_pool_use(op, full_count, dtype)) &&
+        OMPI_SUCCESS == ompi_op_base_reduce_pool_run(op, source, NULL, target, full_count, dtype)) {
+        return;
+    }
+
     /*
      * If the full_count is > INT_MAX then we need to call the reduction op
      * in iterations of counts <= INT_MAX since it has an `int *len`
@@ -654,6 +689,12 @@ static inline void ompi_3buff_op_reduce(ompi_op_t * op, void *source1,
     src2 = source2;
     tgt = target;
 
+    if (OPAL_UNLIKELY(ompi_op_reduce_pool_use(op, full_count, dtype)) &&
+        OMPI_SUCCESS == ompi_op_base_reduce_pool_run(op, source1, source2, target, full_count,
+                                                     dtype)) {
+        return;
+    }
+
     if(OPAL_UNLIKELY((full_count > INT_MAX) &&
         (0 == (op->o_flags & OMPI_OP_FLAGS_BIGCOUNT)))) {
         size_t done_count = 0, shift, iter_count;
@@ -687,6 +728,87 @@ static inline void ompi_3buff_op_reduce(ompi_op_t * op, void *source1,
     }
 }
 
+/**
+ * Perform a reduction operation and copy its result.
+ *
+ * @param op The operation (IN)
+ * @param source Source (input) buffer (IN)
+ * @param target Target (output) buffer (IN/OUT)
+ * @param copy Copy of the result (OUT)
+ * @param count Number of elements (IN)
+ * @param dtype MPI datatype (IN)
+ *
+ * Same as ompi_op_reduce, the result being also stored in the copy
+ * buffer (usually the next send buffer of a pipelined algorithm). For
+ * intrinsic ops on predefined datatypes, an op component may do both
+ * in a single pass over the data; otherwise, the target buffer is
+ * copied after the reduction. The copy buffer may be the source buffer.
+ */
+static inline void ompi_op_reduce_copy(ompi_op_t * op, const void *source,
+                                       void *target, void *copy,
+                                       size_t full_count, ompi_datatype_t * dtype)
+{
+    if (OPAL_LIKELY(NULL != op->o_copy_intrinsic && full_count <= INT_MAX &&
+                    ompi_datatype_is_predefined(dtype))) {
+        int dtype_id = ompi_op_ddt_map[dtype->id];
+        int count = (int)full_count;
+
+        if (NULL != op->o_copy_intrinsic->fns[dtype_id]) {
+            op->o_copy_intrinsic->fns[dtype_id](source, target, copy, &count, &dtype,
+                                                op->o_copy_intrinsic->modules[dtype_id]);
+            return;
+        }
+    }
+    ompi_op_reduce(op, source, target, full_count, dtype);
+    ompi_datatype_copy_content_same_ddt(dtype, full_count, (char*)copy, (char*)target);
+}
+
+/**
+ * Perform an N-ary reduction operation.
+ *
+ * @param op The operation (IN)
+ * @param sources Source (input) buffers (IN)
+ * @param nsources Number of source buffers, at least 2 (IN)
+ * @param target Target (output) buffer (OUT)
+ * @param count Number of elements (IN)
+ * @param dtype MPI datatype (IN)
+ *
+ * The target buffer obtains sources[0] op sources[1] op ... op
+ * sources[nsources - 1]; it must not be one of the sources. For
+ * intrinsic ops on predefined datatypes, an op component may reduce all
+ * the sources in a single pass over the target; otherwise, the sources
+ * are reduced into the target one at a time, from the last one.
+ */
+static inline void ompi_op_reduce_nary(ompi_op_t * op, const void *const *sources,
+                                       int nsources, void *target,
+                                       size_t full_count, ompi_datatype_t * dtype)
+{
+    if (OPAL_LIKELY(NULL != op->o_nary_intrinsic && full_count <= INT_MAX &&
+                    ompi_datatype_is_predefined(dtype))) {
+        int dtype_id = ompi_op_ddt_map[dtype->id];
+        int count = (int)full_count;
+
+        if (NULL != op->o_nary_intrinsic->fns[dtype_id]) {
+            op->o_nary_intrinsic->fns[dtype_id](sources, nsources, target, &count, &dtype,
+                                                op->o_nary_intrinsic->modules[dtype_id]);
+            return;
+        }
+    }
+    /* The intrinsic ops are commutative; the user-defined ones are
+       applied in order */
+    if (ompi_op_is_intrinsic(op)) {
+        ompi_3buff_op_reduce(op, (void*)sources[nsources - 2], (void*)sources[nsources - 1],
+                             target, full_count, dtype);
+    } else {
+        ompi_datatype_copy_content_same_ddt(dtype, full_count, (char*)target,
+                                            (char*)sources[nsources - 1]);
+        ompi_op_reduce(op, sources[nsources - 2], target, full_count, dtype);
+    }
+    for (int i = nsources - 3; i >= 0; i--) {
+        ompi_op_reduce(op, sources[i], target, full_count, dtype);
+    }
+}
+
 END_C_DECLS
 
 #endif /* OMPI_OP_H */
@@ -217,6 +217,23 @@ OMPI_DECLSPEC int ompi_mpi_abort(struct ompi_communicator_t* comm,
  */
 int ompi_init_preconnect_mpi(void);
 
+/**
+ * Force thread-safe operation of OPAL and the MPI components if the
+ * asynchronous progress thread was requested (mpi_async_progress).
+ * Must be called before the components are selected.
+ */
+void ompi_mpi_async_progress_enable_threads(void);
+
+/**
+ * Start the asynchronous progress thread if it was requested.
+ */
+int ompi_mpi_async_progress_start(void);
+
+/**
+ * Stop the asynchronous progress thread (if running).
+ */
+void ompi_mpi_async_progress_stop(void);
+
 /**
  * Called to disable MPI dynamic process support.  It should be called
  * by transports and/or environments where MPI dynamic process
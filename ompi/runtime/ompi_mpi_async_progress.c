@@ -0,0 +1,142 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * MPI asynchronous progress thread
+ *
+ * When mpi_async_progress is set a helper thread calls opal_progress() in
+ * a loop for the lifetime of the MPI instance, so rendezvous protocols,
+ * non-blocking collective schedules and one-sided operations advance while
+ * the application computes. The thread only calls opal_progress(); the
+ * progress callbacks of the BTL/PML/coll/osc components already serialize
+ * themselves with their own locks once opal_using_threads() is true, which
+ * is forced on when the thread is requested.
+ */
+
+#include "ompi_config.h"
+
+#include <time.h>
+
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/output.h"
+#include "opal/util/show_help.h"
+
+#include "ompi/constants.h"
+#include "ompi/runtime/mpiruntime.h"
+#include "ompi/runtime/params.h"
+
+static opal_thread_t ompi_mpi_async_progress_thread;
+static volatile bool ompi_mpi_async_progress_active = false;
+
+static void ompi_mpi_async_progress_bind(void)
+{
+    hwloc_obj_t core;
+
+    if (0 > ompi_mpi_async_progress_core) {
+        /* inherit the binding of the process */
+        return;
+    }
+
+    if (OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return;
+    }
+
+    core = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_CORE,
+                                 (unsigned) ompi_mpi_async_progress_core);
+    if (NULL == core) {
+        opal_show_help("help-mpi-runtime.txt", "mpi-async-progress:bad-core", true,
+                       ompi_mpi_async_progress_core);
+        return;
+    }
+
+    if (0 != hwloc_set_cpubind(opal_hwloc_topology, core->cpuset, HWLOC_CPUBIND_THREAD)) {
+        opal_show_help("help-mpi-runtime.txt", "mpi-async-progress:bind-failed", true,
+                       ompi_mpi_async_progress_core);
+    }
+}
+
+static void *ompi_mpi_async_progress_engine(opal_object_t *obj)
+{
+    const struct timespec idle_sleep = {.tv_sec = ompi_mpi_async_progress_idle_sleep / 1000000,
+                                        .tv_nsec = (long) (ompi_mpi_async_progress_idle_sleep
+                                                           % 1000000) * 1000};
+    unsigned int idle = 0;
+
+    (void) obj;
+
+    ompi_mpi_async_progress_bind();
+
+    while (ompi_mpi_async_progress_active) {
+        if (opal_progress() > 0) {
+            idle = 0;
+            continue;
+        }
+
+        /* back off after a stretch of empty progress calls so an idle
+         * thread does not compete with the application for the core */
+        if (ompi_mpi_async_progress_idle_sleep > 0 && ++idle >= 1000) {
+            idle = 0;
+            (void) nanosleep(&idle_sleep, NULL);
+        }
+    }
+
+    return OPAL_THREAD_CANCELLED;
+}
+
+void ompi_mpi_async_progress_enable_threads(void)
+{
+    if (!ompi_mpi_async_progress) {
+        return;
+    }
+
+    /* the progress thread runs concurrently with the application thread(s)
+     * so every component needs to take its locks */
+    opal_set_using_threads(true);
+    ompi_mpi_thread_multiple = true;
+}
+
+int ompi_mpi_async_progress_start(void)
+{
+    int ret;
+
+    if (!ompi_mpi_async_progress || ompi_mpi_async_progress_active) {
+        return OMPI_SUCCESS;
+    }
+
+    OBJ_CONSTRUCT(&ompi_mpi_async_progress_thread, opal_thread_t);
+    ompi_mpi_async_progress_thread.t_run = ompi_mpi_async_progress_engine;
+    ompi_mpi_async_progress_thread.t_arg = NULL;
+
+    ompi_mpi_async_progress_active = true;
+    opal_atomic_wmb();
+
+    ret = opal_thread_start(&ompi_mpi_async_progress_thread);
+    if (OPAL_SUCCESS != ret) {
+        ompi_mpi_async_progress_active = false;
+        OBJ_DESTRUCT(&ompi_mpi_async_progress_thread);
+        return ret;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+void ompi_mpi_async_progress_stop(void)
+{
+    if (!ompi_mpi_async_progress_active) {
+        return;
+    }
+
+    ompi_mpi_async_progress_active = false;
+    opal_atomic_wmb();
+
+    opal_thread_join(&ompi_mpi_async_progress_thread, NULL);
+    OBJ_DESTRUCT(&ompi_mpi_async_progress_thread);
+}
@@ -72,6 +72,9 @@ bool ompi_use_sparse_group_storage = OPAL_INT_TO_BOOL(OMPI_GROUP_SPARSE);
 /* if the threads module requires yielding we use that as default but allow it to be overridden */
 bool ompi_mpi_yield_when_idle = OPAL_THREAD_YIELD_WHEN_IDLE_DEFAULT;
 int ompi_mpi_event_tick_rate = -1;
+bool ompi_mpi_async_progress = false;
+int ompi_mpi_async_progress_core = -1;
+unsigned int ompi_mpi_async_progress_idle_sleep = 0;
 char *ompi_mpi_show_mca_params_string = NULL;
 bool ompi_mpi_have_sparse_group_storage = !!(OMPI_GROUP_SPARSE);
 bool ompi_mpi_preconnect_mpi = false;
@@ -170,6 +173,30 @@ int ompi_mpi_register_params(void)
                                  MCA_BASE_VAR_SCOPE_READONLY,
                                  &ompi_mpi_event_tick_rate);
 
+    ompi_mpi_async_progress = false;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress",
+                                 "Start a thread that progresses MPI communication (point-to-point, non-blocking collectives and one-sided) while the application computes. Enables thread-safe operation of all components",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress);
+
+    ompi_mpi_async_progress_core = -1;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress_core",
+                                 "Logical index of the core the asynchronous progress thread is bound to (-1 = inherit the binding of the process)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress_core);
+
+    ompi_mpi_async_progress_idle_sleep = 0;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress_idle_sleep",
+                                 "Time in microseconds the asynchronous progress thread sleeps after a stretch of progress calls that found nothing to do (0 = always spin)",
+                                 MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress_idle_sleep);
+
     /* Whether or not to show MPI handle leaks */
     ompi_debug_show_handle_leaks = false;
     (void) mca_base_var_register("ompi", "mpi", NULL, "show_handle_leaks",
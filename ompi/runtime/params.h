@@ -191,6 +191,22 @@ OMPI_DECLSPEC extern bool ompi_enable_timing;
 OMPI_DECLSPEC extern int ompi_mpi_event_tick_rate;
 OMPI_DECLSPEC extern bool ompi_mpi_yield_when_idle;
 
+/**
+ * Whether to start the asynchronous progress thread (default: false).
+ */
+OMPI_DECLSPEC extern bool ompi_mpi_async_progress;
+
+/**
+ * Logical index of the core the asynchronous progress thread is bound
+ * to, or -1 to inherit the binding of the process.
+ */
+OMPI_DECLSPEC extern int ompi_mpi_async_progress_core;
+
+/**
+ * Microseconds the asynchronous progress thread sleeps when idle (0 = spin).
+ */
+OMPI_DECLSPEC extern unsigned int ompi_mpi_async_progress_idle_sleep;
+
  /**
  * An integer value specifying verbosity level for communicator management
  * subsystem.
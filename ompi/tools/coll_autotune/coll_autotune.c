@@ -0,0 +1,1079 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Offline tuner for the collective components.
+ *
+ * For every collective, communicator size and message size the tuner
+ * times each algorithm of coll/tuned (and each segment size / fanout of
+ * the sweep the algorithm reads), keeps the fastest one with a 95%
+ * confidence bound, and writes the result as a coll/tuned dynamic rule
+ * file. It then times the components HAN can pick from on the
+ * node-local communicators (and on the global communicator when the job
+ * spans several nodes) and writes a coll/han dynamic rule file.
+ *
+ * Algorithms and their identifiers are read through MPI_T from the
+ * coll_tuned_<coll>_algorithm control variables, so the sweep always
+ * matches the algorithms compiled in coll/tuned. The forced values are
+ * only read when a communicator is created, hence every configuration
+ * is timed on a fresh duplicate whose coll_preference puts the timed
+ * component first.
+ *
+ * Typical use, on a single node:
+ *   mpirun -n 16 --mca btl sm,self ompi_coll_autotune -o tuned.rules -H han.rules
+ * and then
+ *   --mca coll_tuned_use_dynamic_rules 1 --mca coll_tuned_dynamic_rules_filename tuned.rules
+ *   --mca coll_han_use_dynamic_file_rules 1 --mca coll_han_dynamic_rules_filename han.rules
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <stdbool.h>
+
+#include <mpi.h>
+
+#define AT_MAX_LIST      64
+#define AT_MAX_NAME      256
+#define AT_MAX_ALGS      64
+
+typedef enum {
+    AT_ALLGATHER,
+    AT_ALLREDUCE,
+    AT_ALLTOALL,
+    AT_BARRIER,
+    AT_BCAST,
+    AT_GATHER,
+    AT_REDUCE,
+    AT_REDUCE_SCATTER,
+    AT_REDUCE_SCATTER_BLOCK,
+    AT_SCATTER,
+    AT_NCOLLS
+} at_coll_t;
+
+typedef struct {
+    const char *name;
+    /* COLLTYPE_T identifier, as expected in the rule files */
+    int colltype;
+    /* the tuned decision sizes the message over the whole communicator */
+    bool per_comm;
+    /* HAN has a dynamic selection for this collective */
+    bool han;
+    bool reduction;
+} at_coll_desc_t;
+
+static const at_coll_desc_t at_colls[AT_NCOLLS] = {
+    [AT_ALLGATHER]            = {"allgather",             0, true,  true,  false},
+    [AT_ALLREDUCE]            = {"allreduce",             2, false, true,  true},
+    [AT_ALLTOALL]             = {"alltoall",              3, true,  true,  false},
+    [AT_BARRIER]              = {"barrier",               6, false, true,  false},
+    [AT_BCAST]                = {"bcast",                 7, false, true,  false},
+    [AT_GATHER]               = {"gather",                9, true,  true,  false},
+    [AT_REDUCE]               = {"reduce",               11, false, true,  true},
+    [AT_REDUCE_SCATTER]       = {"reduce_scatter",       12, true,  false, true},
+    [AT_REDUCE_SCATTER_BLOCK] = {"reduce_scatter_block", 13, true,  false, true},
+    [AT_SCATTER]              = {"scatter",              15, true,  true,  false},
+};
+
+/* components HAN knows how to select, with the collectives they implement */
+typedef struct {
+    const char *name;
+    unsigned colls;
+} at_han_component_t;
+
+#define AT_BIT(c) (1u << (c))
+#define AT_ALL_COLLS ((1u << AT_NCOLLS) - 1)
+
+static const at_han_component_t at_han_components[] = {
+    {"tuned", AT_ALL_COLLS},
+    {"basic", AT_ALL_COLLS},
+    {"adapt", AT_BIT(AT_BCAST) | AT_BIT(AT_REDUCE)},
+    {"xhc",   AT_BIT(AT_ALLREDUCE) | AT_BIT(AT_BARRIER) | AT_BIT(AT_BCAST) | AT_BIT(AT_REDUCE)},
+};
+#define AT_NHAN_COMPONENTS ((int) (sizeof(at_han_components) / sizeof(at_han_components[0])))
+
+/*
+ * The tuned parameters each algorithm reads, keyed by its enumerator
+ * name. Only these are swept: the others would time the same algorithm
+ * again and could end up as rules that differ only by a value nobody
+ * reads. Algorithms missing from the table are timed once with their
+ * defaults.
+ */
+#define AT_SEGSIZE 0x1
+#define AT_FANOUT  0x2
+
+typedef struct {
+    at_coll_t coll;
+    const char *alg;
+    unsigned params;
+} at_alg_params_t;
+
+static const at_alg_params_t at_alg_params[] = {
+    {AT_ALLGATHER, "bruck-k-fanout",         AT_FANOUT},
+    {AT_ALLREDUCE, "segmented_ring",         AT_SEGSIZE},
+    {AT_ALLREDUCE, "recursive_multiplying",  AT_FANOUT},
+    {AT_ALLREDUCE, "knomial_rabenseifner",   AT_FANOUT},
+    {AT_ALLREDUCE, "tree_pipelined",         AT_SEGSIZE},
+    {AT_BCAST,     "chain",                  AT_SEGSIZE | AT_FANOUT},
+    {AT_BCAST,     "pipeline",               AT_SEGSIZE},
+    {AT_BCAST,     "split_binary_tree",      AT_SEGSIZE},
+    {AT_BCAST,     "binary_tree",            AT_SEGSIZE},
+    {AT_BCAST,     "binomial",               AT_SEGSIZE},
+    {AT_BCAST,     "knomial",                AT_SEGSIZE},
+    {AT_BCAST,     "scatter_allgather",      AT_SEGSIZE},
+    {AT_BCAST,     "scatter_allgather_ring", AT_SEGSIZE},
+    {AT_GATHER,    "linear_sync",            AT_SEGSIZE},
+    {AT_REDUCE,    "chain",                  AT_SEGSIZE | AT_FANOUT},
+    {AT_REDUCE,    "pipeline",               AT_SEGSIZE},
+    {AT_REDUCE,    "binary",                 AT_SEGSIZE},
+    {AT_REDUCE,    "binomial",               AT_SEGSIZE},
+    {AT_REDUCE,    "in-order_binary",        AT_SEGSIZE},
+    {AT_REDUCE,    "knomial",                AT_SEGSIZE | AT_FANOUT},
+};
+#define AT_NALG_PARAMS ((int) (sizeof(at_alg_params) / sizeof(at_alg_params[0])))
+
+/* one point of the sweep: a tuned algorithm with its parameters, or a
+ * component; for the algorithms component only labels the output */
+typedef struct {
+    int alg;
+    int segsize;
+    int fanout;
+    const char *component;
+} at_config_t;
+
+/* timing of one configuration at one message size */
+typedef struct {
+    bool valid;
+    int n;
+    double mean;
+    /* half width of the 95% confidence interval */
+    double hw;
+} at_stat_t;
+
+typedef struct {
+    size_t msgsize;
+    int config;
+} at_rule_t;
+
+static struct {
+    unsigned colls;
+    size_t min_size, max_size;
+    int comm_sizes[AT_MAX_LIST], ncomm_sizes;
+    int segsizes[AT_MAX_LIST], nsegsizes;
+    int fanouts[AT_MAX_LIST], nfanouts;
+    int min_reps, max_reps, warmup;
+    double precision;
+    double min_sample;
+    const char *tuned_file;
+    const char *han_file;
+    bool verbose;
+} at_opts = {
+    .colls = AT_ALL_COLLS,
+    .min_size = 4,
+    .max_size = 1 << 20,
+    .segsizes = {0, 8192, 65536},
+    .nsegsizes = 3,
+    .fanouts = {2, 4},
+    .nfanouts = 2,
+    .min_reps = 8,
+    .max_reps = 100,
+    .warmup = 3,
+    .precision = 0.03,
+    .min_sample = 100e-6,
+    .tuned_file = "coll_tuned_rules.conf",
+    .han_file = "coll_han_rules.conf",
+};
+
+static int world_rank, world_size;
+
+static void *sbuf, *rbuf;
+static int *rcounts;
+
+/* two sided 95% Student quantiles, for 1 to 30 degrees of freedom */
+static const double at_t95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double at_quantile(int n)
+{
+    if (n < 2) {
+        return INFINITY;
+    }
+    return n - 1 <= 30 ? at_t95[n - 2] : 1.96;
+}
+
+static void at_stat_update(at_stat_t *stat, const double *samples, int n)
+{
+    double sum = 0.0, var = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    stat->mean = sum / n;
+    for (int i = 0; i < n; i++) {
+        var += (samples[i] - stat->mean) * (samples[i] - stat->mean);
+    }
+    var = n > 1 ? var / (n - 1) : 0.0;
+    stat->hw = at_quantile(n) * sqrt(var / n);
+    stat->n = n;
+    stat->valid = true;
+}
+
+/* a is faster than b beyond the noise of both measurements */
+static bool at_stat_better(const at_stat_t *a, const at_stat_t *b)
+{
+    return a->mean + a->hw < b->mean - b->hw;
+}
+
+/*
+ * MPI_T helpers
+ */
+
+static int at_cvar_index(const char *name)
+{
+    int index;
+
+    if (MPI_SUCCESS != MPI_T_cvar_get_index(name, &index)) {
+        return -1;
+    }
+    return index;
+}
+
+static int at_cvar_write_int(const char *name, int value)
+{
+    MPI_T_cvar_handle handle;
+    int index, count, ret;
+
+    index = at_cvar_index(name);
+    if (index < 0) {
+        return MPI_ERR_OTHER;
+    }
+    ret = MPI_T_cvar_handle_alloc(index, NULL, &handle, &count);
+    if (MPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = MPI_T_cvar_write(handle, &value);
+    MPI_T_cvar_handle_free(&handle);
+    return ret;
+}
+
+/*
+ * List the algorithms of a tuned collective from the enumerator of its
+ * coll_tuned_<coll>_algorithm variable. Value 0 ("ignore") is skipped.
+ */
+static int at_tuned_algorithms(at_coll_t coll, int *algs, char names[][AT_MAX_NAME])
+{
+    char cvar[AT_MAX_NAME], name[AT_MAX_NAME];
+    int index, verbosity, bind, scope, nitems, len, nalgs = 0;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+
+    snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm", at_colls[coll].name);
+    index = at_cvar_index(cvar);
+    if (index < 0) {
+        return 0;
+    }
+    len = sizeof(name);
+    if (MPI_SUCCESS != MPI_T_cvar_get_info(index, name, &len, &verbosity, &datatype, &enumtype,
+                                           NULL, NULL, &bind, &scope)
+        || MPI_T_ENUM_NULL == enumtype) {
+        return 0;
+    }
+    len = sizeof(name);
+    if (MPI_SUCCESS != MPI_T_enum_get_info(enumtype, &nitems, name, &len)) {
+        return 0;
+    }
+    for (int i = 0; i < nitems && nalgs < AT_MAX_ALGS; i++) {
+        int value;
+
+        len = AT_MAX_NAME;
+        if (MPI_SUCCESS != MPI_T_enum_get_item(enumtype, i, &value, names[nalgs], &len)
+            || 0 == value) {
+            continue;
+        }
+        algs[nalgs++] = value;
+    }
+    return nalgs;
+}
+
+static unsigned at_tuned_params(at_coll_t coll, const char *alg)
+{
+    for (int i = 0; i < AT_NALG_PARAMS; i++) {
+        if (coll == at_alg_params[i].coll && 0 == strcmp(alg, at_alg_params[i].alg)) {
+            return at_alg_params[i].params;
+        }
+    }
+    return 0;
+}
+
+static void at_tuned_force(at_coll_t coll, const at_config_t *config)
+{
+    char cvar[AT_MAX_NAME];
+    const char *name = at_colls[coll].name;
+
+    snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm", name);
+    at_cvar_write_int(cvar, config->alg);
+    snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm_segmentsize", name);
+    at_cvar_write_int(cvar, config->segsize);
+    if (config->fanout > 0) {
+        snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm_tree_fanout", name);
+        at_cvar_write_int(cvar, config->fanout);
+        snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm_chain_fanout", name);
+        at_cvar_write_int(cvar, config->fanout);
+    }
+}
+
+/* a duplicate of comm on which component is selected first */
+static MPI_Comm at_comm_for(MPI_Comm comm, const char *component)
+{
+    MPI_Comm newcomm;
+    MPI_Info info;
+
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "ompi_comm_coll_preference", component);
+    MPI_Comm_dup_with_info(comm, info, &newcomm);
+    MPI_Info_free(&info);
+    return newcomm;
+}
+
+/*
+ * Message sizes: bytes is the size of the per process block. The
+ * reductions move floats and are rounded to a whole number of them.
+ */
+static size_t at_count(at_coll_t coll, size_t bytes)
+{
+    if (at_colls[coll].reduction) {
+        size_t count = bytes / sizeof(float);
+        return count ? count : 1;
+    }
+    return bytes;
+}
+
+static size_t at_bytes(at_coll_t coll, size_t bytes)
+{
+    return at_count(coll, bytes) * (at_colls[coll].reduction ? sizeof(float) : 1);
+}
+
+/* the message size the tuned decision compares against its rules */
+static size_t at_tuned_msgsize(at_coll_t coll, size_t bytes, int comm_size)
+{
+    if (AT_BARRIER == coll) {
+        return 0;
+    }
+    return at_bytes(coll, bytes) * (at_colls[coll].per_comm ? (size_t) comm_size : 1);
+}
+
+static void at_run(at_coll_t coll, MPI_Comm comm, size_t bytes)
+{
+    size_t count = at_count(coll, bytes);
+    int size;
+
+    switch (coll) {
+    case AT_ALLGATHER:
+        MPI_Allgather(sbuf, (int) count, MPI_BYTE, rbuf, (int) count, MPI_BYTE, comm);
+        break;
+    case AT_ALLREDUCE:
+        MPI_Allreduce(sbuf, rbuf, (int) count, MPI_FLOAT, MPI_SUM, comm);
+        break;
+    case AT_ALLTOALL:
+        MPI_Alltoall(sbuf, (int) count, MPI_BYTE, rbuf, (int) count, MPI_BYTE, comm);
+        break;
+    case AT_BARRIER:
+        MPI_Barrier(comm);
+        break;
+    case AT_BCAST:
+        MPI_Bcast(sbuf, (int) count, MPI_BYTE, 0, comm);
+        break;
+    case AT_GATHER:
+        MPI_Gather(sbuf, (int) count, MPI_BYTE, rbuf, (int) count, MPI_BYTE, 0, comm);
+        break;
+    case AT_REDUCE:
+        MPI_Reduce(sbuf, rbuf, (int) count, MPI_FLOAT, MPI_SUM, 0, comm);
+        break;
+    case AT_REDUCE_SCATTER:
+        MPI_Comm_size(comm, &size);
+        for (int i = 0; i < size; i++) {
+            rcounts[i] = (int) count;
+        }
+        MPI_Reduce_scatter(sbuf, rbuf, rcounts, MPI_FLOAT, MPI_SUM, comm);
+        break;
+    case AT_REDUCE_SCATTER_BLOCK:
+        MPI_Reduce_scatter_block(sbuf, rbuf, (int) count, MPI_FLOAT, MPI_SUM, comm);
+        break;
+    case AT_SCATTER:
+        MPI_Scatter(sbuf, (int) count, MPI_BYTE, rbuf, (int) count, MPI_BYTE, 0, comm);
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * Time one collective on comm. Each sample is the slowest process of a
+ * batch of calls long enough for the clock resolution; samples are
+ * taken until the confidence interval is within the requested
+ * precision, or until the configuration is known to lose against best.
+ * All the synchronization goes through parent, whose collectives are
+ * not affected by the forced algorithm.
+ */
+static void at_measure(at_coll_t coll, MPI_Comm comm, MPI_Comm parent, size_t bytes,
+                       const at_stat_t *best, at_stat_t *stat)
+{
+    double samples[at_opts.max_reps], t0, t, tmax;
+    int iters, n;
+
+    for (int i = 0; i < at_opts.warmup; i++) {
+        at_run(coll, comm, bytes);
+    }
+
+    /* batch size, agreed on by all the processes */
+    MPI_Barrier(parent);
+    t0 = MPI_Wtime();
+    at_run(coll, comm, bytes);
+    t = MPI_Wtime() - t0;
+    MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, parent);
+    iters = tmax >= at_opts.min_sample ? 1 : (int) ceil(at_opts.min_sample / (tmax > 0 ? tmax : 1e-9));
+    if (iters > 1000) {
+        iters = 1000;
+    }
+
+    for (n = 0; n < at_opts.max_reps; ) {
+        MPI_Barrier(parent);
+        t0 = MPI_Wtime();
+        for (int i = 0; i < iters; i++) {
+            at_run(coll, comm, bytes);
+        }
+        t = (MPI_Wtime() - t0) / iters;
+        /* every process gets the same samples, hence takes the same decisions */
+        MPI_Allreduce(&t, &samples[n++], 1, MPI_DOUBLE, MPI_MAX, parent);
+        if (n < at_opts.min_reps) {
+            continue;
+        }
+        at_stat_update(stat, samples, n);
+        if (stat->hw <= at_opts.precision * stat->mean) {
+            break;
+        }
+        if (NULL != best && best->valid && at_stat_better(best, stat)) {
+            break;
+        }
+    }
+}
+
+/*
+ * Turn the timings of a communicator size into message size rules. A
+ * new rule is only opened when the winner is faster than the current
+ * rule beyond the confidence intervals, which keeps the files short
+ * and stable against noise.
+ */
+static int at_make_rules(int nconfigs, int nsizes, at_stat_t stats[nconfigs][nsizes],
+                         at_rule_t *rules)
+{
+    int nrules = 0;
+
+    for (int m = 0; m < nsizes; m++) {
+        int best = -1;
+
+        for (int c = 0; c < nconfigs; c++) {
+            if (stats[c][m].valid && (best < 0 || stats[c][m].mean < stats[best][m].mean)) {
+                best = c;
+            }
+        }
+        if (best < 0) {
+            continue;
+        }
+        if (nrules > 0) {
+            at_stat_t *current = &stats[rules[nrules - 1].config][m];
+            if (current->valid && !at_stat_better(&stats[best][m], current)) {
+                continue;
+            }
+        }
+        rules[nrules].msgsize = m;
+        rules[nrules].config = best;
+        nrules++;
+    }
+    return nrules;
+}
+
+/*
+ * Output. Only world rank 0 writes; rules are kept in a text buffer per
+ * collective until the counts of the enclosing levels are known.
+ */
+typedef struct {
+    char *text;
+    size_t len, size;
+    int nentries;
+} at_buf_t;
+
+static void at_printf(at_buf_t *buf, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void at_printf(at_buf_t *buf, const char *fmt, ...)
+{
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (buf->len + len + 1 > buf->size) {
+        buf->size = (buf->len + len + 1) * 2;
+        buf->text = realloc(buf->text, buf->size);
+    }
+    va_start(ap, fmt);
+    vsnprintf(buf->text + buf->len, len + 1, fmt, ap);
+    va_end(ap);
+    buf->len += len;
+}
+
+static at_buf_t tuned_out[AT_NCOLLS];
+static at_buf_t han_intra_out[AT_NCOLLS], han_global_out[AT_NCOLLS];
+
+static void at_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void at_log(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (0 != world_rank || !at_opts.verbose) {
+        return;
+    }
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+}
+
+static int at_nsizes(at_coll_t coll)
+{
+    int n = 0;
+
+    if (AT_BARRIER == coll) {
+        return 1;
+    }
+    for (size_t bytes = at_opts.min_size; bytes <= at_opts.max_size; bytes *= 2) {
+        n++;
+    }
+    return n;
+}
+
+static size_t at_size(int m)
+{
+    return at_opts.min_size << m;
+}
+
+/*
+ * Sweep the algorithms of tuned for one collective on comm (the first
+ * comm_size processes of the world).
+ */
+static void at_tune_tuned(at_coll_t coll, MPI_Comm comm, int comm_size)
+{
+    int algs[AT_MAX_ALGS], nalgs, nsizes = at_nsizes(coll), nconfigs = 0, nrules;
+    char names[AT_MAX_ALGS][AT_MAX_NAME];
+    at_config_t *configs;
+
+    nalgs = at_tuned_algorithms(coll, algs, names);
+    if (0 == nalgs) {
+        return;
+    }
+    configs = calloc((size_t) nalgs * at_opts.nsegsizes * at_opts.nfanouts, sizeof(*configs));
+    for (int a = 0; a < nalgs; a++) {
+        unsigned params = at_tuned_params(coll, names[a]);
+        int nsegsizes = (params & AT_SEGSIZE) ? at_opts.nsegsizes : 1;
+        int nfanouts = (params & AT_FANOUT) ? at_opts.nfanouts : 1;
+
+        for (int s = 0; s < nsegsizes; s++) {
+            for (int f = 0; f < nfanouts; f++) {
+                configs[nconfigs++] = (at_config_t) {
+                    .alg = algs[a],
+                    .segsize = (params & AT_SEGSIZE) ? at_opts.segsizes[s] : 0,
+                    .fanout = (params & AT_FANOUT) ? at_opts.fanouts[f] : 0,
+                    .component = names[a]
+                };
+            }
+        }
+    }
+
+    at_stat_t (*stats)[nsizes] = calloc((size_t) nconfigs, sizeof(*stats));
+    at_stat_t *best = calloc((size_t) nsizes, sizeof(*best));
+    at_rule_t *rules = calloc((size_t) nsizes, sizeof(*rules));
+
+    for (int c = 0; c < nconfigs; c++) {
+        MPI_Comm tcomm;
+
+        at_tuned_force(coll, &configs[c]);
+        tcomm = at_comm_for(comm, "tuned");
+        for (int m = 0; m < nsizes; m++) {
+            size_t bytes = at_size(m);
+
+            /* a segment larger than the message is the unsegmented algorithm */
+            if (configs[c].segsize > 0 && (size_t) configs[c].segsize >= at_bytes(coll, bytes)) {
+                continue;
+            }
+            at_measure(coll, tcomm, comm, bytes, &best[m], &stats[c][m]);
+            if (!best[m].valid || stats[c][m].mean < best[m].mean) {
+                best[m] = stats[c][m];
+            }
+            at_log("%s np=%d %zu bytes alg=%d (%s) seg=%d fanout=%d: %.3f us +- %.3f (%d)\n",
+                   at_colls[coll].name, comm_size, at_bytes(coll, bytes), configs[c].alg,
+                   configs[c].component, configs[c].segsize, configs[c].fanout,
+                   stats[c][m].mean * 1e6, stats[c][m].hw * 1e6, stats[c][m].n);
+        }
+        MPI_Comm_free(&tcomm);
+    }
+    at_tuned_force(coll, &(at_config_t) {.alg = 0, .segsize = 0, .fanout = 0});
+
+    nrules = at_make_rules(nconfigs, nsizes, stats, rules);
+    if (0 == world_rank && nrules > 0) {
+        at_buf_t *out = &tuned_out[coll];
+
+        at_printf(out, "%d # comm size\n%d # number of message sizes\n", comm_size, nrules);
+        for (int r = 0; r < nrules; r++) {
+            at_config_t *config = &configs[rules[r].config];
+            at_printf(out, "%zu %d %d %d # %zu bytes\n",
+                      r ? at_tuned_msgsize(coll, at_size(rules[r].msgsize), comm_size) : 0,
+                      config->alg, config->fanout, config->segsize,
+                      at_bytes(coll, at_size(rules[r].msgsize)));
+        }
+        out->nentries++;
+    }
+
+    free(rules);
+    free(best);
+    free(stats);
+    free(configs);
+}
+
+/* is component loaded in this process */
+static bool at_component_available(const char *component)
+{
+    char cvar[AT_MAX_NAME];
+
+    snprintf(cvar, sizeof(cvar), "coll_%s_priority", component);
+    return at_cvar_index(cvar) >= 0;
+}
+
+/*
+ * Time the components HAN may select on comm, and record the rules for
+ * the given HAN topological level.
+ */
+static void at_tune_han(at_coll_t coll, MPI_Comm comm, int conf_size, const char **candidates,
+                        int ncandidates, at_buf_t *out)
+{
+    int nsizes = at_nsizes(coll), nrules;
+    at_config_t configs[AT_NHAN_COMPONENTS + 1];
+    at_stat_t (*stats)[nsizes] = calloc((size_t) ncandidates, sizeof(*stats));
+    at_stat_t *best = calloc((size_t) nsizes, sizeof(*best));
+    at_rule_t *rules = calloc((size_t) nsizes, sizeof(*rules));
+
+    for (int c = 0; c < ncandidates; c++) {
+        MPI_Comm tcomm = at_comm_for(comm, candidates[c]);
+
+        configs[c] = (at_config_t) {.component = candidates[c]};
+        for (int m = 0; m < nsizes; m++) {
+            at_measure(coll, tcomm, comm, at_size(m), &best[m], &stats[c][m]);
+            if (!best[m].valid || stats[c][m].mean < best[m].mean) {
+                best[m] = stats[c][m];
+            }
+            at_log("%s np=%d %zu bytes %s: %.3f us +- %.3f (%d)\n", at_colls[coll].name,
+                   conf_size, at_bytes(coll, at_size(m)), candidates[c], stats[c][m].mean * 1e6,
+                   stats[c][m].hw * 1e6, stats[c][m].n);
+        }
+        MPI_Comm_free(&tcomm);
+    }
+
+    nrules = at_make_rules(ncandidates, nsizes, stats, rules);
+    if (0 == world_rank && nrules > 0) {
+        at_printf(out, "%d # configuration size\n%d # number of message sizes\n", conf_size, nrules);
+        for (int r = 0; r < nrules; r++) {
+            /* HAN compares the per process block, except for the reductions */
+            at_printf(out, "%zu %s\n", r ? at_bytes(coll, at_size(rules[r].msgsize)) : 0,
+                      configs[rules[r].config].component);
+        }
+        out->nentries++;
+    }
+
+    free(rules);
+    free(best);
+    free(stats);
+}
+
+static int at_han_candidates(at_coll_t coll, const char **candidates)
+{
+    int n = 0;
+
+    for (int i = 0; i < AT_NHAN_COMPONENTS; i++) {
+        if ((at_han_components[i].colls & AT_BIT(coll))
+            && at_component_available(at_han_components[i].name)) {
+            candidates[n++] = at_han_components[i].name;
+        }
+    }
+    return n;
+}
+
+/* the communicator sizes of the sweep, bounded by max */
+static int at_comm_sizes(int max, int *sizes)
+{
+    int n = 0;
+
+    if (at_opts.ncomm_sizes > 0) {
+        for (int i = 0; i < at_opts.ncomm_sizes; i++) {
+            if (at_opts.comm_sizes[i] >= 2 && at_opts.comm_sizes[i] <= max) {
+                sizes[n++] = at_opts.comm_sizes[i];
+            }
+        }
+        return n;
+    }
+    for (int s = 2; s < max && n < AT_MAX_LIST - 1; s *= 2) {
+        sizes[n++] = s;
+    }
+    if (max >= 2) {
+        sizes[n++] = max;
+    }
+    return n;
+}
+
+static void at_write_rules(void)
+{
+    FILE *fp;
+    int ncolls = 0;
+
+    if (NULL != at_opts.tuned_file && NULL != (fp = fopen(at_opts.tuned_file, "w"))) {
+        for (int c = 0; c < AT_NCOLLS; c++) {
+            ncolls += tuned_out[c].nentries > 0;
+        }
+        fprintf(fp, "rule-file-version-2\n# generated by ompi_coll_autotune on %d processes\n",
+                world_size);
+        fprintf(fp, "%d # number of collectives\n", ncolls);
+        for (int c = 0; c < AT_NCOLLS; c++) {
+            if (0 == tuned_out[c].nentries) {
+                continue;
+            }
+            fprintf(fp, "%d # %s\n%d # number of comm sizes\n%s", at_colls[c].colltype,
+                    at_colls[c].name, tuned_out[c].nentries, tuned_out[c].text);
+        }
+        fclose(fp);
+    } else if (NULL != at_opts.tuned_file) {
+        fprintf(stderr, "ompi_coll_autotune: cannot write %s\n", at_opts.tuned_file);
+    }
+
+    if (NULL != at_opts.han_file && NULL != (fp = fopen(at_opts.han_file, "w"))) {
+        ncolls = 0;
+        for (int c = 0; c < AT_NCOLLS; c++) {
+            ncolls += (han_intra_out[c].nentries + han_global_out[c].nentries) > 0;
+        }
+        fprintf(fp, "# generated by ompi_coll_autotune on %d processes\n", world_size);
+        fprintf(fp, "%d # number of collectives\n", ncolls);
+        for (int c = 0; c < AT_NCOLLS; c++) {
+            int nlevels = (han_intra_out[c].nentries > 0) + (han_global_out[c].nentries > 0);
+
+            if (0 == nlevels) {
+                continue;
+            }
+            fprintf(fp, "%s\n%d # number of topological levels\n", at_colls[c].name, nlevels);
+            if (han_intra_out[c].nentries > 0) {
+                fprintf(fp, "intra_node\n%d # number of configurations\n%s",
+                        han_intra_out[c].nentries, han_intra_out[c].text);
+            }
+            if (han_global_out[c].nentries > 0) {
+                fprintf(fp, "global_communicator\n%d # number of configurations\n%s",
+                        han_global_out[c].nentries, han_global_out[c].text);
+            }
+        }
+        fclose(fp);
+    } else if (NULL != at_opts.han_file) {
+        fprintf(stderr, "ompi_coll_autotune: cannot write %s\n", at_opts.han_file);
+    }
+}
+
+/*
+ * HAN rules must start with a configuration of size 1; on a single
+ * process there is nothing to choose, the first candidate is as good as
+ * any other.
+ */
+static void at_han_seed(at_coll_t coll, const char *component, at_buf_t *out)
+{
+    if (0 == world_rank) {
+        at_printf(out, "1 # configuration size\n1 # number of message sizes\n0 %s\n", component);
+        out->nentries++;
+    }
+}
+
+static void at_tune(void)
+{
+    int sizes[AT_MAX_LIST], nsizes, node_rank, node_size, node_first, on_first_node, nnodes;
+    size_t maxbuf;
+    MPI_Comm node;
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+    MPI_Comm_rank(node, &node_rank);
+    MPI_Comm_size(node, &node_size);
+    MPI_Allreduce(&world_rank, &node_first, 1, MPI_INT, MPI_MIN, node);
+    on_first_node = 0 == node_first;
+    nnodes = 0 == node_rank;
+    MPI_Allreduce(MPI_IN_PLACE, &nnodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+    maxbuf = (at_opts.max_size + sizeof(float)) * (size_t) world_size;
+    sbuf = calloc(1, maxbuf);
+    rbuf = calloc(1, maxbuf);
+    rcounts = calloc((size_t) world_size, sizeof(int));
+
+    at_log("tuning on %d processes, %d node(s)\n", world_size, nnodes);
+
+    /* coll/tuned, on the first processes of the world */
+    at_cvar_write_int("coll_tuned_use_dynamic_rules", 1);
+    nsizes = at_comm_sizes(world_size, sizes);
+    for (int c = 0; c < AT_NCOLLS; c++) {
+        if (!(at_opts.colls & AT_BIT(c))) {
+            continue;
+        }
+        for (int s = 0; s < nsizes; s++) {
+            MPI_Comm comm;
+
+            MPI_Comm_split(MPI_COMM_WORLD, world_rank < sizes[s] ? 0 : MPI_UNDEFINED, world_rank,
+                           &comm);
+            if (MPI_COMM_NULL != comm) {
+                at_tune_tuned(c, comm, sizes[s]);
+                MPI_Comm_free(&comm);
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
+
+    if (NULL == at_opts.han_file) {
+        goto out;
+    }
+
+    /* coll/han, intra_node level, measured on the node of world rank 0 */
+    MPI_Bcast(&node_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    nsizes = at_comm_sizes(node_size, sizes);
+    for (int c = 0; c < AT_NCOLLS; c++) {
+        const char *candidates[AT_NHAN_COMPONENTS];
+        int ncandidates;
+
+        if (!(at_opts.colls & AT_BIT(c)) || !at_colls[c].han) {
+            continue;
+        }
+        ncandidates = at_han_candidates(c, candidates);
+        if (0 == ncandidates) {
+            continue;
+        }
+        at_han_seed(c, candidates[0], &han_intra_out[c]);
+        for (int s = 0; s < nsizes; s++) {
+            MPI_Comm comm;
+
+            MPI_Comm_split(MPI_COMM_WORLD, on_first_node && node_rank < sizes[s] ? 0 : MPI_UNDEFINED,
+                           world_rank, &comm);
+            if (MPI_COMM_NULL != comm) {
+                at_tune_han(c, comm, sizes[s], candidates, ncandidates, &han_intra_out[c]);
+                MPI_Comm_free(&comm);
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
+
+    /* coll/han against a flat algorithm on the whole communicator, when
+     * there is more than one node to span */
+    if (nnodes > 1 && at_component_available("han")) {
+        const char *candidates[2] = {"han", "tuned"};
+
+        nsizes = at_comm_sizes(world_size, sizes);
+        for (int c = 0; c < AT_NCOLLS; c++) {
+            if (!(at_opts.colls & AT_BIT(c)) || !at_colls[c].han) {
+                continue;
+            }
+            at_han_seed(c, "tuned", &han_global_out[c]);
+            for (int s = 0; s < nsizes; s++) {
+                MPI_Comm comm, local;
+                int local_size, spans;
+
+                MPI_Comm_split(MPI_COMM_WORLD, world_rank < sizes[s] ? 0 : MPI_UNDEFINED,
+                               world_rank, &comm);
+                if (MPI_COMM_NULL != comm) {
+                    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &local);
+                    MPI_Comm_size(local, &local_size);
+                    MPI_Comm_free(&local);
+                    spans = local_size < sizes[s];
+                    MPI_Allreduce(MPI_IN_PLACE, &spans, 1, MPI_INT, MPI_LOR, comm);
+                    if (spans) {
+                        at_tune_han(c, comm, sizes[s], candidates, 2, &han_global_out[c]);
+                    }
+                    MPI_Comm_free(&comm);
+                }
+                MPI_Barrier(MPI_COMM_WORLD);
+            }
+        }
+    }
+
+  out:
+    if (0 == world_rank) {
+        at_write_rules();
+    }
+    MPI_Comm_free(&node);
+    free(rcounts);
+    free(rbuf);
+    free(sbuf);
+}
+
+/*
+ * Command line
+ */
+
+static int at_parse_list(const char *arg, int *list)
+{
+    char *copy = strdup(arg), *save = NULL, *tok;
+    int n = 0;
+
+    for (tok = strtok_r(copy, ",", &save); NULL != tok && n < AT_MAX_LIST;
+         tok = strtok_r(NULL, ",", &save)) {
+        list[n++] = (int) strtol(tok, NULL, 0);
+    }
+    free(copy);
+    return n;
+}
+
+static int at_parse_colls(const char *arg, unsigned *colls)
+{
+    char *copy = strdup(arg), *save = NULL, *tok;
+    int ret = 0;
+
+    *colls = 0;
+    for (tok = strtok_r(copy, ",", &save); NULL != tok; tok = strtok_r(NULL, ",", &save)) {
+        int c;
+
+        for (c = 0; c < AT_NCOLLS && 0 != strcmp(tok, at_colls[c].name); c++) {
+        }
+        if (AT_NCOLLS == c) {
+            if (0 == world_rank) {
+                fprintf(stderr, "ompi_coll_autotune: unknown collective %s\n", tok);
+            }
+            ret = -1;
+            break;
+        }
+        *colls |= AT_BIT(c);
+    }
+    free(copy);
+    return ret;
+}
+
+static void at_usage(void)
+{
+    if (0 != world_rank) {
+        return;
+    }
+    fprintf(stderr,
+            "Usage: ompi_coll_autotune [options]\n"
+            "  -c, --collectives LIST  collectives to tune (default: all of\n"
+            "                          allgather,allreduce,alltoall,barrier,bcast,gather,\n"
+            "                          reduce,reduce_scatter,reduce_scatter_block,scatter)\n"
+            "  -m, --min-size BYTES    smallest per process message (default %zu)\n"
+            "  -M, --max-size BYTES    largest per process message (default %zu)\n"
+            "  -n, --comm-sizes LIST   communicator sizes (default: powers of two and the world size)\n"
+            "  -s, --segsizes LIST     segment sizes swept for the segmented algorithms\n"
+            "                          (default 0,8192,65536)\n"
+            "  -f, --fanouts LIST      fanouts swept for the tree and chain algorithms (default 2,4)\n"
+            "  -r, --min-reps N        samples taken before testing the confidence (default %d)\n"
+            "  -R, --max-reps N        samples taken at most per measurement (default %d)\n"
+            "  -p, --precision X       relative half width of the 95%% confidence interval\n"
+            "                          to reach before stopping (default %g)\n"
+            "  -o, --output FILE       coll/tuned rule file (default %s)\n"
+            "  -H, --han-output FILE   coll/han rule file (default %s), \"none\" to skip HAN\n"
+            "  -v, --verbose           print every measurement\n"
+            "  -h, --help              this message\n",
+            at_opts.min_size, at_opts.max_size, at_opts.min_reps, at_opts.max_reps,
+            at_opts.precision, at_opts.tuned_file, at_opts.han_file);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        {"collectives", required_argument, NULL, 'c'},
+        {"min-size",    required_argument, NULL, 'm'},
+        {"max-size",    required_argument, NULL, 'M'},
+        {"comm-sizes",  required_argument, NULL, 'n'},
+        {"segsizes",    required_argument, NULL, 's'},
+        {"fanouts",     required_argument, NULL, 'f'},
+        {"min-reps",    required_argument, NULL, 'r'},
+        {"max-reps",    required_argument, NULL, 'R'},
+        {"precision",   required_argument, NULL, 'p'},
+        {"output",      required_argument, NULL, 'o'},
+        {"han-output",  required_argument, NULL, 'H'},
+        {"verbose",     no_argument,       NULL, 'v'},
+        {"help",        no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int provided, opt, ret = 0;
+
+    MPI_Init(&argc, &argv);
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    while (-1 != (opt = getopt_long(argc, argv, "c:m:M:n:s:f:r:R:p:o:H:vh", longopts, NULL))) {
+        switch (opt) {
+        case 'c':
+            if (at_parse_colls(optarg, &at_opts.colls) < 0) {
+                ret = 1;
+            }
+            break;
+        case 'm':
+            at_opts.min_size = strtoul(optarg, NULL, 0);
+            break;
+        case 'M':
+            at_opts.max_size = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            at_opts.ncomm_sizes = at_parse_list(optarg, at_opts.comm_sizes);
+            break;
+        case 's':
+            at_opts.nsegsizes = at_parse_list(optarg, at_opts.segsizes);
+            break;
+        case 'f':
+            at_opts.nfanouts = at_parse_list(optarg, at_opts.fanouts);
+            break;
+        case 'r':
+            at_opts.min_reps = atoi(optarg);
+            break;
+        case 'R':
+            at_opts.max_reps = atoi(optarg);
+            break;
+        case 'p':
+            at_opts.precision = atof(optarg);
+            break;
+        case 'o':
+            at_opts.tuned_file = optarg;
+            break;
+        case 'H':
+            at_opts.han_file = 0 == strcmp(optarg, "none") ? NULL : optarg;
+            break;
+        case 'v':
+            at_opts.verbose = true;
+            break;
+        case 'h':
+        default:
+            at_usage();
+            ret = 'h' == opt ? 0 : 1;
+            goto done;
+        }
+    }
+    if (0 == at_opts.min_size || at_opts.min_size > at_opts.max_size || at_opts.min_reps < 2
+        || at_opts.max_reps < at_opts.min_reps || 0 == at_opts.nsegsizes || 0 == at_opts.nfanouts) {
+        at_usage();
+        ret = 1;
+    }
+    if (0 == ret) {
+        at_tune();
+    }
+
+  done:
+    MPI_T_finalize();
+    MPI_Finalize();
+    return ret;
+}
@@ -140,9 +140,11 @@ struct opal_datatype_t {
                          all language interfaces (because Fortran is not known at the OPAL
                          layer). This field should never be initialized in homogeneous
                          environments */
+    struct opal_datatype_plan_t *plan; /**< compiled pack/unpack plan of the homogeneous case,
+                                            NULL if the layout is not one of the compiled ones */
     /* --- cacheline 5 boundary (320 bytes) was 32-36 bytes ago --- */
 
-    /* size: 352, cachelines: 6, members: 15 */
+    /* size: 360, cachelines: 6, members: 16 */
     /* last cacheline: 28-32 bytes */
 };
 
@@ -44,6 +44,7 @@ int32_t opal_datatype_clone(const opal_datatype_t *src_type, opal_datatype_t *de
 
     dest_type->flags &= (~OPAL_DATATYPE_FLAG_PREDEFINED);
     dest_type->ptypes = NULL;
+    dest_type->plan = NULL;
     dest_type->desc.desc = temp;
 
     /**
@@ -71,6 +72,9 @@ int32_t opal_datatype_clone(const opal_datatype_t *src_type, opal_datatype_t *de
             assert(0 == dest_type->opt_desc.length);
         }
     }
+    if (NULL != src_type->plan) {
+        (void) opal_datatype_plan_compile(dest_type);
+    }
     dest_type->id = src_type->id; /* preserve the default id. This allow us to
                                    * copy predefined types. */
     return OPAL_SUCCESS;
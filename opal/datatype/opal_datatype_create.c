@@ -54,6 +54,7 @@ static void opal_datatype_construct(opal_datatype_t *pData)
     pData->opt_desc.used = 0;
 
     pData->ptypes = NULL;
+    pData->plan = NULL;
     pData->loops = 0;
 }
 
@@ -79,6 +80,7 @@ static void opal_datatype_destruct(opal_datatype_t *datatype)
             datatype->desc.desc = NULL;
         }
     }
+    opal_datatype_plan_release(datatype);
     /* dont free the ptypes of predefined types (it was not dynamically allocated) */
     if ((NULL != datatype->ptypes) && (!opal_datatype_is_predefined(datatype))) {
         free(datatype->ptypes);
@@ -589,6 +589,21 @@ OPAL_DECLSPEC int opal_datatype_dump_data_flags(unsigned short usflags, char *pt
 OPAL_DECLSPEC int opal_datatype_dump_data_desc(union dt_elem_desc *pDesc, int nbElems, char *ptr,
                                                size_t length);
 
+/*
+ * Compiled pack/unpack plans (see opal_datatype_plan.c)
+ */
+typedef struct opal_datatype_plan_t opal_datatype_plan_t;
+
+extern bool opal_ddt_compiled_plans;
+
+/**
+ * Compile the plan of a committed datatype from its optimized description,
+ * if its layout is one of the compiled ones. Leaves pData->plan NULL
+ * otherwise.
+ */
+int32_t opal_datatype_plan_compile(opal_datatype_t *pData);
+void opal_datatype_plan_release(opal_datatype_t *pData);
+
 extern bool opal_ddt_position_debug;
 extern bool opal_ddt_copy_debug;
 extern bool opal_ddt_unpack_debug;
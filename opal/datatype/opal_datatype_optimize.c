@@ -342,5 +342,6 @@ int32_t opal_datatype_commit(opal_datatype_t *pData)
         pLast->first_elem_disp = first_elem_disp;
         pLast->size = pData->size;
     }
+    (void) opal_datatype_plan_compile(pData);
     return OPAL_SUCCESS;
 }
@@ -0,0 +1,479 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Compiled pack/unpack plans
+ *
+ * The generic pack and unpack functions walk the description of the
+ * datatype with a stack, one element at a time. For the common layouts
+ * of the optimized description, at most two loops around either a
+ * single strided element (vectors, 2D and 3D subarrays) or a list of
+ * elements with the same block size (indexed blocks), the datatype is
+ * turned at commit time into a plan: blocks of blen bytes, the innermost
+ * ones at a constant stride or at the displacements of a table, inside
+ * up to two outer strided dimensions. The blocks of a row are then
+ * copied by a loop specialized for their size, and the position in the
+ * data is recomputed from bConverted instead of being kept on the stack.
+ */
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+#include "opal/datatype/opal_convertor_internal.h"
+#include "opal/datatype/opal_datatype_internal.h"
+#include "opal/datatype/opal_datatype_prototypes.h"
+#include "opal/util/minmax.h"
+
+/* by default the common layouts get a compiled plan */
+bool opal_ddt_compiled_plans = true;
+
+/** maximum number of entries in the displacement table of a plan */
+#define OPAL_DATATYPE_PLAN_MAX_BLOCKS 4096
+/** maximum number of loops around the blocks of a row */
+#define OPAL_DATATYPE_PLAN_MAX_OUTER 2
+
+typedef void (*opal_datatype_plan_strided_fn_t)(unsigned char *dst, const unsigned char *src,
+                                                size_t n, ptrdiff_t stride, size_t blen);
+typedef void (*opal_datatype_plan_indexed_fn_t)(unsigned char *dst, const unsigned char *src,
+                                                const ptrdiff_t *displs, size_t n, size_t blen);
+
+typedef struct {
+    size_t blen; /**< block size the functions are specialized for (0: any) */
+    opal_datatype_plan_strided_fn_t pack_strided;
+    opal_datatype_plan_strided_fn_t unpack_strided;
+    opal_datatype_plan_indexed_fn_t pack_indexed;
+    opal_datatype_plan_indexed_fn_t unpack_indexed;
+} opal_datatype_plan_kernels_t;
+
+struct opal_datatype_plan_t {
+    size_t blen;            /**< size in bytes of each contiguous block */
+    size_t nblocks;         /**< number of blocks in one datatype element */
+    ptrdiff_t disp;         /**< displacement of the first block */
+    size_t inner_count;     /**< number of blocks in a row */
+    ptrdiff_t inner_stride; /**< distance between the blocks of a row if displs is NULL */
+    ptrdiff_t *displs;      /**< displacements of the blocks of a row from the first one */
+    uint32_t outer_dims;    /**< number of loops around the rows, innermost first */
+    size_t outer_count[OPAL_DATATYPE_PLAN_MAX_OUTER];
+    ptrdiff_t outer_stride[OPAL_DATATYPE_PLAN_MAX_OUTER];
+    const opal_datatype_plan_kernels_t *kernels;
+};
+
+/*
+ * Copy loops, unrolled 4 times. With a constant BLEN the memcpy are
+ * turned into plain loads and stores.
+ */
+#define OPAL_DATATYPE_PLAN_KERNELS(NAME, BLEN)                                                    \
+    static void opal_datatype_plan_pack_strided_##NAME(unsigned char *dst,                       \
+                                                       const unsigned char *src, size_t n,       \
+                                                       ptrdiff_t stride, size_t blen)            \
+    {                                                                                             \
+        size_t i = 0;                                                                             \
+        (void) blen;                                                                              \
+        for (; i + 4 <= n; i += 4, dst += 4 * (BLEN), src += 4 * stride) {                       \
+            memcpy(dst, src, (BLEN));                                                             \
+            memcpy(dst + (BLEN), src + stride, (BLEN));                                           \
+            memcpy(dst + 2 * (BLEN), src + 2 * stride, (BLEN));                                   \
+            memcpy(dst + 3 * (BLEN), src + 3 * stride, (BLEN));                                   \
+        }                                                                                         \
+        for (; i < n; i++, dst += (BLEN), src += stride) {                                        \
+            memcpy(dst, src, (BLEN));                                                             \
+        }                                                                                         \
+    }                                                                                             \
+    static void opal_datatype_plan_unpack_strided_##NAME(unsigned char *dst,                     \
+                                                         const unsigned char *src, size_t n,     \
+                                                         ptrdiff_t stride, size_t blen)          \
+    {                                                                                             \
+        size_t i = 0;                                                                             \
+        (void) blen;                                                                              \
+        for (; i + 4 <= n; i += 4, dst += 4 * stride, src += 4 * (BLEN)) {                       \
+            memcpy(dst, src, (BLEN));                                                             \
+            memcpy(dst + stride, src + (BLEN), (BLEN));                                           \
+            memcpy(dst + 2 * stride, src + 2 * (BLEN), (BLEN));                                   \
+            memcpy(dst + 3 * stride, src + 3 * (BLEN), (BLEN));                                   \
+        }                                                                                         \
+        for (; i < n; i++, dst += stride, src += (BLEN)) {                                        \
+            memcpy(dst, src, (BLEN));                                                             \
+        }                                                                                         \
+    }                                                                                             \
+    static void opal_datatype_plan_pack_indexed_##NAME(unsigned char *dst,                       \
+                                                       const unsigned char *src,                 \
+                                                       const ptrdiff_t *displs, size_t n,        \
+                                                       size_t blen)                              \
+    {                                                                                             \
+        size_t i = 0;                                                                             \
+        (void) blen;                                                                              \
+        for (; i + 4 <= n; i += 4, dst += 4 * (BLEN)) {                                           \
+            memcpy(dst, src + displs[i], (BLEN));                                                 \
+            memcpy(dst + (BLEN), src + displs[i + 1], (BLEN));                                    \
+            memcpy(dst + 2 * (BLEN), src + displs[i + 2], (BLEN));                                \
+            memcpy(dst + 3 * (BLEN), src + displs[i + 3], (BLEN));                                \
+        }                                                                                         \
+        for (; i < n; i++, dst += (BLEN)) {                                                       \
+            memcpy(dst, src + displs[i], (BLEN));                                                 \
+        }                                                                                         \
+    }                                                                                             \
+    static void opal_datatype_plan_unpack_indexed_##NAME(unsigned char *dst,                     \
+                                                         const unsigned char *src,               \
+                                                         const ptrdiff_t *displs, size_t n,      \
+                                                         size_t blen)                            \
+    {                                                                                             \
+        size_t i = 0;                                                                             \
+        (void) blen;                                                                              \
+        for (; i + 4 <= n; i += 4, src += 4 * (BLEN)) {                                           \
+            memcpy(dst + displs[i], src, (BLEN));                                                 \
+            memcpy(dst + displs[i + 1], src + (BLEN), (BLEN));                                    \
+            memcpy(dst + displs[i + 2], src + 2 * (BLEN), (BLEN));                                \
+            memcpy(dst + displs[i + 3], src + 3 * (BLEN), (BLEN));                                \
+        }                                                                                         \
+        for (; i < n; i++, src += (BLEN)) {                                                       \
+            memcpy(dst + displs[i], src, (BLEN));                                                 \
+        }                                                                                         \
+    }
+
+OPAL_DATATYPE_PLAN_KERNELS(4, 4)
+OPAL_DATATYPE_PLAN_KERNELS(8, 8)
+OPAL_DATATYPE_PLAN_KERNELS(16, 16)
+OPAL_DATATYPE_PLAN_KERNELS(32, 32)
+OPAL_DATATYPE_PLAN_KERNELS(64, 64)
+OPAL_DATATYPE_PLAN_KERNELS(any, blen)
+
+#if defined(__AVX2__)
+/*
+ * Strided 4 and 8 bytes blocks are packed 4 at a time with a gather. There
+ * is no AVX2 scatter, so the unpack side keeps the scalar loops.
+ */
+static void opal_datatype_plan_gather_4(unsigned char *dst, const unsigned char *src, size_t n,
+                                        ptrdiff_t stride, size_t blen)
+{
+    const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4, dst += 16, src += 4 * stride) {
+        __m128i v = _mm256_i64gather_epi32((const int *) src, offsets, 1);
+        _mm_storeu_si128((__m128i *) dst, v);
+    }
+    opal_datatype_plan_pack_strided_4(dst, src, n - i, stride, blen);
+}
+
+static void opal_datatype_plan_gather_8(unsigned char *dst, const unsigned char *src, size_t n,
+                                        ptrdiff_t stride, size_t blen)
+{
+    const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4, dst += 32, src += 4 * stride) {
+        __m256i v = _mm256_i64gather_epi64((const long long *) src, offsets, 1);
+        _mm256_storeu_si256((__m256i *) dst, v);
+    }
+    opal_datatype_plan_pack_strided_8(dst, src, n - i, stride, blen);
+}
+
+#    define OPAL_DATATYPE_PLAN_PACK_STRIDED_4 opal_datatype_plan_gather_4
+#    define OPAL_DATATYPE_PLAN_PACK_STRIDED_8 opal_datatype_plan_gather_8
+#else
+#    define OPAL_DATATYPE_PLAN_PACK_STRIDED_4 opal_datatype_plan_pack_strided_4
+#    define OPAL_DATATYPE_PLAN_PACK_STRIDED_8 opal_datatype_plan_pack_strided_8
+#endif /* defined(__AVX2__) */
+
+#define OPAL_DATATYPE_PLAN_KERNELS_ENTRY(NAME, BLEN, PACK_STRIDED)                  \
+    {                                                                               \
+        .blen = (BLEN), .pack_strided = PACK_STRIDED,                               \
+        .unpack_strided = opal_datatype_plan_unpack_strided_##NAME,                 \
+        .pack_indexed = opal_datatype_plan_pack_indexed_##NAME,                     \
+        .unpack_indexed = opal_datatype_plan_unpack_indexed_##NAME                  \
+    }
+
+/* the last entry matches any block size */
+static const opal_datatype_plan_kernels_t opal_datatype_plan_kernels[] = {
+    OPAL_DATATYPE_PLAN_KERNELS_ENTRY(4, 4, OPAL_DATATYPE_PLAN_PACK_STRIDED_4),
+    OPAL_DATATYPE_PLAN_KERNELS_ENTRY(8, 8, OPAL_DATATYPE_PLAN_PACK_STRIDED_8),
+    OPAL_DATATYPE_PLAN_KERNELS_ENTRY(16, 16, opal_datatype_plan_pack_strided_16),
+    OPAL_DATATYPE_PLAN_KERNELS_ENTRY(32, 32, opal_datatype_plan_pack_strided_32),
+    OPAL_DATATYPE_PLAN_KERNELS_ENTRY(64, 64, opal_datatype_plan_pack_strided_64),
+    OPAL_DATATYPE_PLAN_KERNELS_ENTRY(any, 0, opal_datatype_plan_pack_strided_any),
+};
+
+/*
+ * Strided dimensions of a plan being compiled, innermost first: drop the
+ * ones with a single iteration, fold the contiguous ones into the block
+ * size (unless blen is NULL) and merge the ones that continue each other.
+ * Returns the number of dimensions left.
+ */
+static uint32_t opal_datatype_plan_normalize(size_t *count, ptrdiff_t *stride, uint32_t ndims,
+                                             size_t *blen)
+{
+    uint32_t i, n = 0;
+
+    for (i = 0; i < ndims; i++) {
+        if (1 == count[i]) {
+            continue;
+        }
+        if (0 == n && NULL != blen && stride[i] == (ptrdiff_t) *blen) {
+            *blen *= count[i];
+            continue;
+        }
+        if (0 != n && stride[i] == (ptrdiff_t) count[n - 1] * stride[n - 1]) {
+            count[n - 1] *= count[i];
+            continue;
+        }
+        count[n] = count[i];
+        stride[n] = stride[i];
+        n++;
+    }
+    return n;
+}
+
+int32_t opal_datatype_plan_compile(opal_datatype_t *pData)
+{
+    const dt_elem_desc_t *desc = pData->opt_desc.desc;
+    size_t used = pData->opt_desc.used, blen, nblocks = 0, k;
+    size_t count[OPAL_DATATYPE_PLAN_MAX_OUTER + 1];
+    ptrdiff_t stride[OPAL_DATATYPE_PLAN_MAX_OUTER + 1];
+    uint32_t loops = 0, ndims = 0, first, last, i;
+    opal_datatype_plan_t *plan;
+    ptrdiff_t *displs = NULL;
+
+    if (!opal_ddt_compiled_plans || NULL != pData->plan
+        || (pData->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) || 0 == used || 0 == pData->size) {
+        return OPAL_SUCCESS;
+    }
+
+    /* The description must be LOOP^k ELEM+ END_LOOP^k with k <= 2 */
+    while (loops < used && OPAL_DATATYPE_LOOP == desc[loops].elem.common.type) {
+        loops++;
+    }
+    if (loops > OPAL_DATATYPE_PLAN_MAX_OUTER || used <= 2 * loops) {
+        return OPAL_SUCCESS;
+    }
+    first = loops;
+    last = used - loops;
+    for (i = last; i < used; i++) {
+        if (OPAL_DATATYPE_END_LOOP != desc[i].elem.common.type) {
+            return OPAL_SUCCESS;
+        }
+    }
+    blen = desc[first].elem.blocklen * opal_datatype_basicDatatypes[desc[first].elem.common.type]->size;
+    for (i = first; i < last; i++) {
+        const ddt_elem_desc_t *elem = &desc[i].elem;
+        if (!(elem->common.flags & OPAL_DATATYPE_FLAG_DATA)
+            || blen != elem->blocklen * opal_datatype_basicDatatypes[elem->common.type]->size) {
+            return OPAL_SUCCESS;
+        }
+        nblocks += elem->count;
+    }
+
+    if (1 == last - first) {
+        /* a single strided element */
+        count[0] = desc[first].elem.count;
+        stride[0] = desc[first].elem.extent;
+        ndims = 1;
+    } else {
+        /* elements with the same block size: build the displacement table,
+         * and use it only if the displacements are not equally spaced */
+        if (nblocks < 2 || nblocks > OPAL_DATATYPE_PLAN_MAX_BLOCKS) {
+            return OPAL_SUCCESS;
+        }
+        displs = (ptrdiff_t *) malloc(nblocks * sizeof(ptrdiff_t));
+        if (NULL == displs) {
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+        k = 0;
+        for (i = first; i < last; i++) {
+            for (size_t j = 0; j < desc[i].elem.count; j++) {
+                displs[k++] = desc[i].elem.disp + (ptrdiff_t) j * desc[i].elem.extent
+                              - desc[first].elem.disp;
+            }
+        }
+        for (k = 2; k < nblocks && displs[k] == (ptrdiff_t) k * displs[1]; k++) {
+        }
+        count[0] = nblocks;
+        stride[0] = displs[1];
+        if (k == nblocks) {
+            free(displs);
+            displs = NULL;
+        }
+        ndims = 1;
+    }
+    for (i = loops; i > 0; i--) {
+        count[ndims] = desc[i - 1].loop.loops;
+        stride[ndims] = desc[i - 1].loop.extent;
+        ndims++;
+    }
+
+    if (NULL == displs) {
+        ndims = opal_datatype_plan_normalize(count, stride, ndims, &blen);
+        if (0 == ndims) {
+            /* one contiguous block per element */
+            return OPAL_SUCCESS;
+        }
+    } else {
+        /* the table is the innermost dimension, keep it as is */
+        ndims = 1 + opal_datatype_plan_normalize(count + 1, stride + 1, ndims - 1, NULL);
+    }
+
+    plan = (opal_datatype_plan_t *) calloc(1, sizeof(opal_datatype_plan_t));
+    if (NULL == plan) {
+        free(displs);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    plan->blen = blen;
+    plan->disp = desc[first].elem.disp;
+    plan->inner_count = count[0];
+    plan->inner_stride = stride[0];
+    plan->displs = displs;
+    plan->outer_dims = ndims - 1;
+    plan->nblocks = count[0];
+    for (i = 1; i < ndims; i++) {
+        plan->outer_count[i - 1] = count[i];
+        plan->outer_stride[i - 1] = stride[i];
+        plan->nblocks *= count[i];
+    }
+    for (i = 0; 0 != opal_datatype_plan_kernels[i].blen && blen != opal_datatype_plan_kernels[i].blen;
+         i++) {
+    }
+    plan->kernels = &opal_datatype_plan_kernels[i];
+
+    if (plan->nblocks * plan->blen != pData->size) {
+        /* the description does not match this model */
+        free(plan->displs);
+        free(plan);
+        return OPAL_SUCCESS;
+    }
+    pData->plan = plan;
+    return OPAL_SUCCESS;
+}
+
+void opal_datatype_plan_release(opal_datatype_t *pData)
+{
+    if (NULL != pData->plan) {
+        free(pData->plan->displs);
+        free(pData->plan);
+        pData->plan = NULL;
+    }
+}
+
+/*
+ * Copy length bytes between the packed buffer and the memory described
+ * by the plan, starting at the byte position of the packed data.
+ */
+static void opal_datatype_plan_copy(const opal_datatype_t *pData, unsigned char *base,
+                                    size_t position, unsigned char *packed, size_t length,
+                                    bool pack)
+{
+    const opal_datatype_plan_t *plan = pData->plan;
+    const ptrdiff_t extent = pData->ub - pData->lb;
+    size_t elem = position / pData->size;
+    size_t offset = position % pData->size;
+    size_t block = offset / plan->blen;
+    size_t skip = offset % plan->blen;
+
+    while (0 != length) {
+        size_t i = block % plan->inner_count, rest = block / plan->inner_count, n;
+        unsigned char *row = base + (ptrdiff_t) elem * extent + plan->disp;
+        ptrdiff_t inner;
+
+        for (uint32_t d = 0; d < plan->outer_dims; d++) {
+            row += (ptrdiff_t)(rest % plan->outer_count[d]) * plan->outer_stride[d];
+            rest /= plan->outer_count[d];
+        }
+        inner = (NULL != plan->displs) ? plan->displs[i] : (ptrdiff_t) i * plan->inner_stride;
+
+        if (0 != skip || length < plan->blen) {
+            /* partial block */
+            n = opal_min(plan->blen - skip, length);
+            if (pack) {
+                memcpy(packed, row + inner + skip, n);
+            } else {
+                memcpy(row + inner + skip, packed, n);
+            }
+            packed += n;
+            length -= n;
+            skip += n;
+            if (skip < plan->blen) {
+                break;
+            }
+            skip = 0;
+            n = 1;
+        } else {
+            /* as many whole blocks of the row as possible */
+            n = opal_min(plan->inner_count - i, length / plan->blen);
+            if (NULL != plan->displs) {
+                if (pack) {
+                    plan->kernels->pack_indexed(packed, row, plan->displs + i, n, plan->blen);
+                } else {
+                    plan->kernels->unpack_indexed(row, packed, plan->displs + i, n, plan->blen);
+                }
+            } else {
+                if (pack) {
+                    plan->kernels->pack_strided(packed, row + inner, n, plan->inner_stride,
+                                                plan->blen);
+                } else {
+                    plan->kernels->unpack_strided(row + inner, packed, n, plan->inner_stride,
+                                                  plan->blen);
+                }
+            }
+            packed += n * plan->blen;
+            length -= n * plan->blen;
+        }
+        block += n;
+        if (block == plan->nblocks) {
+            block = 0;
+            elem++;
+        }
+    }
+}
+
+static int32_t opal_datatype_plan_advance(opal_convertor_t *pConv, struct iovec *iov,
+                                          uint32_t *out_size, size_t *max_data, bool pack)
+{
+    size_t remaining, initial_bytes_converted = pConv->bConverted;
+    uint32_t idx;
+
+    for (idx = 0; idx < (*out_size); idx++) {
+        remaining = pConv->local_size - pConv->bConverted;
+        if (0 == remaining) {
+            break; /* we're done this time */
+        }
+        if (remaining > iov[idx].iov_len) {
+            remaining = iov[idx].iov_len;
+        }
+        opal_datatype_plan_copy(pConv->pDesc, pConv->pBaseBuf, pConv->bConverted,
+                                (unsigned char *) iov[idx].iov_base, remaining, pack);
+        iov[idx].iov_len = remaining;
+        pConv->bConverted += remaining;
+    }
+
+    *out_size = idx;
+    *max_data = pConv->bConverted - initial_bytes_converted;
+    if (pConv->bConverted == pConv->local_size) {
+        pConv->flags |= CONVERTOR_COMPLETED;
+    }
+    return !!(pConv->flags & CONVERTOR_COMPLETED); /* done or not */
+}
+
+/* Like the contiguous versions, the plan versions do not use the stack:
+ * the position is retrieved from pConvertor->bConverted.
+ */
+int32_t opal_pack_plan(opal_convertor_t *pConvertor, struct iovec *iov, uint32_t *out_size,
+                       size_t *max_data)
+{
+    return opal_datatype_plan_advance(pConvertor, iov, out_size, max_data, true);
+}
+
+int32_t opal_unpack_plan(opal_convertor_t *pConvertor, struct iovec *iov, uint32_t *out_size,
+                         size_t *max_data)
+{
+    return opal_datatype_plan_advance(pConvertor, iov, out_size, max_data, false);
+}
@@ -0,0 +1,697 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_pointer_array.h"
+#include "opal/mca/base/mca_base_event.h"
+#include "opal/mca/base/mca_base_vari.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/mca/timer/base/base.h"
+#include "opal/runtime/opal_params_core.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/bit_ops.h"
+#include "opal/util/minmax.h"
+
+/* maximum number of events delivered by one call to the progress callback */
+#define MCA_BASE_EVENT_DELIVER_MAX 64
+
+/*
+ * Multi-producer, single-consumer ring buffer. A producer claims a
+ * ticket by advancing head as long as the ring is not full, fills the
+ * slot and publishes it by setting the slot's sequence number to
+ * ticket + 1. The consumer (whoever holds mca_base_event_lock) delivers
+ * slots in ticket order and advances tail once it is done with a slot.
+ */
+struct mca_base_event_ring_t {
+    mca_base_event_instance_t *slots;
+    int64_t mask;
+    opal_atomic_int64_t head;
+    opal_atomic_int64_t tail;
+    /** total number of events dropped */
+    opal_atomic_int64_t dropped;
+    /** value of dropped when the dropped handlers were last invoked */
+    int64_t dropped_seen;
+};
+typedef struct mca_base_event_ring_t mca_base_event_ring_t;
+
+static mca_base_event_ring_t mca_base_event_ring;
+
+static opal_hash_table_t mca_base_event_index_hash;
+static opal_pointer_array_t registered_events;
+static bool mca_base_event_initialized = false;
+static int event_count = 0;
+
+/* protects the handle lists. never held while a callback runs */
+static opal_recursive_mutex_t mca_base_event_lock;
+/* number of allocated handles */
+static int mca_base_event_num_handles = 0;
+/* set while events are being delivered. prevents nested delivery and makes
+ * the thread that set it the only consumer of the ring */
+static bool mca_base_event_delivering = false;
+
+/* handles an event (or a drop count) is delivered to. filled under the
+ * lock and walked without it. owned by the consumer */
+struct mca_base_event_target_t {
+    mca_base_event_handle_t *handle;
+    int level;
+    size_t count;
+};
+typedef struct mca_base_event_target_t mca_base_event_target_t;
+
+static mca_base_event_target_t *mca_base_event_targets = NULL;
+static int mca_base_event_targets_size = 0;
+
+int mca_base_event_buffer_size = 4096;
+
+static void mca_base_event_constructor(mca_base_event_t *event)
+{
+    memset((char *) event + sizeof(event->super), 0, sizeof(*event) - sizeof(event->super));
+    event->event_index = -1;
+    OBJ_CONSTRUCT(&event->handles, opal_list_t);
+}
+
+static void mca_base_event_destructor(mca_base_event_t *event)
+{
+    free(event->name);
+    free(event->description);
+    OPAL_LIST_DESTRUCT(&event->handles);
+}
+
+OBJ_CLASS_INSTANCE(mca_base_event_t, opal_object_t, mca_base_event_constructor,
+                   mca_base_event_destructor);
+
+static void mca_base_event_handle_constructor(mca_base_event_handle_t *handle)
+{
+    handle->event = NULL;
+    handle->obj = NULL;
+    memset(handle->callbacks, 0, sizeof(handle->callbacks));
+    handle->dropped_cb = NULL;
+    handle->dropped_seen = 0;
+    handle->free_cb = NULL;
+    handle->free_cb_data = NULL;
+}
+
+static void mca_base_event_handle_destructor(mca_base_event_handle_t *handle)
+{
+    /* the last reference goes away either in mca_base_event_handle_free() or,
+     * if the handle was freed during delivery, after its last callback */
+    if (NULL != handle->free_cb) {
+        handle->free_cb(handle,
+                        opal_using_threads() ? OPAL_MCA_BASE_CB_REQUIRE_THREAD_SAFE
+                                             : OPAL_MCA_BASE_CB_REQUIRE_MPI_RESTRICTED,
+                        handle->free_cb_data);
+    }
+}
+
+OBJ_CLASS_INSTANCE(mca_base_event_handle_t, opal_list_item_t, mca_base_event_handle_constructor,
+                   mca_base_event_handle_destructor);
+
+mca_base_event_t mca_base_event_null = {
+    .event_index = -1,
+    .active = 0,
+};
+
+static int mca_base_event_progress(void);
+
+int mca_base_event_init(void)
+{
+    int ret = OPAL_SUCCESS;
+
+    if (!mca_base_event_initialized) {
+        mca_base_event_initialized = true;
+
+        OBJ_CONSTRUCT(&registered_events, opal_pointer_array_t);
+        opal_pointer_array_init(&registered_events, 16, 1024, 16);
+
+        OBJ_CONSTRUCT(&mca_base_event_lock, opal_recursive_mutex_t);
+
+        OBJ_CONSTRUCT(&mca_base_event_index_hash, opal_hash_table_t);
+        ret = opal_hash_table_init(&mca_base_event_index_hash, 256);
+        if (OPAL_SUCCESS != ret) {
+            mca_base_event_initialized = false;
+            OBJ_DESTRUCT(&registered_events);
+            OBJ_DESTRUCT(&mca_base_event_lock);
+            OBJ_DESTRUCT(&mca_base_event_index_hash);
+        }
+    }
+
+    return ret;
+}
+
+int mca_base_event_finalize(void)
+{
+    mca_base_event_t *event;
+
+    if (mca_base_event_initialized) {
+        mca_base_event_initialized = false;
+
+        /* no-op if no handle was ever allocated */
+        (void) opal_progress_unregister(mca_base_event_progress);
+
+        for (int i = 0; i < event_count; ++i) {
+            event = opal_pointer_array_get_item(&registered_events, i);
+            if (NULL != event) {
+                event->active = 0;
+                OBJ_RELEASE(event);
+            }
+        }
+
+        event_count = 0;
+        mca_base_event_num_handles = 0;
+
+        OBJ_DESTRUCT(&registered_events);
+        OBJ_DESTRUCT(&mca_base_event_index_hash);
+        OBJ_DESTRUCT(&mca_base_event_lock);
+
+        free(mca_base_event_ring.slots);
+        memset(&mca_base_event_ring, 0, sizeof(mca_base_event_ring));
+
+        free(mca_base_event_targets);
+        mca_base_event_targets = NULL;
+        mca_base_event_targets_size = 0;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_find_by_name(const char *full_name, int *index)
+{
+    void *tmp;
+    int ret;
+
+    if (!mca_base_event_initialized) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    ret = opal_hash_table_get_value_ptr(&mca_base_event_index_hash, full_name, strlen(full_name),
+                                        &tmp);
+    if (OPAL_SUCCESS != ret) {
+        return ret;
+    }
+
+    *index = (int) (uintptr_t) tmp;
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_get_count(int *count)
+{
+    *count = event_count;
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_get(int index, mca_base_event_t **event)
+{
+    if (!mca_base_event_initialized || index < 0 || index >= event_count) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    *event = opal_pointer_array_get_item(&registered_events, index);
+    if (NULL == *event) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_register(const char *project, const char *framework, const char *component,
+                            const char *name, const char *description,
+                            mca_base_var_info_lvl_t verbosity, int bind, int num_elements,
+                            const mca_base_var_type_t *types, const ptrdiff_t *offsets,
+                            size_t extent, mca_base_event_t **event_out)
+{
+    mca_base_event_t *event;
+    char *full_name;
+    int ret, index;
+
+    *event_out = &mca_base_event_null;
+
+    if (!mca_base_event_initialized) {
+        return OPAL_ERR_NOT_INITIALIZED;
+    }
+
+    /* check the description of the event data */
+    if (num_elements < 0 || num_elements > MCA_BASE_EVENT_MAX_ELEMENTS
+        || extent > MCA_BASE_EVENT_MAX_DATA) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    for (int i = 0; i < num_elements; ++i) {
+        if (types[i] >= MCA_BASE_VAR_TYPE_MAX || MCA_BASE_VAR_TYPE_STRING == types[i]
+            || MCA_BASE_VAR_TYPE_VERSION_STRING == types[i] || offsets[i] < 0
+            || (size_t) offsets[i] + ompi_var_type_sizes[types[i]] > extent) {
+            return OPAL_ERR_BAD_PARAM;
+        }
+    }
+
+    assert(verbosity >= OPAL_INFO_LVL_1 && verbosity <= OPAL_INFO_LVL_9);
+
+    ret = mca_base_var_generate_full_name4(NULL, framework, component, name, &full_name);
+    if (OPAL_SUCCESS != ret) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    (void) project;
+
+    if (OPAL_SUCCESS == mca_base_event_find_by_name(full_name, &index)) {
+        /* already registered (the component was reopened) */
+        free(full_name);
+        event = opal_pointer_array_get_item(&registered_events, index);
+        free(event->description);
+        event->description = NULL;
+    } else {
+        event = OBJ_NEW(mca_base_event_t);
+        if (NULL == event) {
+            free(full_name);
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+
+        event->name = full_name;
+        index = opal_pointer_array_add(&registered_events, event);
+        if (0 > index) {
+            OBJ_RELEASE(event);
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+
+        event->event_index = index;
+        opal_hash_table_set_value_ptr(&mca_base_event_index_hash, event->name,
+                                      strlen(event->name), (void *) (uintptr_t) index);
+        ++event_count;
+    }
+
+    if (NULL != description) {
+        event->description = strdup(description);
+    }
+
+    event->verbosity = verbosity;
+    event->bind = bind;
+    event->num_elements = num_elements;
+    for (int i = 0; i < num_elements; ++i) {
+        event->types[i] = types[i];
+        event->offsets[i] = offsets[i];
+    }
+    event->extent = extent;
+
+    *event_out = event;
+
+    return index;
+}
+
+int mca_base_component_event_register(const mca_base_component_t *component, const char *name,
+                                      const char *description, mca_base_var_info_lvl_t verbosity,
+                                      int bind, int num_elements, const mca_base_var_type_t *types,
+                                      const ptrdiff_t *offsets, size_t extent,
+                                      mca_base_event_t **event)
+{
+    return mca_base_event_register(component->mca_project_name, component->mca_type_name,
+                                   component->mca_component_name, name, description, verbosity,
+                                   bind, num_elements, types, offsets, extent, event);
+}
+
+static int mca_base_event_ring_alloc(mca_base_event_ring_t *ring)
+{
+    int size = opal_next_poweroftwo_inclusive(opal_max(mca_base_event_buffer_size, 2));
+
+    ring->slots = calloc(size, sizeof(ring->slots[0]));
+    if (NULL == ring->slots) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    ring->mask = size - 1;
+    ring->head = ring->tail = 0;
+    ring->dropped = ring->dropped_seen = 0;
+    opal_atomic_wmb();
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_handle_alloc(int index, void *obj_handle, mca_base_event_handle_t **handle_out)
+{
+    mca_base_event_handle_t *handle;
+    mca_base_event_t *event;
+    int ret;
+
+    ret = mca_base_event_get(index, &event);
+    if (OPAL_SUCCESS != ret) {
+        return ret;
+    }
+
+    handle = OBJ_NEW(mca_base_event_handle_t);
+    if (NULL == handle) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    handle->event = event;
+    if (MCA_BASE_VAR_BIND_NO_OBJECT != event->bind && NULL != obj_handle) {
+        handle->obj = *(void **) obj_handle;
+    }
+
+    opal_mutex_lock(&mca_base_event_lock);
+
+    if (NULL == mca_base_event_ring.slots) {
+        ret = mca_base_event_ring_alloc(&mca_base_event_ring);
+        if (OPAL_SUCCESS != ret) {
+            opal_mutex_unlock(&mca_base_event_lock);
+            OBJ_RELEASE(handle);
+            return ret;
+        }
+    }
+
+    handle->dropped_seen = event->dropped;
+    opal_list_append(&event->handles, &handle->super);
+    ++mca_base_event_num_handles;
+
+    /* the progress callback is registered by mca_base_event_progress_init()
+     * if opal_progress is not up yet */
+    if (opal_initialized) {
+        (void) opal_progress_register_lp(mca_base_event_progress);
+    }
+
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    /* start recording */
+    (void) opal_atomic_add_fetch_32(&event->active, 1);
+
+    *handle_out = handle;
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_handle_free(mca_base_event_handle_t *handle,
+                               mca_base_event_free_cb_fn_t free_cb, void *user_data)
+{
+    mca_base_event_t *event = handle->event;
+
+    (void) opal_atomic_add_fetch_32(&event->active, -1);
+
+    opal_mutex_lock(&mca_base_event_lock);
+    opal_list_remove_item(&event->handles, &handle->super);
+    /* a delivery in flight may still hold a reference. it skips the handle
+     * from now on and the free callback runs when it lets go */
+    memset(handle->callbacks, 0, sizeof(handle->callbacks));
+    handle->dropped_cb = NULL;
+    handle->free_cb = free_cb;
+    handle->free_cb_data = user_data;
+    if (0 == --mca_base_event_num_handles) {
+        /* nobody to deliver to anymore */
+        (void) opal_progress_unregister(mca_base_event_progress);
+    }
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    OBJ_RELEASE(handle);
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_register_callback(mca_base_event_handle_t *handle, int cb_safety,
+                                     mca_base_event_cb_fn_t fn, void *user_data)
+{
+    if (cb_safety < OPAL_MCA_BASE_CB_REQUIRE_NONE || cb_safety >= MCA_BASE_EVENT_CB_SAFETY_COUNT) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    opal_mutex_lock(&mca_base_event_lock);
+    handle->callbacks[cb_safety].fn = fn;
+    handle->callbacks[cb_safety].user_data = user_data;
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_set_dropped_handler(mca_base_event_handle_t *handle,
+                                       mca_base_event_dropped_cb_fn_t fn)
+{
+    opal_mutex_lock(&mca_base_event_lock);
+    handle->dropped_cb = fn;
+    handle->dropped_seen = handle->event->dropped;
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    return OPAL_SUCCESS;
+}
+
+int mca_base_event_read(const mca_base_event_instance_t *instance, int element_index,
+                        void *buffer)
+{
+    const mca_base_event_t *event = instance->event;
+
+    if (element_index < 0 || element_index >= event->num_elements) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    memcpy(buffer, instance->data + event->offsets[element_index],
+           ompi_var_type_sizes[event->types[element_index]]);
+
+    return OPAL_SUCCESS;
+}
+
+uint64_t mca_base_event_source_timestamp(void)
+{
+    return (uint64_t) opal_timer_base_get_cycles();
+}
+
+uint64_t mca_base_event_source_ticks_per_second(void)
+{
+    return (uint64_t) opal_timer_base_get_freq();
+}
+
+void mca_base_event_record(mca_base_event_t *event, void *obj, const void *data)
+{
+    mca_base_event_ring_t *ring = &mca_base_event_ring;
+    mca_base_event_instance_t *instance;
+    int64_t head = ring->head;
+
+    do {
+        if (OPAL_UNLIKELY(head - ring->tail > ring->mask)) {
+            /* full. the consumer reports this through the dropped handlers */
+            (void) opal_atomic_add_fetch_64(&event->dropped, 1);
+            (void) opal_atomic_add_fetch_64(&ring->dropped, 1);
+            return;
+        }
+    } while (!opal_atomic_compare_exchange_strong_64(&ring->head, &head, head + 1));
+
+    instance = ring->slots + (head & ring->mask);
+    instance->event = event;
+    instance->obj = obj;
+    instance->timestamp = (uint64_t) opal_timer_base_get_cycles();
+    if (event->extent) {
+        memcpy(instance->data, data, event->extent);
+    }
+
+    opal_atomic_wmb();
+    instance->seq = head + 1;
+}
+
+/* lowest registered callback level that can run in a context that guarantees {cb_safety} */
+static int mca_base_event_callback_level(const mca_base_event_handle_t *handle, int cb_safety)
+{
+    for (int i = cb_safety; i < MCA_BASE_EVENT_CB_SAFETY_COUNT; ++i) {
+        if (NULL != handle->callbacks[i].fn) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* make room for {count} targets. called with the lock held */
+static bool mca_base_event_targets_reserve(int count)
+{
+    mca_base_event_target_t *tmp;
+
+    if (count <= mca_base_event_targets_size) {
+        return true;
+    }
+
+    tmp = realloc(mca_base_event_targets, count * sizeof(tmp[0]));
+    if (NULL == tmp) {
+        return false;
+    }
+
+    mca_base_event_targets = tmp;
+    mca_base_event_targets_size = count;
+
+    return true;
+}
+
+/* release the references taken by the target collection. a handle freed by
+ * one of the callbacks is destroyed (and its free callback invoked) here */
+static void mca_base_event_targets_release(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        OBJ_RELEASE(mca_base_event_targets[i].handle);
+    }
+}
+
+static void mca_base_event_deliver(mca_base_event_instance_t *instance, int cb_safety)
+{
+    mca_base_event_handle_t *handle;
+    mca_base_event_cb_fn_t fn;
+    int level, count = 0;
+
+    opal_mutex_lock(&mca_base_event_lock);
+    if (!mca_base_event_targets_reserve(
+            (int) opal_list_get_size(&instance->event->handles))) {
+        opal_mutex_unlock(&mca_base_event_lock);
+        return;
+    }
+
+    OPAL_LIST_FOREACH (handle, &instance->event->handles, mca_base_event_handle_t) {
+        if (NULL != handle->obj && handle->obj != instance->obj) {
+            continue;
+        }
+
+        level = mca_base_event_callback_level(handle, cb_safety);
+        if (0 <= level) {
+            OBJ_RETAIN(handle);
+            mca_base_event_targets[count].handle = handle;
+            mca_base_event_targets[count++].level = level;
+        }
+    }
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    for (int i = 0; i < count; ++i) {
+        handle = mca_base_event_targets[i].handle;
+        level = mca_base_event_targets[i].level;
+        /* cleared if the handle was freed by an earlier callback */
+        fn = handle->callbacks[level].fn;
+        if (NULL != fn) {
+            fn(instance, handle, cb_safety, handle->callbacks[level].user_data);
+        }
+    }
+
+    mca_base_event_targets_release(count);
+}
+
+static void mca_base_event_report_dropped(int cb_safety)
+{
+    mca_base_event_dropped_cb_fn_t fn;
+    mca_base_event_handle_t *handle;
+    mca_base_event_t *event;
+    int64_t dropped;
+    int level, count = 0;
+
+    opal_mutex_lock(&mca_base_event_lock);
+    if (!mca_base_event_targets_reserve(mca_base_event_num_handles)) {
+        opal_mutex_unlock(&mca_base_event_lock);
+        return;
+    }
+
+    for (int i = 0; i < event_count; ++i) {
+        event = opal_pointer_array_get_item(&registered_events, i);
+        if (NULL == event || 0 == event->dropped) {
+            continue;
+        }
+
+        dropped = event->dropped;
+        OPAL_LIST_FOREACH (handle, &event->handles, mca_base_event_handle_t) {
+            if (dropped == handle->dropped_seen) {
+                continue;
+            }
+
+            size_t ndropped = (size_t) (dropped - handle->dropped_seen);
+            handle->dropped_seen = dropped;
+            if (NULL != handle->dropped_cb) {
+                OBJ_RETAIN(handle);
+                mca_base_event_targets[count].handle = handle;
+                mca_base_event_targets[count].level = mca_base_event_callback_level(handle,
+                                                                                    cb_safety);
+                mca_base_event_targets[count++].count = ndropped;
+            }
+        }
+    }
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    for (int i = 0; i < count; ++i) {
+        handle = mca_base_event_targets[i].handle;
+        level = mca_base_event_targets[i].level;
+        fn = handle->dropped_cb;
+        if (NULL != fn) {
+            fn(mca_base_event_targets[i].count, handle, MCA_BASE_EVENT_SOURCE_TIMER, cb_safety,
+               0 <= level ? handle->callbacks[level].user_data : NULL);
+        }
+    }
+
+    mca_base_event_targets_release(count);
+}
+
+static int mca_base_event_progress(void)
+{
+    mca_base_event_ring_t *ring = &mca_base_event_ring;
+    mca_base_event_instance_t *instance;
+    int cb_safety, count = 0;
+    int64_t tail;
+
+    if (OPAL_LIKELY(ring->tail == ring->head && ring->dropped == ring->dropped_seen)) {
+        return 0;
+    }
+
+    if (0 != opal_mutex_trylock(&mca_base_event_lock)) {
+        return 0;
+    }
+
+    if (mca_base_event_delivering || NULL == ring->slots) {
+        /* called from an event callback or another thread is delivering */
+        opal_mutex_unlock(&mca_base_event_lock);
+        return 0;
+    }
+
+    /* become the consumer. the lock is only taken again to collect the
+     * handles of each event, so callbacks are free to call back into the
+     * MPI_T interface (including freeing their own handle) */
+    mca_base_event_delivering = true;
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    /* callbacks are invoked from inside the library and, with threads, may
+     * run concurrently with other application threads */
+    cb_safety = opal_using_threads() ? OPAL_MCA_BASE_CB_REQUIRE_THREAD_SAFE
+                                     : OPAL_MCA_BASE_CB_REQUIRE_MPI_RESTRICTED;
+
+    while (count < MCA_BASE_EVENT_DELIVER_MAX) {
+        tail = ring->tail;
+        instance = ring->slots + (tail & ring->mask);
+        if (instance->seq != tail + 1) {
+            /* empty or the producer is still writing this slot */
+            break;
+        }
+
+        opal_atomic_rmb();
+        mca_base_event_deliver(instance, cb_safety);
+
+        /* done with the slot. hand it back to the producers */
+        opal_atomic_mb();
+        ring->tail = tail + 1;
+        ++count;
+    }
+
+    if (ring->dropped != ring->dropped_seen) {
+        ring->dropped_seen = ring->dropped;
+        mca_base_event_report_dropped(cb_safety);
+    }
+
+    opal_mutex_lock(&mca_base_event_lock);
+    mca_base_event_delivering = false;
+    opal_mutex_unlock(&mca_base_event_lock);
+
+    return count;
+}
+
+int mca_base_event_progress_init(void)
+{
+    if (!mca_base_event_initialized || 0 == mca_base_event_num_handles) {
+        return OPAL_SUCCESS;
+    }
+
+    return opal_progress_register_lp(mca_base_event_progress);
+}
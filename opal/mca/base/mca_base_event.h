@@ -0,0 +1,285 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * MPI_T events
+ *
+ * Components register events at component registration time and raise
+ * them from their fast paths with mca_base_event_raise(). An event with
+ * no bound handle costs a single, well predicted branch. While a handle
+ * is bound the raise copies the event data and a timestamp into a
+ * lock-free ring buffer shared by all events. The buffer is drained from
+ * a low priority progress callback which invokes the callbacks the tool
+ * registered on the handles. Events raised while the buffer is full are
+ * counted and reported through the dropped handler of each handle.
+ */
+
+#if !defined(OPAL_MCA_BASE_EVENT_H)
+#    define OPAL_MCA_BASE_EVENT_H
+
+#    include "opal_config.h"
+
+#    include <stddef.h>
+
+#    include "opal/class/opal_list.h"
+#    include "opal/mca/base/mca_base_pvar.h"
+#    include "opal/mca/base/mca_base_var.h"
+#    include "opal/sys/atomic.h"
+
+/** maximum number of elements in an event */
+#    define MCA_BASE_EVENT_MAX_ELEMENTS 8
+/** maximum size of the data carried by an event */
+#    define MCA_BASE_EVENT_MAX_DATA 64
+/** number of callback safety levels (see MPI_T_cb_safety) */
+#    define MCA_BASE_EVENT_CB_SAFETY_COUNT (OPAL_MCA_BASE_CB_REQUIRE_ASYNC_SIGNAL_SAFE + 1)
+/** index of the (only) event source */
+#    define MCA_BASE_EVENT_SOURCE_TIMER 0
+
+struct mca_base_event_t {
+    opal_object_t super;
+
+    /** index of this event */
+    int event_index;
+    /** full name of this event (project_framework_component_name) */
+    char *name;
+    /** description of this event */
+    char *description;
+    /** verbosity level of this event */
+    mca_base_var_info_lvl_t verbosity;
+    /** object binding (MCA_BASE_VAR_BIND_*) */
+    int bind;
+
+    /** number of elements in the event data */
+    int num_elements;
+    /** type of each element */
+    mca_base_var_type_t types[MCA_BASE_EVENT_MAX_ELEMENTS];
+    /** offset of each element in the event data */
+    ptrdiff_t offsets[MCA_BASE_EVENT_MAX_ELEMENTS];
+    /** size of the event data passed to mca_base_event_raise() */
+    size_t extent;
+
+    /** number of handles bound to this event. nothing is recorded while
+     * this is zero */
+    opal_atomic_int32_t active;
+    /** number of times this event could not be recorded */
+    opal_atomic_int64_t dropped;
+    /** handles bound to this event (mca_base_event_handle_t) */
+    opal_list_t handles;
+};
+typedef struct mca_base_event_t mca_base_event_t;
+
+OPAL_DECLSPEC OBJ_CLASS_DECLARATION(mca_base_event_t);
+
+/**
+ * A recorded event. Valid only for the duration of the callback it is
+ * passed to.
+ */
+struct mca_base_event_instance_t {
+    /** ticket + 1 once the producer finished writing this slot */
+    opal_atomic_int64_t seq;
+    mca_base_event_t *event;
+    /** object the event was raised on */
+    void *obj;
+    /** opal_timer_base_get_cycles() at the time the event was raised */
+    uint64_t timestamp;
+    unsigned char data[MCA_BASE_EVENT_MAX_DATA];
+};
+typedef struct mca_base_event_instance_t mca_base_event_instance_t;
+
+struct mca_base_event_handle_t;
+
+typedef void (*mca_base_event_cb_fn_t)(mca_base_event_instance_t *instance,
+                                       struct mca_base_event_handle_t *handle, int cb_safety,
+                                       void *user_data);
+typedef void (*mca_base_event_dropped_cb_fn_t)(size_t count,
+                                               struct mca_base_event_handle_t *handle,
+                                               int source_index, int cb_safety, void *user_data);
+typedef void (*mca_base_event_free_cb_fn_t)(struct mca_base_event_handle_t *handle,
+                                            int cb_safety, void *user_data);
+
+struct mca_base_event_handle_t {
+    opal_list_item_t super;
+
+    mca_base_event_t *event;
+    /** bound object or NULL to receive the event for every object */
+    void *obj;
+    /** callbacks indexed by the safety level they were registered with */
+    struct {
+        mca_base_event_cb_fn_t fn;
+        void *user_data;
+    } callbacks[MCA_BASE_EVENT_CB_SAFETY_COUNT];
+    mca_base_event_dropped_cb_fn_t dropped_cb;
+    /** value of event->dropped last reported to dropped_cb */
+    int64_t dropped_seen;
+    /** set by mca_base_event_handle_free(). invoked when the handle is released */
+    mca_base_event_free_cb_fn_t free_cb;
+    void *free_cb_data;
+};
+typedef struct mca_base_event_handle_t mca_base_event_handle_t;
+
+OPAL_DECLSPEC OBJ_CLASS_DECLARATION(mca_base_event_handle_t);
+
+/**
+ * Event that is never active. Event pointers can be initialized with
+ * this so the event can be raised before (or without) registration.
+ */
+OPAL_DECLSPEC extern mca_base_event_t mca_base_event_null;
+
+/** number of events the ring buffer can hold (rounded up to a power of two) */
+OPAL_DECLSPEC extern int mca_base_event_buffer_size;
+
+/**
+ * Register an event
+ *
+ * @param[in] project      Project name
+ * @param[in] framework    Framework name
+ * @param[in] component    Component name
+ * @param[in] name         Event name
+ * @param[in] description  Event description
+ * @param[in] verbosity    Event verbosity level
+ * @param[in] bind         Object binding (MCA_BASE_VAR_BIND_*)
+ * @param[in] num_elements Number of elements in the event data
+ * @param[in] types        Type of each element
+ * @param[in] offsets      Offset of each element in the event data
+ * @param[in] extent       Size of the event data
+ * @param[out] event       Registered event (&mca_base_event_null on error)
+ *
+ * @returns index of the event on success
+ * @returns OPAL_ERR_BAD_PARAM if the element description is invalid
+ * @returns OPAL_ERR_OUT_OF_RESOURCE on allocation failure
+ *
+ * Registering an event that already exists updates its description
+ * and returns the existing event.
+ */
+OPAL_DECLSPEC int mca_base_event_register(const char *project, const char *framework,
+                                          const char *component, const char *name,
+                                          const char *description,
+                                          mca_base_var_info_lvl_t verbosity, int bind,
+                                          int num_elements, const mca_base_var_type_t *types,
+                                          const ptrdiff_t *offsets, size_t extent,
+                                          mca_base_event_t **event);
+
+/**
+ * Convenience function for registering an event associated with a
+ * component. See mca_base_event_register().
+ */
+OPAL_DECLSPEC int mca_base_component_event_register(const mca_base_component_t *component,
+                                                    const char *name, const char *description,
+                                                    mca_base_var_info_lvl_t verbosity, int bind,
+                                                    int num_elements,
+                                                    const mca_base_var_type_t *types,
+                                                    const ptrdiff_t *offsets, size_t extent,
+                                                    mca_base_event_t **event);
+
+/**
+ * Find the index of an event by its full name
+ *
+ * @returns OPAL_SUCCESS on success
+ * @returns OPAL_ERR_NOT_FOUND if no event has that name
+ */
+OPAL_DECLSPEC int mca_base_event_find_by_name(const char *full_name, int *index);
+
+/**
+ * Get the number of registered events
+ */
+OPAL_DECLSPEC int mca_base_event_get_count(int *count);
+
+/**
+ * Get the event at {index}
+ *
+ * @returns OPAL_SUCCESS on success
+ * @returns OPAL_ERR_NOT_FOUND if the index is out of range
+ */
+OPAL_DECLSPEC int mca_base_event_get(int index, mca_base_event_t **event);
+
+/**
+ * Bind a new handle to the event at {index}
+ *
+ * @param[in] index   Event index
+ * @param[in] obj_handle Pointer to the object to bind to (ignored if the
+ *                    event is not bound to an object, NULL for all objects)
+ * @param[out] handle New handle
+ */
+OPAL_DECLSPEC int mca_base_event_handle_alloc(int index, void *obj_handle,
+                                              mca_base_event_handle_t **handle);
+
+/**
+ * Unbind and release a handle. Events that are still in the ring buffer
+ * are not delivered to the handle. The free callback (if any) is invoked
+ * once no callback of the handle is running anymore: before this function
+ * returns or, if called while the handle's callbacks are being invoked
+ * (for example by one of them), when the last of them returns.
+ */
+OPAL_DECLSPEC int mca_base_event_handle_free(mca_base_event_handle_t *handle,
+                                             mca_base_event_free_cb_fn_t free_cb,
+                                             void *user_data);
+
+/**
+ * Set the callback invoked for {handle} at safety level {cb_safety}.
+ * Passing a NULL function removes the callback.
+ */
+OPAL_DECLSPEC int mca_base_event_register_callback(mca_base_event_handle_t *handle,
+                                                   int cb_safety, mca_base_event_cb_fn_t fn,
+                                                   void *user_data);
+
+/**
+ * Set the function called when events were dropped for {handle}
+ */
+OPAL_DECLSPEC int mca_base_event_set_dropped_handler(mca_base_event_handle_t *handle,
+                                                     mca_base_event_dropped_cb_fn_t fn);
+
+/**
+ * Copy element {element_index} of {instance} into {buffer}
+ */
+OPAL_DECLSPEC int mca_base_event_read(const mca_base_event_instance_t *instance,
+                                      int element_index, void *buffer);
+
+/**
+ * Current timestamp of the event source. Timestamps of instances use
+ * the same clock.
+ */
+OPAL_DECLSPEC uint64_t mca_base_event_source_timestamp(void);
+
+/**
+ * Number of timestamp ticks per second of the event source
+ */
+OPAL_DECLSPEC uint64_t mca_base_event_source_ticks_per_second(void);
+
+/**
+ * Record an event in the ring buffer. Use mca_base_event_raise().
+ */
+OPAL_DECLSPEC void mca_base_event_record(mca_base_event_t *event, void *obj, const void *data);
+
+/**
+ * Raise an event
+ *
+ * @param[in] event Event to raise
+ * @param[in] obj   Object the event applies to (e.g. the communicator)
+ * @param[in] data  Event data (event->extent bytes)
+ *
+ * The data is copied before this function returns.
+ */
+static inline void mca_base_event_raise(mca_base_event_t *event, void *obj, const void *data)
+{
+    if (OPAL_UNLIKELY(event->active)) {
+        mca_base_event_record(event, obj, data);
+    }
+}
+
+/* initialize/finalize the event system. called from mca_base_var_init/finalize */
+OPAL_DECLSPEC int mca_base_event_init(void);
+OPAL_DECLSPEC int mca_base_event_finalize(void);
+
+/* register the delivery callback with opal_progress if handles were
+ * allocated before opal_progress was initialized */
+OPAL_DECLSPEC int mca_base_event_progress_init(void);
+
+#endif /* OPAL_MCA_BASE_EVENT_H */
@@ -38,6 +38,7 @@
 #include "opal/constants.h"
 #include "opal/mca/base/base.h"
 #include "opal/mca/base/mca_base_component_repository.h"
+#include "opal/mca/base/mca_base_event.h"
 #include "opal/mca/installdirs/installdirs.h"
 #include "opal/mca/mca.h"
 #include "opal/runtime/opal.h"
@@ -138,6 +139,14 @@ int mca_base_open(void)
     (void) mca_base_var_register_synonym(var_id, "opal", "mca", NULL, "component_disable_dlopen",
                                          MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
 
+    mca_base_event_buffer_size = 4096;
+    (void) mca_base_var_register("opal", "mca", "base", "event_buffer_size",
+                                 "Number of MPI_T events that can be buffered before they are "
+                                 "delivered to the tool callbacks (rounded up to a power of two). "
+                                 "Events raised while the buffer is full are reported as dropped",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &mca_base_event_buffer_size);
+
     /* What verbosity level do we want for the default 0 stream? */
     char *str = getenv("OPAL_OUTPUT_INTERNAL_TO_STDOUT");
     if (NULL != str && str[0] == '1') {
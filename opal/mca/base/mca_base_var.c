@@ -48,6 +48,7 @@
 #include "opal/constants.h"
 #include "opal/include/opal_stdint.h"
 #include "opal/mca/base/mca_base_alias.h"
+#include "opal/mca/base/mca_base_event.h"
 #include "opal/mca/base/mca_base_vari.h"
 #include "opal/mca/installdirs/installdirs.h"
 #include "opal/mca/mca.h"
@@ -267,6 +268,11 @@ int mca_base_var_init(void)
             return ret;
         }
 
+        ret = mca_base_event_init();
+        if (OPAL_SUCCESS != ret) {
+            return ret;
+        }
+
         /* We may need this later */
         home = (char *) opal_home_directory();
         if (NULL == home) {
@@ -1155,6 +1161,7 @@ static void mca_base_var_finalize(void)
 
         (void) mca_base_var_group_finalize();
         (void) mca_base_pvar_finalize();
+        (void) mca_base_event_finalize();
 
         OBJ_DESTRUCT(&mca_base_var_index_hash);
 
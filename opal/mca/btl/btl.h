@@ -512,6 +512,13 @@ OPAL_DECLSPEC OBJ_CLASS_DECLARATION(mca_btl_base_descriptor_t);
  */
 #define MCA_BTL_DES_FLAGS_SIGNAL 0x0040
 
+/* Allow the BTL to hold back a message sent with btl_sendi (for example to
+ * pack it with later messages to the same peer) until btl_flush is called
+ * on the endpoint. Only passed to BTLs that provide btl_flush; the caller
+ * must flush before returning to the application.
+ */
+#define MCA_BTL_DES_FLAGS_DEFER 0x0080
+
 /**
  * Maximum number of allowed segments in src/dst fields of a descriptor.
  */
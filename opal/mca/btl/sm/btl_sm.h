@@ -56,6 +56,7 @@
 #include "opal/mca/rcache/base/base.h"
 #include "opal/mca/rcache/base/rcache_base_vma.h"
 #include "opal/mca/rcache/rcache.h"
+#include "opal/mca/threads/thread_usage.h"
 #include "opal/sys/atomic.h"
 #include "opal/util/proc.h"
 
@@ -73,6 +74,8 @@ struct sm_fifo_t;
 
 OPAL_DECLSPEC extern mca_btl_sm_component_t mca_btl_sm_component;
 OPAL_DECLSPEC extern mca_btl_sm_t mca_btl_sm;
+/** set while the calling thread is in the progress function of this btl */
+extern opal_thread_local bool mca_btl_sm_in_progress;
 
 /* number of peers on the node (not including self) */
 #define MCA_BTL_SM_NUM_LOCAL_PEERS opal_process_info.num_local_peers
@@ -100,6 +103,16 @@ static inline void sm_memmove(void *dst, void *src, size_t size)
 int mca_btl_sm_send(struct mca_btl_base_module_t *btl, struct mca_btl_base_endpoint_t *endpoint,
                     struct mca_btl_base_descriptor_t *descriptor, mca_btl_base_tag_t tag);
 
+/**
+ * Close the open coalesced records of an endpoint (NULL: all endpoints).
+ * Put and get complete before they return so there is nothing else to
+ * flush.
+ *
+ * @param btl (IN)      BTL module
+ * @param endpoint (IN) BTL peer addressing
+ */
+int mca_btl_sm_flush(struct mca_btl_base_module_t *btl, struct mca_btl_base_endpoint_t *endpoint);
+
 /**
  * Initiate an inline send to the peer.
  *
@@ -157,6 +170,17 @@ mca_btl_base_descriptor_t *mca_btl_sm_alloc(struct mca_btl_base_module_t *btl,
  */
 int mca_btl_sm_free(struct mca_btl_base_module_t *btl, mca_btl_base_descriptor_t *des);
 
+/**
+ * Bind a page-aligned region of shared memory to a NUMA node.
+ *
+ * @param base (IN)     Start of the region (page aligned)
+ * @param size (IN)     Size of the region (multiple of the page size)
+ * @param node (IN)     NUMA node (OS index). Nothing is done if negative.
+ *
+ * Pages that have already been touched are migrated.
+ */
+int mca_btl_sm_numa_bind(void *base, size_t size, int node);
+
 static inline bool mca_btl_is_self_endpoint(mca_btl_base_endpoint_t *endpoint) {
     return endpoint->peer_smp_rank == MCA_BTL_SM_LOCAL_RANK;
 }
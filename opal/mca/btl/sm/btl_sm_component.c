@@ -34,11 +34,14 @@
  */
 #include "opal_config.h"
 
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/mca/btl/base/btl_base_error.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "opal/mca/threads/mutex.h"
 #include "opal/util/bit_ops.h"
 #include "opal/util/output.h"
 #include "opal/util/printf.h"
+#include "opal/util/sys_limits.h"
 
 #include "opal/mca/btl/sm/btl_sm.h"
 #include "opal/mca/btl/sm/btl_sm_fbox.h"
@@ -72,6 +75,8 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
 /*
  * Shared Memory (SM) component instance.
  */
+opal_thread_local bool mca_btl_sm_in_progress = false;
+
 mca_btl_sm_component_t mca_btl_sm_component = {
     .super =
         {
@@ -93,8 +98,34 @@ mca_btl_sm_component_t mca_btl_sm_component = {
         } /* end super */
 };
 
+static mca_base_var_enum_value_t mca_btl_sm_numa_policies[] = {
+    {MCA_BTL_SM_NUMA_POLICY_NONE, "none"},
+    {MCA_BTL_SM_NUMA_POLICY_RECEIVER, "receiver"},
+    {0, NULL},
+};
+
+static void mca_btl_sm_component_register_events(void)
+{
+    static const mca_base_var_type_t types[] = {MCA_BASE_VAR_TYPE_INT32_T,
+                                                MCA_BASE_VAR_TYPE_UINT32_T};
+    static const ptrdiff_t offsets[] = {offsetof(mca_btl_sm_fbox_full_event_t, peer),
+                                        offsetof(mca_btl_sm_fbox_full_event_t, size)};
+
+    (void) mca_base_component_event_register(&mca_btl_sm_component.super.btl_version,
+                                             "fbox_full",
+                                             "A message did not fit in the fast box of a "
+                                             "peer and fell back to the fifo. Elements: local "
+                                             "rank of the receiver, message size",
+                                             OPAL_INFO_LVL_5, MCA_BASE_VAR_BIND_NO_OBJECT, 2,
+                                             types, offsets,
+                                             sizeof(mca_btl_sm_fbox_full_event_t),
+                                             &mca_btl_sm_component.fbox_full_event);
+}
+
 static int mca_btl_sm_component_register(void)
 {
+    mca_base_var_enum_t *new_enum;
+
     (void) mca_base_var_group_component_register(&mca_btl_sm_component.super.btl_version,
                                                  "Enhanced shared memory byte transport later");
 
@@ -181,6 +212,93 @@ static int mca_btl_sm_component_register(void)
                                            MCA_BASE_VAR_SCOPE_LOCAL,
                                            &mca_btl_sm_component.fbox_max);
 
+    mca_btl_sm_component.fbox_coalesce_size = 0;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "fbox_coalesce_size",
+                                           "Size in bytes of a coalesced fast box record. When "
+                                           "non-zero small inline sends to the same peer made "
+                                           "while progressing incoming messages (protocol "
+                                           "replies, one-sided responses) or started together "
+                                           "by the application (MPI_Startall) are packed into a "
+                                           "single fast box record that is made visible to the "
+                                           "peer when it is full, when fbox_coalesce_count "
+                                           "messages have been packed, when another fragment is "
+                                           "sent to the peer, at the end of the progress call, "
+                                           "or when the sender flushes the endpoint before "
+                                           "returning to the application. This improves the message rate of bursts of "
+                                           "small messages. "
+                                           "Limited to a quarter of fbox_size (default: 0 - "
+                                           "disabled)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.fbox_coalesce_size);
+
+    mca_btl_sm_component.fbox_coalesce_count = 16;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "fbox_coalesce_count",
+                                           "Maximum number of messages packed into a coalesced "
+                                           "fast box record before it is made visible to the "
+                                           "peer (default: 16)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.fbox_coalesce_count);
+
+#if OPAL_BTL_SM_HAVE_FUTEX
+    mca_btl_sm_component.progress_spin_count = 0;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "progress_spin_count",
+                                           "Number of consecutive progress calls that find no "
+                                           "incoming shared memory traffic before the process "
+                                           "sleeps until a local peer sends to it or "
+                                           "progress_sleep_timeout expires. Reduces CPU usage "
+                                           "of idle processes in oversubscribed or hybrid "
+                                           "MPI+threads jobs. Should be set on all local "
+                                           "processes (default: 0 - never sleep)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.progress_spin_count);
+
+    mca_btl_sm_component.progress_sleep_timeout = 1000;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "progress_sleep_timeout",
+                                           "Maximum time in microseconds an idle process sleeps "
+                                           "before returning to the progress engine. Bounds the "
+                                           "delay seen by other transports and timers "
+                                           "(default: 1000)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.progress_sleep_timeout);
+
+    mca_btl_sm_component.progress_sleeps = 0;
+    (void) mca_base_component_pvar_register(&mca_btl_sm_component.super.btl_version,
+                                            "progress_sleeps",
+                                            "Number of times an idle process went to sleep "
+                                            "waiting for shared memory traffic",
+                                            OPAL_INFO_LVL_5, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &mca_btl_sm_component.progress_sleeps);
+#endif
+
+    mca_btl_sm_component.fbox_doorbell = true;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "fbox_doorbell",
+                                           "Only poll the fast boxes of peers that have signaled "
+                                           "new data in this process' doorbell bitmap instead of "
+                                           "polling every fast box on each progress call "
+                                           "(default: true)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.fbox_doorbell);
+
     mca_btl_sm_component.fbox_size = 4096;
     (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version, "fbox_size",
                                            "Size of per-peer fast transfer buffers. Must be a power of two (default: 4k)",
@@ -189,6 +307,76 @@ static int mca_btl_sm_component_register(void)
                                            MCA_BASE_VAR_SCOPE_LOCAL,
                                            &mca_btl_sm_component.fbox_size);
 
+    mca_btl_sm_component.numa_policy = MCA_BTL_SM_NUMA_POLICY_RECEIVER;
+    (void) mca_base_var_enum_create("btl_sm_numa_policies", mca_btl_sm_numa_policies, &new_enum);
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version, "numa_policy",
+                                           "Placement of the memory a process polls for incoming "
+                                           "messages. \"receiver\" binds each process' receive "
+                                           "fifo and the fast boxes peers allocate for it to the "
+                                           "NUMA node the receiving process is bound to, \"none\" "
+                                           "leaves placement to the operating system. Processes "
+                                           "that are not bound to a single NUMA node are not "
+                                           "affected and keep compact fast boxes (default: "
+                                           "receiver)",
+                                           MCA_BASE_VAR_TYPE_INT, new_enum, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.numa_policy);
+    OBJ_RELEASE(new_enum);
+
+    mca_btl_sm_component.numa_node = -1;
+    (void) mca_base_component_pvar_register(&mca_btl_sm_component.super.btl_version, "numa_node",
+                                            "NUMA node (OS index) the receive fifo of this "
+                                            "process is bound to (-1 if not bound)",
+                                            OPAL_INFO_LVL_5, MCA_BASE_PVAR_CLASS_GENERIC,
+                                            MCA_BASE_VAR_TYPE_INT, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &mca_btl_sm_component.numa_node);
+
+    mca_btl_sm_component.fbox_numa_placed = 0;
+    (void) mca_base_component_pvar_register(&mca_btl_sm_component.super.btl_version,
+                                            "fbox_numa_placed",
+                                            "Number of send fast boxes bound to the NUMA node of "
+                                            "the receiving process",
+                                            OPAL_INFO_LVL_5, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &mca_btl_sm_component.fbox_numa_placed);
+
+    mca_btl_sm_component.fbox_coalesced_records = 0;
+    (void) mca_base_component_pvar_register(&mca_btl_sm_component.super.btl_version,
+                                            "fbox_coalesced_records",
+                                            "Number of coalesced fast box records (each holding "
+                                            "one or more small messages) sent to local peers",
+                                            OPAL_INFO_LVL_5, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &mca_btl_sm_component.fbox_coalesced_records);
+
+    mca_btl_sm_component.numa_bind_failures = 0;
+    (void) mca_base_component_pvar_register(&mca_btl_sm_component.super.btl_version,
+                                            "numa_bind_failures",
+                                            "Number of failed attempts to bind a receive fifo or "
+                                            "fast box to a NUMA node",
+                                            OPAL_INFO_LVL_5, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &mca_btl_sm_component.numa_bind_failures);
+
+    mca_btl_sm_component_register_events();
+
     if (0 == access("/dev/shm", W_OK)) {
         mca_btl_sm_component.backing_directory = "/dev/shm";
     } else {
@@ -266,12 +454,80 @@ static int mca_btl_sm_component_close(void)
     return OPAL_SUCCESS;
 }
 
+/* returns the NUMA node (OS index) this process is bound to or -1 if the process is not bound
+ * within a single NUMA node */
+static int mca_btl_sm_local_numa_node(void)
+{
+    hwloc_bitmap_t cpuset, nodeset;
+    int node = -1;
+
+    if (OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return -1;
+    }
+
+    cpuset = hwloc_bitmap_alloc();
+    nodeset = hwloc_bitmap_alloc();
+    if (NULL != cpuset && NULL != nodeset
+        && 0 == hwloc_get_cpubind(opal_hwloc_topology, cpuset, HWLOC_CPUBIND_PROCESS)
+        && !hwloc_bitmap_iszero(cpuset)) {
+        hwloc_cpuset_to_nodeset(opal_hwloc_topology, cpuset, nodeset);
+        if (1 == hwloc_bitmap_weight(nodeset)) {
+            node = hwloc_bitmap_first(nodeset);
+        }
+    }
+
+    if (NULL != cpuset) {
+        hwloc_bitmap_free(cpuset);
+    }
+    if (NULL != nodeset) {
+        hwloc_bitmap_free(nodeset);
+    }
+
+    return node;
+}
+
+int mca_btl_sm_numa_bind(void *base, size_t size, int node)
+{
+    hwloc_bitmap_t nodeset;
+    int rc;
+
+    if (node < 0 || OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+
+    nodeset = hwloc_bitmap_alloc();
+    if (NULL == nodeset) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    hwloc_bitmap_only(nodeset, (unsigned) node);
+    /* migrate pages that have already been touched */
+#if HWLOC_API_VERSION >= 0x20000
+    rc = hwloc_set_area_membind(opal_hwloc_topology, base, size, nodeset, HWLOC_MEMBIND_BIND,
+                                HWLOC_MEMBIND_BYNODESET | HWLOC_MEMBIND_MIGRATE);
+#else
+    rc = hwloc_set_area_membind_nodeset(opal_hwloc_topology, base, size, nodeset,
+                                        HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_MIGRATE);
+#endif
+    hwloc_bitmap_free(nodeset);
+
+    if (0 != rc) {
+        BTL_VERBOSE(("could not bind %" PRIsize_t " bytes at %p to NUMA node %d. errno = %d",
+                     size, base, node, errno));
+        ++mca_btl_sm_component.numa_bind_failures;
+        return OPAL_ERROR;
+    }
+
+    return OPAL_SUCCESS;
+}
+
 static int mca_btl_base_sm_modex_send(void)
 {
     mca_btl_sm_modex_t modex;
     int modex_size;
 
     modex_size = sizeof(modex) - sizeof(modex.seg_ds);
+    modex.numa_node = mca_btl_sm_component.numa_node;
 
         modex.seg_ds_size = opal_shmem_sizeof_shmem_ds(&mca_btl_sm_component.seg_ds);
         memmove(&modex.seg_ds, &mca_btl_sm_component.seg_ds, modex.seg_ds_size);
@@ -336,6 +592,22 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
 
     /* no fast boxes allocated initially */
     component->num_fbox_in_endpoints = 0;
+    component->num_coalesce_endpoints = 0;
+
+    /* a coalesced record is reserved like any other fast box message */
+    if (component->fbox_coalesce_size) {
+        component->fbox_coalesce_size = opal_min(component->fbox_coalesce_size,
+                                                 (component->fbox_size >> 2)
+                                                     - sizeof(mca_btl_sm_fbox_hdr_t));
+        component->fbox_coalesce_size &= ~MCA_BTL_SM_FBOX_SUB_ALIGNMENT_MASK;
+        if (0 == component->fbox_coalesce_count) {
+            component->fbox_coalesce_count = 1;
+        }
+    }
+
+    /* the fifo and fast box doorbell live at the start of the segment */
+    component->doorbell_words = mca_btl_sm_doorbell_words();
+    component->fifo_reserved = mca_btl_sm_fifo_reserved_size();
 
     bool have_smsc = (NULL != mca_smsc);
     if (have_smsc) {
@@ -401,6 +673,17 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
         goto failed;
     }
 
+    /* the fifo and doorbell are polled by this process. bind them to our NUMA node before
+     * they are touched. */
+    component->numa_node = -1;
+    if (MCA_BTL_SM_NUMA_POLICY_RECEIVER == component->numa_policy) {
+        size_t page_size = (size_t) opal_getpagesize();
+        component->numa_node = mca_btl_sm_local_numa_node();
+        (void) mca_btl_sm_numa_bind(component->my_segment,
+                                    (component->fifo_reserved + page_size - 1) & ~(page_size - 1),
+                                    component->numa_node);
+    }
+
     /* initialize my fifo */
     sm_fifo_init((struct sm_fifo_t *) component->my_segment);
 
@@ -507,6 +790,7 @@ static void mca_btl_sm_progress_waiting(mca_btl_base_endpoint_t *ep)
     }
 
     OPAL_THREAD_LOCK(&ep->pending_frags_lock);
+    mca_btl_sm_fbox_coalesce_flush(ep);
     OPAL_LIST_FOREACH_SAFE (frag, next, &ep->pending_frags, mca_btl_sm_frag_t) {
         ret = sm_fifo_write_ep(frag->hdr, ep);
         if (!ret) {
@@ -546,16 +830,13 @@ static void mca_btl_sm_progress_endpoints(void)
     OPAL_THREAD_UNLOCK(&mca_btl_sm_component.lock);
 }
 
-static int mca_btl_sm_component_progress(void)
+static int mca_btl_sm_progress_once(void)
 {
-    static opal_atomic_int32_t lock = 0;
     int count = 0;
 
-    if (opal_using_threads()) {
-        if (opal_atomic_swap_32(&lock, 1)) {
-            return 0;
-        }
-    }
+    /* small messages sent from the receive callbacks may be coalesced until the end of
+     * this call */
+    mca_btl_sm_in_progress = true;
 
     /* check for messages in fast boxes */
     if (mca_btl_sm_component.num_fbox_in_endpoints) {
@@ -564,14 +845,97 @@ static int mca_btl_sm_component_progress(void)
 
     mca_btl_sm_progress_endpoints();
 
-    if (SM_FIFO_FREE == mca_btl_sm_component.my_fifo->fifo_head) {
-        lock = 0;
-        return count;
+    if (SM_FIFO_FREE != mca_btl_sm_component.my_fifo->fifo_head) {
+        count += mca_btl_sm_poll_fifo();
+    }
+
+    mca_btl_sm_in_progress = false;
+
+    /* make coalesced messages visible to the receivers */
+    if (mca_btl_sm_component.num_coalesce_endpoints) {
+        mca_btl_sm_fbox_coalesce_flush_all();
+    }
+
+    return count;
+}
+
+static opal_atomic_int32_t mca_btl_sm_progress_lock = 0;
+
+static inline bool mca_btl_sm_progress_trylock(void)
+{
+    return !opal_using_threads() || 0 == opal_atomic_swap_32(&mca_btl_sm_progress_lock, 1);
+}
+
+static inline void mca_btl_sm_progress_unlock(void)
+{
+    if (opal_using_threads()) {
+        opal_atomic_mb();
+        mca_btl_sm_progress_lock = 0;
     }
+}
 
-    count += mca_btl_sm_poll_fifo();
+#if OPAL_BTL_SM_HAVE_FUTEX
+/* called with the progress lock held after progress_spin_count idle progress calls. the lock
+ * is released while sleeping so other threads can progress. see btl_sm_wakeup.h */
+static int mca_btl_sm_progress_block(void)
+{
+    mca_btl_sm_component_t *component = &mca_btl_sm_component;
+    sm_fifo_t *fifo = component->my_fifo;
+    int32_t wakeup = fifo->wakeup;
+    int count;
+
+    (void) opal_atomic_add_fetch_32(&fifo->sleeping, 1);
     opal_atomic_mb();
-    lock = 0;
+
+    /* anything sent before the flag was visible is found here */
+    count = mca_btl_sm_progress_once();
+    if (0 != count || 0 != opal_list_get_size(&component->pending_endpoints)) {
+        (void) opal_atomic_add_fetch_32(&fifo->sleeping, -1);
+        mca_btl_sm_progress_unlock();
+        return count;
+    }
+
+    ++component->progress_sleeps;
+    mca_btl_sm_progress_unlock();
+
+    mca_btl_sm_wakeup_wait(fifo, wakeup, component->progress_sleep_timeout);
+    (void) opal_atomic_add_fetch_32(&fifo->sleeping, -1);
+
+    /* another thread may have progressed in the meantime */
+    if (!mca_btl_sm_progress_trylock()) {
+        return 0;
+    }
+    count = mca_btl_sm_progress_once();
+    mca_btl_sm_progress_unlock();
+
+    return count;
+}
+#endif
+
+static int mca_btl_sm_component_progress(void)
+{
+    int count;
+
+    if (!mca_btl_sm_progress_trylock()) {
+        return 0;
+    }
+
+    count = mca_btl_sm_progress_once();
+
+#if OPAL_BTL_SM_HAVE_FUTEX
+    if (OPAL_UNLIKELY(mca_btl_sm_component.progress_spin_count)) {
+        if (count) {
+            mca_btl_sm_component.progress_idle_count = 0;
+        } else if (++mca_btl_sm_component.progress_idle_count
+                   >= mca_btl_sm_component.progress_spin_count) {
+            mca_btl_sm_component.progress_idle_count = 0;
+            /* releases the lock */
+            return mca_btl_sm_progress_block();
+        }
+    }
+#endif
+
+    mca_btl_sm_progress_unlock();
 
     return count;
 }
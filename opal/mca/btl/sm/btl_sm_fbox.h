@@ -17,12 +17,23 @@
 
 #include "opal/mca/btl/sm/btl_sm_types.h"
 #include "opal/mca/btl/sm/btl_sm_virtual.h"
+#include "opal/mca/btl/sm/btl_sm_wakeup.h"
 #include "opal/util/minmax.h"
 
+#include <strings.h>
+
 #define MCA_BTL_SM_POLL_COUNT          31
 #define MCA_BTL_SM_FBOX_ALIGNMENT      32
 #define MCA_BTL_SM_FBOX_ALIGNMENT_MASK (MCA_BTL_SM_FBOX_ALIGNMENT - 1)
 
+/* fast box tags reserved by this btl */
+#define MCA_BTL_SM_FBOX_TAG_SKIP      0xff
+#define MCA_BTL_SM_FBOX_TAG_FRAG      0xfe
+#define MCA_BTL_SM_FBOX_TAG_COALESCED 0xfd
+
+#define MCA_BTL_SM_FBOX_SUB_ALIGNMENT      8
+#define MCA_BTL_SM_FBOX_SUB_ALIGNMENT_MASK (MCA_BTL_SM_FBOX_SUB_ALIGNMENT - 1)
+
 typedef union mca_btl_sm_fbox_hdr_t {
     struct {
         /* NTH: on 32-bit platforms loading/unloading the header may be completed
@@ -79,6 +90,18 @@ static inline void mca_btl_sm_endpoint_setup_fbox_send(struct mca_btl_base_endpo
     opal_atomic_wmb();
 }
 
+/**
+ * Header of each message in a coalesced fast box record. Messages are packed back to back
+ * with each header aligned to MCA_BTL_SM_FBOX_SUB_ALIGNMENT bytes.
+ */
+typedef struct mca_btl_sm_fbox_sub_hdr_t {
+    /** message size */
+    uint32_t size;
+    /** message tag */
+    uint8_t tag;
+    uint8_t padding[3];
+} mca_btl_sm_fbox_sub_hdr_t;
+
 #define MCA_BTL_SM_FBOX_HDR(x) ((mca_btl_sm_fbox_hdr_t *) (x))
 
 static inline unsigned int mca_btl_sm_fbox_out_free(mca_btl_sm_fbox_out_t *fbox_out, unsigned int fbox_size) {
@@ -121,6 +144,25 @@ static inline unsigned int mca_btl_sm_fbox_align(unsigned int size) {
     return (size + MCA_BTL_SM_FBOX_ALIGNMENT_MASK) & ~MCA_BTL_SM_FBOX_ALIGNMENT_MASK;
 }
 
+/* data of the fbox_full event */
+struct mca_btl_sm_fbox_full_event_t {
+    /** local rank of the receiver */
+    int32_t peer;
+    /** size of the message that did not fit */
+    uint32_t size;
+};
+typedef struct mca_btl_sm_fbox_full_event_t mca_btl_sm_fbox_full_event_t;
+
+static inline void mca_btl_sm_fbox_full(mca_btl_base_endpoint_t *ep, unsigned int data_size)
+{
+    mca_base_event_t *event = mca_btl_sm_component.fbox_full_event;
+
+    if (OPAL_UNLIKELY(event->active)) {
+        mca_btl_sm_fbox_full_event_t data = {.peer = ep->peer_smp_rank, .size = data_size};
+        mca_base_event_record(event, NULL, &data);
+    }
+}
+
 static inline unsigned char *mca_btl_sm_fbox_reserve_locked(mca_btl_base_endpoint_t *ep, unsigned int data_size) {
     const unsigned int fbox_size = mca_btl_sm_component.fbox_size;
     const unsigned int fbox_offset_mask = fbox_size - 1;
@@ -175,6 +217,7 @@ static inline unsigned char *mca_btl_sm_fbox_reserve_locked(mca_btl_base_endpoin
             if (OPAL_UNLIKELY(buffer_free < aligned_entry_size)) {
                 /* not writing the skip token so give this space back */
                 ep->fbox_out.end -= remaining;
+                mca_btl_sm_fbox_full(ep, data_size);
                 return NULL;
             }
 
@@ -189,6 +232,7 @@ static inline unsigned char *mca_btl_sm_fbox_reserve_locked(mca_btl_base_endpoin
         }
 
         if (buffer_free < aligned_entry_size) {
+            mca_btl_sm_fbox_full(ep, data_size);
             return NULL;
         }
     }
@@ -208,6 +252,174 @@ static inline unsigned char *mca_btl_sm_fbox_reserve_locked(mca_btl_base_endpoin
     return dst;
 }
 
+/* let the receiver know there is data in our fast box. the bit is always set (even if the
+ * receiver is not using the doorbell) so the doorbell setting does not need to be the same on
+ * all ranks. the word is read first to avoid an atomic when the bit is already set. the
+ * receiver swaps the word to zero before reading the headers, so either it sees the header
+ * or the bit is still clear when read here. */
+static inline void mca_btl_sm_fbox_ring_doorbell(mca_btl_base_endpoint_t *ep)
+{
+    /* full barrier: the fast box header store must not be reordered after the doorbell
+     * load, or a receiver clearing the doorbell in between would miss this message */
+    opal_atomic_mb();
+    if (!(*ep->doorbell & ep->doorbell_bit)) {
+        opal_atomic_fetch_or_32(ep->doorbell, ep->doorbell_bit);
+    }
+
+    mca_btl_sm_wakeup(ep->fifo);
+}
+
+static inline unsigned int mca_btl_sm_fbox_sub_align(unsigned int size)
+{
+    return (size + MCA_BTL_SM_FBOX_SUB_ALIGNMENT_MASK) & ~MCA_BTL_SM_FBOX_SUB_ALIGNMENT_MASK;
+}
+
+/* make the open coalesced record visible to the receiver. the unused tail of the record is
+ * given back to the fast box. must be called with the endpoint lock held. */
+static inline void mca_btl_sm_fbox_coalesce_close_locked(mca_btl_base_endpoint_t *ep)
+{
+    const unsigned int fbox_offset_mask = mca_btl_sm_component.fbox_size - 1;
+    unsigned char *dst = ep->fbox_out.coalesce_dst;
+    unsigned int unused;
+
+    if (NULL == dst) {
+        return;
+    }
+
+    ep->fbox_out.coalesce_dst = NULL;
+
+    /* nothing can have been reserved after the record while it was open */
+    assert(ep->fbox_out.end == ep->fbox_out.coalesce_end);
+    unused = mca_btl_sm_fbox_align(mca_btl_sm_component.fbox_coalesce_size
+                                   + sizeof(mca_btl_sm_fbox_hdr_t))
+             - mca_btl_sm_fbox_align(ep->fbox_out.coalesce_used + sizeof(mca_btl_sm_fbox_hdr_t));
+    if (unused) {
+        ep->fbox_out.end -= unused;
+        /* the next header now falls inside the old reservation */
+        MCA_BTL_SM_FBOX_HDR(ep->fbox_out.buffer + (ep->fbox_out.end & fbox_offset_mask))->ival = 0;
+    }
+
+    opal_atomic_wmb();
+    mca_btl_sm_fbox_set_header(MCA_BTL_SM_FBOX_HDR(dst), MCA_BTL_SM_FBOX_TAG_COALESCED,
+                               ep->fbox_out.coalesce_seq, ep->fbox_out.coalesce_used);
+    ++mca_btl_sm_component.fbox_coalesced_records;
+
+    mca_btl_sm_fbox_ring_doorbell(ep);
+}
+
+/* close the open coalesced record of an endpoint (if any). called before a fragment is
+ * written to the peer's fifo so it cannot overtake the coalesced messages and from
+ * btl_flush. */
+static inline void mca_btl_sm_fbox_coalesce_flush(mca_btl_base_endpoint_t *ep)
+{
+    if (OPAL_UNLIKELY(NULL != ep->fbox_out.coalesce_dst)) {
+        OPAL_THREAD_LOCK(&ep->lock);
+        mca_btl_sm_fbox_coalesce_close_locked(ep);
+        OPAL_THREAD_UNLOCK(&ep->lock);
+    }
+}
+
+/* close the open coalesced records of all endpoints. called at the end of progress and
+ * from btl_flush. */
+static inline void mca_btl_sm_fbox_coalesce_flush_all(void)
+{
+    mca_btl_sm_component_t *component = &mca_btl_sm_component;
+
+    OPAL_THREAD_LOCK(&component->lock);
+    for (int i = 0; i < component->num_coalesce_endpoints; ++i) {
+        mca_btl_base_endpoint_t *ep = component->coalesce_endpoints[i];
+
+        OPAL_THREAD_LOCK(&ep->lock);
+        mca_btl_sm_fbox_coalesce_close_locked(ep);
+        ep->fbox_out.coalesce_listed = false;
+        OPAL_THREAD_UNLOCK(&ep->lock);
+    }
+    component->num_coalesce_endpoints = 0;
+    OPAL_THREAD_UNLOCK(&component->lock);
+}
+
+/**
+ * Pack a small message into the open coalesced record for this endpoint,
+ * opening a new record if needed.
+ *
+ * The message is copied before returning but only becomes visible to the
+ * receiver when the record is closed: when it is full, when it holds
+ * fbox_coalesce_count messages, when anything else is sent to the peer, at
+ * the end of the progress call, or when btl_flush is called on the endpoint.
+ * Must only be called from the progress function of this btl (see
+ * mca_btl_sm_in_progress) or for a send with MCA_BTL_DES_FLAGS_DEFER, whose
+ * caller flushes the endpoint before returning to the application.
+ *
+ * @returns true if the message was packed
+ */
+static inline bool mca_btl_sm_fbox_coalesce(mca_btl_base_endpoint_t *ep, unsigned char tag,
+                                            void *restrict header, const size_t header_size,
+                                            void *restrict payload, const size_t payload_size)
+{
+    mca_btl_sm_component_t *component = &mca_btl_sm_component;
+    const size_t data_size = header_size + payload_size;
+    mca_btl_sm_fbox_sub_hdr_t *sub_hdr;
+    unsigned int entry_size;
+    bool opened = false;
+
+    if (OPAL_UNLIKELY(NULL == ep->fbox_out.buffer
+                      || data_size + sizeof(*sub_hdr) > component->fbox_coalesce_size)) {
+        return false;
+    }
+
+    entry_size = mca_btl_sm_fbox_sub_align((unsigned int) (data_size + sizeof(*sub_hdr)));
+
+    OPAL_THREAD_LOCK(&ep->lock);
+    if (NULL != ep->fbox_out.coalesce_dst
+        && ep->fbox_out.coalesce_used + entry_size > component->fbox_coalesce_size) {
+        mca_btl_sm_fbox_coalesce_close_locked(ep);
+    }
+
+    if (NULL == ep->fbox_out.coalesce_dst) {
+        unsigned char *dst = mca_btl_sm_fbox_reserve_locked(ep, component->fbox_coalesce_size);
+        if (OPAL_UNLIKELY(NULL == dst)) {
+            OPAL_THREAD_UNLOCK(&ep->lock);
+            return false;
+        }
+
+        ep->fbox_out.coalesce_dst = dst;
+        ep->fbox_out.coalesce_used = 0;
+        ep->fbox_out.coalesce_count = 0;
+        ep->fbox_out.coalesce_end = ep->fbox_out.end;
+        ep->fbox_out.coalesce_seq = ep->fbox_out.seq++;
+        opened = true;
+    }
+
+    sub_hdr = (mca_btl_sm_fbox_sub_hdr_t *) (ep->fbox_out.coalesce_dst
+                                             + sizeof(mca_btl_sm_fbox_hdr_t)
+                                             + ep->fbox_out.coalesce_used);
+    sub_hdr->size = (uint32_t) data_size;
+    sub_hdr->tag = tag;
+    memcpy(sub_hdr + 1, header, header_size);
+    if (payload) {
+        memcpy((unsigned char *) (sub_hdr + 1) + header_size, payload, payload_size);
+    }
+
+    ep->fbox_out.coalesce_used += entry_size;
+    if (++ep->fbox_out.coalesce_count >= component->fbox_coalesce_count) {
+        mca_btl_sm_fbox_coalesce_close_locked(ep);
+        opened = false;
+    }
+    OPAL_THREAD_UNLOCK(&ep->lock);
+
+    if (opened) {
+        /* make sure progress closes the record */
+        OPAL_THREAD_LOCK(&component->lock);
+        if (!ep->fbox_out.coalesce_listed) {
+            ep->fbox_out.coalesce_listed = true;
+            component->coalesce_endpoints[component->num_coalesce_endpoints++] = ep;
+        }
+        OPAL_THREAD_UNLOCK(&component->lock);
+    }
+
+    return true;
+}
+
 /* attempt to reserve a contiguous segment from the remote ep */
 static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned char tag,
                                          void *restrict header, const size_t header_size,
@@ -216,6 +428,10 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
     size_t data_size = header_size + payload_size;
 
     OPAL_THREAD_LOCK(&ep->lock);
+    /* keep messages in order */
+    if (OPAL_UNLIKELY(NULL != ep->fbox_out.coalesce_dst)) {
+        mca_btl_sm_fbox_coalesce_close_locked(ep);
+    }
     unsigned char *dst = mca_btl_sm_fbox_reserve_locked(ep, (unsigned int) data_size);
     OPAL_THREAD_UNLOCK(&ep->lock);
     if (OPAL_UNLIKELY(NULL == dst)) {
@@ -235,9 +451,38 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
     mca_btl_sm_fbox_set_header(MCA_BTL_SM_FBOX_HDR(dst), tag, ep->fbox_out.seq++,
                                (uint32_t) data_size);
 
+    mca_btl_sm_fbox_ring_doorbell(ep);
+
     return true;
 }
 
+/* deliver each message of a coalesced record */
+static inline void mca_btl_sm_fbox_demux(mca_btl_base_endpoint_t *ep, unsigned char *data,
+                                         uint32_t size)
+{
+    while (size) {
+        mca_btl_sm_fbox_sub_hdr_t *sub_hdr = (mca_btl_sm_fbox_sub_hdr_t *) data;
+        const unsigned int entry_size = mca_btl_sm_fbox_sub_align(sub_hdr->size
+                                                                  + sizeof(*sub_hdr));
+        const mca_btl_active_message_callback_t *reg = mca_btl_base_active_message_trigger
+            + sub_hdr->tag;
+        mca_btl_base_segment_t segment = {.seg_addr.pval = (void *) (sub_hdr + 1),
+                                          .seg_len = sub_hdr->size};
+        mca_btl_base_receive_descriptor_t desc = {.endpoint = ep,
+                                                  .des_segments = &segment,
+                                                  .des_segment_count = 1,
+                                                  .tag = sub_hdr->tag,
+                                                  .cbdata = reg->cbdata};
+
+        assert(entry_size <= size);
+
+        reg->cbfunc(&mca_btl_sm.super, &desc);
+
+        data += entry_size;
+        size -= entry_size;
+    }
+}
+
 static inline bool mca_btl_sm_poll_fbox(mca_btl_base_endpoint_t *ep)
 {
     const unsigned int fbox_offset_mask = mca_btl_sm_component.fbox_size - 1;
@@ -260,7 +505,10 @@ static inline bool mca_btl_sm_poll_fbox(mca_btl_base_endpoint_t *ep)
          ep->peer_smp_rank, hdr.data.tag, hdr.data.size, hdr.data.seq, start_offset));
 
     /* the 0xff tag indicates we should skip the rest of the buffer */
-    if (OPAL_LIKELY((0xfe & hdr.data.tag) != 0xfe)) {
+    if (OPAL_UNLIKELY(MCA_BTL_SM_FBOX_TAG_COALESCED == hdr.data.tag)) {
+        mca_btl_sm_fbox_demux(ep, ep->fbox_in.buffer + start_offset + sizeof(hdr),
+                              hdr.data.size);
+    } else if (OPAL_LIKELY((0xfe & hdr.data.tag) != 0xfe)) {
         mca_btl_base_segment_t segment;
         const mca_btl_active_message_callback_t *reg = mca_btl_base_active_message_trigger
             + hdr.data.tag;
@@ -292,29 +540,84 @@ static inline bool mca_btl_sm_poll_fbox(mca_btl_base_endpoint_t *ep)
     return true;
 }
 
-static inline int mca_btl_sm_check_fboxes(void)
+/* returns the number of fragments processed. if this number is MCA_BTL_SM_POLL_COUNT the
+ * fast box may not be empty. */
+static inline int mca_btl_sm_check_fbox(mca_btl_base_endpoint_t *ep)
+{
+    int frag_count = 0;
+
+    for (int j = 0 ; j < MCA_BTL_SM_POLL_COUNT ; ++j) {
+        if (!mca_btl_sm_poll_fbox(ep)) {
+            break;
+        }
+        ++frag_count;
+    }
+
+    if (frag_count) {
+        BTL_VERBOSE(("finished processing at offset %x", ep->fbox_in.start));
+
+        /* let the sender know where we stopped */
+        opal_atomic_mb();
+        ep->fbox_in.metadata->start = ep->fbox_in.start;
+    }
+
+    return frag_count;
+}
+
+/* poll only the fast boxes of senders that rang the doorbell. bits are carried over in
+ * fbox_pending if the fast box was not drained or has not been set up yet (the sender's
+ * setup fragment may still be in the fifo). */
+static inline int mca_btl_sm_check_fboxes_doorbell(void)
 {
+    mca_btl_sm_component_t *component = &mca_btl_sm_component;
     int total_processed = 0;
 
-    for (unsigned int i = 0; i < mca_btl_sm_component.num_fbox_in_endpoints; ++i) {
-        mca_btl_base_endpoint_t *ep = mca_btl_sm_component.fbox_in_endpoints[i];
+    for (unsigned int i = 0; i < component->doorbell_words; ++i) {
+        uint32_t pending = component->fbox_pending[i];
+        uint32_t carry = 0;
 
-        int frag_count = 0;
-        for (int j = 0 ; j < MCA_BTL_SM_POLL_COUNT ; ++j) {
-            if (!mca_btl_sm_poll_fbox(ep)) {
-                break;
-            }
-            ++frag_count;
+        /* avoid taking the cache line exclusive when nobody rang */
+        if (component->my_doorbell[i]) {
+            pending |= (uint32_t) opal_atomic_swap_32(component->my_doorbell + i, 0);
+            /* read the fast box headers after clearing the doorbell (pairs with the full
+             * barrier in mca_btl_sm_fbox_ring_doorbell) */
+            opal_atomic_mb();
         }
 
-        if (frag_count) {
-            BTL_VERBOSE(("finished processing at offset %x", ep->fbox_in.start));
+        while (pending) {
+            int bit = ffs((int) pending) - 1;
+            mca_btl_base_endpoint_t *ep = component->endpoints + (i << 5) + bit;
 
-            /* let the sender know where we stopped */
-            opal_atomic_mb();
-            ep->fbox_in.metadata->start = ep->fbox_in.start;
+            pending &= pending - 1;
+
+            if (OPAL_UNLIKELY(NULL == ep->fbox_in.buffer)) {
+                carry |= 1u << bit;
+                continue;
+            }
+
+            int frag_count = mca_btl_sm_check_fbox(ep);
+            if (MCA_BTL_SM_POLL_COUNT == frag_count) {
+                carry |= 1u << bit;
+            }
             total_processed += frag_count;
         }
+
+        component->fbox_pending[i] = carry;
+    }
+
+    return total_processed;
+}
+
+static inline int mca_btl_sm_check_fboxes(void)
+{
+    int total_processed = 0;
+
+    if (mca_btl_sm_component.fbox_doorbell) {
+        return mca_btl_sm_check_fboxes_doorbell();
+    }
+
+    for (unsigned int i = 0; i < mca_btl_sm_component.num_fbox_in_endpoints; ++i) {
+        total_processed += mca_btl_sm_check_fbox(mca_btl_sm_component.fbox_in_endpoints[i]);
     }
 
     return total_processed;
@@ -333,6 +636,15 @@ static inline void mca_btl_sm_try_fbox_setup(mca_btl_base_endpoint_t *ep, mca_bt
             opal_free_list_item_t *fbox = opal_free_list_get(&mca_btl_sm_component.sm_fboxes);
 
             if (NULL != fbox) {
+                /* the receiver polls the fast box so place it on the receiver's NUMA node
+                 * before it is touched */
+                if (mca_btl_sm_component.fbox_page_aligned && ep->numa_node >= 0
+                    && OPAL_SUCCESS == mca_btl_sm_numa_bind(fbox->ptr,
+                                                            mca_btl_sm_component.fbox_alloc_size,
+                                                            ep->numa_node)) {
+                    ++mca_btl_sm_component.fbox_numa_placed;
+                }
+
                 /* zero out the fast box */
                 memset(fbox->ptr, 0, mca_btl_sm_component.fbox_size);
                 mca_btl_sm_endpoint_setup_fbox_send(ep, fbox);
@@ -32,6 +32,7 @@
 #include "opal/mca/btl/sm/btl_sm_fbox.h"
 #include "opal/mca/btl/sm/btl_sm_types.h"
 #include "opal/mca/btl/sm/btl_sm_virtual.h"
+#include "opal/mca/btl/sm/btl_sm_wakeup.h"
 
 #define sm_item_compare_exchange(x, y, z)                                                   \
     opal_atomic_compare_exchange_strong_ptr((opal_atomic_intptr_t *) (x), (intptr_t *) (y), \
@@ -56,6 +57,27 @@
 /* large enough to ensure the fifo is on its own cache line */
 #define MCA_BTL_SM_FIFO_SIZE 128
 
+/*
+ * Fast box doorbell
+ *
+ * The fifo is followed by a bitmap with one bit per local rank. A sender sets its
+ * bit in the receiver's doorbell after writing to its fast box so the receiver only
+ * needs to poll the fast boxes of peers that have sent something. The bitmap is
+ * padded to a multiple of MCA_BTL_SM_FIFO_SIZE so the rest of the segment keeps its
+ * alignment.
+ */
+static inline unsigned int mca_btl_sm_doorbell_words(void)
+{
+    return (MCA_BTL_SM_NUM_LOCAL_PEERS + 32) >> 5;
+}
+
+static inline size_t mca_btl_sm_fifo_reserved_size(void)
+{
+    size_t doorbell_size = mca_btl_sm_doorbell_words() * sizeof(opal_atomic_int32_t);
+    return MCA_BTL_SM_FIFO_SIZE
+           + ((doorbell_size + MCA_BTL_SM_FIFO_SIZE - 1) & ~((size_t) MCA_BTL_SM_FIFO_SIZE - 1));
+}
+
 /**
  * sm_fifo_read:
  *
@@ -114,7 +136,15 @@ static inline void sm_fifo_init(sm_fifo_t *fifo)
     fifo->fifo_head = SM_FIFO_FREE;
     fifo->fifo_tail = SM_FIFO_FREE;
     fifo->fbox_available = mca_btl_sm_component.fbox_max;
+    fifo->sleeping = 0;
+    fifo->wakeup = 0;
     mca_btl_sm_component.my_fifo = fifo;
+
+    mca_btl_sm_component.my_doorbell = (opal_atomic_int32_t *) ((char *) fifo
+                                                                + MCA_BTL_SM_FIFO_SIZE);
+    for (unsigned int i = 0; i < mca_btl_sm_component.doorbell_words; ++i) {
+        mca_btl_sm_component.my_doorbell[i] = 0;
+    }
 }
 
 static inline void sm_fifo_write(sm_fifo_t *fifo, fifo_value_t value)
@@ -135,6 +165,8 @@ static inline void sm_fifo_write(sm_fifo_t *fifo, fifo_value_t value)
     }
 
     opal_atomic_wmb();
+
+    mca_btl_sm_wakeup(fifo);
 }
 
 /**
@@ -35,6 +35,7 @@
 #include "opal/mca/btl/sm/btl_sm_fifo.h"
 #include "opal/mca/btl/sm/btl_sm_frag.h"
 #include "opal/mca/smsc/smsc.h"
+#include "opal/util/sys_limits.h"
 
 #include <string.h>
 
@@ -60,11 +61,12 @@ mca_btl_sm_t mca_btl_sm = {
     {&mca_btl_sm_component.super, .btl_add_procs = sm_add_procs, .btl_del_procs = sm_del_procs,
      .btl_finalize = sm_finalize, .btl_alloc = mca_btl_sm_alloc, .btl_free = mca_btl_sm_free,
      .btl_prepare_src = sm_prepare_src, .btl_send = mca_btl_sm_send, .btl_sendi = mca_btl_sm_sendi,
-     .btl_dump = mca_btl_base_dump, .btl_register_error = sm_register_error_cb}};
+     .btl_flush = mca_btl_sm_flush, .btl_dump = mca_btl_base_dump, .btl_register_error = sm_register_error_cb}};
 
 static int sm_btl_first_time_init(mca_btl_sm_t *sm_btl, int n)
 {
     mca_btl_sm_component_t *component = &mca_btl_sm_component;
+    size_t fbox_alignment;
     int rc;
 
     /* generate the endpoints */
@@ -81,21 +83,50 @@ static int sm_btl_first_time_init(mca_btl_sm_t *sm_btl, int n)
         return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
+    component->fbox_pending = calloc(component->doorbell_words, sizeof(uint32_t));
+    if (NULL == component->fbox_pending) {
+        free(component->fbox_in_endpoints);
+        free(component->endpoints);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    component->coalesce_endpoints = calloc(n + 1, sizeof(void *));
+    if (NULL == component->coalesce_endpoints) {
+        free(component->fbox_pending);
+        free(component->fbox_in_endpoints);
+        free(component->endpoints);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
     component->mpool = mca_mpool_basic_create((void *) (component->my_segment
-                                                        + MCA_BTL_SM_FIFO_SIZE),
+                                                        + component->fifo_reserved),
                                               (unsigned long) (mca_btl_sm_component.segment_size
-                                                               - MCA_BTL_SM_FIFO_SIZE),
+                                                               - component->fifo_reserved),
                                               64);
     if (NULL == component->mpool) {
         free(component->endpoints);
         return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
-    /* Fast box buffers are prepended with a metadata section. */
+    /* Fast box buffers are prepended with a metadata section. When fast boxes are placed on the
+     * receiver's NUMA node each one needs its own pages. This is only done when this process is
+     * bound to a NUMA node: unbound processes keep the compact layout (and do not place the fast
+     * boxes they allocate). */
+    component->fbox_alloc_size = mca_btl_sm_component.fbox_size
+                                 + sizeof(mca_btl_sm_fbox_metadata_t);
+    fbox_alignment = opal_cache_line_size;
+    component->fbox_page_aligned = MCA_BTL_SM_NUMA_POLICY_RECEIVER == component->numa_policy
+                                   && component->numa_node >= 0;
+    if (component->fbox_page_aligned) {
+        size_t page_size = (size_t) opal_getpagesize();
+        component->fbox_alloc_size = (component->fbox_alloc_size + page_size - 1)
+                                     & ~(page_size - 1);
+        fbox_alignment = page_size;
+    }
+
     rc = opal_free_list_init(&component->sm_fboxes, sizeof(opal_free_list_item_t), 8,
-                             OBJ_CLASS(opal_free_list_item_t), mca_btl_sm_component.fbox_size +
-                             sizeof (mca_btl_sm_fbox_metadata_t),
-                             opal_cache_line_size, 0, mca_btl_sm_component.fbox_max, 4,
+                             OBJ_CLASS(opal_free_list_item_t), component->fbox_alloc_size,
+                             fbox_alignment, 0, mca_btl_sm_component.fbox_max, 4,
                              component->mpool, 0, NULL, NULL, NULL);
     if (OPAL_SUCCESS != rc) {
         return rc;
@@ -193,6 +224,7 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
             }
 
             memcpy(ep->seg_ds, &modex->seg_ds, modex->seg_ds_size);
+            ep->numa_node = modex->numa_node;
 
             ep->segment_base = opal_shmem_segment_attach(ep->seg_ds);
             if (NULL == ep->segment_base) {
@@ -205,10 +237,16 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
     } else {
         /* set up the segment base so we can calculate a virtual to real for local pointers */
         ep->segment_base = component->my_segment;
+        ep->numa_node = component->numa_node;
     }
 
     ep->fifo = (struct sm_fifo_t *) ep->segment_base;
 
+    /* my bit in the peer's fast box doorbell */
+    ep->doorbell = (opal_atomic_int32_t *) (ep->segment_base + MCA_BTL_SM_FIFO_SIZE)
+                   + (MCA_BTL_SM_LOCAL_RANK >> 5);
+    ep->doorbell_bit = (int32_t) (1u << (MCA_BTL_SM_LOCAL_RANK & 31));
+
     return OPAL_SUCCESS;
 }
 
@@ -347,6 +385,12 @@ static int sm_finalize(struct mca_btl_base_module_t *btl)
     free(component->fbox_in_endpoints);
     component->fbox_in_endpoints = NULL;
 
+    free(component->fbox_pending);
+    component->fbox_pending = NULL;
+
+    free(component->coalesce_endpoints);
+    component->coalesce_endpoints = NULL;
+
     opal_shmem_unlink(&mca_btl_sm_component.seg_ds);
     opal_shmem_segment_detach(&mca_btl_sm_component.seg_ds);
 
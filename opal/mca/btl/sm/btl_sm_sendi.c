@@ -59,9 +59,20 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
         opal_convertor_get_current_pointer(convertor, &data_ptr);
     }
 
-    if (!(payload_size && (opal_convertor_need_buffers(convertor) || opal_convertor_on_device(convertor)))
-        && mca_btl_sm_fbox_sendi(endpoint, tag, header, header_size, data_ptr, payload_size)) {
-        return OPAL_SUCCESS;
+    if (!(payload_size && (opal_convertor_need_buffers(convertor) || opal_convertor_on_device(convertor)))) {
+        /* small messages sent from progress may be packed with other messages to the same
+         * peer. the record is closed before progress returns or, for deferred messages,
+         * when the caller flushes the endpoint. */
+        if (mca_btl_sm_component.fbox_coalesce_size
+            && (mca_btl_sm_in_progress || (flags & MCA_BTL_DES_FLAGS_DEFER))
+            && mca_btl_sm_fbox_coalesce(endpoint, tag, header, header_size, data_ptr,
+                                        payload_size)) {
+            return OPAL_SUCCESS;
+        }
+
+        if (mca_btl_sm_fbox_sendi(endpoint, tag, header, header_size, data_ptr, payload_size)) {
+            return OPAL_SUCCESS;
+        }
     }
 
     length = header_size + payload_size;
@@ -100,6 +111,9 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
         assert(length == payload_size);
     }
 
+    /* keep messages in order */
+    mca_btl_sm_fbox_coalesce_flush(endpoint);
+
     /* write the fragment pointer to peer's the FIFO. the progress function will return the fragment
      */
     if (!sm_fifo_write_ep(frag->hdr, endpoint)) {
@@ -113,3 +127,16 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
 
     return OPAL_SUCCESS;
 }
+
+int mca_btl_sm_flush(struct mca_btl_base_module_t *btl, struct mca_btl_base_endpoint_t *endpoint)
+{
+    (void) btl;
+
+    if (NULL != endpoint) {
+        mca_btl_sm_fbox_coalesce_flush(endpoint);
+    } else if (mca_btl_sm_component.num_coalesce_endpoints) {
+        mca_btl_sm_fbox_coalesce_flush_all();
+    }
+
+    return OPAL_SUCCESS;
+}
@@ -34,6 +34,7 @@
 
 #include "opal_config.h"
 #include "opal/class/opal_free_list.h"
+#include "opal/mca/base/mca_base_event.h"
 #include "opal/mca/btl/btl.h"
 #include "opal/mca/smsc/smsc.h"
 
@@ -42,6 +43,8 @@
  */
 struct mca_btl_sm_modex_t {
     uint64_t segment_base;
+    /** NUMA node (OS index) this process is bound to or -1 if unknown */
+    int numa_node;
     int seg_ds_size;
     /* seg_ds needs to be the last element */
     opal_shmem_ds_t seg_ds;
@@ -60,6 +63,14 @@ typedef struct mca_btl_sm_fbox_out {
     unsigned int start, end;
     uint16_t seq;
     opal_free_list_item_t *fbox; /**< fast-box free list item */
+
+    /* open coalesced record (see mca_btl_sm_fbox_coalesce) */
+    unsigned char *coalesce_dst;  /**< start of the open record in the fast box (NULL if none) */
+    unsigned int coalesce_used;   /**< bytes of the record filled with messages */
+    unsigned int coalesce_count;  /**< number of messages in the record */
+    unsigned int coalesce_end;    /**< value of end after the record was reserved */
+    uint16_t coalesce_seq;        /**< sequence number of the record */
+    bool coalesce_listed;         /**< endpoint is on the component coalesce list */
 } mca_btl_sm_fbox_out_t;
 
 typedef struct mca_btl_sm_fbox_in {
@@ -83,6 +94,9 @@ typedef struct mca_btl_base_endpoint_t {
                                     *   of this process) */
 
     struct sm_fifo_t *fifo; /**< */
+    opal_atomic_int32_t *doorbell; /**< word of the peer's fast box doorbell holding my bit */
+    int32_t doorbell_bit;          /**< my bit in the peer's fast box doorbell */
+    int numa_node;                 /**< NUMA node of the peer (-1 if unknown) */
 
     opal_mutex_t lock; /**< lock to protect endpoint structures from concurrent
                         *   access */
@@ -123,6 +137,24 @@ struct mca_btl_sm_component_t {
         fbox_threshold; /**< number of sends required before we setup a send fast box for a peer */
     unsigned int fbox_max;  /**< maximum number of send fast boxes to allocate */
     unsigned int fbox_size; /**< size of each peer fast box allocation */
+    size_t fbox_alloc_size; /**< size of each fast box free list element (including metadata) */
+    bool fbox_page_aligned; /**< fast boxes have their own pages and can be bound to a NUMA node */
+    bool fbox_doorbell;     /**< only poll fast boxes whose sender rang the doorbell */
+    unsigned int fbox_coalesce_size;  /**< size of a coalesced fast box record (0: disabled) */
+    unsigned int fbox_coalesce_count; /**< maximum number of messages in a coalesced record */
+    unsigned long fbox_coalesced_records; /**< coalesced records made visible to a peer */
+
+    unsigned int progress_spin_count;     /**< idle progress calls before sleeping (0: never) */
+    unsigned int progress_sleep_timeout;  /**< maximum time to sleep (microseconds) */
+    unsigned int progress_idle_count;     /**< consecutive progress calls that found nothing */
+    unsigned long progress_sleeps;        /**< number of times progress went to sleep */
+
+    int numa_policy; /**< where to place receive fifos and fast boxes (mca_btl_sm_numa_policy_t) */
+    int numa_node;   /**< NUMA node (OS index) this process is bound to or -1 if unknown */
+    unsigned long fbox_numa_placed;   /**< fast boxes bound to the receiver's NUMA node */
+    unsigned long numa_bind_failures; /**< number of failed memory binding attempts */
+
+    mca_base_event_t *fbox_full_event; /**< MPI_T event raised when a fast box is full */
 
     int single_copy_mechanism; /**< single copy mechanism to use */
 
@@ -133,7 +165,16 @@ struct mca_btl_sm_component_t {
         *endpoints; /**< array of local endpoints (one for each local peer including myself) */
     mca_btl_base_endpoint_t **fbox_in_endpoints; /**< array of fast box in endpoints */
     unsigned int num_fbox_in_endpoints;          /**< number of fast boxes to poll */
+    mca_btl_base_endpoint_t **coalesce_endpoints; /**< endpoints that may have an open
+                                                   *   coalesced record */
+    opal_atomic_int32_t num_coalesce_endpoints;   /**< number of entries in coalesce_endpoints */
     struct sm_fifo_t *my_fifo;                   /**< pointer to the local fifo */
+    opal_atomic_int32_t *my_doorbell; /**< fast box doorbell (one bit per local rank), follows
+                                       *   the fifo in my_segment */
+    uint32_t *fbox_pending;           /**< doorbell bits that still need service (local) */
+    unsigned int doorbell_words;      /**< number of 32-bit words in the doorbell */
+    size_t fifo_reserved;             /**< bytes reserved at the start of each segment for the
+                                       *   fifo and the doorbell */
 
     opal_list_t pending_endpoints; /**< list of endpoints with pending fragments */
     opal_list_t pending_fragments; /**< fragments pending remote completion */
@@ -154,6 +195,14 @@ struct mca_btl_sm_t {
 };
 typedef struct mca_btl_sm_t mca_btl_sm_t;
 
+enum mca_btl_sm_numa_policy_t {
+    /** leave placement to the operating system (first touch) */
+    MCA_BTL_SM_NUMA_POLICY_NONE = 0,
+    /** bind receive fifos and fast boxes to the NUMA node of the receiving process */
+    MCA_BTL_SM_NUMA_POLICY_RECEIVER = 1,
+};
+typedef enum mca_btl_sm_numa_policy_t mca_btl_sm_numa_policy_t;
+
 enum {
     MCA_BTL_SM_FLAG_INLINE = 0,
     MCA_BTL_SM_FLAG_SINGLE_COPY = 1,
@@ -240,6 +289,10 @@ struct sm_fifo_t {
     atomic_fifo_value_t fifo_head;
     atomic_fifo_value_t fifo_tail;
     opal_atomic_int32_t fbox_available;
+    /** number of the owner's threads that may be sleeping in mca_btl_sm_progress_block() */
+    opal_atomic_int32_t sleeping;
+    /** futex word. bumped by senders that found the owner sleeping */
+    opal_atomic_int32_t wakeup;
 };
 typedef struct sm_fifo_t sm_fifo_t;
 
@@ -0,0 +1,76 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Blocking progress
+ *
+ * When btl_sm_progress_spin_count is non-zero a process that has called
+ * progress that many times in a row without finding anything to do sets
+ * the sleeping flag in its fifo and waits on the wakeup futex word next to
+ * it. Senders check the flag after making a fragment or fast box message
+ * visible and wake the receiver only when it is set. The sleep is bounded
+ * by btl_sm_progress_sleep_timeout so other components registered with
+ * opal_progress still make progress.
+ *
+ * The receiver reads the futex word before setting the flag and polls once
+ * more after setting it. A sender that misses the flag wrote its message
+ * before that final poll. A sender that sees the flag changes the futex
+ * word so the wait returns immediately.
+ *
+ * The progress lock is released before waiting so other threads of the
+ * process keep progressing. The flag counts the sleeping threads and a
+ * sender wakes all of them.
+ */
+#ifndef MCA_BTL_SM_WAKEUP_H
+#define MCA_BTL_SM_WAKEUP_H
+
+#include "opal_config.h"
+
+#include "opal/mca/btl/sm/btl_sm_types.h"
+
+#if OPAL_BTL_SM_HAVE_FUTEX
+#    include <limits.h>
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+/* wake the owner of {fifo} if it is sleeping. called after a message has been made visible. */
+static inline void mca_btl_sm_wakeup(sm_fifo_t *fifo)
+{
+#if OPAL_BTL_SM_HAVE_FUTEX
+    if (0 == mca_btl_sm_component.progress_spin_count) {
+        return;
+    }
+
+    /* order the message before the read of the sleeping flag */
+    opal_atomic_mb();
+    if (OPAL_UNLIKELY(fifo->sleeping)) {
+        (void) opal_atomic_add_fetch_32(&fifo->wakeup, 1);
+        (void) syscall(SYS_futex, &fifo->wakeup, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+#else
+    (void) fifo;
+#endif
+}
+
+#if OPAL_BTL_SM_HAVE_FUTEX
+/* sleep until a sender changes the wakeup word from {value} or the timeout expires */
+static inline void mca_btl_sm_wakeup_wait(sm_fifo_t *fifo, int32_t value, unsigned int timeout_us)
+{
+    struct timespec timeout = {.tv_sec = timeout_us / 1000000,
+                               .tv_nsec = (long) (timeout_us % 1000000) * 1000};
+
+    (void) syscall(SYS_futex, &fifo->wakeup, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+#endif
+
+#endif /* MCA_BTL_SM_WAKEUP_H */
@@ -22,6 +22,14 @@
 AC_DEFUN([MCA_opal_btl_sm_CONFIG],[
     AC_CONFIG_FILES([opal/mca/btl/sm/Makefile])
 
+    # shared futexes are used to put idle receivers to sleep (optional)
+    btl_sm_have_futex=0
+    AC_CHECK_HEADERS([linux/futex.h],
+                     [AC_CHECK_DECL([SYS_futex], [btl_sm_have_futex=1], [],
+                                    [[#include <sys/syscall.h>]])])
+    AC_DEFINE_UNQUOTED([OPAL_BTL_SM_HAVE_FUTEX], [$btl_sm_have_futex],
+                       [Whether btl/sm can block idle receivers on a shared futex])
+
     # always happy
     $1
 
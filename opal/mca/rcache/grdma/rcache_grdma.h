@@ -30,6 +30,7 @@
 
 #include "opal_config.h"
 #include "opal/class/opal_list.h"
+#include "opal/mca/base/mca_base_event.h"
 #include "opal/mca/rcache/rcache.h"
 #include "opal/util/event.h"
 #if HAVE_SYS_MMAN_H
@@ -57,6 +58,8 @@ struct mca_rcache_grdma_component_t {
     char *rcache_name;
     bool print_stats;
     int leave_pinned;
+    /** MPI_T event raised when a registration is evicted from the cache */
+    mca_base_event_t *evict_event;
 };
 typedef struct mca_rcache_grdma_component_t mca_rcache_grdma_component_t;
 
@@ -77,6 +80,15 @@ struct mca_rcache_grdma_module_t {
 };
 typedef struct mca_rcache_grdma_module_t mca_rcache_grdma_module_t;
 
+/* data of the evict event */
+struct mca_rcache_grdma_evict_event_t {
+    /** base address of the evicted registration */
+    uint64_t base;
+    /** size of the evicted registration */
+    uint64_t size;
+};
+typedef struct mca_rcache_grdma_evict_event_t mca_rcache_grdma_evict_event_t;
+
 /*
  *  Initializes the rcache module.
  */
@@ -75,6 +75,11 @@ static int grdma_open(void)
 
 static int grdma_register(void)
 {
+    static const mca_base_var_type_t evict_types[] = {MCA_BASE_VAR_TYPE_UINT64_T,
+                                                      MCA_BASE_VAR_TYPE_UINT64_T};
+    static const ptrdiff_t evict_offsets[] = {offsetof(mca_rcache_grdma_evict_event_t, base),
+                                              offsetof(mca_rcache_grdma_evict_event_t, size)};
+
     mca_rcache_grdma_component.print_stats = false;
     (void) mca_base_component_var_register(
         &mca_rcache_grdma_component.super.rcache_version, "print_stats",
@@ -82,6 +87,13 @@ static int grdma_register(void)
         NULL, 0, 0, OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
         &mca_rcache_grdma_component.print_stats);
 
+    (void) mca_base_component_event_register(
+        &mca_rcache_grdma_component.super.rcache_version, "evict",
+        "A registration was evicted from the registration cache to make room for a new one. "
+        "Elements: base address, size",
+        OPAL_INFO_LVL_5, MCA_BASE_VAR_BIND_NO_OBJECT, 2, evict_types, evict_offsets,
+        sizeof(mca_rcache_grdma_evict_event_t), &mca_rcache_grdma_component.evict_event);
+
     return OPAL_SUCCESS;
 }
 
@@ -213,6 +213,13 @@ static inline bool mca_rcache_grdma_evict_lru_local(mca_rcache_grdma_cache_t *ca
 
     rcache_grdma = (mca_rcache_grdma_module_t *) old_reg->rcache;
 
+    if (OPAL_UNLIKELY(mca_rcache_grdma_component.evict_event->active)) {
+        mca_rcache_grdma_evict_event_t data = {.base = (uintptr_t) old_reg->base,
+                                               .size = (uint64_t) (old_reg->bound - old_reg->base
+                                                                   + 1)};
+        mca_base_event_record(mca_rcache_grdma_component.evict_event, NULL, &data);
+    }
+
     (void) dereg_mem(old_reg);
     rcache_grdma->stat_evicted++;
 
@@ -24,6 +24,13 @@ int mca_smsc_accelerator_copy_to(mca_smsc_endpoint_t *endpoint, void *local_addr
 int mca_smsc_accelerator_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address,
                              void *remote_address, size_t size, void *reg_handle);
 
+int mca_smsc_accelerator_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                     size_t local_iov_count, const struct iovec *remote_iov,
+                                     size_t remote_iov_count, void *reg_data);
+int mca_smsc_accelerator_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                       size_t local_iov_count, const struct iovec *remote_iov,
+                                       size_t remote_iov_count, void *reg_data);
+
 void *mca_smsc_accelerator_map_peer_region(mca_smsc_endpoint_t *endpoint, uint64_t flags,
                                      void *remote_ptr, size_t size, void **local_ptr);
 void mca_smsc_accelerator_unmap_peer_region(void *ctx);
@@ -156,6 +156,48 @@ int mca_smsc_accelerator_copy_from(mca_smsc_endpoint_t *endpoint, void *local_ad
     return ret;
 }
 
+int mca_smsc_accelerator_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                     size_t local_iov_count, const struct iovec *remote_iov,
+                                     size_t remote_iov_count, void *reg_handle)
+{
+    mca_smsc_accelerator_endpoint_t *ep = (mca_smsc_accelerator_endpoint_t *)endpoint;
+    mca_smsc_accelerator_registration_data_t *reg = (mca_smsc_accelerator_registration_data_t *)reg_handle;
+    int ret = OPAL_SUCCESS;
+
+    if ((NULL != reg) && (0 != reg->base_addr)) {
+        ret = mca_smsc_base_copy_iov(mca_smsc_accelerator_copy_to, endpoint, local_iov,
+                                     local_iov_count, remote_iov, remote_iov_count, reg_handle);
+    }
+    else if (NULL != mca_smsc_accelerator_module.prev_smsc) {
+        ret = mca_smsc_accelerator_module.prev_smsc->copy_to_iov(ep->prev_endpoint, local_iov,
+                                                                 local_iov_count, remote_iov,
+                                                                 remote_iov_count, reg_handle);
+    }
+
+    return ret;
+}
+
+int mca_smsc_accelerator_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                       size_t local_iov_count, const struct iovec *remote_iov,
+                                       size_t remote_iov_count, void *reg_handle)
+{
+    mca_smsc_accelerator_endpoint_t *ep = (mca_smsc_accelerator_endpoint_t *)endpoint;
+    mca_smsc_accelerator_registration_data_t *reg = (mca_smsc_accelerator_registration_data_t *)reg_handle;
+    int ret = OPAL_SUCCESS;
+
+    if ((NULL != reg) && (0 != reg->base_addr)) {
+        ret = mca_smsc_base_copy_iov(mca_smsc_accelerator_copy_from, endpoint, local_iov,
+                                     local_iov_count, remote_iov, remote_iov_count, reg_handle);
+    }
+    else if (NULL != mca_smsc_accelerator_module.prev_smsc) {
+        ret = mca_smsc_accelerator_module.prev_smsc->copy_from_iov(ep->prev_endpoint, local_iov,
+                                                                   local_iov_count, remote_iov,
+                                                                   remote_iov_count, reg_handle);
+    }
+
+    return ret;
+}
+
 void *mca_smsc_accelerator_register_region(void *local_address, size_t size)
 {
     int dev_id, ret;
@@ -223,6 +265,8 @@ mca_smsc_accelerator_module_t mca_smsc_accelerator_module = {
         .return_endpoint = mca_smsc_accelerator_return_endpoint,
         .copy_to = mca_smsc_accelerator_copy_to,
         .copy_from = mca_smsc_accelerator_copy_from,
+        .copy_to_iov = mca_smsc_accelerator_copy_to_iov,
+        .copy_from_iov = mca_smsc_accelerator_copy_from_iov,
         .map_peer_region = mca_smsc_accelerator_map_peer_region,
         .unmap_peer_region = mca_smsc_accelerator_unmap_peer_region,
         .register_region = mca_smsc_accelerator_register_region,
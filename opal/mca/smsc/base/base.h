@@ -28,4 +28,129 @@ OMPI_DECLSPEC OBJ_CLASS_DECLARATION(mca_smsc_base_component_t);
 int mca_smsc_base_select(void);
 void mca_smsc_base_register_default_params(mca_smsc_component_t *component, int default_priority);
 
+/** number of helper threads used for large copies (0 disables the copy pool) */
+extern int mca_smsc_base_copy_threads;
+/** copies of at least this many bytes are split across the copy pool */
+extern size_t mca_smsc_base_copy_threshold;
+
+/**
+ * Copy the bytes [offset, offset + size) of a transfer. Called concurrently
+ * from the copy pool threads for disjoint ranges.
+ */
+typedef int (*mca_smsc_base_copy_chunk_fn_t)(void *ctx, size_t offset, size_t size);
+
+/** check if a copy of {size} bytes should go through the copy pool */
+static inline bool mca_smsc_base_copy_pool_use(size_t size)
+{
+    return mca_smsc_base_copy_threads > 0 && size >= mca_smsc_base_copy_threshold;
+}
+
+/**
+ * Split a copy of {size} bytes across the calling thread and the copy pool
+ * threads. {dst} is the start of the destination buffer (in any address
+ * space) and is used to align the chunks to pages. Returns once all chunks
+ * are complete.
+ */
+int mca_smsc_base_copy_pool_run(mca_smsc_base_copy_chunk_fn_t fn, void *ctx, size_t size,
+                                const void *dst);
+
+void mca_smsc_base_copy_pool_fini(void);
+
+/**
+ * Position within an iovec list. Used to walk a pair of lists whose
+ * entries do not line up.
+ */
+struct mca_smsc_base_iov_cursor_t {
+    const struct iovec *iov;
+    size_t count;
+    /** current entry */
+    size_t index;
+    /** offset within the current entry */
+    size_t offset;
+};
+typedef struct mca_smsc_base_iov_cursor_t mca_smsc_base_iov_cursor_t;
+
+static inline void mca_smsc_base_iov_cursor_init(mca_smsc_base_iov_cursor_t *cursor,
+                                                 const struct iovec *iov, size_t count)
+{
+    cursor->iov = iov;
+    cursor->count = count;
+    cursor->index = 0;
+    cursor->offset = 0;
+
+    /* skip leading empty entries */
+    while (cursor->index < count && 0 == iov[cursor->index].iov_len) {
+        ++cursor->index;
+    }
+}
+
+static inline bool mca_smsc_base_iov_cursor_done(const mca_smsc_base_iov_cursor_t *cursor)
+{
+    return cursor->index >= cursor->count;
+}
+
+/** address and remaining length of the current entry */
+static inline void *mca_smsc_base_iov_cursor_ptr(const mca_smsc_base_iov_cursor_t *cursor,
+                                                 size_t *length)
+{
+    const struct iovec *iov = cursor->iov + cursor->index;
+    *length = iov->iov_len - cursor->offset;
+    return (void *) ((uintptr_t) iov->iov_base + cursor->offset);
+}
+
+static inline void mca_smsc_base_iov_cursor_advance(mca_smsc_base_iov_cursor_t *cursor,
+                                                    size_t length)
+{
+    while (cursor->index < cursor->count) {
+        size_t left = cursor->iov[cursor->index].iov_len - cursor->offset;
+        if (length < left) {
+            cursor->offset += length;
+            return;
+        }
+
+        length -= left;
+        cursor->offset = 0;
+        ++cursor->index;
+        if (0 == length) {
+            break;
+        }
+    }
+
+    while (cursor->index < cursor->count && 0 == cursor->iov[cursor->index].iov_len) {
+        ++cursor->index;
+    }
+}
+
+/**
+ * Fill {window} with at most {max} entries starting at the cursor
+ * position. Returns the number of entries filled in.
+ */
+static inline size_t mca_smsc_base_iov_cursor_window(const mca_smsc_base_iov_cursor_t *cursor,
+                                                     struct iovec *window, size_t max)
+{
+    size_t n = 0;
+
+    for (size_t i = cursor->index; i < cursor->count && n < max; ++i) {
+        size_t skip = (i == cursor->index) ? cursor->offset : 0;
+        if (cursor->iov[i].iov_len == skip) {
+            continue;
+        }
+        window[n].iov_base = (void *) ((uintptr_t) cursor->iov[i].iov_base + skip);
+        window[n].iov_len = cursor->iov[i].iov_len - skip;
+        ++n;
+    }
+
+    return n;
+}
+
+/**
+ * Generic implementation of copy_to_iov/copy_from_iov on top of a
+ * contiguous copy function. Issues one call to {copy_fn} per overlapping
+ * pair of local and remote regions.
+ */
+int mca_smsc_base_copy_iov(mca_smsc_module_copy_fn_t copy_fn, mca_smsc_endpoint_t *endpoint,
+                           const struct iovec *local_iov, size_t local_iov_count,
+                           const struct iovec *remote_iov, size_t remote_iov_count,
+                           void *reg_data);
+
 #endif /* OPAL_MCA_SMSC_BASE_BASE_H */
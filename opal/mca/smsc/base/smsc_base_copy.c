@@ -0,0 +1,42 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include "opal/mca/smsc/base/base.h"
+#include "opal/util/minmax.h"
+
+int mca_smsc_base_copy_iov(mca_smsc_module_copy_fn_t copy_fn, mca_smsc_endpoint_t *endpoint,
+                           const struct iovec *local_iov, size_t local_iov_count,
+                           const struct iovec *remote_iov, size_t remote_iov_count,
+                           void *reg_data)
+{
+    mca_smsc_base_iov_cursor_t local, remote;
+
+    mca_smsc_base_iov_cursor_init(&local, local_iov, local_iov_count);
+    mca_smsc_base_iov_cursor_init(&remote, remote_iov, remote_iov_count);
+
+    while (!mca_smsc_base_iov_cursor_done(&local) && !mca_smsc_base_iov_cursor_done(&remote)) {
+        size_t local_len, remote_len, size;
+        void *local_ptr = mca_smsc_base_iov_cursor_ptr(&local, &local_len);
+        void *remote_ptr = mca_smsc_base_iov_cursor_ptr(&remote, &remote_len);
+
+        size = opal_min(local_len, remote_len);
+
+        int rc = copy_fn(endpoint, local_ptr, remote_ptr, size, reg_data);
+        if (OPAL_SUCCESS != rc) {
+            return rc;
+        }
+
+        mca_smsc_base_iov_cursor_advance(&local, size);
+        mca_smsc_base_iov_cursor_advance(&remote, size);
+    }
+
+    return OPAL_SUCCESS;
+}
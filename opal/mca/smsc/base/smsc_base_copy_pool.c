@@ -0,0 +1,82 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Helper-thread copy pool
+ *
+ * Large single-copy transfers are split into page-aligned chunks that are
+ * copied by the calling thread together with smsc_base_copy_threads
+ * helper threads of an opal chunk pool. Chunk boundaries are aligned to
+ * pages of the destination buffer so no two threads write the same page.
+ */
+
+#include "opal_config.h"
+
+#include "opal/mca/smsc/base/base.h"
+#include "opal/util/chunk_pool.h"
+#include "opal/util/minmax.h"
+#include "opal/util/sys_limits.h"
+
+int mca_smsc_base_copy_threads = 0;
+size_t mca_smsc_base_copy_threshold = 4 * 1024 * 1024;
+
+static opal_chunk_pool_t mca_smsc_base_copy_pool = OPAL_CHUNK_POOL_STATIC_INIT;
+
+struct mca_smsc_base_copy_job_t {
+    mca_smsc_base_copy_chunk_fn_t fn;
+    void *ctx;
+    size_t size;
+    /** bytes before the first page boundary of the destination, copied with the first chunk */
+    size_t head;
+    size_t chunk_size;
+};
+typedef struct mca_smsc_base_copy_job_t mca_smsc_base_copy_job_t;
+
+static int mca_smsc_base_copy_pool_chunk(void *ctx, size_t index)
+{
+    mca_smsc_base_copy_job_t *job = (mca_smsc_base_copy_job_t *) ctx;
+    size_t start = (0 == index) ? 0 : job->head + index * job->chunk_size;
+    size_t end = opal_min(job->size, job->head + (index + 1) * job->chunk_size);
+
+    return job->fn(job->ctx, start, end - start);
+}
+
+int mca_smsc_base_copy_pool_run(mca_smsc_base_copy_chunk_fn_t fn, void *ctx, size_t size,
+                                const void *dst)
+{
+    const size_t page_size = (size_t) opal_getpagesize();
+    mca_smsc_base_copy_job_t job = {.fn = fn, .ctx = ctx, .size = size};
+    size_t num_chunks;
+    int num_threads;
+
+    num_threads = opal_chunk_pool_acquire(&mca_smsc_base_copy_pool, mca_smsc_base_copy_threads,
+                                          opal_smsc_base_framework.framework_output);
+    if (0 == num_threads) {
+        return fn(ctx, 0, size);
+    }
+
+    /* two chunks per thread gives some room for load balancing */
+    job.chunk_size = size / (2 * (num_threads + 1));
+    job.chunk_size = opal_max(page_size, (job.chunk_size + page_size - 1) & ~(page_size - 1));
+    /* the first chunk ends on a page boundary of the destination */
+    job.head = (page_size - ((uintptr_t) dst & (page_size - 1))) & (page_size - 1);
+    job.head = opal_min(job.head, size);
+    num_chunks = (size - job.head + job.chunk_size - 1) / job.chunk_size;
+    if (0 == num_chunks) {
+        num_chunks = 1;
+    }
+
+    return opal_chunk_pool_run(&mca_smsc_base_copy_pool, mca_smsc_base_copy_pool_chunk, &job,
+                               num_chunks);
+}
+
+void mca_smsc_base_copy_pool_fini(void)
+{
+    opal_chunk_pool_fini(&mca_smsc_base_copy_pool);
+}
@@ -43,10 +43,38 @@ mca_smsc_module_t *mca_smsc = NULL;
 
 OBJ_CLASS_INSTANCE(mca_smsc_base_component_t, opal_list_item_t, NULL, NULL);
 
+static int mca_smsc_base_register(mca_base_register_flag_t flags)
+{
+    mca_smsc_base_copy_threads = 0;
+    (void) mca_base_framework_var_register(&opal_smsc_base_framework, "copy_threads",
+                                           "Number of helper threads used to split large "
+                                           "single-copy transfers (0 disables helper threads, "
+                                           "default: 0)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &mca_smsc_base_copy_threads);
+
+    mca_smsc_base_copy_threshold = 4 * 1024 * 1024;
+    (void) mca_base_framework_var_register(&opal_smsc_base_framework, "copy_threshold",
+                                           "Minimum size of a single-copy transfer that is split "
+                                           "across the helper threads (default: 4M)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &mca_smsc_base_copy_threshold);
+
+    return OPAL_SUCCESS;
+}
+
+static int mca_smsc_base_close(void)
+{
+    mca_smsc_base_copy_pool_fini();
+
+    return mca_base_framework_components_close(&opal_smsc_base_framework, NULL);
+}
+
 /*
  * Global variables
  */
-MCA_BASE_FRAMEWORK_DECLARE(opal, smsc, NULL, NULL, NULL, NULL, mca_smsc_base_static_components, 0);
+MCA_BASE_FRAMEWORK_DECLARE(opal, smsc, NULL, mca_smsc_base_register, NULL, mca_smsc_base_close,
+                           mca_smsc_base_static_components, 0);
 
 static int mca_smsc_compare_components(opal_list_item_t **a, opal_list_item_t **b)
 {
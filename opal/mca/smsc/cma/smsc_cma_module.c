@@ -34,6 +34,15 @@
 #    include <sys/uio.h>
 #endif /* OPAL_CMA_NEED_SYSCALL_DEFS */
 
+#include <limits.h>
+
+/* maximum number of iovec entries process_vm_readv/writev accept in one call */
+#if defined(IOV_MAX)
+#    define MCA_SMSC_CMA_IOV_MAX IOV_MAX
+#else
+#    define MCA_SMSC_CMA_IOV_MAX 1024
+#endif
+
 OBJ_CLASS_INSTANCE(mca_smsc_cma_endpoint_t, opal_object_t, NULL, NULL);
 
 mca_smsc_endpoint_t *mca_smsc_cma_get_endpoint(opal_proc_t *peer_proc)
@@ -101,12 +110,9 @@ static inline void mca_smsc_cma_iov_advance(struct iovec *iov, ssize_t length)
     iov->iov_len -= length;
 }
 
-int mca_smsc_cma_copy_to(mca_smsc_endpoint_t *endpoint, void *local_address, void *remote_address,
-                         size_t size, void *reg_handle)
+static int mca_smsc_cma_write(mca_smsc_endpoint_t *endpoint, void *local_address,
+                              void *remote_address, size_t size)
 {
-    /* ignore the registration handle as it is not used for CMA */
-    (void) reg_handle;
-
     mca_smsc_cma_endpoint_t *cma_endpoint = (mca_smsc_cma_endpoint_t *) endpoint;
 
     /*
@@ -157,12 +163,9 @@ int mca_smsc_cma_copy_to(mca_smsc_endpoint_t *endpoint, void *local_address, voi
     return OPAL_SUCCESS;
 }
 
-int mca_smsc_cma_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address, void *remote_address,
-                           size_t size, void *reg_handle)
+static int mca_smsc_cma_read(mca_smsc_endpoint_t *endpoint, void *local_address,
+                             void *remote_address, size_t size)
 {
-    /* ignore the registration handle as it is not used for CMA */
-    (void) reg_handle;
-
     mca_smsc_cma_endpoint_t *cma_endpoint = (mca_smsc_cma_endpoint_t *) endpoint;
 
     /*
@@ -213,6 +216,126 @@ int mca_smsc_cma_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address, v
     return OPAL_SUCCESS;
 }
 
+/* large copies split across the smsc base copy pool */
+struct mca_smsc_cma_chunk_ctx_t {
+    mca_smsc_endpoint_t *endpoint;
+    char *local_address;
+    char *remote_address;
+    bool write;
+};
+typedef struct mca_smsc_cma_chunk_ctx_t mca_smsc_cma_chunk_ctx_t;
+
+static int mca_smsc_cma_copy_chunk(void *ctx, size_t offset, size_t size)
+{
+    mca_smsc_cma_chunk_ctx_t *chunk_ctx = (mca_smsc_cma_chunk_ctx_t *) ctx;
+
+    if (chunk_ctx->write) {
+        return mca_smsc_cma_write(chunk_ctx->endpoint, chunk_ctx->local_address + offset,
+                                  chunk_ctx->remote_address + offset, size);
+    }
+
+    return mca_smsc_cma_read(chunk_ctx->endpoint, chunk_ctx->local_address + offset,
+                             chunk_ctx->remote_address + offset, size);
+}
+
+int mca_smsc_cma_copy_to(mca_smsc_endpoint_t *endpoint, void *local_address, void *remote_address,
+                         size_t size, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for CMA */
+    (void) reg_handle;
+
+    if (mca_smsc_base_copy_pool_use(size)) {
+        mca_smsc_cma_chunk_ctx_t ctx = {.endpoint = endpoint, .local_address = local_address,
+                                        .remote_address = remote_address, .write = true};
+        return mca_smsc_base_copy_pool_run(mca_smsc_cma_copy_chunk, &ctx, size, remote_address);
+    }
+
+    return mca_smsc_cma_write(endpoint, local_address, remote_address, size);
+}
+
+int mca_smsc_cma_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address, void *remote_address,
+                           size_t size, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for CMA */
+    (void) reg_handle;
+
+    if (mca_smsc_base_copy_pool_use(size)) {
+        mca_smsc_cma_chunk_ctx_t ctx = {.endpoint = endpoint, .local_address = local_address,
+                                        .remote_address = remote_address, .write = false};
+        return mca_smsc_base_copy_pool_run(mca_smsc_cma_copy_chunk, &ctx, size, local_address);
+    }
+
+    return mca_smsc_cma_read(endpoint, local_address, remote_address, size);
+}
+
+/*
+ * Transfer a pair of iovec lists with as few system calls as possible. Each call
+ * passes up to MCA_SMSC_CMA_IOV_MAX entries of each list. The kernel may stop early
+ * (see the comment in mca_smsc_cma_write) so keep going from wherever it stopped.
+ */
+static int mca_smsc_cma_copy_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                 size_t local_iov_count, const struct iovec *remote_iov,
+                                 size_t remote_iov_count, bool write)
+{
+    mca_smsc_cma_endpoint_t *cma_endpoint = (mca_smsc_cma_endpoint_t *) endpoint;
+    struct iovec local_window[MCA_SMSC_CMA_IOV_MAX], remote_window[MCA_SMSC_CMA_IOV_MAX];
+    mca_smsc_base_iov_cursor_t local, remote;
+    ssize_t ret;
+
+    mca_smsc_base_iov_cursor_init(&local, local_iov, local_iov_count);
+    mca_smsc_base_iov_cursor_init(&remote, remote_iov, remote_iov_count);
+
+    while (!mca_smsc_base_iov_cursor_done(&local) && !mca_smsc_base_iov_cursor_done(&remote)) {
+        size_t local_count = mca_smsc_base_iov_cursor_window(&local, local_window,
+                                                             MCA_SMSC_CMA_IOV_MAX);
+        size_t remote_count = mca_smsc_base_iov_cursor_window(&remote, remote_window,
+                                                              MCA_SMSC_CMA_IOV_MAX);
+
+        if (write) {
+            ret = process_vm_writev(cma_endpoint->pid, local_window, local_count, remote_window,
+                                    remote_count, 0);
+        } else {
+            ret = process_vm_readv(cma_endpoint->pid, local_window, local_count, remote_window,
+                                   remote_count, 0);
+        }
+
+        if (0 >= ret) {
+            OPAL_OUTPUT_VERBOSE((MCA_BASE_VERBOSE_ERROR, opal_smsc_base_framework.framework_output,
+                                 "CMA %s of %lu local/%lu remote segments returned %ld, errno = %d",
+                                 write ? "write" : "read", (unsigned long) local_count,
+                                 (unsigned long) remote_count, (long) ret, errno));
+            return OPAL_ERROR;
+        }
+
+        mca_smsc_base_iov_cursor_advance(&local, (size_t) ret);
+        mca_smsc_base_iov_cursor_advance(&remote, (size_t) ret);
+    }
+
+    return OPAL_SUCCESS;
+}
+
+int mca_smsc_cma_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                             size_t local_iov_count, const struct iovec *remote_iov,
+                             size_t remote_iov_count, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for CMA */
+    (void) reg_handle;
+
+    return mca_smsc_cma_copy_iov(endpoint, local_iov, local_iov_count, remote_iov,
+                                 remote_iov_count, true);
+}
+
+int mca_smsc_cma_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                               size_t local_iov_count, const struct iovec *remote_iov,
+                               size_t remote_iov_count, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for CMA */
+    (void) reg_handle;
+
+    return mca_smsc_cma_copy_iov(endpoint, local_iov, local_iov_count, remote_iov,
+                                 remote_iov_count, false);
+}
+
 /* unsupported interfaces defined to support MCA direct */
 void *mca_smsc_cma_map_peer_region(mca_smsc_endpoint_t *endpoint, uint64_t flags,
                                    void *remote_address, size_t size, void **local_mapping)
@@ -238,4 +361,6 @@ mca_smsc_module_t mca_smsc_cma_module = {
     .return_endpoint = mca_smsc_cma_return_endpoint,
     .copy_to = mca_smsc_cma_copy_to,
     .copy_from = mca_smsc_cma_copy_from,
+    .copy_to_iov = mca_smsc_cma_copy_to_iov,
+    .copy_from_iov = mca_smsc_cma_copy_from_iov,
 };
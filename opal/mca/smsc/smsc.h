@@ -24,6 +24,8 @@
 #include "opal/class/opal_object.h"
 #include "opal/util/proc.h"
 
+#include <sys/uio.h>
+
 #define MCA_SMSC_BASE_MAJOR_VERSION 1
 #define MCA_SMSC_BASE_MINOR_VERSION 0
 #define MCA_SMSC_BASE_PATCH_VERSION 0
@@ -74,6 +76,26 @@ typedef void (*mca_smsc_module_return_endpoint_fn_t)(mca_smsc_endpoint_t *endpoi
 typedef int (*mca_smsc_module_copy_fn_t)(mca_smsc_endpoint_t *endpoint, void *local_address,
                                          void *remote_address, size_t size, void *reg_data);
 
+/**
+ * @brief Copy a list of non-contiguous regions to/from a peer process.
+ *
+ * @param(in) endpoint          shared-memory single-copy endpoint
+ * @param(in) local_iov         local regions to use
+ * @param(in) local_iov_count   number of entries in local_iov
+ * @param(in) remote_iov        remote regions to use
+ * @param(in) remote_iov_count  number of entries in remote_iov
+ * @param(in) reg_data          pointer to memory containing registration data (if required)
+ *
+ * Both lists are treated as a single stream of bytes (like process_vm_readv) so the regions do not
+ * need to line up. The total length of the local and remote lists must be the same. Neither list
+ * is modified. A module must provide both copy_from_iov and copy_to_iov. Modules without a native
+ * implementation can use mca_smsc_base_copy_iov() to split the operation into contiguous copies.
+ */
+typedef int (*mca_smsc_module_copy_iov_fn_t)(mca_smsc_endpoint_t *endpoint,
+                                             const struct iovec *local_iov, size_t local_iov_count,
+                                             const struct iovec *remote_iov,
+                                             size_t remote_iov_count, void *reg_data);
+
 /**
  * @brief Map a peer's memory onto local memory.
  *
@@ -158,6 +180,10 @@ struct mca_smsc_module_t {
     mca_smsc_module_copy_fn_t copy_to;
     /** Copy data from a peer's memory space. */
     mca_smsc_module_copy_fn_t copy_from;
+    /** Copy non-contiguous data into a peer's memory space. */
+    mca_smsc_module_copy_iov_fn_t copy_to_iov;
+    /** Copy non-contiguous data from a peer's memory space. */
+    mca_smsc_module_copy_iov_fn_t copy_from_iov;
 
     /* Defined if MCA_SMSC_FEATURE_CAN_MAP is set. */
     /** Map a peer memory region into this processes address space. The module is allowed to cache
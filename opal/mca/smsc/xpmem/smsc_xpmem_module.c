@@ -283,6 +283,33 @@ static inline void mca_smsc_xpmem_memmove(void *dst, void *src, size_t size)
     }
 }
 
+/* large copies out of (or into) an attached region are split across the smsc base copy pool */
+struct mca_smsc_xpmem_chunk_ctx_t {
+    char *dst;
+    char *src;
+};
+typedef struct mca_smsc_xpmem_chunk_ctx_t mca_smsc_xpmem_chunk_ctx_t;
+
+static int mca_smsc_xpmem_copy_chunk(void *ctx, size_t offset, size_t size)
+{
+    mca_smsc_xpmem_chunk_ctx_t *chunk_ctx = (mca_smsc_xpmem_chunk_ctx_t *) ctx;
+
+    mca_smsc_xpmem_memmove(chunk_ctx->dst + offset, chunk_ctx->src + offset, size);
+
+    return OPAL_SUCCESS;
+}
+
+static inline void mca_smsc_xpmem_copy(void *dst, void *src, size_t size)
+{
+    if (mca_smsc_base_copy_pool_use(size)) {
+        mca_smsc_xpmem_chunk_ctx_t ctx = {.dst = dst, .src = src};
+        (void) mca_smsc_base_copy_pool_run(mca_smsc_xpmem_copy_chunk, &ctx, size, dst);
+        return;
+    }
+
+    mca_smsc_xpmem_memmove(dst, src, size);
+}
+
 int mca_smsc_xpmem_copy_to(mca_smsc_endpoint_t *endpoint, void *local_address, void *remote_address,
                            size_t size, void *reg_handle)
 {
@@ -292,7 +319,7 @@ int mca_smsc_xpmem_copy_to(mca_smsc_endpoint_t *endpoint, void *local_address, v
     void *remote_ptr, *ctx;
     ctx = mca_smsc_xpmem_map_peer_region(endpoint,
         MCA_RCACHE_FLAGS_PERSIST, remote_address, size, &remote_ptr);
-    mca_smsc_xpmem_memmove(remote_ptr, local_address, size);
+    mca_smsc_xpmem_copy(remote_ptr, local_address, size);
 
     mca_smsc_xpmem_unmap_peer_region(ctx);
 
@@ -309,13 +336,91 @@ int mca_smsc_xpmem_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address,
 
     ctx = mca_smsc_xpmem_map_peer_region(endpoint,
         MCA_RCACHE_FLAGS_PERSIST, remote_address, size, &remote_ptr);
-    mca_smsc_xpmem_memmove(local_address, remote_ptr, size);
+    mca_smsc_xpmem_copy(local_address, remote_ptr, size);
+
+    mca_smsc_xpmem_unmap_peer_region(ctx);
+
+    return OPAL_SUCCESS;
+}
+
+/* attach the span covering all the remote regions once and copy each region out of the
+ * single mapping. the mapping is cached in the endpoint rcache so repeated calls with the
+ * same (or nearby) buffers do not need to attach again. */
+static int mca_smsc_xpmem_copy_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                   size_t local_iov_count, const struct iovec *remote_iov,
+                                   size_t remote_iov_count, bool to_remote)
+{
+    mca_smsc_base_iov_cursor_t local, remote;
+    uintptr_t span_base = UINTPTR_MAX, span_end = 0;
+    void *span_ptr, *ctx;
+
+    for (size_t i = 0; i < remote_iov_count; ++i) {
+        if (0 == remote_iov[i].iov_len) {
+            continue;
+        }
+        span_base = opal_min(span_base, (uintptr_t) remote_iov[i].iov_base);
+        span_end = opal_max(span_end, (uintptr_t) remote_iov[i].iov_base + remote_iov[i].iov_len);
+    }
+
+    if (span_end <= span_base) {
+        /* nothing to copy */
+        return OPAL_SUCCESS;
+    }
+
+    ctx = mca_smsc_xpmem_map_peer_region(endpoint, MCA_RCACHE_FLAGS_PERSIST, (void *) span_base,
+                                         span_end - span_base, &span_ptr);
+    if (OPAL_UNLIKELY(NULL == ctx)) {
+        return OPAL_ERROR;
+    }
+
+    mca_smsc_base_iov_cursor_init(&local, local_iov, local_iov_count);
+    mca_smsc_base_iov_cursor_init(&remote, remote_iov, remote_iov_count);
+
+    while (!mca_smsc_base_iov_cursor_done(&local) && !mca_smsc_base_iov_cursor_done(&remote)) {
+        size_t local_len, remote_len, size;
+        void *local_ptr = mca_smsc_base_iov_cursor_ptr(&local, &local_len);
+        void *remote_ptr = mca_smsc_base_iov_cursor_ptr(&remote, &remote_len);
+
+        size = opal_min(local_len, remote_len);
+        remote_ptr = (void *) ((uintptr_t) span_ptr + ((uintptr_t) remote_ptr - span_base));
+
+        if (to_remote) {
+            mca_smsc_xpmem_memmove(remote_ptr, local_ptr, size);
+        } else {
+            mca_smsc_xpmem_memmove(local_ptr, remote_ptr, size);
+        }
+
+        mca_smsc_base_iov_cursor_advance(&local, size);
+        mca_smsc_base_iov_cursor_advance(&remote, size);
+    }
 
     mca_smsc_xpmem_unmap_peer_region(ctx);
 
     return OPAL_SUCCESS;
 }
 
+int mca_smsc_xpmem_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                               size_t local_iov_count, const struct iovec *remote_iov,
+                               size_t remote_iov_count, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for XPMEM */
+    (void) reg_handle;
+
+    return mca_smsc_xpmem_copy_iov(endpoint, local_iov, local_iov_count, remote_iov,
+                                   remote_iov_count, true);
+}
+
+int mca_smsc_xpmem_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                 size_t local_iov_count, const struct iovec *remote_iov,
+                                 size_t remote_iov_count, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for XPMEM */
+    (void) reg_handle;
+
+    return mca_smsc_xpmem_copy_iov(endpoint, local_iov, local_iov_count, remote_iov,
+                                   remote_iov_count, false);
+}
+
 /* unsupported interfaces defined to support MCA direct */
 void *mca_smsc_xpmem_register_region(void *local_address, size_t size)
 {
@@ -333,6 +438,8 @@ mca_smsc_xpmem_module_t mca_smsc_xpmem_module = {
         .return_endpoint = mca_smsc_xpmem_return_endpoint,
         .copy_to = mca_smsc_xpmem_copy_to,
         .copy_from = mca_smsc_xpmem_copy_from,
+        .copy_to_iov = mca_smsc_xpmem_copy_to_iov,
+        .copy_from_iov = mca_smsc_xpmem_copy_from_iov,
         .map_peer_region = mca_smsc_xpmem_map_peer_region,
         .unmap_peer_region = mca_smsc_xpmem_unmap_peer_region,
     },
@@ -61,6 +61,8 @@ static void opal_deregister_params(void)
 
 int opal_register_params(void)
 {
+    int ret1;
+
     if (opal_register_done) {
         return OPAL_SUCCESS;
     }
@@ -69,7 +71,6 @@ int opal_register_params(void)
 
 #if defined(HAVE_SCHED_YIELD)
     opal_progress_yield_when_idle = false;
-    int ret1;
     ret1 = mca_base_var_register("opal", "opal", "progress", "yield_when_idle",
                                 "Yield the processor when waiting on progress",
                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
@@ -80,6 +81,42 @@ int opal_register_params(void)
     }
 #endif
 
+    opal_progress_backoff_max = 0;
+    ret1 = mca_base_var_register("opal", "opal", "progress", "backoff_max",
+                                "Maximum number of opal_progress passes a high priority progress "
+                                "callback that keeps reporting no events is skipped. Idle callbacks "
+                                "are skipped for 1, 2, 4, ... passes up to this value until they "
+                                "report an event again (0 = call every callback on every pass)",
+                                MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                &opal_progress_backoff_max);
+    if (ret1 < 0) {
+        return ret1;
+    }
+
+    opal_progress_backoff_threshold = 16;
+    ret1 = mca_base_var_register("opal", "opal", "progress", "backoff_threshold",
+                                "Number of consecutive calls without events before a high priority "
+                                "progress callback is backed off (see opal_progress_backoff_max)",
+                                MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                &opal_progress_backoff_threshold);
+    if (ret1 < 0) {
+        return ret1;
+    }
+
+    opal_progress_stats = false;
+    ret1 = mca_base_var_register("opal", "opal", "progress", "stats",
+                                "Measure the time spent in each high priority progress callback. "
+                                "Per-callback statistics are available as the "
+                                "opal_progress_callback_* performance variables",
+                                MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                &opal_progress_stats);
+    if (ret1 < 0) {
+        return ret1;
+    }
+
 #if OPAL_ENABLE_DEBUG
     opal_progress_debug = false;
     int ret;
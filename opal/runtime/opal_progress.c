@@ -28,6 +28,8 @@
 #include "opal_config.h"
 
 #include "opal/constants.h"
+#include "opal/mca/base/mca_base_event.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/mca/base/mca_base_var.h"
 #include "opal/mca/threads/threads.h"
 #include "opal/mca/timer/base/base.h"
@@ -35,6 +37,7 @@
 #include "opal/runtime/opal_params.h"
 #include "opal/runtime/opal_progress.h"
 #include "opal/util/event.h"
+#include "opal/util/minmax.h"
 #include "opal/util/output.h"
 
 #define OPAL_PROGRESS_USE_TIMERS       (OPAL_TIMER_CYCLE_SUPPORTED || OPAL_TIMER_USEC_SUPPORTED)
@@ -67,6 +70,36 @@ static size_t callbacks_lp_size = 0;
 /* do we want to yield() if nothing happened */
 bool opal_progress_yield_when_idle = false;
 
+/* adaptive scheduling of the high priority callbacks */
+unsigned int opal_progress_backoff_threshold = 16;
+unsigned int opal_progress_backoff_max = 0;
+bool opal_progress_stats = false;
+
+/* number of high priority callbacks that have statistics and may be backed off. callbacks
+ * beyond this index are called on every pass. */
+#define OPAL_PROGRESS_STATS_MAX 32
+
+typedef struct opal_progress_cb_stats_t {
+    /** number of times the callback was called */
+    uint64_t calls;
+    /** number of events returned by the callback */
+    uint64_t events;
+    /** number of passes the callback was skipped because it was backed off */
+    uint64_t skipped;
+    /** time spent in the callback (timer ticks, only if opal_progress_stats is set) */
+    opal_timer_t time;
+    /** consecutive calls that returned no events */
+    uint32_t idle;
+    /** current back-off interval in passes */
+    uint32_t interval;
+    /** passes left to skip. shared by the threads calling opal_progress */
+    opal_atomic_int32_t skip;
+} opal_progress_cb_stats_t;
+
+/* indexed like callbacks[]. updates of the counters are not atomic: the values are only used
+ * as a heuristic and for reporting. skip is only decremented atomically so it cannot wrap. */
+static opal_progress_cb_stats_t callbacks_stats[OPAL_PROGRESS_STATS_MAX];
+
 #if OPAL_PROGRESS_USE_TIMERS
 static opal_timer_t event_progress_last_time = 0;
 static opal_timer_t event_progress_delta = 0;
@@ -84,6 +117,94 @@ static opal_atomic_int32_t num_event_users = 0;
 static int debug_output = -1;
 #endif
 
+static inline opal_timer_t opal_progress_get_time(void)
+{
+#if OPAL_PROGRESS_ONLY_USEC_NATIVE
+    return opal_timer_base_get_usec();
+#else
+    return opal_timer_base_get_cycles();
+#endif
+}
+
+static int opal_progress_stats_notify(struct mca_base_pvar_t *pvar, mca_base_pvar_event_t event,
+                                      void *obj, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = OPAL_PROGRESS_STATS_MAX;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static int opal_progress_stats_get(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    const size_t offset = (size_t) (uintptr_t) pvar->ctx;
+    unsigned long long *values = (unsigned long long *) value;
+
+    for (int i = 0; i < OPAL_PROGRESS_STATS_MAX; ++i) {
+        values[i] = *(uint64_t *) ((char *) (callbacks_stats + i) + offset);
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static int opal_progress_stats_get_time(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    double *values = (double *) value;
+
+    for (int i = 0; i < OPAL_PROGRESS_STATS_MAX; ++i) {
+#if OPAL_PROGRESS_USE_TIMERS && !OPAL_PROGRESS_ONLY_USEC_NATIVE
+        values[i] = (double) callbacks_stats[i].time * 1000000.0
+                    / (double) opal_timer_base_get_freq();
+#else
+        values[i] = (double) callbacks_stats[i].time;
+#endif
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static void opal_progress_register_pvars(void)
+{
+    (void) mca_base_pvar_register("opal", "opal", "progress", "callback_calls",
+                                  "Number of calls to each high priority progress callback "
+                                  "(in registration order)",
+                                  OPAL_INFO_LVL_9, MCA_BASE_PVAR_CLASS_COUNTER,
+                                  MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                  MCA_BASE_VAR_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  opal_progress_stats_get, NULL, opal_progress_stats_notify,
+                                  (void *) offsetof(opal_progress_cb_stats_t, calls));
+    (void) mca_base_pvar_register("opal", "opal", "progress", "callback_events",
+                                  "Number of events reported by each high priority progress "
+                                  "callback (in registration order)",
+                                  OPAL_INFO_LVL_9, MCA_BASE_PVAR_CLASS_COUNTER,
+                                  MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                  MCA_BASE_VAR_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  opal_progress_stats_get, NULL, opal_progress_stats_notify,
+                                  (void *) offsetof(opal_progress_cb_stats_t, events));
+    (void) mca_base_pvar_register("opal", "opal", "progress", "callback_skipped",
+                                  "Number of progress passes each high priority progress "
+                                  "callback was skipped because it was backed off (in "
+                                  "registration order)",
+                                  OPAL_INFO_LVL_9, MCA_BASE_PVAR_CLASS_COUNTER,
+                                  MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                  MCA_BASE_VAR_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  opal_progress_stats_get, NULL, opal_progress_stats_notify,
+                                  (void *) offsetof(opal_progress_cb_stats_t, skipped));
+    (void) mca_base_pvar_register("opal", "opal", "progress", "callback_time",
+                                  "Time in microseconds spent in each high priority progress "
+                                  "callback (in registration order, requires "
+                                  "opal_progress_stats)",
+                                  OPAL_INFO_LVL_9, MCA_BASE_PVAR_CLASS_TIMER,
+                                  MCA_BASE_VAR_TYPE_DOUBLE, NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  opal_progress_stats_get_time, NULL, opal_progress_stats_notify,
+                                  NULL);
+}
+
 /**
  * Fake callback used for threading purposes when one thread
  * progresses callbacks while another unregisters some. The root
@@ -155,6 +276,13 @@ int opal_progress_init(void)
         callbacks_lp[i] = fake_cb;
     }
 
+    memset(callbacks_stats, 0, sizeof(callbacks_stats));
+    /* back-off and statistics can be enabled at runtime */
+    opal_progress_register_pvars();
+
+    /* deliver MPI_T events to handles allocated before now */
+    (void) mca_base_event_progress_init();
+
     OPAL_OUTPUT(
         (debug_output, "progress: initialized event flag to: %x", opal_progress_event_flag));
     OPAL_OUTPUT((debug_output, "progress: initialized yield_when_idle to: %s",
@@ -213,6 +341,67 @@ static int opal_progress_events(void)
  * care, as the cost of that happening is far outweighed by the cost
  * of the if checks (they were resulting in bad pipe stalling behavior)
  */
+/*
+ * Progress the high priority callbacks, keeping per-callback statistics.
+ * A callback that returned no events opal_progress_backoff_threshold times
+ * in a row is skipped for 1, 2, 4, ... passes (up to
+ * opal_progress_backoff_max) until it reports an event again.
+ */
+static int opal_progress_callbacks_adaptive(void)
+{
+    const size_t len = callbacks_len;
+    /* the parameters may be changed at any time */
+    const uint32_t backoff_max = opal_min(opal_progress_backoff_max, (unsigned int) INT32_MAX);
+    const bool measure = opal_progress_stats;
+    int events = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        opal_progress_cb_stats_t *stats = callbacks_stats + i;
+        opal_timer_t start = 0;
+        int ret;
+
+        if (OPAL_UNLIKELY(i >= OPAL_PROGRESS_STATS_MAX)) {
+            events += (callbacks[i])();
+            continue;
+        }
+
+        int32_t skip = stats->skip;
+        if (skip > 0 && backoff_max) {
+            /* a lowered backoff_max applies to callbacks already backed off. if another
+             * thread changed the value the callback is called instead. */
+            if (opal_atomic_compare_exchange_strong_32(&stats->skip, &skip,
+                                                       (int32_t) opal_min((uint32_t) skip,
+                                                                          backoff_max) - 1)) {
+                ++stats->skipped;
+                continue;
+            }
+        }
+
+        if (measure) {
+            start = opal_progress_get_time();
+        }
+
+        ret = (callbacks[i])();
+
+        if (measure) {
+            stats->time += opal_progress_get_time() - start;
+        }
+
+        ++stats->calls;
+        if (ret > 0) {
+            events += ret;
+            stats->events += ret;
+            stats->idle = 0;
+            stats->interval = 0;
+        } else if (backoff_max && ++stats->idle >= opal_progress_backoff_threshold) {
+            stats->interval = stats->interval ? opal_min(2 * stats->interval, backoff_max) : 1;
+            stats->skip = (int32_t) stats->interval;
+        }
+    }
+
+    return events;
+}
+
 int opal_progress(void)
 {
     static uint32_t num_calls = 0;
@@ -220,8 +409,12 @@ int opal_progress(void)
     int events = 0;
 
     /* progress all registered callbacks */
-    for (i = 0; i < callbacks_len; ++i) {
-        events += (callbacks[i])();
+    if (OPAL_UNLIKELY(opal_progress_stats || opal_progress_backoff_max)) {
+        events = opal_progress_callbacks_adaptive();
+    } else {
+        for (i = 0; i < callbacks_len; ++i) {
+            events += (callbacks[i])();
+        }
     }
 
     /* Run low priority callbacks and events once every 8 calls to opal_progress().
@@ -405,6 +598,10 @@ static int _opal_progress_register(opal_progress_callback_t cb,
         *cbs_size *= 2;
     }
 
+    if (&callbacks == cbs && *cbs_len < OPAL_PROGRESS_STATS_MAX) {
+        memset(callbacks_stats + *cbs_len, 0, sizeof(callbacks_stats[0]));
+    }
+
     cbs[0][*cbs_len] = cb;
     ++*cbs_len;
 
@@ -463,6 +660,14 @@ static int _opal_progress_unregister(opal_progress_callback_t cb,
                                     (intptr_t) callback_array[i + 1]);
     }
 
+    /* statistics follow the callbacks */
+    if (callbacks == callback_array) {
+        for (size_t i = (size_t) ret; i < *callback_array_len - 1 && i + 1 < OPAL_PROGRESS_STATS_MAX;
+             ++i) {
+            callbacks_stats[i] = callbacks_stats[i + 1];
+        }
+    }
+
     --*callback_array_len;
     callback_array[*callback_array_len] = fake_cb;
 
@@ -178,6 +178,15 @@ OPAL_DECLSPEC extern int opal_progress_spin_count;
 /* do we want to call sched_yield() if nothing happened */
 OPAL_DECLSPEC extern bool opal_progress_yield_when_idle;
 
+/* number of consecutive idle calls before a high priority callback is backed off */
+OPAL_DECLSPEC extern unsigned int opal_progress_backoff_threshold;
+
+/* maximum number of passes a backed off callback is skipped (0 disables back off) */
+OPAL_DECLSPEC extern unsigned int opal_progress_backoff_max;
+
+/* measure the time spent in each high priority callback */
+OPAL_DECLSPEC extern bool opal_progress_stats;
+
 /**
  * Progress until flag is true or poll iterations completed
  */
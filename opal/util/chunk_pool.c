@@ -0,0 +1,224 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stdlib.h>
+
+#include "opal/constants.h"
+#include "opal/mca/base/base.h"
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/util/chunk_pool.h"
+#include "opal/util/output.h"
+
+static void opal_chunk_pool_work(opal_chunk_pool_t *pool)
+{
+    for (;;) {
+        size_t i = opal_atomic_fetch_add_size_t(&pool->next_chunk, 1);
+        if (i >= pool->num_chunks) {
+            break;
+        }
+
+        int rc = pool->fn(pool->ctx, i);
+        if (OPAL_UNLIKELY(OPAL_SUCCESS != rc)) {
+            pool->rc = rc;
+        }
+
+        opal_atomic_wmb();
+        (void) opal_atomic_add_fetch_size_t(&pool->chunks_done, 1);
+    }
+}
+
+static void *opal_chunk_pool_thread(void *arg)
+{
+    opal_chunk_pool_t *pool = (opal_chunk_pool_t *) arg;
+    uint64_t generation;
+
+    if (NULL != pool->cpuset) {
+        (void) hwloc_set_cpubind(opal_hwloc_topology, pool->cpuset, HWLOC_CPUBIND_THREAD);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    generation = pool->generation;
+
+    for (;;) {
+        while (!pool->shutdown && generation == pool->generation) {
+            pthread_cond_wait(&pool->cond, &pool->lock);
+        }
+
+        if (pool->shutdown) {
+            break;
+        }
+
+        generation = pool->generation;
+        if (!pool->job_open) {
+            /* woke up too late for this job */
+            continue;
+        }
+
+        (void) opal_atomic_add_fetch_32(&pool->active, 1);
+        pthread_mutex_unlock(&pool->lock);
+
+        opal_chunk_pool_work(pool);
+
+        (void) opal_atomic_add_fetch_32(&pool->active, -1);
+        pthread_mutex_lock(&pool->lock);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/* cpuset of the NUMA domain(s) local to the calling thread's binding */
+static hwloc_bitmap_t opal_chunk_pool_cpuset(void)
+{
+    hwloc_bitmap_t cpuset;
+    hwloc_obj_t obj;
+
+    if (OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return NULL;
+    }
+
+    cpuset = hwloc_bitmap_alloc();
+    if (NULL == cpuset) {
+        return NULL;
+    }
+
+    if (0 != hwloc_get_cpubind(opal_hwloc_topology, cpuset, HWLOC_CPUBIND_THREAD)
+        || hwloc_bitmap_iszero(cpuset)) {
+        hwloc_bitmap_free(cpuset);
+        return NULL;
+    }
+
+    obj = hwloc_get_obj_covering_cpuset(opal_hwloc_topology, cpuset);
+    if (NULL == obj || NULL == obj->nodeset) {
+        hwloc_bitmap_free(cpuset);
+        return NULL;
+    }
+
+    hwloc_cpuset_from_nodeset(opal_hwloc_topology, cpuset, obj->nodeset);
+
+    return cpuset;
+}
+
+static int opal_chunk_pool_start(opal_chunk_pool_t *pool, int num_threads, int output)
+{
+    pool->threads = calloc(num_threads, sizeof(pool->threads[0]));
+    if (NULL == pool->threads) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    pool->cpuset = opal_chunk_pool_cpuset();
+    pool->shutdown = false;
+    pool->num_threads = 0;
+
+    for (int i = 0; i < num_threads; ++i) {
+        if (0 != pthread_create(pool->threads + i, NULL, opal_chunk_pool_thread, pool)) {
+            opal_output_verbose(MCA_BASE_VERBOSE_WARN, output,
+                                "opal_chunk_pool_start: could only start %d of %d helper threads",
+                                i, num_threads);
+            break;
+        }
+        ++pool->num_threads;
+    }
+
+    opal_output_verbose(MCA_BASE_VERBOSE_INFO, output,
+                        "opal_chunk_pool_start: started %d helper threads", pool->num_threads);
+
+    return OPAL_SUCCESS;
+}
+
+int opal_chunk_pool_acquire(opal_chunk_pool_t *pool, int num_threads, int output)
+{
+    int32_t expected = 0;
+
+    if (!opal_atomic_compare_exchange_strong_32(&pool->busy, &expected, 1)) {
+        /* another thread is using the pool */
+        return 0;
+    }
+
+    if (OPAL_UNLIKELY(!pool->started)) {
+        pool->started = true;
+        (void) opal_chunk_pool_start(pool, num_threads, output);
+    }
+
+    if (0 == pool->num_threads) {
+        pool->busy = 0;
+    }
+
+    return pool->num_threads;
+}
+
+int opal_chunk_pool_run(opal_chunk_pool_t *pool, opal_chunk_pool_fn_t fn, void *ctx,
+                        size_t num_chunks)
+{
+    int rc;
+
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->num_chunks = num_chunks;
+    pool->next_chunk = 0;
+    pool->chunks_done = 0;
+    pool->rc = OPAL_SUCCESS;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job_open = true;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    opal_chunk_pool_work(pool);
+
+    while (pool->chunks_done < pool->num_chunks) {
+        opal_atomic_rmb();
+    }
+
+    /* keep late helpers out and wait for the ones still leaving the job */
+    pthread_mutex_lock(&pool->lock);
+    pool->job_open = false;
+    pthread_mutex_unlock(&pool->lock);
+
+    while (pool->active) {
+        opal_atomic_rmb();
+    }
+
+    rc = pool->rc;
+    opal_atomic_mb();
+    pool->busy = 0;
+
+    return rc;
+}
+
+void opal_chunk_pool_fini(opal_chunk_pool_t *pool)
+{
+    if (!pool->started) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->num_threads; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    free(pool->threads);
+    pool->threads = NULL;
+    pool->num_threads = 0;
+
+    if (NULL != pool->cpuset) {
+        hwloc_bitmap_free(pool->cpuset);
+        pool->cpuset = NULL;
+    }
+
+    pool->started = false;
+}
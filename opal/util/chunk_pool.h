@@ -0,0 +1,106 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Helper-thread chunk pool
+ *
+ * A single core cannot saturate the memory bandwidth of a socket, so
+ * large memory-bound operations (copies, reductions) are split into
+ * chunks that are processed by the calling thread together with a set of
+ * helper threads. The helpers are started on first use and are bound to
+ * the NUMA domain of the thread that started them. How the work is split
+ * is up to the caller, which only provides a callback processing one
+ * chunk.
+ *
+ * A pool runs one job at a time. A thread that finds the pool busy does
+ * the work on its own.
+ */
+
+#ifndef OPAL_UTIL_CHUNK_POOL_H
+#define OPAL_UTIL_CHUNK_POOL_H
+
+#include "opal_config.h"
+
+#include <pthread.h>
+
+#include "opal/mca/hwloc/hwloc-internal.h"
+#include "opal/sys/atomic.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Process chunk {index} of the current job. Called concurrently from the
+ * calling thread and the helper threads, once for each chunk.
+ */
+typedef int (*opal_chunk_pool_fn_t)(void *ctx, size_t index);
+
+struct opal_chunk_pool_t {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t *threads;
+    int num_threads;
+    bool started;
+    bool shutdown;
+    /** incremented each time a job is posted */
+    uint64_t generation;
+    /** set while helpers may join the current job */
+    bool job_open;
+    /** cpuset of the NUMA domain the helpers are bound to (NULL if unbound) */
+    hwloc_bitmap_t cpuset;
+
+    /* current job */
+    opal_chunk_pool_fn_t fn;
+    void *ctx;
+    size_t num_chunks;
+    opal_atomic_size_t next_chunk;
+    opal_atomic_size_t chunks_done;
+    opal_atomic_int32_t active;
+    opal_atomic_int32_t rc;
+
+    /** non-zero while a thread owns the pool */
+    opal_atomic_int32_t busy;
+};
+typedef struct opal_chunk_pool_t opal_chunk_pool_t;
+
+#define OPAL_CHUNK_POOL_STATIC_INIT                                             \
+    {                                                                           \
+        .lock = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER,    \
+    }
+
+/**
+ * Take the pool for one job.
+ *
+ * @param[in] pool        Pool
+ * @param[in] num_threads Number of helper threads started on first use
+ * @param[in] output      Output stream for the startup messages
+ *
+ * @returns the number of helper threads that take part in the job. If 0
+ * the pool is busy or has no threads: the caller does the work on its
+ * own and must not call opal_chunk_pool_run().
+ */
+OPAL_DECLSPEC int opal_chunk_pool_acquire(opal_chunk_pool_t *pool, int num_threads, int output);
+
+/**
+ * Process the chunks [0, num_chunks) of a job with the calling thread and
+ * the helper threads of a pool taken with opal_chunk_pool_acquire(), then
+ * release the pool. Returns once all chunks are complete.
+ *
+ * @returns OPAL_SUCCESS or an error returned by {fn} for one of the chunks
+ */
+OPAL_DECLSPEC int opal_chunk_pool_run(opal_chunk_pool_t *pool, opal_chunk_pool_fn_t fn, void *ctx,
+                                      size_t num_chunks);
+
+/** Stop the helper threads. The pool can be used again afterwards */
+OPAL_DECLSPEC void opal_chunk_pool_fini(opal_chunk_pool_t *pool);
+
+END_C_DECLS
+
+#endif /* OPAL_UTIL_CHUNK_POOL_H */
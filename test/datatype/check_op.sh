@@ -79,3 +79,28 @@ for op in max min sum prod; do
     done
 done
 
+
+echo "========16-bit floating point types all operations========="
+echo ""
+# op_avx_support masks: none (scalar), AVX2, AVX2+F16C, AVX512F and all
+# the capabilities (native AVX512-FP16 and AVX512-BF16 where available).
+# Each run also checks every count up to 100 with 2 and 3 buffers.
+for mask in 0 0x30 0x70 0x370 0xf7f; do
+    for type in h b; do
+        for op in max min sum prod; do
+            for size in 0 7 15 31 33; do
+                foo=$((1024 + $size))
+                echo -e "Test $Yellow op_avx_support $mask $NC Total_num_bits = $foo * 16"
+                cmd="$mpirun --mca op_avx_support $mask -n 1 reduce_local -l $foo -u $foo -t $type -o $op"
+                if test $verbose -eq 1 ; then echo $cmd; fi
+                eval $cmd
+            done
+        done
+    done
+done
+
+echo "========16-bit allreduce accumulated in float========="
+echo ""
+cmd="$mpirun --mca coll self,basic,libnbc,tuned --mca coll_tuned_allreduce_fp32_accumulate 1 -n 4 reduce_local -l 1 -u 1 -t hb -o sum -a"
+if test $verbose -eq 1 ; then echo $cmd; fi
+eval $cmd
@@ -0,0 +1,251 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Pack and unpack bandwidth of strided, subarray and indexed layouts.
+ *
+ * Every layout is checked against a copy done by hand before being timed.
+ * Run it once as is and once with --mca mpi_ddt_compiled_plans 0 to
+ * compare the compiled plans with the generic engine.
+ */
+
+/* needed for getopt() */
+#define _POSIX_C_SOURCE 200809L
+
+#include "ompi_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mpi.h"
+
+#define MAX_BLOCKS 4
+
+typedef struct pack_layout_s {
+    const char *name;
+    MPI_Datatype type;
+    /* reference layout: nblocks blocks of blen bytes, block i at
+     * disp[i % ninner] + (i / ninner) * stride (in bytes) */
+    int blen;
+    int nblocks;
+    int ninner;
+    MPI_Aint disp[MAX_BLOCKS];
+    MPI_Aint stride;
+    /* number of elements packed at once */
+    int count;
+} pack_layout_t;
+
+static int verbose = 0;
+static int total_errors = 0;
+
+static void reference_pack(const pack_layout_t *l, const char *src, char *dst)
+{
+    for (int i = 0; i < l->nblocks; i++) {
+        memcpy(dst + (size_t) i * l->blen,
+               src + l->disp[i % l->ninner] + (MPI_Aint)(i / l->ninner) * l->stride, l->blen);
+    }
+}
+
+static void vector_layout(pack_layout_t *l, int blen, int nblocks)
+{
+    int dsize = (blen < 8) ? blen : 8;
+    MPI_Datatype base = (4 == dsize) ? MPI_FLOAT : MPI_DOUBLE;
+    static char names[5][32];
+    static int n = 0;
+
+    snprintf(names[n], sizeof(names[n]), "vector %dB", blen);
+    l->name = names[n++];
+    l->blen = blen;
+    l->nblocks = nblocks;
+    l->ninner = 1;
+    l->disp[0] = 0;
+    l->stride = 3 * blen;
+    l->count = 4;
+    MPI_Type_vector(nblocks, blen / dsize, 3 * blen / dsize, base, &l->type);
+}
+
+static void subarray_layout(pack_layout_t *l, const char *name, int ndims, const int *sizes,
+                            const int *subsizes, const int *starts)
+{
+    l->name = name;
+    l->blen = subsizes[ndims - 1] * (int) sizeof(double);
+    l->nblocks = 1;
+    for (int d = 0; d < ndims - 1; d++) {
+        l->nblocks *= subsizes[d];
+    }
+    /* the reference handles a single strided dimension, so the outer
+     * dimensions of the 3D case are expanded into its displacements */
+    l->ninner = 1;
+    l->disp[0] = 0;
+    for (int d = 0; d < ndims; d++) {
+        MPI_Aint pitch = sizeof(double);
+        for (int e = d + 1; e < ndims; e++) {
+            pitch *= sizes[e];
+        }
+        l->disp[0] += starts[d] * pitch;
+        if (d == ndims - 2) {
+            l->stride = pitch;
+        }
+    }
+    if (3 == ndims) {
+        /* rows of a plane, then the next plane */
+        l->ninner = subsizes[1];
+        for (int i = 1; i < subsizes[1]; i++) {
+            l->disp[i] = l->disp[0] + i * l->stride;
+        }
+        l->stride = (MPI_Aint) sizes[1] * sizes[2] * sizeof(double);
+    }
+    l->count = 4;
+    MPI_Type_create_subarray(ndims, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &l->type);
+}
+
+static void indexed_layout(pack_layout_t *l)
+{
+    static const int displs[MAX_BLOCKS] = {0, 5, 7, 20};
+    MPI_Datatype block;
+
+    l->name = "indexed_block";
+    l->blen = 2 * sizeof(double);
+    l->ninner = MAX_BLOCKS;
+    l->nblocks = MAX_BLOCKS;
+    l->count = 8192;
+    for (int i = 0; i < MAX_BLOCKS; i++) {
+        l->disp[i] = displs[i] * sizeof(double);
+    }
+    l->stride = 32 * sizeof(double);
+    MPI_Type_create_indexed_block(MAX_BLOCKS, 2, displs, MPI_DOUBLE, &block);
+    MPI_Type_create_resized(block, 0, l->stride, &l->type);
+    MPI_Type_free(&block);
+}
+
+static int run_layout(pack_layout_t *l, int repeat)
+{
+    int count = l->count;
+    MPI_Aint lb, extent;
+    int size, position;
+    size_t span, packed_size;
+    char *user, *copy, *packed, *expected;
+    double t0, tpack, tunpack;
+    int errors = 0;
+
+    MPI_Type_commit(&l->type);
+    MPI_Type_get_extent(l->type, &lb, &extent);
+    MPI_Type_size(l->type, &size);
+    if (size != l->nblocks * l->blen) {
+        printf("%-16s wrong reference layout (%d bytes instead of %d)\n", l->name,
+               l->nblocks * l->blen, size);
+        return 1;
+    }
+
+    span = (size_t) count * extent + l->stride;
+    packed_size = (size_t) count * size;
+    user = (char *) malloc(span);
+    copy = (char *) malloc(span);
+    packed = (char *) malloc(packed_size);
+    expected = (char *) malloc(packed_size);
+    for (size_t i = 0; i < span; i++) {
+        user[i] = (char) (i * 7 + 3);
+    }
+    for (int e = 0; e < count; e++) {
+        reference_pack(l, user + (MPI_Aint) e * extent, expected + (size_t) e * size);
+    }
+
+    /* correctness */
+    position = 0;
+    MPI_Pack(user, count, l->type, packed, (int) packed_size, &position, MPI_COMM_WORLD);
+    if (0 != memcmp(packed, expected, packed_size)) {
+        printf("%-16s pack mismatch\n", l->name);
+        errors++;
+    }
+    memset(copy, 0, span);
+    position = 0;
+    MPI_Unpack(expected, (int) packed_size, &position, copy, count, l->type, MPI_COMM_WORLD);
+    position = 0;
+    MPI_Pack(copy, count, l->type, packed, (int) packed_size, &position, MPI_COMM_WORLD);
+    if (0 != memcmp(packed, expected, packed_size)) {
+        printf("%-16s unpack mismatch\n", l->name);
+        errors++;
+    }
+
+    /* bandwidth */
+    t0 = MPI_Wtime();
+    for (int r = 0; r < repeat; r++) {
+        position = 0;
+        MPI_Pack(user, count, l->type, packed, (int) packed_size, &position, MPI_COMM_WORLD);
+    }
+    tpack = MPI_Wtime() - t0;
+    t0 = MPI_Wtime();
+    for (int r = 0; r < repeat; r++) {
+        position = 0;
+        MPI_Unpack(packed, (int) packed_size, &position, copy, count, l->type, MPI_COMM_WORLD);
+    }
+    tunpack = MPI_Wtime() - t0;
+
+    printf("%-16s %10zu bytes  pack %9.2f MB/s  unpack %9.2f MB/s%s\n", l->name, packed_size,
+           (double) packed_size * repeat / tpack / 1e6,
+           (double) packed_size * repeat / tunpack / 1e6, errors ? "  FAILED" : "");
+    if (verbose) {
+        printf("%-16s extent %ld, %d blocks of %d bytes per element\n", l->name, (long) extent,
+               l->nblocks, l->blen);
+    }
+
+    free(user);
+    free(copy);
+    free(packed);
+    free(expected);
+    MPI_Type_free(&l->type);
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    static const int sizes2[2] = {512, 512}, subsizes2[2] = {256, 128}, starts2[2] = {16, 32};
+    static const int sizes3[3] = {64, 64, 64}, subsizes3[3] = {32, 4, 16},
+                     starts3[3] = {8, 8, 8};
+    pack_layout_t layouts[8];
+    int nlayouts = 0, repeat = 100, c;
+
+    while (-1 != (c = getopt(argc, argv, "r:vh"))) {
+        switch (c) {
+        case 'r':
+            repeat = atoi(optarg);
+            if (repeat <= 0) {
+                fprintf(stderr, "The number of repetitions (%s) must be positive\n", optarg);
+                exit(-1);
+            }
+            break;
+        case 'v':
+            verbose++;
+            break;
+        case 'h':
+            fprintf(stdout, "%s [-r repeat] [-v] [-h]\n"
+                            "Compare with --mca mpi_ddt_compiled_plans 0\n",
+                    argv[0]);
+            exit(0);
+        }
+    }
+
+    MPI_Init(&argc, &argv);
+
+    for (int blen = 4; blen <= 64; blen *= 2) {
+        vector_layout(&layouts[nlayouts++], blen, 4096);
+    }
+    subarray_layout(&layouts[nlayouts++], "subarray 2D", 2, sizes2, subsizes2, starts2);
+    subarray_layout(&layouts[nlayouts++], "subarray 3D", 3, sizes3, subsizes3, starts3);
+    indexed_layout(&layouts[nlayouts++]);
+
+    for (int i = 0; i < nlayouts; i++) {
+        total_errors += run_layout(&layouts[i], repeat);
+    }
+
+    MPI_Finalize();
+
+    return (0 == total_errors) ? 0 : -1;
+}
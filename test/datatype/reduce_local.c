@@ -30,8 +30,10 @@
 #include <unistd.h>
 
 #include "mpi.h"
+#include "mpi-ext.h"
 #include "ompi/communicator/communicator.h"
 #include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
 #include "ompi/runtime/mpiruntime.h"
 
 typedef struct op_name_s {
@@ -121,6 +123,173 @@ static int build_do_ops(char *optarg, int *do_ops)
     return 0;
 }
 
+/*
+ * 16-bit floating point types: MPIX_SHORT_FLOAT (when it is an IEEE half)
+ * and MPIX_BFLOAT16. They are handled as their 16 bits, the reference
+ * result of each element is computed in float and rounded once, like the
+ * scalar functions of op/base do.
+ */
+#if defined(OMPI_HAVE_MPI_EXT_SHORTFLOAT) && OMPI_HAVE_MPI_EXT_SHORTFLOAT
+#define HAVE_BFLOAT16 1
+#if (defined(HAVE_SHORT_FLOAT) && (2 == SIZEOF_SHORT_FLOAT)) || \
+    (!defined(HAVE_SHORT_FLOAT) && defined(HAVE_OPAL_SHORT_FLOAT_T) && (2 == SIZEOF_OPAL_SHORT_FLOAT_T))
+#define HAVE_HALF 1
+#if defined(HAVE_SHORT_FLOAT)
+typedef short float half_t;
+#else
+typedef opal_short_float_t half_t;
+#endif
+#endif
+#endif /* OMPI_HAVE_MPI_EXT_SHORTFLOAT */
+
+typedef struct float16_type_s {
+    char *mpi_type;
+    MPI_Datatype dtype;
+    float (*to_float)(uint16_t);
+    uint16_t (*from_float)(float);
+    const uint16_t *values; /* inputs, including the special values */
+    int num_values;
+    float big; /* smallest power of 2 from which the values are 2 apart */
+} float16_type_t;
+
+#if defined(HAVE_HALF)
+static float half_to_float(uint16_t v)
+{
+    half_t h;
+    memcpy(&h, &v, sizeof(h));
+    return (float) h;
+}
+
+static uint16_t float_to_half(float f)
+{
+    half_t h = (half_t) f;
+    uint16_t v;
+    memcpy(&v, &h, sizeof(v));
+    return v;
+}
+
+/* 1 + 0x1000 and 0x3c01 + 0x1000 are ties (rounded down and up to even),
+ * 0x7bff is the largest finite value, 0x0001 and 0x03ff are denormals */
+static const uint16_t half_values[] = {
+    0x3c00, 0x3c01, 0x1000, 0xbc00, 0x3800, 0x4900, 0xc500, 0x7bff, 0xfbff,
+    0x0001, 0x03ff, 0x8001, 0x0400, 0x0000, 0x8000, 0x7c00, 0xfc00, 0x7e00,
+};
+#endif /* HAVE_HALF */
+
+#if defined(HAVE_BFLOAT16)
+/* 1 + 0x3b80 and 0x3f81 + 0x3b80 are ties (rounded down and up to even),
+ * 0x7f7f is the largest finite value, 0x0001 and 0x007f are denormals */
+static const uint16_t bfloat16_values[] = {
+    0x3f80, 0x3f81, 0x3b80, 0xbf80, 0x3f00, 0x4321, 0xc0a0, 0x7f7f, 0xff7f,
+    0x0001, 0x007f, 0x8001, 0x0080, 0x0000, 0x8000, 0x7f80, 0xff80, 0x7fc0,
+};
+#endif /* HAVE_BFLOAT16 */
+
+static float float16_op(const char *op, float a, float b)
+{
+    if (0 == strcmp(op, "max")) {
+        return a > b ? a : b;
+    }
+    if (0 == strcmp(op, "min")) {
+        return a < b ? a : b;
+    }
+    if (0 == strcmp(op, "sum")) {
+        return a + b;
+    }
+    return a * b;
+}
+
+/* NaNs are all equal, whatever their payload */
+static int float16_equal(const float16_type_t *t, uint16_t a, uint16_t b)
+{
+    float fa = t->to_float(a), fb = t->to_float(b);
+    return (a == b) || ((fa != fa) && (fb != fb));
+}
+
+static void float16_fill(const float16_type_t *t, uint16_t *in, uint16_t *inout, int count)
+{
+    /* every pair of values shows up in a run of num_values^2 elements */
+    for (int i = 0; i < count; i++) {
+        in[i] = t->values[i % t->num_values];
+        inout[i] = t->values[(i / t->num_values + i) % t->num_values];
+    }
+}
+
+/* check (in op inout) of count elements, inout holding the result */
+static int float16_check(const float16_type_t *t, const char *op, const uint16_t *in,
+                         const uint16_t *check, const uint16_t *inout, int count,
+                         const char *what)
+{
+    for (int i = 0; i < count; i++) {
+        uint16_t expected = t->from_float(float16_op(op, t->to_float(check[i]),
+                                                     t->to_float(in[i])));
+        if (!float16_equal(t, expected, inout[i])) {
+            printf("%s %s %s: first error at position %d of %d (%#06x %s %#06x: %#06x != "
+                   "%#06x)\n",
+                   t->mpi_type, op, what, i, count, check[i], op, in[i], inout[i], expected);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * The vector kernels process 8, 16 or 32 elements at a time and leave the
+ * remainder to a scalar loop: check every length up to 100, with both
+ * aligned and misaligned buffers, with two (MPI_Reduce_local) and three
+ * (ompi_3buff_op_reduce) buffers.
+ */
+#define FLOAT16_MAX_TAIL 100
+static int float16_check_tails(const float16_type_t *t, const char *op, MPI_Op mpi_op)
+{
+    uint16_t in[FLOAT16_MAX_TAIL + 1], inout[FLOAT16_MAX_TAIL + 1], check[FLOAT16_MAX_TAIL + 1],
+        out[FLOAT16_MAX_TAIL + 1];
+
+    for (int shift = 0; shift < 2; shift++) {
+        for (int count = 1; count <= FLOAT16_MAX_TAIL; count++) {
+            float16_fill(t, in + shift, check + shift, count);
+            memcpy(inout + shift, check + shift, count * sizeof(uint16_t));
+            MPI_Reduce_local(in + shift, inout + shift, count, t->dtype, mpi_op);
+            if (!float16_check(t, op, in + shift, check + shift, inout + shift, count,
+                               "2 buffers")) {
+                return 0;
+            }
+            ompi_3buff_op_reduce(mpi_op, check + shift, in + shift, out + shift, count,
+                                 t->dtype);
+            if (!float16_check(t, op, in + shift, check + shift, out + shift, count,
+                               "3 buffers")) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/*
+ * Allreduce of 16-bit sums on MPI_COMM_WORLD. Rank 0 contributes big and
+ * the others 1: the exact sum is rounded once when the reduction is
+ * accumulated in float (coll_tuned_allreduce_fp32_accumulate), while the
+ * native 16-bit reduction loses the contributions added one at a time.
+ */
+static int float16_check_allreduce(const float16_type_t *t, int rank, int size)
+{
+    uint16_t sbuf[37], rbuf[37], expected = t->from_float(t->big + (float) (size - 1));
+    const int count = 37;
+
+    for (int i = 0; i < count; i++) {
+        sbuf[i] = t->from_float(0 == rank ? t->big : 1.0f);
+    }
+    MPI_Allreduce(sbuf, rbuf, count, t->dtype, MPI_SUM, MPI_COMM_WORLD);
+    for (int i = 0; i < count; i++) {
+        if (!float16_equal(t, expected, rbuf[i])) {
+            printf("%s allreduce sum on %d ranks: position %d %#06x != %#06x\n", t->mpi_type,
+                   size, i, rbuf[i], expected);
+            return 0;
+        }
+    }
+    return 1;
+}
+
 /* clang-format off */
 #define MPI_OP_TEST(OPNAME, MPIOP, MPITYPE, TYPE, INBUF, INOUT_BUF, CHECK_BUF, COUNT, TYPE_PREFIX) \
 do { \
@@ -187,12 +356,12 @@ int main(int argc, char **argv)
     int repeats = 1, i, c, op1_alignment = 0, res_alignment = 0;
     int max_shift = 4;
     double *duration, tstart, tend;
-    bool check = true;
-    char type[5] = "uifd", *op = "sum", *mpi_type;
+    bool check = true, allreduce_fp32 = false;
+    char type[7] = "uifdhb", *op = "sum", *mpi_type;
     int lower = 1, upper = 16*1024*1024, skip_op_type;
     MPI_Op mpi_op;
 
-    while (-1 != (c = getopt(argc, argv, "l:u:r:t:o:i:s:n:1:2:vfh"))) {
+    while (-1 != (c = getopt(argc, argv, "l:u:r:t:o:i:s:n:1:2:avfh"))) {
         switch (c) {
         case 'l':
             lower = atoi(optarg);
@@ -215,6 +384,9 @@ int main(int argc, char **argv)
                 exit(-1);
             }
             break;
+        case 'a':
+            allreduce_fp32 = true;
+            break;
         case 'f':
             check = false;
             break;
@@ -231,14 +403,13 @@ int main(int argc, char **argv)
         case 't':
             for (i = 0; i < (int) strlen(optarg); i++) {
                 if (!(('i' == optarg[i]) || ('u' == optarg[i]) || ('f' == optarg[i])
-                      || ('d' == optarg[i]))) {
-                    fprintf(
-                        stderr,
-                        "type must be i (signed int), u (unsigned int), f (float) or d (double)\n");
+                      || ('d' == optarg[i]) || ('h' == optarg[i]) || ('b' == optarg[i]))) {
+                    fprintf(stderr, "type must be i (signed int), u (unsigned int), f (float), "
+                                    "d (double), h (short float) or b (bfloat16)\n");
                     exit(-1);
                 }
             }
-            strncpy(type, optarg, 4);
+            strncpy(type, optarg, 6);
             break;
         case 'o':
             build_do_ops(optarg, do_ops);
@@ -272,13 +443,16 @@ int main(int argc, char **argv)
                     " -l <number> : lower number of elements\n"
                     " -u <number> : upper number of elements\n"
                     " -s <type_size> : 8, 16, 32 or 64 bits elements\n"
-                    " -t [i,u,f,d] : type of the elements to apply the operations on\n"
+                    " -t [i,u,f,d,h,b] : type of the elements to apply the operations on\n"
+                    "           (h and b are the 16-bit MPIX_SHORT_FLOAT and MPIX_BFLOAT16)\n"
                     " -r <number> : number of repetitions for each test\n"
                     " -o <op> : comma separated list of operations to execute among\n"
                     "           sum, min, max, prod, bor, bxor, band\n"
                     " -i <number> : shift on all buffers to check alignment\n"
                     " -1 <number> : (mis)alignment in elements for the first op\n"
                     " -2 <number> : (mis)alignment in elements for the result\n"
+                    " -a: check that the 16-bit allreduce sums are accumulated in float\n"
+                    "     (run with --mca coll_tuned_allreduce_fp32_accumulate 1)\n"
                     " -v: increase the verbosity level\n"
                     " -f: turn off correctness checks\n"
                     " -h: this help message\n",
@@ -302,6 +476,19 @@ int main(int argc, char **argv)
     size = ompi_comm_size(MPI_COMM_WORLD);
     (void) size;
 
+    float16_type_t *half_type = NULL, *bfloat16_type = NULL;
+#if defined(HAVE_HALF)
+    float16_type_t half = {"MPIX_SHORT_FLOAT", MPIX_SHORT_FLOAT, half_to_float, float_to_half,
+                           half_values, sizeof(half_values) / sizeof(half_values[0]), 2048.0f};
+    half_type = &half;
+#endif
+#if defined(HAVE_BFLOAT16)
+    float16_type_t bfloat16 = {"MPIX_BFLOAT16", MPIX_BFLOAT16, ompi_op_bfloat16_to_float,
+                               ompi_op_float_to_bfloat16, bfloat16_values,
+                               sizeof(bfloat16_values) / sizeof(bfloat16_values[0]), 256.0f};
+    bfloat16_type = &bfloat16;
+#endif
+
     for (uint32_t type_idx = 0; type_idx < strlen(type); type_idx++) {
         for (uint32_t op_idx = 0; do_ops[op_idx] >= 0; op_idx++) {
             op = array_of_ops[do_ops[op_idx]].name;
@@ -703,15 +890,67 @@ int main(int argc, char **argv)
                                            inout_double_for_check, count, "f");
                     }
                 }
+
+                if ('h' == type[type_idx] || 'b' == type[type_idx]) {
+                    const float16_type_t *t = ('h' == type[type_idx]) ? half_type : bfloat16_type;
+                    uint16_t *in16 = (uint16_t *) ((char *) in_buf
+                                                   + op1_alignment * sizeof(uint16_t)),
+                             *inout16 = (uint16_t *) ((char *) inout_buf
+                                                      + res_alignment * sizeof(uint16_t)),
+                             *inout16_for_check = (uint16_t *) inout_check_buf;
+
+                    if (NULL == t
+                        || !(0 == strcmp(op, "max") || 0 == strcmp(op, "min")
+                             || 0 == strcmp(op, "sum") || 0 == strcmp(op, "prod"))) {
+                        goto check_and_continue;
+                    }
+                    float16_fill(t, in16, inout16_for_check, count);
+                    mpi_type = t->mpi_type;
+                    skip_op_type = 0;
+
+                    if (check && lower == count) {
+                        correctness = float16_check_tails(t, op, mpi_op);
+                    }
+                    for (int _k = 0; _k < min(count, max_shift); _k++) {
+                        duration[_k] = 0.0;
+                        for (int _r = repeats; _r > 0; _r--) {
+                            memcpy(inout16, inout16_for_check, sizeof(uint16_t) * count);
+                            tstart = MPI_Wtime();
+                            MPI_Reduce_local(in16 + _k, inout16 + _k, count - _k, t->dtype, mpi_op);
+                            tend = MPI_Wtime();
+                            duration[_k] += (tend - tstart);
+                            if (check && correctness
+                                && !float16_check(t, op, in16 + _k, inout16_for_check + _k,
+                                                  inout16 + _k, count - _k, "2 buffers")) {
+                                printf("First error at alignment %d\n", _k);
+                                correctness = 0;
+                            }
+                        }
+                    }
+                }
             check_and_continue:
                 if (!skip_op_type)
-                    print_status(array_of_ops[do_ops[op_idx]].mpi_op_name, mpi_type, type_size,
+                    print_status(array_of_ops[do_ops[op_idx]].mpi_op_name, mpi_type,
+                                 ('h' == type[type_idx] || 'b' == type[type_idx]) ? 16 : type_size,
                                  count, max_shift, duration, repeats, correctness);
             }
             if (!skip_op_type)
                 printf("\n");
         }
     }
+
+    if (allreduce_fp32) {
+        const float16_type_t *types[] = {half_type, bfloat16_type};
+        for (i = 0; i < 2; i++) {
+            if (NULL == types[i]) {
+                continue;
+            }
+            correctness = float16_check_allreduce(types[i], rank, size);
+            if (0 == rank) {
+                print_status("MPI_SUM", types[i]->mpi_type, 16, 37, 1, duration, 1, correctness);
+            }
+        }
+    }
     ompi_mpi_finalize();
 
     free(in_buf);
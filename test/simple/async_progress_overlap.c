@@ -0,0 +1,167 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Measure how much communication overlaps with computation for
+ *
+ *  - MPI_Isend/MPI_Irecv of a message large enough to use a rendezvous
+ *    protocol (ranks are paired: 0<->1, 2<->3, ...), and
+ *  - MPI_Iallreduce on MPI_COMM_WORLD,
+ *
+ * each followed by a compute phase that makes no MPI calls and then
+ * MPI_Wait. The compute phase is sized to the measured communication time
+ * so the ideal overlapped time equals the communication time.
+ *
+ *   overlap = (t_comm + t_compute - t_total) / min(t_comm, t_compute)
+ *
+ * 100% means the communication was hidden completely. Run once with
+ * --mca mpi_async_progress 0 and once with 1 to compare.
+ *
+ * usage: async_progress_overlap [p2p_bytes] [allreduce_count] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+
+static volatile double sink;
+
+/* busy work for roughly {seconds} without calling MPI */
+static void compute(double seconds)
+{
+    double t = MPI_Wtime(), x = 1.0;
+
+    while (MPI_Wtime() - t < seconds) {
+        for (int i = 0; i < 1000; ++i) {
+            x = x * 1.000001 + 0.000001;
+        }
+    }
+
+    sink = x;
+}
+
+static double time_p2p(char *sbuf, char *rbuf, int bytes, int peer, double work, int iters)
+{
+    MPI_Request reqs[2];
+    double t;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    for (int i = 0; i < iters; ++i) {
+        MPI_Irecv(rbuf, bytes, MPI_CHAR, peer, 0, MPI_COMM_WORLD, reqs);
+        MPI_Isend(sbuf, bytes, MPI_CHAR, peer, 0, MPI_COMM_WORLD, reqs + 1);
+        if (work > 0.0) {
+            compute(work);
+        }
+        MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);
+    }
+
+    return (MPI_Wtime() - t) / iters;
+}
+
+static double time_iallreduce(double *sbuf, double *rbuf, int count, double work, int iters)
+{
+    MPI_Request req;
+    double t;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    for (int i = 0; i < iters; ++i) {
+        MPI_Iallreduce(sbuf, rbuf, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req);
+        if (work > 0.0) {
+            compute(work);
+        }
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+    }
+
+    return (MPI_Wtime() - t) / iters;
+}
+
+static void report(const char *name, double t_comm, double t_compute, double t_total)
+{
+    double overlap = (t_comm + t_compute - t_total)
+                     / (t_comm < t_compute ? t_comm : t_compute);
+
+    if (overlap < 0.0) {
+        overlap = 0.0;
+    }
+
+    printf("%-12s %12.1f %12.1f %12.1f %9.1f%%\n", name, t_comm * 1e6, t_compute * 1e6,
+           t_total * 1e6, overlap * 100.0);
+}
+
+int main(int argc, char *argv[])
+{
+    int rank, size, peer, p2p_bytes = 4 * 1024 * 1024, count = 1024 * 1024, iters = 20;
+    double t_comm, t_total, t;
+    char *sbuf, *rbuf;
+    double *dsbuf, *drbuf;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1) {
+        p2p_bytes = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        count = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        iters = atoi(argv[3]);
+    }
+
+    sbuf = calloc(p2p_bytes, 1);
+    rbuf = calloc(p2p_bytes, 1);
+    dsbuf = calloc(count, sizeof(double));
+    drbuf = calloc(count, sizeof(double));
+
+    if (0 == rank) {
+        printf("%-12s %12s %12s %12s %10s\n", "operation", "comm_us", "compute_us", "total_us",
+               "overlap");
+    }
+
+    /* point-to-point. an odd rank out talks to itself */
+    peer = rank ^ 1;
+    if (peer >= size) {
+        peer = rank;
+    }
+
+    (void) time_p2p(sbuf, rbuf, p2p_bytes, peer, 0.0, 2);
+    t_comm = time_p2p(sbuf, rbuf, p2p_bytes, peer, 0.0, iters);
+    MPI_Allreduce(MPI_IN_PLACE, &t_comm, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    compute(t_comm);
+    t = MPI_Wtime() - t;
+    t_total = time_p2p(sbuf, rbuf, p2p_bytes, peer, t_comm, iters);
+    MPI_Allreduce(MPI_IN_PLACE, &t_total, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    if (0 == rank) {
+        report("isend", t_comm, t, t_total);
+    }
+
+    /* non-blocking collective */
+    (void) time_iallreduce(dsbuf, drbuf, count, 0.0, 2);
+    t_comm = time_iallreduce(dsbuf, drbuf, count, 0.0, iters);
+    MPI_Allreduce(MPI_IN_PLACE, &t_comm, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    compute(t_comm);
+    t = MPI_Wtime() - t;
+    t_total = time_iallreduce(dsbuf, drbuf, count, t_comm, iters);
+    MPI_Allreduce(MPI_IN_PLACE, &t_total, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    if (0 == rank) {
+        report("iallreduce", t_comm, t, t_total);
+    }
+
+    free(sbuf);
+    free(rbuf);
+    free(dsbuf);
+    free(drbuf);
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#!/bin/bash
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+#
+# Check the coll/tuned rule file written by ompi_coll_autotune on a
+# short sweep: the file must follow the rule-file-version-2 layout,
+# message sizes must start at 0 and grow, and the algorithms that read
+# neither the segment size nor the fanout must be written with both at
+# 0. The file is then loaded by coll/tuned for a run of hello_barrier.
+#
+# usage: coll_autotune_rules.sh [np]
+#
+
+np=${1:-4}
+dir=$(mktemp -d)
+rules=$dir/tuned.rules
+trap 'rm -rf $dir' EXIT
+
+common_opt="--oversubscribe --mca pml ob1 --mca btl self,sm"
+
+mpirun -n $np $common_opt ompi_coll_autotune -c allreduce,alltoall,barrier,bcast \
+    -M 65536 -r 4 -R 8 -p 0.2 -o $rules -H none > /dev/null || exit 1
+
+# algorithms reading a parameter, per COLLTYPE_T identifier:
+# allreduce (2): segmented_ring 5 and tree_pipelined 10 read the segment
+# size, recursive_multiplying 8 and knomial_rabenseifner 9 the fanout.
+# alltoall (3) and barrier (6) read neither. bcast (7): every algorithm
+# but basic_linear 1 reads the segment size, only chain 2 the fanout.
+awk '
+function fail(msg) { print "'"$rules"': line " NR ": " msg; failed = 1; exit 1 }
+function next_int() {
+    if (0 == getline) fail("truncated file")
+    return $1 + 0
+}
+function uses_segsize(coll, alg) {
+    if (2 == coll) return 5 == alg || 10 == alg
+    if (7 == coll) return 1 != alg
+    return 0
+}
+function uses_fanout(coll, alg) {
+    if (2 == coll) return 8 == alg || 9 == alg
+    if (7 == coll) return 2 == alg
+    return 0
+}
+BEGIN {
+    if (0 == getline || "rule-file-version-2" != $1) fail("missing version")
+    do { if (0 == getline) fail("truncated file") } while ($1 ~ /^#/)
+    ncolls = $1 + 0
+    for (c = 0; c < ncolls; c++) {
+        coll = next_int()
+        ncomms = next_int()
+        for (s = 0; s < ncomms; s++) {
+            comm_size = next_int()
+            nmsgs = next_int()
+            last = -1
+            for (m = 0; m < nmsgs; m++) {
+                if (0 == getline) fail("truncated file")
+                msg = $1 + 0; alg = $2 + 0; fanout = $3 + 0; segsize = $4 + 0
+                if (0 == m && 0 != msg) fail("first message size is not 0")
+                if (msg <= last) fail("message sizes do not grow")
+                last = msg
+                if (!uses_segsize(coll, alg) && 0 != segsize)
+                    fail("segment size " segsize " for algorithm " alg " of collective " coll)
+                if (!uses_fanout(coll, alg) && 0 != fanout)
+                    fail("fanout " fanout " for algorithm " alg " of collective " coll)
+            }
+        }
+    }
+    if (0 != getline) fail("trailing data")
+}' < $rules || exit 1
+
+mpirun -n $np $common_opt --mca coll_tuned_use_dynamic_rules 1 \
+    --mca coll_tuned_dynamic_rules_filename $rules ./hello_barrier > /dev/null || exit 1
+
+echo "coll_autotune_rules: $(grep -c '' $rules) lines checked"
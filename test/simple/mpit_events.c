@@ -0,0 +1,165 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * List the MPI_T events and count the ones raised by a short exchange:
+ * every rank sends a batch of messages to rank 0 before rank 0 posts the
+ * receives (so they arrive unexpected), then all ranks run an allreduce.
+ * Rank 0 prints how many events of each kind its callbacks saw. One more
+ * handle on the matched event frees itself from its first callback; the
+ * test fails if it is invoked again or its free callback does not run.
+ *
+ * usage: mpit_events [messages]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+
+static const char *watched[] = {"pml_ob1_message_unexpected", "pml_ob1_message_matched",
+                                "coll_tuned_algorithm_selected"};
+#define NWATCHED ((int) (sizeof(watched) / sizeof(watched[0])))
+
+static long seen[NWATCHED], dropped[NWATCHED];
+
+static void event_cb(MPI_T_event_instance event, MPI_T_event_registration handle,
+                     MPI_T_cb_safety cb_safety, void *user_data)
+{
+    (void) event;
+    (void) handle;
+    (void) cb_safety;
+    ++seen[(int) (intptr_t) user_data];
+}
+
+static void dropped_cb(MPI_Count count, MPI_T_event_registration handle, int source_index,
+                       MPI_T_cb_safety cb_safety, void *user_data)
+{
+    (void) handle;
+    (void) source_index;
+    (void) cb_safety;
+    dropped[(int) (intptr_t) user_data] += (long) count;
+}
+
+static MPI_T_event_registration self_handle = MPI_T_EVENT_REGISTRATION_NULL;
+static long self_seen, self_freed;
+
+static void self_free_done(MPI_T_event_registration handle, MPI_T_cb_safety cb_safety,
+                           void *user_data)
+{
+    (void) handle;
+    (void) cb_safety;
+    (void) user_data;
+    ++self_freed;
+}
+
+static void self_free_cb(MPI_T_event_instance event, MPI_T_event_registration handle,
+                         MPI_T_cb_safety cb_safety, void *user_data)
+{
+    (void) event;
+    (void) cb_safety;
+    (void) user_data;
+    if (1 == ++self_seen) {
+        MPI_T_event_handle_free(handle, NULL, self_free_done);
+        self_handle = MPI_T_EVENT_REGISTRATION_NULL;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    MPI_T_event_registration handles[NWATCHED];
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int provided, rank, size, num_events, nmsg = 16, index, ret = 0, self_alloc = 0;
+    double value = 1.0;
+
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    if (argc > 1) {
+        nmsg = atoi(argv[1]);
+    }
+
+    MPI_T_event_get_num(&num_events);
+    if (0 == rank) {
+        printf("%d events\n", num_events);
+        for (int i = 0; i < num_events; ++i) {
+            char name[256], desc[1024];
+            int name_len = sizeof(name), desc_len = sizeof(desc), verbosity, bind, nelem = 0;
+
+            MPI_T_event_get_info(i, name, &name_len, &verbosity, NULL, NULL, &nelem, NULL, NULL,
+                                 desc, &desc_len, &bind);
+            printf("  %-40s %d elements: %s\n", name, nelem, desc);
+        }
+    }
+
+    for (int i = 0; i < NWATCHED; ++i) {
+        handles[i] = MPI_T_EVENT_REGISTRATION_NULL;
+        if (MPI_SUCCESS != MPI_T_event_get_index(watched[i], &index)
+            || MPI_SUCCESS != MPI_T_event_handle_alloc(index, &comm, MPI_INFO_NULL, handles + i)) {
+            continue;
+        }
+
+        MPI_T_event_register_callback(handles[i], MPI_T_CB_REQUIRE_MPI_RESTRICTED, MPI_INFO_NULL,
+                                      (void *) (intptr_t) i, event_cb);
+        MPI_T_event_set_dropped_handler(handles[i], dropped_cb);
+    }
+
+    if (MPI_SUCCESS == MPI_T_event_get_index("pml_ob1_message_matched", &index)
+        && MPI_SUCCESS == MPI_T_event_handle_alloc(index, &comm, MPI_INFO_NULL, &self_handle)) {
+        self_alloc = 1;
+        MPI_T_event_register_callback(self_handle, MPI_T_CB_REQUIRE_MPI_RESTRICTED, MPI_INFO_NULL,
+                                      NULL, self_free_cb);
+    }
+
+    if (0 != rank) {
+        for (int i = 0; i < nmsg; ++i) {
+            MPI_Send(&value, 1, MPI_DOUBLE, 0, i, comm);
+        }
+        MPI_Barrier(comm);
+    } else {
+        /* let the messages arrive before the receives are posted */
+        MPI_Barrier(comm);
+        for (int i = 0; i < nmsg * (size - 1); ++i) {
+            MPI_Recv(&value, 1, MPI_DOUBLE, MPI_ANY_SOURCE, MPI_ANY_TAG, comm, MPI_STATUS_IGNORE);
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_DOUBLE, MPI_SUM, comm);
+    /* events are delivered from progress */
+    MPI_Barrier(comm);
+
+    if (0 == rank) {
+        for (int i = 0; i < NWATCHED; ++i) {
+            printf("%-32s %s seen %ld dropped %ld\n", watched[i],
+                   MPI_T_EVENT_REGISTRATION_NULL == handles[i] ? "(not available)" : "",
+                   seen[i], dropped[i]);
+        }
+    }
+
+    for (int i = 0; i < NWATCHED; ++i) {
+        if (MPI_T_EVENT_REGISTRATION_NULL != handles[i]) {
+            MPI_T_event_handle_free(handles[i], NULL, NULL);
+        }
+    }
+
+    if (MPI_T_EVENT_REGISTRATION_NULL != self_handle) {
+        /* no message was matched */
+        MPI_T_event_handle_free(self_handle, NULL, self_free_done);
+    } else if (self_alloc && (1 != self_seen || 1 != self_freed)) {
+        fprintf(stderr, "rank %d: self-freeing handle invoked %ld times, freed %ld times\n", rank,
+                self_seen, self_freed);
+        ret = 1;
+    }
+
+    MPI_Finalize();
+    MPI_T_finalize();
+
+    return ret;
+}
@@ -0,0 +1,122 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Check that small sends started together from user context are packed
+ * into coalesced btl/sm fast box records: rank 0 starts a batch of
+ * persistent sends to rank 1 with MPI_Startall and reads the
+ * btl_sm_fbox_coalesced_records pvar before and after. The test fails if
+ * no record was produced or if rank 1 receives wrong data.
+ *
+ * Run with: mpirun -n 2 --mca pml ob1 --mca btl self,sm
+ *           --mca btl_sm_fbox_coalesce_size 1024 sm_fbox_coalesce [batch] [iters]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+
+int main(int argc, char *argv[])
+{
+    int batch = argc > 1 ? atoi(argv[1]) : 8, iters = argc > 2 ? atoi(argv[2]) : 100;
+    int provided, rank, size, index, count, ret = 0;
+    MPI_T_pvar_session session;
+    MPI_T_pvar_handle handle;
+    unsigned long before = 0, after = 0;
+    MPI_Request *reqs;
+    int *buf;
+
+    MPI_Init(&argc, &argv);
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (2 > size) {
+        if (0 == rank) {
+            fprintf(stderr, "sm_fbox_coalesce: needs at least 2 ranks\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (MPI_SUCCESS != MPI_T_pvar_get_index("btl_sm_fbox_coalesced_records",
+                                            MPI_T_PVAR_CLASS_COUNTER, &index)) {
+        if (0 == rank) {
+            fprintf(stderr, "sm_fbox_coalesce: btl_sm_fbox_coalesced_records not found\n");
+        }
+        MPI_T_finalize();
+        MPI_Finalize();
+        return 1;
+    }
+
+    MPI_T_pvar_session_create(&session);
+    MPI_T_pvar_handle_alloc(session, index, NULL, &handle, &count);
+
+    if (1 < rank) {
+        /* only ranks 0 and 1 exchange messages */
+        batch = 0;
+    }
+
+    reqs = malloc(batch * sizeof(*reqs));
+    buf = malloc(batch * sizeof(*buf));
+
+    for (int i = 0; i < batch; ++i) {
+        if (0 == rank) {
+            MPI_Send_init(&buf[i], 1, MPI_INT, 1, i, MPI_COMM_WORLD, &reqs[i]);
+        } else {
+            MPI_Recv_init(&buf[i], 1, MPI_INT, 0, i, MPI_COMM_WORLD, &reqs[i]);
+        }
+    }
+
+    MPI_T_pvar_read(session, handle, &before);
+
+    for (int iter = 0; iter < iters; ++iter) {
+        for (int i = 0; 0 == rank && i < batch; ++i) {
+            buf[i] = iter * batch + i;
+        }
+
+        MPI_Startall(batch, reqs);
+        MPI_Waitall(batch, reqs, MPI_STATUSES_IGNORE);
+
+        for (int i = 0; 1 == rank && i < batch; ++i) {
+            if (buf[i] != iter * batch + i) {
+                fprintf(stderr, "sm_fbox_coalesce: iteration %d message %d: got %d\n", iter, i,
+                        buf[i]);
+                ret = 1;
+            }
+        }
+
+        /* keep the sender from running ahead of the fast box */
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    MPI_T_pvar_read(session, handle, &after);
+
+    if (0 == rank) {
+        printf("sm_fbox_coalesce: %d batches of %d messages: %lu coalesced records\n", iters,
+               batch, after - before);
+        if (after == before) {
+            fprintf(stderr, "sm_fbox_coalesce: no coalesced record was sent\n");
+            ret = 1;
+        }
+    }
+
+    for (int i = 0; i < batch; ++i) {
+        MPI_Request_free(&reqs[i]);
+    }
+    free(reqs);
+    free(buf);
+
+    MPI_T_pvar_handle_free(session, &handle);
+    MPI_T_pvar_session_free(&session);
+    MPI_T_finalize();
+
+    MPI_Allreduce(MPI_IN_PLACE, &ret, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Finalize();
+    return ret;
+}
@@ -0,0 +1,104 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Measure the cost of the btl/sm fast box poll as a function of the
+ * number of local peers. Every rank first exchanges enough messages with
+ * every other rank to get a fast box set up with each peer, then
+ *
+ *  - times an idle MPI_Iprobe loop (the progress loop with nothing to
+ *    receive), and
+ *  - times a ping-pong between ranks 0 and 1 while all other ranks sit
+ *    idle in MPI_Iprobe, so rank 0 has one active fast box out of size - 1.
+ *
+ * Run once with --mca btl_sm_fbox_doorbell 0 and once with 1 to compare
+ * polling every fast box against polling only the peers that rang the
+ * doorbell (see sm_fbox_poll.sh).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+
+#define WARMUP_ROUNDS 64
+
+int main(int argc, char *argv[])
+{
+    int rank, size, flag, stop = 0;
+    int idle_iters = 100000, pp_iters = 10000;
+    double t, poll_ns, poll_ns_max, pp_us = 0.0;
+    int *sbuf, *rbuf;
+    MPI_Request req;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1) {
+        idle_iters = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        pp_iters = atoi(argv[2]);
+    }
+
+    /* the fast box threshold (btl_sm_fbox_threshold) is 16 sends by default */
+    sbuf = calloc(size, sizeof(int));
+    rbuf = calloc(size, sizeof(int));
+    for (int i = 0; i < WARMUP_ROUNDS; ++i) {
+        MPI_Alltoall(sbuf, 1, MPI_INT, rbuf, 1, MPI_INT, MPI_COMM_WORLD);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    /* idle progress cost */
+    t = MPI_Wtime();
+    for (int i = 0; i < idle_iters; ++i) {
+        MPI_Iprobe(MPI_ANY_SOURCE, 1, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+    }
+    poll_ns = (MPI_Wtime() - t) * 1e9 / idle_iters;
+
+    MPI_Reduce(&poll_ns, &poll_ns_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &poll_ns, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    poll_ns /= size;
+
+    /* ping-pong with one active peer while everyone else polls */
+    if (size > 1) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (0 == rank) {
+            t = MPI_Wtime();
+            for (int i = 0; i < pp_iters; ++i) {
+                MPI_Send(sbuf, 1, MPI_INT, 1, 2, MPI_COMM_WORLD);
+                MPI_Recv(rbuf, 1, MPI_INT, 1, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            }
+            pp_us = (MPI_Wtime() - t) * 1e6 / (2.0 * pp_iters);
+            for (int i = 2; i < size; ++i) {
+                MPI_Send(&stop, 1, MPI_INT, i, 3, MPI_COMM_WORLD);
+            }
+        } else if (1 == rank) {
+            for (int i = 0; i < pp_iters; ++i) {
+                MPI_Recv(rbuf, 1, MPI_INT, 0, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                MPI_Send(sbuf, 1, MPI_INT, 0, 2, MPI_COMM_WORLD);
+            }
+        } else {
+            /* keep progressing so the idle ranks' own polling competes for the memory system */
+            MPI_Irecv(&stop, 1, MPI_INT, 0, 3, MPI_COMM_WORLD, &req);
+            do {
+                MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+            } while (!flag);
+        }
+    }
+
+    if (0 == rank) {
+        printf("%6d %12.1f %12.1f %12.3f\n", size, poll_ns, poll_ns_max, pp_us);
+    }
+
+    free(sbuf);
+    free(rbuf);
+    MPI_Finalize();
+
+    return 0;
+}
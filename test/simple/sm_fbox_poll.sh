@@ -0,0 +1,33 @@
+#!/bin/bash
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+#
+# A/B comparison of the btl/sm fast box poll with and without the
+# doorbell bitmap for 2 to 256 local ranks. Ranks beyond the number of
+# cores on the node are oversubscribed, which inflates the ping-pong
+# numbers but still shows the trend of the idle poll cost.
+#
+# usage: sm_fbox_poll.sh [max_ranks] [idle_iters] [pingpong_iters]
+#
+
+exe=./sm_fbox_poll
+max=${1:-256}
+[ $# -ge 1 ] && shift
+
+common_opt="--oversubscribe --bind-to core:overload-allowed --mca pml ob1 --mca btl self,sm"
+
+printf "%-9s %6s %12s %12s %12s\n" "doorbell" "ranks" "poll_ns" "poll_ns_max" "pingpong_us"
+for doorbell in 0 1 ; do
+    np=2
+    while [ $np -le $max ] ; do
+        printf "%-9s " $doorbell
+        mpirun -n $np $common_opt --mca btl_sm_fbox_doorbell $doorbell $exe "$@"
+        np=$((np * 2))
+    done
+done